@@ -0,0 +1,120 @@
+#include "memory.h"
+#include "fiber.h"
+#include "cbus.h"
+
+#include <pmatomic.h>
+
+#include <climits>
+#include <iostream>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+// Number of messages delivered to the consumer.
+static uint64_t delivered_count;
+
+static void
+count_f(struct cmsg *msg)
+{
+	(void)msg;
+	pm_atomic_fetch_add(&delivered_count, 1);
+}
+
+static const struct cmsg_hop count_route[] = {
+	{count_f, NULL},
+};
+
+static int
+consumer_f(va_list ap)
+{
+	(void)ap;
+	struct cbus_endpoint endpoint;
+	cbus_endpoint_create(&endpoint, "consumer", fiber_schedule_cb,
+			     fiber());
+	cbus_loop(&endpoint);
+	cbus_endpoint_destroy(&endpoint, cbus_process);
+	return 0;
+}
+
+// Class that starts the consumer thread and connects a pipe to it.
+class Consumer {
+public:
+	static Consumer &instance()
+	{
+		static Consumer instance;
+		return instance;
+	}
+	struct cpipe *pipe() { return &consumer_pipe; }
+private:
+	Consumer()
+	{
+		memory_init();
+		fiber_init(fiber_c_invoke);
+		cbus_init();
+		if (cord_costart(&consumer, "consumer", consumer_f, NULL) != 0)
+			abort();
+		cpipe_create(&consumer_pipe, "consumer");
+	}
+	~Consumer()
+	{
+		cbus_stop_loop(&consumer_pipe);
+		cpipe_destroy(&consumer_pipe);
+		cord_join(&consumer);
+		cbus_free();
+		fiber_free();
+		memory_free();
+	}
+
+	struct cord consumer;
+	struct cpipe consumer_pipe;
+};
+
+// Push messages to another thread in batches of the given size and
+// wait until the whole batch is delivered.
+static void
+cbus_push_batch(benchmark::State& state)
+{
+	struct cpipe *pipe = Consumer::instance().pipe();
+	size_t batch_size = state.range(0);
+	std::vector<struct cmsg> msgs(batch_size);
+	// Flush as soon as the whole batch is in the input.
+	cpipe_set_max_input(pipe, batch_size);
+	uint64_t total_count = 0;
+	for (auto _ : state) {
+		for (size_t i = 0; i < batch_size; i++) {
+			cmsg_init(&msgs[i], count_route);
+			cpipe_push_input(pipe, &msgs[i]);
+		}
+		total_count += batch_size;
+		while (pm_atomic_load(&delivered_count) < total_count)
+			;
+	}
+	delivered_count = 0;
+	cpipe_set_max_input(pipe, INT_MAX);
+	state.SetItemsProcessed(total_count);
+}
+
+BENCHMARK(cbus_push_batch)->RangeMultiplier(4)->Range(1, 1024);
+
+BENCHMARK_MAIN();
+
+static void
+show_warning_if_debug()
+{
+#ifndef NDEBUG
+	std::cerr << "#######################################################\n"
+		  << "#######################################################\n"
+		  << "#######################################################\n"
+		  << "###                                                 ###\n"
+		  << "###                    WARNING!                     ###\n"
+		  << "###   The performance test is run in debug build!   ###\n"
+		  << "###   Test results are definitely inappropriate!    ###\n"
+		  << "###                                                 ###\n"
+		  << "#######################################################\n"
+		  << "#######################################################\n"
+		  << "#######################################################\n";
+#endif // #ifndef NDEBUG
+}
+
+struct DebugWarning {
+	DebugWarning() { show_warning_if_debug(); }
+} debug_warning;
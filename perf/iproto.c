@@ -0,0 +1,551 @@
+/*
+ * End-to-end benchmark of the iproto request path.
+ *
+ * Usage:
+ *
+ *   iproto.perftest [--tarantool PATH] [--type select|replace|call]
+ *                   [--connections N] [--pipeline N] [--duration SEC]
+ *                   [--keys N] [--iproto-threads N] [--net-msg-max N]
+ *                   [--readahead N] [--wal-mode MODE]
+ *
+ * The benchmark starts a Tarantool server listening on a UNIX socket,
+ * opens --connections connections to it, each served by its own
+ * thread, and keeps --pipeline requests in flight on each of them for
+ * --duration seconds. It prints the number of requests per second and
+ * percentiles of the request latency, measured from sending a request
+ * to receiving its response.
+ *
+ * The server is a child process running the tarantool binary of the
+ * same build, so that every request goes through the iproto threads,
+ * cbus and TX exactly as it does in production.
+ */
+#include <assert.h>
+#include <errno.h>
+#include <getopt.h>
+#include <limits.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <msgpuck.h>
+
+#include "clock.h"
+#include "histogram.h"
+#include "latency.h"
+#include "trivia/util.h"
+#include "iproto_constants.h"
+#include "iterator_type.h"
+
+#if !defined(TARANTOOL_BIN)
+#define TARANTOOL_BIN "tarantool"
+#endif
+
+/** Id of the space created by the server script. */
+enum { BENCH_SPACE_ID = 512 };
+
+enum bench_type {
+	BENCH_SELECT,
+	BENCH_REPLACE,
+	BENCH_CALL,
+	bench_type_MAX,
+};
+
+static const char *const bench_type_strs[] = {
+	"select", "replace", "call",
+};
+
+static struct {
+	const char *tarantool;
+	enum bench_type type;
+	int connections;
+	int pipeline;
+	double duration;
+	int keys;
+	int iproto_threads;
+	int net_msg_max;
+	int readahead;
+	const char *wal_mode;
+} opts = {
+	/* .tarantool = */ TARANTOOL_BIN,
+	/* .type = */ BENCH_SELECT,
+	/* .connections = */ 10,
+	/* .pipeline = */ 16,
+	/* .duration = */ 10,
+	/* .keys = */ 100000,
+	/* .iproto_threads = */ 1,
+	/* .net_msg_max = */ 768,
+	/* .readahead = */ 16320,
+	/* .wal_mode = */ "none",
+};
+
+/** Set by the main thread when the benchmark time is over. */
+static volatile bool is_stopped;
+
+struct conn {
+	pthread_t thread;
+	/** Random seed for request keys. */
+	unsigned seed;
+	/** Send time of the request in each pipeline slot. */
+	double *sent;
+	/** Number of requests sent so far, used to generate syncs. */
+	uint64_t send_count;
+	/** Number of responses received, including errors. */
+	uint64_t recv_count;
+	/** Number of error responses. */
+	uint64_t error_count;
+	struct latency latency;
+};
+
+static char socket_path[PATH_MAX];
+
+static void
+die(const char *msg)
+{
+	perror(msg);
+	exit(EXIT_FAILURE);
+}
+
+/**
+ * Encode a request with the given sync. The key is taken at random
+ * from the range loaded by the server script.
+ */
+static char *
+encode_request(char *data, struct conn *conn, uint64_t sync)
+{
+	char *fixheader = data;
+	/* Leave room for a fixed-size packet length. */
+	data += 5;
+	uint32_t key = rand_r(&conn->seed) % opts.keys + 1;
+	int type;
+	switch (opts.type) {
+	case BENCH_SELECT:
+		type = IPROTO_SELECT;
+		break;
+	case BENCH_REPLACE:
+		type = IPROTO_REPLACE;
+		break;
+	case BENCH_CALL:
+		type = IPROTO_CALL;
+		break;
+	default:
+		unreachable();
+	}
+	data = mp_encode_map(data, 2);
+	data = mp_encode_uint(data, IPROTO_REQUEST_TYPE);
+	data = mp_encode_uint(data, type);
+	data = mp_encode_uint(data, IPROTO_SYNC);
+	data = mp_encode_uint(data, sync);
+	switch (opts.type) {
+	case BENCH_SELECT:
+		data = mp_encode_map(data, 6);
+		data = mp_encode_uint(data, IPROTO_SPACE_ID);
+		data = mp_encode_uint(data, BENCH_SPACE_ID);
+		data = mp_encode_uint(data, IPROTO_INDEX_ID);
+		data = mp_encode_uint(data, 0);
+		data = mp_encode_uint(data, IPROTO_LIMIT);
+		data = mp_encode_uint(data, 1);
+		data = mp_encode_uint(data, IPROTO_OFFSET);
+		data = mp_encode_uint(data, 0);
+		data = mp_encode_uint(data, IPROTO_ITERATOR);
+		data = mp_encode_uint(data, ITER_EQ);
+		data = mp_encode_uint(data, IPROTO_KEY);
+		data = mp_encode_array(data, 1);
+		data = mp_encode_uint(data, key);
+		break;
+	case BENCH_REPLACE:
+		data = mp_encode_map(data, 2);
+		data = mp_encode_uint(data, IPROTO_SPACE_ID);
+		data = mp_encode_uint(data, BENCH_SPACE_ID);
+		data = mp_encode_uint(data, IPROTO_TUPLE);
+		data = mp_encode_array(data, 2);
+		data = mp_encode_uint(data, key);
+		data = mp_encode_uint(data, sync);
+		break;
+	case BENCH_CALL:
+		data = mp_encode_map(data, 2);
+		data = mp_encode_uint(data, IPROTO_FUNCTION_NAME);
+		data = mp_encode_str0(data, "bench_call");
+		data = mp_encode_uint(data, IPROTO_TUPLE);
+		data = mp_encode_array(data, 1);
+		data = mp_encode_uint(data, key);
+		break;
+	default:
+		unreachable();
+	}
+	uint32_t len = data - fixheader - 5;
+	*fixheader = 0xce;
+	mp_store_u32(fixheader + 1, len);
+	return data;
+}
+
+/** Maximal size of an encoded request. */
+enum { REQUEST_SIZE_MAX = 64 };
+
+static int
+conn_connect(void)
+{
+	int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd < 0)
+		die("socket");
+	struct sockaddr_un addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	strlcpy(addr.sun_path, socket_path, sizeof(addr.sun_path));
+	if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+		close(fd);
+		return -1;
+	}
+	char greeting[IPROTO_GREETING_SIZE];
+	size_t done = 0;
+	while (done < sizeof(greeting)) {
+		ssize_t n = read(fd, greeting + done, sizeof(greeting) - done);
+		if (n <= 0) {
+			close(fd);
+			return -1;
+		}
+		done += n;
+	}
+	return fd;
+}
+
+static void
+write_all(int fd, const char *data, size_t size)
+{
+	while (size > 0) {
+		ssize_t n = write(fd, data, size);
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n < 0)
+			die("write");
+		data += n;
+		size -= n;
+	}
+}
+
+/**
+ * Parse the header of a response and account it. Returns the
+ * pipeline slot of the request it answers.
+ */
+static int
+conn_handle_response(struct conn *conn, const char *data, double now)
+{
+	uint64_t sync = UINT64_MAX;
+	uint64_t type = 0;
+	uint32_t size = mp_decode_map(&data);
+	for (uint32_t i = 0; i < size; i++) {
+		if (mp_typeof(*data) != MP_UINT) {
+			mp_next(&data);
+			mp_next(&data);
+			continue;
+		}
+		uint64_t key = mp_decode_uint(&data);
+		if (key == IPROTO_SYNC && mp_typeof(*data) == MP_UINT)
+			sync = mp_decode_uint(&data);
+		else if (key == IPROTO_REQUEST_TYPE &&
+			 mp_typeof(*data) == MP_UINT)
+			type = mp_decode_uint(&data);
+		else
+			mp_next(&data);
+	}
+	if (sync == UINT64_MAX) {
+		fprintf(stderr, "response without sync\n");
+		exit(EXIT_FAILURE);
+	}
+	int slot = sync % opts.pipeline;
+	conn->recv_count++;
+	if ((type & IPROTO_TYPE_ERROR) != 0)
+		conn->error_count++;
+	latency_collect(&conn->latency, now - conn->sent[slot]);
+	return slot;
+}
+
+/**
+ * Connection thread. A request is sent to each pipeline slot, then
+ * every response frees its slot for a new request until the
+ * benchmark is stopped.
+ */
+static void *
+conn_f(void *arg)
+{
+	struct conn *conn = (struct conn *)arg;
+	int fd = conn_connect();
+	if (fd < 0)
+		die("connect");
+	size_t out_size = opts.pipeline * REQUEST_SIZE_MAX;
+	char *out = (char *)xmalloc(out_size);
+	size_t in_size = 64 * 1024;
+	char *in = (char *)xmalloc(in_size);
+	size_t in_used = 0;
+
+	char *out_end = out;
+	double now = clock_monotonic();
+	for (int slot = 0; slot < opts.pipeline; slot++) {
+		conn->sent[slot] = now;
+		out_end = encode_request(out_end, conn, slot);
+	}
+	conn->send_count = opts.pipeline;
+	write_all(fd, out, out_end - out);
+	uint64_t in_flight = opts.pipeline;
+
+	while (in_flight > 0) {
+		if (in_used == in_size) {
+			in_size *= 2;
+			in = (char *)xrealloc(in, in_size);
+		}
+		ssize_t n = read(fd, in + in_used, in_size - in_used);
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n <= 0)
+			die("read");
+		in_used += n;
+		now = clock_monotonic();
+		out_end = out;
+		const char *pos = in;
+		const char *end = in + in_used;
+		while (true) {
+			const char *p = pos;
+			if (p == end || mp_typeof(*p) != MP_UINT) {
+				if (p != end) {
+					fprintf(stderr, "invalid packet\n");
+					exit(EXIT_FAILURE);
+				}
+				break;
+			}
+			if (mp_check_uint(p, end) > 0)
+				break;
+			uint64_t len = mp_decode_uint(&p);
+			if ((uint64_t)(end - p) < len)
+				break;
+			int slot = conn_handle_response(conn, p, now);
+			pos = p + len;
+			in_flight--;
+			if (is_stopped)
+				continue;
+			/* The slot of a request is sync % pipeline. */
+			uint64_t sync = conn->send_count++ * opts.pipeline + slot;
+			conn->sent[slot] = now;
+			out_end = encode_request(out_end, conn, sync);
+			in_flight++;
+		}
+		in_used = end - pos;
+		memmove(in, pos, in_used);
+		if (out_end != out)
+			write_all(fd, out, out_end - out);
+	}
+	free(in);
+	free(out);
+	close(fd);
+	return NULL;
+}
+
+static pid_t
+server_start(const char *dir)
+{
+	char script_path[PATH_MAX];
+	snprintf(script_path, sizeof(script_path), "%s/server.lua", dir);
+	snprintf(socket_path, sizeof(socket_path), "%s/server.sock", dir);
+	FILE *f = fopen(script_path, "w");
+	if (f == NULL)
+		die("fopen");
+	fprintf(f,
+		"box.cfg({\n"
+		"    work_dir = '%s',\n"
+		"    log = 'server.log',\n"
+		"    wal_mode = '%s',\n"
+		"    iproto_threads = %d,\n"
+		"    net_msg_max = %d,\n"
+		"    readahead = %d,\n"
+		"})\n"
+		"box.schema.user.grant('guest', 'super')\n"
+		"local s = box.schema.space.create('bench', {id = %d})\n"
+		"s:create_index('pk')\n"
+		"box.begin()\n"
+		"for i = 1, %d do\n"
+		"    s:replace({i, i})\n"
+		"    if i %% 1000 == 0 then box.commit() box.begin() end\n"
+		"end\n"
+		"box.commit()\n"
+		"function bench_call(key) return key end\n"
+		"box.cfg({listen = '%s'})\n",
+		dir, opts.wal_mode, opts.iproto_threads, opts.net_msg_max,
+		opts.readahead, BENCH_SPACE_ID, opts.keys, socket_path);
+	fclose(f);
+
+	pid_t pid = fork();
+	if (pid < 0)
+		die("fork");
+	if (pid == 0) {
+		execlp(opts.tarantool, opts.tarantool, script_path,
+		       (char *)NULL);
+		perror("exec");
+		_exit(EXIT_FAILURE);
+	}
+	/* Wait until the server loads the data and starts listening. */
+	double deadline = clock_monotonic() + 60;
+	while (true) {
+		int fd = conn_connect();
+		if (fd >= 0) {
+			close(fd);
+			break;
+		}
+		int status;
+		if (waitpid(pid, &status, WNOHANG) == pid) {
+			fprintf(stderr, "server exited, see %s/server.log\n",
+				dir);
+			exit(EXIT_FAILURE);
+		}
+		if (clock_monotonic() > deadline) {
+			fprintf(stderr, "server didn't start in time\n");
+			kill(pid, SIGKILL);
+			exit(EXIT_FAILURE);
+		}
+		usleep(10000);
+	}
+	return pid;
+}
+
+static void
+usage(const char *prog)
+{
+	fprintf(stderr,
+		"Usage: %s [--tarantool PATH] [--type select|replace|call]\n"
+		"       [--connections N] [--pipeline N] [--duration SEC]\n"
+		"       [--keys N] [--iproto-threads N] [--net-msg-max N]\n"
+		"       [--readahead N] [--wal-mode MODE]\n", prog);
+	exit(EXIT_FAILURE);
+}
+
+static void
+parse_options(int argc, char **argv)
+{
+	static const struct option longopts[] = {
+		{"tarantool", required_argument, NULL, 't'},
+		{"type", required_argument, NULL, 'T'},
+		{"connections", required_argument, NULL, 'c'},
+		{"pipeline", required_argument, NULL, 'p'},
+		{"duration", required_argument, NULL, 'd'},
+		{"keys", required_argument, NULL, 'k'},
+		{"iproto-threads", required_argument, NULL, 'i'},
+		{"net-msg-max", required_argument, NULL, 'm'},
+		{"readahead", required_argument, NULL, 'r'},
+		{"wal-mode", required_argument, NULL, 'w'},
+		{NULL, 0, NULL, 0},
+	};
+	int ch;
+	while ((ch = getopt_long(argc, argv, "", longopts, NULL)) != -1) {
+		switch (ch) {
+		case 't':
+			opts.tarantool = optarg;
+			break;
+		case 'T':
+			opts.type = STR2ENUM(bench_type, optarg);
+			if (opts.type == bench_type_MAX)
+				usage(argv[0]);
+			break;
+		case 'c':
+			opts.connections = atoi(optarg);
+			break;
+		case 'p':
+			opts.pipeline = atoi(optarg);
+			break;
+		case 'd':
+			opts.duration = atof(optarg);
+			break;
+		case 'k':
+			opts.keys = atoi(optarg);
+			break;
+		case 'i':
+			opts.iproto_threads = atoi(optarg);
+			break;
+		case 'm':
+			opts.net_msg_max = atoi(optarg);
+			break;
+		case 'r':
+			opts.readahead = atoi(optarg);
+			break;
+		case 'w':
+			opts.wal_mode = optarg;
+			break;
+		default:
+			usage(argv[0]);
+		}
+	}
+	if (optind != argc || opts.connections <= 0 || opts.pipeline <= 0 ||
+	    opts.duration <= 0 || opts.keys <= 0)
+		usage(argv[0]);
+}
+
+int
+main(int argc, char **argv)
+{
+	parse_options(argc, argv);
+	char dir[] = "/tmp/iproto.perftest.XXXXXX";
+	if (mkdtemp(dir) == NULL)
+		die("mkdtemp");
+	pid_t server = server_start(dir);
+
+	struct conn *conns = (struct conn *)xcalloc(opts.connections,
+						    sizeof(*conns));
+	double start = clock_monotonic();
+	for (int i = 0; i < opts.connections; i++) {
+		struct conn *conn = &conns[i];
+		conn->seed = i;
+		conn->sent = (double *)xcalloc(opts.pipeline,
+					       sizeof(*conn->sent));
+		if (latency_create(&conn->latency) != 0)
+			die("latency_create");
+		if (pthread_create(&conn->thread, NULL, conn_f, conn) != 0)
+			die("pthread_create");
+	}
+	usleep(opts.duration * 1e6);
+	is_stopped = true;
+
+	struct latency total;
+	if (latency_create(&total) != 0)
+		die("latency_create");
+	uint64_t recv_count = 0, error_count = 0;
+	for (int i = 0; i < opts.connections; i++) {
+		struct conn *conn = &conns[i];
+		pthread_join(conn->thread, NULL);
+		recv_count += conn->recv_count;
+		error_count += conn->error_count;
+		struct histogram *src = conn->latency.histogram;
+		struct histogram *dst = total.histogram;
+		for (size_t j = 0; j < src->n_buckets; j++)
+			dst->buckets[j].count += src->buckets[j].count;
+		dst->total += src->total;
+		dst->max = MAX(dst->max, src->max);
+		/* Drop the zero latency_create() puts in each counter. */
+		histogram_discard(dst, 0);
+		latency_destroy(&conn->latency);
+		free(conn->sent);
+	}
+	double elapsed = clock_monotonic() - start;
+	kill(server, SIGTERM);
+	waitpid(server, NULL, 0);
+
+	printf("type: %s, connections: %d, pipeline: %d, "
+	       "iproto_threads: %d, net_msg_max: %d, readahead: %d\n",
+	       bench_type_strs[opts.type], opts.connections, opts.pipeline,
+	       opts.iproto_threads, opts.net_msg_max, opts.readahead);
+	printf("requests: %llu, errors: %llu, rps: %.0f\n",
+	       (unsigned long long)recv_count,
+	       (unsigned long long)error_count, recv_count / elapsed);
+	static const double pcts[] = {50, 90, 99, 99.9, 100};
+	for (size_t i = 0; i < lengthof(pcts); i++) {
+		printf("latency p%g: %.0f us\n", pcts[i],
+		       latency_get(&total, pcts[i]) * 1e6);
+	}
+	latency_destroy(&total);
+	free(conns);
+
+	unlink(socket_path);
+	return 0;
+}
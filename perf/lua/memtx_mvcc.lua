@@ -0,0 +1,106 @@
+--
+-- Measures the overhead of the memtx transaction manager.
+--
+-- Usage:
+--
+--   tarantool memtx_mvcc.lua [--mvcc] [--read-view] [--fibers N]
+--                            [--tx-size N] [--count N]
+--
+-- The benchmark runs replace transactions in several fibers on a space
+-- with a primary and a secondary index, and prints the number of
+-- statements per second. Run it with and without --mvcc to get the
+-- overhead. --read-view keeps a long read view open during the run, so
+-- that no story can be collected until it is closed.
+--
+
+local clock = require('clock')
+local fiber = require('fiber')
+
+local params = {
+    mvcc = false,
+    read_view = false,
+    fibers = 10,
+    tx_size = 10,
+    count = 1000000,
+}
+
+local i = 1
+while i <= #arg do
+    local name = arg[i]:match('^%-%-(.+)$')
+    if name == nil then
+        error('Unexpected argument: ' .. arg[i])
+    end
+    name = name:gsub('-', '_')
+    if type(params[name]) == 'boolean' then
+        params[name] = true
+    elseif type(params[name]) == 'number' then
+        i = i + 1
+        params[name] = tonumber(arg[i])
+    else
+        error('Unknown option: ' .. arg[i])
+    end
+    i = i + 1
+end
+
+box.cfg({
+    memtx_use_mvcc_engine = params.mvcc,
+    wal_mode = 'none',
+    log_level = 1,
+    work_dir = require('fio').tempdir(),
+})
+
+local s = box.schema.space.create('test')
+s:create_index('pk')
+s:create_index('sk', {parts = {2, 'unsigned'}, unique = false})
+-- Rows are replaced, so the space size doesn't depend on the count.
+local row_count = 10000
+
+local read_view_done
+if params.read_view then
+    local started = fiber.channel()
+    read_view_done = fiber.channel()
+    fiber.create(function()
+        box.begin()
+        s:get(0)
+        started:put(true)
+        read_view_done:get()
+        -- Without MVCC the transaction is aborted by the yield.
+        pcall(box.commit)
+    end)
+    started:get()
+end
+
+local count_per_fiber = math.floor(params.count / params.fibers)
+local done = fiber.channel(params.fibers)
+local start = clock.monotonic()
+for f = 1, params.fibers do
+    fiber.create(function()
+        local n = 0
+        while n < count_per_fiber do
+            box.begin()
+            for _ = 1, params.tx_size do
+                n = n + 1
+                local key = (f * count_per_fiber + n) % row_count
+                s:replace({key, n})
+            end
+            box.commit()
+        end
+        done:put(n)
+    end)
+end
+local total = 0
+for _ = 1, params.fibers do
+    total = total + done:get()
+end
+local elapsed = clock.monotonic() - start
+
+if read_view_done ~= nil then
+    read_view_done:put(true)
+end
+
+print(string.format('mvcc: %s, read view: %s, fibers: %d, tx size: %d',
+                    params.mvcc, params.read_view, params.fibers,
+                    params.tx_size))
+print(string.format('%d statements in %.3f s, %d statements/s',
+                    total, elapsed, total / elapsed))
+os.exit(0)
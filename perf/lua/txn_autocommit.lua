@@ -0,0 +1,95 @@
+--
+-- Measures the per-request cost of single-statement transactions.
+--
+-- Usage:
+--
+--   tarantool txn_autocommit.lua [--wal] [--explicit] [--triggers]
+--                                [--fibers N] [--count N]
+--
+-- The benchmark runs replace statements in several fibers and prints
+-- the number of statements per second. By default every statement is
+-- an autocommit transaction. --explicit wraps each one in box.begin()
+-- and box.commit(), --triggers sets an on_replace trigger and a
+-- box.on_commit() trigger per transaction, so that the difference with
+-- the default run shows the cost of the trigger lists. --wal writes
+-- the transactions to WAL instead of running with wal_mode = 'none'.
+--
+
+local clock = require('clock')
+local fiber = require('fiber')
+
+local params = {
+    wal = false,
+    explicit = false,
+    triggers = false,
+    fibers = 10,
+    count = 1000000,
+}
+
+local i = 1
+while i <= #arg do
+    local name = arg[i]:match('^%-%-(.+)$')
+    if name == nil then
+        error('Unexpected argument: ' .. arg[i])
+    end
+    name = name:gsub('-', '_')
+    if type(params[name]) == 'boolean' then
+        params[name] = true
+    elseif type(params[name]) == 'number' then
+        i = i + 1
+        params[name] = tonumber(arg[i])
+    else
+        error('Unknown option: ' .. arg[i])
+    end
+    i = i + 1
+end
+
+box.cfg({
+    wal_mode = params.wal and 'write' or 'none',
+    log_level = 1,
+    work_dir = require('fio').tempdir(),
+})
+
+local s = box.schema.space.create('test')
+s:create_index('pk')
+-- Rows are replaced, so the space size doesn't depend on the count.
+local row_count = 10000
+
+local on_commit = function() end
+if params.triggers then
+    s:on_replace(function() end)
+end
+
+local count_per_fiber = math.floor(params.count / params.fibers)
+local done = fiber.channel(params.fibers)
+local start = clock.monotonic()
+for f = 1, params.fibers do
+    fiber.create(function()
+        for n = 1, count_per_fiber do
+            local key = (f * count_per_fiber + n) % row_count
+            if params.explicit or params.triggers then
+                box.begin()
+                if params.triggers then
+                    box.on_commit(on_commit)
+                end
+                s:replace({key, n})
+                box.commit()
+            else
+                s:replace({key, n})
+            end
+        end
+        done:put(count_per_fiber)
+    end)
+end
+local total = 0
+for _ = 1, params.fibers do
+    total = total + done:get()
+end
+local elapsed = clock.monotonic() - start
+
+print(string.format('wal: %s, explicit: %s, triggers: %s, fibers: %d',
+                    params.wal, params.explicit, params.triggers,
+                    params.fibers))
+print(string.format('%d statements in %.3f s, %d statements/s, %.0f ns/stmt',
+                    total, elapsed, total / elapsed, elapsed * 1e9 / total))
+os.exit(0)
@@ -0,0 +1,237 @@
+--
+-- Drives a vinyl space with a mix of reads and writes and reports how
+-- the LSM tree behaves under it.
+--
+-- Usage:
+--
+--   tarantool vinyl.lua [--keys N] [--count N] [--fibers N]
+--                       [--distribution uniform|zipf|latest]
+--                       [--zipf-theta X] [--write-ratio X]
+--                       [--value-size N] [--memory N] [--interval SEC]
+--                       [--dir PATH]
+--
+-- The space is loaded with --keys rows first, then --fibers fibers run
+-- --count requests in total. Each request is a write (replace) with the
+-- probability --write-ratio and a get otherwise. Keys are chosen:
+--
+--   uniform - uniformly from all keys;
+--   zipf    - with the Zipfian distribution over all keys, so that a
+--             few keys take most of the requests;
+--   latest  - with the Zipfian distribution over the most recently
+--             written keys; writes insert new keys.
+--
+-- Every --interval seconds the benchmark prints a line of the timeline:
+-- request rate, dumps and compactions completed, the level 0 size, the
+-- disk size and the regulator rate limit. At the end it prints the
+-- throughput, write, read and space amplification of the primary index
+-- and the tuple cache hit rate.
+--
+
+local clock = require('clock')
+local fiber = require('fiber')
+local fio = require('fio')
+
+local params = {
+    keys = 1000000,
+    count = 10000000,
+    fibers = 10,
+    distribution = 'uniform',
+    zipf_theta = 0.99,
+    write_ratio = 0.5,
+    value_size = 100,
+    memory = 128 * 1024 * 1024,
+    interval = 1,
+    dir = '',
+}
+
+local i = 1
+while i <= #arg do
+    local name = arg[i]:match('^%-%-(.+)$')
+    if name == nil then
+        error('Unexpected argument: ' .. arg[i])
+    end
+    name = name:gsub('-', '_')
+    if type(params[name]) == 'number' then
+        i = i + 1
+        params[name] = tonumber(arg[i])
+    elseif type(params[name]) == 'string' then
+        i = i + 1
+        params[name] = arg[i]
+    else
+        error('Unknown option: ' .. arg[i])
+    end
+    i = i + 1
+end
+
+local distributions = {uniform = true, zipf = true, latest = true}
+if not distributions[params.distribution] then
+    error('Unknown distribution: ' .. params.distribution)
+end
+
+local work_dir = params.dir
+if work_dir == '' then
+    work_dir = fio.tempdir()
+end
+
+box.cfg({
+    vinyl_memory = params.memory,
+    log_level = 1,
+    work_dir = work_dir,
+})
+
+local s = box.schema.space.create('test', {engine = 'vinyl'})
+s:create_index('pk')
+
+local value = string.rep('x', params.value_size)
+
+-- Load the initial data set.
+box.begin()
+for key = 1, params.keys do
+    s:replace({key, value})
+    if key % 1000 == 0 then
+        box.commit()
+        box.begin()
+    end
+end
+box.commit()
+box.snapshot()
+
+-- Zipfian generator, see "Quickly Generating Billion-Record Synthetic
+-- Databases" by J. Gray et al. Returns ranks in [1, n], rank 1 being
+-- the most popular.
+local function zipf_new(n, theta)
+    local zetan = 0
+    for k = 1, n do
+        zetan = zetan + 1 / k ^ theta
+    end
+    local zeta2 = 1 + 1 / 2 ^ theta
+    local alpha = 1 / (1 - theta)
+    local eta = (1 - (2 / n) ^ (1 - theta)) / (1 - zeta2 / zetan)
+    return function()
+        local u = math.random()
+        local uz = u * zetan
+        if uz < 1 then
+            return 1
+        end
+        if uz < zeta2 then
+            return 2
+        end
+        return 1 + math.floor(n * (eta * u - eta + 1) ^ alpha)
+    end
+end
+
+local max_key = params.keys
+local next_key
+
+if params.distribution == 'uniform' then
+    next_key = function()
+        return math.random(params.keys)
+    end
+elseif params.distribution == 'zipf' then
+    local zipf = zipf_new(params.keys, params.zipf_theta)
+    next_key = function()
+        -- Scatter the popular keys over the key space.
+        return (zipf() * 2654435761) % params.keys + 1
+    end
+else
+    local zipf = zipf_new(params.keys, params.zipf_theta)
+    next_key = function()
+        return math.max(max_key - zipf() + 1, 1)
+    end
+end
+
+local function pk_stat()
+    return s.index.pk:stat()
+end
+
+local done_count = 0
+local is_running = true
+
+local function timeline_f()
+    local start = clock.monotonic()
+    local prev_count = 0
+    local prev_time = start
+    local prev = box.stat.vinyl()
+    print(string.format('%8s %10s %6s %11s %12s %12s %12s',
+                        'time', 'rps', 'dumps', 'compactions',
+                        'level0', 'disk', 'rate_limit'))
+    while is_running do
+        fiber.sleep(params.interval)
+        local now = clock.monotonic()
+        local stat = box.stat.vinyl()
+        local sched = stat.scheduler
+        print(string.format('%8.1f %10d %6d %11d %12d %12d %12d',
+                            now - start,
+                            (done_count - prev_count) / (now - prev_time),
+                            sched.dump_count - prev.scheduler.dump_count,
+                            sched.tasks_completed -
+                                prev.scheduler.tasks_completed -
+                                (sched.dump_count -
+                                 prev.scheduler.dump_count),
+                            stat.memory.level0, stat.disk.data,
+                            stat.regulator.rate_limit))
+        prev = stat
+        prev_count = done_count
+        prev_time = now
+    end
+end
+
+local before = pk_stat()
+local count_per_fiber = math.floor(params.count / params.fibers)
+local done = fiber.channel(params.fibers)
+local start = clock.monotonic()
+local timeline = fiber.create(timeline_f)
+for _ = 1, params.fibers do
+    fiber.create(function()
+        for _ = 1, count_per_fiber do
+            if math.random() < params.write_ratio then
+                local key
+                if params.distribution == 'latest' then
+                    max_key = max_key + 1
+                    key = max_key
+                else
+                    key = next_key()
+                end
+                s:replace({key, value})
+            else
+                s:get(next_key())
+            end
+            done_count = done_count + 1
+        end
+        done:put(true)
+    end)
+end
+for _ = 1, params.fibers do
+    done:get()
+end
+local elapsed = clock.monotonic() - start
+is_running = false
+timeline:cancel()
+
+local after = pk_stat()
+local cache_lookup = after.cache.lookup - before.cache.lookup
+local cache_hits = after.cache.get.rows - before.cache.get.rows
+local rows_read = after.disk.iterator.read.rows -
+                  before.disk.iterator.read.rows
+local rows_got = after.get.rows - before.get.rows
+
+print(string.format('distribution: %s, keys: %d, write ratio: %.2f, ' ..
+                    'value size: %d, fibers: %d',
+                    params.distribution, params.keys, params.write_ratio,
+                    params.value_size, params.fibers))
+print(string.format('%d requests in %.3f s, %d requests/s',
+                    done_count, elapsed, done_count / elapsed))
+print(string.format('write amplification: %.2f',
+                    after.disk.write_amplification))
+print(string.format('read amplification: %.2f',
+                    rows_got == 0 and 0 or rows_read / rows_got))
+print(string.format('space amplification: %.2f',
+                    after.disk.space_amplification))
+print(string.format('cache hit rate: %.3f',
+                    cache_lookup == 0 and 0 or cache_hits / cache_lookup))
+print(string.format('runs: %d, dumps: %d, compactions: %d',
+                    after.run_count,
+                    after.disk.dump.count - before.disk.dump.count,
+                    after.disk.compaction.count -
+                        before.disk.compaction.count))
+os.exit(0)
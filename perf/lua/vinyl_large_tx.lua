@@ -0,0 +1,113 @@
+--
+-- Measures the per-statement cost of large vinyl transactions.
+--
+-- Usage:
+--
+--   tarantool vinyl_large_tx.lua [--stmts N] [--count N]
+--                                [--order asc|desc|random]
+--                                [--secondary] [--insert] [--dir PATH]
+--
+-- The benchmark commits transactions of --stmts statements each until
+-- --count statements are written and prints the number of statements
+-- per second. Every transaction writes new keys in the given --order,
+-- so the cost of the transaction write set depends on the order and
+-- the size of the transaction. --secondary adds a secondary index, so
+-- that each statement is added to the write set twice. --insert uses
+-- insert instead of replace, which adds a uniqueness check and a read
+-- interval to the read set per statement.
+--
+
+local clock = require('clock')
+local fio = require('fio')
+
+local params = {
+    stmts = 10000,
+    count = 1000000,
+    order = 'asc',
+    secondary = false,
+    insert = false,
+    dir = '',
+}
+
+local i = 1
+while i <= #arg do
+    local name = arg[i]:match('^%-%-(.+)$')
+    if name == nil then
+        error('Unexpected argument: ' .. arg[i])
+    end
+    name = name:gsub('-', '_')
+    if type(params[name]) == 'boolean' then
+        params[name] = true
+    elseif type(params[name]) == 'number' then
+        i = i + 1
+        params[name] = tonumber(arg[i])
+    elseif type(params[name]) == 'string' then
+        i = i + 1
+        params[name] = arg[i]
+    else
+        error('Unknown option: ' .. arg[i])
+    end
+    i = i + 1
+end
+
+local orders = {asc = true, desc = true, random = true}
+if not orders[params.order] then
+    error('Unknown order: ' .. params.order)
+end
+
+local work_dir = params.dir
+if work_dir == '' then
+    work_dir = fio.tempdir()
+end
+
+box.cfg({
+    wal_mode = 'none',
+    vinyl_memory = 512 * 1024 * 1024,
+    log_level = 1,
+    work_dir = work_dir,
+})
+
+local s = box.schema.space.create('test', {engine = 'vinyl'})
+s:create_index('pk')
+if params.secondary then
+    s:create_index('sk', {parts = {{2, 'unsigned'}}})
+end
+
+-- Keys of one transaction, in the order they are written.
+local offsets = {}
+for n = 1, params.stmts do
+    offsets[n] = n - 1
+end
+if params.order == 'desc' then
+    for n = 1, params.stmts do
+        offsets[n] = params.stmts - n
+    end
+elseif params.order == 'random' then
+    math.randomseed(42)
+    for n = params.stmts, 2, -1 do
+        local j = math.random(n)
+        offsets[n], offsets[j] = offsets[j], offsets[n]
+    end
+end
+
+local write = params.insert and s.insert or s.replace
+local tx_count = math.floor(params.count / params.stmts)
+local start = clock.monotonic()
+for tx = 1, tx_count do
+    local base = (tx - 1) * params.stmts
+    box.begin()
+    for n = 1, params.stmts do
+        local key = base + offsets[n]
+        write(s, {key, key})
+    end
+    box.commit()
+end
+local elapsed = clock.monotonic() - start
+local total = tx_count * params.stmts
+
+print(string.format('stmts: %d, order: %s, secondary: %s, insert: %s',
+                    params.stmts, params.order, params.secondary,
+                    params.insert))
+print(string.format('%d statements in %.3f s, %d statements/s, %.0f ns/stmt',
+                    total, elapsed, total / elapsed, elapsed * 1e9 / total))
+os.exit(0)
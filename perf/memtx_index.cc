@@ -0,0 +1,546 @@
+#include "memory.h"
+#include "fiber.h"
+#include "tuple.h"
+#include "index.h"
+#include "schema.h"
+#include "engine.h"
+#include "blackhole.h"
+#include "memtx_engine.h"
+#include "memtx_tree.h"
+#include "memtx_hash.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <benchmark/benchmark.h>
+
+// Memory reserved for tuples and index extents. 100M entries with
+// the largest key kind take about 20 GB, so the arena is reserved
+// with a margin; the memory is only touched when it's used.
+const uint64_t MEMTX_MEMORY = 32ULL << 30;
+// Number of precomputed random lookup keys.
+const size_t NUM_LOOKUP_KEYS = 1 << 16;
+// Number of tuples read by one iterator benchmark operation.
+const size_t ITERATOR_LIMIT = 10;
+// Space id that is not used by any system space.
+const uint32_t SPACE_ID = 512;
+
+// Kinds of keys the indexes are built on.
+enum KeyKind {
+	// [unsigned]
+	KEY_UNSIGNED,
+	// [string]
+	KEY_STRING,
+	// [unsigned, string]
+	KEY_COMPOSITE,
+	// [*] of an array of 4 unsigned, TREE only.
+	KEY_MULTIKEY,
+	// .id of a map, unsigned.
+	KEY_JSON,
+};
+
+const char *const key_kind_strs[] = {
+	"unsigned", "string", "composite", "multikey", "json",
+};
+
+// Number of multikey index entries per tuple.
+const uint32_t MULTIKEY_COUNT = 4;
+
+// Maps a tuple number to a unique pseudo-random key.
+static uint32_t
+key_of(uint64_t i)
+{
+	return (uint32_t)(i * 2654435761ULL);
+}
+
+// Encodes the key of the i-th tuple, the j-th entry for multikey.
+static char *
+encode_key(char *data, enum KeyKind kind, uint64_t i, uint32_t j = 0)
+{
+	uint32_t k = key_of(i);
+	char buf[16];
+	int len;
+	switch (kind) {
+	case KEY_UNSIGNED:
+	case KEY_JSON:
+		return mp_encode_uint(data, k);
+	case KEY_STRING:
+		len = snprintf(buf, sizeof(buf), "%010u", k);
+		return mp_encode_str(data, buf, len);
+	case KEY_COMPOSITE:
+		data = mp_encode_uint(data, k >> 10);
+		len = snprintf(buf, sizeof(buf), "%04u", k & 1023);
+		return mp_encode_str(data, buf, len);
+	case KEY_MULTIKEY:
+		return mp_encode_uint(data, (uint64_t)k * MULTIKEY_COUNT + j);
+	}
+	abort();
+}
+
+static uint32_t
+key_part_count(enum KeyKind kind)
+{
+	return kind == KEY_COMPOSITE ? 2 : 1;
+}
+
+// Encodes the i-th tuple.
+static char *
+encode_tuple(char *data, enum KeyKind kind, uint64_t i)
+{
+	switch (kind) {
+	case KEY_UNSIGNED:
+	case KEY_STRING:
+		data = mp_encode_array(data, 1);
+		return encode_key(data, kind, i);
+	case KEY_COMPOSITE:
+		data = mp_encode_array(data, 2);
+		return encode_key(data, kind, i);
+	case KEY_MULTIKEY:
+		data = mp_encode_array(data, 1);
+		data = mp_encode_array(data, MULTIKEY_COUNT);
+		for (uint32_t j = 0; j < MULTIKEY_COUNT; j++)
+			data = encode_key(data, kind, i, j);
+		return data;
+	case KEY_JSON:
+		data = mp_encode_array(data, 1);
+		data = mp_encode_map(data, 1);
+		data = mp_encode_str(data, "id", 2);
+		return encode_key(data, kind, i);
+	}
+	abort();
+}
+
+static struct key_def *
+key_def_new_for_kind(enum KeyKind kind)
+{
+	struct key_part_def parts[2];
+	for (uint32_t i = 0; i < lengthof(parts); i++)
+		parts[i] = key_part_def_default;
+	parts[0].fieldno = 0;
+	parts[0].type = FIELD_TYPE_UNSIGNED;
+	switch (kind) {
+	case KEY_UNSIGNED:
+		break;
+	case KEY_STRING:
+		parts[0].type = FIELD_TYPE_STRING;
+		break;
+	case KEY_COMPOSITE:
+		parts[1].fieldno = 1;
+		parts[1].type = FIELD_TYPE_STRING;
+		break;
+	case KEY_MULTIKEY:
+		parts[0].path = "[*]";
+		break;
+	case KEY_JSON:
+		parts[0].path = ".id";
+		break;
+	}
+	struct key_def *def = key_def_new(parts, key_part_count(kind), false);
+	if (def == NULL)
+		abort();
+	return def;
+}
+
+// Class that creates a private memtx engine and the schema for it.
+// Indexes are created and used directly, without spaces.
+class MemtxEngine {
+public:
+	static MemtxEngine &instance()
+	{
+		static MemtxEngine instance;
+		return instance;
+	}
+	struct memtx_engine *engine() { return memtx; }
+private:
+	MemtxEngine()
+	{
+		memory_init();
+		fiber_init(fiber_c_invoke);
+		tuple_init(NULL);
+
+		char tmpl[] = "/tmp/memtx_index.perftest.XXXXXX";
+		if (mkdtemp(tmpl) == NULL)
+			abort();
+		dir = tmpl;
+		memtx = memtx_engine_new(dir.c_str(), false, MEMTX_MEMORY,
+					 16, false, 8, "small", 1.05, false,
+					 -1);
+		if (memtx == NULL)
+			abort();
+		engine_register((struct engine *)memtx);
+		struct engine *blackhole = blackhole_engine_new();
+		if (blackhole == NULL)
+			abort();
+		engine_register(blackhole);
+		schema_init();
+	}
+	~MemtxEngine()
+	{
+		rmdir(dir.c_str());
+	}
+
+	std::string dir;
+	struct memtx_engine *memtx;
+};
+
+// Hardware cache miss counter of the calling thread. Reads zero if
+// perf events aren't available, e.g. in a container.
+class CacheMisses {
+public:
+	CacheMisses()
+	{
+		fd = -1;
+#if defined(__linux__)
+		struct perf_event_attr attr;
+		memset(&attr, 0, sizeof(attr));
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.size = sizeof(attr);
+		attr.config = PERF_COUNT_HW_CACHE_MISSES;
+		attr.disabled = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		fd = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+	}
+	~CacheMisses()
+	{
+		if (fd >= 0)
+			close(fd);
+	}
+	bool available() const { return fd >= 0; }
+	void start()
+	{
+#if defined(__linux__)
+		if (fd >= 0) {
+			ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+			ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+		}
+#endif
+	}
+	void stop()
+	{
+#if defined(__linux__)
+		if (fd >= 0)
+			ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+#endif
+	}
+	uint64_t read() const
+	{
+		uint64_t count = 0;
+		if (fd >= 0 && ::read(fd, &count, sizeof(count)) !=
+			       sizeof(count))
+			count = 0;
+		return count;
+	}
+private:
+	int fd;
+};
+
+// Tuples of one key kind and the index built on them. Only one data
+// set is kept at a time because the big ones take gigabytes.
+class DataSet {
+public:
+	static DataSet &get(enum KeyKind kind, size_t size)
+	{
+		static DataSet *current = NULL;
+		if (current != NULL && current->kind == kind &&
+		    current->size == size)
+			return *current;
+		delete current;
+		current = new DataSet(kind, size);
+		return *current;
+	}
+	struct index *new_index(enum index_type type)
+	{
+		struct index_def *def = index_def_new(SPACE_ID, 0, "pk", 2,
+						      type, &index_opts_default,
+						      key_def, NULL);
+		if (def == NULL)
+			abort();
+		struct memtx_engine *memtx = MemtxEngine::instance().engine();
+		struct index *index = type == TREE ?
+				      memtx_tree_index_new(memtx, def) :
+				      memtx_hash_index_new(memtx, def);
+		index_def_delete(def);
+		if (index == NULL)
+			abort();
+		return index;
+	}
+	void fill(struct index *index)
+	{
+		for (size_t i = 0; i < size; i++) {
+			struct tuple *result, *successor;
+			if (index_replace(index, NULL, tuples[i], DUP_INSERT,
+					  &result, &successor) != 0)
+				abort();
+		}
+	}
+	// Returns the index of the given type filled with all tuples.
+	struct index *index(enum index_type type)
+	{
+		if (idx != NULL && idx_type == type)
+			return idx;
+		if (idx != NULL)
+			index_delete(idx);
+		idx = new_index(type);
+		idx_type = type;
+		fill(idx);
+		return idx;
+	}
+	const char *key(size_t i) { return keys.data() + key_offsets[i]; }
+	uint32_t part_count() const { return key_part_count(kind); }
+private:
+	DataSet(enum KeyKind kind, size_t size)
+		: kind(kind), size(size), idx(NULL), idx_type(TREE)
+	{
+		MemtxEngine::instance();
+		key_def = key_def_new_for_kind(kind);
+		format = tuple_format_new(&memtx_tuple_format_vtab,
+					  MemtxEngine::instance().engine(),
+					  &key_def, 1, NULL, 0, 0, NULL, false,
+					  false);
+		if (format == NULL)
+			abort();
+		tuple_format_ref(format);
+		tuples.resize(size);
+		for (size_t i = 0; i < size; i++) {
+			char data[64];
+			char *end = encode_tuple(data, kind, i);
+			tuples[i] = tuple_new(format, data, end);
+			if (tuples[i] == NULL)
+				abort();
+			tuple_ref(tuples[i]);
+		}
+		keys.resize(NUM_LOOKUP_KEYS * 16);
+		key_offsets.resize(NUM_LOOKUP_KEYS);
+		char *data = keys.data();
+		for (size_t i = 0; i < NUM_LOOKUP_KEYS; i++) {
+			key_offsets[i] = data - keys.data();
+			data = encode_key(data, kind, rand() % size,
+					  rand() % MULTIKEY_COUNT);
+		}
+	}
+	~DataSet()
+	{
+		if (idx != NULL)
+			index_delete(idx);
+		for (size_t i = 0; i < size; i++)
+			tuple_unref(tuples[i]);
+		tuple_format_unref(format);
+		key_def_delete(key_def);
+	}
+	enum KeyKind kind;
+	size_t size;
+	struct key_def *key_def;
+	struct tuple_format *format;
+	std::vector<struct tuple *> tuples;
+	std::vector<char> keys;
+	std::vector<size_t> key_offsets;
+	struct index *idx;
+	enum index_type idx_type;
+};
+
+static void
+report(benchmark::State& state, size_t op_count, CacheMisses &misses,
+       struct index *index)
+{
+	state.SetItemsProcessed(op_count);
+	state.counters["op_time"] = benchmark::Counter(
+		op_count, benchmark::Counter::kIsRate |
+			  benchmark::Counter::kInvert);
+	if (misses.available()) {
+		state.counters["cache_misses"] = benchmark::Counter(
+			(double)misses.read() / op_count);
+	}
+	state.counters["bytes_per_entry"] = benchmark::Counter(
+		(double)index_bsize(index) / index_size(index));
+}
+
+static void
+index_replace_bench(benchmark::State& state, enum index_type type)
+{
+	enum KeyKind kind = (enum KeyKind)state.range(0);
+	size_t size = state.range(1);
+	DataSet &data = DataSet::get(kind, size);
+	CacheMisses misses;
+	size_t total_count = 0;
+	struct index *index = NULL;
+	for (auto _ : state) {
+		state.PauseTiming();
+		if (index != NULL)
+			index_delete(index);
+		index = data.new_index(type);
+		misses.start();
+		state.ResumeTiming();
+		data.fill(index);
+		misses.stop();
+		total_count += size;
+	}
+	report(state, total_count, misses, index);
+	index_delete(index);
+}
+
+static void
+tree_replace(benchmark::State& state)
+{
+	index_replace_bench(state, TREE);
+}
+
+static void
+hash_replace(benchmark::State& state)
+{
+	index_replace_bench(state, HASH);
+}
+
+static void
+index_get_bench(benchmark::State& state, enum index_type type)
+{
+	enum KeyKind kind = (enum KeyKind)state.range(0);
+	size_t size = state.range(1);
+	DataSet &data = DataSet::get(kind, size);
+	struct index *index = data.index(type);
+	uint32_t part_count = data.part_count();
+	CacheMisses misses;
+	size_t total_count = 0;
+	misses.start();
+	for (auto _ : state) {
+		const char *key = data.key(total_count % NUM_LOOKUP_KEYS);
+		struct tuple *result;
+		if (index_get(index, key, part_count, &result) != 0 ||
+		    result == NULL)
+			abort();
+		benchmark::DoNotOptimize(result);
+		total_count++;
+	}
+	misses.stop();
+	report(state, total_count, misses, index);
+}
+
+static void
+tree_get(benchmark::State& state)
+{
+	index_get_bench(state, TREE);
+}
+
+static void
+hash_get(benchmark::State& state)
+{
+	index_get_bench(state, HASH);
+}
+
+static void
+tree_iterator(benchmark::State& state)
+{
+	enum KeyKind kind = (enum KeyKind)state.range(0);
+	size_t size = state.range(1);
+	DataSet &data = DataSet::get(kind, size);
+	struct index *index = data.index(TREE);
+	uint32_t part_count = data.part_count();
+	CacheMisses misses;
+	size_t total_count = 0;
+	misses.start();
+	for (auto _ : state) {
+		const char *key = data.key(total_count % NUM_LOOKUP_KEYS);
+		struct iterator *it = index_create_iterator(index, ITER_GE,
+							    key, part_count);
+		if (it == NULL)
+			abort();
+		for (size_t i = 0; i < ITERATOR_LIMIT; i++) {
+			struct tuple *tuple;
+			if (iterator_next(it, &tuple) != 0)
+				abort();
+			benchmark::DoNotOptimize(tuple);
+		}
+		iterator_delete(it);
+		total_count++;
+	}
+	misses.stop();
+	report(state, total_count, misses, index);
+}
+
+// Index sizes from 1M to 100M entries. Use --benchmark_filter to run
+// only some of them: the biggest ones take minutes to build and tens
+// of gigabytes of memory.
+static void
+tree_args(benchmark::internal::Benchmark *b)
+{
+	b->ArgNames({"key", "size"});
+	for (int kind = KEY_UNSIGNED; kind <= KEY_JSON; kind++) {
+		for (int64_t size = 1000000; size <= 100000000; size *= 10)
+			b->Args({kind, size});
+	}
+}
+
+// HASH indexes don't support multikey parts.
+static void
+hash_args(benchmark::internal::Benchmark *b)
+{
+	b->ArgNames({"key", "size"});
+	for (int kind = KEY_UNSIGNED; kind <= KEY_JSON; kind++) {
+		if (kind == KEY_MULTIKEY)
+			continue;
+		for (int64_t size = 1000000; size <= 100000000; size *= 10)
+			b->Args({kind, size});
+	}
+}
+
+BENCHMARK(tree_replace)
+	->Apply(tree_args)
+	->Unit(benchmark::kMillisecond);
+
+BENCHMARK(tree_get)->Apply(tree_args);
+
+BENCHMARK(tree_iterator)->Apply(tree_args);
+
+BENCHMARK(hash_replace)
+	->Apply(hash_args)
+	->Unit(benchmark::kMillisecond);
+
+BENCHMARK(hash_get)->Apply(hash_args);
+
+int
+main(int argc, char **argv)
+{
+	std::cout << "Key kinds:";
+	for (int kind = KEY_UNSIGNED; kind <= KEY_JSON; kind++)
+		std::cout << " " << kind << " = " << key_kind_strs[kind];
+	std::cout << std::endl;
+	::benchmark::Initialize(&argc, argv);
+	if (::benchmark::ReportUnrecognizedArguments(argc, argv))
+		return 1;
+	::benchmark::RunSpecifiedBenchmarks();
+	return 0;
+}
+
+static void
+show_warning_if_debug()
+{
+#ifndef NDEBUG
+	std::cerr << "#######################################################\n"
+		  << "#######################################################\n"
+		  << "#######################################################\n"
+		  << "###                                                 ###\n"
+		  << "###                    WARNING!                     ###\n"
+		  << "###   The performance test is run in debug build!   ###\n"
+		  << "###   Test results are definitely inappropriate!    ###\n"
+		  << "###                                                 ###\n"
+		  << "#######################################################\n"
+		  << "#######################################################\n"
+		  << "#######################################################\n";
+#endif // #ifndef NDEBUG
+}
+
+struct DebugWarning {
+	DebugWarning() { show_warning_if_debug(); }
+} debug_warning;
@@ -0,0 +1,192 @@
+#include "salad/rtree.h"
+
+#include <stdlib.h>
+
+#include <iostream>
+#include <benchmark/benchmark.h>
+
+const size_t NUM_POINTS = 1000000;
+const uint32_t EXTENT_SIZE = 16 * 1024;
+const coord_t WORLD_SIZE = 10000;
+
+static void *
+extent_alloc(void *ctx)
+{
+	(void)ctx;
+	return malloc(EXTENT_SIZE);
+}
+
+static void
+extent_free(void *ctx, void *extent)
+{
+	(void)ctx;
+	free(extent);
+}
+
+static coord_t
+random_coord()
+{
+	return (coord_t)rand() / RAND_MAX * WORLD_SIZE;
+}
+
+// Class that creates a 2D tree of random points, bulk loaded or
+// built by inserting the points one by one.
+class Points {
+public:
+	static Points &instance()
+	{
+		static Points instance;
+		return instance;
+	}
+	struct rtree *tree(bool bulk)
+	{
+		return bulk ? &bulk_tree : &insert_tree;
+	}
+	struct rtree_rect *point(size_t i) { return &points[i]; }
+	void load(struct rtree *tree)
+	{
+		struct rtree_builder builder;
+		rtree_builder_create(&builder);
+		for (size_t i = 0; i < NUM_POINTS; i++) {
+			if (rtree_builder_add(&builder, tree, &points[i],
+					      (record_t)(i + 1)) != 0)
+				abort();
+		}
+		if (rtree_builder_load(&builder, tree) != 0)
+			abort();
+		rtree_builder_destroy(&builder);
+	}
+	void insert(struct rtree *tree)
+	{
+		for (size_t i = 0; i < NUM_POINTS; i++)
+			rtree_insert(tree, &points[i], (record_t)(i + 1));
+	}
+private:
+	Points()
+	{
+		points = new struct rtree_rect[NUM_POINTS];
+		for (size_t i = 0; i < NUM_POINTS; i++)
+			rtree_set2dp(&points[i], random_coord(),
+				     random_coord());
+		create(&bulk_tree);
+		load(&bulk_tree);
+		create(&insert_tree);
+		insert(&insert_tree);
+	}
+	~Points()
+	{
+		rtree_destroy(&bulk_tree);
+		rtree_destroy(&insert_tree);
+		delete[] points;
+	}
+	static void create(struct rtree *tree)
+	{
+		rtree_init(tree, 2, EXTENT_SIZE, extent_alloc, extent_free,
+			   NULL, RTREE_EUCLID);
+	}
+	struct rtree_rect *points;
+	struct rtree bulk_tree;
+	struct rtree insert_tree;
+};
+
+static void
+rtree_build(benchmark::State& state)
+{
+	bool bulk = state.range(0) != 0;
+	Points &points = Points::instance();
+	for (auto _ : state) {
+		struct rtree tree;
+		rtree_init(&tree, 2, EXTENT_SIZE, extent_alloc, extent_free,
+			   NULL, RTREE_EUCLID);
+		if (bulk)
+			points.load(&tree);
+		else
+			points.insert(&tree);
+		rtree_destroy(&tree);
+	}
+	state.SetItemsProcessed(state.iterations() * NUM_POINTS);
+}
+
+BENCHMARK(rtree_build)
+	->ArgNames({"bulk"})
+	->Args({0})
+	->Args({1})
+	->Unit(benchmark::kMillisecond);
+
+static void
+rtree_neighbor(benchmark::State& state)
+{
+	bool bulk = state.range(0) != 0;
+	size_t limit = state.range(1);
+	struct rtree *tree = Points::instance().tree(bulk);
+	struct rtree_iterator iterator;
+	rtree_iterator_init(&iterator);
+	size_t total_count = 0;
+	for (auto _ : state) {
+		struct rtree_rect rect;
+		rtree_set2dp(&rect, random_coord(), random_coord());
+		if (!rtree_search(tree, &rect, SOP_NEIGHBOR, &iterator))
+			abort();
+		for (size_t i = 0; i < limit; i++) {
+			record_t rec = rtree_iterator_next(&iterator);
+			benchmark::DoNotOptimize(rec);
+		}
+		total_count++;
+	}
+	rtree_iterator_destroy(&iterator);
+	state.SetItemsProcessed(total_count);
+}
+
+BENCHMARK(rtree_neighbor)
+	->ArgNames({"bulk", "limit"})
+	->ArgsProduct({{0, 1}, {1, 10, 100}});
+
+static void
+rtree_overlaps(benchmark::State& state)
+{
+	bool bulk = state.range(0) != 0;
+	struct rtree *tree = Points::instance().tree(bulk);
+	struct rtree_iterator iterator;
+	rtree_iterator_init(&iterator);
+	size_t total_count = 0;
+	for (auto _ : state) {
+		struct rtree_rect rect;
+		coord_t x = random_coord(), y = random_coord();
+		rtree_set2d(&rect, x, y, x + WORLD_SIZE / 100,
+			    y + WORLD_SIZE / 100);
+		rtree_search(tree, &rect, SOP_OVERLAPS, &iterator);
+		while (rtree_iterator_next(&iterator) != NULL)
+			total_count++;
+	}
+	rtree_iterator_destroy(&iterator);
+	state.SetItemsProcessed(total_count);
+}
+
+BENCHMARK(rtree_overlaps)
+	->ArgNames({"bulk"})
+	->Args({0})
+	->Args({1});
+
+BENCHMARK_MAIN();
+
+static void
+show_warning_if_debug()
+{
+#ifndef NDEBUG
+	std::cerr << "#######################################################\n"
+		  << "#######################################################\n"
+		  << "#######################################################\n"
+		  << "###                                                 ###\n"
+		  << "###                    WARNING!                     ###\n"
+		  << "###   The performance test is run in debug build!   ###\n"
+		  << "###   Test results are definitely inappropriate!    ###\n"
+		  << "###                                                 ###\n"
+		  << "#######################################################\n"
+		  << "#######################################################\n"
+		  << "#######################################################\n";
+#endif // #ifndef NDEBUG
+}
+
+struct DebugWarning {
+	DebugWarning() { show_warning_if_debug(); }
+} debug_warning;
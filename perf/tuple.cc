@@ -431,6 +431,61 @@ tuple_tuple_compare_hint(benchmark::State& state)
 
 BENCHMARK(tuple_tuple_compare_hint);
 
+// Benchmark of an update that increments a counter and appends an
+// element to a large array field: {counter, {...}, nil, 0, key}.
+// The cost of the update grows with the size of the array, because
+// the new tuple is a copy of the old one.
+static void
+tuple_update_large_array(benchmark::State& state)
+{
+	struct tuple_format *format = MemtxEngine::instance().format();
+	uint32_t array_size = state.range(0);
+	size_t size = 64 + array_size * mp_sizeof_uint(0xFFFFFF);
+	char *data = (char *)xmalloc(size);
+	char *data_end = data;
+	data_end = mp_encode_array(data_end, 5);
+	data_end = mp_encode_uint(data_end, 0);
+	data_end = mp_encode_array(data_end, array_size);
+	for (uint32_t i = 0; i < array_size; i++)
+		data_end = mp_encode_uint(data_end, 0xFFFFFF);
+	data_end = mp_encode_nil(data_end);
+	data_end = mp_encode_uint(data_end, 0);
+	data_end = mp_encode_uint(data_end, 1);
+	assert(data_end <= data + size);
+	struct tuple *tuple = box_tuple_new(format, data, data_end);
+	tuple_ref(tuple);
+
+	char path[32];
+	int path_len = snprintf(path, sizeof(path), "[2][%u]", array_size + 1);
+	char ops[128];
+	char *ops_end = ops;
+	ops_end = mp_encode_array(ops_end, 2);
+	ops_end = mp_encode_array(ops_end, 3);
+	ops_end = mp_encode_str(ops_end, "+", 1);
+	ops_end = mp_encode_uint(ops_end, 1);
+	ops_end = mp_encode_uint(ops_end, 1);
+	ops_end = mp_encode_array(ops_end, 3);
+	ops_end = mp_encode_str(ops_end, "!", 1);
+	ops_end = mp_encode_str(ops_end, path, path_len);
+	ops_end = mp_encode_uint(ops_end, 0xFFFFFF);
+
+	size_t total_count = 0;
+	for (auto _ : state) {
+		struct tuple *result = box_tuple_update(tuple, ops, ops_end);
+		if (result == NULL)
+			abort();
+		benchmark::DoNotOptimize(result);
+		++total_count;
+	}
+	state.SetItemsProcessed(total_count);
+	state.SetBytesProcessed(total_count * (data_end - data));
+
+	tuple_unref(tuple);
+	free(data);
+}
+
+BENCHMARK(tuple_update_large_array)->RangeMultiplier(8)->Range(8, 32768);
+
 BENCHMARK_MAIN();
 
 static void
@@ -0,0 +1,339 @@
+#include "memory.h"
+#include "fiber.h"
+#include "cbus.h"
+#include "clock.h"
+#include "coio_task.h"
+#include "latency.h"
+#include "journal.h"
+#include "wal.h"
+#include "xrow.h"
+#include "replication.h"
+#include "iproto_constants.h"
+#include "info/info.h"
+
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+// Number of journal writes done by each fiber in one iteration.
+const size_t WRITES_PER_FIBER = 100;
+// Size of a WAL file.
+const int64_t WAL_MAX_SIZE = 64 * 1024 * 1024;
+// Maximal size of a group commit batch, if it's enabled.
+const int64_t GROUP_COMMIT_MAX_SIZE = 1024 * 1024;
+
+// WAL mode, set with --wal-mode.
+static enum wal_mode bench_wal_mode = WAL_FSYNC;
+
+static void
+tx_prio_cb(struct ev_loop *loop, ev_watcher *watcher, int events)
+{
+	(void)loop;
+	(void)events;
+	struct cbus_endpoint *endpoint = (struct cbus_endpoint *)watcher->data;
+	cbus_process(endpoint);
+}
+
+static void
+on_garbage_collection(const struct vclock *vclock)
+{
+	(void)vclock;
+}
+
+static void
+on_checkpoint_threshold(void)
+{
+}
+
+// Runs the given function in the given number of fibers and returns
+// when all of them are done.
+static void
+run_fibers(size_t count, int (*f)(va_list), void *arg)
+{
+	static size_t running;
+	struct Wrapper {
+		static int
+		f(va_list ap)
+		{
+			int (*func)(va_list) = va_arg(ap, int (*)(va_list));
+			va_list ap2;
+			va_copy(ap2, ap);
+			func(ap2);
+			va_end(ap2);
+			if (--running == 0)
+				ev_break(loop(), EVBREAK_ALL);
+			return 0;
+		}
+	};
+	running = count;
+	for (size_t i = 0; i < count; i++) {
+		struct fiber *fiber = fiber_new("bench", Wrapper::f);
+		if (fiber == NULL)
+			abort();
+		fiber_start(fiber, f, arg);
+	}
+	if (running > 0)
+		ev_run(loop(), 0);
+}
+
+// WAL writer statistics, see wal_stat().
+struct WalStat {
+	int64_t writes;
+	int64_t entries;
+};
+
+static void
+wal_stat_append_int(struct info_handler *h, const char *key, int64_t value)
+{
+	struct WalStat *stat = (struct WalStat *)h->ctx;
+	if (strcmp(key, "writes") == 0)
+		stat->writes = value;
+	else if (strcmp(key, "entries") == 0)
+		stat->entries = value;
+}
+
+static void
+wal_stat_nop(struct info_handler *h)
+{
+	(void)h;
+}
+
+static void
+wal_stat_nop_key(struct info_handler *h, const char *key)
+{
+	(void)h;
+	(void)key;
+}
+
+static void
+wal_stat_nop_str(struct info_handler *h, const char *key, const char *value)
+{
+	(void)h;
+	(void)key;
+	(void)value;
+}
+
+static void
+wal_stat_nop_double(struct info_handler *h, const char *key, double value)
+{
+	(void)h;
+	(void)key;
+	(void)value;
+}
+
+static int
+wal_stat_f(va_list ap)
+{
+	struct WalStat *stat = va_arg(ap, struct WalStat *);
+	static struct info_handler_vtab vtab = {
+		wal_stat_nop, wal_stat_nop, wal_stat_nop_key, wal_stat_nop,
+		wal_stat_nop_str, wal_stat_append_int, wal_stat_nop_double,
+	};
+	struct info_handler h;
+	h.vtab = &vtab;
+	h.ctx = stat;
+	wal_stat(&h);
+	return 0;
+}
+
+static struct WalStat
+wal_stat_get(void)
+{
+	struct WalStat stat;
+	memset(&stat, 0, sizeof(stat));
+	run_fibers(1, wal_stat_f, &stat);
+	return stat;
+}
+
+// Class that starts the WAL writer in a temporary directory and
+// removes the directory on exit. Set TMPDIR to run the benchmark on
+// a particular disk.
+class WalWriter {
+public:
+	static WalWriter &instance()
+	{
+		static WalWriter instance;
+		return instance;
+	}
+private:
+	WalWriter()
+	{
+		memory_init();
+		fiber_init(fiber_c_invoke);
+		coio_init();
+		coio_enable();
+		cbus_init();
+		cbus_endpoint_create(&tx_prio_endpoint, "tx_prio", tx_prio_cb,
+				     &tx_prio_endpoint);
+		const char *tmpdir = getenv("TMPDIR");
+		snprintf(dir, sizeof(dir), "%s/wal.XXXXXX",
+			 tmpdir != NULL ? tmpdir : "/tmp");
+		if (mkdtemp(dir) == NULL)
+			abort();
+		struct tt_uuid uuid;
+		tt_uuid_create(&uuid);
+		instance_id = 1;
+		if (wal_init(bench_wal_mode, WAL_IO_BUFFERED, dir, WAL_MAX_SIZE,
+			     0, &uuid, on_garbage_collection,
+			     on_checkpoint_threshold) != 0 ||
+		    wal_enable() != 0)
+			abort();
+	}
+	~WalWriter()
+	{
+		wal_free();
+		std::string cmd = std::string("rm -rf ") + dir;
+		if (system(cmd.c_str()) != 0)
+			std::cerr << "Failed to remove " << dir << std::endl;
+	}
+
+	char dir[PATH_MAX];
+	struct cbus_endpoint tx_prio_endpoint;
+};
+
+// Parameters and results of one iteration of wal_write.
+struct WriteCtx {
+	size_t row_size;
+	const char *body;
+	struct latency *latency;
+};
+
+static int
+wal_write_f(va_list ap)
+{
+	struct WriteCtx *ctx = va_arg(ap, struct WriteCtx *);
+	struct region *region = &fiber()->gc;
+	for (size_t i = 0; i < WRITES_PER_FIBER; i++) {
+		size_t svp = region_used(region);
+		struct xrow_header row;
+		memset(&row, 0, sizeof(row));
+		row.type = IPROTO_INSERT;
+		row.bodycnt = 1;
+		row.body[0].iov_base = (void *)ctx->body;
+		row.body[0].iov_len = ctx->row_size;
+		struct journal_entry *entry = journal_entry_new(
+			1, region, journal_entry_fiber_wakeup_cb, fiber());
+		if (entry == NULL)
+			abort();
+		entry->rows[0] = &row;
+		entry->approx_len = xrow_approx_len(&row);
+		double start = clock_monotonic();
+		if (journal_write(entry) != 0 || entry->res < 0)
+			abort();
+		latency_collect(ctx->latency, clock_monotonic() - start);
+		region_truncate(region, svp);
+	}
+	return 0;
+}
+
+// Submit journal entries of one row from many fibers, each waiting
+// for its write to complete before submitting the next one, like
+// autocommit transactions do. The arguments are the number of fibers,
+// the row body size and the group commit delay in microseconds. The
+// WAL mode is set with --wal-mode, fsync by default.
+//
+// Besides the rate of entries, reports the rate of WAL writes, which
+// is the rate of fsyncs in the fsync mode, the average number of
+// entries per write and percentiles of the commit latency.
+static void
+wal_write(benchmark::State& state)
+{
+	size_t fiber_count = state.range(0);
+	size_t row_size = state.range(1);
+	double group_commit_delay = state.range(2) / 1e6;
+	WalWriter::instance();
+	wal_set_group_commit(group_commit_delay, GROUP_COMMIT_MAX_SIZE);
+	std::vector<char> body(row_size, 'x');
+	struct latency latency;
+	if (latency_create(&latency) != 0)
+		abort();
+	struct WriteCtx ctx;
+	ctx.row_size = row_size;
+	ctx.body = body.data();
+	ctx.latency = &latency;
+	struct WalStat start = wal_stat_get();
+	size_t total_count = 0;
+	for (auto _ : state) {
+		run_fibers(fiber_count, wal_write_f, &ctx);
+		total_count += fiber_count * WRITES_PER_FIBER;
+	}
+	struct WalStat end = wal_stat_get();
+	wal_set_group_commit(0, GROUP_COMMIT_MAX_SIZE);
+	int64_t writes = end.writes - start.writes;
+	int64_t entries = end.entries - start.entries;
+	state.SetItemsProcessed(total_count);
+	state.counters["write_rate"] = benchmark::Counter(
+		writes, benchmark::Counter::kIsRate);
+	state.counters["batch_size"] = benchmark::Counter(
+		writes > 0 ? (double)entries / writes : 0);
+	state.counters["p50_us"] = benchmark::Counter(
+		latency_get(&latency, 50) * 1e6);
+	state.counters["p99_us"] = benchmark::Counter(
+		latency_get(&latency, 99) * 1e6);
+	state.counters["p99.9_us"] = benchmark::Counter(
+		latency_get(&latency, 99.9) * 1e6);
+	latency_destroy(&latency);
+}
+
+BENCHMARK(wal_write)
+	->ArgNames({"fibers", "row_size", "group_commit_us"})
+	->ArgsProduct({{1, 16, 256}, {64, 1024}, {0, 1000}})
+	->Unit(benchmark::kMillisecond)
+	->UseRealTime();
+
+int
+main(int argc, char **argv)
+{
+	// Take --wal-mode=write|fsync out before parsing benchmark flags.
+	int new_argc = 0;
+	for (int i = 0; i < argc; i++) {
+		const char *prefix = "--wal-mode=";
+		if (strncmp(argv[i], prefix, strlen(prefix)) == 0) {
+			const char *mode = argv[i] + strlen(prefix);
+			bench_wal_mode = (enum wal_mode)strindex(
+				wal_mode_STRS, mode, WAL_MODE_MAX);
+			if (bench_wal_mode == WAL_MODE_MAX ||
+			    bench_wal_mode == WAL_NONE) {
+				std::cerr << "Invalid WAL mode: " << mode
+					  << std::endl;
+				return 1;
+			}
+			continue;
+		}
+		argv[new_argc++] = argv[i];
+	}
+	argc = new_argc;
+	::benchmark::Initialize(&argc, argv);
+	if (::benchmark::ReportUnrecognizedArguments(argc, argv))
+		return 1;
+	::benchmark::RunSpecifiedBenchmarks();
+	return 0;
+}
+
+static void
+show_warning_if_debug()
+{
+#ifndef NDEBUG
+	std::cerr << "#######################################################\n"
+		  << "#######################################################\n"
+		  << "#######################################################\n"
+		  << "###                                                 ###\n"
+		  << "###                    WARNING!                     ###\n"
+		  << "###   The performance test is run in debug build!   ###\n"
+		  << "###   Test results are definitely inappropriate!    ###\n"
+		  << "###                                                 ###\n"
+		  << "#######################################################\n"
+		  << "#######################################################\n"
+		  << "#######################################################\n";
+#endif // #ifndef NDEBUG
+}
+
+struct DebugWarning {
+	DebugWarning() { show_warning_if_debug(); }
+} debug_warning;
@@ -0,0 +1,156 @@
+#include "memory.h"
+#include "fiber.h"
+#include "xlog.h"
+#include "xrow.h"
+#include "iproto_constants.h"
+
+#include <fcntl.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <iostream>
+#include <map>
+#include <string>
+#include <benchmark/benchmark.h>
+
+const size_t NUM_ROWS = 1000000;
+const size_t ROW_SIZE = 100;
+
+// Class that writes test xlog files, one per number of rows per
+// transaction, and removes them on exit.
+class XlogFiles {
+public:
+	static XlogFiles &instance()
+	{
+		static XlogFiles instance;
+		return instance;
+	}
+	const char *path(size_t rows_per_tx)
+	{
+		std::string &path = files[rows_per_tx];
+		if (path.empty())
+			path = write(rows_per_tx);
+		return path.c_str();
+	}
+private:
+	XlogFiles()
+	{
+		memory_init();
+		fiber_init(fiber_c_invoke);
+		snprintf(dir, sizeof(dir), "/tmp/xlog_cursor.XXXXXX");
+		if (mkdtemp(dir) == NULL)
+			abort();
+	}
+	~XlogFiles()
+	{
+		for (auto &file : files)
+			unlink(file.second.c_str());
+		rmdir(dir);
+		fiber_free();
+		memory_free();
+	}
+
+	std::string write(size_t rows_per_tx)
+	{
+		std::string path = std::string(dir) + "/" +
+				   std::to_string(rows_per_tx) + ".xlog";
+		struct tt_uuid uuid;
+		memset(&uuid, 0, sizeof(uuid));
+		struct xlog_meta meta;
+		xlog_meta_create(&meta, "XLOG", &uuid, NULL, NULL);
+		struct xlog xlog;
+		if (xlog_create(&xlog, path.c_str(), 0, &meta,
+				&xlog_opts_default) != 0)
+			abort();
+		char body[ROW_SIZE];
+		memset(body, 'x', sizeof(body));
+		struct xrow_header row;
+		memset(&row, 0, sizeof(row));
+		row.type = IPROTO_INSERT;
+		row.replica_id = 1;
+		row.bodycnt = 1;
+		row.body[0].iov_base = body;
+		row.body[0].iov_len = sizeof(body);
+		for (size_t i = 0; i < NUM_ROWS; i += rows_per_tx) {
+			xlog_tx_begin(&xlog);
+			for (size_t j = 0; j < rows_per_tx; j++) {
+				row.lsn = i + j + 1;
+				if (xlog_write_row(&xlog, &row) < 0)
+					abort();
+			}
+			if (xlog_tx_commit(&xlog) < 0)
+				abort();
+		}
+		if (xlog_flush(&xlog) < 0)
+			abort();
+		xlog_close(&xlog, false);
+		return path;
+	}
+
+	char dir[PATH_MAX];
+	std::map<size_t, std::string> files;
+};
+
+// Replay a WAL file of NUM_ROWS rows. The first argument is the
+// number of rows per transaction: single-row transactions are
+// written uncompressed, big ones are compressed with zstd. The
+// second argument is set to read the file with mmap().
+static void
+xlog_cursor_replay(benchmark::State& state)
+{
+	const char *path = XlogFiles::instance().path(state.range(0));
+	bool use_mmap = state.range(1) != 0;
+	size_t total_count = 0;
+	for (auto _ : state) {
+		int fd = open(path, O_RDONLY);
+		if (fd < 0)
+			abort();
+		struct xlog_cursor cursor;
+		int rc = use_mmap ? xlog_cursor_openfd_mmap(&cursor, fd, path) :
+			 xlog_cursor_openfd(&cursor, fd, path);
+		if (rc != 0)
+			abort();
+		struct xrow_header row;
+		size_t count = 0;
+		while ((rc = xlog_cursor_next(&cursor, &row, false)) == 0) {
+			benchmark::DoNotOptimize(row.body[0].iov_base);
+			count++;
+		}
+		if (rc < 0 || count != NUM_ROWS)
+			abort();
+		xlog_cursor_close(&cursor, false);
+		total_count += count;
+	}
+	state.SetItemsProcessed(total_count);
+}
+
+BENCHMARK(xlog_cursor_replay)
+	->ArgNames({"rows_per_tx", "mmap"})
+	->ArgsProduct({{1, 100}, {0, 1}})
+	->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
+
+static void
+show_warning_if_debug()
+{
+#ifndef NDEBUG
+	std::cerr << "#######################################################\n"
+		  << "#######################################################\n"
+		  << "#######################################################\n"
+		  << "###                                                 ###\n"
+		  << "###                    WARNING!                     ###\n"
+		  << "###   The performance test is run in debug build!   ###\n"
+		  << "###   Test results are definitely inappropriate!    ###\n"
+		  << "###                                                 ###\n"
+		  << "#######################################################\n"
+		  << "#######################################################\n"
+		  << "#######################################################\n";
+#endif // #ifndef NDEBUG
+}
+
+struct DebugWarning {
+	DebugWarning() { show_warning_if_debug(); }
+} debug_warning;
@@ -0,0 +1,199 @@
+#include "memory.h"
+#include "fiber.h"
+#include "xlog.h"
+#include "xrow.h"
+#include "iproto_constants.h"
+
+#include <fcntl.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+// A file is closed and a new one is started when it grows beyond
+// this size, so that long runs don't fill the disk.
+const off_t MAX_FILE_SIZE = 64 * 1024 * 1024;
+
+// How a transaction is made durable.
+enum SyncMode {
+	// Written to the page cache, no sync.
+	SYNC_NONE,
+	// fdatasync() after each transaction.
+	SYNC_FDATASYNC,
+	// The file is opened with O_DSYNC.
+	SYNC_DSYNC,
+};
+
+// Class that creates a directory for test xlog files and removes it
+// on exit. Set TMPDIR to run the benchmark on a particular disk.
+class XlogDir {
+public:
+	static XlogDir &instance()
+	{
+		static XlogDir instance;
+		return instance;
+	}
+	std::string next_path()
+	{
+		return std::string(dir) + "/" + std::to_string(++count) +
+		       ".xlog";
+	}
+private:
+	XlogDir() : count(0)
+	{
+		memory_init();
+		fiber_init(fiber_c_invoke);
+		const char *tmpdir = getenv("TMPDIR");
+		snprintf(dir, sizeof(dir), "%s/xlog_write.XXXXXX",
+			 tmpdir != NULL ? tmpdir : "/tmp");
+		if (mkdtemp(dir) == NULL)
+			abort();
+	}
+	~XlogDir()
+	{
+		rmdir(dir);
+		fiber_free();
+		memory_free();
+	}
+
+	char dir[PATH_MAX];
+	size_t count;
+};
+
+// An xlog file that is rotated when it gets too big.
+class TestXlog {
+public:
+	TestXlog(bool compress, enum SyncMode sync_mode)
+		: sync_mode(sync_mode)
+	{
+		opts = xlog_opts_default;
+		opts.no_compression = !compress;
+		memset(&uuid, 0, sizeof(uuid));
+		open();
+	}
+	~TestXlog()
+	{
+		close();
+	}
+	struct xlog *get() { return &xlog; }
+	bool is_full() const { return xlog.offset > MAX_FILE_SIZE; }
+	void rotate()
+	{
+		close();
+		open();
+	}
+	// Makes the written transactions durable according to the mode.
+	void sync()
+	{
+		if (xlog_flush(&xlog) < 0)
+			abort();
+		if (sync_mode == SYNC_FDATASYNC && fdatasync(xlog.fd) != 0)
+			abort();
+	}
+private:
+	void open()
+	{
+		path = XlogDir::instance().next_path();
+		struct xlog_meta meta;
+		xlog_meta_create(&meta, "XLOG", &uuid, NULL, NULL);
+		int flags = sync_mode == SYNC_DSYNC ? O_DSYNC : 0;
+		if (xlog_create(&xlog, path.c_str(), flags, &meta, &opts) != 0)
+			abort();
+	}
+	void close()
+	{
+		xlog_close(&xlog, false);
+		unlink(path.c_str());
+	}
+
+	enum SyncMode sync_mode;
+	struct xlog_opts opts;
+	struct tt_uuid uuid;
+	struct xlog xlog;
+	std::string path;
+};
+
+// Write transactions with xlog_write_row() and xlog_tx_commit() and
+// flush each of them to the file, the way the WAL thread does for a
+// batch. The arguments are the row body size, the number of rows per
+// transaction, whether zstd compression is enabled and the sync mode,
+// see SyncMode. Compression only applies to transactions bigger than
+// XLOG_TX_COMPRESS_THRESHOLD.
+static void
+xlog_write_tx(benchmark::State& state)
+{
+	size_t row_size = state.range(0);
+	size_t rows_per_tx = state.range(1);
+	bool compress = state.range(2) != 0;
+	enum SyncMode sync_mode = (enum SyncMode)state.range(3);
+	XlogDir::instance();
+	TestXlog xlog(compress, sync_mode);
+	std::vector<char> body(row_size);
+	// Make the data compressible, like tuples usually are.
+	for (size_t i = 0; i < row_size; i++)
+		body[i] = 'a' + i % 16;
+	struct xrow_header row;
+	memset(&row, 0, sizeof(row));
+	row.type = IPROTO_INSERT;
+	row.replica_id = 1;
+	row.bodycnt = 1;
+	row.body[0].iov_base = body.data();
+	row.body[0].iov_len = row_size;
+	int64_t lsn = 0;
+	size_t tx_count = 0;
+	for (auto _ : state) {
+		if (xlog.is_full()) {
+			state.PauseTiming();
+			xlog.rotate();
+			state.ResumeTiming();
+		}
+		xlog_tx_begin(xlog.get());
+		for (size_t i = 0; i < rows_per_tx; i++) {
+			row.lsn = ++lsn;
+			if (xlog_write_row(xlog.get(), &row) < 0)
+				abort();
+		}
+		if (xlog_tx_commit(xlog.get()) < 0)
+			abort();
+		xlog.sync();
+		tx_count++;
+	}
+	state.SetItemsProcessed(tx_count * rows_per_tx);
+	state.SetBytesProcessed(tx_count * rows_per_tx * row_size);
+	state.counters["tx_rate"] = benchmark::Counter(
+		tx_count, benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(xlog_write_tx)
+	->ArgNames({"row_size", "rows_per_tx", "zstd", "sync"})
+	->ArgsProduct({{64, 512, 4096}, {1, 16}, {0, 1},
+		       {SYNC_NONE, SYNC_FDATASYNC, SYNC_DSYNC}});
+
+BENCHMARK_MAIN();
+
+static void
+show_warning_if_debug()
+{
+#ifndef NDEBUG
+	std::cerr << "#######################################################\n"
+		  << "#######################################################\n"
+		  << "#######################################################\n"
+		  << "###                                                 ###\n"
+		  << "###                    WARNING!                     ###\n"
+		  << "###   The performance test is run in debug build!   ###\n"
+		  << "###   Test results are definitely inappropriate!    ###\n"
+		  << "###                                                 ###\n"
+		  << "#######################################################\n"
+		  << "#######################################################\n"
+		  << "#######################################################\n";
+#endif // #ifndef NDEBUG
+}
+
+struct DebugWarning {
+	DebugWarning() { show_warning_if_debug(); }
+} debug_warning;
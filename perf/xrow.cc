@@ -0,0 +1,260 @@
+#include "memory.h"
+#include "fiber.h"
+#include "mp_skip.h"
+#include "msgpuck.h"
+#include "small/region.h"
+#include "xrow.h"
+#include "iproto_constants.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <iostream>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+// Kind of fields the test tuples consist of.
+enum TupleShape {
+	// Small unsigned integers, encoded in one byte each.
+	SHAPE_SMALL_INTS,
+	// Integers, strings, doubles and nils one after another.
+	SHAPE_MIXED,
+};
+
+// Class that initializes the memory and fiber subsystems needed to
+// encode rows.
+class Env {
+public:
+	static Env &instance()
+	{
+		static Env instance;
+		return instance;
+	}
+private:
+	Env()
+	{
+		memory_init();
+		fiber_init(fiber_c_invoke);
+	}
+	~Env()
+	{
+		fiber_free();
+		memory_free();
+	}
+};
+
+// Returns a MsgPack array of the given number of fields.
+static std::vector<char>
+make_tuple(size_t field_count, enum TupleShape shape)
+{
+	std::vector<char> buf(16 + field_count * 16);
+	char *data = buf.data();
+	data = mp_encode_array(data, field_count);
+	for (size_t i = 0; i < field_count; i++) {
+		if (shape == SHAPE_SMALL_INTS) {
+			data = mp_encode_uint(data, i % 128);
+			continue;
+		}
+		switch (i % 4) {
+		case 0:
+			data = mp_encode_uint(data, i * 1000);
+			break;
+		case 1:
+			data = mp_encode_str0(data, "value");
+			break;
+		case 2:
+			data = mp_encode_double(data, i * 0.5);
+			break;
+		default:
+			data = mp_encode_nil(data);
+			break;
+		}
+	}
+	buf.resize(data - buf.data());
+	return buf;
+}
+
+// Returns a REPLACE packet without the fixheader, the way it is
+// passed to xrow_header_decode() by iproto.
+static std::vector<char>
+make_replace_packet(const std::vector<char> &tuple)
+{
+	std::vector<char> body(16 + tuple.size());
+	char *data = body.data();
+	data = mp_encode_map(data, 2);
+	data = mp_encode_uint(data, IPROTO_SPACE_ID);
+	data = mp_encode_uint(data, 512);
+	data = mp_encode_uint(data, IPROTO_TUPLE);
+	memcpy(data, tuple.data(), tuple.size());
+	data += tuple.size();
+	body.resize(data - body.data());
+
+	struct xrow_header row;
+	memset(&row, 0, sizeof(row));
+	row.type = IPROTO_REPLACE;
+	row.bodycnt = 1;
+	row.body[0].iov_base = body.data();
+	row.body[0].iov_len = body.size();
+	struct region *region = &fiber()->gc;
+	size_t svp = region_used(region);
+	struct iovec iov[XROW_IOVMAX];
+	int iovcnt = xrow_header_encode(&row, 1, iov, 0);
+	if (iovcnt < 0)
+		abort();
+	std::vector<char> packet;
+	for (int i = 0; i < iovcnt; i++) {
+		const char *base = (const char *)iov[i].iov_base;
+		packet.insert(packet.end(), base, base + iov[i].iov_len);
+	}
+	region_truncate(region, svp);
+	return packet;
+}
+
+// Decode the header of a REPLACE request, which also validates the
+// body with mp_check_fast(). The arguments are the number of tuple
+// fields and the tuple shape, see TupleShape.
+static void
+bench_xrow_header_decode(benchmark::State& state)
+{
+	Env::instance();
+	std::vector<char> packet = make_replace_packet(
+		make_tuple(state.range(0), (enum TupleShape)state.range(1)));
+	const char *end = packet.data() + packet.size();
+	for (auto _ : state) {
+		struct xrow_header row;
+		const char *pos = packet.data();
+		if (xrow_header_decode(&row, &pos, end, true) != 0)
+			abort();
+		benchmark::DoNotOptimize(row);
+	}
+	state.SetBytesProcessed(state.iterations() * packet.size());
+}
+
+BENCHMARK(bench_xrow_header_decode)
+	->ArgNames({"fields", "shape"})
+	->ArgsProduct({{1, 10, 100, 1000}, {SHAPE_SMALL_INTS, SHAPE_MIXED}});
+
+// Decode the body of a REPLACE request with a decoded header.
+static void
+bench_xrow_decode_dml(benchmark::State& state)
+{
+	Env::instance();
+	std::vector<char> packet = make_replace_packet(
+		make_tuple(state.range(0), (enum TupleShape)state.range(1)));
+	struct xrow_header row;
+	const char *pos = packet.data();
+	if (xrow_header_decode(&row, &pos, pos + packet.size(), true) != 0)
+		abort();
+	for (auto _ : state) {
+		struct request request;
+		if (xrow_decode_dml(&row, &request, 0) != 0)
+			abort();
+		benchmark::DoNotOptimize(request);
+	}
+	state.SetBytesProcessed(state.iterations() * packet.size());
+}
+
+BENCHMARK(bench_xrow_decode_dml)
+	->ArgNames({"fields", "shape"})
+	->ArgsProduct({{1, 10, 100, 1000}, {SHAPE_SMALL_INTS, SHAPE_MIXED}});
+
+// Check a tuple with mp_check() from msgpuck, as a baseline for
+// mp_check_fast().
+static void
+bench_mp_check(benchmark::State& state)
+{
+	std::vector<char> tuple = make_tuple(state.range(0),
+					     (enum TupleShape)state.range(1));
+	const char *end = tuple.data() + tuple.size();
+	for (auto _ : state) {
+		const char *data = tuple.data();
+		if (mp_check(&data, end) != 0)
+			abort();
+		benchmark::DoNotOptimize(data);
+	}
+	state.SetBytesProcessed(state.iterations() * tuple.size());
+}
+
+BENCHMARK(bench_mp_check)
+	->ArgNames({"fields", "shape"})
+	->ArgsProduct({{10, 100, 1000}, {SHAPE_SMALL_INTS, SHAPE_MIXED}});
+
+static void
+bench_mp_check_fast(benchmark::State& state)
+{
+	std::vector<char> tuple = make_tuple(state.range(0),
+					     (enum TupleShape)state.range(1));
+	const char *end = tuple.data() + tuple.size();
+	for (auto _ : state) {
+		const char *data = tuple.data();
+		if (mp_check_fast(&data, end) != 0)
+			abort();
+		benchmark::DoNotOptimize(data);
+	}
+	state.SetBytesProcessed(state.iterations() * tuple.size());
+}
+
+BENCHMARK(bench_mp_check_fast)
+	->ArgNames({"fields", "shape"})
+	->ArgsProduct({{10, 100, 1000}, {SHAPE_SMALL_INTS, SHAPE_MIXED}});
+
+// Skip a tuple with mp_next() from msgpuck, as a baseline for
+// mp_next_fast().
+static void
+bench_mp_next(benchmark::State& state)
+{
+	std::vector<char> tuple = make_tuple(state.range(0),
+					     (enum TupleShape)state.range(1));
+	for (auto _ : state) {
+		const char *data = tuple.data();
+		mp_next(&data);
+		benchmark::DoNotOptimize(data);
+	}
+	state.SetBytesProcessed(state.iterations() * tuple.size());
+}
+
+BENCHMARK(bench_mp_next)
+	->ArgNames({"fields", "shape"})
+	->ArgsProduct({{10, 100, 1000}, {SHAPE_SMALL_INTS, SHAPE_MIXED}});
+
+static void
+bench_mp_next_fast(benchmark::State& state)
+{
+	std::vector<char> tuple = make_tuple(state.range(0),
+					     (enum TupleShape)state.range(1));
+	const char *end = tuple.data() + tuple.size();
+	for (auto _ : state) {
+		const char *data = tuple.data();
+		mp_next_fast(&data, end);
+		benchmark::DoNotOptimize(data);
+	}
+	state.SetBytesProcessed(state.iterations() * tuple.size());
+}
+
+BENCHMARK(bench_mp_next_fast)
+	->ArgNames({"fields", "shape"})
+	->ArgsProduct({{10, 100, 1000}, {SHAPE_SMALL_INTS, SHAPE_MIXED}});
+
+BENCHMARK_MAIN();
+
+static void
+show_warning_if_debug()
+{
+#ifndef NDEBUG
+	std::cerr << "#######################################################\n"
+		  << "#######################################################\n"
+		  << "#######################################################\n"
+		  << "###                                                 ###\n"
+		  << "###                    WARNING!                     ###\n"
+		  << "###   The performance test is run in debug build!   ###\n"
+		  << "###   Test results are definitely inappropriate!    ###\n"
+		  << "###                                                 ###\n"
+		  << "#######################################################\n"
+		  << "#######################################################\n"
+		  << "#######################################################\n";
+#endif // #ifndef NDEBUG
+}
+
+struct DebugWarning {
+	DebugWarning() { show_warning_if_debug(); }
+} debug_warning;
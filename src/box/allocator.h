@@ -165,6 +165,7 @@ public:
 		struct sys_stats data_stats;
 		sys_stats(&sys_alloc, &data_stats);
 		alloc_stats->sys.used = data_stats.used;
+		alloc_stats->sys.total = data_stats.total;
 	}
 private:
 	static struct sys_alloc sys_alloc;
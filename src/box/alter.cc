@@ -240,6 +240,12 @@ index_opts_decode(struct index_opts *opts, const char *map,
 			 "less than or equal to 1");
 		return -1;
 	}
+	if (opts->compaction_strategy == compaction_strategy_MAX) {
+		diag_set(ClientError, ER_WRONG_INDEX_OPTIONS,
+			 BOX_INDEX_FIELD_OPTS, "compaction_strategy must be "
+			 "either 'leveled' or 'tiered'");
+		return -1;
+	}
 	return 0;
 }
 
@@ -1044,6 +1050,7 @@ alter_space_rollback(struct trigger *trigger, void * /* event */)
 	space_swap_triggers(alter->new_space, alter->old_space);
 	space_swap_fk_constraints(alter->new_space, alter->old_space);
 	space_swap_constraint_ids(alter->new_space, alter->old_space);
+	SWAP(alter->new_space->op_stat, alter->old_space->op_stat);
 	space_cache_replace(alter->new_space, alter->old_space);
 	alter_space_delete(alter);
 	return 0;
@@ -1156,6 +1163,7 @@ alter_space_do(struct txn_stmt *stmt, struct alter_space *alter)
 	space_swap_triggers(alter->new_space, alter->old_space);
 	space_swap_fk_constraints(alter->new_space, alter->old_space);
 	space_swap_constraint_ids(alter->new_space, alter->old_space);
+	SWAP(alter->new_space->op_stat, alter->old_space->op_stat);
 	/*
 	 * The new space is ready. Time to update the space
 	 * cache with it.
@@ -4638,6 +4646,24 @@ on_drop_sequence_data_rollback(struct trigger *trigger, void * /* event */)
 	return 0;
 }
 
+/**
+ * Forget the values preallocated for a sequence if the write
+ * of them is rolled back.
+ */
+static int
+on_replace_sequence_data_rollback(struct trigger *trigger,
+				  void * /* event */)
+{
+	struct tuple *tuple = (struct tuple *)trigger->data;
+	uint32_t id;
+	if (tuple_field_u32(tuple, BOX_SEQUENCE_DATA_FIELD_ID, &id) != 0)
+		return -1;
+	struct sequence *seq = sequence_by_id(id);
+	if (seq != NULL)
+		sequence_cancel_reserve(seq);
+	return 0;
+}
+
 /**
  * A trigger invoked on replace in space _sequence_data.
  * Used to update a sequence value.
@@ -4664,7 +4690,18 @@ on_replace_dd_sequence_data(struct trigger * /* trigger */, void *event)
 		if (tuple_field_i64(new_tuple, BOX_SEQUENCE_DATA_FIELD_VALUE,
 				    &value) != 0)
 			return -1;
-		if (sequence_set(seq, value) != 0)
+		if (seq->def->cache > 1) {
+			/*
+			 * The values preallocated by sequence_reserve()
+			 * may be used only if they are persisted.
+			 */
+			struct trigger *on_rollback = txn_alter_trigger_new(
+				on_replace_sequence_data_rollback, new_tuple);
+			if (on_rollback == NULL)
+				return -1;
+			txn_stmt_on_rollback(stmt, on_rollback);
+		}
+		if (sequence_set_reserved(seq, value) != 0)
 			return -1;
 	} else {					/* DELETE */
 		/*
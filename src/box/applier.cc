@@ -30,6 +30,7 @@
  */
 #include "applier.h"
 
+#include <unistd.h>
 #include <msgpuck.h>
 
 #include "xlog.h"
@@ -39,6 +40,7 @@
 #include "coio.h"
 #include "coio_buf.h"
 #include "wal.h"
+#include "cbus.h"
 #include "xrow.h"
 #include "replication.h"
 #include "iproto_constants.h"
@@ -58,9 +60,20 @@
 #include "journal.h"
 #include "raft.h"
 #include "small/static.h"
+#include "clock.h"
+#include "histogram.h"
+#include "rmean.h"
 
 STRS(applier_state, applier_STATE);
 
+const char *applier_stat_strs[] = {
+	"ROWS",
+	"BYTES",
+};
+
+static_assert(lengthof(applier_stat_strs) == APPLIER_STAT_LAST,
+	      "applier_stat_strs must match applier_stat_name");
+
 enum {
 	/**
 	 * How often to log received row count. Used during join and register.
@@ -195,7 +208,9 @@ applier_writer_f(va_list ap)
 		try {
 			applier->has_acks_to_send = false;
 			struct xrow_header xrow;
-			xrow_encode_vclock(&xrow, &replicaset.vclock);
+			if (xrow_encode_ack(&xrow, &replicaset.vclock,
+					    applier->lease_ts) != 0)
+				diag_raise();
 			/*
 			 * For relay lag statistics we report last
 			 * written transaction timestamp in tm field.
@@ -242,6 +257,22 @@ applier_writer_f(va_list ap)
 	return 0;
 }
 
+/**
+ * Remember the lease timestamp of a heartbeat to send it back to the
+ * master. Only the Raft leader is promised not to vote for anybody else
+ * while it's seen, so leases are acked only to it.
+ */
+static void
+applier_process_lease_ts(struct applier *applier,
+			 const struct xrow_header *row)
+{
+	struct raft *raft = box_raft();
+	if (!raft->is_lease_enabled || raft->leader != applier->instance_id)
+		return;
+	if (xrow_decode_lease_ts(row, &applier->lease_ts) != 0)
+		diag_raise();
+}
+
 static int
 apply_snapshot_row(struct xrow_header *row)
 {
@@ -338,13 +369,22 @@ applier_connect(struct applier *applier)
 	 */
 	applier->addr_len = sizeof(applier->addrstorage);
 	applier_set_state(applier, APPLIER_CONNECT);
+	struct iostream_ctx io_ctx;
+	if (iostream_ctx_create(&io_ctx, IOSTREAM_CLIENT, uri) != 0)
+		diag_raise();
+	auto io_ctx_guard = make_scoped_guard([&] {
+		iostream_ctx_destroy(&io_ctx);
+	});
 	int fd = coio_connect(uri->host != NULL ? uri->host : "",
 			      uri->service != NULL ? uri->service : "",
 			      uri->host_hint, &applier->addr,
 			      &applier->addr_len);
 	if (fd < 0)
 		diag_raise();
-	iostream_create(io, fd);
+	if (iostream_create_with_ctx(io, fd, &io_ctx) != 0) {
+		close(fd);
+		diag_raise();
+	}
 	if (coio_readn(io, greetingbuf, IPROTO_GREETING_SIZE) < 0)
 		diag_raise();
 	applier->last_row_time = ev_monotonic_now(loop());
@@ -655,6 +695,108 @@ applier_join(struct applier *applier)
 	applier_set_state(applier, APPLIER_READY);
 }
 
+static void
+applier_zstream_create(struct applier_zstream *zstream)
+{
+	zstream->zdctx = NULL;
+	ibuf_create(&zstream->rows, &cord()->slabc, 16 * 1024);
+}
+
+static void
+applier_zstream_destroy(struct applier_zstream *zstream)
+{
+	if (zstream->zdctx != NULL)
+		ZSTD_freeDStream(zstream->zdctx);
+	ibuf_destroy(&zstream->rows);
+}
+
+/** Prepare a decompressor for a new connection. */
+static void
+applier_zstream_reset(struct applier_zstream *zstream)
+{
+	if (zstream->zdctx != NULL)
+		ZSTD_initDStream(zstream->zdctx);
+	ibuf_reinit(&zstream->rows);
+}
+
+/**
+ * Decompress a batch of rows sent by the master. All rows of
+ * the previous batch must have been processed by now.
+ */
+static void
+applier_zstream_decompress(struct applier_zstream *zstream,
+			   const struct xrow_header *row)
+{
+	assert(ibuf_used(&zstream->rows) == 0);
+	const char *data;
+	size_t size;
+	xrow_decode_compressed_rows_xc(row, &data, &size);
+	if (zstream->zdctx == NULL) {
+		zstream->zdctx = ZSTD_createDStream();
+		if (zstream->zdctx == NULL) {
+			tnt_raise(OutOfMemory, sizeof(ZSTD_DStream *),
+				  "ZSTD_createDStream", "zdctx");
+		}
+		ZSTD_initDStream(zstream->zdctx);
+	}
+	ibuf_reset(&zstream->rows);
+	ZSTD_inBuffer input = {data, size, 0};
+	ZSTD_outBuffer output;
+	do {
+		size_t out_size = ZSTD_DStreamOutSize();
+		void *dst = ibuf_reserve(&zstream->rows, out_size);
+		if (dst == NULL) {
+			tnt_raise(OutOfMemory, out_size, "ibuf",
+				  "decompressed rows");
+		}
+		output = {dst, out_size, 0};
+		size_t rc = ZSTD_decompressStream(zstream->zdctx, &output,
+						  &input);
+		if (ZSTD_isError(rc)) {
+			tnt_raise(ClientError, ER_DECOMPRESSION,
+				  ZSTD_getErrorName(rc));
+		}
+		ibuf_alloc(&zstream->rows, output.pos);
+	} while (input.pos < input.size || output.pos == output.size);
+}
+
+/**
+ * Read the next row of the replication stream. Compressed
+ * batches are unpacked transparently. The body of the returned
+ * row is valid until the next call.
+ */
+static void
+applier_read_row(struct iostream *io, struct ibuf *ibuf,
+		 struct applier_zstream *zstream, struct rmean *stat,
+		 struct xrow_header *row, double timeout)
+{
+	struct ibuf *rows = &zstream->rows;
+	while (ibuf_used(rows) == 0) {
+		size_t size = coio_read_xrow_timeout_xc(io, ibuf, row,
+							timeout);
+		rmean_collect(stat, APPLIER_STAT_BYTES, size);
+		if (row->type != IPROTO_COMPRESSED_ROWS) {
+			rmean_collect(stat, APPLIER_STAT_ROWS, 1);
+			return;
+		}
+		applier_zstream_decompress(zstream, row);
+	}
+	rmean_collect(stat, APPLIER_STAT_ROWS, 1);
+	const char *pos = rows->rpos;
+	if (mp_typeof(*pos) != MP_UINT ||
+	    mp_check_uint(pos, rows->wpos) > 0) {
+		tnt_raise(ClientError, ER_INVALID_MSGPACK,
+			  "packet length");
+	}
+	uint32_t len = mp_decode_uint(&pos);
+	if ((size_t)(rows->wpos - pos) < len) {
+		tnt_raise(ClientError, ER_INVALID_MSGPACK,
+			  "compressed rows");
+	}
+	xrow_header_decode_xc(row, &pos, pos + len, true);
+	rows->rpos = (char *)pos;
+}
+
 static struct applier_tx_row *
 applier_read_tx_row(struct applier *applier, double timeout)
 {
@@ -671,7 +813,8 @@ applier_read_tx_row(struct applier *applier, double timeout)
 
 	ERROR_INJECT_YIELD(ERRINJ_APPLIER_READ_TX_ROW_DELAY);
 
-	coio_read_xrow_timeout_xc(io, ibuf, row, timeout);
+	applier_read_row(io, ibuf, &applier->zstream, applier->stat, row,
+			 timeout);
 
 	if (row->tm > 0)
 		applier->lag = ev_now(loop()) - row->tm;
@@ -760,6 +903,501 @@ applier_read_tx(struct applier *applier, struct stailq *rows, double timeout)
 	return row_count;
 }
 
+/* {{{ Applier threads */
+
+/**
+ * A thread that reads and decodes replication streams so that
+ * tx doesn't spend time on it.
+ */
+struct applier_thread {
+	/** Thread. */
+	struct cord cord;
+	/** Pipe from tx to the applier thread. */
+	struct cpipe thread_pipe;
+	/** Pipe from the applier thread to tx. */
+	struct cpipe tx_pipe;
+};
+
+/** Applier thread pool, see box.cfg.replication_threads. */
+static struct applier_thread *applier_threads;
+/** Number of threads in the applier thread pool. */
+static int applier_thread_count;
+/** Index of the thread to be used by the next applier. */
+static int applier_next_thread;
+
+enum {
+	/**
+	 * Max number of transactions an applier thread may read
+	 * ahead of tx.
+	 */
+	APPLIER_THREAD_TX_MAX = 64,
+};
+
+/**
+ * Reader of a replication stream running in an applier thread.
+ * Members marked with [tx] are accessed only from tx, the rest
+ * are accessed only from the applier thread.
+ */
+struct applier_thread_reader {
+	/** Thread the reader runs in. */
+	struct applier_thread *thread;
+	/** Applier whose stream is read. Only its io is used. */
+	struct applier *applier;
+	/** Fiber reading the stream or NULL if it exited. */
+	struct fiber *fiber;
+	/** Input buffer, allocated on the thread slab cache. */
+	struct ibuf ibuf;
+	/** Decompression state of the stream. */
+	struct applier_zstream zstream;
+	/** Data read by tx before passing the stream to the thread. */
+	char *initial_data;
+	/** Size of initial_data. */
+	size_t initial_size;
+	/** Number of transactions passed to tx and not returned yet. */
+	int tx_in_flight;
+	/** Signaled when tx returns a transaction. */
+	struct fiber_cond thread_cond;
+	/** Set when tx asks the reader to stop. */
+	bool is_stopping;
+	/** [tx] Read transactions, linked by applier_thread_tx::in_queue. */
+	struct stailq queue;
+	/** [tx] Transaction that is being applied. */
+	struct applier_thread_tx *curr;
+	/** [tx] Signaled when a message from the thread arrives. */
+	struct fiber_cond tx_cond;
+	/** [tx] Set when the thread is done with the reader. */
+	bool is_stopped;
+	/** Message to start the reader. */
+	struct cmsg start_msg;
+	/** Message to stop the reader. */
+	struct cmsg stop_msg;
+	/** Message sent by the thread when it is done with the reader. */
+	struct cmsg stopped_msg;
+};
+
+/** A transaction read and decoded by an applier thread. */
+struct applier_thread_tx {
+	struct cmsg base;
+	/** Reader that read the transaction. */
+	struct applier_thread_reader *reader;
+	/** Link in applier_thread_reader::queue. */
+	struct stailq_entry in_queue;
+	/**
+	 * Transaction rows, linked by applier_tx_row::next.
+	 * The rows and their bodies are stored after this struct.
+	 */
+	struct stailq rows;
+	/** Set if the reader failed, then diag holds the error. */
+	bool is_error;
+	/** Error that stopped the reader. */
+	struct diag diag;
+};
+
+static void
+applier_thread_tx_delete(struct applier_thread_tx *tx)
+{
+	if (tx->is_error)
+		diag_destroy(&tx->diag);
+	free(tx);
+}
+
+/** Put a transaction read by a thread to the reader queue. */
+static void
+applier_thread_tx_deliver_f(struct cmsg *msg)
+{
+	struct applier_thread_tx *tx = (struct applier_thread_tx *)msg;
+	struct applier_thread_reader *reader = tx->reader;
+	stailq_add_tail_entry(&reader->queue, tx, in_queue);
+	fiber_cond_signal(&reader->tx_cond);
+}
+
+/** Free a transaction returned by tx. Runs in the applier thread. */
+static void
+applier_thread_tx_free_f(struct cmsg *msg)
+{
+	struct applier_thread_tx *tx = (struct applier_thread_tx *)msg;
+	struct applier_thread_reader *reader = tx->reader;
+	assert(reader->tx_in_flight > 0);
+	reader->tx_in_flight--;
+	fiber_cond_signal(&reader->thread_cond);
+	applier_thread_tx_delete(tx);
+}
+
+static const struct cmsg_hop applier_thread_tx_route[] = {
+	{applier_thread_tx_deliver_f, NULL},
+};
+
+static const struct cmsg_hop applier_thread_tx_free_route[] = {
+	{applier_thread_tx_free_f, NULL},
+};
+
+/** Pass a transaction to tx. Runs in the applier thread. */
+static void
+applier_thread_push_tx(struct applier_thread_reader *reader,
+		       struct applier_thread_tx *tx)
+{
+	tx->reader = reader;
+	reader->tx_in_flight++;
+	cmsg_init(&tx->base, applier_thread_tx_route);
+	cpipe_push(&reader->thread->tx_pipe, &tx->base);
+}
+
+/**
+ * Read a transaction from the stream and copy its rows to a single
+ * memory block that can be passed to tx. Runs in the applier thread.
+ */
+static struct applier_thread_tx *
+applier_thread_read_tx(struct applier_thread_reader *reader, double timeout)
+{
+	struct iostream *io = &reader->applier->io;
+	struct ibuf *ibuf = &reader->ibuf;
+	struct stailq rows;
+	stailq_create(&rows);
+	int64_t tsn = 0;
+	int row_count = 0;
+	size_t size = sizeof(struct applier_thread_tx);
+	do {
+		size_t tx_row_size;
+		struct applier_tx_row *tx_row =
+			region_alloc_object(&fiber()->gc, typeof(*tx_row),
+					    &tx_row_size);
+		if (tx_row == NULL)
+			tnt_raise(OutOfMemory, tx_row_size,
+				  "region_alloc_object", "tx_row");
+		ERROR_INJECT_YIELD(ERRINJ_APPLIER_READ_TX_ROW_DELAY);
+		applier_read_row(io, ibuf, &reader->zstream,
+				 reader->applier->stat, &tx_row->row, timeout);
+		tsn = set_next_tx_row(&rows, tx_row, tsn);
+		size += sizeof(*tx_row);
+		for (int i = 0; i < tx_row->row.bodycnt; i++)
+			size += tx_row->row.body[i].iov_len;
+		++row_count;
+	} while (tsn != 0);
+
+	struct applier_thread_tx *tx =
+		(struct applier_thread_tx *)xmalloc(size);
+	tx->is_error = false;
+	stailq_create(&tx->rows);
+	struct applier_tx_row *dst = (struct applier_tx_row *)(tx + 1);
+	char *data = (char *)(dst + row_count);
+	struct applier_tx_row *item;
+	stailq_foreach_entry(item, &rows, next) {
+		dst->row = item->row;
+		for (int i = 0; i < item->row.bodycnt; i++) {
+			struct iovec *body = &dst->row.body[i];
+			memcpy(data, body->iov_base, body->iov_len);
+			body->iov_base = data;
+			data += body->iov_len;
+		}
+		stailq_add_tail_entry(&tx->rows, dst, next);
+		dst++;
+	}
+	assert(data == (char *)tx + size);
+	fiber_gc();
+	if (ibuf_used(ibuf) == 0)
+		ibuf_reset(ibuf);
+	return tx;
+}
+
+static void
+applier_thread_reader_stopped_f(struct cmsg *msg)
+{
+	struct applier_thread_reader *reader =
+		container_of(msg, struct applier_thread_reader, stopped_msg);
+	reader->is_stopped = true;
+	fiber_cond_signal(&reader->tx_cond);
+}
+
+static const struct cmsg_hop applier_thread_reader_stopped_route[] = {
+	{applier_thread_reader_stopped_f, NULL},
+};
+
+/**
+ * Free the thread part of a reader and notify tx that the thread
+ * is done with it. Runs in the applier thread.
+ */
+static void
+applier_thread_reader_finish(struct applier_thread_reader *reader)
+{
+	assert(reader->fiber == NULL);
+	assert(reader->is_stopping);
+	ibuf_destroy(&reader->ibuf);
+	applier_zstream_destroy(&reader->zstream);
+	fiber_cond_destroy(&reader->thread_cond);
+	free(reader->initial_data);
+	reader->initial_data = NULL;
+	cmsg_init(&reader->stopped_msg, applier_thread_reader_stopped_route);
+	cpipe_push(&reader->thread->tx_pipe, &reader->stopped_msg);
+}
+
+/** Fiber reading a replication stream in an applier thread. */
+static int
+applier_thread_reader_f(va_list ap)
+{
+	struct applier_thread_reader *reader =
+		va_arg(ap, struct applier_thread_reader *);
+	struct applier *applier = reader->applier;
+	try {
+		if (reader->initial_size > 0) {
+			void *data = ibuf_alloc(&reader->ibuf,
+						reader->initial_size);
+			if (data == NULL)
+				tnt_raise(OutOfMemory, reader->initial_size,
+					  "ibuf", "data");
+			memcpy(data, reader->initial_data,
+			       reader->initial_size);
+		}
+		free(reader->initial_data);
+		reader->initial_data = NULL;
+		while (true) {
+			while (reader->tx_in_flight >= APPLIER_THREAD_TX_MAX) {
+				if (fiber_cond_wait(&reader->thread_cond) != 0)
+					diag_raise();
+			}
+			/* See the comment in applier_subscribe(). */
+			double timeout =
+				applier->version_id < version_id(1, 7, 7) ?
+				TIMEOUT_INFINITY :
+				replication_disconnect_timeout();
+			struct applier_thread_tx *tx =
+				applier_thread_read_tx(reader, timeout);
+			applier_thread_push_tx(reader, tx);
+		}
+	} catch (Exception *e) {
+		fiber_gc();
+		if (!reader->is_stopping) {
+			struct applier_thread_tx *tx =
+				(struct applier_thread_tx *)
+				xmalloc(sizeof(*tx));
+			stailq_create(&tx->rows);
+			tx->is_error = true;
+			diag_create(&tx->diag);
+			diag_move(diag_get(), &tx->diag);
+			applier_thread_push_tx(reader, tx);
+		}
+	}
+	reader->fiber = NULL;
+	if (reader->is_stopping)
+		applier_thread_reader_finish(reader);
+	return 0;
+}
+
+/** Start a reader. Runs in the applier thread. */
+static void
+applier_thread_reader_start_f(struct cmsg *msg)
+{
+	struct applier_thread_reader *reader =
+		container_of(msg, struct applier_thread_reader, start_msg);
+	fiber_cond_create(&reader->thread_cond);
+	ibuf_create(&reader->ibuf, &cord()->slabc, 1024);
+	applier_zstream_create(&reader->zstream);
+
+	char name[FIBER_NAME_MAX];
+	int pos = snprintf(name, sizeof(name), "applierr/");
+	uri_format(name + pos, sizeof(name) - pos,
+		   &reader->applier->uri, false);
+	reader->fiber = fiber_new(name, applier_thread_reader_f);
+	if (reader->fiber == NULL) {
+		struct applier_thread_tx *tx =
+			(struct applier_thread_tx *)xmalloc(sizeof(*tx));
+		stailq_create(&tx->rows);
+		tx->is_error = true;
+		diag_create(&tx->diag);
+		diag_move(diag_get(), &tx->diag);
+		applier_thread_push_tx(reader, tx);
+		return;
+	}
+	fiber_start(reader->fiber, reader);
+}
+
+/** Stop a reader. Runs in the applier thread. */
+static void
+applier_thread_reader_stop_f(struct cmsg *msg)
+{
+	struct applier_thread_reader *reader =
+		container_of(msg, struct applier_thread_reader, stop_msg);
+	reader->is_stopping = true;
+	/*
+	 * The fiber will finish the reader on exit. We can't wait
+	 * for it here, because cbus message handlers must not
+	 * yield.
+	 */
+	if (reader->fiber != NULL)
+		fiber_cancel(reader->fiber);
+	else
+		applier_thread_reader_finish(reader);
+}
+
+static const struct cmsg_hop applier_thread_reader_start_route[] = {
+	{applier_thread_reader_start_f, NULL},
+};
+
+static const struct cmsg_hop applier_thread_reader_stop_route[] = {
+	{applier_thread_reader_stop_f, NULL},
+};
+
+/**
+ * Pass the replication stream of an applier to an applier thread.
+ * Must be called after SUBSCRIBE, when only data rows and heartbeats
+ * are expected from the master.
+ */
+static struct applier_thread_reader *
+applier_thread_reader_new(struct applier *applier)
+{
+	assert(applier_thread_count > 0);
+	struct applier_thread_reader *reader =
+		(struct applier_thread_reader *)xcalloc(1, sizeof(*reader));
+	reader->thread = &applier_threads[applier_next_thread++];
+	applier_next_thread %= applier_thread_count;
+	reader->applier = applier;
+	stailq_create(&reader->queue);
+	fiber_cond_create(&reader->tx_cond);
+	/* The thread takes over data tx has read ahead. */
+	struct ibuf *ibuf = &applier->ibuf;
+	reader->initial_size = ibuf_used(ibuf);
+	if (reader->initial_size > 0) {
+		reader->initial_data = (char *)xmalloc(reader->initial_size);
+		memcpy(reader->initial_data, ibuf->rpos, reader->initial_size);
+	}
+	ibuf_reset(ibuf);
+	cmsg_init(&reader->start_msg, applier_thread_reader_start_route);
+	cpipe_push(&reader->thread->thread_pipe, &reader->start_msg);
+	return reader;
+}
+
+/** Return the transaction that has been applied to the thread. */
+static void
+applier_thread_reader_release(struct applier_thread_reader *reader)
+{
+	struct applier_thread_tx *tx = reader->curr;
+	if (tx == NULL)
+		return;
+	reader->curr = NULL;
+	cmsg_init(&tx->base, applier_thread_tx_free_route);
+	cpipe_push(&reader->thread->thread_pipe, &tx->base);
+}
+
+/**
+ * Get the next transaction read by an applier thread. The rows are
+ * valid until the next call. Raises an exception if the thread failed
+ * to read the stream.
+ */
+static void
+applier_thread_reader_next(struct applier_thread_reader *reader,
+			   struct stailq *rows)
+{
+	applier_thread_reader_release(reader);
+	while (stailq_empty(&reader->queue)) {
+		if (fiber_cond_wait(&reader->tx_cond) != 0)
+			diag_raise();
+	}
+	struct applier_thread_tx *tx = stailq_shift_entry(
+		&reader->queue, struct applier_thread_tx, in_queue);
+	reader->curr = tx;
+	if (tx->is_error) {
+		diag_move(&tx->diag, diag_get());
+		diag_raise();
+	}
+	stailq_create(rows);
+	stailq_concat(rows, &tx->rows);
+
+	struct applier *applier = reader->applier;
+	struct xrow_header *last_row =
+		&stailq_last_entry(rows, struct applier_tx_row, next)->row;
+	if (last_row->tm > 0)
+		applier->lag = ev_now(loop()) - last_row->tm;
+	applier->last_row_time = ev_monotonic_now(loop());
+}
+
+/**
+ * Stop reading the replication stream in the applier thread and
+ * free the reader. The applier io must not be closed before this
+ * function returns.
+ */
+static void
+applier_thread_reader_delete(struct applier_thread_reader *reader)
+{
+	cmsg_init(&reader->stop_msg, applier_thread_reader_stop_route);
+	cpipe_push(&reader->thread->thread_pipe, &reader->stop_msg);
+	bool cancellable = fiber_set_cancellable(false);
+	while (!reader->is_stopped)
+		fiber_cond_wait(&reader->tx_cond);
+	fiber_set_cancellable(cancellable);
+	/*
+	 * The thread doesn't use the reader anymore and all
+	 * transactions it sent have been delivered, so we can
+	 * free them here.
+	 */
+	if (reader->curr != NULL)
+		applier_thread_tx_delete(reader->curr);
+	struct applier_thread_tx *tx, *next;
+	stailq_foreach_entry_safe(tx, next, &reader->queue, in_queue)
+		applier_thread_tx_delete(tx);
+	fiber_cond_destroy(&reader->tx_cond);
+	free(reader);
+}
+
+/** Applier thread function. */
+static int
+applier_thread_f(va_list ap)
+{
+	struct applier_thread *thread = va_arg(ap, struct applier_thread *);
+	struct cbus_endpoint endpoint;
+
+	cpipe_create(&thread->tx_pipe, "tx_prio");
+	cbus_endpoint_create(&endpoint, cord_name(cord()),
+			     fiber_schedule_cb, fiber());
+	cbus_loop(&endpoint);
+	cbus_endpoint_destroy(&endpoint, cbus_process);
+	cpipe_destroy(&thread->tx_pipe);
+	return 0;
+}
+
+void
+applier_init(int thread_count)
+{
+	assert(applier_threads == NULL);
+	applier_thread_count = thread_count;
+	if (thread_count == 0)
+		return;
+	applier_threads = (struct applier_thread *)
+		xcalloc(thread_count, sizeof(*applier_threads));
+	for (int i = 0; i < thread_count; i++) {
+		struct applier_thread *thread = &applier_threads[i];
+		char name[FIBER_NAME_MAX];
+		snprintf(name, sizeof(name), "applier.%d", i);
+		if (cord_costart(&thread->cord, name,
+				 applier_thread_f, thread) != 0)
+			panic("failed to start applier thread");
+		cpipe_create(&thread->thread_pipe, name);
+	}
+}
+
+int
+applier_set_cpu_affinity(const char *cpus)
+{
+	for (int i = 0; i < applier_thread_count; i++) {
+		if (cord_set_cpu_affinity(&applier_threads[i].cord, cpus) != 0)
+			return -1;
+	}
+	return 0;
+}
+
+void
+applier_free(void)
+{
+	for (int i = 0; i < applier_thread_count; i++) {
+		struct applier_thread *thread = &applier_threads[i];
+		tt_pthread_cancel(thread->cord.id);
+		tt_pthread_join(thread->cord.id, NULL);
+	}
+	free(applier_threads);
+	applier_threads = NULL;
+	applier_thread_count = 0;
+}
+
+/* }}} Applier threads */
+
 static void
 applier_rollback_by_wal_io(int64_t signature)
 {
@@ -810,6 +1448,10 @@ struct replica_cb_data {
 	 * a transaction.
 	 */
 	double txn_last_tm;
+	/** Time when the transaction started to be applied. */
+	double apply_start;
+	/** Time when the transaction was submitted to WAL. */
+	double wal_start;
 };
 
 /** Update replica associated data once write is complete. */
@@ -817,8 +1459,17 @@ static void
 replica_txn_wal_write_cb(struct replica_cb_data *rcb)
 {
 	struct replica *r = replica_by_id(rcb->replica_id);
-	if (likely(r != NULL))
-		r->applier_txn_last_tm = rcb->txn_last_tm;
+	if (unlikely(r == NULL))
+		return;
+	r->applier_txn_last_tm = rcb->txn_last_tm;
+	struct applier *applier = r->applier;
+	if (applier != NULL && rcb->apply_start > 0) {
+		double now = clock_monotonic();
+		histogram_collect(applier->apply_latency,
+				  (now - rcb->apply_start) * 1e6);
+		histogram_collect(applier->wal_latency,
+				  (now - rcb->wal_start) * 1e6);
+	}
 }
 
 static int
@@ -898,6 +1549,8 @@ apply_synchro_row(uint32_t replica_id, struct xrow_header *row)
 
 	rcb_data.replica_id = replica_id;
 	rcb_data.txn_last_tm = row->tm;
+	rcb_data.apply_start = clock_monotonic();
+	rcb_data.wal_start = rcb_data.apply_start;
 	entry.rcb = &rcb_data;
 
 	/*
@@ -957,6 +1610,7 @@ apply_plain_tx(uint32_t replica_id, struct stailq *rows,
 	 * conflict safely access failed xrow object and allocate
 	 * IPROTO_NOP on gc.
 	 */
+	double apply_start = clock_monotonic();
 	struct txn *txn = txn_begin();
 	struct applier_tx_row *item;
 	if (txn == NULL)
@@ -1037,6 +1691,8 @@ apply_plain_tx(uint32_t replica_id, struct stailq *rows,
 		item = stailq_last_entry(rows, struct applier_tx_row, next);
 		rcb->replica_id = replica_id;
 		rcb->txn_last_tm = item->row.tm;
+		rcb->apply_start = apply_start;
+		rcb->wal_start = clock_monotonic();
 
 		trigger_create(on_wal_write, applier_txn_wal_write_cb, rcb, NULL);
 		txn_on_wal_write(txn, on_wal_write);
@@ -1278,7 +1934,8 @@ applier_subscribe(struct applier *applier)
 	 */
 	uint32_t id_filter = box_is_orphan() ? 0 : 1 << instance_id;
 	xrow_encode_subscribe_xc(&row, &REPLICASET_UUID, &INSTANCE_UUID,
-				 &vclock, replication_anon, id_filter);
+				 &vclock, replication_anon, id_filter,
+				 &IPROTO_CURRENT_FEATURES, NULL);
 	coio_write_xrow(io, &row);
 
 	/* Read SUBSCRIBE response */
@@ -1363,6 +2020,7 @@ applier_subscribe(struct applier *applier)
 	}
 
 	applier->lag = TIMEOUT_INFINITY;
+	applier->lease_ts = 0;
 
 	/*
 	 * Register triggers to handle WAL writes and rollbacks.
@@ -1384,6 +2042,23 @@ applier_subscribe(struct applier *applier)
 		trigger_clear(&on_rollback);
 	});
 
+	/*
+	 * Offload reading and decoding of the stream to an applier
+	 * thread if configured. ACKs are still sent from tx by the
+	 * writer fiber. This is fine for a plain stream, because a
+	 * socket may be read and written from different threads.
+	 * An SSL stream keeps its state in the SSL object, which
+	 * can't be used from two threads at once, so it is read in
+	 * tx.
+	 */
+	struct applier_thread_reader *reader = NULL;
+	if (applier_thread_count > 0 && iostream_is_plain(&applier->io))
+		reader = applier_thread_reader_new(applier);
+	auto reader_guard = make_scoped_guard([&] {
+		if (reader != NULL)
+			applier_thread_reader_delete(reader);
+	});
+
 	/*
 	 * Process a stream of rows from the binary log.
 	 */
@@ -1407,7 +2082,10 @@ applier_subscribe(struct applier *applier)
 				 replication_disconnect_timeout();
 
 		struct stailq rows;
-		applier_read_tx(applier, &rows, timeout);
+		if (reader != NULL)
+			applier_thread_reader_next(reader, &rows);
+		else
+			applier_read_tx(applier, &rows, timeout);
 
 		/*
 		 * In case of an heartbeat message wake a writer up
@@ -1423,6 +2101,8 @@ applier_subscribe(struct applier *applier)
 				if (applier_handle_raft(applier,
 							first_row) != 0)
 					diag_raise();
+			} else if (first_row->type == IPROTO_OK) {
+				applier_process_lease_ts(applier, first_row);
 			}
 			applier_signal_ack(applier);
 		} else if (applier_apply_tx(applier, &rows) != 0) {
@@ -1447,6 +2127,7 @@ applier_disconnect(struct applier *applier, enum applier_state state)
 		iostream_close(&applier->io);
 	/* Clear all unparsed input. */
 	ibuf_reinit(&applier->ibuf);
+	applier_zstream_reset(&applier->zstream);
 	fiber_gc();
 }
 
@@ -1659,6 +2340,7 @@ applier_new(struct uri *uri)
 		xcalloc(1, sizeof(struct applier));
 	iostream_clear(&applier->io);
 	ibuf_create(&applier->ibuf, &cord()->slabc, 1024);
+	applier_zstream_create(&applier->zstream);
 
 	uri_move(&applier->uri, uri);
 	applier->last_row_time = ev_monotonic_now(loop());
@@ -1667,6 +2349,20 @@ applier_new(struct uri *uri)
 	fiber_cond_create(&applier->writer_cond);
 	diag_create(&applier->diag);
 
+	applier->stat = rmean_new(applier_stat_strs, APPLIER_STAT_LAST);
+	if (applier->stat == NULL)
+		panic("failed to allocate applier statistics");
+	/* Latency buckets, in microseconds. */
+	static const int64_t latency_buckets[] = {
+		10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000, 20000,
+		50000, 100000, 200000, 500000, 1000000, 2000000, 5000000,
+	};
+	applier->apply_latency = histogram_new(latency_buckets,
+					       lengthof(latency_buckets));
+	applier->wal_latency = histogram_new(latency_buckets,
+					     lengthof(latency_buckets));
+	if (applier->apply_latency == NULL || applier->wal_latency == NULL)
+		panic("failed to allocate applier latency histogram");
 	return applier;
 }
 
@@ -1676,9 +2372,13 @@ applier_delete(struct applier *applier)
 	assert(applier->reader == NULL && applier->writer == NULL);
 	assert(!iostream_is_initialized(&applier->io));
 	ibuf_destroy(&applier->ibuf);
+	applier_zstream_destroy(&applier->zstream);
 	uri_destroy(&applier->uri);
 	trigger_destroy(&applier->on_state);
 	diag_destroy(&applier->diag);
+	rmean_delete(applier->stat);
+	histogram_delete(applier->apply_latency);
+	histogram_delete(applier->wal_latency);
 	free(applier);
 }
 
@@ -45,6 +45,7 @@
 #include "uri/uri.h"
 
 #include "xrow.h"
+#include "zstd.h"
 
 #if defined(__cplusplus)
 extern "C" {
@@ -75,6 +76,39 @@ enum { APPLIER_SOURCE_MAXLEN = 1024 }; /* enough to fit URI with passwords */
 ENUM(applier_state, applier_STATE);
 extern const char *applier_state_strs[];
 
+enum {
+	/** Max value of box.cfg.replication_threads. */
+	APPLIER_THREADS_MAX = 64,
+};
+
+/**
+ * Decompression state of a replication stream, see
+ * IPROTO_COMPRESSED_ROWS.
+ */
+struct applier_zstream {
+	/**
+	 * Decompression context. Created on the first compressed
+	 * batch received from the master.
+	 */
+	ZSTD_DStream *zdctx;
+	/** Decompressed rows not processed yet. */
+	struct ibuf rows;
+};
+
+/** Applier statistics counters, see applier::stat. */
+enum applier_stat_name {
+	/** Rows received from the master. */
+	APPLIER_STAT_ROWS,
+	/** Bytes received from the master. */
+	APPLIER_STAT_BYTES,
+	APPLIER_STAT_LAST,
+};
+
+extern const char *applier_stat_strs[];
+
+struct rmean;
+struct histogram;
+
 /**
  * State of a replication connection to the master
  */
@@ -92,6 +126,12 @@ struct applier {
 	 * condition variable is not enough.
 	 */
 	bool has_acks_to_send;
+	/**
+	 * Lease timestamp of the last heartbeat received from the master,
+	 * sent back in acks. Set only when the master is the Raft leader,
+	 * see box.cfg.election_leader_lease.
+	 */
+	double lease_ts;
 	/** Finite-state machine */
 	enum applier_state state;
 	/** Local time of this replica when the last row has been received */
@@ -121,6 +161,8 @@ struct applier {
 	struct iostream io;
 	/** Input buffer */
 	struct ibuf ibuf;
+	/** Decompression state of the replication stream. */
+	struct applier_zstream zstream;
 	/** Triggers invoked on state change */
 	struct rlist on_state;
 	/**
@@ -134,6 +176,21 @@ struct applier {
 	struct diag diag;
 	/* Master's vclock at the time of SUBSCRIBE. */
 	struct vclock remote_vclock_at_subscribe;
+	/**
+	 * Received rows and bytes. Updated atomically, because
+	 * the stream may be read by an applier thread.
+	 */
+	struct rmean *stat;
+	/**
+	 * Time from the start of applying a transaction to the end
+	 * of its WAL write, in microseconds.
+	 */
+	struct histogram *apply_latency;
+	/**
+	 * Time a transaction spent waiting for WAL: from submitting
+	 * it to the end of the write, in microseconds.
+	 */
+	struct histogram *wal_latency;
 };
 
 /**
@@ -204,6 +261,26 @@ applier_pause(struct applier *applier);
 const char *
 applier_uri_str(const struct applier *applier);
 
+/**
+ * Start the applier thread pool. If @a thread_count is 0,
+ * replication streams are read and decoded in tx.
+ */
+void
+applier_init(int thread_count);
+
+/**
+ * Pin the applier threads to the given CPUs, see
+ * cord_set_cpu_affinity().
+ */
+int
+applier_set_cpu_affinity(const char *cpus);
+
+/**
+ * Stop the applier thread pool.
+ */
+void
+applier_free(void);
+
 #if defined(__cplusplus)
 } /* extern "C" */
 #endif /* defined(__cplusplus) */
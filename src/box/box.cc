@@ -767,7 +767,7 @@ box_check_election_timeout(void)
 }
 
 static int
-box_check_uri_set(const char *option_name)
+box_check_uri_set(const char *option_name, enum iostream_mode mode)
 {
 	struct uri_set uri_set;
 	if (cfg_get_uri_set(option_name, &uri_set) != 0) {
@@ -787,6 +787,15 @@ box_check_uri_set(const char *option_name)
 			rc = -1;
 			break;
 		}
+		/* Check the transport parameters, e.g. SSL files. */
+		struct iostream_ctx io_ctx;
+		if (iostream_ctx_create(&io_ctx, mode, uri) != 0) {
+			diag_set(ClientError, ER_CFG, option_name,
+				 diag_last_error(diag_get())->errmsg);
+			rc = -1;
+			break;
+		}
+		iostream_ctx_destroy(&io_ctx);
 	}
 	uri_set_destroy(&uri_set);
 	return rc;
@@ -795,13 +804,13 @@ box_check_uri_set(const char *option_name)
 static int
 box_check_replication(void)
 {
-	return box_check_uri_set("replication");
+	return box_check_uri_set("replication", IOSTREAM_CLIENT);
 }
 
 static int
 box_check_listen(void)
 {
-	return box_check_uri_set("listen");
+	return box_check_uri_set("listen", IOSTREAM_SERVER);
 }
 
 static double
@@ -974,6 +983,33 @@ box_check_replication_synchro_timeout(void)
 	return timeout;
 }
 
+static int
+box_check_replication_compression_level(void)
+{
+	int level = cfg_geti("replication_compression_level");
+	if (level < 0 || level > ZSTD_maxCLevel()) {
+		diag_set(ClientError, ER_CFG, "replication_compression_level",
+			 tt_sprintf("must be greater than or equal to 0,"
+				    " less than or equal to %d",
+				    ZSTD_maxCLevel()));
+		return -1;
+	}
+	return level;
+}
+
+static int
+box_check_replication_compression_batch_size(void)
+{
+	int size = cfg_geti("replication_compression_batch_size");
+	if (size <= 0) {
+		diag_set(ClientError, ER_CFG,
+			 "replication_compression_batch_size",
+			 "the value must be greater than zero");
+		return -1;
+	}
+	return size;
+}
+
 static double
 box_check_replication_sync_timeout(void)
 {
@@ -1048,6 +1084,16 @@ box_check_wal_mode(const char *mode_name)
 	return (enum wal_mode) mode;
 }
 
+static enum wal_io_mode
+box_check_wal_io_mode(const char *mode_name)
+{
+	assert(mode_name != NULL); /* checked in Lua */
+	int mode = strindex(wal_io_mode_STRS, mode_name, WAL_IO_MODE_MAX);
+	if (mode == WAL_IO_MODE_MAX)
+		tnt_raise(ClientError, ER_CFG, "wal_io_mode", mode_name);
+	return (enum wal_io_mode) mode;
+}
+
 static int64_t
 box_check_wal_queue_max_size(void)
 {
@@ -1075,6 +1121,34 @@ box_check_wal_cleanup_delay(void)
 	return value;
 }
 
+static double
+box_check_snap_io_latency_target(void)
+{
+	double target = cfg_getd("snap_io_latency_target");
+	if (target < 0) {
+		diag_set(ClientError, ER_CFG, "snap_io_latency_target",
+			 "value must be >= 0");
+		return -1;
+	}
+	return target;
+}
+
+static int
+box_check_wal_group_commit(void)
+{
+	if (cfg_getd("wal_group_commit_delay") < 0) {
+		diag_set(ClientError, ER_CFG, "wal_group_commit_delay",
+			 "value must be >= 0");
+		return -1;
+	}
+	if (cfg_geti64("wal_group_commit_max_size") <= 0) {
+		diag_set(ClientError, ER_CFG, "wal_group_commit_max_size",
+			 "value must be > 0");
+		return -1;
+	}
+	return 0;
+}
+
 static void
 box_check_readahead(int readahead)
 {
@@ -1086,6 +1160,58 @@ box_check_readahead(int readahead)
 	}
 }
 
+static int
+box_check_iproto_coalesce(void)
+{
+	int64_t size = cfg_geti64("iproto_coalesce_size");
+	if (size < 0 || size > UINT32_MAX) {
+		diag_set(ClientError, ER_CFG, "iproto_coalesce_size",
+			 "specified value is out of bounds");
+		return -1;
+	}
+	if (cfg_getd("iproto_coalesce_timeout") < 0) {
+		diag_set(ClientError, ER_CFG, "iproto_coalesce_timeout",
+			 "value must be >= 0");
+		return -1;
+	}
+	return 0;
+}
+
+static int
+box_check_slow_request_threshold(void)
+{
+	if (cfg_getd("slow_request_threshold") < 0) {
+		diag_set(ClientError, ER_CFG, "slow_request_threshold",
+			 "value must be >= 0");
+		return -1;
+	}
+	return 0;
+}
+
+static int
+box_check_iproto_busy_poll(void)
+{
+	if (cfg_geti("iproto_busy_poll") < 0) {
+		diag_set(ClientError, ER_CFG, "iproto_busy_poll",
+			 "value must be >= 0");
+		return -1;
+	}
+	return 0;
+}
+
+/** Check an option with a list of CPUs to pin a thread to. */
+static int
+box_check_cpu_affinity(const char *option)
+{
+	if (cord_check_cpu_affinity(cfg_gets(option)) != 0) {
+		diag_set(ClientError, ER_CFG, option,
+			 "must be a list of CPU numbers and ranges, "
+			 "like '0-3,8'");
+		return -1;
+	}
+	return 0;
+}
+
 static void
 box_check_checkpoint_count(int checkpoint_count)
 {
@@ -1118,6 +1244,22 @@ box_check_memory_quota(const char *quota_name)
 	return -1;
 }
 
+static int
+box_check_vinyl_upsert_squash_threshold(void)
+{
+	int threshold = cfg_geti("vinyl_upsert_squash_threshold");
+	/*
+	 * Vinyl counts upserts in an uint8_t and reserves the max
+	 * value for a chain that is already being squashed.
+	 */
+	if (threshold < 1 || threshold > UINT8_MAX - 1) {
+		diag_set(ClientError, ER_CFG, "vinyl_upsert_squash_threshold",
+			 tt_sprintf("must be >= 1 and <= %d", UINT8_MAX - 1));
+		return -1;
+	}
+	return threshold;
+}
+
 static void
 box_check_vinyl_options(void)
 {
@@ -1131,6 +1273,10 @@ box_check_vinyl_options(void)
 
 	if (box_check_memory_quota("vinyl_memory") < 0)
 		diag_raise();
+	if (box_check_memory_quota("vinyl_page_cache") < 0)
+		diag_raise();
+	if (box_check_vinyl_upsert_squash_threshold() < 0)
+		diag_raise();
 
 	if (read_threads < 1) {
 		tnt_raise(ClientError, ER_CFG, "vinyl_read_threads",
@@ -1183,6 +1329,19 @@ box_check_allocator(void)
 	return 0;
 }
 
+static int
+box_check_memtx_numa_node(void)
+{
+	int node = cfg_geti("memtx_numa_node");
+	if (node < -1 || node > MEMTX_NUMA_NODE_MAX) {
+		diag_set(ClientError, ER_CFG, "memtx_numa_node",
+			 tt_sprintf("must be -1 or a NUMA node number not "
+				    "greater than %d", MEMTX_NUMA_NODE_MAX));
+		return -1;
+	}
+	return 0;
+}
+
 static void
 box_check_small_alloc_options(void)
 {
@@ -1221,6 +1380,52 @@ box_check_iproto_options(void)
 	return 0;
 }
 
+static int
+box_check_memtx_snap_compress_threads(void)
+{
+	int thread_count = cfg_geti("memtx_snap_compress_threads");
+	if (thread_count < 0 || thread_count > XLOG_COMPRESS_THREADS_MAX) {
+		diag_set(ClientError, ER_CFG, "memtx_snap_compress_threads",
+			 tt_sprintf("must be greater than or equal to 0,"
+				    " less than or equal to %d",
+				    XLOG_COMPRESS_THREADS_MAX));
+		return -1;
+	}
+	return thread_count;
+}
+
+static int
+box_check_replication_threads(void)
+{
+	int thread_count = cfg_geti("replication_threads");
+	if (thread_count < 0 || thread_count > APPLIER_THREADS_MAX) {
+		diag_set(ClientError, ER_CFG, "replication_threads",
+			 tt_sprintf("must be greater than or equal to 0,"
+				    " less than or equal to %d",
+				    APPLIER_THREADS_MAX));
+		return -1;
+	}
+	return thread_count;
+}
+
+/**
+ * Check a zstd compression level option and return its value
+ * or -1 if it is invalid.
+ */
+static int
+box_check_compression_level(const char *option)
+{
+	int level = cfg_geti(option);
+	if (level < 1 || level > ZSTD_maxCLevel()) {
+		diag_set(ClientError, ER_CFG, option,
+			 tt_sprintf("must be greater than or equal to 1,"
+				    " less than or equal to %d",
+				    ZSTD_maxCLevel()));
+		return -1;
+	}
+	return level;
+}
+
 static double
 box_check_txn_timeout(void)
 {
@@ -1257,20 +1462,50 @@ box_check_config(void)
 	if (box_check_replication_synchro_timeout() < 0)
 		diag_raise();
 	box_check_replication_sync_timeout();
+	if (box_check_replication_compression_level() < 0)
+		diag_raise();
+	if (box_check_replication_compression_batch_size() < 0)
+		diag_raise();
 	box_check_readahead(cfg_geti("readahead"));
+	if (box_check_iproto_coalesce() != 0)
+		diag_raise();
+	if (box_check_slow_request_threshold() != 0)
+		diag_raise();
+	if (box_check_iproto_busy_poll() != 0)
+		diag_raise();
+	if (box_check_cpu_affinity("tx_cpu_affinity") != 0 ||
+	    box_check_cpu_affinity("wal_cpu_affinity") != 0 ||
+	    box_check_cpu_affinity("iproto_cpu_affinity") != 0 ||
+	    box_check_cpu_affinity("replication_cpu_affinity") != 0)
+		diag_raise();
 	box_check_checkpoint_count(cfg_geti("checkpoint_count"));
 	box_check_wal_max_size(cfg_geti64("wal_max_size"));
 	box_check_wal_mode(cfg_gets("wal_mode"));
+	box_check_wal_io_mode(cfg_gets("wal_io_mode"));
 	if (box_check_wal_queue_max_size() < 0)
 		diag_raise();
 	if (box_check_wal_cleanup_delay() < 0)
 		diag_raise();
+	if (box_check_snap_io_latency_target() < 0)
+		diag_raise();
+	if (box_check_wal_group_commit() != 0)
+		diag_raise();
 	if (box_check_memory_quota("memtx_memory") < 0)
 		diag_raise();
 	box_check_memtx_min_tuple_size(cfg_geti64("memtx_min_tuple_size"));
 	if (box_check_allocator() != 0)
 		diag_raise();
+	if (box_check_memtx_numa_node() != 0)
+		diag_raise();
 	box_check_small_alloc_options();
+	if (box_check_memtx_snap_compress_threads() < 0)
+		diag_raise();
+	if (box_check_replication_threads() < 0)
+		diag_raise();
+	if (box_check_compression_level("memtx_snap_compression_level") < 0 ||
+	    box_check_compression_level("vinyl_compression_level") < 0 ||
+	    box_check_compression_level("wal_compression_level") < 0)
+		diag_raise();
 	box_check_vinyl_options();
 	if (box_check_iproto_options() != 0)
 		diag_raise();
@@ -1302,6 +1537,13 @@ box_set_election_timeout(void)
 	return 0;
 }
 
+void
+box_set_election_leader_lease(void)
+{
+	raft_cfg_is_lease_enabled(box_raft(),
+				  cfg_getb("election_leader_lease"));
+}
+
 /*
  * Parse box.cfg.replication and create appliers.
  */
@@ -1483,6 +1725,26 @@ box_set_replication_sync_timeout(void)
 	replication_sync_timeout = box_check_replication_sync_timeout();
 }
 
+int
+box_set_replication_compression_level(void)
+{
+	int level = box_check_replication_compression_level();
+	if (level < 0)
+		return -1;
+	replication_compression_level = level;
+	return 0;
+}
+
+int
+box_set_replication_compression_batch_size(void)
+{
+	int size = box_check_replication_compression_batch_size();
+	if (size < 0)
+		return -1;
+	replication_compression_batch_size = size;
+	return 0;
+}
+
 void
 box_set_replication_skip_conflict(void)
 {
@@ -1938,6 +2200,40 @@ box_demote(void)
 	return 0;
 }
 
+int
+box_read_barrier(double timeout)
+{
+	struct raft *raft = box_raft();
+	/*
+	 * Without a lease a leader can't know if it's still the leader
+	 * without a round trip, so only wait for the pending synchronous
+	 * transactions to be committed.
+	 */
+	if (!raft->is_lease_enabled)
+		return txn_limbo_wait_empty(&txn_limbo, timeout);
+	double deadline = ev_monotonic_now(loop()) + timeout;
+	while (true) {
+		if (!raft->is_enabled) {
+			diag_set(ClientError, ER_ELECTION_DISABLED);
+			return -1;
+		}
+		if (raft->state != RAFT_STATE_LEADER) {
+			diag_set(ClientError, ER_NOT_LEADER, raft->leader);
+			return -1;
+		}
+		/*
+		 * The data written by the previous leaders is visible only
+		 * when the synchro queue is taken over.
+		 */
+		if (raft_has_lease(raft) && txn_limbo.owner_id == instance_id &&
+		    txn_limbo_replica_term(&txn_limbo, instance_id) ==
+		    raft->term)
+			return 0;
+		if (box_raft_wait_lease(deadline) != 0)
+			return -1;
+	}
+}
+
 int
 box_listen(void)
 {
@@ -1997,6 +2293,45 @@ box_set_memtx_memory(void)
 	memtx_engine_set_memory_xc(memtx, size);
 }
 
+int
+box_set_memtx_snap_compress_threads(void)
+{
+	int thread_count = box_check_memtx_snap_compress_threads();
+	if (thread_count < 0)
+		return -1;
+	struct memtx_engine *memtx;
+	memtx = (struct memtx_engine *)engine_by_name("memtx");
+	assert(memtx != NULL);
+	memtx_engine_set_snap_compress_threads(memtx, thread_count);
+	return 0;
+}
+
+int
+box_set_memtx_snap_compression_level(void)
+{
+	int level = box_check_compression_level(
+		"memtx_snap_compression_level");
+	if (level < 0)
+		return -1;
+	struct memtx_engine *memtx;
+	memtx = (struct memtx_engine *)engine_by_name("memtx");
+	assert(memtx != NULL);
+	memtx_engine_set_snap_compression_level(memtx, level);
+	return 0;
+}
+
+int
+box_set_vinyl_compression_level(void)
+{
+	int level = box_check_compression_level("vinyl_compression_level");
+	if (level < 0)
+		return -1;
+	struct engine *vinyl = engine_by_name("vinyl");
+	assert(vinyl != NULL);
+	vinyl_engine_set_compression_level(vinyl, level);
+	return 0;
+}
+
 void
 box_set_memtx_max_tuple_size(void)
 {
@@ -2025,6 +2360,39 @@ box_set_readahead(void)
 	iproto_readahead = readahead;
 }
 
+int
+box_set_iproto_coalesce(void)
+{
+	if (box_check_iproto_coalesce() != 0)
+		return -1;
+	iproto_coalesce_size = cfg_geti64("iproto_coalesce_size");
+	iproto_coalesce_timeout = cfg_getd("iproto_coalesce_timeout");
+	return 0;
+}
+
+/** Pin the threads to the CPUs set in box.cfg.*_cpu_affinity. */
+static int
+box_set_cpu_affinity(void)
+{
+	const char *replication_cpus = cfg_gets("replication_cpu_affinity");
+	if (cord_set_cpu_affinity(cord(), cfg_gets("tx_cpu_affinity")) != 0 ||
+	    wal_set_cpu_affinity(cfg_gets("wal_cpu_affinity")) != 0 ||
+	    iproto_set_cpu_affinity(cfg_gets("iproto_cpu_affinity")) != 0 ||
+	    applier_set_cpu_affinity(replication_cpus) != 0)
+		return -1;
+	relay_set_cpu_affinity(replication_cpus);
+	return 0;
+}
+
+int
+box_set_slow_request_threshold(void)
+{
+	if (box_check_slow_request_threshold() != 0)
+		return -1;
+	iproto_slow_request_threshold = cfg_getd("slow_request_threshold");
+	return 0;
+}
+
 void
 box_set_checkpoint_count(void)
 {
@@ -2057,6 +2425,26 @@ box_set_wal_queue_max_size(void)
 	return 0;
 }
 
+int
+box_set_wal_group_commit(void)
+{
+	if (box_check_wal_group_commit() != 0)
+		return -1;
+	wal_set_group_commit(cfg_getd("wal_group_commit_delay"),
+			     cfg_geti64("wal_group_commit_max_size"));
+	return 0;
+}
+
+int
+box_set_snap_io_latency_target(void)
+{
+	double target = box_check_snap_io_latency_target();
+	if (target < 0)
+		return -1;
+	wal_set_latency_target(target);
+	return 0;
+}
+
 int
 box_set_wal_cleanup_delay(void)
 {
@@ -2102,6 +2490,37 @@ box_set_vinyl_cache(void)
 	vinyl_engine_set_cache(vinyl, cfg_geti64("vinyl_cache"));
 }
 
+void
+box_set_vinyl_cache_scan_resistant(void)
+{
+	struct engine *vinyl = engine_by_name("vinyl");
+	assert(vinyl != NULL);
+	vinyl_engine_set_cache_scan_resistant_xc(vinyl,
+			cfg_getb("vinyl_cache_scan_resistant"));
+}
+
+void
+box_set_vinyl_page_cache(void)
+{
+	struct engine *vinyl = engine_by_name("vinyl");
+	assert(vinyl != NULL);
+	ssize_t size = box_check_memory_quota("vinyl_page_cache");
+	if (size < 0)
+		diag_raise();
+	vinyl_engine_set_page_cache(vinyl, size);
+}
+
+void
+box_set_vinyl_upsert_squash_threshold(void)
+{
+	struct engine *vinyl = engine_by_name("vinyl");
+	assert(vinyl != NULL);
+	int threshold = box_check_vinyl_upsert_squash_threshold();
+	if (threshold < 0)
+		diag_raise();
+	vinyl_engine_set_upsert_squash_threshold(vinyl, threshold);
+}
+
 void
 box_set_vinyl_timeout(void)
 {
@@ -2115,9 +2534,10 @@ box_set_net_msg_max(void)
 {
 	int new_iproto_msg_max = cfg_geti("net_msg_max");
 	iproto_set_msg_max(new_iproto_msg_max);
-	fiber_pool_set_max_size(&tx_fiber_pool,
-				new_iproto_msg_max *
-				IPROTO_FIBER_POOL_SIZE_FACTOR);
+	int pool_size = new_iproto_msg_max * IPROTO_FIBER_POOL_SIZE_FACTOR;
+	ERROR_INJECT_COND(ERRINJ_TX_FIBER_POOL_SIZE, ERRINJ_INT,
+			  inj->iparam > 0, pool_size = inj->iparam);
+	fiber_pool_set_max_size(&tx_fiber_pool, pool_size);
 }
 
 int
@@ -2288,13 +2708,11 @@ box_index_id_by_name(uint32_t space_id, const char *name, uint32_t len)
 }
 /** \endcond public */
 
-int
-box_process1(struct request *request, box_tuple_t **result)
+/** Check that a DML request may write to the space. */
+static int
+box_check_space_writable(struct space *space)
 {
 	/* Allow to write to temporary spaces in read-only mode. */
-	struct space *space = space_cache_find(request->space_id);
-	if (space == NULL)
-		return -1;
 	if (!space_is_temporary(space) &&
 	    space_group_id(space) != GROUP_LOCAL &&
 	    box_check_writable() != 0)
@@ -2316,15 +2734,122 @@ box_process1(struct request *request, box_tuple_t **result)
 			return -1;
 		}
 	}
+	return 0;
+}
 
+int
+box_process1(struct request *request, box_tuple_t **result)
+{
+	struct space *space = space_cache_find(request->space_id);
+	if (space == NULL)
+		return -1;
+	if (box_check_space_writable(space) != 0)
+		return -1;
 	return box_process_rw(request, space, result);
 }
 
+int
+box_process_many(uint32_t space_id, uint16_t type, const char *tuples,
+		 const char *tuples_end)
+{
+	(void)tuples_end;
+	assert(type == IPROTO_INSERT || type == IPROTO_REPLACE);
+	struct space *space = space_cache_find(space_id);
+	if (space == NULL)
+		return -1;
+	if (box_check_space_writable(space) != 0)
+		return -1;
+	if (mp_typeof(*tuples) != MP_ARRAY) {
+		diag_set(ClientError, ER_ILLEGAL_PARAMS,
+			 "tuples must be an array");
+		return -1;
+	}
+	uint32_t count = mp_decode_array(&tuples);
+	if (access_check_space(space, PRIV_W) != 0)
+		return -1;
+	/*
+	 * The batch is atomic: in autocommit mode it is committed as
+	 * one transaction, otherwise a failed batch is rolled back to
+	 * where it started.
+	 */
+	struct txn *txn = in_txn();
+	bool is_autocommit = txn == NULL;
+	box_txn_savepoint_t *svp = NULL;
+	if (is_autocommit) {
+		txn = txn_begin();
+		if (txn == NULL)
+			return -1;
+	} else {
+		svp = box_txn_savepoint();
+		if (svp == NULL)
+			return -1;
+	}
+	rmean_collect(rmean_box, type, count);
+	struct request request;
+	memset(&request, 0, sizeof(request));
+	request.type = type;
+	request.space_id = space_id;
+	for (uint32_t i = 0; i < count; i++) {
+		if (mp_typeof(*tuples) != MP_ARRAY) {
+			diag_set(ClientError, ER_TUPLE_NOT_ARRAY);
+			goto rollback;
+		}
+		request.tuple = tuples;
+		mp_next(&tuples);
+		request.tuple_end = tuples;
+		if (txn_begin_stmt(txn, space, type) != 0)
+			goto rollback;
+		struct tuple *result;
+		if (space_execute_dml(space, txn, &request, &result) != 0) {
+			txn_rollback_stmt(txn);
+			goto rollback;
+		}
+		if (txn_commit_stmt(txn, &request) != 0)
+			goto rollback;
+	}
+	if (is_autocommit) {
+		if (txn_commit(txn) < 0)
+			return -1;
+		fiber_gc();
+	}
+	return 0;
+rollback:
+	if (is_autocommit) {
+		txn_abort(txn);
+		fiber_gc();
+	} else {
+		/* Keep the error of the failed statement. */
+		struct error *e = diag_last_error(diag_get());
+		error_ref(e);
+		if (box_txn_rollback_to_savepoint(svp) != 0)
+			diag_log();
+		diag_set_error(diag_get(), e);
+		error_unref(e);
+	}
+	return -1;
+}
+
+/**
+ * Number of parts of a position that an iterator needs to start
+ * right after it. A position is a cmp_def key, but a unique index
+ * without nullable parts orders tuples by key_def already, so the
+ * primary key parts of the position aren't needed.
+ */
+static uint32_t
+box_select_position_part_count(struct index *index)
+{
+	struct index_def *def = index->def;
+	if (def->opts.is_unique && !def->key_def->is_nullable)
+		return def->key_def->part_count;
+	return def->cmp_def->part_count;
+}
+
 API_EXPORT int
 box_select(uint32_t space_id, uint32_t index_id,
 	   int iterator, uint32_t offset, uint32_t limit,
 	   const char *key, const char *key_end,
-	   struct port *port)
+	   const char **packed_pos, const char **packed_pos_end,
+	   bool update_pos, struct port *port)
 {
 	(void)key_end;
 
@@ -2347,9 +2872,16 @@ box_select(uint32_t space_id, uint32_t index_id,
 		return -1;
 
 	enum iterator_type type = (enum iterator_type) iterator;
+	const char *key_array = key;
 	uint32_t part_count = key ? mp_decode_array(&key) : 0;
 	if (key_validate(index->def, type, key, part_count))
 		return -1;
+	assert(packed_pos != NULL || !update_pos);
+	const char *pos = packed_pos != NULL ? *packed_pos : NULL;
+	if ((pos != NULL || update_pos) &&
+	    index_check_position(index, type, key_array, part_count,
+				 pos, pos != NULL ? *packed_pos_end : NULL) != 0)
+		return -1;
 
 	ERROR_INJECT(ERRINJ_TESTING, {
 		diag_set(ClientError, ER_INJECTION, "ERRINJ_TESTING");
@@ -2361,8 +2893,27 @@ box_select(uint32_t space_id, uint32_t index_id,
 	if (txn_begin_ro_stmt(space, &txn, &svp) != 0)
 		return -1;
 
-	struct iterator *it = index_create_iterator(index, type,
-						    key, part_count);
+	/*
+	 * To continue after a position, iterate strictly after it.
+	 * The position is within the range of the original iterator,
+	 * so only the EQ and REQ iterators need to check the key.
+	 */
+	enum iterator_type it_type = type;
+	const char *it_key = key;
+	uint32_t it_part_count = part_count;
+	bool check_key = false;
+	if (pos != NULL) {
+		it_type = iterator_type_is_reverse(type) ? ITER_LT : ITER_GT;
+		it_key = pos;
+		mp_decode_array(&it_key);
+		it_part_count = box_select_position_part_count(index);
+		check_key = part_count > 0 &&
+			    (type == ITER_EQ || type == ITER_REQ);
+	}
+	struct iterator *it = index_create_iterator_with_offset(index, it_type,
+								it_key,
+								it_part_count,
+								&offset);
 	if (it == NULL) {
 		txn_rollback_stmt(txn);
 		return -1;
@@ -2371,11 +2922,17 @@ box_select(uint32_t space_id, uint32_t index_id,
 	int rc = 0;
 	uint32_t found = 0;
 	struct tuple *tuple;
+	struct tuple *last = NULL;
 	port_c_create(port);
 	while (found < limit) {
 		rc = iterator_next(it, &tuple);
 		if (rc != 0 || tuple == NULL)
 			break;
+		if (check_key &&
+		    tuple_compare_with_key(tuple, HINT_NONE, key, part_count,
+					   HINT_NONE,
+					   index->def->key_def) != 0)
+			break;
 		if (offset > 0) {
 			offset--;
 			continue;
@@ -2383,8 +2940,13 @@ box_select(uint32_t space_id, uint32_t index_id,
 		rc = port_c_add_tuple(port, tuple);
 		if (rc != 0)
 			break;
+		last = tuple;
 		found++;
 	}
+	/* The last tuple is referenced by the port. */
+	if (rc == 0 && update_pos && last != NULL)
+		rc = index_tuple_position(index, last, packed_pos,
+					  packed_pos_end);
 	iterator_delete(it);
 
 	if (rc != 0) {
@@ -2396,6 +2958,44 @@ box_select(uint32_t space_id, uint32_t index_id,
 	return 0;
 }
 
+int
+box_select_read_view(uint32_t space_id, uint32_t index_id, int iterator,
+		     const char *key, const char *key_end,
+		     struct snapshot_iterator **result)
+{
+	(void)key_end;
+	*result = NULL;
+	/*
+	 * A select in a transaction must see the changes done by
+	 * the transaction, so it can't use a read view.
+	 */
+	if (in_txn() != NULL)
+		return 0;
+	if (iterator < 0 || iterator >= iterator_type_MAX)
+		return 0;
+	struct space *space = space_by_id(space_id);
+	if (space == NULL || !space->def->opts.read_view_enabled)
+		return 0;
+	struct index *index = space_index(space, index_id);
+	/* Only unique-entry tree indexes support read views now. */
+	if (index == NULL || index->def->type != TREE ||
+	    index->def->key_def->is_multikey ||
+	    index->def->key_def->for_func_index)
+		return 0;
+
+	rmean_collect(rmean_box, IPROTO_SELECT, 1);
+
+	if (access_check_space(space, PRIV_R) != 0)
+		return -1;
+	enum iterator_type type = (enum iterator_type) iterator;
+	uint32_t part_count = key ? mp_decode_array(&key) : 0;
+	if (key_validate(index->def, type, key, part_count))
+		return -1;
+	*result = index_create_read_view_iterator(index, type,
+						  key, part_count);
+	return *result != NULL ? 0 : -1;
+}
+
 API_EXPORT int
 box_insert(uint32_t space_id, const char *tuple, const char *tuple_end,
 	   box_tuple_t **result)
@@ -2589,7 +3189,9 @@ box_sequence_next(uint32_t seq_id, int64_t *result)
 	int64_t value;
 	if (sequence_next(seq, &value) != 0)
 		return -1;
-	if (sequence_data_update(seq_id, value) != 0)
+	int64_t reserved;
+	if (sequence_reserve(seq, &reserved) &&
+	    sequence_data_update(seq_id, reserved) != 0)
 		return -1;
 	*result = value;
 	return 0;
@@ -2974,9 +3576,11 @@ box_process_subscribe(struct iostream *io, const struct xrow_header *header)
 	uint32_t replica_version_id;
 	bool anon;
 	uint32_t id_filter;
+	struct iproto_features features;
+	struct xrow_subscribe_filter filter;
 	xrow_decode_subscribe_xc(header, &peer_replicaset_uuid, &replica_uuid,
 				 &replica_clock, &replica_version_id, &anon,
-				 &id_filter);
+				 &id_filter, &features, &filter);
 
 	/* Forbid connection to itself */
 	if (tt_uuid_is_equal(&replica_uuid, &INSTANCE_UUID))
@@ -3027,6 +3631,14 @@ box_process_subscribe(struct iostream *io, const struct xrow_header *header)
 		tnt_raise(ClientError, ER_PROTOCOL, "Can't subscribe an "
 			  "anonymous replica having an ID assigned");
 	}
+	/*
+	 * A registered replica may become a master, so it must
+	 * have all the data. Filters are for consumers only.
+	 */
+	if (!anon && !xrow_subscribe_filter_is_empty(&filter)) {
+		tnt_raise(ClientError, ER_PROTOCOL, "Can't subscribe a "
+			  "non-anonymous replica with a row filter");
+	}
 	if (replica == NULL)
 		replica = replicaset_add_anon(&replica_uuid);
 
@@ -3118,7 +3730,7 @@ box_process_subscribe(struct iostream *io, const struct xrow_header *header)
 	 * indefinitely).
 	 */
 	relay_subscribe(replica, io, header->sync, &replica_clock,
-			replica_version_id, id_filter);
+			replica_version_id, id_filter, &features, &filter);
 }
 
 void
@@ -3171,6 +3783,7 @@ box_free(void)
 		box_raft_free();
 		iproto_free();
 		replication_free();
+		applier_free();
 		sequence_free();
 		gc_free();
 		engine_shutdown();
@@ -3197,7 +3810,9 @@ engine_init()
 				    cfg_geti("strip_core"),
 				    cfg_geti("slab_alloc_granularity"),
 				    cfg_gets("memtx_allocator"),
-				    cfg_getd("slab_alloc_factor"));
+				    cfg_getd("slab_alloc_factor"),
+				    cfg_getb("memtx_use_huge_pages"),
+				    cfg_geti("memtx_numa_node"));
 	engine_register((struct engine *)memtx);
 	box_set_memtx_max_tuple_size();
 
@@ -3219,6 +3834,9 @@ engine_init()
 	engine_register((struct engine *)vinyl);
 	box_set_vinyl_max_tuple_size();
 	box_set_vinyl_cache();
+	box_set_vinyl_cache_scan_resistant();
+	box_set_vinyl_page_cache();
+	box_set_vinyl_upsert_squash_threshold();
 	box_set_vinyl_timeout();
 }
 
@@ -3431,6 +4049,18 @@ local_recovery(const struct tt_uuid *instance_uuid,
 	bool is_force_recovery = cfg_geti("force_recovery");
 	recovery = recovery_new(wal_dir(), is_force_recovery,
 				checkpoint_vclock);
+	/*
+	 * WAL files can't change under us while we own the WAL
+	 * directory lock so it's safe to read them with mmap() and
+	 * in a background thread.
+	 * Relays and hot standby read files that may be truncated
+	 * by a writer after a write error, and accessing a truncated
+	 * mapping raises SIGBUS, so they still use pread().
+	 */
+	if (wal_dir_lock >= 0) {
+		recovery->wal_dir.opts.read_mmap = true;
+		recovery->use_reader = true;
+	}
 
 	/*
 	 * Make sure we report the actual recovery position
@@ -3628,17 +4258,24 @@ box_cfg_xc(void)
 	engine_init();
 	schema_init();
 	replication_init();
+	applier_init(cfg_geti("replication_threads"));
 	port_init();
+	iproto_busy_poll = cfg_geti("iproto_busy_poll");
 	iproto_init(cfg_geti("iproto_threads"));
 	sql_init();
 
 	int64_t wal_max_size = box_check_wal_max_size(cfg_geti64("wal_max_size"));
 	enum wal_mode wal_mode = box_check_wal_mode(cfg_gets("wal_mode"));
-	if (wal_init(wal_mode, cfg_gets("wal_dir"), wal_max_size,
+	enum wal_io_mode wal_io_mode =
+		box_check_wal_io_mode(cfg_gets("wal_io_mode"));
+	if (wal_init(wal_mode, wal_io_mode, cfg_gets("wal_dir"), wal_max_size,
+		     cfg_geti("wal_compression_level"),
 		     &INSTANCE_UUID, on_wal_garbage_collection,
 		     on_wal_checkpoint_threshold) != 0) {
 		diag_raise();
 	}
+	if (box_set_cpu_affinity() != 0)
+		diag_raise();
 
 	title("loading");
 
@@ -3650,6 +4287,10 @@ box_cfg_xc(void)
 		diag_raise();
 	box_set_net_msg_max();
 	box_set_readahead();
+	if (box_set_iproto_coalesce() != 0)
+		diag_raise();
+	if (box_set_slow_request_threshold() != 0)
+		diag_raise();
 	box_set_too_long_threshold();
 	box_set_replication_timeout();
 	box_set_replication_connect_timeout();
@@ -3660,6 +4301,9 @@ box_cfg_xc(void)
 	if (box_set_replication_synchro_timeout() != 0)
 		diag_raise();
 	box_set_replication_sync_timeout();
+	if (box_set_replication_compression_level() != 0 ||
+	    box_set_replication_compression_batch_size() != 0)
+		diag_raise();
 	box_set_replication_skip_conflict();
 	box_set_replication_anon();
 
@@ -3758,6 +4402,7 @@ box_cfg_xc(void)
 
 	if (box_set_election_timeout() != 0)
 		diag_raise();
+	box_set_election_leader_lease();
 	/*
 	 * Election is enabled last. So as all the parameters are installed by
 	 * that time.
@@ -3845,7 +4490,9 @@ box_checkpoint(void)
 }
 
 int
-box_backup_start(int checkpoint_idx, box_backup_cb cb, void *cb_arg)
+box_backup_start(int checkpoint_idx, const struct engine_backup_point *since,
+		 struct engine_backup_point *point,
+		 box_backup_cb cb, void *cb_arg)
 {
 	assert(checkpoint_idx >= 0);
 	if (backup_is_in_progress) {
@@ -3861,9 +4508,15 @@ box_backup_start(int checkpoint_idx, box_backup_cb cb, void *cb_arg)
 		diag_set(ClientError, ER_MISSING_SNAPSHOT);
 		return -1;
 	}
+	point->signature = vclock_sum(&checkpoint->vclock);
+	if (since != NULL && since->signature > point->signature) {
+		diag_set(ClientError, ER_ILLEGAL_PARAMS, "incremental backup "
+			 "can't be based on a newer checkpoint");
+		return -1;
+	}
 	backup_is_in_progress = true;
 	gc_ref_checkpoint(checkpoint, &backup_gc, "backup");
-	int rc = engine_backup(&checkpoint->vclock, cb, cb_arg);
+	int rc = engine_backup(&checkpoint->vclock, since, point, cb, cb_arg);
 	if (rc != 0) {
 		gc_unref_checkpoint(&backup_gc);
 		backup_is_in_progress = false;
@@ -52,6 +52,7 @@ struct iostream;
 struct auth_request;
 struct space;
 struct vclock;
+struct engine_backup_point;
 
 /**
  * Pointer to TX thread local vclock.
@@ -175,11 +176,18 @@ typedef int (*box_backup_cb)(const char *path, void *arg);
  * is 0, the last checkpoint will be backed up; if it is 1, next
  * to last, and so on.
  *
+ * If @since is not NULL, the backup is incremental: it skips files
+ * that were already listed by the backup @since was returned for.
+ * The state needed to make the next incremental backup is stored
+ * in @point.
+ *
  * The caller is supposed to call box_backup_stop() after he's
  * done copying the files.
  */
 int
-box_backup_start(int checkpoint_idx, box_backup_cb cb, void *cb_arg);
+box_backup_start(int checkpoint_idx, const struct engine_backup_point *since,
+		 struct engine_backup_point *point,
+		 box_backup_cb cb, void *cb_arg);
 
 /**
  * Finish backup started with box_backup_start().
@@ -258,14 +266,25 @@ void box_set_checkpoint_interval(void);
 void box_set_checkpoint_wal_threshold(void);
 int box_set_wal_queue_max_size(void);
 int box_set_wal_cleanup_delay(void);
+int box_set_wal_group_commit(void);
+int box_set_snap_io_latency_target(void);
+int box_set_iproto_coalesce(void);
+int box_set_slow_request_threshold(void);
 void box_set_memtx_memory(void);
 void box_set_memtx_max_tuple_size(void);
+int box_set_memtx_snap_compress_threads(void);
+int box_set_memtx_snap_compression_level(void);
+int box_set_vinyl_compression_level(void);
 void box_set_vinyl_memory(void);
 void box_set_vinyl_max_tuple_size(void);
 void box_set_vinyl_cache(void);
+void box_set_vinyl_cache_scan_resistant(void);
+void box_set_vinyl_page_cache(void);
+void box_set_vinyl_upsert_squash_threshold(void);
 void box_set_vinyl_timeout(void);
 int box_set_election_mode(void);
 int box_set_election_timeout(void);
+void box_set_election_leader_lease(void);
 void box_set_replication_timeout(void);
 void box_set_replication_connect_timeout(void);
 void box_set_replication_connect_quorum(void);
@@ -274,6 +293,8 @@ void box_update_replication_synchro_quorum(void);
 int box_set_replication_synchro_quorum(void);
 int box_set_replication_synchro_timeout(void);
 void box_set_replication_sync_timeout(void);
+int box_set_replication_compression_level(void);
+int box_set_replication_compression_batch_size(void);
 void box_set_replication_skip_conflict(void);
 void box_set_replication_anon(void);
 void box_set_net_msg_max(void);
@@ -297,15 +318,50 @@ box_promote(void);
 int
 box_demote(void);
 
+/**
+ * Wait until it's safe to serve linearizable reads on this instance: it is
+ * the leader holding a valid lease and owning the synchro queue. Without
+ * box.cfg.election_leader_lease only waits for the synchro queue to become
+ * empty.
+ */
+int
+box_read_barrier(double timeout);
+
 int
 box_promote_qsync(void);
 
-/* box_select is private and used only by FFI */
+/**
+ * Select tuples from an index to a port_c.
+ *
+ * If @a packed_pos points to a position returned by a previous
+ * call, the iteration starts right after the position, otherwise
+ * it must point to NULL or be NULL itself. If @a update_pos is set,
+ * the position of the last selected tuple is stored to
+ * @a packed_pos on the fiber region. If no tuples are selected, the
+ * position is left unchanged.
+ *
+ * box_select is private and used only by FFI.
+ */
 API_EXPORT int
 box_select(uint32_t space_id, uint32_t index_id,
 	   int iterator, uint32_t offset, uint32_t limit,
 	   const char *key, const char *key_end,
-	   struct port *port);
+	   const char **packed_pos, const char **packed_pos_end,
+	   bool update_pos, struct port *port);
+
+struct snapshot_iterator;
+
+/**
+ * Open a read view for a select request if the space allows
+ * executing selects outside tx (see space_opts::read_view_enabled).
+ * On success sets @a result to an iterator over the read view that
+ * returns the tuples matching the key, or to NULL if the request
+ * must be executed by box_select().
+ */
+int
+box_select_read_view(uint32_t space_id, uint32_t index_id, int iterator,
+		     const char *key, const char *key_end,
+		     struct snapshot_iterator **result);
 
 /** \cond public */
 
@@ -548,6 +604,16 @@ box_session_push(const char *data, const char *data_end);
 int
 box_process1(struct request *request, box_tuple_t **result);
 
+/**
+ * Execute INSERT or REPLACE (@a type) requests for all tuples of
+ * the MsgPack array [@a tuples, @a tuples_end) in one transaction.
+ * The space lookup and the access check are done once per batch.
+ * If a tuple fails, none of the tuples are written.
+ */
+int
+box_process_many(uint32_t space_id, uint16_t type, const char *tuples,
+		 const char *tuples_end);
+
 /**
  * Execute request on given space.
  *
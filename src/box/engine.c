@@ -181,11 +181,15 @@ engine_collect_garbage(const struct vclock *vclock)
 }
 
 int
-engine_backup(const struct vclock *vclock, engine_backup_cb cb, void *cb_arg)
+engine_backup(const struct vclock *vclock,
+	      const struct engine_backup_point *since,
+	      struct engine_backup_point *point,
+	      engine_backup_cb cb, void *cb_arg)
 {
 	struct engine *engine;
 	engine_foreach(engine) {
-		if (engine->vtab->backup(engine, vclock, cb, cb_arg) < 0)
+		if (engine->vtab->backup(engine, vclock, since, point,
+					 cb, cb_arg) < 0)
 			return -1;
 	}
 	return 0;
@@ -414,10 +418,14 @@ generic_engine_collect_garbage(struct engine *engine,
 
 int
 generic_engine_backup(struct engine *engine, const struct vclock *vclock,
+		      const struct engine_backup_point *since,
+		      struct engine_backup_point *point,
 		      engine_backup_cb cb, void *cb_arg)
 {
 	(void)engine;
 	(void)vclock;
+	(void)since;
+	(void)point;
 	(void)cb;
 	(void)cb_arg;
 	return 0;
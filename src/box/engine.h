@@ -67,6 +67,22 @@ struct engine_memory_stat {
 typedef int
 engine_backup_cb(const char *path, void *arg);
 
+/**
+ * State of a backed up checkpoint. A backup started with the state
+ * of an earlier backup is incremental: it lists only files that
+ * were created after the earlier checkpoint. Files that are
+ * rewritten on each checkpoint (snapshot, vylog) are always listed.
+ */
+struct engine_backup_point {
+	/** Signature of the checkpoint. */
+	int64_t signature;
+	/**
+	 * Vinyl run files with greater ids are not included in
+	 * the backup, see vy_log_next_id().
+	 */
+	int64_t vy_max_id;
+};
+
 struct engine_vtab {
 	/** Destroy an engine instance. */
 	void (*shutdown)(struct engine *);
@@ -194,8 +210,15 @@ struct engine_vtab {
 	 * Backup callback. It is supposed to call @cb for each file
 	 * that needs to be backed up in order to restore from the
 	 * checkpoint @vclock.
+	 *
+	 * If @since is not NULL, files that were listed by the backup
+	 * @since was returned for may be skipped. The engine state
+	 * needed to make the next incremental backup is stored in
+	 * @point.
 	 */
 	int (*backup)(struct engine *engine, const struct vclock *vclock,
+		      const struct engine_backup_point *since,
+		      struct engine_backup_point *point,
 		      engine_backup_cb cb, void *cb_arg);
 	/**
 	 * Accumulate engine memory statistics.
@@ -379,7 +402,10 @@ void
 engine_collect_garbage(const struct vclock *vclock);
 
 int
-engine_backup(const struct vclock *vclock, engine_backup_cb cb, void *cb_arg);
+engine_backup(const struct vclock *vclock,
+	      const struct engine_backup_point *since,
+	      struct engine_backup_point *point,
+	      engine_backup_cb cb, void *cb_arg);
 
 void
 engine_memory_stat(struct engine_memory_stat *stat);
@@ -413,6 +439,8 @@ void generic_engine_commit_checkpoint(struct engine *, const struct vclock *);
 void generic_engine_abort_checkpoint(struct engine *);
 void generic_engine_collect_garbage(struct engine *, const struct vclock *);
 int generic_engine_backup(struct engine *, const struct vclock *,
+			  const struct engine_backup_point *,
+			  struct engine_backup_point *,
 			  engine_backup_cb, void *);
 void generic_engine_memory_stat(struct engine *, struct engine_memory_stat *);
 void generic_engine_reset_stat(struct engine *);
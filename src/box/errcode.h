@@ -286,6 +286,8 @@ struct errcode_record {
 	/*228 */_(ER_TRANSACTION_TIMEOUT,       "Transaction has been aborted by timeout") \
 	/*229 */_(ER_ACTIVE_TIMER,              "Operation is not permitted if timer is already running") \
 	/*230 */_(ER_TUPLE_FIELD_COUNT_LIMIT,	"Tuple field count limit reached: see box.schema.FIELD_MAX") \
+	/*234 */_(ER_ITERATOR_POSITION,		"Iterator position is invalid") \
+	/*235 */_(ER_REQUEST_EXPIRED,		"Request has waited for %.3f sec, longer than its timeout %.3f sec, and was not processed") \
 
 /*
  * !IMPORTANT! Please follow instructions at start of the file
@@ -554,6 +554,9 @@ sql_execute(struct sql_stmt *stmt, struct port *port, struct region *region)
 	int rc, column_count = sql_column_count(stmt);
 	rmean_collect(rmean_box, IPROTO_EXECUTE, 1);
 	if (column_count > 0) {
+		rc = sql_stmt_point_lookup(stmt, region, port);
+		if (rc <= 0)
+			return rc;
 		/* Either ROW or DONE or ERROR. */
 		while ((rc = sql_step(stmt)) == SQL_ROW) {
 			if (sql_row_to_port(stmt, region, port) != 0)
@@ -570,6 +573,36 @@ sql_execute(struct sql_stmt *stmt, struct port *port, struct region *region)
 	return 0;
 }
 
+/**
+ * Bind parameters to a statement from the prepared statement
+ * cache and execute it. The statement is reset afterwards and
+ * stays in the cache.
+ */
+static int
+sql_execute_cached(struct sql_stmt *stmt, const struct sql_bind *bind,
+		   uint32_t bind_count, struct port *port,
+		   struct region *region)
+{
+	assert(!sql_stmt_busy(stmt));
+	/*
+	 * Clear all set from previous execution cycle
+	 * values to be bound.
+	 */
+	sql_unbind(stmt);
+	if (sql_bind(stmt, bind, bind_count) != 0)
+		return -1;
+	enum sql_serialization_format format = sql_column_count(stmt) > 0 ?
+					       DQL_EXECUTE : DML_EXECUTE;
+	port_sql_create(port, stmt, format, false);
+	if (sql_execute(stmt, port, region) != 0) {
+		port_destroy(port);
+		sql_stmt_reset(stmt);
+		return -1;
+	}
+	sql_stmt_reset(stmt);
+	return 0;
+}
+
 int
 sql_execute_prepared(uint32_t stmt_id, const struct sql_bind *bind,
 		     uint32_t bind_count, struct port *port,
@@ -591,24 +624,27 @@ sql_execute_prepared(uint32_t stmt_id, const struct sql_bind *bind,
 		return sql_prepare_and_execute(sql_str, strlen(sql_str), bind,
 					       bind_count, port, region);
 	}
-	/*
-	 * Clear all set from previous execution cycle
-	 * values to be bound.
-	 */
-	sql_unbind(stmt);
-	if (sql_bind(stmt, bind, bind_count) != 0)
-		return -1;
-	enum sql_serialization_format format = sql_column_count(stmt) > 0 ?
-					       DQL_EXECUTE : DML_EXECUTE;
-	port_sql_create(port, stmt, format, false);
-	if (sql_execute(stmt, port, region) != 0) {
-		port_destroy(port);
-		sql_stmt_reset(stmt);
-		return -1;
-	}
-	sql_stmt_reset(stmt);
+	return sql_execute_cached(stmt, bind, bind_count, port, region);
+}
 
-	return 0;
+/**
+ * Look up a statement compiled from exactly the given SQL string
+ * in the prepared statement cache. Return NULL if there is none,
+ * or it has expired, or it is being executed right now.
+ */
+static struct sql_stmt *
+sql_stmt_cache_find_by_str(const char *sql, int len)
+{
+	struct sql_stmt *stmt =
+		sql_stmt_cache_find(sql_stmt_calculate_id(sql, len));
+	if (stmt == NULL || sql_stmt_busy(stmt) ||
+	    !sql_stmt_schema_version_is_valid(stmt))
+		return NULL;
+	/* Statement IDs are hashes and may collide. */
+	const char *sql_str = sql_stmt_query_str(stmt);
+	if (strlen(sql_str) != (size_t)len || memcmp(sql_str, sql, len) != 0)
+		return NULL;
+	return stmt;
 }
 
 int
@@ -616,7 +652,13 @@ sql_prepare_and_execute(const char *sql, int len, const struct sql_bind *bind,
 			uint32_t bind_count, struct port *port,
 			struct region *region)
 {
-	struct sql_stmt *stmt;
+	/*
+	 * If the same query has been prepared by any session,
+	 * reuse its VDBE program instead of compiling it again.
+	 */
+	struct sql_stmt *stmt = sql_stmt_cache_find_by_str(sql, len);
+	if (stmt != NULL)
+		return sql_execute_cached(stmt, bind, bind_count, port, region);
 	if (sql_stmt_compile(sql, len, NULL, &stmt, NULL) != 0)
 		return -1;
 	assert(stmt != NULL);
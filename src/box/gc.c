@@ -41,8 +41,6 @@
 #include <stdio.h>
 #include <time.h>
 
-#define RB_COMPACT 1
-#include <small/rb.h>
 #include <small/rlist.h>
 #include <tarantool_ev.h>
 
@@ -58,6 +56,12 @@
 #include "checkpoint_schedule.h"
 #include "txn_limbo.h"
 
+#define HEAP_NAME gc_heap
+#define HEAP_LESS(h, a, b) ((a)->lsn < (b)->lsn)
+#define heap_value_t struct gc_consumer_lsn
+#define heap_value_attr in_heap
+#include "salad/heap.h"
+
 struct gc_state gc;
 
 static int
@@ -65,25 +69,45 @@ gc_cleanup_fiber_f(va_list);
 static int
 gc_checkpoint_fiber_f(va_list);
 
+/** Return the consumer of a vclock component. */
+static inline struct gc_consumer *
+gc_consumer_by_lsn(struct gc_consumer_lsn *lsn, uint32_t replica_id)
+{
+	return container_of(lsn - replica_id, struct gc_consumer, lsn[0]);
+}
+
 /**
- * Comparator used for ordering gc_consumer objects
- * lexicographically by their vclock in a binary tree.
+ * Add a consumer to the list of active consumers and its vclock
+ * components to the consumer heaps. Return -1 and set diag on
+ * memory error.
  */
-static inline int
-gc_consumer_cmp(const struct gc_consumer *a, const struct gc_consumer *b)
+static int
+gc_consumer_link(struct gc_consumer *consumer)
 {
-	int rc = vclock_lex_compare(&a->vclock, &b->vclock);
-	if (rc != 0)
-		return rc;
-	if ((intptr_t)a < (intptr_t)b)
-		return -1;
-	if ((intptr_t)a > (intptr_t)b)
-		return 1;
+	for (uint32_t i = 1; i < VCLOCK_MAX; i++) {
+		struct gc_consumer_lsn *lsn = &consumer->lsn[i];
+		lsn->lsn = vclock_get(&consumer->vclock, i);
+		if (gc_heap_insert(&gc.consumer_heaps[i], lsn) != 0) {
+			while (--i > 0) {
+				gc_heap_delete(&gc.consumer_heaps[i],
+					       &consumer->lsn[i]);
+			}
+			diag_set(OutOfMemory, 0, "realloc", "gc consumer heap");
+			return -1;
+		}
+	}
+	rlist_add_tail_entry(&gc.consumers, consumer, in_consumers);
 	return 0;
 }
 
-rb_gen(MAYBE_UNUSED static inline, gc_tree_, gc_tree_t,
-       struct gc_consumer, node, gc_consumer_cmp);
+/** Remove a consumer linked by gc_consumer_link(). */
+static void
+gc_consumer_unlink(struct gc_consumer *consumer)
+{
+	for (uint32_t i = 1; i < VCLOCK_MAX; i++)
+		gc_heap_delete(&gc.consumer_heaps[i], &consumer->lsn[i]);
+	rlist_del_entry(consumer, in_consumers);
+}
 
 /** Free a consumer object. */
 static void
@@ -114,7 +138,9 @@ gc_init(void)
 
 	vclock_create(&gc.vclock);
 	rlist_create(&gc.checkpoints);
-	gc_tree_new(&gc.consumers);
+	rlist_create(&gc.consumers);
+	for (int i = 0; i < VCLOCK_MAX; i++)
+		gc_heap_create(&gc.consumer_heaps[i]);
 	fiber_cond_create(&gc.cleanup_cond);
 	checkpoint_schedule_cfg(&gc.checkpoint_schedule, 0, 0);
 
@@ -146,14 +172,13 @@ gc_free(void)
 		gc_checkpoint_delete(checkpoint);
 	}
 	/* Free all registered consumers. */
-	struct gc_consumer *consumer = gc_tree_first(&gc.consumers);
-	while (consumer != NULL) {
-		struct gc_consumer *next = gc_tree_next(&gc.consumers,
-							consumer);
-		gc_tree_remove(&gc.consumers, consumer);
+	struct gc_consumer *consumer, *next_consumer;
+	rlist_foreach_entry_safe(consumer, &gc.consumers, in_consumers,
+				 next_consumer) {
 		gc_consumer_delete(consumer);
-		consumer = next;
 	}
+	for (int i = 0; i < VCLOCK_MAX; i++)
+		gc_heap_destroy(&gc.consumer_heaps[i]);
 }
 
 /**
@@ -192,7 +217,6 @@ gc_run_cleanup(void)
 
 	/* Find the vclock of the oldest WAL row to keep. */
 	struct vclock min_vclock;
-	struct gc_consumer *consumer = gc_tree_first(&gc.consumers);
 	/*
 	 * Vclock of the oldest WAL row to keep is a by-component
 	 * minimum of all consumer vclocks and the oldest
@@ -200,15 +224,16 @@ gc_run_cleanup(void)
 	 * at least one consumer are kept.
 	 * Note, we must keep all WALs created after the
 	 * oldest checkpoint, even if no consumer needs them.
+	 * Consumers will never need rows signed with a zero
+	 * instance id (local rows), so the 0th component is
+	 * skipped.
 	 */
 	vclock_copy(&min_vclock, &checkpoint->vclock);
-	while (consumer != NULL) {
-		/*
-		 * Consumers will never need rows signed
-		 * with a zero instance id (local rows).
-		 */
-		vclock_min_ignore0(&min_vclock, &consumer->vclock);
-		consumer = gc_tree_next(&gc.consumers, consumer);
+	for (uint32_t i = 1; i < VCLOCK_MAX; i++) {
+		struct gc_consumer_lsn *lsn =
+			gc_heap_top(&gc.consumer_heaps[i]);
+		if (lsn != NULL && lsn->lsn < vclock_get(&min_vclock, i))
+			vclock_reset(&min_vclock, i, lsn->lsn);
 	}
 
 	if (vclock_sum(&min_vclock) > vclock_sum(&gc.vclock)) {
@@ -379,27 +404,26 @@ gc_advance(const struct vclock *vclock)
 	 */
 	vclock_copy(&gc.vclock, vclock);
 
-	struct gc_consumer *consumer = gc_tree_first(&gc.consumers);
-	while (consumer != NULL) {
-		struct gc_consumer *next = gc_tree_next(&gc.consumers,
-							consumer);
-		/*
-		 * Remove all the consumers whose vclocks are
-		 * either less than or incomparable with the wal
-		 * gc vclock.
-		 */
-		if (vclock_compare_ignore0(vclock, &consumer->vclock) <= 0) {
-			consumer = next;
-			continue;
+	/*
+	 * Remove all the consumers whose vclocks are either less
+	 * than or incomparable with the wal gc vclock, that is
+	 * have a component less than the one of the wal gc vclock.
+	 */
+	for (uint32_t i = 1; i < VCLOCK_MAX; i++) {
+		int64_t lsn = vclock_get(vclock, i);
+		struct gc_consumer_lsn *top;
+		while ((top = gc_heap_top(&gc.consumer_heaps[i])) != NULL &&
+		       top->lsn < lsn) {
+			struct gc_consumer *consumer =
+				gc_consumer_by_lsn(top, i);
+			assert(!consumer->is_inactive);
+			consumer->is_inactive = true;
+			gc_consumer_unlink(consumer);
+
+			say_crit("deactivated WAL consumer %s at %s",
+				 consumer->name,
+				 vclock_to_string(&consumer->vclock));
 		}
-		assert(!consumer->is_inactive);
-		consumer->is_inactive = true;
-		gc_tree_remove(&gc.consumers, consumer);
-
-		say_crit("deactivated WAL consumer %s at %s", consumer->name,
-			 vclock_to_string(&consumer->vclock));
-
-		consumer = next;
 	}
 	gc_schedule_cleanup();
 }
@@ -652,7 +676,10 @@ gc_consumer_register(const struct vclock *vclock, const char *format, ...)
 	va_end(ap);
 
 	vclock_copy(&consumer->vclock, vclock);
-	gc_tree_insert(&gc.consumers, consumer);
+	if (gc_consumer_link(consumer) != 0) {
+		gc_consumer_delete(consumer);
+		return NULL;
+	}
 	return consumer;
 }
 
@@ -660,7 +687,7 @@ void
 gc_consumer_unregister(struct gc_consumer *consumer)
 {
 	if (!consumer->is_inactive) {
-		gc_tree_remove(&gc.consumers, consumer);
+		gc_consumer_unlink(consumer);
 		gc_schedule_cleanup();
 	}
 	gc_consumer_delete(consumer);
@@ -680,20 +707,24 @@ gc_consumer_advance(struct gc_consumer *consumer, const struct vclock *vclock)
 		return; /* nothing to do */
 
 	/*
-	 * Do not update the tree unless the tree invariant
-	 * is violated.
+	 * Only the components that have changed need to be moved
+	 * in their heaps. Components missing in both vclocks are
+	 * zero and so can't have changed.
 	 */
-	struct gc_consumer *next = gc_tree_next(&gc.consumers, consumer);
-	bool update_tree = (next != NULL &&
-			    vclock_lex_compare(vclock, &next->vclock) >= 0);
-
-	if (update_tree)
-		gc_tree_remove(&gc.consumers, consumer);
-
+	vclock_map_t map = consumer->vclock.map | vclock->map;
 	vclock_copy(&consumer->vclock, vclock);
 
-	if (update_tree)
-		gc_tree_insert(&gc.consumers, consumer);
+	struct bit_iterator it;
+	bit_iterator_init(&it, &map, sizeof(map), true);
+	for (size_t i = bit_iterator_next(&it); i < VCLOCK_MAX;
+	     i = bit_iterator_next(&it)) {
+		struct gc_consumer_lsn *lsn = &consumer->lsn[i];
+		int64_t new_lsn = vclock_get(vclock, i);
+		if (i == 0 || lsn->lsn == new_lsn)
+			continue;
+		lsn->lsn = new_lsn;
+		gc_heap_update(&gc.consumer_heaps[i], lsn);
+	}
 
 	gc_schedule_cleanup();
 }
@@ -701,9 +732,10 @@ gc_consumer_advance(struct gc_consumer *consumer, const struct vclock *vclock)
 struct gc_consumer *
 gc_consumer_iterator_next(struct gc_consumer_iterator *it)
 {
-	if (it->curr != NULL)
-		it->curr = gc_tree_next(&gc.consumers, it->curr);
-	else
-		it->curr = gc_tree_first(&gc.consumers);
+	struct rlist *next = it->curr != NULL ?
+			     rlist_next(&it->curr->in_consumers) :
+			     rlist_first(&gc.consumers);
+	it->curr = next != &gc.consumers ?
+		   rlist_entry(next, struct gc_consumer, in_consumers) : NULL;
 	return it->curr;
 }
@@ -40,17 +40,17 @@
 #include "trivia/util.h"
 #include "checkpoint_schedule.h"
 
+#define HEAP_FORWARD_DECLARATION
+#include "salad/heap.h"
+
 #if defined(__cplusplus)
 extern "C" {
 #endif /* defined(__cplusplus) */
 
 struct fiber;
-struct gc_consumer;
 
 enum { GC_NAME_MAX = 64 };
 
-typedef rb_node(struct gc_consumer) gc_node_t;
-
 /**
  * Garbage collector keeps track of all preserved checkpoints.
  * The following structure represents a checkpoint.
@@ -81,17 +81,30 @@ struct gc_checkpoint_ref {
 	char name[GC_NAME_MAX];
 };
 
+/** A component of the vclock tracked by a consumer. */
+struct gc_consumer_lsn {
+	/** Link in gc_state::consumer_heaps. */
+	struct heap_node in_heap;
+	/** LSN of the component. */
+	int64_t lsn;
+};
+
 /**
  * The object of this type is used to prevent garbage
  * collection from removing WALs that are still in use.
  */
 struct gc_consumer {
 	/** Link in gc_state::consumers. */
-	gc_node_t node;
+	struct rlist in_consumers;
 	/** Human-readable name. */
 	char name[GC_NAME_MAX];
 	/** The vclock tracked by this consumer. */
 	struct vclock vclock;
+	/**
+	 * Components of the vclock, indexed by replica id. The 0th
+	 * one isn't used, because consumers never need local rows.
+	 */
+	struct gc_consumer_lsn lsn[VCLOCK_MAX];
 	/**
 	 * This flag is set if a WAL needed by this consumer was
 	 * deleted by the WAL thread on ENOSPC.
@@ -99,8 +112,6 @@ struct gc_consumer {
 	bool is_inactive;
 };
 
-typedef rb_tree(struct gc_consumer) gc_tree_t;
-
 /** Garbage collection state. */
 struct gc_state {
 	/** VClock of the oldest WAL row available on the instance. */
@@ -121,8 +132,16 @@ struct gc_state {
 	 * to the tail. Linked by gc_checkpoint::in_checkpoints.
 	 */
 	struct rlist checkpoints;
-	/** Registered consumers, linked by gc_consumer::node. */
-	gc_tree_t consumers;
+	/** Active consumers, linked by gc_consumer::in_consumers. */
+	struct rlist consumers;
+	/**
+	 * Min-heaps of the vclock components of active consumers,
+	 * one per replica id, linked by gc_consumer::lsn. The heap
+	 * tops make up the minimal vclock of all consumers, which is
+	 * updated in O(log n) per changed component when a consumer
+	 * advances.
+	 */
+	heap_t consumer_heaps[VCLOCK_MAX];
 	/** Fiber responsible for periodic checkpointing. */
 	struct fiber *checkpoint_fiber;
 	/** Schedule of periodic checkpoints. */
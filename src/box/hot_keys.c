@@ -0,0 +1,222 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "hot_keys.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "diag.h"
+#include "fiber.h"
+#include "key_def.h"
+#include "msgpuck.h"
+#include "small/region.h"
+#include "trivia/util.h"
+#include "tuple.h"
+
+struct hot_keys *
+hot_keys_new(uint32_t sample_rate)
+{
+	assert(sample_rate > 0 && sample_rate <= HOT_KEYS_SAMPLE_RATE_MAX);
+	struct hot_keys *hot_keys = calloc(1, sizeof(*hot_keys));
+	if (hot_keys == NULL) {
+		diag_set(OutOfMemory, sizeof(*hot_keys), "calloc",
+			 "struct hot_keys");
+		return NULL;
+	}
+	hot_keys->sample_rate = sample_rate;
+	hot_keys->random = (uint32_t)rand() | 1;
+	hot_keys_reset_countdown(hot_keys);
+	return hot_keys;
+}
+
+void
+hot_keys_delete(struct hot_keys *hot_keys)
+{
+	for (uint32_t i = 0; i < hot_keys->top_size; i++)
+		free(hot_keys->top[i].key);
+	free(hot_keys);
+}
+
+void
+hot_keys_reset_countdown(struct hot_keys *hot_keys)
+{
+	/*
+	 * A random countdown in [1, 2 * sample_rate - 1] is sample_rate
+	 * on average and, unlike a fixed one, doesn't miss keys that
+	 * are accessed in a periodic pattern.
+	 */
+	uint32_t x = hot_keys->random;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	hot_keys->random = x;
+	hot_keys->countdown = 1 + x % (2 * hot_keys->sample_rate - 1);
+}
+
+/**
+ * Increment the counters of a hash in the sketch and return the
+ * estimated count, which is the minimum of the counters.
+ */
+static uint32_t
+hot_keys_sketch_add(struct hot_keys *hot_keys, uint32_t hash)
+{
+	/*
+	 * Row positions are taken as hash + i * step, which is as good
+	 * as independent hash functions for a count-min sketch.
+	 */
+	uint32_t step = hash * 0x9e3779b1u;
+	step ^= step >> 16;
+	step |= 1;
+	uint32_t count = UINT32_MAX;
+	for (int i = 0; i < HOT_KEYS_SKETCH_DEPTH; i++) {
+		uint32_t pos = hash + i * step;
+		uint32_t *counter =
+			&hot_keys->sketch[i][pos & (HOT_KEYS_SKETCH_WIDTH - 1)];
+		if (*counter < UINT32_MAX)
+			++*counter;
+		count = MIN(count, *counter);
+	}
+	return count;
+}
+
+/**
+ * Update the estimate of a hash in the top. Returns the entry that
+ * the key should be stored to, or NULL if the key is either in the
+ * top already or not accessed often enough to get there.
+ */
+static struct hot_key *
+hot_keys_top_update(struct hot_keys *hot_keys, uint32_t hash, uint32_t count)
+{
+	struct hot_key *min = NULL;
+	for (uint32_t i = 0; i < hot_keys->top_size; i++) {
+		struct hot_key *entry = &hot_keys->top[i];
+		if (entry->hash == hash) {
+			entry->count = count;
+			return NULL;
+		}
+		if (min == NULL || entry->count < min->count)
+			min = entry;
+	}
+	if (hot_keys->top_size < HOT_KEYS_TOP_MAX)
+		return &hot_keys->top[hot_keys->top_size];
+	assert(min != NULL);
+	return min->count < count ? min : NULL;
+}
+
+/**
+ * Store a key to an entry returned by hot_keys_top_update(). The key
+ * is given with the MsgPack array header. The key is not stored on
+ * memory error, which only makes the statistics less accurate.
+ */
+static void
+hot_keys_top_set(struct hot_keys *hot_keys, struct hot_key *entry,
+		 uint32_t hash, uint32_t count,
+		 const char *key, uint32_t key_size)
+{
+	char *copy = malloc(key_size);
+	if (copy == NULL)
+		return;
+	memcpy(copy, key, key_size);
+	if (entry == &hot_keys->top[hot_keys->top_size])
+		hot_keys->top_size++;
+	else
+		free(entry->key);
+	entry->hash = hash;
+	entry->count = count;
+	entry->key = copy;
+	entry->key_size = key_size;
+}
+
+void
+hot_keys_add_key(struct hot_keys *hot_keys, struct key_def *key_def,
+		 const char *key)
+{
+	uint32_t hash = key_hash(key, key_def);
+	uint32_t count = hot_keys_sketch_add(hot_keys, hash);
+	struct hot_key *entry = hot_keys_top_update(hot_keys, hash, count);
+	if (entry == NULL)
+		return;
+	const char *key_end = key;
+	for (uint32_t i = 0; i < key_def->part_count; i++)
+		mp_next(&key_end);
+	uint32_t part_count_size = mp_sizeof_array(key_def->part_count);
+	uint32_t key_size = part_count_size + (key_end - key);
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	char *buf = region_alloc(region, key_size);
+	if (buf != NULL) {
+		char *pos = mp_encode_array(buf, key_def->part_count);
+		memcpy(pos, key, key_end - key);
+		hot_keys_top_set(hot_keys, entry, hash, count, buf, key_size);
+	}
+	region_truncate(region, region_svp);
+}
+
+/**
+ * Account an access to a key given with the MsgPack array header,
+ * as returned by tuple_extract_key().
+ */
+static void
+hot_keys_add_extracted_key(struct hot_keys *hot_keys,
+			   struct key_def *key_def,
+			   const char *key, uint32_t key_size)
+{
+	const char *parts = key;
+	mp_decode_array(&parts);
+	uint32_t hash = key_hash(parts, key_def);
+	uint32_t count = hot_keys_sketch_add(hot_keys, hash);
+	struct hot_key *entry = hot_keys_top_update(hot_keys, hash, count);
+	if (entry != NULL)
+		hot_keys_top_set(hot_keys, entry, hash, count, key, key_size);
+}
+
+void
+hot_keys_add_tuple(struct hot_keys *hot_keys, struct key_def *key_def,
+		   struct tuple *tuple)
+{
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	uint32_t key_size;
+	const char *key = tuple_extract_key(tuple, key_def, MULTIKEY_NONE,
+					    &key_size);
+	if (key != NULL)
+		hot_keys_add_extracted_key(hot_keys, key_def, key, key_size);
+	region_truncate(region, region_svp);
+}
+
+void
+hot_keys_add_raw(struct hot_keys *hot_keys, struct key_def *key_def,
+		 const char *data, const char *data_end)
+{
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	uint32_t key_size;
+	const char *key = tuple_extract_key_raw(data, data_end, key_def,
+						MULTIKEY_NONE, &key_size);
+	if (key != NULL)
+		hot_keys_add_extracted_key(hot_keys, key_def, key, key_size);
+	region_truncate(region, region_svp);
+}
+
+static int
+hot_key_cmp(const void *a, const void *b)
+{
+	const struct hot_key *left = a;
+	const struct hot_key *right = b;
+	if (left->count != right->count)
+		return left->count > right->count ? -1 : 1;
+	return 0;
+}
+
+struct hot_key *
+hot_keys_top(struct hot_keys *hot_keys, uint32_t *count)
+{
+	qsort(hot_keys->top, hot_keys->top_size, sizeof(hot_keys->top[0]),
+	      hot_key_cmp);
+	*count = hot_keys->top_size;
+	return hot_keys->top;
+}
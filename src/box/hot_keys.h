@@ -0,0 +1,127 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2026, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "trivia/util.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+struct key_def;
+struct tuple;
+
+enum {
+	/** Number of rows of the count-min sketch. */
+	HOT_KEYS_SKETCH_DEPTH = 4,
+	/** Number of counters in a row, must be a power of two. */
+	HOT_KEYS_SKETCH_WIDTH = 1024,
+	/** Max number of keys reported by hot_keys_top(). */
+	HOT_KEYS_TOP_MAX = 32,
+	/** Max sample rate, see hot_keys_new(). */
+	HOT_KEYS_SAMPLE_RATE_MAX = 1 << 20,
+};
+
+/** A key with the estimated number of accesses to it. */
+struct hot_key {
+	/** Hash of the key, see key_hash(). */
+	uint32_t hash;
+	/** Estimated number of sampled accesses to the key. */
+	uint32_t count;
+	/** MsgPack array of the key parts, malloc'ed. */
+	char *key;
+	/** Size of the key. */
+	uint32_t key_size;
+};
+
+/**
+ * Tracker of the most frequently accessed keys of an index.
+ *
+ * One in sample_rate accesses on average is sampled. The number of
+ * sampled accesses to each key is estimated with a count-min sketch,
+ * which takes a fixed amount of memory regardless of the number of
+ * distinct keys and never underestimates. The HOT_KEYS_TOP_MAX keys
+ * with the highest estimates seen so far are kept along with copies
+ * of the keys so that they can be reported.
+ *
+ * Keys are identified by their hash, so keys with the same hash are
+ * counted as one key.
+ */
+struct hot_keys {
+	/** Average number of accesses per one sampled access. */
+	uint32_t sample_rate;
+	/** Number of accesses left until the next sampled one. */
+	uint32_t countdown;
+	/** State of the random generator of countdown values. */
+	uint32_t random;
+	/** Number of used entries in top. */
+	uint32_t top_size;
+	/** Keys with the highest estimates, in no particular order. */
+	struct hot_key top[HOT_KEYS_TOP_MAX];
+	/** Count-min sketch. */
+	uint32_t sketch[HOT_KEYS_SKETCH_DEPTH][HOT_KEYS_SKETCH_WIDTH];
+};
+
+/**
+ * Create a hot key tracker that samples one in sample_rate accesses
+ * on average. Returns NULL and sets diag on memory error.
+ */
+struct hot_keys *
+hot_keys_new(uint32_t sample_rate);
+
+/** Destroy a hot key tracker. */
+void
+hot_keys_delete(struct hot_keys *hot_keys);
+
+/** Choose the number of accesses until the next sampled one. */
+void
+hot_keys_reset_countdown(struct hot_keys *hot_keys);
+
+/**
+ * Return true if the current access should be accounted with
+ * hot_keys_add_key() or hot_keys_add_tuple().
+ */
+static inline bool
+hot_keys_sample(struct hot_keys *hot_keys)
+{
+	if (likely(--hot_keys->countdown > 0))
+		return false;
+	hot_keys_reset_countdown(hot_keys);
+	return true;
+}
+
+/**
+ * Account an access to a key. The key has all the parts of key_def
+ * and is given without the MsgPack array header.
+ */
+void
+hot_keys_add_key(struct hot_keys *hot_keys, struct key_def *key_def,
+		 const char *key);
+
+/** Account an access to the key of a tuple. */
+void
+hot_keys_add_tuple(struct hot_keys *hot_keys, struct key_def *key_def,
+		   struct tuple *tuple);
+
+/** Account an access to the key of a tuple given as MsgPack. */
+void
+hot_keys_add_raw(struct hot_keys *hot_keys, struct key_def *key_def,
+		 const char *data, const char *data_end);
+
+/**
+ * Sort the tracked keys by the estimated number of accesses, from
+ * the highest, and return them. The number of keys is returned in
+ * count. The array is valid until the next access is accounted.
+ */
+struct hot_key *
+hot_keys_top(struct hot_keys *hot_keys, uint32_t *count);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
@@ -39,6 +39,8 @@
 #include "rmean.h"
 #include "info/info.h"
 #include "memtx_tx.h"
+#include "port.h"
+#include "fiber.h"
 
 /* {{{ Utilities. **********************************************/
 
@@ -149,6 +151,88 @@ exact_key_validate(struct key_def *key_def, const char *key,
 	return key_validate_parts(key_def, key, part_count, false, &key_end);
 }
 
+/**
+ * Check that tuples of the index are ordered by cmp_def, so that
+ * the position of a tuple is its cmp_def key.
+ */
+static int
+index_check_position_support(struct index *index)
+{
+	struct index_def *def = index->def;
+	if (def->type != TREE || def->key_def->is_multikey ||
+	    def->key_def->for_func_index) {
+		diag_set(UnsupportedIndexFeature, def, "pagination");
+		return -1;
+	}
+	return 0;
+}
+
+int
+index_check_position(struct index *index, enum iterator_type type,
+		     const char *key, uint32_t part_count,
+		     const char *pos, const char *pos_end)
+{
+	if (index_check_position_support(index) != 0)
+		return -1;
+	if (pos == NULL)
+		return 0;
+	struct key_def *cmp_def = index->def->cmp_def;
+	const char *data = pos;
+	if (mp_typeof(*data) != MP_ARRAY || mp_check(&data, pos_end) != 0 ||
+	    data != pos_end)
+		goto invalid;
+	data = pos;
+	if (mp_decode_array(&data) != cmp_def->part_count ||
+	    key_validate_parts(cmp_def, data, cmp_def->part_count, true,
+			       &data) != 0)
+		goto invalid;
+	if (part_count > 0) {
+		/* The position must be within the iterator range. */
+		int cmp = key_compare(pos, HINT_NONE, key, HINT_NONE, cmp_def);
+		bool in_range;
+		switch (type) {
+		case ITER_EQ:
+		case ITER_REQ:
+			in_range = cmp == 0;
+			break;
+		case ITER_LT:
+			in_range = cmp < 0;
+			break;
+		case ITER_LE:
+			in_range = cmp <= 0;
+			break;
+		case ITER_GT:
+			in_range = cmp > 0;
+			break;
+		default:
+			in_range = cmp >= 0;
+			break;
+		}
+		if (!in_range)
+			goto invalid;
+	}
+	return 0;
+invalid:
+	diag_set(ClientError, ER_ITERATOR_POSITION);
+	return -1;
+}
+
+int
+index_tuple_position(struct index *index, struct tuple *tuple,
+		     const char **pos, const char **pos_end)
+{
+	if (index_check_position_support(index) != 0)
+		return -1;
+	uint32_t size;
+	char *key = tuple_extract_key(tuple, index->def->cmp_def,
+				      MULTIKEY_NONE, &size);
+	if (key == NULL)
+		return -1;
+	*pos = key;
+	*pos_end = key + size;
+	return 0;
+}
+
 char *
 box_tuple_extract_key(box_tuple_t *tuple, uint32_t space_id, uint32_t index_id,
 		      uint32_t *key_size)
@@ -163,6 +247,37 @@ box_tuple_extract_key(box_tuple_t *tuple, uint32_t space_id, uint32_t index_id,
 				 MULTIKEY_NONE, key_size);
 }
 
+int
+box_index_tuple_position(uint32_t space_id, uint32_t index_id,
+			 const char *tuple, const char *tuple_end,
+			 const char **packed_pos, const char **packed_pos_end)
+{
+	struct space *space = space_cache_find(space_id);
+	if (space == NULL)
+		return -1;
+	struct index *index = index_find(space, index_id);
+	if (index == NULL)
+		return -1;
+	if (index_check_position_support(index) != 0)
+		return -1;
+	if (mp_typeof(*tuple) != MP_ARRAY) {
+		diag_set(ClientError, ER_TUPLE_NOT_ARRAY);
+		return -1;
+	}
+	/* The key extraction expects all indexed fields present. */
+	if (tuple_validate_raw(space->format, tuple) != 0)
+		return -1;
+	uint32_t size;
+	char *key = tuple_extract_key_raw(tuple, tuple_end,
+					  index->def->cmp_def,
+					  MULTIKEY_NONE, &size);
+	if (key == NULL)
+		return -1;
+	*packed_pos = key;
+	*packed_pos_end = key + size;
+	return 0;
+}
+
 static inline int
 check_index(uint32_t space_id, uint32_t index_id,
 	    struct space **space, struct index **index)
@@ -255,6 +370,70 @@ box_index_get(uint32_t space_id, uint32_t index_id, const char *key,
 	return 0;
 }
 
+int
+box_index_get_many(uint32_t space_id, uint32_t index_id, const char *keys,
+		   const char *keys_end, struct port *port)
+{
+	assert(keys != NULL && keys_end != NULL && port != NULL);
+	(void)keys_end;
+	struct space *space;
+	struct index *index;
+	if (check_index(space_id, index_id, &space, &index) != 0)
+		return -1;
+	if (!index->def->opts.is_unique) {
+		diag_set(ClientError, ER_MORE_THAN_ONE_TUPLE);
+		return -1;
+	}
+	if (mp_typeof(*keys) != MP_ARRAY) {
+		diag_set(ClientError, ER_ILLEGAL_PARAMS,
+			 "keys must be an array");
+		return -1;
+	}
+	uint32_t count = mp_decode_array(&keys);
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	size_t size;
+	const char **key_ptrs = region_alloc_array(region, typeof(key_ptrs[0]),
+						   count, &size);
+	if (key_ptrs == NULL) {
+		diag_set(OutOfMemory, size, "region_alloc_array", "key_ptrs");
+		return -1;
+	}
+	for (uint32_t i = 0; i < count; i++) {
+		if (mp_typeof(*keys) != MP_ARRAY) {
+			diag_set(ClientError, ER_ILLEGAL_PARAMS,
+				 "key must be an array");
+			goto fail;
+		}
+		uint32_t part_count = mp_decode_array(&keys);
+		if (exact_key_validate(index->def->key_def, keys,
+				       part_count) != 0)
+			goto fail;
+		key_ptrs[i] = keys;
+		for (uint32_t j = 0; j < part_count; j++)
+			mp_next(&keys);
+	}
+	/* Start transaction in the engine. */
+	struct txn *txn;
+	struct txn_ro_savepoint svp;
+	if (txn_begin_ro_stmt(space, &txn, &svp) != 0)
+		goto fail;
+	port_c_create(port);
+	if (index_get_many(index, key_ptrs, count, port) != 0) {
+		port_destroy(port);
+		txn_rollback_stmt(txn);
+		goto fail;
+	}
+	txn_commit_ro_stmt(txn, &svp);
+	region_truncate(region, region_svp);
+	/* Count statistics. */
+	rmean_collect(rmean_box, IPROTO_SELECT, 1);
+	return 0;
+fail:
+	region_truncate(region, region_svp);
+	return -1;
+}
+
 int
 box_index_min(uint32_t space_id, uint32_t index_id, const char *key,
 	      const char *key_end, box_tuple_t **result)
@@ -404,6 +583,25 @@ box_iterator_next(box_iterator_t *itr, box_tuple_t **result)
 	return 0;
 }
 
+ssize_t
+box_iterator_next_batch(box_iterator_t *itr, box_tuple_t **result,
+			uint32_t count)
+{
+	assert(result != NULL);
+	uint32_t i;
+	for (i = 0; i < count; i++) {
+		if (iterator_next(itr, &result[i]) != 0) {
+			while (i-- > 0)
+				tuple_unref(result[i]);
+			return -1;
+		}
+		if (result[i] == NULL)
+			break;
+		tuple_ref(result[i]);
+	}
+	return i;
+}
+
 void
 box_iterator_free(box_iterator_t *it)
 {
@@ -437,6 +635,65 @@ box_index_compact(uint32_t space_id, uint32_t index_id)
 	return 0;
 }
 
+int
+box_index_hot_keys_enable(uint32_t space_id, uint32_t index_id,
+			  uint32_t sample_rate)
+{
+	struct space *space;
+	struct index *index;
+	if (check_index(space_id, index_id, &space, &index) != 0)
+		return -1;
+	if (sample_rate == 0 || sample_rate > HOT_KEYS_SAMPLE_RATE_MAX) {
+		diag_set(ClientError, ER_ILLEGAL_PARAMS,
+			 "sample_rate must be in range [1, 1048576]");
+		return -1;
+	}
+	struct index_def *def = index->def;
+	if ((def->type != TREE && def->type != HASH) ||
+	    def->key_def->is_multikey || def->key_def->for_func_index) {
+		diag_set(UnsupportedIndexFeature, def, "hot key tracking");
+		return -1;
+	}
+	struct hot_keys *hot_keys = hot_keys_new(sample_rate);
+	if (hot_keys == NULL)
+		return -1;
+	if (index->hot_keys != NULL)
+		hot_keys_delete(index->hot_keys);
+	index->hot_keys = hot_keys;
+	return 0;
+}
+
+int
+box_index_hot_keys_disable(uint32_t space_id, uint32_t index_id)
+{
+	struct space *space;
+	struct index *index;
+	if (check_index(space_id, index_id, &space, &index) != 0)
+		return -1;
+	if (index->hot_keys != NULL) {
+		hot_keys_delete(index->hot_keys);
+		index->hot_keys = NULL;
+	}
+	return 0;
+}
+
+int
+box_index_hot_keys(uint32_t space_id, uint32_t index_id,
+		   struct hot_keys **hot_keys)
+{
+	struct space *space;
+	struct index *index;
+	if (check_index(space_id, index_id, &space, &index) != 0)
+		return -1;
+	if (index->hot_keys == NULL) {
+		diag_set(ClientError, ER_ILLEGAL_PARAMS,
+			 "hot key tracking is disabled");
+		return -1;
+	}
+	*hot_keys = index->hot_keys;
+	return 0;
+}
+
 /* }}} */
 
 /* {{{ Internal API */
@@ -469,6 +726,7 @@ iterator_next(struct iterator *it, struct tuple **ret)
 			goto invalidate;
 		it->space_cache_version = space_cache_version;
 	}
+	it->index->op_stat.next++;
 	return it->next(it, ret);
 
 invalidate:
@@ -502,6 +760,8 @@ index_create(struct index *index, struct engine *engine,
 	index->dense_id = UINT32_MAX;
 	rlist_create(&index->nearby_gaps);
 	rlist_create(&index->full_scans);
+	memset(&index->op_stat, 0, sizeof(index->op_stat));
+	index->hot_keys = NULL;
 	return 0;
 }
 
@@ -515,13 +775,15 @@ index_delete(struct index *index)
 	 * the index is primary or secondary.
 	 */
 	struct index_def *def = index->def;
+	if (index->hot_keys != NULL)
+		hot_keys_delete(index->hot_keys);
 	memtx_tx_on_index_delete(index);
 	index->vtab->destroy(index);
 	index_def_delete(def);
 }
 
 int
-index_build(struct index *index, struct index *pk)
+index_build_feed(struct index *index, struct index *pk)
 {
 	ssize_t n_tuples = index_size(pk);
 	if (n_tuples < 0)
@@ -555,9 +817,14 @@ index_build(struct index *index, struct index *pk)
 			break;
 	}
 	iterator_delete(it);
-	if (rc != 0)
-		return -1;
+	return rc;
+}
 
+int
+index_build(struct index *index, struct index *pk)
+{
+	if (index_build_feed(index, pk) != 0)
+		return -1;
 	index_end_build(index);
 	return 0;
 }
@@ -698,6 +965,26 @@ generic_index_get(struct index *index, const char *key,
 	return -1;
 }
 
+int
+generic_index_get_many(struct index *index, const char **keys,
+		       uint32_t count, struct port *result)
+{
+	uint32_t part_count = index->def->key_def->part_count;
+	for (uint32_t i = 0; i < count; i++) {
+		struct tuple *tuple;
+		if (index_get(index, keys[i], part_count, &tuple) != 0)
+			return -1;
+		/*
+		 * Add the tuple to the port right away: a tuple
+		 * returned by a disk engine may be referenced only
+		 * until the next lookup.
+		 */
+		if (tuple != NULL && port_c_add_tuple(result, tuple) != 0)
+			return -1;
+	}
+	return 0;
+}
+
 int
 generic_index_replace(struct index *index, struct tuple *old_tuple,
 		      struct tuple *new_tuple, enum dup_replace_mode mode,
@@ -721,6 +1008,15 @@ generic_index_create_iterator(struct index *base, enum iterator_type type,
 	return NULL;
 }
 
+struct iterator *
+generic_index_create_iterator_with_offset(struct index *index,
+					  enum iterator_type type,
+					  const char *key, uint32_t part_count,
+					  uint32_t *offset)
+{
+	(void)offset;
+	return index->vtab->create_iterator(index, type, key, part_count);
+}
 
 struct snapshot_iterator *
 generic_index_create_snapshot_iterator(struct index *index)
@@ -729,6 +1025,18 @@ generic_index_create_snapshot_iterator(struct index *index)
 	return NULL;
 }
 
+struct snapshot_iterator *
+generic_index_create_read_view_iterator(struct index *index,
+					enum iterator_type type,
+					const char *key, uint32_t part_count)
+{
+	(void)type;
+	(void)key;
+	(void)part_count;
+	diag_set(UnsupportedIndexFeature, index->def, "consistent read view");
+	return NULL;
+}
+
 void
 generic_index_stat(struct index *index, struct info_handler *handler)
 {
@@ -765,9 +1073,9 @@ generic_index_build_next(struct index *index, struct tuple *tuple)
 {
 	struct tuple *unused;
 	/*
-	 * Note this is not no-op call in case of rtee index:
-	 * reserving 0 bytes is required during rtree recovery.
-	 * For details see memtx_rtree_index_reserve().
+	 * Note this is not always a no-op call: some indexes use
+	 * it to make sure that the following replace can't fail
+	 * to allocate memory.
 	 */
 	if (index_reserve(index, 0) != 0)
 		return -1;
@@ -34,12 +34,14 @@
 #include "trivia/util.h"
 #include "iterator_type.h"
 #include "index_def.h"
+#include "hot_keys.h"
 
 #if defined(__cplusplus)
 extern "C" {
 #endif /* defined(__cplusplus) */
 
 struct tuple;
+struct port;
 struct engine;
 struct index;
 struct index_def;
@@ -212,6 +214,42 @@ box_tuple_extract_key(box_tuple_t *tuple, uint32_t space_id,
 
 /** \endcond public */
 
+/**
+ * Retrieve up to \a count next items from the \a iterator. Unlike
+ * box_iterator_next(), every returned tuple is referenced, and the
+ * caller must unreference it with box_tuple_unref().
+ *
+ * \param iterator an iterator returned by box_index_iterator().
+ * \param[out] result an array of at least \a count tuples.
+ * \param count the maximal number of tuples to retrieve.
+ * \retval -1 on error (check box_error_last() for details)
+ * \retval the number of retrieved tuples. It is less than \a count
+ *         only if there is no more data.
+ */
+ssize_t
+box_iterator_next_batch(box_iterator_t *iterator, box_tuple_t **result,
+			uint32_t count);
+
+/**
+ * Get the position of a tuple in an index, which can be passed to
+ * box_select() to start iteration right after the tuple. The tuple
+ * is MsgPack data, it doesn't have to be stored in the space. The
+ * position is allocated on the fiber region.
+ *
+ * \param space_id space identifier
+ * \param index_id index identifier
+ * \param tuple encoded tuple in MsgPack Array format
+ * \param tuple_end the end of encoded \a tuple
+ * \param[out] packed_pos the position
+ * \param[out] packed_pos_end the end of the position
+ * \retval -1 on error (check box_error_last())
+ * \retval 0 on success
+ */
+int
+box_index_tuple_position(uint32_t space_id, uint32_t index_id,
+			 const char *tuple, const char *tuple_end,
+			 const char **packed_pos, const char **packed_pos_end);
+
 /**
  * Index statistics (index:stat())
  *
@@ -236,6 +274,48 @@ box_index_stat(uint32_t space_id, uint32_t index_id,
 int
 box_index_compact(uint32_t space_id, uint32_t index_id);
 
+/**
+ * Start tracking frequently accessed keys of an index
+ * (index:hot_keys_enable()). The statistics collected so far
+ * are dropped.
+ *
+ * \param space_id space identifier
+ * \param index_id index identifier
+ * \param sample_rate one in sample_rate accesses is sampled
+ * \retval -1 on error (check box_error_last())
+ * \retval >=0 on success
+ */
+int
+box_index_hot_keys_enable(uint32_t space_id, uint32_t index_id,
+			  uint32_t sample_rate);
+
+/**
+ * Stop tracking frequently accessed keys of an index
+ * (index:hot_keys_disable()).
+ *
+ * \param space_id space identifier
+ * \param index_id index identifier
+ * \retval -1 on error (check box_error_last())
+ * \retval >=0 on success
+ */
+int
+box_index_hot_keys_disable(uint32_t space_id, uint32_t index_id);
+
+/**
+ * Get the tracker of frequently accessed keys of an index
+ * (index:hot_keys()).
+ *
+ * \param space_id space identifier
+ * \param index_id index identifier
+ * \param[out] hot_keys the tracker
+ * \retval -1 on error (check box_error_last()), including the case
+ *         when tracking is disabled
+ * \retval >=0 on success
+ */
+int
+box_index_hot_keys(uint32_t space_id, uint32_t index_id,
+		   struct hot_keys **hot_keys);
+
 struct iterator {
 	/**
 	 * Iterate to the next tuple.
@@ -328,6 +408,55 @@ int
 exact_key_validate(struct key_def *key_def, const char *key,
 		   uint32_t part_count);
 
+/**
+ * Check that an iteration over the index with the given iterator
+ * type and key may start after the position returned by a previous
+ * select, i.e. that the position is a full cmp_def key within the
+ * iterator range. If @a pos is NULL, only check that the index
+ * supports positions.
+ *
+ * @param key msgpack-encoded key with the array header
+ * @param pos position with the array header, may be NULL
+ *
+ * @retval 0  The position is valid.
+ * @retval -1 The position is invalid or not supported, diag is set.
+ */
+int
+index_check_position(struct index *index, enum iterator_type type,
+		     const char *key, uint32_t part_count,
+		     const char *pos, const char *pos_end);
+
+/**
+ * Get the position of a tuple in an index, which can be passed to
+ * a select to continue iteration after the tuple. The position is
+ * the key of the tuple extracted with cmp_def and is allocated on
+ * the fiber region.
+ *
+ * @retval 0  Success.
+ * @retval -1 Memory error or the index doesn't support positions.
+ */
+int
+index_tuple_position(struct index *index, struct tuple *tuple,
+		     const char **pos, const char **pos_end);
+
+
+/**
+ * Get tuples from a unique index by several keys at once.
+ *
+ * \param space_id space identifier
+ * \param index_id index identifier
+ * \param keys MsgPack array of keys, each is a MsgPack array.
+ * \param keys_end the end of encoded \a keys
+ * \param[out] port port with the found tuples in the order of keys.
+ *             Keys that aren't found are skipped.
+ * \retval -1 on error
+ * \retval 0 on success
+ * \sa \code box.space[space_id].index[index_id]:get_many(keys) \endcode
+ */
+int
+box_index_get_many(uint32_t space_id, uint32_t index_id, const char *keys,
+		   const char *keys_end, struct port *port);
+
 /**
  * The manner in which replace in a unique index must treat
  * duplicates (tuples with the same value of indexed key),
@@ -413,6 +542,14 @@ struct index_vtab {
 			 const char *key, uint32_t part_count);
 	int (*get)(struct index *index, const char *key,
 		   uint32_t part_count, struct tuple **result);
+	/**
+	 * Look up several full keys at once. Each key points to
+	 * MsgPack of key_def::part_count parts without the array
+	 * header. Found tuples are appended to the given port_c
+	 * in the order of keys, missing keys are skipped.
+	 */
+	int (*get_many)(struct index *index, const char **keys,
+			uint32_t count, struct port *result);
 	/**
 	 * Main entrance point for changing data in index. Once built and
 	 * before deletion this is the only way to insert, replace and delete
@@ -430,12 +567,32 @@ struct index_vtab {
 	struct iterator *(*create_iterator)(struct index *index,
 			enum iterator_type type,
 			const char *key, uint32_t part_count);
+	/**
+	 * Create an index iterator that skips the first tuples of
+	 * the range. The offset is decreased by the number of tuples
+	 * the index skipped without returning them, and the caller
+	 * must skip the rest with iterator_next().
+	 */
+	struct iterator *(*create_iterator_with_offset)(struct index *index,
+			enum iterator_type type, const char *key,
+			uint32_t part_count, uint32_t *offset);
 	/**
 	 * Create an ALL iterator with personal read view so further
 	 * index modifications will not affect the iteration results.
 	 * Must be destroyed by iterator_delete() after usage.
 	 */
 	struct snapshot_iterator *(*create_snapshot_iterator)(struct index *);
+	/**
+	 * Create an iterator over a personal read view of the index
+	 * that returns the same tuples as an iterator created by
+	 * create_iterator() with the same arguments would. The key
+	 * isn't referenced after the function returns. The iterator
+	 * may be advanced from any thread, doesn't fail, and must be
+	 * destroyed in the tx thread by iterator->free().
+	 */
+	struct snapshot_iterator *(*create_read_view_iterator)(
+		struct index *index, enum iterator_type type,
+		const char *key, uint32_t part_count);
 	/** Introspection (index:stat()) */
 	void (*stat)(struct index *, struct info_handler *);
 	/**
@@ -459,6 +616,21 @@ struct index_vtab {
 	void (*end_build)(struct index *index);
 };
 
+/**
+ * Operation counters of an index. Updated by the tx thread only,
+ * so they are plain integers.
+ */
+struct index_op_stat {
+	/** Number of point lookups, see index_get(). */
+	int64_t get;
+	/** Number of iterators created, i.e. selects and pairs. */
+	int64_t select;
+	/** Number of iterator steps, see iterator_next(). */
+	int64_t next;
+	/** Number of tuples inserted, replaced or deleted. */
+	int64_t write;
+};
+
 struct index {
 	/** Virtual function table. */
 	const struct index_vtab *vtab;
@@ -483,6 +655,13 @@ struct index {
 	struct rlist nearby_gaps;
 	/** List of full scans of the index. @sa struct full_scan_item. */
 	struct rlist full_scans;
+	/** Operation counters, see space_stat(). */
+	struct index_op_stat op_stat;
+	/**
+	 * Tracker of frequently accessed keys or NULL if disabled,
+	 * see index:hot_keys().
+	 */
+	struct hot_keys *hot_keys;
 };
 
 /**
@@ -557,6 +736,15 @@ index_unref(struct index *index)
 int
 index_build(struct index *index, struct index *pk);
 
+/**
+ * Feed all tuples of another index to this index, but don't
+ * finish the build. The caller must call index_end_build() on
+ * success. Used to do some work between the two steps, e.g.
+ * building several indexes simultaneously.
+ */
+int
+index_build_feed(struct index *index, struct index *pk);
+
 static inline void
 index_commit_create(struct index *index, int64_t signature)
 {
@@ -639,13 +827,60 @@ index_count(struct index *index, enum iterator_type type,
 	return index->vtab->count(index, type, key, part_count);
 }
 
+/**
+ * Account an access to a key in the hot key tracker of an index if
+ * it's enabled. The key is given without the MsgPack array header.
+ * Partial keys are ignored.
+ */
+static inline void
+index_hot_keys_add_key(struct index *index, const char *key,
+		       uint32_t part_count)
+{
+	struct hot_keys *hot_keys = index->hot_keys;
+	if (likely(hot_keys == NULL) ||
+	    part_count != index->def->key_def->part_count ||
+	    !hot_keys_sample(hot_keys))
+		return;
+	hot_keys_add_key(hot_keys, index->def->key_def, key);
+}
+
+/** Account an access to the key of a tuple, see above. */
+static inline void
+index_hot_keys_add_tuple(struct index *index, struct tuple *tuple)
+{
+	struct hot_keys *hot_keys = index->hot_keys;
+	if (likely(hot_keys == NULL) || !hot_keys_sample(hot_keys))
+		return;
+	hot_keys_add_tuple(hot_keys, index->def->key_def, tuple);
+}
+
+/** Account an access to the key of a MsgPack tuple, see above. */
+static inline void
+index_hot_keys_add_raw(struct index *index, const char *data,
+		       const char *data_end)
+{
+	struct hot_keys *hot_keys = index->hot_keys;
+	if (likely(hot_keys == NULL) || !hot_keys_sample(hot_keys))
+		return;
+	hot_keys_add_raw(hot_keys, index->def->key_def, data, data_end);
+}
+
 static inline int
 index_get(struct index *index, const char *key,
 	   uint32_t part_count, struct tuple **result)
 {
+	index->op_stat.get++;
+	index_hot_keys_add_key(index, key, part_count);
 	return index->vtab->get(index, key, part_count, result);
 }
 
+static inline int
+index_get_many(struct index *index, const char **keys, uint32_t count,
+	       struct port *result)
+{
+	return index->vtab->get_many(index, keys, count, result);
+}
+
 /**
  * Get tuple to be inserted in index, based on index-specific constraints
  * (current constraint: if exclude_null = true, return NULL)
@@ -675,6 +910,7 @@ index_replace(struct index *index, struct tuple *old_tuple,
 		*result = NULL;
 		return 0;
 	}
+	index->op_stat.write++;
 	return index->vtab->replace(index, old_tuple, new_tuple, mode,
 				    result, successor);
 }
@@ -683,15 +919,38 @@ static inline struct iterator *
 index_create_iterator(struct index *index, enum iterator_type type,
 		      const char *key, uint32_t part_count)
 {
+	index->op_stat.select++;
+	if (type == ITER_EQ || type == ITER_REQ)
+		index_hot_keys_add_key(index, key, part_count);
 	return index->vtab->create_iterator(index, type, key, part_count);
 }
 
+static inline struct iterator *
+index_create_iterator_with_offset(struct index *index, enum iterator_type type,
+				  const char *key, uint32_t part_count,
+				  uint32_t *offset)
+{
+	index->op_stat.select++;
+	if (type == ITER_EQ || type == ITER_REQ)
+		index_hot_keys_add_key(index, key, part_count);
+	return index->vtab->create_iterator_with_offset(index, type, key,
+							 part_count, offset);
+}
+
 static inline struct snapshot_iterator *
 index_create_snapshot_iterator(struct index *index)
 {
 	return index->vtab->create_snapshot_iterator(index);
 }
 
+static inline struct snapshot_iterator *
+index_create_read_view_iterator(struct index *index, enum iterator_type type,
+				const char *key, uint32_t part_count)
+{
+	return index->vtab->create_read_view_iterator(index, type, key,
+						      part_count);
+}
+
 static inline void
 index_stat(struct index *index, struct info_handler *handler)
 {
@@ -753,10 +1012,16 @@ int generic_index_random(struct index *, uint32_t, struct tuple **);
 ssize_t generic_index_count(struct index *, enum iterator_type,
 			    const char *, uint32_t);
 int generic_index_get(struct index *, const char *, uint32_t, struct tuple **);
+int generic_index_get_many(struct index *, const char **, uint32_t,
+			   struct port *);
 int generic_index_replace(struct index *, struct tuple *, struct tuple *,
 			  enum dup_replace_mode,
 			  struct tuple **, struct tuple **);
 struct snapshot_iterator *generic_index_create_snapshot_iterator(struct index *);
+struct snapshot_iterator *
+generic_index_create_read_view_iterator(struct index *index,
+					enum iterator_type type,
+					const char *key, uint32_t part_count);
 void generic_index_stat(struct index *, struct info_handler *);
 void generic_index_compact(struct index *);
 void generic_index_reset_stat(struct index *);
@@ -765,6 +1030,11 @@ int generic_index_reserve(struct index *, uint32_t);
 struct iterator *
 generic_index_create_iterator(struct index *base, enum iterator_type type,
 			      const char *key, uint32_t part_count);
+struct iterator *
+generic_index_create_iterator_with_offset(struct index *index,
+					  enum iterator_type type,
+					  const char *key, uint32_t part_count,
+					  uint32_t *offset);
 int generic_index_build_next(struct index *, struct tuple *);
 void generic_index_end_build(struct index *);
 int
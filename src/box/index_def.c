@@ -39,6 +39,8 @@ const char *index_type_strs[] = { "HASH", "TREE", "BITSET", "RTREE" };
 
 const char *rtree_index_distance_type_strs[] = { "EUCLID", "MANHATTAN" };
 
+const char *compaction_strategy_strs[] = { "leveled", "tiered" };
+
 const struct index_opts index_opts_default = {
 	/* .unique              = */ true,
 	/* .dimension           = */ 2,
@@ -48,10 +50,12 @@ const struct index_opts index_opts_default = {
 	/* .run_count_per_level = */ 2,
 	/* .run_size_ratio      = */ 3.5,
 	/* .bloom_fpr           = */ 0.05,
+	/* .compaction_strategy = */ COMPACTION_STRATEGY_LEVELED,
 	/* .lsn                 = */ 0,
 	/* .stat                = */ NULL,
 	/* .func                = */ 0,
 	/* .hint                = */ true,
+	/* .multipart_hint      = */ false,
 };
 
 const struct opt_def index_opts_reg[] = {
@@ -64,10 +68,13 @@ const struct opt_def index_opts_reg[] = {
 	OPT_DEF("run_count_per_level", OPT_INT64, struct index_opts, run_count_per_level),
 	OPT_DEF("run_size_ratio", OPT_FLOAT, struct index_opts, run_size_ratio),
 	OPT_DEF("bloom_fpr", OPT_FLOAT, struct index_opts, bloom_fpr),
+	OPT_DEF_ENUM("compaction_strategy", compaction_strategy,
+		     struct index_opts, compaction_strategy, NULL),
 	OPT_DEF("lsn", OPT_INT64, struct index_opts, lsn),
 	OPT_DEF("func", OPT_UINT32, struct index_opts, func_id),
 	OPT_DEF_LEGACY("sql"),
 	OPT_DEF("hint", OPT_BOOL, struct index_opts, hint),
+	OPT_DEF("multipart_hint", OPT_BOOL, struct index_opts, multipart_hint),
 	OPT_END,
 };
 
@@ -111,6 +118,8 @@ index_def_new(uint32_t space_id, uint32_t iid, const char *name,
 		index_def_delete(def);
 		return NULL;
 	}
+	if (type == TREE && opts->hint && opts->multipart_hint)
+		key_def_set_multipart_hint(def->cmp_def);
 	def->type = type;
 	def->space_id = space_id;
 	def->iid = iid;
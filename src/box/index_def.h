@@ -58,6 +58,27 @@ enum rtree_index_distance_type {
 };
 extern const char *rtree_index_distance_type_strs[];
 
+/** How a vinyl LSM tree decides which runs to compact. */
+enum compaction_strategy {
+	/**
+	 * Keep at most run_count_per_level runs per level and
+	 * at most one run at the last level. Gives the lowest
+	 * space and read amplification.
+	 */
+	COMPACTION_STRATEGY_LEVELED,
+	/**
+	 * Same as leveled, but the last level may store up to
+	 * run_count_per_level runs as any other level, so the
+	 * biggest run isn't rewritten each time a new run reaches
+	 * the last level. Gives lower write amplification at the
+	 * cost of higher space and read amplification.
+	 */
+	COMPACTION_STRATEGY_TIERED,
+	compaction_strategy_MAX
+};
+
+extern const char *compaction_strategy_strs[];
+
 /** Simple alias to represent logarithm metrics. */
 typedef int16_t log_est_t;
 
@@ -153,6 +174,8 @@ struct index_opts {
 	double run_size_ratio;
 	/* Bloom filter false positive rate. */
 	double bloom_fpr;
+	/** Vinyl compaction strategy. */
+	enum compaction_strategy compaction_strategy;
 	/**
 	 * LSN from the time of index creation.
 	 */
@@ -169,6 +192,11 @@ struct index_opts {
 	 * Use hint optimization for tree index.
 	 */
 	bool hint;
+	/**
+	 * Build tree index hints from the first two key parts,
+	 * see key_def_set_multipart_hint().
+	 */
+	bool multipart_hint;
 };
 
 extern const struct index_opts index_opts_default;
@@ -213,10 +241,15 @@ index_opts_cmp(const struct index_opts *o1, const struct index_opts *o2)
 		return o1->run_size_ratio < o2->run_size_ratio ? -1 : 1;
 	if (o1->bloom_fpr != o2->bloom_fpr)
 		return o1->bloom_fpr < o2->bloom_fpr ? -1 : 1;
+	if (o1->compaction_strategy != o2->compaction_strategy)
+		return o1->compaction_strategy < o2->compaction_strategy ?
+		       -1 : 1;
 	if (o1->func_id != o2->func_id)
 		return o1->func_id - o2->func_id;
 	if (o1->hint != o2->hint)
 		return o1->hint - o2->hint;
+	if (o1->multipart_hint != o2->multipart_hint)
+		return o1->multipart_hint - o2->multipart_hint;
 	return 0;
 }
 
@@ -52,6 +52,8 @@
 
 #include "bind.h"
 #include "port.h"
+#include "index.h"
+#include "tuple.h"
 #include "box.h"
 #include "call.h"
 #include "tuple_convert.h"
@@ -62,8 +64,12 @@
 #include "iproto_constants.h"
 #include "iproto_features.h"
 #include "rmean.h"
+#include "latency.h"
+#include "clock.h"
+#include "info/info.h"
 #include "execute.h"
 #include "errinj.h"
+#include "trivia/probe.h"
 #include "tt_static.h"
 #include "salad/stailq.h"
 #include "assoc.h"
@@ -124,6 +130,257 @@ iproto_wpos_create(struct iproto_wpos *wpos, struct obuf *out)
 	wpos->svp = obuf_create_svp(out);
 }
 
+enum {
+	/**
+	 * Min size of a select result set that is sent to the
+	 * client directly from tuples instead of being copied to
+	 * the output buffer. Smaller result sets are cheaper to copy
+	 * than to pass back to tx for unreferencing.
+	 */
+	IPROTO_SELECT_ZC_SIZE_MIN = 16 * 1024,
+	/** Max number of tuples written with one writev() call. */
+	IPROTO_SELECT_ZC_IOV_MAX = 256,
+};
+
+/**
+ * Result set of a select request that is written to the socket
+ * bypassing the connection output buffer. There are two kinds of
+ * them:
+ *
+ * - Zero-copy: the tx thread writes only the response header to
+ *   the output buffer and passes the port holding the tuples to
+ *   the iproto thread. Results of C functions called over iproto
+ *   are sent the same way, see tx_reply_call_zc(). The iproto
+ *   thread sends the tuples after the header and returns the
+ *   object back to tx, where the tuples are unreferenced.
+ *
+ * - Read view: the tx thread only opens a read view of the index
+ *   (see box_select_read_view()) and the iproto thread does the
+ *   rest: it reads the tuples, encodes the whole response to a
+ *   buffer and sends it. The read view is returned to tx as soon
+ *   as the response is encoded.
+ */
+struct iproto_select_zc {
+	/** Message used to return the object to tx. */
+	struct cmsg base;
+	/** C port referencing the result set tuples. */
+	struct port port;
+	/** Position in the output buffer the response follows. */
+	struct iproto_wpos wpos;
+	/** Link in iproto_connection::select_zc_queue. */
+	struct stailq_entry in_queue;
+	/** First port entry that hasn't been sent yet. */
+	struct port_c_entry *pos;
+	/**
+	 * Number of already sent bytes of the port entry or of
+	 * the response buffer.
+	 */
+	size_t offset;
+	/** Read view to read the result set from, or NULL. */
+	struct snapshot_iterator *read_view;
+	/** Schema version to reply with, if read view is used. */
+	uint32_t schema_version;
+	/** Response read from the read view, or NULL. */
+	char *buf;
+	/** Size of the response read from the read view. */
+	size_t buf_size;
+};
+
+/** Return data of a port entry. Doesn't access the tuple ref counter. */
+static inline const char *
+iproto_select_zc_entry_data(struct port_c_entry *pe, uint32_t *size)
+{
+	if (pe->mp_size != 0) {
+		*size = pe->mp_size;
+		return pe->mp;
+	}
+	return tuple_data_range(pe->tuple, size);
+}
+
+/**
+ * Move the result set stored in the given C port to a new
+ * zero-copy select object. Never fails.
+ */
+static struct iproto_select_zc *
+iproto_select_zc_new(struct port *port)
+{
+	struct iproto_select_zc *zc =
+		(struct iproto_select_zc *)xmalloc(sizeof(*zc));
+	struct port_c *src = (struct port_c *)port;
+	struct port_c *dst = (struct port_c *)&zc->port;
+	*dst = *src;
+	/* The first entry is embedded into the port, relink it. */
+	if (src->first == &src->first_entry)
+		dst->first = &dst->first_entry;
+	if (src->last == &src->first_entry)
+		dst->last = &dst->first_entry;
+	port_c_create(port);
+	zc->pos = dst->first;
+	zc->offset = 0;
+	zc->read_view = NULL;
+	zc->buf = NULL;
+	zc->buf_size = 0;
+	return zc;
+}
+
+/**
+ * Create a select result set that will be read from the given
+ * read view by the iproto thread. Never fails.
+ */
+static struct iproto_select_zc *
+iproto_select_zc_new_read_view(struct snapshot_iterator *read_view,
+			       uint32_t schema_version)
+{
+	struct iproto_select_zc *zc =
+		(struct iproto_select_zc *)xmalloc(sizeof(*zc));
+	port_c_create(&zc->port);
+	zc->pos = NULL;
+	zc->offset = 0;
+	zc->read_view = read_view;
+	zc->schema_version = schema_version;
+	zc->buf = NULL;
+	zc->buf_size = 0;
+	return zc;
+}
+
+/** Unreference the result set tuples and free the object. */
+static void
+tx_select_zc_delete(struct cmsg *m)
+{
+	struct iproto_select_zc *zc = (struct iproto_select_zc *)m;
+	port_destroy(&zc->port);
+	free(zc);
+}
+
+static const struct cmsg_hop select_zc_delete_route[] = {
+	{ tx_select_zc_delete, NULL },
+};
+
+/** Message used to return a read view to tx. */
+struct iproto_read_view_msg {
+	struct cmsg base;
+	struct snapshot_iterator *read_view;
+};
+
+static void
+tx_read_view_delete(struct cmsg *m)
+{
+	struct iproto_read_view_msg *msg = (struct iproto_read_view_msg *)m;
+	msg->read_view->free(msg->read_view);
+	free(msg);
+}
+
+static const struct cmsg_hop read_view_delete_route[] = {
+	{ tx_read_view_delete, NULL },
+};
+
+/**
+ * Encoded IPROTO_EVENT packet. The packet has no sync, so a single
+ * buffer is shared by all connections notified about the same key
+ * update. Allocated in tx, freed by the thread that drops the last
+ * reference.
+ */
+struct iproto_event {
+	/** Reference counter, accessed atomically. */
+	int refs;
+	/** Version of the key data, see watcher_version(). */
+	uint64_t version;
+	/** Notification key name, stored after the packet. */
+	const char *key;
+	/** Length of the notification key name. */
+	size_t key_len;
+	/** Size of the packet. */
+	size_t size;
+	/** The packet. */
+	char data[0];
+};
+
+static struct iproto_event *
+iproto_event_new(const char *key, size_t key_len,
+		 const char *data, const char *data_end, uint64_t version)
+{
+	size_t size = iproto_event_size(key_len, data, data_end);
+	struct iproto_event *event =
+		(struct iproto_event *)xmalloc(sizeof(*event) + size +
+					       key_len);
+	event->refs = 1;
+	event->version = version;
+	event->size = size;
+	event->key_len = key_len;
+	event->key = event->data + size;
+	memcpy(event->data + size, key, key_len);
+	iproto_encode_event(event->data, size, key, key_len, data, data_end);
+	return event;
+}
+
+static inline void
+iproto_event_ref(struct iproto_event *event)
+{
+	__atomic_add_fetch(&event->refs, 1, __ATOMIC_RELAXED);
+}
+
+static inline void
+iproto_event_unref(struct iproto_event *event)
+{
+	if (__atomic_sub_fetch(&event->refs, 1, __ATOMIC_ACQ_REL) == 0)
+		free(event);
+}
+
+/** A notification queued for a connection. */
+struct iproto_event_entry {
+	/** Shared packet. */
+	struct iproto_event *event;
+	/** Connection to send the packet to. */
+	struct iproto_connection *con;
+	/** Number of bytes of the packet already sent. */
+	size_t offset;
+	/**
+	 * Link in iproto_thread::tx::event_queue, then in
+	 * iproto_event_msg::entries, then in
+	 * iproto_connection::event_queue.
+	 */
+	struct rlist in_queue;
+	/**
+	 * Link in iproto_connection::tx::events, while the entry is
+	 * in iproto_thread::tx::event_queue.
+	 */
+	struct rlist in_con;
+};
+
+static struct iproto_event_entry *
+iproto_event_entry_new(struct iproto_event *event,
+		       struct iproto_connection *con)
+{
+	struct iproto_event_entry *entry =
+		(struct iproto_event_entry *)xmalloc(sizeof(*entry));
+	iproto_event_ref(event);
+	entry->event = event;
+	entry->con = con;
+	entry->offset = 0;
+	rlist_create(&entry->in_queue);
+	rlist_create(&entry->in_con);
+	return entry;
+}
+
+static void
+iproto_event_entry_delete(struct iproto_event_entry *entry)
+{
+	iproto_event_unref(entry->event);
+	free(entry);
+}
+
+/**
+ * Message carrying a batch of notifications from tx to an iproto
+ * thread. There's one message per thread, which works like kharon
+ * (see iproto_kharon): notifications queued while the message is
+ * travelling are sent with it when it returns to tx.
+ */
+struct iproto_event_msg {
+	struct cmsg base;
+	/** Linked by iproto_event_entry::in_queue. */
+	struct rlist entries;
+};
+
 struct iproto_thread {
 	/**
 	 * Slab cache used for allocating memory for output network buffers
@@ -159,12 +416,15 @@ struct iproto_thread {
 	struct cmsg_hop misc_route[2];
 	struct cmsg_hop call_route[2];
 	struct cmsg_hop select_route[2];
+	struct cmsg_hop select_batch_route[2];
+	struct cmsg_hop process_many_route[2];
 	struct cmsg_hop process1_route[2];
 	struct cmsg_hop sql_route[2];
 	struct cmsg_hop join_route[2];
 	struct cmsg_hop subscribe_route[2];
 	struct cmsg_hop error_route[2];
 	struct cmsg_hop push_route[2];
+	struct cmsg_hop event_route[2];
 	struct cmsg_hop *dml_route[IPROTO_TYPE_STAT_MAX];
 	struct cmsg_hop connect_route[2];
 	/*
@@ -189,6 +449,8 @@ struct iproto_thread {
 	struct evio_service binary;
 	/** Requests count currently pending in stream queue. */
 	size_t requests_in_stream_queue;
+	/** Notification batch, see iproto_event_msg. */
+	struct iproto_event_msg event_msg;
 	/**
 	 * The following fields are used exclusively by the tx thread.
 	 * Align them to prevent false-sharing.
@@ -199,6 +461,13 @@ struct iproto_thread {
 		size_t requests_in_progress;
 		/** Iproto thread stat collected in tx thread. */
 		struct rmean *rmean;
+		/**
+		 * Notifications waiting for event_msg to return,
+		 * linked by iproto_event_entry::in_queue.
+		 */
+		struct rlist event_queue;
+		/** True if event_msg is travelling. */
+		bool is_event_msg_sent;
 	} tx;
 };
 
@@ -242,7 +511,9 @@ struct iproto_kharon {
  * use in iproto thread -- it's OK that
  * readahead has a stale value while until the thread
  * caches have synchronized, after all, it's used
- * in new connections only.
+ * in new buffers only. It's the upper bound of the
+ * start capacity of input buffers, which adapts to
+ * the requests of each connection.
  *
  * Notice that the default is not a strict power of two.
  * slab metadata takes some space, and we want
@@ -252,6 +523,11 @@ struct iproto_kharon {
  */
 unsigned iproto_readahead = 16320;
 
+unsigned iproto_coalesce_size = 0;
+double iproto_coalesce_timeout = 0.001;
+double iproto_slow_request_threshold = 0;
+unsigned iproto_busy_poll = 0;
+
 /* The maximal number of iproto messages in fly. */
 static int iproto_msg_max = IPROTO_MSG_MAX_MIN;
 
@@ -270,6 +546,24 @@ iproto_addr_str(char *buf, int idx)
 	return buf;
 }
 
+enum {
+	/** Size of the slab header, see iproto_readahead. */
+	IPROTO_READAHEAD_HEADER = 64,
+	/**
+	 * The minimal start capacity of a connection input
+	 * buffer: the smallest slab minus the slab header, see
+	 * the comment to iproto_readahead.
+	 */
+	IPROTO_READAHEAD_MIN = 4032,
+	/**
+	 * Input buffers are sized to fit this many requests of
+	 * the average size observed on the connection, so that
+	 * a pipelining client doesn't have to wait for buffer
+	 * rotation on every few requests.
+	 */
+	IPROTO_READAHEAD_REQUESTS = 8,
+};
+
 /**
  * How big is a buffer which needs to be shrunk before
  * it is put back into buffer cache.
@@ -292,8 +586,9 @@ iproto_reset_input(struct ibuf *ibuf)
 		ibuf_reset(ibuf);
 	} else {
 		struct slab_cache *slabc = ibuf->slabc;
+		size_t start_capacity = ibuf->start_capacity;
 		ibuf_destroy(ibuf);
-		ibuf_create(ibuf, slabc, iproto_readahead);
+		ibuf_create(ibuf, slabc, start_capacity);
 	}
 }
 
@@ -351,6 +646,11 @@ struct iproto_msg
 	 * more output to flush.
 	 */
 	struct iproto_wpos wpos;
+	/**
+	 * Result set of a select request to send after the data
+	 * written to the output buffer, or NULL.
+	 */
+	struct iproto_select_zc *select_zc;
 	/**
 	 * Message sent by the tx thread to notify iproto that input has
 	 * been processed and can be discarded before request completion.
@@ -372,6 +672,15 @@ struct iproto_msg
 	struct stailq_entry in_stream;
 	/** Stream that owns this message, or NULL. */
 	struct iproto_stream *stream;
+	/**
+	 * Time when the request was read from the socket, or 0
+	 * if the message isn't a request.
+	 */
+	double recv_time;
+	/** Time when the request was put to the tx pipe. */
+	double push_time;
+	/** Time when tx started to process the request. */
+	double accept_time;
 };
 
 static struct iproto_msg *
@@ -408,13 +717,39 @@ const char *rmean_net_strings[RMEAN_NET_LAST] = {
 
 enum rmean_tx_name {
 	REQUESTS_IN_PROGRESS,
+	REQUESTS_EXPIRED,
 	RMEAN_TX_LAST,
 };
 
 const char *rmean_tx_strings[RMEAN_TX_LAST] = {
 	"REQUESTS_IN_PROGRESS",
+	"REQUESTS_EXPIRED",
+};
+
+/**
+ * Latency of requests of one type split into processing stages.
+ * Updated only by the tx thread.
+ */
+struct iproto_latency {
+	/**
+	 * From reading the request from the socket to putting it
+	 * to the tx pipe, including waiting for net_msg_max and
+	 * for preceding requests of the same stream.
+	 */
+	struct latency net;
+	/** From putting the request to the tx pipe to tx. */
+	struct latency cbus;
+	/** Execution in tx except for waiting for WAL. */
+	struct latency tx;
+	/** Waiting for WAL. */
+	struct latency wal;
+	/** From reading the request to the end of execution in tx. */
+	struct latency total;
 };
 
+/** Request latencies by request type, see iproto_type_strs. */
+static struct iproto_latency iproto_latencies[IPROTO_TYPE_STAT_MAX];
+
 static void
 tx_process_destroy(struct cmsg *m);
 
@@ -446,6 +781,22 @@ iproto_process_push(struct cmsg *m);
 static void
 tx_end_push(struct cmsg *m);
 
+/**
+ * A batch of notifications arrives to iproto. Queue them for the
+ * connections and schedule flushing.
+ * @param m Notification batch.
+ */
+static void
+net_deliver_events(struct cmsg *m);
+
+/**
+ * A batch of notifications returns to tx. Send the notifications
+ * queued meanwhile, if any.
+ * @param m Notification batch.
+ */
+static void
+tx_end_events(struct cmsg *m);
+
 /* }}} */
 
 /* {{{ iproto_connection - declaration and definition */
@@ -542,6 +893,20 @@ struct iproto_connection
 	 * output is available (see iproto_msg::wpos).
 	 */
 	struct iproto_wpos wend;
+	/**
+	 * Zero-copy select result sets awaiting to be flushed, in the
+	 * order of their headers in the output buffer. The output
+	 * buffer is flushed only up to the header of the first one,
+	 * then its tuples are written.
+	 */
+	struct stailq select_zc_queue;
+	/**
+	 * Notifications awaiting to be sent, linked by
+	 * iproto_event_entry::in_queue. They are written when the
+	 * output buffer and zero-copy result sets are flushed, so
+	 * that they don't get in the middle of a response.
+	 */
+	struct rlist event_queue;
 	/*
 	 * Size of readahead which is not parsed yet, i.e. size of
 	 * a piece of request which is not fully read. Is always
@@ -554,6 +919,16 @@ struct iproto_connection
 	 * meaningless.
 	 */
 	size_t parse_size;
+	/** Time when the last chunk of the input was read. */
+	double input_time;
+	/**
+	 * Start capacity of new input buffers. Adapts to the size
+	 * of requests and to how fast the client fills buffers,
+	 * iproto_readahead is the upper bound.
+	 */
+	size_t readahead;
+	/** Moving average of the size of requests. */
+	size_t avg_request_size;
 	/**
 	 * Nubmer of active long polling requests that have already
 	 * discarded their arguments in order not to stall other
@@ -564,6 +939,12 @@ struct iproto_connection
 	struct iostream io;
 	struct ev_io input;
 	struct ev_io output;
+	/**
+	 * Timer that flushes output delayed to be coalesced with
+	 * replies to other pipelined requests of the connection,
+	 * see iproto_connection_schedule_output().
+	 */
+	struct ev_timer coalesce_timer;
 	/** Logical session. */
 	struct session *session;
 	ev_loop *loop;
@@ -645,6 +1026,12 @@ struct iproto_connection
 		 * return.
 		 */
 		bool is_push_pending;
+		/**
+		 * Notifications of this connection waiting in
+		 * iproto_thread::tx::event_queue, linked by
+		 * iproto_event_entry::in_con.
+		 */
+		struct rlist events;
 	} tx;
 	/** Authentication salt. */
 	char salt[IPROTO_SALT_SIZE];
@@ -750,8 +1137,10 @@ iproto_msg_new(struct iproto_connection *con)
 		return NULL;
 	}
 	msg->close_connection = false;
+	msg->select_zc = NULL;
 	msg->connection = con;
 	msg->stream = NULL;
+	msg->recv_time = 0;
 	rmean_collect(con->iproto_thread->rmean, IPROTO_REQUESTS, 1);
 	return msg;
 }
@@ -778,6 +1167,60 @@ iproto_connection_feed_output(struct iproto_connection *con)
 		ev_feed_event(con->loop, &con->output, EV_CUSTOM);
 }
 
+/**
+ * Return the approximate size of output awaiting to be flushed,
+ * not counting zero-copy result sets.
+ */
+static inline size_t
+iproto_connection_output_size(struct iproto_connection *con)
+{
+	struct iproto_wpos *begin = &con->wpos;
+	struct iproto_wpos *end = &con->wend;
+	if (begin->obuf == end->obuf)
+		return end->svp.used - begin->svp.used;
+	return obuf_size(begin->obuf) - begin->svp.used + end->svp.used;
+}
+
+/**
+ * Signal output of replies, unless there are requests of the
+ * connection still being processed and it's worth waiting for
+ * their replies to write them all with one syscall. The output
+ * is delayed until there are iproto_coalesce_size bytes to
+ * write, the last request in progress is replied to or
+ * iproto_coalesce_timeout expires, whatever happens first.
+ */
+static void
+iproto_connection_schedule_output(struct iproto_connection *con)
+{
+	assert(con->state == IPROTO_CONNECTION_ALIVE);
+	/*
+	 * All the input that is not parsed yet is accounted in
+	 * parse_size, so if the buffers hold nothing else, there
+	 * are no requests in progress.
+	 */
+	bool has_requests = ibuf_used(&con->ibuf[0]) +
+			    ibuf_used(&con->ibuf[1]) > con->parse_size;
+	if (iproto_coalesce_size == 0 || !has_requests ||
+	    iproto_connection_output_size(con) >= iproto_coalesce_size) {
+		iproto_connection_feed_output(con);
+		return;
+	}
+	if (!ev_is_active(&con->coalesce_timer)) {
+		ev_timer_set(&con->coalesce_timer, iproto_coalesce_timeout, 0);
+		ev_timer_start(con->loop, &con->coalesce_timer);
+	}
+}
+
+static void
+iproto_connection_on_coalesce_timer(ev_loop *loop, struct ev_timer *watcher,
+				    int /* revents */)
+{
+	(void)loop;
+	struct iproto_connection *con =
+		(struct iproto_connection *)watcher->data;
+	iproto_connection_feed_output(con);
+}
+
 /**
  * A connection is idle when the client is gone
  * and there are no outstanding msgs in the msg queue.
@@ -841,6 +1284,98 @@ iproto_connection_stop_msg_max_limit(struct iproto_connection *con)
 		       &con->in_stop_list);
 }
 
+/**
+ * Pass a zero-copy select result set back to tx, which will
+ * unreference the tuples and free it.
+ */
+static void
+iproto_select_zc_release(struct iproto_connection *con,
+			 struct iproto_select_zc *zc)
+{
+	assert(zc->read_view == NULL);
+	if (zc->buf != NULL) {
+		/* Nothing is referenced, no need to bother tx. */
+		free(zc->buf);
+		free(zc);
+		return;
+	}
+	cmsg_init(&zc->base, select_zc_delete_route);
+	cpipe_push(&con->iproto_thread->tx_pipe, &zc->base);
+}
+
+/**
+ * Read the result set of a select request from the read view and
+ * encode the response, then return the read view to tx.
+ * @param request Select request or NULL if the connection is
+ *        closed and the result set isn't needed.
+ */
+static void
+iproto_select_zc_read(struct iproto_connection *con,
+		      struct iproto_select_zc *zc,
+		      const struct request *request, uint64_t sync)
+{
+	struct snapshot_iterator *it = zc->read_view;
+	assert(it != NULL);
+	if (request != NULL) {
+		size_t capacity = IPROTO_SELECT_ZC_SIZE_MIN;
+		size_t size = IPROTO_SELECT_HEADER_LEN;
+		char *buf = (char *)xmalloc(capacity);
+		uint32_t offset = request->offset;
+		uint32_t count = 0;
+		while (count < request->limit) {
+			const char *data;
+			uint32_t len;
+			int rc = it->next(it, &data, &len);
+			assert(rc == 0);
+			(void)rc;
+			if (data == NULL)
+				break;
+			if (offset > 0) {
+				offset--;
+				continue;
+			}
+			if (size + len > capacity) {
+				capacity = MAX(size + len, 2 * capacity);
+				buf = (char *)xrealloc(buf, capacity);
+			}
+			memcpy(buf + size, data, len);
+			size += len;
+			count++;
+		}
+		iproto_select_header_encode(buf, sync, zc->schema_version,
+					    count,
+					    size - IPROTO_SELECT_HEADER_LEN);
+		zc->buf = buf;
+		zc->buf_size = size;
+	}
+	struct iproto_read_view_msg *msg =
+		(struct iproto_read_view_msg *)xmalloc(sizeof(*msg));
+	msg->read_view = it;
+	zc->read_view = NULL;
+	cmsg_init(&msg->base, read_view_delete_route);
+	cpipe_push(&con->iproto_thread->tx_pipe, &msg->base);
+}
+
+/** Free all notifications queued for a connection. */
+static void
+iproto_connection_discard_events(struct iproto_connection *con)
+{
+	struct iproto_event_entry *entry, *tmp;
+	rlist_foreach_entry_safe(entry, &con->event_queue, in_queue, tmp)
+		iproto_event_entry_delete(entry);
+	rlist_create(&con->event_queue);
+}
+
+/** Release all zero-copy result sets of a connection. */
+static void
+iproto_connection_discard_select_zc(struct iproto_connection *con)
+{
+	struct iproto_select_zc *zc, *tmp;
+	stailq_foreach_entry_safe(zc, tmp, &con->select_zc_queue, in_queue)
+		iproto_select_zc_release(con, zc);
+	stailq_create(&con->select_zc_queue);
+}
+
 /**
  * Send a destroy message to TX thread in case all requests are
  * finished.
@@ -882,12 +1417,16 @@ iproto_connection_close(struct iproto_connection *con)
 		/* Clears all pending events. */
 		ev_io_stop(con->loop, &con->input);
 		ev_io_stop(con->loop, &con->output);
+		ev_timer_stop(con->loop, &con->coalesce_timer);
 		/*
 		 * Invalidate fd to prevent undefined behavior in case
 		 * we mistakenly try to use it after this point.
 		 */
 		con->input.fd = con->output.fd = -1;
 		iostream_close(&con->io);
+		/* The output won't be sent, unreference the tuples. */
+		iproto_connection_discard_select_zc(con);
+		iproto_connection_discard_events(con);
 		/*
 		 * Discard unparsed data, to recycle the
 		 * connection in net_send_msg() as soon as all
@@ -928,6 +1467,56 @@ iproto_connection_next_input(struct iproto_connection *con)
 	return &con->ibuf[con->p_ibuf == &con->ibuf[0]];
 }
 
+/**
+ * Return the smallest size of a slab-fitting buffer that is
+ * greater than or equal to the given size, but not greater
+ * than iproto_readahead.
+ */
+static size_t
+iproto_readahead_fit(size_t size)
+{
+	size_t readahead = IPROTO_READAHEAD_MIN;
+	while (readahead < size && readahead < iproto_readahead)
+		readahead = (readahead + IPROTO_READAHEAD_HEADER) * 2 -
+			    IPROTO_READAHEAD_HEADER;
+	return MIN(readahead, (size_t)iproto_readahead);
+}
+
+/** Account the size of a request read from the connection. */
+static inline void
+iproto_connection_account_request(struct iproto_connection *con,
+				  size_t size)
+{
+	/* Exponential moving average with weight 1/8. */
+	con->avg_request_size = (7 * con->avg_request_size + size) / 8;
+}
+
+/**
+ * Free the memory of the input buffers of a connection that has
+ * all its input processed, and adjust the size of the buffers
+ * to be allocated on new input to the size of recent requests.
+ * The memory returns to the thread slab cache and is reused by
+ * other connections, so idle connections hold no input buffers.
+ */
+static void
+iproto_connection_release_input(struct iproto_connection *con)
+{
+	assert(ibuf_used(&con->ibuf[0]) == 0);
+	assert(ibuf_used(&con->ibuf[1]) == 0);
+	assert(con->parse_size == 0);
+	con->readahead = iproto_readahead_fit(IPROTO_READAHEAD_REQUESTS *
+					      con->avg_request_size);
+	for (int i = 0; i < 2; i++) {
+		struct ibuf *ibuf = &con->ibuf[i];
+		if (ibuf->buf == NULL &&
+		    ibuf->start_capacity == con->readahead)
+			continue;
+		struct slab_cache *slabc = ibuf->slabc;
+		ibuf_destroy(ibuf);
+		ibuf_create(ibuf, slabc, con->readahead);
+	}
+}
+
 /**
  * If there is no space for reading input, we can do one of the
  * following:
@@ -986,6 +1575,12 @@ iproto_connection_input_buffer(struct iproto_connection *con)
 		return old_ibuf;
 	}
 
+	/*
+	 * The client fills buffers faster than we process them,
+	 * so use bigger buffers from now on.
+	 */
+	con->readahead = iproto_readahead_fit(2 * con->readahead);
+
 	struct ibuf *new_ibuf = iproto_connection_next_input(con);
 	if (ibuf_used(new_ibuf) != 0) {
 		/*
@@ -995,9 +1590,9 @@ iproto_connection_input_buffer(struct iproto_connection *con)
 		return NULL;
 	}
 	/* Update buffer size if readahead has changed. */
-	if (new_ibuf->start_capacity != iproto_readahead) {
+	if (new_ibuf->start_capacity != con->readahead) {
 		ibuf_destroy(new_ibuf);
-		ibuf_create(new_ibuf, cord_slab_cache(), iproto_readahead);
+		ibuf_create(new_ibuf, cord_slab_cache(), con->readahead);
 	}
 
 	ibuf_reserve_xc(new_ibuf, to_read + con->parse_size);
@@ -1129,6 +1724,8 @@ err_msgpack:
 		msg->wpos = con->wpos;
 
 		msg->len = reqend - reqstart; /* total request length */
+		iproto_connection_account_request(con, msg->len);
+		msg->recv_time = con->input_time;
 
 		iproto_msg_decode(msg, &pos, reqend, &stop_input);
 
@@ -1146,6 +1743,7 @@ err_msgpack:
 			 * This can't throw, but should not be
 			 * done in case of exception.
 			 */
+			msg->push_time = clock_monotonic();
 			cpipe_push_input(&con->iproto_thread->tx_pipe, &msg->base);
 			n_requests++;
 		}
@@ -1166,6 +1764,7 @@ err_msgpack:
 		 */
 		ev_io_stop(con->loop, &con->output);
 		ev_io_stop(con->loop, &con->input);
+		ev_timer_stop(con->loop, &con->coalesce_timer);
 	} else if (n_requests != 1 || con->parse_size != 0) {
 		/*
 		 * Keep reading input, as long as the socket
@@ -1287,11 +1886,20 @@ iproto_connection_on_input(ev_loop *loop, struct ev_io *watcher,
 			      IPROTO_RECEIVED, nrd);
 
 		/* Update the read position and connection state. */
+		con->input_time = clock_monotonic();
 		in->wpos += nrd;
 		con->parse_size += nrd;
 		/* Enqueue all requests which are fully read up. */
 		if (iproto_enqueue_batch(con, in) != 0)
 			diag_raise();
+		/*
+		 * An encrypted stream may hold decrypted data that
+		 * didn't fit in the buffer, the fd won't become
+		 * readable for it.
+		 */
+		if (iostream_pending(io) > 0 &&
+		    rlist_empty(&con->in_stop_list))
+			ev_feed_event(loop, &con->input, EV_CUSTOM);
 	} catch (Exception *e) {
 		/* Best effort at sending the error message to the client. */
 		iproto_write_error(io, e, ::schema_version, 0);
@@ -1300,27 +1908,160 @@ iproto_connection_on_input(ev_loop *loop, struct ev_io *watcher,
 	}
 }
 
+/**
+ * writev() the tuples of the first zero-copy result set in the
+ * queue to the socket. The result set is released once it has
+ * been written completely.
+ */
+static int
+iproto_flush_select_zc(struct iproto_connection *con)
+{
+	struct iproto_select_zc *zc =
+		stailq_first_entry(&con->select_zc_queue,
+				   struct iproto_select_zc, in_queue);
+	if (!con->can_write) {
+		/* Receiving end was closed. Discard the output. */
+		goto done;
+	}
+	struct iovec iov[IPROTO_SELECT_ZC_IOV_MAX];
+	int iovcnt;
+	size_t total;
+	size_t offset;
+	ssize_t nwr;
+	if (zc->buf != NULL) {
+		nwr = iostream_write(&con->io, zc->buf + zc->offset,
+				     zc->buf_size - zc->offset);
+		if (nwr == IOSTREAM_ERROR) {
+			diag_log();
+			con->can_write = false;
+			goto done;
+		}
+		if (nwr < 0)
+			return nwr;
+		rmean_collect(con->iproto_thread->rmean, IPROTO_SENT, nwr);
+		zc->offset += nwr;
+		if (zc->offset < zc->buf_size)
+			return IOSTREAM_WANT_WRITE;
+		goto done;
+	}
+	iovcnt = 0;
+	total = 0;
+	offset = zc->offset;
+	for (struct port_c_entry *pe = zc->pos;
+	     pe != NULL && iovcnt < IPROTO_SELECT_ZC_IOV_MAX; pe = pe->next) {
+		uint32_t size;
+		const char *data = iproto_select_zc_entry_data(pe, &size);
+		iov[iovcnt].iov_base = (void *)(data + offset);
+		iov[iovcnt].iov_len = size - offset;
+		total += size - offset;
+		offset = 0;
+		iovcnt++;
+	}
+	nwr = iostream_writev(&con->io, iov, iovcnt);
+	if (nwr == IOSTREAM_ERROR) {
+		/* See the comment in iproto_flush(). */
+		diag_log();
+		con->can_write = false;
+		goto done;
+	}
+	if (nwr < 0)
+		return nwr;
+	rmean_collect(con->iproto_thread->rmean, IPROTO_SENT, nwr);
+	for (size_t left = nwr; left > 0; ) {
+		uint32_t size;
+		iproto_select_zc_entry_data(zc->pos, &size);
+		size_t len = size - zc->offset;
+		if (left < len) {
+			zc->offset += left;
+			break;
+		}
+		left -= len;
+		zc->offset = 0;
+		zc->pos = zc->pos->next;
+	}
+	if (zc->pos != NULL)
+		return (size_t)nwr == total ? 0 : IOSTREAM_WANT_WRITE;
+done:
+	stailq_shift(&con->select_zc_queue);
+	iproto_select_zc_release(con, zc);
+	return 0;
+}
+
+/**
+ * write() the first notification in the queue to the socket. The
+ * notification is freed once it has been written completely.
+ */
+static int
+iproto_flush_event(struct iproto_connection *con)
+{
+	struct iproto_event_entry *entry =
+		rlist_first_entry(&con->event_queue,
+				  struct iproto_event_entry, in_queue);
+	struct iproto_event *event = entry->event;
+	if (con->can_write) {
+		ssize_t nwr = iostream_write(&con->io,
+					     event->data + entry->offset,
+					     event->size - entry->offset);
+		if (nwr == IOSTREAM_ERROR) {
+			/* See the comment in iproto_flush(). */
+			diag_log();
+			con->can_write = false;
+		} else if (nwr < 0) {
+			return nwr;
+		} else {
+			rmean_collect(con->iproto_thread->rmean,
+				      IPROTO_SENT, nwr);
+			entry->offset += nwr;
+			if (entry->offset < event->size)
+				return IOSTREAM_WANT_WRITE;
+		}
+	}
+	rlist_del(&entry->in_queue);
+	iproto_event_entry_delete(entry);
+	return 0;
+}
+
 /** writev() to the socket and handle the result. */
 static int
 iproto_flush(struct iproto_connection *con)
 {
+	/* Finish a partially written notification first. */
+	if (!rlist_empty(&con->event_queue) &&
+	    rlist_first_entry(&con->event_queue, struct iproto_event_entry,
+			      in_queue)->offset > 0)
+		return iproto_flush_event(con);
+	/*
+	 * If there's a zero-copy result set pending, flush the
+	 * buffer only up to its header, because the tuples must
+	 * follow the header on the wire.
+	 */
+	struct iproto_wpos *wend = &con->wend;
+	if (!stailq_empty(&con->select_zc_queue)) {
+		wend = &stailq_first_entry(&con->select_zc_queue,
+					   struct iproto_select_zc,
+					   in_queue)->wpos;
+	}
 	struct obuf *obuf = con->wpos.obuf;
 	struct obuf_svp obuf_end = obuf_create_svp(obuf);
 	struct obuf_svp *begin = &con->wpos.svp;
-	struct obuf_svp *end = &con->wend.svp;
-	if (con->wend.obuf != obuf) {
+	struct obuf_svp *end = &wend->svp;
+	if (wend->obuf != obuf) {
 		/*
 		 * Flush the current buffer before
 		 * advancing to the next one.
 		 */
 		if (begin->used == obuf_end.used) {
-			obuf = con->wpos.obuf = con->wend.obuf;
+			obuf = con->wpos.obuf = wend->obuf;
 			obuf_svp_reset(begin);
 		} else {
 			end = &obuf_end;
 		}
 	}
 	if (begin->used == end->used) {
+		if (wend != &con->wend)
+			return iproto_flush_select_zc(con);
+		if (!rlist_empty(&con->event_queue))
+			return iproto_flush_event(con);
 		/* Nothing to do. */
 		return 1;
 	}
@@ -1379,6 +2120,7 @@ iproto_connection_on_output(ev_loop *loop, struct ev_io *watcher,
 {
 	struct iproto_connection *con = (struct iproto_connection *) watcher->data;
 	assert(con->state == IPROTO_CONNECTION_ALIVE);
+	ev_timer_stop(loop, &con->coalesce_timer);
 	int rc;
 	while ((rc = iproto_flush(con)) <= 0) {
 		if (rc != 0) {
@@ -1397,7 +2139,8 @@ iproto_connection_on_output(ev_loop *loop, struct ev_io *watcher,
 }
 
 static struct iproto_connection *
-iproto_connection_new(struct iproto_thread *iproto_thread, int fd)
+iproto_connection_new(struct iproto_thread *iproto_thread,
+		      struct iostream *io)
 {
 	struct iproto_connection *con = (struct iproto_connection *)
 		mempool_alloc(&iproto_thread->iproto_connection_pool);
@@ -1409,11 +2152,21 @@ iproto_connection_new(struct iproto_thread *iproto_thread, int fd)
 	con->iproto_thread = iproto_thread;
 	con->input.data = con->output.data = con;
 	con->loop = loop();
-	iostream_create(&con->io, fd);
+	iostream_move(&con->io, io);
+	int fd = con->io.fd;
 	ev_io_init(&con->input, iproto_connection_on_input, fd, EV_READ);
 	ev_io_init(&con->output, iproto_connection_on_output, fd, EV_WRITE);
-	ibuf_create(&con->ibuf[0], cord_slab_cache(), iproto_readahead);
-	ibuf_create(&con->ibuf[1], cord_slab_cache(), iproto_readahead);
+	ev_timer_init(&con->coalesce_timer, iproto_connection_on_coalesce_timer,
+		      0, 0);
+	con->coalesce_timer.data = con;
+	/*
+	 * Start with the smallest buffers, they grow if
+	 * the client sends big requests or many of them.
+	 */
+	con->readahead = iproto_readahead_fit(0);
+	con->avg_request_size = 0;
+	ibuf_create(&con->ibuf[0], cord_slab_cache(), con->readahead);
+	ibuf_create(&con->ibuf[1], cord_slab_cache(), con->readahead);
 	obuf_create(&con->obuf[0], &con->iproto_thread->net_slabc,
 		    iproto_readahead);
 	obuf_create(&con->obuf[1], &con->iproto_thread->net_slabc,
@@ -1422,6 +2175,9 @@ iproto_connection_new(struct iproto_thread *iproto_thread, int fd)
 	con->tx.p_obuf = &con->obuf[0];
 	iproto_wpos_create(&con->wpos, con->tx.p_obuf);
 	iproto_wpos_create(&con->wend, con->tx.p_obuf);
+	stailq_create(&con->select_zc_queue);
+	rlist_create(&con->event_queue);
+	rlist_create(&con->tx.events);
 	con->parse_size = 0;
 	con->can_write = true;
 	con->long_poll_count = 0;
@@ -1443,6 +2199,9 @@ iproto_connection_delete(struct iproto_connection *con)
 {
 	assert(iproto_connection_is_idle(con));
 	assert(!iostream_is_initialized(&con->io));
+	assert(stailq_empty(&con->select_zc_queue));
+	assert(rlist_empty(&con->event_queue));
+	assert(rlist_empty(&con->tx.events));
 	assert(con->session == NULL);
 	assert(con->state == IPROTO_CONNECTION_DESTROYED);
 	/*
@@ -1477,6 +2236,12 @@ tx_process1(struct cmsg *msg);
 static void
 tx_process_select(struct cmsg *msg);
 
+static void
+tx_process_select_batch(struct cmsg *msg);
+
+static void
+tx_process_many(struct cmsg *msg);
+
 static void
 tx_process_sql(struct cmsg *msg);
 
@@ -1516,10 +2281,14 @@ iproto_msg_decode(struct iproto_msg *msg, const char **pos, const char *reqend,
 	assert(*pos == reqend);
 
 	type = msg->header.type;
+	TT_PROBE(iproto_msg_decode, msg, type, msg->header.sync);
 	stream_id = msg->header.stream_id;
 	request_is_not_for_stream =
 		((type > IPROTO_TYPE_STAT_MAX &&
-		 type != IPROTO_PING) || type == IPROTO_AUTH);
+		 type != IPROTO_PING && type != IPROTO_SELECT_BATCH &&
+		 type != IPROTO_INSERT_BATCH &&
+		 type != IPROTO_REPLACE_BATCH) ||
+		 type == IPROTO_AUTH);
 	request_is_only_for_stream =
 		(type == IPROTO_BEGIN ||
 		 type == IPROTO_COMMIT ||
@@ -1560,6 +2329,23 @@ iproto_msg_decode(struct iproto_msg *msg, const char **pos, const char *reqend,
 		              sizeof(*(iproto_thread->dml_route)));
 		cmsg_init(&msg->base, iproto_thread->dml_route[type]);
 		break;
+	case IPROTO_SELECT_BATCH:
+		if (xrow_decode_dml(&msg->header, &msg->dml,
+				    iproto_key_bit(IPROTO_SPACE_ID) |
+				    iproto_key_bit(IPROTO_KEY)) != 0)
+			goto error;
+		msg->dml.header = NULL;
+		cmsg_init(&msg->base, iproto_thread->select_batch_route);
+		break;
+	case IPROTO_INSERT_BATCH:
+	case IPROTO_REPLACE_BATCH:
+		if (xrow_decode_dml(&msg->header, &msg->dml,
+				    iproto_key_bit(IPROTO_SPACE_ID) |
+				    iproto_key_bit(IPROTO_TUPLE)) != 0)
+			goto error;
+		msg->dml.header = NULL;
+		cmsg_init(&msg->base, iproto_thread->process_many_route);
+		break;
 	case IPROTO_BEGIN:
 		if (xrow_decode_begin(&msg->header, &msg->begin) != 0)
 			goto error;
@@ -1646,6 +2432,8 @@ tx_fiber_init(struct session *session, uint64_t sync)
 	 */
 	assert(rlist_empty(&f->on_stop));
 	f->storage.net.sync = sync;
+	f->storage.net.wal_wait = 0;
+	f->storage.net.limbo_wait = 0;
 	/*
 	 * We do not cleanup fiber keys at the end of each request.
 	 * This does not lead to privilege escalation as long as
@@ -1706,6 +2494,11 @@ tx_process_disconnect(struct cmsg *m)
 		 * closed, its push() method is replaced with a stub.
 		 */
 		con->tx.is_push_pending = false;
+		/*
+		 * Watchers were unregistered by session_close(), drop
+		 * the notifications that haven't left tx.
+		 */
+		tx_discard_events(con);
 		if (! rlist_empty(&session_on_disconnect)) {
 			tx_fiber_init(con->session, 0);
 			session_run_on_disconnect_triggers(con->session);
@@ -1768,6 +2561,28 @@ tx_check_schema(uint32_t new_schema_version)
 	return 0;
 }
 
+/**
+ * Check that the request hasn't waited for processing longer than
+ * the timeout set by the client in IPROTO_REQUEST_TIMEOUT. The client
+ * has most likely given up on such a request, so its result would be
+ * dropped anyway, and processing it would only delay the requests
+ * queued after it.
+ */
+static int
+tx_check_deadline(struct iproto_msg *msg)
+{
+	double timeout = msg->header.timeout;
+	if (timeout <= 0 || msg->recv_time == 0)
+		return 0;
+	double waited = msg->accept_time - msg->recv_time;
+	if (waited <= timeout)
+		return 0;
+	rmean_collect(msg->connection->iproto_thread->tx.rmean,
+		      REQUESTS_EXPIRED, 1);
+	diag_set(ClientError, ER_REQUEST_EXPIRED, waited, timeout);
+	return -1;
+}
+
 static void
 net_discard_input(struct cmsg *m)
 {
@@ -1853,6 +2668,8 @@ static inline struct iproto_msg *
 tx_accept_msg(struct cmsg *m)
 {
 	struct iproto_msg *msg = (struct iproto_msg *) m;
+	TT_PROBE(tx_process_begin, msg, msg->header.type, msg->header.sync);
+	msg->accept_time = clock_monotonic();
 	tx_accept_wpos(msg->connection, &msg->wpos);
 	tx_fiber_init(msg->connection->session, msg->header.sync);
 	tx_prepare_transaction_for_request(msg);
@@ -1862,9 +2679,78 @@ tx_accept_msg(struct cmsg *m)
 	return msg;
 }
 
+/**
+ * Log a request that took longer than iproto_slow_request_threshold
+ * with the time it spent at each stage. For data manipulation
+ * requests also log the space, the index and the key or the tuple,
+ * truncated.
+ */
+static void
+tx_log_slow_request(struct iproto_msg *msg, double now)
+{
+	const struct fiber *f = fiber();
+	double wal_wait = f->storage.net.wal_wait;
+	double limbo_wait = f->storage.net.limbo_wait;
+	uint32_t type = msg->header.type;
+	const char *type_name = iproto_type_name(type);
+	if (type_name == NULL)
+		type_name = tt_sprintf("%u", (unsigned)type);
+	char target[160] = "";
+	if (iproto_type_is_dml(type) || type == IPROTO_SELECT_BATCH ||
+	    type == IPROTO_INSERT_BATCH || type == IPROTO_REPLACE_BATCH) {
+		const struct request *req = &msg->dml;
+		const char *data = req->key != NULL ? req->key : req->tuple;
+		char buf[64] = "";
+		if (data != NULL &&
+		    mp_snprint(buf, sizeof(buf), data) >= (int)sizeof(buf))
+			strcpy(buf + sizeof(buf) - 4, "...");
+		snprintf(target, sizeof(target),
+			 " space %u, index %u, %s %s", req->space_id,
+			 req->index_id, req->key != NULL ? "key" : "tuple",
+			 buf);
+	}
+	say_warn("slow request %s%s: total %.3f s, net %.3f s, cbus %.3f s, "
+		 "tx %.3f s, wal %.3f s, sync %.3f s",
+		 type_name, target, now - msg->recv_time,
+		 msg->push_time - msg->recv_time,
+		 msg->accept_time - msg->push_time,
+		 now - msg->accept_time - wal_wait - limbo_wait,
+		 wal_wait, limbo_wait);
+}
+
+/** Account the latency of a request processed by tx. */
+static void
+tx_collect_latency(struct iproto_msg *msg)
+{
+	if (msg->recv_time == 0)
+		return;
+	double now = clock_monotonic();
+	if (iproto_slow_request_threshold > 0 &&
+	    now - msg->recv_time > iproto_slow_request_threshold)
+		tx_log_slow_request(msg, now);
+	uint32_t type = msg->header.type;
+	if (type == IPROTO_SELECT_BATCH)
+		type = IPROTO_SELECT;
+	else if (type == IPROTO_INSERT_BATCH)
+		type = IPROTO_INSERT;
+	else if (type == IPROTO_REPLACE_BATCH)
+		type = IPROTO_REPLACE;
+	if (type >= IPROTO_TYPE_STAT_MAX || iproto_type_strs[type] == NULL)
+		return;
+	struct iproto_latency *latency = &iproto_latencies[type];
+	double wal_wait = fiber()->storage.net.wal_wait;
+	latency_collect(&latency->net, msg->push_time - msg->recv_time);
+	latency_collect(&latency->cbus, msg->accept_time - msg->push_time);
+	latency_collect(&latency->tx, now - msg->accept_time - wal_wait);
+	latency_collect(&latency->wal, wal_wait);
+	latency_collect(&latency->total, now - msg->recv_time);
+}
+
 static inline void
 tx_end_msg(struct iproto_msg *msg)
 {
+	TT_PROBE(tx_process_end, msg, msg->header.type, msg->header.sync);
+	tx_collect_latency(msg);
 	if (msg->stream != NULL) {
 		assert(msg->stream->txn == NULL);
 		msg->stream->txn = txn_detach();
@@ -1987,6 +2873,8 @@ static void
 tx_process1(struct cmsg *m)
 {
 	struct iproto_msg *msg = tx_accept_msg(m);
+	if (tx_check_deadline(msg) != 0)
+		goto error;
 	if (tx_check_schema(msg->header.schema_version))
 		goto error;
 
@@ -2011,44 +2899,220 @@ error:
 	tx_end_msg(msg);
 }
 
+/** Return the size of MessagePack stored in a select result set. */
+static size_t
+tx_select_data_size(struct port *base)
+{
+	struct port_c *port = (struct port_c *)base;
+	size_t total = 0;
+	for (struct port_c_entry *pe = port->first; pe != NULL;
+	     pe = pe->next) {
+		uint32_t size;
+		iproto_select_zc_entry_data(pe, &size);
+		total += size;
+	}
+	return total;
+}
+
+/**
+ * Encode the tuples of a port_c as a SELECT response and take
+ * ownership of the port. Returns -1 and sets diag on error.
+ */
+static int
+tx_reply_select(struct iproto_msg *msg, struct port *port)
+{
+	struct obuf *out = msg->connection->tx.p_obuf;
+	struct obuf_svp svp;
+	if (iproto_prepare_select(out, &svp) != 0) {
+		port_destroy(port);
+		return -1;
+	}
+	size_t data_size = tx_select_data_size(port);
+	if (data_size >= IPROTO_SELECT_ZC_SIZE_MIN) {
+		/*
+		 * Big result set: let the iproto thread send it
+		 * right from the tuples.
+		 */
+		iproto_reply_select_ext(out, &svp, msg->header.sync,
+					::schema_version,
+					((struct port_c *)port)->size,
+					data_size);
+		iproto_wpos_create(&msg->wpos, out);
+		msg->select_zc = iproto_select_zc_new(port);
+		msg->select_zc->wpos = msg->wpos;
+		return 0;
+	}
+	/*
+	 * SELECT output format has not changed since Tarantool 1.6
+	 */
+	int count = port_dump_msgpack_16(port, out);
+	port_destroy(port);
+	if (count < 0) {
+		/* Discard the prepared select. */
+		obuf_rollback_to_svp(out, &svp);
+		return -1;
+	}
+	iproto_reply_select(out, &svp, msg->header.sync,
+			    ::schema_version, count);
+	iproto_wpos_create(&msg->wpos, out);
+	return 0;
+}
+
+/**
+ * Encode the tuples of a port_c as a SELECT response with the
+ * position of the last tuple and take ownership of the port.
+ * The result set is always copied to the output buffer, because
+ * the position goes after it. Returns -1 and sets diag on error.
+ */
+static int
+tx_reply_select_with_position(struct iproto_msg *msg, struct port *port,
+			      const char *packed_pos,
+			      const char *packed_pos_end)
+{
+	struct obuf *out = msg->connection->tx.p_obuf;
+	struct obuf_svp svp;
+	if (iproto_prepare_select(out, &svp) != 0) {
+		port_destroy(port);
+		return -1;
+	}
+	int count = port_dump_msgpack_16(port, out);
+	port_destroy(port);
+	if (count < 0)
+		goto error;
+	if (packed_pos == NULL) {
+		iproto_reply_select(out, &svp, msg->header.sync,
+				    ::schema_version, count);
+	} else if (iproto_reply_select_with_position(out, &svp,
+						     msg->header.sync,
+						     ::schema_version, count,
+						     packed_pos,
+						     packed_pos_end) != 0) {
+		goto error;
+	}
+	iproto_wpos_create(&msg->wpos, out);
+	return 0;
+error:
+	/* Discard the prepared select. */
+	obuf_rollback_to_svp(out, &svp);
+	return -1;
+}
+
 static void
 tx_process_select(struct cmsg *m)
 {
 	struct iproto_msg *msg = tx_accept_msg(m);
-	struct obuf *out;
-	struct obuf_svp svp;
 	struct port port;
-	int count;
+	struct snapshot_iterator *read_view;
 	int rc;
 	struct request *req = &msg->dml;
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	const char *packed_pos = req->after_position;
+	const char *packed_pos_end = req->after_position_end;
+	if (tx_check_deadline(msg) != 0)
+		goto error;
 	if (tx_check_schema(msg->header.schema_version))
 		goto error;
 
 	tx_inject_delay();
+	if (req->after_tuple != NULL) {
+		if (box_index_tuple_position(req->space_id, req->index_id,
+					     req->after_tuple,
+					     req->after_tuple_end,
+					     &packed_pos,
+					     &packed_pos_end) != 0)
+			goto error;
+	}
+	if (packed_pos != NULL || req->fetch_position) {
+		rc = box_select(req->space_id, req->index_id,
+				req->iterator, req->offset, req->limit,
+				req->key, req->key_end, &packed_pos,
+				&packed_pos_end, req->fetch_position, &port);
+		if (rc < 0)
+			goto error;
+		if (req->fetch_position)
+			rc = tx_reply_select_with_position(msg, &port,
+							   packed_pos,
+							   packed_pos_end);
+		else
+			rc = tx_reply_select(msg, &port);
+		if (rc != 0)
+			goto error;
+		region_truncate(region, region_svp);
+		tx_end_msg(msg);
+		return;
+	}
+	if (box_select_read_view(req->space_id, req->index_id, req->iterator,
+				 req->key, req->key_end, &read_view) != 0)
+		goto error;
+	if (read_view != NULL) {
+		/* The iproto thread will read the result set. */
+		msg->select_zc = iproto_select_zc_new_read_view(
+			read_view, ::schema_version);
+		iproto_wpos_create(&msg->wpos, msg->connection->tx.p_obuf);
+		msg->select_zc->wpos = msg->wpos;
+		tx_end_msg(msg);
+		return;
+	}
 	rc = box_select(req->space_id, req->index_id,
 			req->iterator, req->offset, req->limit,
-			req->key, req->key_end, &port);
+			req->key, req->key_end, NULL, NULL, false, &port);
 	if (rc < 0)
 		goto error;
+	if (tx_reply_select(msg, &port) != 0)
+		goto error;
+	tx_end_msg(msg);
+	return;
+error:
+	region_truncate(region, region_svp);
+	tx_reply_error(msg);
+	tx_end_msg(msg);
+}
+
+static void
+tx_process_select_batch(struct cmsg *m)
+{
+	struct iproto_msg *msg = tx_accept_msg(m);
+	struct request *req = &msg->dml;
+	struct port port;
+	if (tx_check_deadline(msg) != 0)
+		goto error;
+	if (tx_check_schema(msg->header.schema_version))
+		goto error;
 
-	out = msg->connection->tx.p_obuf;
-	if (iproto_prepare_select(out, &svp) != 0) {
-		port_destroy(&port);
+	tx_inject_delay();
+	if (box_index_get_many(req->space_id, req->index_id, req->key,
+			       req->key_end, &port) != 0)
 		goto error;
-	}
-	/*
-	 * SELECT output format has not changed since Tarantool 1.6
-	 */
-	count = port_dump_msgpack_16(&port, out);
-	port_destroy(&port);
-	if (count < 0) {
-		/* Discard the prepared select. */
-		obuf_rollback_to_svp(out, &svp);
+	if (tx_reply_select(msg, &port) != 0)
 		goto error;
-	}
-	iproto_reply_select(out, &svp, msg->header.sync,
-			    ::schema_version, count);
-	iproto_wpos_create(&msg->wpos, out);
+	tx_end_msg(msg);
+	return;
+error:
+	tx_reply_error(msg);
+	tx_end_msg(msg);
+}
+
+static void
+tx_process_many(struct cmsg *m)
+{
+	struct iproto_msg *msg = tx_accept_msg(m);
+	struct request *req = &msg->dml;
+	uint16_t type = msg->header.type == IPROTO_INSERT_BATCH ?
+			IPROTO_INSERT : IPROTO_REPLACE;
+	if (tx_check_deadline(msg) != 0)
+		goto error;
+	if (tx_check_schema(msg->header.schema_version))
+		goto error;
+
+	tx_inject_delay();
+	if (box_process_many(req->space_id, type, req->tuple,
+			     req->tuple_end) != 0)
+		goto error;
+	if (iproto_reply_ok(msg->connection->tx.p_obuf, msg->header.sync,
+			    ::schema_version) != 0)
+		goto error;
+	iproto_wpos_create(&msg->wpos, msg->connection->tx.p_obuf);
 	tx_end_msg(msg);
 	return;
 error:
@@ -2067,10 +3131,52 @@ tx_process_call_on_yield(struct trigger *trigger, void *event)
 	return 0;
 }
 
+/**
+ * Send a big result set of a C function stored in a C port the
+ * same way as a big select result set: let the iproto thread send
+ * it right from the port entries. Takes ownership of the port.
+ * Returns -1 and sets diag on error.
+ */
+static int
+tx_reply_call_zc(struct iproto_msg *msg, struct port *port, size_t data_size)
+{
+	struct obuf *out = msg->connection->tx.p_obuf;
+	struct obuf_svp svp;
+	if (iproto_prepare_select(out, &svp) != 0) {
+		port_destroy(port);
+		return -1;
+	}
+	uint32_t count = ((struct port_c *)port)->size;
+	if (msg->header.type == IPROTO_CALL) {
+		/*
+		 * Unlike CALL_16, CALL returns all the values in
+		 * one array, see port_c_dump_msgpack().
+		 */
+		size_t size = mp_sizeof_array(count);
+		char *pos = (char *)obuf_alloc(out, size);
+		if (pos == NULL) {
+			diag_set(OutOfMemory, size, "obuf_alloc", "pos");
+			obuf_rollback_to_svp(out, &svp);
+			port_destroy(port);
+			return -1;
+		}
+		mp_encode_array(pos, count);
+		count = 1;
+	}
+	iproto_reply_select_ext(out, &svp, msg->header.sync, ::schema_version,
+				count, data_size);
+	iproto_wpos_create(&msg->wpos, out);
+	msg->select_zc = iproto_select_zc_new(port);
+	msg->select_zc->wpos = msg->wpos;
+	return 0;
+}
+
 static void
 tx_process_call(struct cmsg *m)
 {
 	struct iproto_msg *msg = tx_accept_msg(m);
+	if (tx_check_deadline(msg) != 0)
+		goto error;
 	if (tx_check_schema(msg->header.schema_version))
 		goto error;
 
@@ -2128,6 +3234,16 @@ tx_process_call(struct cmsg *m)
 	struct obuf *out;
 	struct obuf_svp svp;
 
+	if (port.vtab == &port_c_vtab) {
+		size_t data_size = tx_select_data_size(&port);
+		if (data_size >= IPROTO_SELECT_ZC_SIZE_MIN) {
+			if (tx_reply_call_zc(msg, &port, data_size) != 0)
+				goto error;
+			tx_end_msg(msg);
+			return;
+		}
+	}
+
 	out = msg->connection->tx.p_obuf;
 	if (iproto_prepare_select(out, &svp) != 0) {
 		port_destroy(&port);
@@ -2157,7 +3273,8 @@ error:
 static void
 iproto_session_notify(struct session *session,
 		      const char *key, size_t key_len,
-		      const char *data, const char *data_end);
+		      const char *data, const char *data_end,
+		      uint64_t version);
 
 static void
 tx_process_misc(struct cmsg *m)
@@ -2233,6 +3350,8 @@ tx_process_sql(struct cmsg *m)
 	uint32_t len;
 	bool is_unprepare = false;
 
+	if (tx_check_deadline(msg) != 0)
+		goto error;
 	if (tx_check_schema(msg->header.schema_version))
 		goto error;
 	assert(msg->header.type == IPROTO_EXECUTE ||
@@ -2410,6 +3529,7 @@ iproto_msg_finish_processing_in_stream(struct iproto_msg *msg)
 		assert(stream->current != NULL);
 		stream->current->wpos = con->wpos;
 		con->iproto_thread->requests_in_stream_queue--;
+		stream->current->push_time = clock_monotonic();
 		cpipe_push_input(&con->iproto_thread->tx_pipe,
 				 &stream->current->base);
 		cpipe_flush_input(&con->iproto_thread->tx_pipe);
@@ -2431,10 +3551,27 @@ net_send_msg(struct cmsg *m)
 		assert(con->long_poll_count > 0);
 		con->long_poll_count--;
 	}
+	if (msg->select_zc != NULL) {
+		bool is_alive = con->state == IPROTO_CONNECTION_ALIVE;
+		if (msg->select_zc->read_view != NULL) {
+			iproto_select_zc_read(con, msg->select_zc,
+					      is_alive ? &msg->dml : NULL,
+					      msg->header.sync);
+		}
+		if (is_alive) {
+			stailq_add_tail_entry(&con->select_zc_queue,
+					      msg->select_zc, in_queue);
+		} else {
+			iproto_select_zc_release(con, msg->select_zc);
+		}
+	}
 	con->wend = msg->wpos;
 
+	if (con->state == IPROTO_CONNECTION_ALIVE &&
+	    ibuf_used(&con->ibuf[0]) == 0 && ibuf_used(&con->ibuf[1]) == 0)
+		iproto_connection_release_input(con);
 	if (con->state == IPROTO_CONNECTION_ALIVE) {
-		iproto_connection_feed_output(con);
+		iproto_connection_schedule_output(con);
 	} else if (iproto_connection_is_idle(con)) {
 		iproto_connection_close(con);
 	}
@@ -2565,7 +3702,7 @@ net_send_greeting(struct cmsg *m)
  * Create a connection and start input.
  */
 static int
-iproto_on_accept(struct evio_service *service, int fd,
+iproto_on_accept(struct evio_service *service, struct iostream *io,
 		 struct sockaddr *addr, socklen_t addrlen)
 {
 	(void) addr;
@@ -2574,8 +3711,17 @@ iproto_on_accept(struct evio_service *service, int fd,
 
 	struct iproto_thread *iproto_thread =
 		(struct iproto_thread *)service->on_accept_param;
+#ifdef SO_BUSY_POLL
+	if (iproto_busy_poll > 0) {
+		int usec = iproto_busy_poll;
+		if (setsockopt(io->fd, SOL_SOCKET, SO_BUSY_POLL,
+			       &usec, sizeof(usec)) != 0)
+			say_warn_ratelimited("failed to set SO_BUSY_POLL: %s",
+					     strerror(errno));
+	}
+#endif
 	struct iproto_connection *con =
-		iproto_connection_new(iproto_thread, fd);
+		iproto_connection_new(iproto_thread, io);
 	if (con == NULL)
 		return -1;
 	/*
@@ -2585,6 +3731,8 @@ iproto_on_accept(struct evio_service *service, int fd,
 	 */
 	msg = iproto_msg_new(con);
 	if (msg == NULL) {
+		/* Give the stream back to be destroyed by the caller. */
+		iostream_move(io, &con->io);
 		mempool_free(&con->iproto_thread->iproto_connection_pool, con);
 		return -1;
 	}
@@ -2595,6 +3743,18 @@ iproto_on_accept(struct evio_service *service, int fd,
 	return 0;
 }
 
+/**
+ * Does nothing. An active idle watcher makes the event loop poll
+ * for events without blocking, see iproto_busy_poll.
+ */
+static void
+iproto_busy_poll_cb(ev_loop *loop, ev_idle *watcher, int events)
+{
+	(void)loop;
+	(void)watcher;
+	(void)events;
+}
+
 /**
  * The network io thread main function:
  * begin serving the message bus.
@@ -2627,9 +3787,16 @@ net_cord_f(va_list  ap)
 	cpipe_create(&iproto_thread->tx_pipe, "tx");
 	cpipe_set_max_input(&iproto_thread->tx_pipe, iproto_msg_max / 2);
 
+	struct ev_idle busy_poll;
+	ev_idle_init(&busy_poll, iproto_busy_poll_cb);
+	if (iproto_busy_poll > 0)
+		ev_idle_start(loop(), &busy_poll);
+
 	/* Process incomming messages. */
 	cbus_loop(&endpoint);
 
+	ev_idle_stop(loop(), &busy_poll);
+
 	cpipe_destroy(&iproto_thread->tx_pipe);
 	/*
 	 * Nothing to do in the fiber so far, the service
@@ -2735,25 +3902,119 @@ iproto_session_push(struct session *session, struct port *port)
 	return 0;
 }
 
+/** }}} */
+
+/** {{{ IPROTO_EVENT implementation. */
+
+/**
+ * The last encoded notification. A key update runs the watchers of
+ * all sessions one after another, so they all reuse this packet.
+ */
+static struct iproto_event *tx_last_event;
+
+/** Return the packet for the given key data, encoding it if needed. */
+static struct iproto_event *
+tx_get_event(const char *key, size_t key_len,
+	     const char *data, const char *data_end, uint64_t version)
+{
+	struct iproto_event *event = tx_last_event;
+	if (event != NULL && event->version == version &&
+	    event->key_len == key_len &&
+	    memcmp(event->key, key, key_len) == 0)
+		return event;
+	if (event != NULL)
+		iproto_event_unref(event);
+	tx_last_event = iproto_event_new(key, key_len, data, data_end,
+					 version);
+	return tx_last_event;
+}
+
+static void
+net_deliver_events(struct cmsg *m)
+{
+	struct iproto_event_msg *msg = (struct iproto_event_msg *)m;
+	struct iproto_event_entry *entry, *tmp;
+	rlist_foreach_entry_safe(entry, &msg->entries, in_queue, tmp) {
+		struct iproto_connection *con = entry->con;
+		rlist_del(&entry->in_queue);
+		/*
+		 * The connection can't be deleted yet, because its
+		 * destroy message follows this one, but it may be
+		 * closed already.
+		 */
+		if (con->state != IPROTO_CONNECTION_ALIVE) {
+			iproto_event_entry_delete(entry);
+			continue;
+		}
+		rlist_add_tail_entry(&con->event_queue, entry, in_queue);
+		iproto_connection_feed_output(con);
+	}
+}
+
+/** Send the notifications queued for an iproto thread. */
+static void
+tx_begin_events(struct iproto_thread *iproto_thread)
+{
+	assert(!iproto_thread->tx.is_event_msg_sent);
+	struct iproto_event_msg *msg = &iproto_thread->event_msg;
+	cmsg_init(&msg->base, iproto_thread->event_route);
+	rlist_create(&msg->entries);
+	struct iproto_event_entry *entry;
+	rlist_foreach_entry(entry, &iproto_thread->tx.event_queue, in_queue)
+		rlist_del(&entry->in_con);
+	rlist_splice_tail(&msg->entries, &iproto_thread->tx.event_queue);
+	iproto_thread->tx.is_event_msg_sent = true;
+	cpipe_push(&iproto_thread->net_pipe, &msg->base);
+}
+
+static void
+tx_end_events(struct cmsg *m)
+{
+	struct iproto_event_msg *msg = (struct iproto_event_msg *)m;
+	struct iproto_thread *iproto_thread =
+		container_of(msg, struct iproto_thread, event_msg);
+	assert(rlist_empty(&msg->entries));
+	iproto_thread->tx.is_event_msg_sent = false;
+	if (!rlist_empty(&iproto_thread->tx.event_queue))
+		tx_begin_events(iproto_thread);
+}
+
+/** Free the notifications of a connection that haven't been sent. */
+static void
+tx_discard_events(struct iproto_connection *con)
+{
+	struct iproto_event_entry *entry, *tmp;
+	rlist_foreach_entry_safe(entry, &con->tx.events, in_con, tmp) {
+		rlist_del(&entry->in_queue);
+		rlist_del(&entry->in_con);
+		iproto_event_entry_delete(entry);
+	}
+}
+
 /**
  * Sends a notification to a remote watcher when a key is updated.
- * Uses IPROTO_PUSH (kharon) infrastructure to signal the iproto thread
- * about new data.
+ *
+ * The packet is encoded once per key update and shared by all the
+ * connections, see tx_get_event(). The notifications are passed to
+ * each iproto thread in batches, see iproto_event_msg, and written
+ * to the sockets there.
  */
 static void
 iproto_session_notify(struct session *session,
 		      const char *key, size_t key_len,
-		      const char *data, const char *data_end)
+		      const char *data, const char *data_end,
+		      uint64_t version)
 {
 	struct iproto_connection *con =
 		(struct iproto_connection *)session->meta.connection;
-	if (iproto_send_event(con->tx.p_obuf, key, key_len,
-			      data, data_end) != 0) {
-		/* Nothing we can do on error but log the error. */
-		diag_log();
-		return;
-	}
-	tx_push(con);
+	struct iproto_thread *iproto_thread = con->iproto_thread;
+	struct iproto_event *event = tx_get_event(key, key_len, data,
+						  data_end, version);
+	struct iproto_event_entry *entry = iproto_event_entry_new(event, con);
+	rlist_add_tail_entry(&iproto_thread->tx.event_queue, entry, in_queue);
+	rlist_add_tail_entry(&con->tx.events, entry, in_con);
+	if (!iproto_thread->tx.is_event_msg_sent)
+		tx_begin_events(iproto_thread);
 }
 
 /** }}} */
@@ -2795,6 +4056,12 @@ iproto_thread_init_routes(struct iproto_thread *iproto_thread)
 	iproto_thread->select_route[0] =
 		{ tx_process_select, &iproto_thread->net_pipe };
 	iproto_thread->select_route[1] = { net_send_msg, NULL };
+	iproto_thread->select_batch_route[0] =
+		{ tx_process_select_batch, &iproto_thread->net_pipe };
+	iproto_thread->select_batch_route[1] = { net_send_msg, NULL };
+	iproto_thread->process_many_route[0] =
+		{ tx_process_many, &iproto_thread->net_pipe };
+	iproto_thread->process_many_route[1] = { net_send_msg, NULL };
 	iproto_thread->process1_route[0] =
 		{ tx_process1, &iproto_thread->net_pipe };
 	iproto_thread->process1_route[1] = { net_send_msg, NULL };
@@ -2813,6 +4080,9 @@ iproto_thread_init_routes(struct iproto_thread *iproto_thread)
 	iproto_thread->push_route[0] =
 		{ iproto_process_push, &iproto_thread->tx_pipe };
 	iproto_thread->push_route[1] = { tx_end_push, NULL };
+	iproto_thread->event_route[0] =
+		{ net_deliver_events, &iproto_thread->tx_pipe };
+	iproto_thread->event_route[1] = { tx_end_events, NULL };
 	/* IPROTO_OK */
 	iproto_thread->dml_route[0] = NULL;
 	/* IPROTO_SELECT */
@@ -2860,6 +4130,8 @@ iproto_thread_init(struct iproto_thread *iproto_thread)
 		goto fail;
 	rlist_create(&iproto_thread->stopped_connections);
 	iproto_thread->tx.requests_in_progress = 0;
+	rlist_create(&iproto_thread->tx.event_queue);
+	iproto_thread->tx.is_event_msg_sent = false;
 	iproto_thread->requests_in_stream_queue = 0;
 	return 0;
 fail:
@@ -2871,11 +4143,30 @@ fail:
 	return -1;
 }
 
+/** Call a function for each latency counter of a request type. */
+#define iproto_latency_foreach(latency, func) do {			\
+	func(&(latency)->net);						\
+	func(&(latency)->cbus);						\
+	func(&(latency)->tx);						\
+	func(&(latency)->wal);						\
+	func(&(latency)->total);					\
+} while (0)
+
+static void
+iproto_latency_create(struct latency *latency)
+{
+	if (latency_create(latency) != 0)
+		panic("failed to allocate request latency histogram");
+}
+
 /** Initialize the iproto subsystem and start network io thread */
 void
 iproto_init(int threads_count)
 {
 	iproto_features_init();
+	for (int i = 0; i < IPROTO_TYPE_STAT_MAX; i++)
+		iproto_latency_foreach(&iproto_latencies[i],
+				       iproto_latency_create);
 
 	iproto_threads_count = 0;
 	struct session_vtab iproto_session_vtab = {
@@ -3023,7 +4314,17 @@ iproto_do_cfg_f(struct cbus_call_msg *m)
 			}
 			evio_service_create(loop(), binary, "binary",
 					    iproto_on_accept, iproto_thread);
-			evio_service_attach(binary, cfg_msg->binary);
+			/*
+			 * The first thread listens on the sockets bound
+			 * by tx, others bind their own sockets to the
+			 * addresses with reuseport=true.
+			 */
+			if (iproto_thread->id == 0) {
+				evio_service_attach(binary, cfg_msg->binary);
+			} else if (evio_service_attach_reuse_port(
+					binary, cfg_msg->binary) != 0) {
+				diag_raise();
+			}
 			if (evio_service_listen(binary) != 0)
 				diag_raise();
 			break;
@@ -3084,6 +4385,17 @@ iproto_send_listen_msg(struct evio_service *binary)
 	return 0;
 }
 
+int
+iproto_set_cpu_affinity(const char *cpus)
+{
+	for (int i = 0; i < iproto_threads_count; i++) {
+		if (cord_set_cpu_affinity(&iproto_threads[i].net_cord,
+					  cpus) != 0)
+			return -1;
+	}
+	return 0;
+}
+
 int
 iproto_listen(const struct uri_set *uri_set)
 {
@@ -3148,6 +4460,38 @@ iproto_reset_stat(void)
 		rmean_cleanup(iproto_threads[i].rmean);
 		rmean_cleanup(iproto_threads[i].tx.rmean);
 	}
+	for (int i = 0; i < IPROTO_TYPE_STAT_MAX; i++)
+		iproto_latency_foreach(&iproto_latencies[i], latency_reset);
+}
+
+static void
+iproto_latency_append(struct info_handler *h, const char *name,
+		      struct latency *latency)
+{
+	info_table_begin(h, name);
+	info_append_double(h, "p50", latency_get(latency, 50));
+	info_append_double(h, "p99", latency_get(latency, 99));
+	info_append_double(h, "p999", latency_get(latency, 99.9));
+	info_table_end(h);
+}
+
+void
+iproto_latency_stat(struct info_handler *h)
+{
+	info_begin(h);
+	for (int i = 0; i < IPROTO_TYPE_STAT_MAX; i++) {
+		if (iproto_type_strs[i] == NULL)
+			continue;
+		struct iproto_latency *latency = &iproto_latencies[i];
+		info_table_begin(h, iproto_type_strs[i]);
+		iproto_latency_append(h, "net", &latency->net);
+		iproto_latency_append(h, "cbus", &latency->cbus);
+		iproto_latency_append(h, "tx", &latency->tx);
+		iproto_latency_append(h, "wal", &latency->wal);
+		iproto_latency_append(h, "total", &latency->total);
+		info_table_end(h);
+	}
+	info_end(h);
 }
 
 void
@@ -3185,6 +4529,8 @@ iproto_free(void)
 		slab_cache_destroy(&iproto_threads[i].net_slabc);
 	}
 	free(iproto_threads);
+	for (int i = 0; i < IPROTO_TYPE_STAT_MAX; i++)
+		iproto_latency_foreach(&iproto_latencies[i], latency_destroy);
 
 	/*
 	 * Here we close sockets and unlink all unix socket paths.
@@ -34,6 +34,7 @@
 #include <stddef.h>
 
 struct uri_set;
+struct info_handler;
 
 #if defined(__cplusplus)
 extern "C" {
@@ -74,6 +75,26 @@ struct iproto_stats {
 };
 
 extern unsigned iproto_readahead;
+/**
+ * If not 0, replies to pipelined requests of a connection are
+ * written to the socket when there are this many bytes to write,
+ * the last request in progress is replied to or after
+ * iproto_coalesce_timeout seconds.
+ */
+extern unsigned iproto_coalesce_size;
+extern double iproto_coalesce_timeout;
+/**
+ * If not 0, requests that take longer than this many seconds from
+ * reading from the socket to the end of execution in tx are logged
+ * with the time spent at each stage.
+ */
+extern double iproto_slow_request_threshold;
+/**
+ * If not 0, iproto threads never sleep in the event loop, and
+ * their sockets use SO_BUSY_POLL with this many microseconds.
+ * Must be set before iproto_init().
+ */
+extern unsigned iproto_busy_poll;
 extern int iproto_threads_count;
 
 /**
@@ -95,6 +116,14 @@ iproto_thread_stats_get(struct iproto_stats *stats, int thread_id);
 void
 iproto_reset_stat(void);
 
+/**
+ * Report latency percentiles of requests by type, split into
+ * processing stages: net thread queueing, cbus transit, tx
+ * execution and WAL wait.
+ */
+void
+iproto_latency_stat(struct info_handler *h);
+
 /**
  * Return count of the addresses currently served by iproto.
  */
@@ -128,6 +157,13 @@ iproto_init(int threads_count);
 int
 iproto_listen(const struct uri_set *uri_set);
 
+/**
+ * Pin the iproto threads to the given CPUs, see
+ * cord_set_cpu_affinity().
+ */
+int
+iproto_set_cpu_affinity(const char *cpus);
+
 void
 iproto_set_msg_max(int iproto_msg_max);
 
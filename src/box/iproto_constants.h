@@ -73,6 +73,13 @@ enum iproto_key {
 	IPROTO_TSN = 0x08,
 	IPROTO_FLAGS = 0x09,
 	IPROTO_STREAM_ID = 0x0a,
+	/**
+	 * Time in seconds the client is going to wait for the reply
+	 * to the request, MP_DOUBLE. A request that has waited in the
+	 * server queues for longer than that is not processed and
+	 * fails with ER_REQUEST_EXPIRED, so the client may retry it.
+	 */
+	IPROTO_REQUEST_TIMEOUT = 0x0b,
 	/* Leave a gap for other keys in the header. */
 	IPROTO_SPACE_ID = 0x10,
 	IPROTO_INDEX_ID = 0x11,
@@ -80,6 +87,8 @@ enum iproto_key {
 	IPROTO_OFFSET = 0x13,
 	IPROTO_ITERATOR = 0x14,
 	IPROTO_INDEX_BASE = 0x15,
+	/** Return the position of the last selected tuple. */
+	IPROTO_FETCH_POSITION = 0x1f,
 
 	/* Leave a gap between integer values and other keys */
 	IPROTO_KEY = 0x20,
@@ -104,6 +113,10 @@ enum iproto_key {
 	IPROTO_BALLOT = 0x29,
 	IPROTO_TUPLE_META = 0x2a,
 	IPROTO_OPTIONS = 0x2b,
+	/** Select tuples after the given position. */
+	IPROTO_AFTER_POSITION = 0x2e,
+	/** Select tuples after the given tuple. */
+	IPROTO_AFTER_TUPLE = 0x2f,
 
 	/* Leave a gap between request keys and response keys */
 	IPROTO_DATA = 0x30,
@@ -118,6 +131,8 @@ enum iproto_key {
 	IPROTO_METADATA = 0x32,
 	IPROTO_BIND_METADATA = 0x33,
 	IPROTO_BIND_COUNT = 0x34,
+	/** Position of the last selected tuple. */
+	IPROTO_POSITION = 0x35,
 
 	/* Leave a gap between response keys and SQL keys. */
 	IPROTO_SQL_TEXT = 0x40,
@@ -148,6 +163,19 @@ enum iproto_key {
 	/** Key name and data sent to a remote watcher. */
 	IPROTO_EVENT_KEY = 0x57,
 	IPROTO_EVENT_DATA = 0x58,
+	/**
+	 * Leader lease timestamp. Sent by a relay in heartbeats and echoed
+	 * back by the replica in acks, see box.cfg.election_leader_lease.
+	 */
+	IPROTO_LEASE_TS = 0x59,
+	/**
+	 * Ids of spaces and types of requests a subscriber wants to
+	 * receive rows of. Other DML rows are sent as NOPs, so that
+	 * the subscriber's vclock still advances. Used for change
+	 * data capture consumers that need only a part of the data.
+	 */
+	IPROTO_SPACE_FILTER = 0x5a,
+	IPROTO_TYPE_FILTER = 0x5b,
 	/*
 	 * Be careful to not extend iproto_key values over 0x7f.
 	 * iproto_keys are encoded in msgpack as positive fixnum, which ends at
@@ -231,6 +259,19 @@ enum iproto_type {
 	/** The maximum typecode used for box.stat() */
 	IPROTO_TYPE_STAT_MAX,
 
+	/**
+	 * Look up several keys of a unique index. IPROTO_KEY is
+	 * an array of keys. Accounted as SELECT in box.stat().
+	 */
+	IPROTO_SELECT_BATCH = 20,
+	/**
+	 * Insert or replace several tuples in one transaction.
+	 * IPROTO_TUPLE is an array of tuples. Accounted as INSERT
+	 * or REPLACE in box.stat().
+	 */
+	IPROTO_INSERT_BATCH = 21,
+	IPROTO_REPLACE_BATCH = 22,
+
 	IPROTO_RAFT = 30,
 	/** PROMOTE request. */
 	IPROTO_RAFT_PROMOTE = 31,
@@ -282,6 +323,15 @@ enum iproto_type {
 	IPROTO_WATCH = 74,
 	IPROTO_UNWATCH = 75,
 	IPROTO_EVENT = 76,
+	/**
+	 * A batch of rows compressed with zstd, sent by a relay to
+	 * a replica that supports IPROTO_FEATURE_REPLICATION_COMPRESSION.
+	 * The body is {IPROTO_DATA: MP_BIN}, where the binary is
+	 * a flushed chunk of the zstd stream started on SUBSCRIBE. The
+	 * decompressed data is a sequence of regular packets, each with
+	 * its own fixed header.
+	 */
+	IPROTO_COMPRESSED_ROWS = 77,
 
 	/** Vinyl run info stored in .index file */
 	VY_INDEX_RUN_INFO = 100,
@@ -327,6 +377,12 @@ iproto_type_name(uint16_t type)
 		return iproto_type_strs[type];
 
 	switch (type) {
+	case IPROTO_SELECT_BATCH:
+		return "SELECT_BATCH";
+	case IPROTO_INSERT_BATCH:
+		return "INSERT_BATCH";
+	case IPROTO_REPLACE_BATCH:
+		return "REPLACE_BATCH";
 	case IPROTO_RAFT:
 		return "RAFT";
 	case IPROTO_RAFT_PROMOTE:
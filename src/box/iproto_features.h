@@ -45,6 +45,27 @@ enum iproto_feature_id {
 	 * IPROTO_WATCH, IPROTO_UNWATCH, IPROTO_EVENT commands.
 	 */
 	IPROTO_FEATURE_WATCHERS = 3,
+	/**
+	 * Compressed replication stream: IPROTO_COMPRESSED_ROWS packets.
+	 *
+	 * A replica sets this feature bit in IPROTO_FEATURES of its
+	 * SUBSCRIBE request if it can decompress the stream. The master
+	 * compresses the stream only if the bit is set and
+	 * box.cfg.replication_compression_level is not 0.
+	 */
+	IPROTO_FEATURE_REPLICATION_COMPRESSION = 4,
+	/**
+	 * Select pagination: IPROTO_AFTER_POSITION, IPROTO_AFTER_TUPLE,
+	 * IPROTO_FETCH_POSITION request keys and IPROTO_POSITION
+	 * response key.
+	 */
+	IPROTO_FEATURE_PAGINATION = 5,
+	/**
+	 * Request timeout: IPROTO_REQUEST_TIMEOUT request header key.
+	 * A request that waited in the queue longer than its timeout
+	 * is rejected with ER_REQUEST_EXPIRED without being processed.
+	 */
+	IPROTO_FEATURE_REQUEST_TIMEOUT = 6,
 	iproto_feature_id_MAX,
 };
 
@@ -60,7 +81,7 @@ struct iproto_features {
  * It should be incremented every time a new feature is added or removed.
  */
 enum {
-	IPROTO_CURRENT_VERSION = 3,
+	IPROTO_CURRENT_VERSION = 5,
 };
 
 /**
@@ -34,6 +34,7 @@
 #include <stdbool.h>
 #include "salad/stailq.h"
 #include "fiber.h"
+#include "trivia/probe.h"
 
 #if defined(__cplusplus)
 extern "C" {
@@ -266,7 +267,10 @@ journal_write(struct journal_entry *entry)
 	journal_queue_flush();
 	journal_queue_on_append(entry);
 
-	return current_journal->write(current_journal, entry);
+	TT_PROBE(journal_write_begin, entry, entry->n_rows, entry->approx_len);
+	int rc = current_journal->write(current_journal, entry);
+	TT_PROBE(journal_write_end, entry, rc, entry->res);
+	return rc;
 }
 
 /**
@@ -680,6 +680,15 @@ box_key_def_validate_full_key(const box_key_def_t *key_def, const char *key,
 	return rc;
 }
 
+uint32_t
+box_key_def_bucket_id(box_key_def_t *key_def, const char *key,
+		      uint32_t bucket_count)
+{
+	assert(bucket_count > 0);
+	mp_decode_array(&key);
+	return key_hash(key, key_def) % bucket_count + 1;
+}
+
 /* }}} Module API functions */
 
 int
@@ -714,6 +723,13 @@ key_part_cmp(const struct key_part *parts1, uint32_t part_count1,
 	return part_count1 < part_count2 ? -1 : part_count1 > part_count2;
 }
 
+void
+key_def_set_multipart_hint(struct key_def *def)
+{
+	def->multipart_hint = true;
+	key_def_set_func(def);
+}
+
 void
 key_def_update_optionality(struct key_def *def, uint32_t min_field_count)
 {
@@ -214,6 +214,11 @@ struct key_def {
 	 * fields assumed to be MP_NIL.
 	 */
 	bool has_optional_parts;
+	/**
+	 * True if comparison hints are built from the first two
+	 * key parts, see key_def_set_multipart_hint().
+	 */
+	bool multipart_hint;
 	/** Key fields mask. @sa column_mask.h for details. */
 	uint64_t column_mask;
 	/**
@@ -629,6 +634,28 @@ API_EXPORT int
 box_key_def_validate_full_key(const box_key_def_t *key_def, const char *key,
 			      uint32_t *key_size_ptr);
 
+/**
+ * Map a full key to a bucket id in range [1, bucket_count].
+ *
+ * The bucket id is the hash of the key parts modulo bucket_count
+ * plus one, so that it can be used as an index of a precomputed
+ * bucket-to-replicaset array. Keys that are equal according to
+ * @a key_def (including collations) get the same bucket id.
+ *
+ * Note that the hash is not the one used by
+ * vshard.router.bucket_id_mpcrc32().
+ *
+ * @param key_def       Key definition.
+ * @param key           MessagePack'ed key, should be checked with
+ *                      <box_key_def_validate_full_key>() first.
+ * @param bucket_count  Number of buckets, must be positive.
+ *
+ * @retval Bucket id.
+ */
+API_EXPORT uint32_t
+box_key_def_bucket_id(box_key_def_t *key_def, const char *key,
+		      uint32_t bucket_count);
+
 /** \endcond public */
 
 /*
@@ -665,6 +692,15 @@ int
 key_def_dump_parts(const struct key_def *def, struct key_part_def *parts,
 		   struct region *region);
 
+/**
+ * Build comparison hints of @a def from its first two parts.
+ * Has no effect if the types of the parts don't allow it, in
+ * which case ordinary hints built from the first part are used.
+ * @param def Key definition to update.
+ */
+void
+key_def_set_multipart_hint(struct key_def *def);
+
 /**
  * Update 'has_optional_parts' of @a key_def with correspondence
  * to @a min_field_count.
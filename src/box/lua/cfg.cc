@@ -169,6 +169,38 @@ lbox_cfg_set_wal_queue_max_size(struct lua_State *L)
 	return 0;
 }
 
+static int
+lbox_cfg_set_wal_group_commit(struct lua_State *L)
+{
+	if (box_set_wal_group_commit() != 0)
+		luaT_error(L);
+	return 0;
+}
+
+static int
+lbox_cfg_set_snap_io_latency_target(struct lua_State *L)
+{
+	if (box_set_snap_io_latency_target() != 0)
+		luaT_error(L);
+	return 0;
+}
+
+static int
+lbox_cfg_set_iproto_coalesce(struct lua_State *L)
+{
+	if (box_set_iproto_coalesce() != 0)
+		luaT_error(L);
+	return 0;
+}
+
+static int
+lbox_cfg_set_slow_request_threshold(struct lua_State *L)
+{
+	if (box_set_slow_request_threshold() != 0)
+		luaT_error(L);
+	return 0;
+}
+
 static int
 lbox_cfg_set_wal_cleanup_delay(struct lua_State *L)
 {
@@ -243,6 +275,39 @@ lbox_cfg_set_vinyl_cache(struct lua_State *L)
 	return 0;
 }
 
+static int
+lbox_cfg_set_vinyl_cache_scan_resistant(struct lua_State *L)
+{
+	try {
+		box_set_vinyl_cache_scan_resistant();
+	} catch (Exception *) {
+		luaT_error(L);
+	}
+	return 0;
+}
+
+static int
+lbox_cfg_set_vinyl_page_cache(struct lua_State *L)
+{
+	try {
+		box_set_vinyl_page_cache();
+	} catch (Exception *) {
+		luaT_error(L);
+	}
+	return 0;
+}
+
+static int
+lbox_cfg_set_vinyl_upsert_squash_threshold(struct lua_State *L)
+{
+	try {
+		box_set_vinyl_upsert_squash_threshold();
+	} catch (Exception *) {
+		luaT_error(L);
+	}
+	return 0;
+}
+
 static int
 lbox_cfg_set_vinyl_timeout(struct lua_State *L)
 {
@@ -298,6 +363,14 @@ lbox_cfg_set_election_timeout(struct lua_State *L)
 	return 0;
 }
 
+static int
+lbox_cfg_set_election_leader_lease(struct lua_State *L)
+{
+	(void)L;
+	box_set_election_leader_lease();
+	return 0;
+}
+
 static int
 lbox_cfg_set_replication_timeout(struct lua_State *L)
 {
@@ -358,6 +431,22 @@ lbox_cfg_set_replication_synchro_timeout(struct lua_State *L)
 	return 0;
 }
 
+static int
+lbox_cfg_set_replication_compression_level(struct lua_State *L)
+{
+	if (box_set_replication_compression_level() != 0)
+		luaT_error(L);
+	return 0;
+}
+
+static int
+lbox_cfg_set_replication_compression_batch_size(struct lua_State *L)
+{
+	if (box_set_replication_compression_batch_size() != 0)
+		luaT_error(L);
+	return 0;
+}
+
 static int
 lbox_cfg_set_replication_sync_timeout(struct lua_State *L)
 {
@@ -404,6 +493,30 @@ lbox_cfg_set_txn_timeout(struct lua_State *L)
 	return 0;
 }
 
+static int
+lbox_cfg_set_memtx_snap_compress_threads(struct lua_State *L)
+{
+	if (box_set_memtx_snap_compress_threads() != 0)
+		luaT_error(L);
+	return 0;
+}
+
+static int
+lbox_cfg_set_memtx_snap_compression_level(struct lua_State *L)
+{
+	if (box_set_memtx_snap_compression_level() != 0)
+		luaT_error(L);
+	return 0;
+}
+
+static int
+lbox_cfg_set_vinyl_compression_level(struct lua_State *L)
+{
+	if (box_set_vinyl_compression_level() != 0)
+		luaT_error(L);
+	return 0;
+}
+
 void
 box_lua_cfg_init(struct lua_State *L)
 {
@@ -414,6 +527,9 @@ box_lua_cfg_init(struct lua_State *L)
 		{"cfg_set_replication", lbox_cfg_set_replication},
 		{"cfg_set_worker_pool_threads", lbox_cfg_set_worker_pool_threads},
 		{"cfg_set_readahead", lbox_cfg_set_readahead},
+		{"cfg_set_iproto_coalesce", lbox_cfg_set_iproto_coalesce},
+		{"cfg_set_slow_request_threshold",
+		 lbox_cfg_set_slow_request_threshold},
 		{"cfg_set_io_collect_interval", lbox_cfg_set_io_collect_interval},
 		{"cfg_set_too_long_threshold", lbox_cfg_set_too_long_threshold},
 		{"cfg_set_snap_io_rate_limit", lbox_cfg_set_snap_io_rate_limit},
@@ -422,15 +538,31 @@ box_lua_cfg_init(struct lua_State *L)
 		{"cfg_set_checkpoint_wal_threshold", lbox_cfg_set_checkpoint_wal_threshold},
 		{"cfg_set_wal_queue_max_size", lbox_cfg_set_wal_queue_max_size},
 		{"cfg_set_wal_cleanup_delay", lbox_cfg_set_wal_cleanup_delay},
+		{"cfg_set_wal_group_commit", lbox_cfg_set_wal_group_commit},
+		{"cfg_set_snap_io_latency_target",
+		 lbox_cfg_set_snap_io_latency_target},
 		{"cfg_set_read_only", lbox_cfg_set_read_only},
 		{"cfg_set_memtx_memory", lbox_cfg_set_memtx_memory},
 		{"cfg_set_memtx_max_tuple_size", lbox_cfg_set_memtx_max_tuple_size},
+		{"cfg_set_memtx_snap_compress_threads",
+			lbox_cfg_set_memtx_snap_compress_threads},
+		{"cfg_set_memtx_snap_compression_level",
+			lbox_cfg_set_memtx_snap_compression_level},
+		{"cfg_set_vinyl_compression_level",
+			lbox_cfg_set_vinyl_compression_level},
 		{"cfg_set_vinyl_memory", lbox_cfg_set_vinyl_memory},
 		{"cfg_set_vinyl_max_tuple_size", lbox_cfg_set_vinyl_max_tuple_size},
 		{"cfg_set_vinyl_cache", lbox_cfg_set_vinyl_cache},
+		{"cfg_set_vinyl_cache_scan_resistant",
+			lbox_cfg_set_vinyl_cache_scan_resistant},
+		{"cfg_set_vinyl_page_cache", lbox_cfg_set_vinyl_page_cache},
+		{"cfg_set_vinyl_upsert_squash_threshold",
+		 lbox_cfg_set_vinyl_upsert_squash_threshold},
 		{"cfg_set_vinyl_timeout", lbox_cfg_set_vinyl_timeout},
 		{"cfg_set_election_mode", lbox_cfg_set_election_mode},
 		{"cfg_set_election_timeout", lbox_cfg_set_election_timeout},
+		{"cfg_set_election_leader_lease",
+		 lbox_cfg_set_election_leader_lease},
 		{"cfg_set_replication_timeout", lbox_cfg_set_replication_timeout},
 		{"cfg_set_replication_connect_quorum", lbox_cfg_set_replication_connect_quorum},
 		{"cfg_set_replication_connect_timeout", lbox_cfg_set_replication_connect_timeout},
@@ -438,6 +570,8 @@ box_lua_cfg_init(struct lua_State *L)
 		{"cfg_set_replication_synchro_quorum", lbox_cfg_set_replication_synchro_quorum},
 		{"cfg_set_replication_synchro_timeout", lbox_cfg_set_replication_synchro_timeout},
 		{"cfg_set_replication_sync_timeout", lbox_cfg_set_replication_sync_timeout},
+		{"cfg_set_replication_compression_level", lbox_cfg_set_replication_compression_level},
+		{"cfg_set_replication_compression_batch_size", lbox_cfg_set_replication_compression_batch_size},
 		{"cfg_set_replication_skip_conflict", lbox_cfg_set_replication_skip_conflict},
 		{"cfg_set_replication_anon", lbox_cfg_set_replication_anon},
 		{"cfg_set_net_msg_max", lbox_cfg_set_net_msg_max},
@@ -104,6 +104,18 @@ lbox_ctl_demote(struct lua_State *L)
 	return 0;
 }
 
+static int
+lbox_ctl_read_barrier(struct lua_State *L)
+{
+	int index = lua_gettop(L);
+	double timeout = TIMEOUT_INFINITY;
+	if (index > 0)
+		timeout = luaL_checknumber(L, 1);
+	if (box_read_barrier(timeout) != 0)
+		return luaT_error(L);
+	return 0;
+}
+
 static int
 lbox_ctl_is_recovery_finished(struct lua_State *L)
 {
@@ -144,6 +156,7 @@ static const struct luaL_Reg lbox_ctl_lib[] = {
 	/* An old alias. */
 	{"clear_synchro_queue", lbox_ctl_promote},
 	{"demote", lbox_ctl_demote},
+	{"read_barrier", lbox_ctl_read_barrier},
 	{"is_recovery_finished", lbox_ctl_is_recovery_finished},
 	{"set_on_shutdown_timeout", lbox_ctl_set_on_shutdown_timeout},
 	{NULL, NULL}
@@ -34,6 +34,8 @@
 #include "info/info.h"
 #include "box/box.h"
 #include "box/index.h"
+#include "box/iproto_constants.h"
+#include "box/tuple.h"
 #include "box/lua/tuple.h"
 #include "box/lua/misc.h" /* lbox_encode_tuple_on_gc() */
 
@@ -74,6 +76,35 @@ lbox_replace(lua_State *L)
 	return luaT_pushtupleornil(L, result);
 }
 
+static int
+lbox_process_many(lua_State *L, uint16_t type, const char *usage)
+{
+	if (lua_gettop(L) != 2 || !lua_isnumber(L, 1) || !lua_istable(L, 2))
+		return luaL_error(L, usage);
+
+	uint32_t space_id = lua_tonumber(L, 1);
+	size_t tuples_len;
+	const char *tuples = lbox_encode_tuple_on_gc(L, 2, &tuples_len);
+	if (box_process_many(space_id, type, tuples,
+			     tuples + tuples_len) != 0)
+		return luaT_error(L);
+	return 0;
+}
+
+static int
+lbox_insert_many(lua_State *L)
+{
+	return lbox_process_many(L, IPROTO_INSERT,
+				 "Usage space:insert_many(tuples)");
+}
+
+static int
+lbox_replace_many(lua_State *L)
+{
+	return lbox_process_many(L, IPROTO_REPLACE,
+				 "Usage space:replace_many(tuples)");
+}
+
 static int
 lbox_index_update(lua_State *L)
 {
@@ -284,6 +315,39 @@ lbox_iterator_next(lua_State *L)
 	return luaT_pushtupleornil(L, tuple);
 }
 
+/**
+ * Fetch up to the given number of tuples from an iterator into the
+ * array part of a table and return the number of fetched tuples:
+ * iterator_next_batch(state, tuples, count).
+ */
+static int
+lbox_iterator_next_batch(lua_State *L)
+{
+	if (lua_gettop(L) < 3 || lua_type(L, 1) != LUA_TCDATA ||
+	    lua_type(L, 2) != LUA_TTABLE)
+		return luaL_error(L, "usage: next_batch(state, tuples, count)");
+
+	uint32_t ctypeid;
+	void *data = luaL_checkcdata(L, 1, &ctypeid);
+	if (ctypeid != (uint32_t) CTID_STRUCT_ITERATOR_REF)
+		return luaL_error(L, "usage: next_batch(state, tuples, count)");
+
+	struct iterator *itr = *(struct iterator **) data;
+	uint32_t count = luaL_checkinteger(L, 3);
+	uint32_t i;
+	for (i = 0; i < count; i++) {
+		struct tuple *tuple;
+		if (box_iterator_next(itr, &tuple) != 0)
+			return luaT_error(L);
+		if (tuple == NULL)
+			break;
+		luaT_pushtuple(L, tuple);
+		lua_rawseti(L, 2, i + 1);
+	}
+	lua_pushinteger(L, i);
+	return 1;
+}
+
 /** Truncate a given space */
 static int
 lbox_truncate(struct lua_State *L)
@@ -328,6 +392,82 @@ lbox_index_compact(lua_State *L)
 	return 0;
 }
 
+static int
+lbox_index_hot_keys_enable(lua_State *L)
+{
+	if (lua_gettop(L) != 3 || !lua_isnumber(L, 1) ||
+	    !lua_isnumber(L, 2) || !lua_isnumber(L, 3))
+		return luaL_error(L, "usage index.hot_keys_enable(space_id, "
+				  "index_id, sample_rate)");
+
+	uint32_t space_id = lua_tonumber(L, 1);
+	uint32_t index_id = lua_tonumber(L, 2);
+	/* Out of range values are reported by box_index_hot_keys_enable(). */
+	double rate = lua_tonumber(L, 3);
+	uint32_t sample_rate = rate >= 1 && rate <= HOT_KEYS_SAMPLE_RATE_MAX ?
+			       rate : 0;
+
+	if (box_index_hot_keys_enable(space_id, index_id, sample_rate) != 0)
+		return luaT_error(L);
+	return 0;
+}
+
+static int
+lbox_index_hot_keys_disable(lua_State *L)
+{
+	if (lua_gettop(L) != 2 || !lua_isnumber(L, 1) || !lua_isnumber(L, 2))
+		return luaL_error(L, "usage index.hot_keys_disable(space_id, "
+				  "index_id)");
+
+	uint32_t space_id = lua_tonumber(L, 1);
+	uint32_t index_id = lua_tonumber(L, 2);
+
+	if (box_index_hot_keys_disable(space_id, index_id) != 0)
+		return luaT_error(L);
+	return 0;
+}
+
+/**
+ * Push an array of the k most frequently accessed keys of an index,
+ * each one as {key, count}, where count is the estimated number of
+ * accesses, with the sample rate taken into account.
+ */
+static int
+lbox_index_hot_keys(lua_State *L)
+{
+	if (lua_gettop(L) != 3 || !lua_isnumber(L, 1) ||
+	    !lua_isnumber(L, 2) || !lua_isnumber(L, 3))
+		return luaL_error(L, "usage index.hot_keys(space_id, "
+				  "index_id, k)");
+
+	uint32_t space_id = lua_tonumber(L, 1);
+	uint32_t index_id = lua_tonumber(L, 2);
+	double k = lua_tonumber(L, 3);
+
+	struct hot_keys *hot_keys;
+	if (box_index_hot_keys(space_id, index_id, &hot_keys) != 0)
+		return luaT_error(L);
+	uint32_t count;
+	struct hot_key *top = hot_keys_top(hot_keys, &count);
+	if (k < count)
+		count = k;
+	lua_createtable(L, count, 0);
+	for (uint32_t i = 0; i < count; i++) {
+		struct tuple *key = tuple_new(tuple_format_runtime, top[i].key,
+					      top[i].key + top[i].key_size);
+		if (key == NULL)
+			return luaT_error(L);
+		lua_createtable(L, 2, 0);
+		luaT_pushtuple(L, key);
+		lua_rawseti(L, -2, 1);
+		luaL_pushuint64(L, (uint64_t)top[i].count *
+				hot_keys->sample_rate);
+		lua_rawseti(L, -2, 2);
+		lua_rawseti(L, -2, i + 1);
+	}
+	return 1;
+}
+
 /* }}} */
 
 void
@@ -352,6 +492,8 @@ box_lua_index_init(struct lua_State *L)
 	static const struct luaL_Reg boxlib_internal[] = {
 		{"insert", lbox_insert},
 		{"replace",  lbox_replace},
+		{"insert_many", lbox_insert_many},
+		{"replace_many", lbox_replace_many},
 		{"update", lbox_index_update},
 		{"upsert",  lbox_upsert},
 		{"delete",  lbox_index_delete},
@@ -362,9 +504,13 @@ box_lua_index_init(struct lua_State *L)
 		{"count", lbox_index_count},
 		{"iterator", lbox_index_iterator},
 		{"iterator_next", lbox_iterator_next},
+		{"iterator_next_batch", lbox_iterator_next_batch},
 		{"truncate", lbox_truncate},
 		{"stat", lbox_index_stat},
 		{"compact", lbox_index_compact},
+		{"hot_keys_enable", lbox_index_hot_keys_enable},
+		{"hot_keys_disable", lbox_index_hot_keys_disable},
+		{"hot_keys", lbox_index_hot_keys},
 		{NULL, NULL}
 	};
 
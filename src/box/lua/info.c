@@ -45,6 +45,7 @@
 #include "box/gc.h"
 #include "box/engine.h"
 #include "box/vinyl.h"
+#include "box/memtx_engine.h"
 #include "box/sql_stmt_cache.h"
 #include "main.h"
 #include "version.h"
@@ -55,6 +56,8 @@
 #include "lua/serializer.h" /* luaL_setmaphint */
 #include "fiber.h"
 #include "sio.h"
+#include "rmean.h"
+#include "histogram.h"
 
 static void
 lbox_pushvclock(struct lua_State *L, const struct vclock *vclock)
@@ -84,6 +87,33 @@ lbox_push_replication_error_message(struct lua_State *L, struct error *e,
 	lua_settable(L, idx - 2);
 }
 
+/** Push {rps = ..., total = ...} for a counter of the given rmean. */
+static void
+lbox_pushrmean(lua_State *L, struct rmean *rmean, size_t name)
+{
+	lua_createtable(L, 0, 2);
+	lua_pushinteger(L, rmean_mean(rmean, name));
+	lua_setfield(L, -2, "rps");
+	luaL_pushint64(L, rmean_total(rmean, name));
+	lua_setfield(L, -2, "total");
+}
+
+/**
+ * Push {p50 = ..., p90 = ..., p99 = ...} for a histogram of
+ * latencies collected in microseconds. Values are in seconds.
+ */
+static void
+lbox_pushlatency(lua_State *L, struct histogram *hist)
+{
+	lua_createtable(L, 0, 3);
+	lua_pushnumber(L, histogram_percentile(hist, 50) / 1e6);
+	lua_setfield(L, -2, "p50");
+	lua_pushnumber(L, histogram_percentile(hist, 90) / 1e6);
+	lua_setfield(L, -2, "p90");
+	lua_pushnumber(L, histogram_percentile(hist, 99) / 1e6);
+	lua_setfield(L, -2, "p99");
+}
+
 static void
 lbox_pushapplier(lua_State *L, struct applier *applier)
 {
@@ -124,9 +154,38 @@ lbox_pushapplier(lua_State *L, struct applier *applier)
 		struct error *e = diag_last_error(&applier->reader->diag);
 		if (e != NULL)
 			lbox_push_replication_error_message(L, e, -1);
+
+		lua_createtable(L, 0, 4);
+		lbox_pushrmean(L, applier->stat, APPLIER_STAT_ROWS);
+		lua_setfield(L, -2, "rows");
+		lbox_pushrmean(L, applier->stat, APPLIER_STAT_BYTES);
+		lua_setfield(L, -2, "bytes");
+		lbox_pushlatency(L, applier->apply_latency);
+		lua_setfield(L, -2, "apply_latency");
+		lbox_pushlatency(L, applier->wal_latency);
+		lua_setfield(L, -2, "wal_latency");
+		lua_setfield(L, -2, "stat");
 	}
 }
 
+/**
+ * Push relay statistics. Read and send times are accumulated
+ * in microseconds and reported in seconds.
+ */
+static void
+lbox_pushrelay_stat(lua_State *L, struct rmean *stat)
+{
+	lua_createtable(L, 0, 4);
+	lbox_pushrmean(L, stat, RELAY_STAT_ROWS);
+	lua_setfield(L, -2, "rows");
+	lbox_pushrmean(L, stat, RELAY_STAT_BYTES);
+	lua_setfield(L, -2, "bytes");
+	lua_pushnumber(L, rmean_total(stat, RELAY_STAT_READ_TIME) / 1e6);
+	lua_setfield(L, -2, "wal_read_time");
+	lua_pushnumber(L, rmean_total(stat, RELAY_STAT_SEND_TIME) / 1e6);
+	lua_setfield(L, -2, "send_time");
+}
+
 static void
 lbox_pushrelay(lua_State *L, struct relay *relay)
 {
@@ -147,6 +206,8 @@ lbox_pushrelay(lua_State *L, struct relay *relay)
 		lua_pushstring(L, "lag");
 		lua_pushnumber(L, relay_txn_lag(relay));
 		lua_settable(L, -3);
+		lbox_pushrelay_stat(L, relay_stat(relay));
+		lua_setfield(L, -2, "stat");
 		break;
 	case RELAY_STOPPED:
 	{
@@ -566,6 +627,34 @@ lbox_info_vinyl(struct lua_State *L)
 	return 1;
 }
 
+static int
+lbox_info_memtx_call(struct lua_State *L)
+{
+	struct info_handler h;
+	luaT_info_handler_create(&h, L);
+	struct memtx_engine *memtx =
+		(struct memtx_engine *)engine_by_name("memtx");
+	assert(memtx != NULL);
+	memtx_engine_stat(memtx, &h);
+	return 1;
+}
+
+static int
+lbox_info_memtx(struct lua_State *L)
+{
+	lua_newtable(L);
+
+	lua_newtable(L); /* metatable */
+
+	lua_pushstring(L, "__call");
+	lua_pushcfunction(L, lbox_info_memtx_call);
+	lua_settable(L, -3);
+
+	lua_setmetatable(L, -2);
+
+	return 1;
+}
+
 static int
 lbox_info_sql_call(struct lua_State *L)
 {
@@ -665,6 +754,7 @@ static const struct luaL_Reg lbox_info_dynamic_meta[] = {
 	{"memory", lbox_info_memory},
 	{"gc", lbox_info_gc},
 	{"vinyl", lbox_info_vinyl},
+	{"memtx", lbox_info_memtx},
 	{"sql", lbox_info_sql},
 	{"listen", lbox_info_listen},
 	{"election", lbox_info_election},
@@ -41,6 +41,7 @@
 #include "lua/msgpack.h"
 
 #include "box/box.h"
+#include "box/engine.h"
 #include "box/txn.h"
 #include "box/func.h"
 #include "box/mp_error.h"
@@ -67,6 +68,7 @@
 #include "box/lua/key_def.h"
 #include "box/lua/merger.h"
 #include "box/lua/watcher.h"
+#include "box/lua/read_view.h"
 
 #include "mpstream/mpstream.h"
 
@@ -360,22 +362,81 @@ lbox_backup_cb(const char *path, void *cb_arg)
 	return 0;
 }
 
+/**
+ * Decodes a backup point returned by box.backup.start() from
+ * the table at the given index.
+ */
+static int
+lbox_backup_point_decode(struct lua_State *L, int idx,
+			 struct engine_backup_point *point)
+{
+	if (!lua_istable(L, idx))
+		return -1;
+	lua_getfield(L, idx, "signature");
+	lua_getfield(L, idx, "vinyl_max_id");
+	if (!lua_isnumber(L, -2) || !lua_isnumber(L, -1)) {
+		lua_pop(L, 2);
+		return -1;
+	}
+	point->signature = lua_tointeger(L, -2);
+	point->vy_max_id = lua_tointeger(L, -1);
+	lua_pop(L, 2);
+	return 0;
+}
+
+/**
+ * Pushes a table with the state of the checkpoint being backed up,
+ * which is needed to make an incremental backup based on it.
+ */
+static void
+lbox_backup_point_push(struct lua_State *L,
+		       const struct engine_backup_point *since,
+		       const struct engine_backup_point *point)
+{
+	lua_createtable(L, 0, 3);
+	lua_pushinteger(L, point->signature);
+	lua_setfield(L, -2, "signature");
+	lua_pushinteger(L, point->vy_max_id);
+	lua_setfield(L, -2, "vinyl_max_id");
+	if (since != NULL) {
+		lua_pushinteger(L, since->signature);
+		lua_setfield(L, -2, "since");
+	}
+}
+
 static int
 lbox_backup_start(struct lua_State *L)
 {
 	int checkpoint_idx = 0;
-	if (lua_gettop(L) > 0) {
+	if (lua_gettop(L) > 0 && !lua_isnil(L, 1)) {
 		checkpoint_idx = luaL_checkint(L, 1);
 		if (checkpoint_idx < 0)
 			return luaL_error(L, "invalid checkpoint index");
 	}
+	struct engine_backup_point since_buf;
+	struct engine_backup_point *since = NULL;
+	if (lua_gettop(L) > 1 && !lua_isnil(L, 2)) {
+		if (!lua_istable(L, 2))
+			return luaL_error(L, "invalid backup options");
+		lua_getfield(L, 2, "since");
+		if (!lua_isnil(L, -1)) {
+			if (lbox_backup_point_decode(L, lua_gettop(L),
+						     &since_buf) != 0)
+				return luaL_error(L, "invalid backup point");
+			since = &since_buf;
+		}
+		lua_pop(L, 1);
+	}
 	lua_newtable(L);
 	struct lbox_backup_arg arg = {
 		.L = L,
 	};
-	if (box_backup_start(checkpoint_idx, lbox_backup_cb, &arg) != 0)
+	struct engine_backup_point point;
+	if (box_backup_start(checkpoint_idx, since, &point,
+			     lbox_backup_cb, &arg) != 0)
 		return luaT_error(L);
-	return 1;
+	lbox_backup_point_push(L, since, &point);
+	return 2;
 }
 
 static int
@@ -480,6 +541,7 @@ box_lua_init(struct lua_State *L)
 	box_lua_xlog_init(L);
 	box_lua_sql_init(L);
 	box_lua_watcher_init(L);
+	box_lua_read_view_init(L);
 	luaopen_net_box(L);
 	lua_pop(L, 1);
 	tarantool_lua_console_init(L);
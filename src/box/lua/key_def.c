@@ -414,6 +414,107 @@ lbox_key_def_merge(struct lua_State *L)
 	return 1;
 }
 
+/**
+ * Encode a key at the given Lua stack index, check that it's a full
+ * key of the key_def and return its bucket id. Return 0 and set diag
+ * on error.
+ */
+static uint32_t
+luaT_key_def_bucket_id(struct lua_State *L, struct key_def *key_def,
+		       int idx, uint32_t bucket_count)
+{
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	uint32_t bucket_id = 0;
+	const char *key = luaT_tuple_encode(L, idx, NULL);
+	if (key != NULL &&
+	    box_key_def_validate_full_key(key_def, key, NULL) == 0)
+		bucket_id = box_key_def_bucket_id(key_def, key, bucket_count);
+	region_truncate(region, region_svp);
+	return bucket_id;
+}
+
+/** Check a bucket count. Return 0 and set diag if it's out of range. */
+static uint32_t
+key_def_check_bucket_count(lua_Integer bucket_count)
+{
+	if (bucket_count <= 0 || bucket_count > UINT32_MAX) {
+		diag_set(IllegalParams,
+			 "bucket count must be in range [1, %u]", UINT32_MAX);
+		return 0;
+	}
+	return bucket_count;
+}
+
+/**
+ * Push the bucket id of a full key, that is a number in range
+ * [1, bucket_count], to a Lua stack. Raise error if the key doesn't
+ * match the key_def.
+ */
+static int
+lbox_key_def_bucket_id(struct lua_State *L)
+{
+	struct key_def *key_def;
+	if (lua_gettop(L) != 3 ||
+	    (key_def = luaT_check_key_def(L, 1)) == NULL ||
+	    lua_type(L, 3) != LUA_TNUMBER)
+		return luaL_error(L,
+			"Usage: key_def:bucket_id(key, bucket_count)");
+
+	uint32_t bucket_count = key_def_check_bucket_count(lua_tointeger(L, 3));
+	if (bucket_count == 0)
+		return luaT_error(L);
+	uint32_t bucket_id = luaT_key_def_bucket_id(L, key_def, 2,
+						    bucket_count);
+	if (bucket_id == 0)
+		return luaT_error(L);
+	lua_pushinteger(L, bucket_id);
+	return 1;
+}
+
+/**
+ * Route an array of full keys to buckets.
+ *
+ * The second argument is either the number of buckets or an array
+ * of bucket_count values indexed by bucket id, for example, the
+ * replicasets the buckets are stored on. Push an array with the
+ * bucket id or with the value of the bucket for each key to a Lua
+ * stack. Raise error if any key doesn't match the key_def.
+ */
+static int
+lbox_key_def_route(struct lua_State *L)
+{
+	struct key_def *key_def;
+	if (lua_gettop(L) != 3 ||
+	    (key_def = luaT_check_key_def(L, 1)) == NULL ||
+	    lua_type(L, 2) != LUA_TTABLE ||
+	    (lua_type(L, 3) != LUA_TTABLE && lua_type(L, 3) != LUA_TNUMBER))
+		return luaL_error(L, "Usage: key_def:route(keys, buckets)");
+
+	bool has_table = lua_type(L, 3) == LUA_TTABLE;
+	uint32_t bucket_count = key_def_check_bucket_count(
+		has_table ? (lua_Integer)lua_objlen(L, 3) :
+		lua_tointeger(L, 3));
+	if (bucket_count == 0)
+		return luaT_error(L);
+
+	uint32_t key_count = lua_objlen(L, 2);
+	lua_createtable(L, key_count, 0);
+	for (uint32_t i = 1; i <= key_count; i++) {
+		lua_rawgeti(L, 2, i);
+		uint32_t bucket_id = luaT_key_def_bucket_id(L, key_def, -1,
+							    bucket_count);
+		if (bucket_id == 0)
+			return luaT_error(L);
+		lua_pop(L, 1);
+		if (has_table)
+			lua_rawgeti(L, 3, bucket_id);
+		else
+			lua_pushinteger(L, bucket_id);
+		lua_rawseti(L, -2, i);
+	}
+	return 1;
+}
 
 /**
  * Push a new table representing a key_def to a Lua stack.
@@ -513,6 +614,8 @@ luaopen_key_def(struct lua_State *L)
 		{"compare_with_key", lbox_key_def_compare_with_key},
 		{"merge", lbox_key_def_merge},
 		{"totable", lbox_key_def_to_table},
+		{"bucket_id", lbox_key_def_bucket_id},
+		{"route", lbox_key_def_route},
 		{NULL, NULL}
 	};
 	luaL_register_module(L, "key_def", meta);
@@ -8,6 +8,8 @@ local methods = {
     ['compare_with_key'] = key_def.compare_with_key,
     ['merge'] = key_def.merge,
     ['totable'] = key_def.totable,
+    ['bucket_id'] = key_def.bucket_id,
+    ['route'] = key_def.route,
     ['__serialize'] = key_def.totable,
 }
 
@@ -42,10 +42,19 @@ local default_cfg = {
     strip_core          = true,
     memtx_min_tuple_size = 16,
     memtx_max_tuple_size = 1024 * 1024,
+    memtx_snap_compress_threads = 0,
+    memtx_snap_compression_level = 3,
     slab_alloc_granularity = 8,
     slab_alloc_factor   = 1.05,
     iproto_threads      = 1,
+    iproto_busy_poll    = 0,
+    tx_cpu_affinity     = nil,
+    wal_cpu_affinity    = nil,
+    iproto_cpu_affinity = nil,
+    replication_cpu_affinity = nil,
     memtx_allocator     = "small",
+    memtx_use_huge_pages = false,
+    memtx_numa_node     = -1,
     work_dir            = nil,
     memtx_dir           = ".",
     wal_dir             = ".",
@@ -53,6 +62,10 @@ local default_cfg = {
     vinyl_dir           = '.',
     vinyl_memory        = 128 * 1024 * 1024,
     vinyl_cache         = 128 * 1024 * 1024,
+    vinyl_cache_scan_resistant = false,
+    vinyl_page_cache    = 0,
+    vinyl_upsert_squash_threshold = 128,
+    vinyl_compression_level = 3,
     vinyl_max_tuple_size = 1024 * 1024,
     vinyl_read_threads  = 1,
     vinyl_write_threads = 4,
@@ -72,13 +85,21 @@ local default_cfg = {
 
     io_collect_interval = nil,
     readahead           = 16320,
+    iproto_coalesce_size = 0,
+    iproto_coalesce_timeout = 0.001,
+    slow_request_threshold = 0,
     snap_io_rate_limit  = nil, -- no limit
+    snap_io_latency_target = 0,
     too_long_threshold  = 0.5,
     wal_mode            = "write",
+    wal_io_mode         = "buffered",
     wal_max_size        = 256 * 1024 * 1024,
     wal_dir_rescan_delay= 2,
     wal_queue_max_size  = 16 * 1024 * 1024,
     wal_cleanup_delay   = 4 * 3600,
+    wal_compression_level = 3,
+    wal_group_commit_delay = 0,
+    wal_group_commit_max_size = 1024 * 1024,
     force_recovery      = false,
     replication         = nil,
     instance_uuid       = nil,
@@ -97,11 +118,15 @@ local default_cfg = {
     worker_pool_threads = 4,
     election_mode       = 'off',
     election_timeout    = 5,
+    election_leader_lease = false,
     replication_timeout = 1,
     replication_sync_lag = 10,
     replication_sync_timeout = 300,
     replication_synchro_quorum = 1,
     replication_synchro_timeout = 5,
+    replication_threads = 0,
+    replication_compression_level = 0,
+    replication_compression_batch_size = 16 * 1024,
     replication_connect_timeout = 30,
     replication_connect_quorum = nil, -- connect all
     replication_skip_conflict = false,
@@ -120,6 +145,7 @@ local module_cfg = {
     -- logging
     log                 = log.box_api,
     log_nonblock        = log.box_api,
+    log_async           = log.box_api,
     log_level           = log.box_api,
     log_format          = log.box_api,
 }
@@ -136,6 +162,7 @@ local module_cfg_type = {
     -- logging
     log                 = 'string',
     log_nonblock        = 'boolean',
+    log_async           = 'boolean',
     log_level           = 'number, string',
     log_format          = 'string',
 }
@@ -152,9 +179,18 @@ local template_cfg = {
     strip_core          = 'boolean',
     memtx_min_tuple_size  = 'number',
     memtx_max_tuple_size  = 'number',
+    memtx_snap_compress_threads = 'number',
+    memtx_snap_compression_level = 'number',
     slab_alloc_granularity = 'number',
     slab_alloc_factor   = 'number',
     iproto_threads      = 'number',
+    iproto_busy_poll    = 'number',
+    tx_cpu_affinity     = 'string',
+    wal_cpu_affinity    = 'string',
+    iproto_cpu_affinity = 'string',
+    replication_cpu_affinity = 'string',
+    memtx_use_huge_pages = 'boolean',
+    memtx_numa_node     = 'number',
     memtx_allocator     = 'string',
     work_dir            = 'string',
     memtx_dir            = 'string',
@@ -162,6 +198,10 @@ local template_cfg = {
     vinyl_dir           = 'string',
     vinyl_memory        = 'number',
     vinyl_cache               = 'number',
+    vinyl_cache_scan_resistant = 'boolean',
+    vinyl_page_cache          = 'number',
+    vinyl_upsert_squash_threshold = 'number',
+    vinyl_compression_level   = 'number',
     vinyl_max_tuple_size      = 'number',
     vinyl_read_threads        = 'number',
     vinyl_write_threads       = 'number',
@@ -174,6 +214,7 @@ local template_cfg = {
 
     log                 = 'module',
     log_nonblock        = 'module',
+    log_async           = 'module',
     log_level           = 'module',
     log_format          = 'module',
 
@@ -182,12 +223,18 @@ local template_cfg = {
 
     io_collect_interval = 'number',
     readahead           = 'number',
+    iproto_coalesce_size = 'number',
+    iproto_coalesce_timeout = 'number',
+    slow_request_threshold = 'number',
     snap_io_rate_limit  = 'number',
+    snap_io_latency_target = 'number',
     too_long_threshold  = 'number',
     wal_mode            = 'string',
+    wal_io_mode         = 'string',
     wal_max_size        = 'number',
     wal_dir_rescan_delay= 'number',
     wal_cleanup_delay   = 'number',
+    wal_compression_level = 'number',
     force_recovery      = 'boolean',
     replication         = 'string, number, table',
     instance_uuid       = 'string',
@@ -200,6 +247,8 @@ local template_cfg = {
     checkpoint_interval = 'number',
     checkpoint_wal_threshold = 'number',
     wal_queue_max_size  = 'number',
+    wal_group_commit_delay = 'number',
+    wal_group_commit_max_size = 'number',
     checkpoint_count    = 'number',
     read_only           = 'boolean',
     hot_standby         = 'boolean',
@@ -207,11 +256,15 @@ local template_cfg = {
     worker_pool_threads = 'number',
     election_mode       = 'string',
     election_timeout    = 'number',
+    election_leader_lease = 'boolean',
     replication_timeout = 'number',
     replication_sync_lag = 'number',
     replication_sync_timeout = 'number',
     replication_synchro_quorum = 'string, number',
     replication_synchro_timeout = 'number',
+    replication_threads = 'number',
+    replication_compression_level = 'number',
+    replication_compression_batch_size = 'number',
     replication_connect_timeout = 'number',
     replication_connect_quorum = 'number',
     replication_skip_conflict = 'boolean',
@@ -290,14 +343,25 @@ local dynamic_cfg = {
     log_format              = log.box_api.cfg_set_log_format,
     io_collect_interval     = private.cfg_set_io_collect_interval,
     readahead               = private.cfg_set_readahead,
+    iproto_coalesce_size    = private.cfg_set_iproto_coalesce,
+    iproto_coalesce_timeout = private.cfg_set_iproto_coalesce,
+    slow_request_threshold  = private.cfg_set_slow_request_threshold,
     too_long_threshold      = private.cfg_set_too_long_threshold,
     snap_io_rate_limit      = private.cfg_set_snap_io_rate_limit,
+    snap_io_latency_target  = private.cfg_set_snap_io_latency_target,
     read_only               = private.cfg_set_read_only,
     memtx_memory            = private.cfg_set_memtx_memory,
     memtx_max_tuple_size    = private.cfg_set_memtx_max_tuple_size,
+    memtx_snap_compress_threads = private.cfg_set_memtx_snap_compress_threads,
+    memtx_snap_compression_level = private.cfg_set_memtx_snap_compression_level,
     vinyl_memory            = private.cfg_set_vinyl_memory,
     vinyl_max_tuple_size    = private.cfg_set_vinyl_max_tuple_size,
     vinyl_cache             = private.cfg_set_vinyl_cache,
+    vinyl_cache_scan_resistant = private.cfg_set_vinyl_cache_scan_resistant,
+    vinyl_page_cache        = private.cfg_set_vinyl_page_cache,
+    vinyl_upsert_squash_threshold =
+        private.cfg_set_vinyl_upsert_squash_threshold,
+    vinyl_compression_level = private.cfg_set_vinyl_compression_level,
     vinyl_timeout           = private.cfg_set_vinyl_timeout,
     checkpoint_count        = private.cfg_set_checkpoint_count,
     checkpoint_interval     = private.cfg_set_checkpoint_interval,
@@ -311,12 +375,15 @@ local dynamic_cfg = {
     -- do nothing, affects new replicas, which query this value on start
     wal_dir_rescan_delay    = function() end,
     wal_cleanup_delay       = private.cfg_set_wal_cleanup_delay,
+    wal_group_commit_delay  = private.cfg_set_wal_group_commit,
+    wal_group_commit_max_size = private.cfg_set_wal_group_commit,
     custom_proc_title       = function()
         require('title').update(box.cfg.custom_proc_title)
     end,
     force_recovery          = function() end,
     election_mode           = private.cfg_set_election_mode,
     election_timeout        = private.cfg_set_election_timeout,
+    election_leader_lease   = private.cfg_set_election_leader_lease,
     replication_timeout     = private.cfg_set_replication_timeout,
     replication_connect_timeout = private.cfg_set_replication_connect_timeout,
     replication_connect_quorum = private.cfg_set_replication_connect_quorum,
@@ -324,6 +391,9 @@ local dynamic_cfg = {
     replication_sync_timeout = private.cfg_set_replication_sync_timeout,
     replication_synchro_quorum = private.cfg_set_replication_synchro_quorum,
     replication_synchro_timeout = private.cfg_set_replication_synchro_timeout,
+    replication_compression_level = private.cfg_set_replication_compression_level,
+    replication_compression_batch_size =
+        private.cfg_set_replication_compression_batch_size,
     replication_skip_conflict = private.cfg_set_replication_skip_conflict,
     replication_anon        = private.cfg_set_replication_anon,
     instance_uuid           = check_instance_uuid,
@@ -390,6 +460,8 @@ local dynamic_cfg_order = {
     replication_anon        = 250,
     -- Cleanup delay should be ignored if replication_anon is set.
     wal_cleanup_delay       = 260,
+    -- The lease must be set before the elections are enabled.
+    election_leader_lease   = 290,
     election_mode           = 300,
     election_timeout        = 320,
 }
@@ -407,10 +479,14 @@ local dynamic_cfg_skip_at_load = {
     vinyl_memory            = true,
     vinyl_max_tuple_size    = true,
     vinyl_cache             = true,
+    vinyl_cache_scan_resistant = true,
+    vinyl_page_cache        = true,
+    vinyl_upsert_squash_threshold = true,
     vinyl_timeout           = true,
     too_long_threshold      = true,
     election_mode           = true,
     election_timeout        = true,
+    election_leader_lease   = true,
     replication             = true,
     replication_timeout     = true,
     replication_connect_timeout = true,
@@ -419,6 +495,8 @@ local dynamic_cfg_skip_at_load = {
     replication_sync_timeout = true,
     replication_synchro_quorum = true,
     replication_synchro_timeout = true,
+    replication_compression_level = true,
+    replication_compression_batch_size = true,
     replication_skip_conflict = true,
     replication_anon        = true,
     wal_dir_rescan_delay    = true,
@@ -428,6 +506,9 @@ local dynamic_cfg_skip_at_load = {
     replicaset_uuid         = true,
     net_msg_max             = true,
     readahead               = true,
+    iproto_coalesce_size    = true,
+    iproto_coalesce_timeout = true,
+    slow_request_threshold  = true,
 }
 
 local function convert_gb(size)
@@ -36,6 +36,7 @@
 #include "lua/msgpack.h"
 
 #include "box/box.h"
+#include "box/index.h"
 #include "box/port.h"
 #include "box/tuple.h"
 #include "box/tuple_format.h"
@@ -101,10 +102,13 @@ port_msgpack_dump_lua(struct port *base, struct lua_State *L, bool is_flat)
 static int
 lbox_select(lua_State *L)
 {
-	if (lua_gettop(L) != 6 || !lua_isnumber(L, 1) || !lua_isnumber(L, 2) ||
-		!lua_isnumber(L, 3) || !lua_isnumber(L, 4) || !lua_isnumber(L, 5)) {
+	int argc = lua_gettop(L);
+	if (argc < 6 || argc > 8 || !lua_isnumber(L, 1) ||
+	    !lua_isnumber(L, 2) || !lua_isnumber(L, 3) ||
+	    !lua_isnumber(L, 4) || !lua_isnumber(L, 5) ||
+	    (argc >= 7 && !lua_isnil(L, 7) && lua_type(L, 7) != LUA_TSTRING)) {
 		return luaL_error(L, "Usage index:select(iterator, offset, "
-				  "limit, key)");
+				  "limit, key, after, fetch_pos)");
 	}
 
 	uint32_t space_id = lua_tonumber(L, 1);
@@ -116,9 +120,22 @@ lbox_select(lua_State *L)
 	size_t key_len;
 	const char *key = lbox_encode_tuple_on_gc(L, 6, &key_len);
 
+	const char *pos = NULL;
+	const char *pos_end = NULL;
+	if (argc >= 7 && !lua_isnil(L, 7)) {
+		size_t pos_len;
+		pos = lua_tolstring(L, 7, &pos_len);
+		pos_end = pos + pos_len;
+	}
+	bool fetch_pos = argc >= 8 && lua_toboolean(L, 8);
+
+	struct region *gc = &fiber()->gc;
+	size_t region_svp = region_used(gc);
 	struct port port;
 	if (box_select(space_id, index_id, iterator, offset, limit,
-		       key, key + key_len, &port) != 0) {
+		       key, key + key_len, &pos, &pos_end, fetch_pos,
+		       &port) != 0) {
+		region_truncate(gc, region_svp);
 		return luaT_error(L);
 	}
 
@@ -133,6 +150,69 @@ lbox_select(lua_State *L)
 	 */
 	port_dump_lua(&port, L, false);
 	port_destroy(&port);
+	if (!fetch_pos) {
+		region_truncate(gc, region_svp);
+		return 1; /* lua table with tuples */
+	}
+	if (pos != NULL)
+		lua_pushlstring(L, pos, pos_end - pos);
+	else
+		lua_pushnil(L);
+	region_truncate(gc, region_svp);
+	return 2; /* lua table with tuples and the position */
+}
+
+/* }}} */
+
+/** {{{ Lua/C implementation of index:tuple_pos() **/
+
+static int
+lbox_index_tuple_pos(lua_State *L)
+{
+	if (lua_gettop(L) != 3 || !lua_isnumber(L, 1) ||
+	    !lua_isnumber(L, 2) ||
+	    (!lua_istable(L, 3) && luaT_istuple(L, 3) == NULL))
+		return luaL_error(L, "Usage index:tuple_pos(tuple)");
+
+	uint32_t space_id = lua_tonumber(L, 1);
+	uint32_t index_id = lua_tonumber(L, 2);
+	struct region *gc = &fiber()->gc;
+	size_t region_svp = region_used(gc);
+	size_t tuple_len;
+	const char *tuple = lbox_encode_tuple_on_gc(L, 3, &tuple_len);
+	const char *pos, *pos_end;
+	if (box_index_tuple_position(space_id, index_id, tuple,
+				     tuple + tuple_len, &pos, &pos_end) != 0) {
+		region_truncate(gc, region_svp);
+		return luaT_error(L);
+	}
+	lua_pushlstring(L, pos, pos_end - pos);
+	region_truncate(gc, region_svp);
+	return 1;
+}
+
+/* }}} */
+
+/** {{{ Lua/C implementation of index:get_many() **/
+
+static int
+lbox_get_many(lua_State *L)
+{
+	if (lua_gettop(L) != 3 || !lua_isnumber(L, 1) || !lua_isnumber(L, 2) ||
+	    !lua_istable(L, 3))
+		return luaL_error(L, "Usage index:get_many(keys)");
+
+	uint32_t space_id = lua_tonumber(L, 1);
+	uint32_t index_id = lua_tonumber(L, 2);
+	size_t keys_len;
+	const char *keys = lbox_encode_tuple_on_gc(L, 3, &keys_len);
+
+	struct port port;
+	if (box_index_get_many(space_id, index_id, keys, keys + keys_len,
+			       &port) != 0)
+		return luaT_error(L);
+	port_dump_lua(&port, L, false);
+	port_destroy(&port);
 	return 1; /* lua table with tuples */
 }
 
@@ -252,6 +332,8 @@ box_lua_misc_init(struct lua_State *L)
 {
 	static const struct luaL_Reg boxlib_internal[] = {
 		{"select", lbox_select},
+		{"get_many", lbox_get_many},
+		{"tuple_pos", lbox_index_tuple_pos},
 		{"new_tuple_format", lbox_tuple_format_new},
 		{NULL, NULL}
 	};
@@ -110,6 +110,10 @@ enum netbox_method {
 	NETBOX_COMMIT      = 18,
 	NETBOX_ROLLBACK    = 19,
 	NETBOX_INJECT      = 20,
+	NETBOX_GET_MANY    = 21,
+	NETBOX_SELECT_WITH_POS = 22,
+	NETBOX_INSERT_MANY = 23,
+	NETBOX_REPLACE_MANY = 24,
 	netbox_method_MAX
 };
 
@@ -271,7 +275,13 @@ struct netbox_request {
 	 * buffer is not set.
 	 */
 	bool skip_header;
-	/** Lua references to on_push trigger and its context. */
+	/**
+	 * Lua references to on_push trigger and its context. An async
+	 * request has no trigger (LUA_NOREF): the context is a table
+	 * of received messages, which is created lazily, on the first
+	 * push or future:pairs() invocation. Until then, it's
+	 * LUA_NOREF.
+	 */
 	int on_push_ref;
 	int on_push_ctx_ref;
 	/**
@@ -743,11 +753,17 @@ static void
 netbox_encode_select(lua_State *L, int idx, struct mpstream *stream,
 		     uint64_t sync, uint64_t stream_id)
 {
-	/* Lua stack at idx: space_id, index_id, iterator, offset, limit, key */
+	/*
+	 * Lua stack at idx: space_id, index_id, iterator, offset, limit, key
+	 * and optional after (position or tuple) and fetch_pos.
+	 */
 	size_t svp = netbox_begin_encode(stream, sync, IPROTO_SELECT,
 					 stream_id);
 
-	mpstream_encode_map(stream, 6);
+	int top = lua_gettop(L);
+	bool has_after = top >= idx + 6 && !lua_isnil(L, idx + 6);
+	bool fetch_pos = top >= idx + 7 && lua_toboolean(L, idx + 7);
+	mpstream_encode_map(stream, 6 + has_after + fetch_pos);
 
 	uint32_t space_id = lua_tonumber(L, idx);
 	uint32_t index_id = lua_tonumber(L, idx + 1);
@@ -779,6 +795,53 @@ netbox_encode_select(lua_State *L, int idx, struct mpstream *stream,
 	mpstream_encode_uint(stream, IPROTO_KEY);
 	luamp_convert_key(L, cfg, stream, idx + 5);
 
+	/* encode the position or the tuple to start after */
+	if (has_after) {
+		if (lua_type(L, idx + 6) == LUA_TSTRING) {
+			size_t pos_len;
+			const char *pos = lua_tolstring(L, idx + 6, &pos_len);
+			mpstream_encode_uint(stream, IPROTO_AFTER_POSITION);
+			mpstream_encode_strn(stream, pos, pos_len);
+		} else {
+			mpstream_encode_uint(stream, IPROTO_AFTER_TUPLE);
+			luamp_encode_tuple(L, cfg, stream, idx + 6);
+		}
+	}
+
+	/* encode fetch_pos */
+	if (fetch_pos) {
+		mpstream_encode_uint(stream, IPROTO_FETCH_POSITION);
+		mpstream_encode_bool(stream, true);
+	}
+
+	netbox_end_encode(stream, svp);
+}
+
+static void
+netbox_encode_get_many(lua_State *L, int idx, struct mpstream *stream,
+		       uint64_t sync, uint64_t stream_id)
+{
+	/* Lua stack at idx: space_id, index_id, keys */
+	size_t svp = netbox_begin_encode(stream, sync, IPROTO_SELECT_BATCH,
+					 stream_id);
+
+	mpstream_encode_map(stream, 3);
+
+	uint32_t space_id = lua_tonumber(L, idx);
+	uint32_t index_id = lua_tonumber(L, idx + 1);
+
+	/* encode space_id */
+	mpstream_encode_uint(stream, IPROTO_SPACE_ID);
+	mpstream_encode_uint(stream, space_id);
+
+	/* encode index_id */
+	mpstream_encode_uint(stream, IPROTO_INDEX_ID);
+	mpstream_encode_uint(stream, index_id);
+
+	/* encode keys */
+	mpstream_encode_uint(stream, IPROTO_KEY);
+	luamp_encode_tuple(L, cfg, stream, idx + 2);
+
 	netbox_end_encode(stream, svp);
 }
 
@@ -820,6 +883,24 @@ netbox_encode_replace(lua_State *L, int idx, struct mpstream *stream,
 					IPROTO_REPLACE, stream_id);
 }
 
+static void
+netbox_encode_insert_many(lua_State *L, int idx, struct mpstream *stream,
+			  uint64_t sync, uint64_t stream_id)
+{
+	/* Lua stack at idx: space_id, tuples */
+	netbox_encode_insert_or_replace(L, idx, stream, sync,
+					IPROTO_INSERT_BATCH, stream_id);
+}
+
+static void
+netbox_encode_replace_many(lua_State *L, int idx, struct mpstream *stream,
+			   uint64_t sync, uint64_t stream_id)
+{
+	/* Lua stack at idx: space_id, tuples */
+	netbox_encode_insert_or_replace(L, idx, stream, sync,
+					IPROTO_REPLACE_BATCH, stream_id);
+}
+
 static void
 netbox_encode_delete(lua_State *L, int idx, struct mpstream *stream,
 		     uint64_t sync, uint64_t stream_id)
@@ -1226,6 +1307,10 @@ netbox_encode_method(struct lua_State *L, int idx, enum netbox_method method,
 		[NETBOX_COMMIT]         = netbox_encode_commit,
 		[NETBOX_ROLLBACK]       = netbox_encode_rollback,
 		[NETBOX_INJECT]		= netbox_encode_inject,
+		[NETBOX_GET_MANY]	= netbox_encode_get_many,
+		[NETBOX_SELECT_WITH_POS] = netbox_encode_select,
+		[NETBOX_INSERT_MANY]	= netbox_encode_insert_many,
+		[NETBOX_REPLACE_MANY]	= netbox_encode_replace_many,
 	};
 	struct mpstream stream;
 	mpstream_init(&stream, ibuf, ibuf_reserve_cb, ibuf_alloc_cb,
@@ -1332,6 +1417,36 @@ netbox_decode_select(struct lua_State *L, const char **data,
 	netbox_decode_data(L, data, format);
 }
 
+/**
+ * Decodes Tarantool response body consisting of IPROTO_DATA and optional
+ * IPROTO_POSITION keys and pushes a table {tuples, position} to Lua stack.
+ * The position is nil if the response doesn't have it.
+ */
+static void
+netbox_decode_select_with_pos(struct lua_State *L, const char **data,
+			      const char *data_end,
+			      struct tuple_format *format)
+{
+	(void)data_end;
+	assert(mp_typeof(**data) == MP_MAP);
+	uint32_t map_size = mp_decode_map(data);
+	lua_createtable(L, 2, 0);
+	for (uint32_t i = 0; i < map_size; i++) {
+		uint32_t key = mp_decode_uint(data);
+		if (key == IPROTO_DATA) {
+			netbox_decode_data(L, data, format);
+			lua_rawseti(L, -2, 1);
+		} else if (key == IPROTO_POSITION) {
+			uint32_t len;
+			const char *pos = mp_decode_str(data, &len);
+			lua_pushlstring(L, pos, len);
+			lua_rawseti(L, -2, 2);
+		} else {
+			mp_next(data);
+		}
+	}
+}
+
 /**
  * Same as netbox_decode_select, but only decodes the first tuple of the array,
  * skipping the rest.
@@ -1600,6 +1715,10 @@ netbox_decode_method(struct lua_State *L, enum netbox_method method,
 		[NETBOX_COMMIT]         = netbox_decode_nil,
 		[NETBOX_ROLLBACK]       = netbox_decode_nil,
 		[NETBOX_INJECT]		= netbox_decode_table,
+		[NETBOX_GET_MANY]	= netbox_decode_select,
+		[NETBOX_SELECT_WITH_POS] = netbox_decode_select_with_pos,
+		[NETBOX_INSERT_MANY]	= netbox_decode_nil,
+		[NETBOX_REPLACE_MANY]	= netbox_decode_nil,
 	};
 	method_decoder[method](L, data, data_end, format);
 }
@@ -1751,6 +1870,24 @@ luaT_netbox_request_wait_result(struct lua_State *L)
  * received, it will be ignored. It reduces the size of the requests hash table
  * speeding up other requests.
  */
+/**
+ * Pushes the table of messages received for an async request to Lua stack,
+ * creating it if it doesn't exist yet.
+ */
+static void
+netbox_request_push_messages(struct netbox_request *request,
+			     struct lua_State *L)
+{
+	assert(request->on_push_ref == LUA_NOREF);
+	if (request->on_push_ctx_ref == LUA_NOREF) {
+		lua_newtable(L);
+		lua_pushvalue(L, -1);
+		request->on_push_ctx_ref = luaL_ref(L, LUA_REGISTRYINDEX);
+		return;
+	}
+	lua_rawgeti(L, LUA_REGISTRYINDEX, request->on_push_ctx_ref);
+}
+
 static int
 luaT_netbox_request_discard(struct lua_State *L)
 {
@@ -1798,7 +1935,7 @@ luaT_netbox_request_iterator_next(struct lua_State *L)
 	 * refers to a table that contains received messages. We iterate over
 	 * the content of the table.
 	 */
-	lua_rawgeti(L, LUA_REGISTRYINDEX, request->on_push_ctx_ref);
+	netbox_request_push_messages(request, L);
 	int messages_idx = lua_gettop(L);
 	assert(lua_istable(L, messages_idx));
 	int message_count = lua_objlen(L, messages_idx);
@@ -1925,7 +2062,7 @@ luaT_netbox_new_transport(struct lua_State *L)
  *  - buffer: buffer (ibuf) to write the result to or nil
  *  - skip_header: whether to skip header when writing the result to the buffer
  *  - method: a value from the netbox_method enumeration
- *  - on_push: on_push trigger function
+ *  - on_push: on_push trigger function or nil for an async request
  *  - on_push_ctx: on_push trigger function argument
  *  - format: tuple format to use for decoding the body or nil
  *  - stream_id: determines whether or not the request belongs to stream
@@ -1976,10 +2113,15 @@ luaT_netbox_transport_make_request(struct lua_State *L, int idx,
 	lua_pushvalue(L, idx);
 	request->buffer_ref = luaL_ref(L, LUA_REGISTRYINDEX);
 	request->skip_header = lua_toboolean(L, idx + 1);
-	lua_pushvalue(L, idx + 3);
-	request->on_push_ref = luaL_ref(L, LUA_REGISTRYINDEX);
-	lua_pushvalue(L, idx + 4);
-	request->on_push_ctx_ref = luaL_ref(L, LUA_REGISTRYINDEX);
+	if (!lua_isnil(L, idx + 3)) {
+		lua_pushvalue(L, idx + 3);
+		request->on_push_ref = luaL_ref(L, LUA_REGISTRYINDEX);
+		lua_pushvalue(L, idx + 4);
+		request->on_push_ctx_ref = luaL_ref(L, LUA_REGISTRYINDEX);
+	} else {
+		request->on_push_ref = LUA_NOREF;
+		request->on_push_ctx_ref = LUA_NOREF;
+	}
 	if (!lua_isnil(L, idx + 5))
 		request->format = lbox_check_tuple_format(L, idx + 5);
 	else
@@ -2206,6 +2348,17 @@ netbox_transport_dispatch_response(struct netbox_transport *transport,
 		netbox_request_set_result(request,
 					  luaL_ref(L, LUA_REGISTRYINDEX));
 		netbox_request_complete(request);
+	} else if (request->on_push_ref == LUA_NOREF) {
+		/*
+		 * We received a push for an async request. Store it for
+		 * future:pairs().
+		 */
+		int message_idx = lua_gettop(L);
+		netbox_request_push_messages(request, L);
+		lua_pushvalue(L, message_idx);
+		lua_rawseti(L, -2, lua_objlen(L, -2) + 1);
+		lua_pop(L, 1);
+		netbox_request_signal(request);
 	} else {
 		/* We received a push. Invoke on_push trigger. */
 		lua_rawgeti(L, LUA_REGISTRYINDEX, request->on_push_ref);
@@ -2570,6 +2723,8 @@ luaopen_net_box(struct lua_State *L)
 			    IPROTO_FEATURE_ERROR_EXTENSION);
 	iproto_features_set(&NETBOX_IPROTO_FEATURES,
 			    IPROTO_FEATURE_WATCHERS);
+	iproto_features_set(&NETBOX_IPROTO_FEATURES,
+			    IPROTO_FEATURE_PAGINATION);
 
 	lua_pushcfunction(L, luaT_netbox_request_iterator_next);
 	luaT_netbox_request_iterator_next_ref = luaL_ref(L, LUA_REGISTRYINDEX);
@@ -44,6 +44,10 @@ local M_COMMIT      = 18
 local M_ROLLBACK    = 19
 -- Injects raw data into connection. Used by tests.
 local M_INJECT      = 20
+local M_GET_MANY    = 21
+local M_SELECT_WITH_POS = 22
+local M_INSERT_MANY = 23
+local M_REPLACE_MANY = 24
 
 -- IPROTO feature id -> name
 local IPROTO_FEATURE_NAMES = {
@@ -51,6 +55,9 @@ local IPROTO_FEATURE_NAMES = {
     [1]     = 'transactions',
     [2]     = 'error_extension',
     [3]     = 'watchers',
+    [4]     = 'replication_compression',
+    [5]     = 'pagination',
+    [6]     = 'request_timeout',
 }
 
 -- Given an array of IPROTO feature ids, returns a map {feature_name: bool}.
@@ -648,7 +655,7 @@ function remote_methods:_request(method, opts, format, stream_id, ...)
             end
             local res, err =
                 transport:perform_async_request(buffer, skip_header, method,
-                                                table.insert, {}, format,
+                                                nil, nil, format,
                                                 stream_id, ...)
             if err then
                 box.error(err)
@@ -906,6 +913,26 @@ space_metatable = function(remote)
                                self._stream_id, self.id, tuple)
     end
 
+    function methods:insert_many(tuples, opts)
+        check_space_arg(self, 'insert_many')
+        if type(tuples) ~= 'table' then
+            box.error(box.error.ILLEGAL_PARAMS,
+                      "Usage: space:insert_many({tuple1, tuple2, ...})")
+        end
+        return remote:_request(M_INSERT_MANY, opts, nil, self._stream_id,
+                               self.id, tuples)
+    end
+
+    function methods:replace_many(tuples, opts)
+        check_space_arg(self, 'replace_many')
+        if type(tuples) ~= 'table' then
+            box.error(box.error.ILLEGAL_PARAMS,
+                      "Usage: space:replace_many({tuple1, tuple2, ...})")
+        end
+        return remote:_request(M_REPLACE_MANY, opts, nil, self._stream_id,
+                               self.id, tuples)
+    end
+
     function methods:select(key, opts)
         check_space_arg(self, 'select')
         return check_primary_index(self):select(key, opts)
@@ -933,6 +960,11 @@ space_metatable = function(remote)
         return check_primary_index(self):get(key, opts)
     end
 
+    function methods:get_many(keys, opts)
+        check_space_arg(self, 'get_many')
+        return check_primary_index(self):get_many(keys, opts)
+    end
+
     function methods:format(format)
         if format == nil then
             return self._format
@@ -954,9 +986,33 @@ index_metatable = function(remote)
         local iterator = check_iterator_type(opts, key_is_nil)
         local offset = tonumber(opts and opts.offset) or 0
         local limit = tonumber(opts and opts.limit) or 0xFFFFFFFF
-        return (remote:_request(M_SELECT, opts, self.space._format_cdata,
-                                self._stream_id, self.space.id, self.id,
-                                iterator, offset, limit, key))
+        local after = opts and opts.after
+        local fetch_pos = opts and opts.fetch_pos
+        if after == nil and not fetch_pos then
+            return (remote:_request(M_SELECT, opts, self.space._format_cdata,
+                                    self._stream_id, self.space.id, self.id,
+                                    iterator, offset, limit, key))
+        end
+        if after ~= nil and type(after) ~= 'string' and
+           type(after) ~= 'table' and not box.tuple.is(after) then
+            box.error(box.error.ILLEGAL_PARAMS,
+                      "options parameter 'after' should be of type " ..
+                      "string, table, tuple")
+        end
+        if not fetch_pos then
+            return (remote:_request(M_SELECT, opts, self.space._format_cdata,
+                                    self._stream_id, self.space.id, self.id,
+                                    iterator, offset, limit, key, after))
+        end
+        local res = remote:_request(M_SELECT_WITH_POS, opts,
+                                    self.space._format_cdata,
+                                    self._stream_id, self.space.id, self.id,
+                                    iterator, offset, limit, key, after,
+                                    true)
+        if opts.is_async or opts.buffer ~= nil then
+            return res
+        end
+        return res[1], res[2]
     end
 
     function methods:get(key, opts)
@@ -971,6 +1027,24 @@ index_metatable = function(remote)
                                                box.index.EQ, 0, 2, key))
     end
 
+    function methods:get_many(keys, opts)
+        check_index_arg(self, 'get_many')
+        if type(keys) ~= 'table' then
+            box.error(box.error.ILLEGAL_PARAMS,
+                      "Usage: index:get_many({key1, key2, ...})")
+        end
+        local keified = {}
+        for i, key in ipairs(keys) do
+            if type(key) ~= 'table' and not box.tuple.is(key) then
+                key = {key}
+            end
+            keified[i] = key
+        end
+        return (remote:_request(M_GET_MANY, opts, self.space._format_cdata,
+                                self._stream_id, self.space.id, self.id,
+                                keified))
+    end
+
     function methods:min(key, opts)
         check_index_arg(self, 'min')
         if opts and opts.buffer then
@@ -1050,6 +1124,10 @@ local this_module = {
         commit      = M_COMMIT,
         rollback    = M_ROLLBACK,
         inject      = M_INJECT,
+        get_many    = M_GET_MANY,
+        select_with_pos = M_SELECT_WITH_POS,
+        insert_many = M_INSERT_MANY,
+        replace_many = M_REPLACE_MANY,
     }
 }
 
@@ -1066,6 +1144,108 @@ function this_module.timeout(timeout, ...)
     }, {__index = this_module})
 end
 
+-- Skips the array of call results in a buffer filled with
+-- skip_header = true and returns the number of results.
+local function skip_call_results(buf)
+    if buf:size() == 0 then
+        return 0
+    end
+    local count
+    count, buf.rpos = msgpack.decode_array_header(buf.rpos, buf:size())
+    return count
+end
+
+--
+-- Calls a function with the same arguments on all connections
+-- at once and gathers the results.
+--
+-- The requests are sent without waiting for responses, and the
+-- responses are copied to buffers as raw MsgPack. Then:
+--
+--  - with opts.key_def, the function must return an array of
+--    tuples sorted by the key_def. The arrays are merged without
+--    decoding them to Lua, and a merger source is returned, see
+--    the merger module. opts.reverse sets descending order.
+--  - with opts.reduce, the first result of each call is decoded
+--    and the results are folded with opts.reduce(acc, result),
+--    starting with opts.initial. The last acc is returned.
+--  - otherwise, an array of the first results of the calls, in
+--    the order of the connections, is returned.
+--
+-- opts.timeout limits the total time to wait for all responses.
+-- The first failed call raises its error, and the responses to
+-- the calls that are not done yet are discarded.
+--
+function this_module.scatter_gather(conns, func_name, args, opts)
+    if type(conns) ~= 'table' or type(func_name) ~= 'string' or
+       (args ~= nil and type(args) ~= 'table') or
+       (opts ~= nil and type(opts) ~= 'table') then
+        error('Usage: net_box.scatter_gather(conns, func_name[, args' ..
+              '[, opts]])', 2)
+    end
+    opts = opts or {}
+    if opts.key_def ~= nil and opts.reduce ~= nil then
+        error('key_def and reduce options are mutually exclusive', 2)
+    end
+    local buffer = require('buffer')
+    local futures = {}
+    local buffers = {}
+    for i, conn in ipairs(conns) do
+        local buf = buffer.ibuf()
+        local ok, res = pcall(conn.call, conn, func_name, args,
+                              {is_async = true, buffer = buf,
+                               skip_header = true})
+        if not ok then
+            for j = 1, i - 1 do
+                futures[j]:discard()
+            end
+            error(res, 0)
+        end
+        futures[i] = res
+        buffers[i] = buf
+    end
+    local deadline = opts.timeout and fiber_clock() + opts.timeout
+    for i, future in ipairs(futures) do
+        local timeout = deadline and max(0, deadline - fiber_clock())
+        local res, err = future:wait_result(timeout)
+        if res == nil then
+            for j = i + 1, #futures do
+                futures[j]:discard()
+            end
+            box.error(err)
+        end
+    end
+    if opts.key_def ~= nil then
+        local merger = require('merger')
+        local sources = {}
+        for i, buf in ipairs(buffers) do
+            if skip_call_results(buf) == 0 then
+                buf:recycle()
+            end
+            sources[i] = merger.new_source_frombuffer(buf)
+        end
+        return merger.new(opts.key_def, sources, {reverse = opts.reverse})
+    end
+    local acc = opts.initial
+    local results = {}
+    for i, buf in ipairs(buffers) do
+        local res
+        if skip_call_results(buf) > 0 then
+            res = msgpack.decode_unchecked(buf.rpos)
+        end
+        buf:recycle()
+        if opts.reduce ~= nil then
+            acc = opts.reduce(acc, res)
+        else
+            results[i] = res
+        end
+    end
+    if opts.reduce ~= nil then
+        return acc
+    end
+    return results
+end
+
 local function rollback()
     if rawget(box, 'rollback') ~= nil then
         -- roll back local transaction on error
@@ -0,0 +1,377 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2022, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "box/lua/read_view.h"
+
+#include <assert.h>
+#include <lua.h>
+#include <lauxlib.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "box/error.h"
+#include "box/index.h"
+#include "box/lua/tuple.h"
+#include "box/schema.h"
+#include "box/space.h"
+#include "box/tuple.h"
+#include "box/tuple_format.h"
+#include "diag.h"
+#include "fiber.h"
+#include "lua/utils.h"
+#include "small/rlist.h"
+#include "trivia/util.h"
+
+/** A space included in a read view. */
+struct lbox_read_view_space {
+	/** Space id at the time the read view was opened. */
+	uint32_t id;
+	/** Space name at the time the read view was opened. */
+	char *name;
+	/**
+	 * Runtime format with the space field names, used for
+	 * tuples returned by the read view.
+	 */
+	struct tuple_format *format;
+	/**
+	 * Full scan iterator over a frozen primary index. NULL
+	 * once the space has been read.
+	 */
+	struct snapshot_iterator *iterator;
+};
+
+/**
+ * A consistent read-only view of several spaces. All the primary
+ * indexes are frozen at once, without yielding, so the spaces are
+ * seen as of the same moment. Writers don't wait for a read view,
+ * but tuples deleted after it was opened aren't freed until it is
+ * closed, see memtx_enter_delayed_free_mode().
+ */
+struct lbox_read_view {
+	/** Unique id, for box.read_view.list(). */
+	uint64_t id;
+	/** Name given by the user. */
+	char *name;
+	/** fiber_clock() at the time the read view was opened. */
+	double open_time;
+	/** Link in lbox_read_views. */
+	struct rlist in_read_views;
+	/** Number of entries in spaces. */
+	uint32_t space_count;
+	struct lbox_read_view_space spaces[0];
+};
+
+/** Read view handle pushed to Lua as userdata. NULL once closed. */
+struct lbox_read_view_handle {
+	struct lbox_read_view *rv;
+};
+
+static const char lbox_read_view_typename[] = "box.read_view";
+
+/** All open read views, ordered by id. */
+static RLIST_HEAD(lbox_read_views);
+
+/** Id of the last opened read view. */
+static uint64_t lbox_read_view_last_id = 0;
+
+static void
+lbox_read_view_delete(struct lbox_read_view *rv)
+{
+	for (uint32_t i = 0; i < rv->space_count; i++) {
+		struct lbox_read_view_space *s = &rv->spaces[i];
+		if (s->iterator != NULL)
+			s->iterator->free(s->iterator);
+		if (s->format != NULL)
+			tuple_format_unref(s->format);
+		free(s->name);
+	}
+	rlist_del(&rv->in_read_views);
+	free(rv->name);
+	free(rv);
+}
+
+/**
+ * Find the space referenced by the Lua value at the given stack
+ * index (a name or an id). Returns NULL and sets diag on error.
+ */
+static struct space *
+lbox_read_view_find_space(struct lua_State *L, int idx)
+{
+	struct space *space;
+	if (lua_type(L, idx) == LUA_TNUMBER) {
+		uint32_t id = lua_tointeger(L, idx);
+		space = space_by_id(id);
+		if (space == NULL)
+			diag_set(ClientError, ER_NO_SUCH_SPACE, int2str(id));
+	} else {
+		const char *name = lua_tostring(L, idx);
+		if (name == NULL) {
+			diag_set(IllegalParams, "spaces must be a table of "
+				 "space names or ids");
+			return NULL;
+		}
+		space = space_by_name(name);
+		if (space == NULL)
+			diag_set(ClientError, ER_NO_SUCH_SPACE, name);
+	}
+	return space;
+}
+
+/**
+ * Freeze the primary index of a space for the read view. Returns -1
+ * and sets diag on error.
+ */
+static int
+lbox_read_view_add_space(struct lbox_read_view_space *s,
+			 struct space *space)
+{
+	struct index *pk = space_index(space, 0);
+	if (pk == NULL) {
+		diag_set(ClientError, ER_NO_SUCH_INDEX_ID, 0,
+			 space_name(space));
+		return -1;
+	}
+	s->id = space_id(space);
+	s->name = xstrdup(space_name(space));
+	s->format = tuple_format_new(&tuple_format_runtime_vtab, NULL, NULL, 0,
+				     space->def->fields,
+				     space->def->field_count, 0,
+				     space->def->dict, false, false);
+	if (s->format == NULL)
+		return -1;
+	tuple_format_ref(s->format);
+	s->iterator = index_create_snapshot_iterator(pk);
+	if (s->iterator == NULL)
+		return -1;
+	return 0;
+}
+
+static inline struct lbox_read_view_handle *
+lbox_check_read_view(struct lua_State *L, int idx)
+{
+	return luaL_checkudata(L, idx, lbox_read_view_typename);
+}
+
+static int
+lbox_read_view_tostring(struct lua_State *L)
+{
+	lua_pushstring(L, lbox_read_view_typename);
+	return 1;
+}
+
+/**
+ * Lua iterator function returned by rv:pairs(). Returns the next
+ * tuple number and the tuple, or nothing at the end of the space.
+ */
+static int
+lbox_read_view_next(struct lua_State *L)
+{
+	struct lbox_read_view_handle *handle =
+		lua_touserdata(L, lua_upvalueindex(1));
+	uint32_t i = lua_tointeger(L, lua_upvalueindex(2));
+	if (handle->rv == NULL)
+		return luaL_error(L, "Read view is closed");
+	struct lbox_read_view_space *s = &handle->rv->spaces[i];
+	if (s->iterator == NULL)
+		return 0;
+	const char *data;
+	uint32_t size;
+	if (s->iterator->next(s->iterator, &data, &size) != 0)
+		return luaT_error(L);
+	if (data == NULL) {
+		/* Don't keep the frozen index longer than needed. */
+		s->iterator->free(s->iterator);
+		s->iterator = NULL;
+		return 0;
+	}
+	struct tuple *tuple = tuple_new(s->format, data, data + size);
+	if (tuple == NULL)
+		return luaT_error(L);
+	lua_pushinteger(L, lua_tointeger(L, 2) + 1);
+	luaT_pushtuple(L, tuple);
+	return 2;
+}
+
+/**
+ * rv:pairs(space) returns an iterator over all tuples of the space
+ * in the primary key order, as of the moment the read view was
+ * opened. Each space can be read only once, because the iterator
+ * walks the frozen index itself.
+ */
+static int
+lbox_read_view_pairs(struct lua_State *L)
+{
+	if (lua_gettop(L) != 2)
+		return luaL_error(L, "Usage: read_view:pairs(space)");
+	struct lbox_read_view_handle *handle = lbox_check_read_view(L, 1);
+	struct lbox_read_view *rv = handle->rv;
+	if (rv == NULL)
+		return luaL_error(L, "Read view is closed");
+	uint32_t i;
+	for (i = 0; i < rv->space_count; i++) {
+		struct lbox_read_view_space *s = &rv->spaces[i];
+		if (lua_type(L, 2) == LUA_TNUMBER ?
+		    (uint32_t)lua_tointeger(L, 2) == s->id :
+		    (lua_isstring(L, 2) &&
+		     strcmp(lua_tostring(L, 2), s->name) == 0))
+			break;
+	}
+	if (i == rv->space_count)
+		return luaL_error(L, "Space '%s' is not in the read view",
+				  luaT_tolstring(L, 2, NULL));
+	if (rv->spaces[i].iterator == NULL)
+		return luaL_error(L, "Space '%s' has already been read",
+				  rv->spaces[i].name);
+	lua_pushvalue(L, 1);
+	lua_pushinteger(L, i);
+	lua_pushcclosure(L, lbox_read_view_next, 2);
+	lua_pushnil(L);
+	lua_pushinteger(L, 0);
+	return 3;
+}
+
+/** rv:close() releases the frozen indexes. */
+static int
+lbox_read_view_close(struct lua_State *L)
+{
+	struct lbox_read_view_handle *handle = lbox_check_read_view(L, 1);
+	if (handle->rv == NULL)
+		return luaL_error(L, "Read view is closed");
+	lbox_read_view_delete(handle->rv);
+	handle->rv = NULL;
+	return 0;
+}
+
+static int
+lbox_read_view_gc(struct lua_State *L)
+{
+	struct lbox_read_view_handle *handle = lbox_check_read_view(L, 1);
+	if (handle->rv != NULL)
+		lbox_read_view_delete(handle->rv);
+	handle->rv = NULL;
+	return 0;
+}
+
+/** Push a table describing a read view, see box.read_view.list(). */
+static void
+lbox_read_view_push_info(struct lua_State *L, struct lbox_read_view *rv)
+{
+	lua_newtable(L);
+	luaL_pushuint64(L, rv->id);
+	lua_setfield(L, -2, "id");
+	lua_pushstring(L, rv->name);
+	lua_setfield(L, -2, "name");
+	lua_pushnumber(L, fiber_clock() - rv->open_time);
+	lua_setfield(L, -2, "age");
+	lua_newtable(L);
+	for (uint32_t i = 0; i < rv->space_count; i++) {
+		lua_pushstring(L, rv->spaces[i].name);
+		lua_rawseti(L, -2, i + 1);
+	}
+	lua_setfield(L, -2, "spaces");
+}
+
+/** rv:info() returns the read view description. */
+static int
+lbox_read_view_info(struct lua_State *L)
+{
+	struct lbox_read_view_handle *handle = lbox_check_read_view(L, 1);
+	if (handle->rv == NULL)
+		return luaL_error(L, "Read view is closed");
+	lbox_read_view_push_info(L, handle->rv);
+	return 1;
+}
+
+/**
+ * box.read_view.open({spaces = {...}, name = '...'}) opens a read
+ * view of the given memtx spaces.
+ */
+static int
+lbox_read_view_open(struct lua_State *L)
+{
+	if (lua_gettop(L) != 1 || !lua_istable(L, 1))
+		return luaL_error(L, "Usage: box.read_view.open({spaces = "
+				  "{...}[, name = '...']})");
+	lua_getfield(L, 1, "name");
+	const char *name = lua_isnil(L, -1) ? "unknown" : lua_tostring(L, -1);
+	if (name == NULL)
+		return luaL_error(L, "name must be a string");
+	lua_getfield(L, 1, "spaces");
+	if (!lua_istable(L, -1))
+		return luaL_error(L, "spaces must be a table of space names "
+				  "or ids");
+	int spaces_idx = lua_gettop(L);
+	uint32_t space_count = lua_objlen(L, spaces_idx);
+	if (space_count == 0)
+		return luaL_error(L, "spaces must not be empty");
+
+	struct lbox_read_view_handle *handle = lua_newuserdata(
+		L, sizeof(*handle));
+	handle->rv = NULL;
+	luaL_getmetatable(L, lbox_read_view_typename);
+	lua_setmetatable(L, -2);
+
+	size_t size = sizeof(struct lbox_read_view) +
+		      space_count * sizeof(struct lbox_read_view_space);
+	struct lbox_read_view *rv = xcalloc(1, size);
+	rv->id = ++lbox_read_view_last_id;
+	rv->name = xstrdup(name);
+	rv->open_time = fiber_clock();
+	rv->space_count = space_count;
+	rlist_add_tail_entry(&lbox_read_views, rv, in_read_views);
+	/*
+	 * Nothing here yields, so all the indexes are frozen at the
+	 * same moment.
+	 */
+	for (uint32_t i = 0; i < space_count; i++) {
+		lua_rawgeti(L, spaces_idx, i + 1);
+		struct space *space = lbox_read_view_find_space(L, -1);
+		lua_pop(L, 1);
+		if (space == NULL ||
+		    lbox_read_view_add_space(&rv->spaces[i], space) != 0) {
+			lbox_read_view_delete(rv);
+			return luaT_error(L);
+		}
+	}
+	handle->rv = rv;
+	return 1;
+}
+
+/** box.read_view.list() returns descriptions of open read views. */
+static int
+lbox_read_view_list(struct lua_State *L)
+{
+	lua_newtable(L);
+	int i = 0;
+	struct lbox_read_view *rv;
+	rlist_foreach_entry(rv, &lbox_read_views, in_read_views) {
+		lbox_read_view_push_info(L, rv);
+		lua_rawseti(L, -2, ++i);
+	}
+	return 1;
+}
+
+void
+box_lua_read_view_init(struct lua_State *L)
+{
+	static const struct luaL_Reg lbox_read_view_meta[] = {
+		{"__tostring", lbox_read_view_tostring},
+		{"__gc", lbox_read_view_gc},
+		{"pairs", lbox_read_view_pairs},
+		{"info", lbox_read_view_info},
+		{"close", lbox_read_view_close},
+		{NULL, NULL},
+	};
+	luaL_register_type(L, lbox_read_view_typename, lbox_read_view_meta);
+
+	static const struct luaL_Reg lbox_read_view_lib[] = {
+		{"open", lbox_read_view_open},
+		{"list", lbox_read_view_list},
+		{NULL, NULL},
+	};
+	luaL_register_module(L, "box.read_view", lbox_read_view_lib);
+	lua_pop(L, 1);
+}
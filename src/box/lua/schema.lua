@@ -17,8 +17,10 @@ local builtin = ffi.C
 -- performance fixup for hot functions
 local tuple_encode = box.internal.tuple.encode
 local tuple_bless = box.internal.tuple.bless
+local tuple_bless_referenced = box.internal.tuple.bless_referenced
 local is_tuple = box.tuple.is
 assert(tuple_encode ~= nil and tuple_bless ~= nil and is_tuple ~= nil)
+assert(tuple_bless_referenced ~= nil)
 local cord_ibuf_take = buffer.internal.cord_ibuf_take
 local cord_ibuf_put = buffer.internal.cord_ibuf_put
 
@@ -43,6 +45,9 @@ ffi.cdef[[
     void
     box_iterator_free(box_iterator_t *itr);
     /** \endcond public */
+    ssize_t
+    box_iterator_next_batch(box_iterator_t *itr, box_tuple_t **result,
+                            uint32_t count);
     /** \cond public */
     ssize_t
     box_index_len(uint32_t space_id, uint32_t index_id);
@@ -107,7 +112,14 @@ ffi.cdef[[
     box_select(uint32_t space_id, uint32_t index_id,
                int iterator, uint32_t offset, uint32_t limit,
                const char *key, const char *key_end,
-               struct port *port);
+               const char **packed_pos, const char **packed_pos_end,
+               bool update_pos, struct port *port);
+
+    size_t
+    box_region_used(void);
+
+    void
+    box_region_truncate(size_t size);
 
     void password_prepare(const char *password, int len,
                           char *out, int out_len);
@@ -443,6 +455,7 @@ box.schema.space.create = function(name, options)
         is_local = 'boolean',
         temporary = 'boolean',
         is_sync = 'boolean',
+        read_view_enabled = 'boolean',
     }
     local options_defaults = {
         engine = 'memtx',
@@ -487,7 +500,8 @@ box.schema.space.create = function(name, options)
     local space_options = setmap({
         group_id = options.is_local and 1 or nil,
         temporary = options.temporary and true or nil,
-        is_sync = options.is_sync
+        is_sync = options.is_sync,
+        read_view_enabled = options.read_view_enabled,
     })
     _space:insert{id, uid, name, options.engine, options.field_count,
         space_options, format}
@@ -580,6 +594,7 @@ local alter_space_template = {
     format = 'table',
     temporary = 'boolean',
     is_sync = 'boolean',
+    read_view_enabled = 'boolean',
     name = 'string',
 }
 
@@ -616,6 +631,10 @@ box.schema.space.alter = function(space_id, options)
         flags.is_sync = options.is_sync
     end
 
+    if options.read_view_enabled ~= nil then
+        flags.read_view_enabled = options.read_view_enabled
+    end
+
     local format
     if options.format ~= nil then
         format = update_format(options.format)
@@ -1085,8 +1104,10 @@ local index_options = {
     range_size = 'number',
     page_size = 'number',
     bloom_fpr = 'number',
+    compaction_strategy = 'string',
     func = 'number, string',
     hint = 'boolean',
+    multipart_hint = 'boolean',
 }
 
 local function jsonpaths_from_idx_parts(parts)
@@ -1190,6 +1211,11 @@ box.schema.index.create = function(space_id, name, options)
         box.error(box.error.MODIFY_INDEX, name, space.name,
                 "hint is only reasonable with memtx tree index")
     end
+    if options.multipart_hint and
+            (options.type ~= 'tree' or box.space[space_id].engine ~= 'memtx') then
+        box.error(box.error.MODIFY_INDEX, name, space.name,
+                "multipart_hint is only reasonable with memtx tree index")
+    end
     if options.hint and options.func then
         box.error(box.error.MODIFY_INDEX, name, space.name,
                 "functional index can't use hints")
@@ -1232,8 +1258,10 @@ box.schema.index.create = function(space_id, name, options)
             run_count_per_level = options.run_count_per_level,
             run_size_ratio = options.run_size_ratio,
             bloom_fpr = options.bloom_fpr,
+            compaction_strategy = options.compaction_strategy,
             func = options.func,
             hint = options.hint,
+            multipart_hint = options.multipart_hint,
     }
     local field_type_aliases = {
         num = 'unsigned'; -- Deprecated since 1.7.2
@@ -1386,6 +1414,12 @@ box.schema.index.alter = function(space_id, index_id, options)
                                           space.name,
             "hint is only reasonable with memtx tree index")
     end
+    if options.multipart_hint and
+       (options.type ~= 'tree' or box.space[space_id].engine ~= 'memtx') then
+        box.error(box.error.MODIFY_INDEX, space.index[index_id].name,
+                                          space.name,
+            "multipart_hint is only reasonable with memtx tree index")
+    end
     if options.hint and options.func then
         box.error(box.error.MODIFY_INDEX, space.index[index_id].name,
                                           space.name,
@@ -1482,6 +1516,78 @@ local iterator_gen_luac = function(param, state) -- luacheck: no unused args
     end
 end
 
+--
+-- Batched iterators fetch up to batch.size tuples per call to C
+-- into batch.tuples and then return them one by one without leaving
+-- Lua. *param* is the batch, *state* is the `struct iterator` cdata.
+--
+local iterator_batch_ptuples_t = ffi.typeof('box_tuple_t *[?]')
+
+local function iterator_batch_new(keybuf, size, is_ffi)
+    return {
+        -- Prevents the key from being collected, see iterator_gen.
+        keybuf = keybuf,
+        size = size,
+        tuples = {},
+        ptuples = is_ffi and iterator_batch_ptuples_t(size) or nil,
+        pos = 1,
+        count = 0,
+        is_eof = false,
+    }
+end
+
+local function iterator_batch_fill(batch, state)
+    local count
+    if batch.ptuples ~= nil then
+        count = tonumber(builtin.box_iterator_next_batch(state, batch.ptuples,
+                                                         batch.size))
+        if count < 0 then
+            return box.error()
+        end
+        for i = 1, count do
+            batch.tuples[i] = tuple_bless_referenced(batch.ptuples[i - 1])
+        end
+    else
+        count = internal.iterator_next_batch(state, batch.tuples, batch.size)
+    end
+    batch.pos = 1
+    batch.count = count
+    batch.is_eof = count < batch.size
+end
+
+local iterator_gen_batch = function(batch, state)
+    if batch.pos > batch.count then
+        if batch.is_eof then
+            return nil
+        end
+        iterator_batch_fill(batch, state)
+        if batch.count == 0 then
+            return nil
+        end
+    end
+    local pos = batch.pos
+    local tuple = batch.tuples[pos]
+    -- Don't keep the returned tuple referenced by the batch.
+    batch.tuples[pos] = nil
+    batch.pos = pos + 1
+    return state, tuple
+end
+
+-- Returns the batch size of index:pairs() or nil if not batched.
+local function check_pairs_batch_size(opts)
+    if type(opts) ~= 'table' or opts.batch_size == nil then
+        return nil
+    end
+    local size = opts.batch_size
+    if type(size) ~= 'number' or size < 1 or size > 0xffffffff or
+       math.floor(size) ~= size then
+        box.error(box.error.ILLEGAL_PARAMS,
+                  "options parameter 'batch_size' should be a positive " ..
+                  "integer")
+    end
+    return size
+end
+
 -- global struct port instance to use by select()/get()
 local port_c = ffi.new('struct port_c')
 
@@ -1886,6 +1992,7 @@ base_index_mt.pairs_ffi = function(index, key, opts)
     local ibuf = cord_ibuf_take()
     local pkey, pkey_end = tuple_encode(ibuf, key)
     local itype = check_iterator_type(opts, pkey + 1 >= pkey_end);
+    local batch_size = check_pairs_batch_size(opts)
 
     local keybuf = ffi.string(pkey, pkey_end - pkey)
     cord_ibuf_put(ibuf)
@@ -1895,6 +2002,11 @@ base_index_mt.pairs_ffi = function(index, key, opts)
     if cdata == nil then
         box.error()
     end
+    if batch_size ~= nil then
+        return fun.wrap(iterator_gen_batch,
+            iterator_batch_new(keybuf, batch_size, true),
+            ffi.gc(cdata, builtin.box_iterator_free))
+    end
     return fun.wrap(iterator_gen, keybuf,
         ffi.gc(cdata, builtin.box_iterator_free))
 end
@@ -1902,9 +2014,17 @@ base_index_mt.pairs_luac = function(index, key, opts)
     check_index_arg(index, 'pairs')
     key = keify(key)
     local itype = check_iterator_type(opts, #key == 0);
+    local batch_size = check_pairs_batch_size(opts)
     local keymp = msgpack.encode(key)
     local keybuf = ffi.string(keymp, #keymp)
     local cdata = internal.iterator(index.space_id, index.id, itype, keymp);
+    if batch_size ~= nil then
+        -- The iterator may yield, so batches are fetched with the
+        -- Lua C API rather than FFI.
+        return fun.wrap(iterator_gen_batch,
+            iterator_batch_new(keybuf, batch_size, false),
+            ffi.gc(cdata, builtin.box_iterator_free))
+    end
     return fun.wrap(iterator_gen_luac, keybuf,
         ffi.gc(cdata, builtin.box_iterator_free))
 end
@@ -1955,6 +2075,8 @@ local function check_select_opts(opts, key_is_nil)
     local offset = 0
     local limit = 4294967295
     local iterator = check_iterator_type(opts, key_is_nil)
+    local after = nil
+    local fetch_pos = false
     if opts ~= nil then
         if opts.offset ~= nil then
             offset = opts.offset
@@ -1962,23 +2084,68 @@ local function check_select_opts(opts, key_is_nil)
         if opts.limit ~= nil then
             limit = opts.limit
         end
+        if opts.after ~= nil then
+            after = opts.after
+            if type(after) ~= 'string' and type(after) ~= 'table' and
+               not is_tuple(after) then
+                box.error(box.error.ILLEGAL_PARAMS,
+                          "options parameter 'after' should be of type " ..
+                          "string, table, tuple")
+            end
+        end
+        if opts.fetch_pos ~= nil then
+            fetch_pos = opts.fetch_pos
+            if type(fetch_pos) ~= 'boolean' then
+                box.error(box.error.ILLEGAL_PARAMS,
+                          "options parameter 'fetch_pos' should be of " ..
+                          "type boolean")
+            end
+        end
+    end
+    return iterator, offset, limit, after, fetch_pos
+end
+
+-- Convert the 'after' option of select to a position string.
+local function select_after_pos(index, after)
+    if after == nil or type(after) == 'string' then
+        return after
     end
-    return iterator, offset, limit
+    return internal.tuple_pos(index.space_id, index.id, after)
 end
 
+local select_pos = ffi.new('const char *[1]')
+local select_pos_end = ffi.new('const char *[1]')
+
 base_index_mt.select_ffi = function(index, key, opts)
     check_index_arg(index, 'select')
     local ibuf = cord_ibuf_take()
     local key, key_end = tuple_encode(ibuf, key)
-    local iterator, offset, limit = check_select_opts(opts, key + 1 >= key_end)
+    local iterator, offset, limit, after, fetch_pos =
+        check_select_opts(opts, key + 1 >= key_end)
+    after = select_after_pos(index, after)
+    local region_svp = builtin.box_region_used()
+    if after ~= nil then
+        select_pos[0] = after
+        select_pos_end[0] = select_pos[0] + #after
+    else
+        select_pos[0] = nil
+        select_pos_end[0] = nil
+    end
 
     local port = ffi.cast('struct port *', port_c)
     local nok = builtin.box_select(index.space_id, index.id, iterator, offset,
-                                   limit, key, key_end, port) ~= 0
+                                   limit, key, key_end, select_pos,
+                                   select_pos_end, fetch_pos, port) ~= 0
     cord_ibuf_put(ibuf)
     if nok then
+        builtin.box_region_truncate(region_svp)
         return box.error()
     end
+    local pos = nil
+    if fetch_pos and select_pos[0] ~= nil then
+        pos = ffi.string(select_pos[0], select_pos_end[0] - select_pos[0])
+    end
+    builtin.box_region_truncate(region_svp)
 
     local ret = {}
     local entry = port_c.first
@@ -1987,15 +2154,42 @@ base_index_mt.select_ffi = function(index, key, opts)
         entry = entry.next
     end
     builtin.port_destroy(port);
+    if fetch_pos then
+        return ret, pos
+    end
     return ret
 end
 
 base_index_mt.select_luac = function(index, key, opts)
     check_index_arg(index, 'select')
     local key = keify(key)
-    local iterator, offset, limit = check_select_opts(opts, #key == 0)
+    local iterator, offset, limit, after, fetch_pos =
+        check_select_opts(opts, #key == 0)
+    after = select_after_pos(index, after)
     return internal.select(index.space_id, index.id, iterator,
-        offset, limit, key)
+        offset, limit, key, after, fetch_pos)
+end
+
+base_index_mt.tuple_pos = function(index, tuple)
+    check_index_arg(index, 'tuple_pos')
+    if type(tuple) ~= 'table' and not is_tuple(tuple) then
+        box.error(box.error.ILLEGAL_PARAMS,
+                  "Usage: index:tuple_pos(tuple)")
+    end
+    return internal.tuple_pos(index.space_id, index.id, tuple)
+end
+
+base_index_mt.get_many = function(index, keys)
+    check_index_arg(index, 'get_many')
+    if type(keys) ~= 'table' then
+        box.error(box.error.ILLEGAL_PARAMS,
+                  "Usage: index:get_many({key1, key2, ...})")
+    end
+    local keified = {}
+    for i, key in ipairs(keys) do
+        keified[i] = keify(key)
+    end
+    return internal.get_many(index.space_id, index.id, keified)
 end
 
 base_index_mt.update = function(index, key, ops)
@@ -2015,6 +2209,29 @@ base_index_mt.compact = function(index)
     return internal.compact(index.space_id, index.id)
 end
 
+base_index_mt.hot_keys_enable = function(index, opts)
+    check_index_arg(index, 'hot_keys_enable')
+    check_param_table(opts, {sample_rate = 'number'})
+    local sample_rate = opts and opts.sample_rate or 16
+    return internal.hot_keys_enable(index.space_id, index.id, sample_rate)
+end
+
+base_index_mt.hot_keys_disable = function(index)
+    check_index_arg(index, 'hot_keys_disable')
+    return internal.hot_keys_disable(index.space_id, index.id)
+end
+
+base_index_mt.hot_keys = function(index, k)
+    check_index_arg(index, 'hot_keys')
+    if k == nil then
+        k = 10
+    elseif type(k) ~= 'number' or k < 0 then
+        box.error(box.error.ILLEGAL_PARAMS,
+                  "Usage: index:hot_keys([k])")
+    end
+    return internal.hot_keys(index.space_id, index.id, k)
+end
+
 base_index_mt.drop = function(index)
     check_index_arg(index, 'drop')
     return box.schema.index.drop(index.space_id, index.id)
@@ -2067,11 +2284,19 @@ space_mt.bsize = function(space)
     end
     return builtin.space_bsize(s)
 end
+space_mt.stat = function(space)
+    check_space_arg(space, 'stat')
+    return internal.space.stat(space.id)
+end
 
 space_mt.get = function(space, key)
     check_space_arg(space, 'get')
     return check_primary_index(space):get(key)
 end
+space_mt.get_many = function(space, keys)
+    check_space_arg(space, 'get_many')
+    return check_primary_index(space):get_many(keys)
+end
 space_mt.select = function(space, key, opts)
     check_space_arg(space, 'select')
     return check_primary_index(space):select(key, opts)
@@ -2097,6 +2322,22 @@ space_mt.replace = function(space, tuple)
     return internal.replace(space.id, tuple);
 end
 space_mt.put = space_mt.replace; -- put is an alias for replace
+space_mt.insert_many = function(space, tuples)
+    check_space_arg(space, 'insert_many')
+    if type(tuples) ~= 'table' then
+        box.error(box.error.ILLEGAL_PARAMS,
+                  "Usage: space:insert_many({tuple1, tuple2, ...})")
+    end
+    return internal.insert_many(space.id, tuples)
+end
+space_mt.replace_many = function(space, tuples)
+    check_space_arg(space, 'replace_many')
+    if type(tuples) ~= 'table' then
+        box.error(box.error.ILLEGAL_PARAMS,
+                  "Usage: space:replace_many({tuple1, tuple2, ...})")
+    end
+    return internal.replace_many(space.id, tuples)
+end
 space_mt.update = function(space, key, ops)
     check_space_arg(space, 'update')
     return check_primary_index(space):update(key, ops)
@@ -2153,6 +2394,98 @@ space_mt.truncate = function(space)
     check_space_arg(space, 'truncate')
     return internal.truncate(space.id)
 end
+-- Return a function that returns the next tuple of a bulk_load()
+-- source or nil at the end.
+local function bulk_load_source(source)
+    if type(source) == 'function' then
+        return source
+    end
+    if type(source) == 'table' and source.gen ~= nil then
+        -- A luafun iterator.
+        local gen, param, state = source.gen, source.param, source.state
+        return function()
+            local tuple
+            state, tuple = gen(param, state)
+            if state == nil then
+                return nil
+            end
+            return tuple
+        end
+    end
+    if type(source) == 'table' then
+        local i = 0
+        return function()
+            i = i + 1
+            return source[i]
+        end
+    end
+    box.error(box.error.ILLEGAL_PARAMS,
+              "source should be a table, an iterator or a function")
+end
+
+-- Fill an empty space from a source of tuples. The tuples are
+-- inserted in transactions of batch_size tuples, so the WAL gets one
+-- entry per batch. Each batch is read from the source before the
+-- transaction is started, so the source may yield. The space must
+-- have no secondary indexes: they should be created after the load,
+-- which builds each of them at once instead of inserting the keys
+-- one by one. If anything fails, the space is truncated, so it is
+-- either fully loaded or left empty.
+space_mt.bulk_load = function(space, source, opts)
+    check_space_arg(space, 'bulk_load')
+    check_space_exists(space)
+    check_param_table(opts, {batch_size = 'number'})
+    local batch_size = opts and opts.batch_size or 1000
+    if batch_size < 1 then
+        box.error(box.error.ILLEGAL_PARAMS,
+                  "batch_size should be a positive number")
+    end
+    if box.is_in_txn() then
+        box.error(box.error.ACTIVE_TRANSACTION)
+    end
+    local pk = check_primary_index(space)
+    local next_tuple = bulk_load_source(source)
+    if pk:min() ~= nil then
+        box.error(box.error.ILLEGAL_PARAMS,
+                  "bulk_load requires an empty space")
+    end
+    if box.space[box.schema.INDEX_ID]:count({space.id}) > 1 then
+        box.error(box.error.ILLEGAL_PARAMS,
+                  "bulk_load requires a space without secondary " ..
+                  "indexes, create them after the load")
+    end
+    local count = 0
+    local ok, err = pcall(function()
+        local done = false
+        while not done do
+            local batch = {}
+            for _ = 1, batch_size do
+                local tuple = next_tuple()
+                if tuple == nil then
+                    done = true
+                    break
+                end
+                table.insert(batch, tuple)
+            end
+            if #batch > 0 then
+                box.begin()
+                for _, tuple in ipairs(batch) do
+                    space:insert(tuple)
+                end
+                box.commit()
+                count = count + #batch
+            end
+        end
+    end)
+    if not ok then
+        if box.is_in_txn() then
+            box.rollback()
+        end
+        space:truncate()
+        error(err, 0)
+    end
+    return count
+end
 space_mt.format = function(space, format)
     check_space_arg(space, 'format')
     return box.schema.space.format(space.id, format)
@@ -35,6 +35,8 @@
 #include "box/sql/sqlLimit.h"
 #include "lua/utils.h"
 #include "lua/trigger.h"
+#include "lua/info.h"
+#include "info/info.h"
 
 extern "C" {
 	#include <lua.h>
@@ -257,6 +259,11 @@ lbox_fillspace(struct lua_State *L, struct space *space, int i)
 	lua_pushboolean(L, space->def->opts.is_sync);
 	lua_settable(L, i);
 
+	/* space.read_view_enabled */
+	lua_pushstring(L, "read_view_enabled");
+	lua_pushboolean(L, space->def->opts.read_view_enabled);
+	lua_settable(L, i);
+
 	lua_pushstring(L, "enabled");
 	lua_pushboolean(L, space_index(space, 0) != 0);
 	lua_settable(L, i);
@@ -349,6 +356,14 @@ lbox_fillspace(struct lua_State *L, struct space *space, int i)
 			lua_pushnil(L);
 			lua_setfield(L, -2, "hint");
 		}
+		if (space_is_memtx(space) && index_def->type == TREE &&
+		    index_opts->multipart_hint) {
+			lua_pushboolean(L, true);
+			lua_setfield(L, -2, "multipart_hint");
+		} else {
+			lua_pushnil(L);
+			lua_setfield(L, -2, "multipart_hint");
+		}
 
 		if (index_opts->func_id > 0) {
 			lua_pushstring(L, "func");
@@ -527,6 +542,26 @@ box_lua_space_new_or_delete(struct trigger *trigger, void *event)
 	return 0;
 }
 
+/**
+ * Return memory usage and operation counters of a space.
+ * @param Lua space id.
+ * @retval Lua table, see space_stat().
+ */
+static int
+lbox_space_stat(struct lua_State *L)
+{
+	if (lua_gettop(L) != 1 || !lua_isnumber(L, 1))
+		return luaL_error(L, "usage: space.stat(space_id)");
+	uint32_t space_id = lua_tonumber(L, 1);
+	struct space *space = space_cache_find(space_id);
+	if (space == NULL)
+		return luaT_error(L);
+	struct info_handler info;
+	luaT_info_handler_create(&info, L);
+	space_stat(space, &info);
+	return 1;
+}
+
 static struct trigger on_alter_space_in_lua = {
 	RLIST_LINK_INITIALIZER, box_lua_space_new_or_delete, NULL, NULL
 };
@@ -705,6 +740,7 @@ box_lua_space_init(struct lua_State *L)
 
 	static const struct luaL_Reg space_internal_lib[] = {
 		{"frommap", lbox_space_frommap},
+		{"stat", lbox_space_stat},
 		{NULL, NULL}
 	};
 	luaL_register(L, "box.internal.space", space_internal_lib);
@@ -42,6 +42,7 @@
 #include "box/iproto.h"
 #include "box/engine.h"
 #include "box/vinyl.h"
+#include "box/wal.h"
 #include "box/sql.h"
 #include "info/info.h"
 #include "lua/info.h"
@@ -214,7 +215,8 @@ lbox_stat_net_index(struct lua_State *L)
  * - STREAMS: total, rps, current;
  * - REQUESTS: total, rps, current;
  * - REQUESTS_IN_PROGRESS: total, rps, current;
- * - REQUESTS_IN_STREAM_QUEUE: total, rps, current.
+ * - REQUESTS_IN_STREAM_QUEUE: total, rps, current;
+ * - REQUESTS_EXPIRED: total, rps.
  *
  * These fields have the following meaning:
  *
@@ -279,6 +281,24 @@ lbox_stat_sql(struct lua_State *L)
 	return 1;
 }
 
+static int
+lbox_stat_wal(struct lua_State *L)
+{
+	struct info_handler info;
+	luaT_info_handler_create(&info, L);
+	wal_stat(&info);
+	return 1;
+}
+
+static int
+lbox_stat_latency(struct lua_State *L)
+{
+	struct info_handler info;
+	luaT_info_handler_create(&info, L);
+	iproto_latency_stat(&info);
+	return 1;
+}
+
 static const struct luaL_Reg lbox_stat_meta [] = {
 	{"__index", lbox_stat_index},
 	{"__call",  lbox_stat_call},
@@ -305,6 +325,8 @@ box_lua_stat_init(struct lua_State *L)
 		{"vinyl", lbox_stat_vinyl},
 		{"reset", lbox_stat_reset},
 		{"sql", lbox_stat_sql},
+		{"wal", lbox_stat_wal},
+		{"latency", lbox_stat_latency},
 		{NULL, NULL}
 	};
 
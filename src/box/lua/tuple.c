@@ -81,6 +81,15 @@ uint32_t CTID_STRUCT_TUPLE_REF;
  */
 static int luaT_tuple_encode_table_ref = LUA_NOREF;
 
+/**
+ * <lbox_tuple_gc>() reference in the Lua registry.
+ *
+ * The finalizer is set for every tuple pushed to Lua, so pushing
+ * a cached function instead of <lua_pushcfunction>() saves one
+ * GCfunc allocation per tuple.
+ */
+static int lbox_tuple_gc_ref = LUA_NOREF;
+
 box_tuple_t *
 luaT_checktuple(struct lua_State *L, int idx)
 {
@@ -282,6 +291,20 @@ luaT_tuple_encode(struct lua_State *L, int idx, size_t *tuple_len_ptr)
 box_tuple_t *
 luaT_tuple_new(struct lua_State *L, int idx, box_tuple_format_t *format)
 {
+	struct tuple *orig = luaT_istuple(L, idx);
+	if (orig != NULL) {
+		/*
+		 * Tuples are immutable, so a tuple of the same format
+		 * can be returned as is. Otherwise its data is already
+		 * MsgPack and only needs to be copied and validated
+		 * against the new format.
+		 */
+		if (tuple_format(orig) == format)
+			return tuple_bless(orig);
+		uint32_t size;
+		const char *data = tuple_data_range(orig, &size);
+		return box_tuple_new(format, data, data + size);
+	}
 	struct ibuf *ibuf = cord_ibuf_take();
 	size_t tuple_len;
 	box_tuple_t *tuple;
@@ -687,7 +710,8 @@ luaT_pushtuple(struct lua_State *L, box_tuple_t *tuple)
 	*ptr = tuple;
 	/* The order is important - first reference tuple, next set gc */
 	box_tuple_ref(tuple);
-	lua_pushcfunction(L, lbox_tuple_gc);
+	assert(lbox_tuple_gc_ref != LUA_NOREF);
+	lua_rawgeti(L, LUA_REGISTRYINDEX, lbox_tuple_gc_ref);
 	luaL_setcdatagc(L, -2);
 }
 
@@ -757,4 +781,7 @@ box_lua_tuple_init(struct lua_State *L)
 
 	lua_pushcfunction(L, luaT_tuple_encode_table);
 	luaT_tuple_encode_table_ref = luaL_ref(L, LUA_REGISTRYINDEX);
+
+	lua_pushcfunction(L, lbox_tuple_gc);
+	lbox_tuple_gc_ref = luaL_ref(L, LUA_REGISTRYINDEX);
 }
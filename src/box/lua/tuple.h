@@ -114,6 +114,9 @@ luaT_tuple_encode(struct lua_State *L, int idx, size_t *tuple_len_ptr);
  *
  * @sa box_tuple_ref()
  *
+ * If the argument is a tuple of the given format, it is returned
+ * as is. A tuple of another format is copied without encoding.
+ *
  * In case of an error set a diag and return NULL.
  */
 API_EXPORT box_tuple_t *
@@ -58,12 +58,17 @@ box_tuple_update(box_tuple_t *tuple, const char *expr, const char *expr_end);
 
 box_tuple_t *
 box_tuple_upsert(box_tuple_t *tuple, const char *expr, const char *expr_end);
+
+const char *
+box_tuple_field_by_path(box_tuple_t *tuple, const char *path,
+                        uint32_t path_len);
 ]]
 
 local builtin = ffi.C
 
 local tuple_t = ffi.typeof('box_tuple_t')
 local const_tuple_ref_t = ffi.typeof('box_tuple_t&')
+local const_uint8_ptr_t = ffi.typeof('const uint8_t *')
 
 local is_tuple = function(tuple)
     return tuple ~= nil and type(tuple) == 'cdata' and ffi.istype(const_tuple_ref_t, tuple)
@@ -113,6 +118,13 @@ local tuple_bless = function(tuple)
     return tuple_ref
 end
 
+-- Same as tuple_bless(), but takes over the reference that the
+-- caller already holds instead of taking a new one.
+local tuple_bless_referenced = function(tuple)
+    local tuple_ref = ffi.gc(ffi.cast(const_tuple_ref_t, tuple), tuple_gc)
+    return tuple_ref
+end
+
 local tuple_check = function(tuple, usage)
     if not is_tuple(tuple) then
         error('Usage: ' .. usage)
@@ -282,9 +294,25 @@ end
 
 msgpackffi.on_encode(const_tuple_ref_t, tuple_to_msgpack)
 
+-- The field is looked up via FFI rather than the Lua C API,
+-- because then access to a field by name can be JITed. Extension
+-- types are decoded in C, because msgpackffi doesn't know all of
+-- them.
 local function tuple_field_by_path(tuple, path)
     tuple_check(tuple, "tuple['field_name']");
-    return internal.tuple.tuple_field_by_path(tuple, path)
+    if #path == 0 then
+        return nil
+    end
+    local field = builtin.box_tuple_field_by_path(tuple, path, #path)
+    if field == nil then
+        return nil
+    end
+    local c = ffi.cast(const_uint8_ptr_t, field)[0]
+    if (c >= 0xc7 and c <= 0xc9) or (c >= 0xd4 and c <= 0xd8) then
+        return internal.tuple.tuple_field_by_path(tuple, path)
+    end
+    -- Use () to shrink stack to the first return value
+    return (msgpackffi.decode_unchecked(field))
 end
 
 local methods = {
@@ -364,6 +392,7 @@ internal.tuple.tostring = nil
 
 -- internal api for box.select and iterators
 internal.tuple.bless = tuple_bless
+internal.tuple.bless_referenced = tuple_bless_referenced
 internal.tuple.encode = tuple_encode
 
 -- Public API, additional to implemented in C.
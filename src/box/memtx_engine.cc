@@ -37,7 +37,9 @@
 
 #include "fiber.h"
 #include "errinj.h"
+#include "clock.h"
 #include "coio_file.h"
+#include "coio_task.h"
 #include "tuple.h"
 #include "txn.h"
 #include "memtx_tx.h"
@@ -51,8 +53,17 @@
 #include "gc.h"
 #include "raft.h"
 #include "txn_limbo.h"
+#include "wal.h"
 #include "memtx_allocator.h"
-
+#include "xlog_reader.h"
+#include "info/info.h"
+
+#include <limits.h>
+#include <sys/mman.h>
+#if defined(__linux__)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 #include <type_traits>
 
 /* sync snapshot every 16MB */
@@ -87,15 +98,69 @@ memtx_end_build_primary_key(struct space *space, void *param)
 	return 0;
 }
 
+/** State of a secondary index being built at the end of recovery. */
+struct memtx_index_build {
+	/** The index. */
+	struct index *index;
+	/** Fiber waiting for the index build array to be sorted. */
+	struct fiber *sort_fiber;
+	/** Time spent on building the index so far, in seconds. */
+	double time;
+};
+
+/** Sort an index build array. Runs in a coio thread. */
+static ssize_t
+memtx_index_build_sort_f(va_list ap)
+{
+	struct memtx_index_build *build = va_arg(ap, struct memtx_index_build *);
+	double start = clock_monotonic();
+	memtx_tree_index_sort_build_array(build->index);
+	build->time += clock_monotonic() - start;
+	return 0;
+}
+
+static int
+memtx_index_build_sort_fiber_f(va_list ap)
+{
+	struct memtx_index_build *build = va_arg(ap, struct memtx_index_build *);
+	/*
+	 * On failure the array stays unsorted and will be sorted
+	 * by index_end_build() in the tx thread.
+	 */
+	if (coio_call(memtx_index_build_sort_f, build) < 0)
+		diag_log();
+	return 0;
+}
+
+/** Remember how much time it took to build an index. */
+static void
+memtx_engine_add_index_build_stat(struct memtx_engine *memtx,
+				  struct space *space,
+				  struct memtx_index_build *build)
+{
+	struct memtx_index_build_stat *stat =
+		(struct memtx_index_build_stat *)xmalloc(sizeof(*stat));
+	stat->space_name = xstrdup(space_name(space));
+	stat->index_name = xstrdup(build->index->def->name);
+	stat->time = build->time;
+	stailq_add_tail_entry(&memtx->index_build_stats, stat, in_stats);
+}
+
 /**
  * Secondary indexes are built in bulk after all data is
  * recovered. This function enables secondary keys on a space.
  * Data dictionary spaces are an exception, they are fully
  * built right from the start.
+ *
+ * All tuples are fed to the indexes in the tx thread, then
+ * build arrays of TREE indexes are sorted concurrently in coio
+ * threads, and finally the indexes are built from the sorted
+ * arrays in the tx thread again.
  */
 static int
 memtx_build_secondary_keys(struct space *space, void *param)
 {
+	struct memtx_engine *memtx = (struct memtx_engine *)param;
 	struct memtx_space *memtx_space = (struct memtx_space *)space;
 	if (space->engine != param || space_index(space, 0) == NULL ||
 	    memtx_space->replace == memtx_space_replace_all_keys)
@@ -111,10 +176,46 @@ memtx_build_secondary_keys(struct space *space, void *param)
 				 space_name(space));
 		}
 
-		for (uint32_t j = 1; j < space->index_count; j++) {
-			if (index_build(space->index[j], pk) < 0)
-				return -1;
+		uint32_t build_count = space->index_count - 1;
+		struct memtx_index_build *builds = (struct memtx_index_build *)
+			xcalloc(build_count, sizeof(*builds));
+		int rc = 0;
+		uint32_t fed_count;
+		for (fed_count = 0; fed_count < build_count; fed_count++) {
+			struct memtx_index_build *build = &builds[fed_count];
+			build->index = space->index[fed_count + 1];
+			double start = clock_monotonic();
+			rc = index_build_feed(build->index, pk);
+			build->time = clock_monotonic() - start;
+			if (rc != 0)
+				break;
+			if (build->index->def->type != TREE || n_tuples == 0)
+				continue;
+			build->sort_fiber = fiber_new("index.build",
+					memtx_index_build_sort_fiber_f);
+			if (build->sort_fiber == NULL) {
+				diag_log();
+				continue;
+			}
+			fiber_set_joinable(build->sort_fiber, true);
+			fiber_start(build->sort_fiber, build);
+		}
+		for (uint32_t j = 0; j < fed_count; j++) {
+			struct memtx_index_build *build = &builds[j];
+			if (build->sort_fiber != NULL)
+				fiber_join(build->sort_fiber);
+			if (rc != 0)
+				continue;
+			double start = clock_monotonic();
+			index_end_build(build->index);
+			build->time += clock_monotonic() - start;
+			say_verbose("Index '%s' built in %.3f sec",
+				    build->index->def->name, build->time);
+			memtx_engine_add_index_build_stat(memtx, space, build);
 		}
+		free(builds);
+		if (rc != 0)
+			return -1;
 
 		if (n_tuples > 0) {
 			say_info("Space '%s': done", space_name(space));
@@ -132,6 +233,13 @@ memtx_engine_shutdown(struct engine *engine)
 		checkpoint_cancel(memtx->checkpoint);
 	if (memtx->replica_join_cord != NULL)
 		replica_join_cancel(memtx->replica_join_cord);
+	struct memtx_index_build_stat *stat, *next_stat;
+	stailq_foreach_entry_safe(stat, next_stat, &memtx->index_build_stats,
+				  in_stats) {
+		free(stat->space_name);
+		free(stat->index_name);
+		free(stat);
+	}
 	mempool_destroy(&memtx->iterator_pool);
 	if (mempool_is_initialized(&memtx->rtree_iterator_pool))
 		mempool_destroy(&memtx->rtree_iterator_pool);
@@ -153,6 +261,50 @@ static int
 memtx_engine_recover_snapshot_row(struct memtx_engine *memtx,
 				  struct xrow_header *row, int *is_space_system);
 
+/**
+ * Recover the snapshot using a background reader thread: the
+ * thread reads the file, checks crc32 and decompresses rows while
+ * the tx thread applies already read ones. Errors aren't
+ * tolerated so this path isn't used with force_recovery.
+ */
+static int
+memtx_engine_recover_snapshot_async(struct memtx_engine *memtx,
+				    const char *filename, int64_t signature)
+{
+	assert(!memtx->force_recovery);
+	struct xlog_reader *reader = xlog_reader_new(filename);
+	if (reader == NULL)
+		return -1;
+
+	int rc;
+	struct xrow_header row;
+	uint64_t row_count = 0;
+	int is_space_system = -1;
+	while ((rc = xlog_reader_next(reader, &row)) == 0) {
+		row.lsn = signature;
+		rc = memtx_engine_recover_snapshot_row(memtx, &row,
+						       &is_space_system);
+		if (rc < 0)
+			break;
+		++row_count;
+		if (row_count % 100000 == 0) {
+			say_info_ratelimited("%.1fM rows processed",
+					     row_count / 1e6);
+			fiber_yield_timeout(0);
+		}
+	}
+	if (rc < 0 || is_space_system < 0) {
+		xlog_reader_delete(reader);
+		return -1;
+	}
+	/* See the comment in memtx_engine_recover_snapshot(). */
+	if (!xlog_reader_is_eof(reader))
+		panic("snapshot `%s' has no EOF marker",
+		      xlog_reader_name(reader));
+	xlog_reader_delete(reader);
+	return 0;
+}
+
 int
 memtx_engine_recover_snapshot(struct memtx_engine *memtx,
 			      const struct vclock *vclock)
@@ -164,6 +316,9 @@ memtx_engine_recover_snapshot(struct memtx_engine *memtx,
 						    signature, NONE);
 
 	say_info("recovering from `%s'", filename);
+	if (!memtx->force_recovery)
+		return memtx_engine_recover_snapshot_async(memtx, filename,
+							   signature);
 	struct xlog_cursor cursor;
 	if (xlog_cursor_open(&cursor, filename) < 0)
 		return -1;
@@ -597,7 +752,8 @@ struct checkpoint {
 };
 
 static struct checkpoint *
-checkpoint_new(const char *snap_dirname, uint64_t snap_io_rate_limit)
+checkpoint_new(const char *snap_dirname, uint64_t snap_io_rate_limit,
+	       int snap_compress_threads, int snap_compression_level)
 {
 	struct checkpoint *ckpt = (struct checkpoint *)malloc(sizeof(*ckpt));
 	if (ckpt == NULL) {
@@ -609,8 +765,11 @@ checkpoint_new(const char *snap_dirname, uint64_t snap_io_rate_limit)
 	ckpt->waiting_for_snap_thread = false;
 	struct xlog_opts opts = xlog_opts_default;
 	opts.rate_limit = snap_io_rate_limit;
+	opts.rate_factor_f = wal_background_rate_factor;
 	opts.sync_interval = SNAP_SYNC_INTERVAL;
 	opts.free_cache = true;
+	opts.compress_threads = snap_compress_threads;
+	opts.compression_level = snap_compression_level;
 	xdir_create(&ckpt->dir, snap_dirname, SNAP, &INSTANCE_UUID, &opts);
 	vclock_create(&ckpt->vclock);
 	box_raft_checkpoint_local(&ckpt->raft);
@@ -771,7 +930,9 @@ memtx_engine_begin_checkpoint(struct engine *engine, bool is_scheduled)
 
 	assert(memtx->checkpoint == NULL);
 	memtx->checkpoint = checkpoint_new(memtx->snap_dir.dirname,
-					   memtx->snap_io_rate_limit);
+					   memtx->snap_io_rate_limit,
+					   memtx->snap_compress_threads,
+					   memtx->snap_compression_level);
 	if (memtx->checkpoint == NULL)
 		return -1;
 
@@ -889,8 +1050,16 @@ memtx_engine_collect_garbage(struct engine *engine, const struct vclock *vclock)
 
 static int
 memtx_engine_backup(struct engine *engine, const struct vclock *vclock,
+		    const struct engine_backup_point *since,
+		    struct engine_backup_point *point,
 		    engine_backup_cb cb, void *cb_arg)
 {
+	/*
+	 * There are no deltas for memtx snapshots so the snapshot
+	 * is listed by incremental backups, too.
+	 */
+	(void)since;
+	(void)point;
 	struct memtx_engine *memtx = (struct memtx_engine *)engine;
 	const char *filename = xdir_format_filename(&memtx->snap_dir,
 						    vclock_sum(vclock), NONE);
@@ -1137,7 +1306,8 @@ struct memtx_engine *
 memtx_engine_new(const char *snap_dirname, bool force_recovery,
 		 uint64_t tuple_arena_max_size, uint32_t objsize_min,
 		 bool dontdump, unsigned granularity,
-		 const char *allocator, float alloc_factor)
+		 const char *allocator, float alloc_factor,
+		 bool use_huge_pages, int numa_node)
 {
 	int64_t snap_signature;
 	struct memtx_engine *memtx =
@@ -1183,6 +1353,7 @@ memtx_engine_new(const char *snap_dirname, bool force_recovery,
 	}
 
 	stailq_create(&memtx->gc_queue);
+	stailq_create(&memtx->index_build_stats);
 	memtx->gc_fiber = fiber_new("memtx.gc", memtx_engine_gc_f);
 	if (memtx->gc_fiber == NULL)
 		goto fail;
@@ -1205,6 +1376,7 @@ memtx_engine_new(const char *snap_dirname, bool force_recovery,
 	quota_init(&memtx->quota, tuple_arena_max_size);
 	tuple_arena_create(&memtx->arena, &memtx->quota, tuple_arena_max_size,
 			   SLAB_SIZE, dontdump, "memtx");
+	memtx_arena_set_placement(&memtx->arena, use_huge_pages, numa_node);
 	slab_cache_create(&memtx->slab_cache, &memtx->arena);
 	memtx->free_mode = MEMTX_ENGINE_FREE;
 	float actual_alloc_factor;
@@ -1230,6 +1402,7 @@ memtx_engine_new(const char *snap_dirname, bool force_recovery,
 	memtx->state = MEMTX_INITIALIZED;
 	memtx->max_tuple_size = MAX_TUPLE_SIZE;
 	memtx->force_recovery = force_recovery;
+	memtx->snap_compression_level = XLOG_COMPRESSION_LEVEL_DEFAULT;
 
 	memtx->replica_join_cord = NULL;
 
@@ -1258,6 +1431,20 @@ memtx_engine_set_snap_io_rate_limit(struct memtx_engine *memtx, double limit)
 	memtx->snap_io_rate_limit = limit * 1024 * 1024;
 }
 
+void
+memtx_engine_set_snap_compress_threads(struct memtx_engine *memtx,
+				       int thread_count)
+{
+	memtx->snap_compress_threads = thread_count;
+}
+
+void
+memtx_engine_set_snap_compression_level(struct memtx_engine *memtx,
+					int level)
+{
+	memtx->snap_compression_level = level;
+}
+
 int
 memtx_engine_set_memory(struct memtx_engine *memtx, size_t size)
 {
@@ -1276,6 +1463,30 @@ memtx_engine_set_max_tuple_size(struct memtx_engine *memtx, size_t max_size)
 	memtx->max_tuple_size = max_size;
 }
 
+void
+memtx_engine_stat(struct memtx_engine *memtx, struct info_handler *h)
+{
+	info_begin(h);
+	info_table_begin(h, "index_build");
+	/* Stats of indexes of the same space go one after another. */
+	const char *space_name = NULL;
+	struct memtx_index_build_stat *stat;
+	stailq_foreach_entry(stat, &memtx->index_build_stats, in_stats) {
+		if (space_name == NULL ||
+		    strcmp(space_name, stat->space_name) != 0) {
+			if (space_name != NULL)
+				info_table_end(h);
+			space_name = stat->space_name;
+			info_table_begin(h, space_name);
+		}
+		info_append_double(h, stat->index_name, stat->time);
+	}
+	if (space_name != NULL)
+		info_table_end(h);
+	info_table_end(h);
+	info_end(h);
+}
+
 void
 memtx_enter_delayed_free_mode(struct memtx_engine *memtx)
 {
@@ -1296,6 +1507,43 @@ memtx_leave_delayed_free_mode(struct memtx_engine *memtx)
 	}
 }
 
+/**
+ * Advise the kernel on the placement of the preallocated part of the
+ * tuple arena: back it with transparent huge pages and bind it to the
+ * given NUMA node (-1 to not bind). Must be called before the memory is
+ * touched. Failures aren't fatal, since they only affect performance.
+ */
+static void
+memtx_arena_set_placement(struct slab_arena *arena, bool use_huge_pages,
+			  int numa_node)
+{
+	if (use_huge_pages) {
+#ifdef MADV_HUGEPAGE
+		if (madvise(arena->arena, arena->prealloc, MADV_HUGEPAGE) != 0)
+			say_syserror("failed to enable huge pages for memtx");
+#else
+		say_warn("huge pages are not supported on this platform");
+#endif
+	}
+	if (numa_node >= 0) {
+#if defined(__linux__) && defined(SYS_mbind)
+		/* Defined in <linux/mempolicy.h>. */
+		const int mpol_bind = 2;
+		const int bits = sizeof(unsigned long) * CHAR_BIT;
+		unsigned long mask[(MEMTX_NUMA_NODE_MAX + 1 + bits - 1) / bits];
+		memset(mask, 0, sizeof(mask));
+		mask[numa_node / bits] |= 1UL << (numa_node % bits);
+		if (syscall(SYS_mbind, arena->arena, arena->prealloc,
+			    mpol_bind, mask, sizeof(mask) * CHAR_BIT, 0) != 0) {
+			say_syserror("failed to bind memtx memory to NUMA "
+				     "node %d", numa_node);
+		}
+#else
+		say_warn("NUMA binding is not supported on this platform");
+#endif
+	}
+}
+
 template<class ALLOC>
 struct tuple *
 memtx_tuple_new(struct tuple_format *format, const char *data, const char *end)
@@ -1523,6 +1771,8 @@ memtx_index_def_change_requires_rebuild(struct index *index,
 		return true;
 	if (old_def->opts.hint != new_def->opts.hint)
 		return true;
+	if (old_def->opts.multipart_hint != new_def->opts.multipart_hint)
+		return true;
 
 	const struct key_def *old_cmp_def, *new_cmp_def;
 	if (index_depends_on_pk(index)) {
@@ -1554,6 +1804,13 @@ memtx_index_def_change_requires_rebuild(struct index *index,
 			return true;
 		if (old_part->exclude_null != new_part->exclude_null)
 			return true;
+		/*
+		 * Multipart hint layout depends on the types of
+		 * the key parts.
+		 */
+		if (new_cmp_def->multipart_hint &&
+		    old_part->type != new_part->type)
+			return true;
 	}
 	assert(old_cmp_def->is_multikey == new_cmp_def->is_multikey);
 	return false;
@@ -50,6 +50,7 @@ struct index;
 struct fiber;
 struct tuple;
 struct tuple_format;
+struct info_handler;
 
 /**
  * Free mode, determines a strategy for freeing up memory
@@ -130,6 +131,14 @@ struct memtx_engine {
 	struct xdir snap_dir;
 	/** Limit disk usage of checkpointing (bytes per second). */
 	uint64_t snap_io_rate_limit;
+	/**
+	 * Number of threads compressing a snapshot while it is
+	 * written. If 0, the snapshot is compressed by the
+	 * checkpoint thread itself.
+	 */
+	int snap_compress_threads;
+	/** zstd compression level used for snapshots. */
+	int snap_compression_level;
 	/** Skip invalid snapshot records if this flag is set. */
 	bool force_recovery;
 	/**
@@ -193,6 +202,23 @@ struct memtx_engine {
 	 * Free mode, determines a strategy for freeing up memory
 	 */
 	enum memtx_engine_free_mode free_mode;
+	/**
+	 * Statistics of secondary indexes built at the end of
+	 * recovery, linked by memtx_index_build_stat::in_stats.
+	 */
+	struct stailq index_build_stats;
+};
+
+/** Statistics of a secondary index built at the end of recovery. */
+struct memtx_index_build_stat {
+	/** Link in memtx_engine::index_build_stats. */
+	struct stailq_entry in_stats;
+	/** Name of the space the index belongs to. */
+	char *space_name;
+	/** Name of the index. */
+	char *index_name;
+	/** Time spent on building the index, in seconds. */
+	double time;
 };
 
 struct memtx_gc_task;
@@ -228,7 +254,8 @@ struct memtx_engine *
 memtx_engine_new(const char *snap_dirname, bool force_recovery,
 		 uint64_t tuple_arena_max_size, uint32_t objsize_min,
 		 bool dontdump, unsigned granularity,
-		 const char *allocator, float alloc_factor);
+		 const char *allocator, float alloc_factor,
+		 bool use_huge_pages, int numa_node);
 
 int
 memtx_engine_recover_snapshot(struct memtx_engine *memtx,
@@ -237,12 +264,24 @@ memtx_engine_recover_snapshot(struct memtx_engine *memtx,
 void
 memtx_engine_set_snap_io_rate_limit(struct memtx_engine *memtx, double limit);
 
+void
+memtx_engine_set_snap_compress_threads(struct memtx_engine *memtx,
+				       int thread_count);
+
+void
+memtx_engine_set_snap_compression_level(struct memtx_engine *memtx,
+					int level);
+
 int
 memtx_engine_set_memory(struct memtx_engine *memtx, size_t size);
 
 void
 memtx_engine_set_max_tuple_size(struct memtx_engine *memtx, size_t max_size);
 
+/** Dump memtx engine statistics to box.info.memtx(). */
+void
+memtx_engine_stat(struct memtx_engine *memtx, struct info_handler *h);
+
 /**
  * Enter tuple delayed free mode: tuple allocated before the call
  * won't be freed until memtx_leave_delayed_free_mode() is called.
@@ -265,7 +304,9 @@ extern struct tuple_format_vtab memtx_tuple_format_vtab;
 
 enum {
 	MEMTX_EXTENT_SIZE = 16 * 1024,
-	MEMTX_SLAB_SIZE = 4 * 1024 * 1024
+	MEMTX_SLAB_SIZE = 4 * 1024 * 1024,
+	/** Max NUMA node number allowed in box.cfg.memtx_numa_node. */
+	MEMTX_NUMA_NODE_MAX = 1023,
 };
 
 /**
@@ -309,13 +350,15 @@ static inline struct memtx_engine *
 memtx_engine_new_xc(const char *snap_dirname, bool force_recovery,
 		    uint64_t tuple_arena_max_size, uint32_t objsize_min,
 		    bool dontdump, unsigned granularity,
-		    const char *allocator, float alloc_factor)
+		    const char *allocator, float alloc_factor,
+		    bool use_huge_pages, int numa_node)
 {
 	struct memtx_engine *memtx;
 	memtx = memtx_engine_new(snap_dirname, force_recovery,
 				 tuple_arena_max_size,
 				 objsize_min, dontdump,
-				 granularity, allocator, alloc_factor);
+				 granularity, allocator, alloc_factor,
+				 use_huge_pages, numa_node);
 	if (memtx == NULL)
 		diag_raise();
 	return memtx;
@@ -39,6 +39,7 @@
 #include "space.h"
 #include "schema.h" /* space_by_id(), space_cache_find() */
 #include "errinj.h"
+#include "info/info.h"
 
 #include <small/mempool.h>
 
@@ -280,6 +281,66 @@ memtx_hash_index_bsize(struct index *base)
 					MEMTX_EXTENT_SIZE;
 }
 
+enum {
+	/** Max number of slots visited by index:stat(). */
+	MEMTX_HASH_STAT_SAMPLE_SIZE = 1 << 16,
+	/** Chains of this length and longer share a histogram bucket. */
+	MEMTX_HASH_STAT_CHAIN_LENGTH_MAX = 8,
+};
+
+/**
+ * Report the hash table size and its load factor. The chain length
+ * histogram is built from a sample of evenly spaced slots, so that
+ * index:stat() doesn't stall the tx thread on a huge index.
+ */
+static void
+memtx_hash_index_stat(struct index *base, struct info_handler *info)
+{
+	struct memtx_hash_index *index = (struct memtx_hash_index *)base;
+	struct light_index_core *hash_table = &index->hash_table;
+	info_begin(info);
+	info_append_int(info, "count", hash_table->count);
+	info_append_int(info, "table_size", hash_table->table_size);
+	info_append_double(info, "load_factor", hash_table->table_size == 0 ?
+			   0 : (double)hash_table->count /
+			   hash_table->table_size);
+	uint64_t histogram[MEMTX_HASH_STAT_CHAIN_LENGTH_MAX] = {0};
+	uint32_t step = MAX(hash_table->table_size /
+			    MEMTX_HASH_STAT_SAMPLE_SIZE, 1);
+	for (uint32_t slot = 0; slot < hash_table->table_size; slot += step) {
+		uint32_t length = light_index_chain_length(hash_table, slot);
+		if (length == 0)
+			continue;
+		length = MIN(length, (uint32_t)MEMTX_HASH_STAT_CHAIN_LENGTH_MAX);
+		histogram[length - 1]++;
+	}
+	info_table_begin(info, "chain_length");
+	for (int i = 0; i < MEMTX_HASH_STAT_CHAIN_LENGTH_MAX; i++) {
+		char key[16];
+		snprintf(key, sizeof(key), "%d%s", i + 1,
+			 i + 1 == MEMTX_HASH_STAT_CHAIN_LENGTH_MAX ? "+" : "");
+		info_append_int(info, key, histogram[i]);
+	}
+	info_table_end(info);
+	info_end(info);
+}
+
+/**
+ * Grow the hash table in advance, so that building an index over an
+ * existing space doesn't grow it step by step.
+ */
+static int
+memtx_hash_index_reserve(struct index *base, uint32_t size_hint)
+{
+	struct memtx_hash_index *index = (struct memtx_hash_index *)base;
+	if (light_index_reserve(&index->hash_table, size_hint) != 0) {
+		diag_set(OutOfMemory, MEMTX_EXTENT_SIZE, "memtx_hash_index",
+			 "reserve");
+		return -1;
+	}
+	return 0;
+}
+
 static int
 memtx_hash_index_random(struct index *base, uint32_t rnd, struct tuple **result)
 {
@@ -568,15 +629,20 @@ static const struct index_vtab memtx_hash_index_vtab = {
 	/* .random = */ memtx_hash_index_random,
 	/* .count = */ memtx_hash_index_count,
 	/* .get = */ memtx_hash_index_get,
+	/* .get_many = */ generic_index_get_many,
 	/* .replace = */ memtx_hash_index_replace,
 	/* .create_iterator = */ memtx_hash_index_create_iterator,
+	/* .create_iterator_with_offset = */
+		generic_index_create_iterator_with_offset,
 	/* .create_snapshot_iterator = */
 		memtx_hash_index_create_snapshot_iterator,
-	/* .stat = */ generic_index_stat,
+	/* .create_read_view_iterator = */
+		generic_index_create_read_view_iterator,
+	/* .stat = */ memtx_hash_index_stat,
 	/* .compact = */ generic_index_compact,
 	/* .reset_stat = */ generic_index_reset_stat,
 	/* .begin_build = */ generic_index_begin_build,
-	/* .reserve = */ generic_index_reserve,
+	/* .reserve = */ memtx_hash_index_reserve,
 	/* .build_next = */ generic_index_build_next,
 	/* .end_build = */ generic_index_end_build,
 };
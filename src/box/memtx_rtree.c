@@ -50,6 +50,8 @@ struct memtx_rtree_index {
 	struct index base;
 	unsigned dimension;
 	struct rtree tree;
+	/** Records collected by build_next() for bulk loading. */
+	struct rtree_builder builder;
 };
 
 /* {{{ Utilities. *************************************************/
@@ -173,6 +175,7 @@ static void
 memtx_rtree_index_destroy(struct index *base)
 {
 	struct memtx_rtree_index *index = (struct memtx_rtree_index *)base;
+	rtree_builder_destroy(&index->builder);
 	rtree_destroy(&index->tree);
 	free(index);
 }
@@ -284,16 +287,82 @@ memtx_rtree_index_reserve(struct index *base, uint32_t size_hint)
          * memory allocation will not fail during any operation
          * on rtree, because there is no error handling in the
          * rtree lib.
+         * During a build size_hint is the expected number of records,
+         * and the bulk load buffer is allocated for them.
          */
-	(void)size_hint;
 	ERROR_INJECT(ERRINJ_INDEX_RESERVE, {
 		diag_set(OutOfMemory, MEMTX_EXTENT_SIZE, "mempool", "new slab");
 		return -1;
 	});
+	struct memtx_rtree_index *index = (struct memtx_rtree_index *)base;
+	if (rtree_builder_reserve(&index->builder, &index->tree,
+				  size_hint) != 0) {
+		diag_set(OutOfMemory, size_hint * index->tree.page_branch_size,
+			 "realloc", "rtree builder");
+		return -1;
+	}
 	struct memtx_engine *memtx = (struct memtx_engine *)base->engine;
 	return memtx_index_extent_reserve(memtx, RESERVE_EXTENTS_BEFORE_REPLACE);
 }
 
+static void
+memtx_rtree_index_begin_build(struct index *base)
+{
+	struct memtx_rtree_index *index = (struct memtx_rtree_index *)base;
+	assert(rtree_number_of_records(&index->tree) == 0);
+	assert(index->builder.count == 0);
+	(void)index;
+}
+
+/**
+ * Number of index extents needed to bulk load the given number of
+ * records, including the matras directory.
+ */
+static int
+memtx_rtree_index_build_extent_count(struct memtx_rtree_index *index,
+				     size_t count)
+{
+	size_t pages = rtree_bulk_load_page_count(&index->tree, count);
+	size_t pages_per_extent = MEMTX_EXTENT_SIZE / index->tree.page_size;
+	size_t extents = DIV_ROUND_UP(pages, pages_per_extent);
+	extents += DIV_ROUND_UP(extents, MEMTX_EXTENT_SIZE / sizeof(void *));
+	return extents + 1 + RESERVE_EXTENTS_BEFORE_REPLACE;
+}
+
+static int
+memtx_rtree_index_build_next(struct index *base, struct tuple *tuple)
+{
+	struct memtx_rtree_index *index = (struct memtx_rtree_index *)base;
+	struct rtree_rect rect;
+	if (extract_rectangle(&rect, tuple, base->def) != 0)
+		return -1;
+	if (rtree_builder_add(&index->builder, &index->tree,
+			      &rect, tuple) != 0) {
+		diag_set(OutOfMemory, index->builder.capacity *
+			 index->tree.page_branch_size,
+			 "realloc", "rtree builder");
+		return -1;
+	}
+	/*
+	 * Reserve extents for all pages of the tree now, because
+	 * end_build() can't fail.
+	 */
+	struct memtx_engine *memtx = (struct memtx_engine *)base->engine;
+	int extents = memtx_rtree_index_build_extent_count(
+					index, index->builder.count);
+	return memtx_index_extent_reserve(memtx, extents);
+}
+
+static void
+memtx_rtree_index_end_build(struct index *base)
+{
+	struct memtx_rtree_index *index = (struct memtx_rtree_index *)base;
+	if (rtree_builder_load(&index->builder, &index->tree) != 0)
+		panic("failed to allocate memory for rtree index '%s'",
+		      base->def->name);
+	rtree_builder_destroy(&index->builder);
+}
+
 static struct iterator *
 memtx_rtree_index_create_iterator(struct index *base,  enum iterator_type type,
 				  const char *key, uint32_t part_count)
@@ -384,17 +453,22 @@ static const struct index_vtab memtx_rtree_index_vtab = {
 	/* .random = */ generic_index_random,
 	/* .count = */ memtx_rtree_index_count,
 	/* .get = */ memtx_rtree_index_get,
+	/* .get_many = */ generic_index_get_many,
 	/* .replace = */ memtx_rtree_index_replace,
 	/* .create_iterator = */ memtx_rtree_index_create_iterator,
+	/* .create_iterator_with_offset = */
+		generic_index_create_iterator_with_offset,
 	/* .create_snapshot_iterator = */
 		generic_index_create_snapshot_iterator,
+	/* .create_read_view_iterator = */
+		generic_index_create_read_view_iterator,
 	/* .stat = */ generic_index_stat,
 	/* .compact = */ generic_index_compact,
 	/* .reset_stat = */ generic_index_reset_stat,
-	/* .begin_build = */ generic_index_begin_build,
+	/* .begin_build = */ memtx_rtree_index_begin_build,
 	/* .reserve = */ memtx_rtree_index_reserve,
-	/* .build_next = */ generic_index_build_next,
-	/* .end_build = */ generic_index_end_build,
+	/* .build_next = */ memtx_rtree_index_build_next,
+	/* .end_build = */ memtx_rtree_index_end_build,
 };
 
 struct index *
@@ -442,5 +516,6 @@ memtx_rtree_index_new(struct memtx_engine *memtx, struct index_def *def)
 	rtree_init(&index->tree, index->dimension, MEMTX_EXTENT_SIZE,
 		   memtx_index_extent_alloc, memtx_index_extent_free, memtx,
 		   distance_type);
+	rtree_builder_create(&index->builder);
 	return &index->base;
 }
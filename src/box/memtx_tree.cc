@@ -36,9 +36,12 @@
 #include "memory.h"
 #include "fiber.h"
 #include "key_list.h"
+#include "func.h"
 #include "tuple.h"
 #include "txn.h"
 #include "memtx_tx.h"
+#include "port.h"
+#include "bit/bit.h"
 #include <qsort_arg.h>
 #include <small/mempool.h>
 
@@ -117,6 +120,7 @@ memtx_tree_data_is_equal(const struct memtx_tree_data_common *a,
 			       (b)->part_count, (b)->hint, arg)
 #define BPS_TREE_IS_IDENTICAL(a, b) memtx_tree_data_is_equal(&a, &b)
 #define BPS_TREE_NO_DEBUG 1
+#define BPS_INNER_CARD 1
 #define bps_tree_arg_t struct key_def *
 
 #define BPS_TREE_NAMESPACE NS_NO_HINT
@@ -146,6 +150,7 @@ memtx_tree_data_is_equal(const struct memtx_tree_data_common *a,
 #undef BPS_TREE_COMPARE_KEY
 #undef BPS_TREE_IS_IDENTICAL
 #undef BPS_TREE_NO_DEBUG
+#undef BPS_INNER_CARD
 #undef bps_tree_arg_t
 
 using namespace NS_NO_HINT;
@@ -197,6 +202,8 @@ struct memtx_tree_index {
 	memtx_tree_t<USE_HINT> tree;
 	struct memtx_tree_data<USE_HINT> *build_array;
 	size_t build_array_size, build_array_alloc_size;
+	/** Set if build_array was sorted before end_build. */
+	bool build_array_is_sorted;
 	struct memtx_gc_task gc_task;
 	memtx_tree_iterator_t<USE_HINT> gc_iterator;
 };
@@ -229,6 +236,11 @@ struct tree_iterator {
 	struct iterator base;
 	memtx_tree_iterator_t<USE_HINT> tree_iterator;
 	enum iterator_type type;
+	/**
+	 * Number of tuples to skip on start, set only if MVCC is off,
+	 * see memtx_tree_index_create_iterator_with_offset().
+	 */
+	uint32_t offset;
 	struct memtx_tree_key_data<USE_HINT> key_data;
 	struct memtx_tree_data<USE_HINT> current;
 	/** Memory pool the iterator was allocated from. */
@@ -530,6 +542,40 @@ tree_iterator_set_next_method(struct tree_iterator<USE_HINT> *it)
 	}
 }
 
+/**
+ * Position the tree iterator at the tuple that follows skipping
+ * it->offset tuples from the start of the iterator range. Uses the
+ * subtree sizes of the tree, so it takes O(log n). Returns false
+ * if the range has no more than it->offset tuples.
+ */
+template <bool USE_HINT>
+static bool
+tree_iterator_seek_offset(struct tree_iterator<USE_HINT> *it,
+			  memtx_tree_t<USE_HINT> *tree)
+{
+	assert(!memtx_tx_manager_use_mvcc_engine);
+	enum iterator_type type = it->type;
+	struct memtx_tree_key_data<USE_HINT> *key = &it->key_data;
+	size_t begin = 0;
+	size_t end = memtx_tree_size(tree);
+	if (key->key != NULL) {
+		if (type != ITER_LE && type != ITER_LT)
+			begin = type == ITER_GT ?
+				memtx_tree_upper_bound_offset(tree, key, NULL) :
+				memtx_tree_lower_bound_offset(tree, key, NULL);
+		if (type != ITER_GE && type != ITER_GT && type != ITER_ALL)
+			end = type == ITER_LT ?
+			      memtx_tree_lower_bound_offset(tree, key, NULL) :
+			      memtx_tree_upper_bound_offset(tree, key, NULL);
+	}
+	if (end <= begin || end - begin <= it->offset)
+		return false;
+	size_t pos = iterator_type_is_reverse(type) ?
+		     end - 1 - it->offset : begin + it->offset;
+	it->tree_iterator = memtx_tree_iterator_at(tree, pos);
+	return true;
+}
+
 template <bool USE_HINT>
 static int
 tree_iterator_start(struct iterator *iterator, struct tuple **ret)
@@ -612,6 +658,8 @@ tree_iterator_start(struct iterator *iterator, struct tuple **ret)
 		 */
 		memtx_tree_iterator_prev(tree, &it->tree_iterator);
 	}
+	if (it->offset > 0 && !tree_iterator_seek_offset(it, tree))
+		return 0;
 
 	struct memtx_tree_data<USE_HINT> *res =
 		memtx_tree_iterator_get_elem(tree, &it->tree_iterator);
@@ -792,7 +840,43 @@ memtx_tree_index_count(struct index *base, enum iterator_type type,
 {
 	if (type == ITER_ALL)
 		return memtx_tree_index_size<USE_HINT>(base); /* optimization */
-	return generic_index_count(base, type, key, part_count);
+	/*
+	 * With MVCC some of the tuples in the tree may be invisible
+	 * to the transaction, so they have to be counted one by one.
+	 */
+	if (memtx_tx_manager_use_mvcc_engine || type > ITER_GT)
+		return generic_index_count(base, type, key, part_count);
+	struct memtx_tree_index<USE_HINT> *index =
+		(struct memtx_tree_index<USE_HINT> *)base;
+	memtx_tree_t<USE_HINT> *tree = &index->tree;
+	size_t size = memtx_tree_size(tree);
+	if (part_count == 0)
+		return size;
+	struct key_def *cmp_def = memtx_tree_cmp_def(tree);
+	struct memtx_tree_key_data<USE_HINT> key_data;
+	key_data.key = key;
+	key_data.part_count = part_count;
+	if (USE_HINT)
+		key_data.set_hint(key_hint(key, part_count, cmp_def));
+	switch (type) {
+	case ITER_EQ:
+	case ITER_REQ:
+		return memtx_tree_upper_bound_offset(tree, &key_data, NULL) -
+		       memtx_tree_lower_bound_offset(tree, &key_data, NULL);
+	case ITER_GE:
+		return size - memtx_tree_lower_bound_offset(tree, &key_data,
+							    NULL);
+	case ITER_GT:
+		return size - memtx_tree_upper_bound_offset(tree, &key_data,
+							    NULL);
+	case ITER_LE:
+		return memtx_tree_upper_bound_offset(tree, &key_data, NULL);
+	case ITER_LT:
+		return memtx_tree_lower_bound_offset(tree, &key_data, NULL);
+	default:
+		unreachable();
+	}
+	return 0;
 }
 
 template <bool USE_HINT>
@@ -828,6 +912,74 @@ memtx_tree_index_get(struct index *base, const char *key,
 	return 0;
 }
 
+template <bool USE_HINT>
+static int
+memtx_tree_index_get_many(struct index *base, const char **keys,
+			  uint32_t count, struct port *result)
+{
+	assert(base->def->opts.is_unique);
+	struct memtx_tree_index<USE_HINT> *index =
+		(struct memtx_tree_index<USE_HINT> *)base;
+	struct key_def *cmp_def = memtx_tree_cmp_def(&index->tree);
+	uint32_t part_count = base->def->key_def->part_count;
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	size_t size;
+	struct memtx_tree_key_data<USE_HINT> *key_data =
+		region_alloc_array(region, typeof(key_data[0]), count, &size);
+	if (key_data == NULL) {
+		diag_set(OutOfMemory, size, "region_alloc_array", "key_data");
+		return -1;
+	}
+	struct memtx_tree_key_data<USE_HINT> **key_ptrs =
+		region_alloc_array(region, typeof(key_ptrs[0]), count, &size);
+	if (key_ptrs == NULL) {
+		region_truncate(region, region_svp);
+		diag_set(OutOfMemory, size, "region_alloc_array", "key_ptrs");
+		return -1;
+	}
+	struct memtx_tree_data<USE_HINT> **res =
+		region_alloc_array(region, typeof(res[0]), count, &size);
+	if (res == NULL) {
+		region_truncate(region, region_svp);
+		diag_set(OutOfMemory, size, "region_alloc_array", "res");
+		return -1;
+	}
+	for (uint32_t i = 0; i < count; i++) {
+		key_data[i].key = keys[i];
+		key_data[i].part_count = part_count;
+		if (USE_HINT)
+			key_data[i].set_hint(key_hint(keys[i], part_count,
+						      cmp_def));
+		key_ptrs[i] = &key_data[i];
+	}
+	memtx_tree_find_batch(&index->tree, key_ptrs, count, res);
+
+	struct txn *txn = in_txn();
+	struct space *space = space_by_id(base->def->space_id);
+	bool is_rw = txn != NULL;
+	bool is_multikey = base->def->key_def->is_multikey;
+	int rc = 0;
+	for (uint32_t i = 0; i < count; i++) {
+		if (res[i] == NULL) {
+			if (part_count == cmp_def->part_count)
+				memtx_tx_track_point(txn, space, base, keys[i]);
+			continue;
+		}
+		uint32_t mk_index = is_multikey ? (uint32_t)res[i]->hint : 0;
+		struct tuple *tuple = memtx_tx_tuple_clarify(txn, space,
+							     res[i]->tuple,
+							     base, mk_index,
+							     is_rw);
+		if (tuple != NULL && port_c_add_tuple(result, tuple) != 0) {
+			rc = -1;
+			break;
+		}
+	}
+	region_truncate(region, region_svp);
+	return rc;
+}
+
 template <bool USE_HINT>
 static int
 memtx_tree_index_replace(struct index *base, struct tuple *old_tuple,
@@ -1033,6 +1185,12 @@ memtx_tree_index_replace_multikey_rollback(struct memtx_tree_index<true> *index,
  * set of the old and the new tuple, we don't using key parts alone
  * to compare - we also look at b+* tree value that has the tuple
  * pointer, and delete old tuple entries only.
+ *
+ * A duplicate found on insertion carries the multikey position of
+ * the old tuple entry it has overwritten, so we mark these positions
+ * and don't look them up again on deletion. Updating a tuple with
+ * many keys usually preserves most of them, and this halves the
+ * number of tree lookups.
  */
 static int
 memtx_tree_index_replace_multikey(struct index *base, struct tuple *old_tuple,
@@ -1046,6 +1204,14 @@ memtx_tree_index_replace_multikey(struct index *base, struct tuple *old_tuple,
 	*successor = NULL;
 
 	struct key_def *cmp_def = memtx_tree_cmp_def(&index->tree);
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	/*
+	 * Bitmap of the old tuple entries overwritten by the new tuple.
+	 * It's only an optimization, so if it can't be allocated, all
+	 * the old tuple entries are looked up on deletion.
+	 */
+	uint8_t *is_overwritten = NULL;
 	*result = NULL;
 	if (new_tuple != NULL) {
 		int multikey_idx = 0, err = 0;
@@ -1065,10 +1231,24 @@ memtx_tree_index_replace_multikey(struct index *base, struct tuple *old_tuple,
 			    !is_multikey_conflict) {
 				assert(*result == NULL ||
 				       *result == replaced_data.tuple);
+				if (*result == NULL) {
+					uint32_t count = tuple_multikey_count(
+						replaced_data.tuple, cmp_def);
+					size_t size = DIV_ROUND_UP(count,
+								   CHAR_BIT);
+					is_overwritten = (uint8_t *)
+						region_alloc(region, size);
+					if (is_overwritten != NULL)
+						memset(is_overwritten, 0, size);
+				}
 				*result = replaced_data.tuple;
+				if (is_overwritten != NULL)
+					bit_set(is_overwritten,
+						replaced_data.hint);
 			}
 		}
 		if (err != 0) {
+			region_truncate(region, region_svp);
 			memtx_tree_index_replace_multikey_rollback(index,
 					new_tuple, *result, multikey_idx);
 			return -1;
@@ -1084,10 +1264,14 @@ memtx_tree_index_replace_multikey(struct index *base, struct tuple *old_tuple,
 		uint32_t multikey_count =
 			tuple_multikey_count(old_tuple, cmp_def);
 		for (int i = 0; (uint32_t) i < multikey_count; i++) {
+			if (is_overwritten != NULL &&
+			    bit_test(is_overwritten, i))
+				continue;
 			data.hint = i;
 			memtx_tree_delete_value(&index->tree, data, NULL);
 		}
 	}
+	region_truncate(region, region_svp);
 	return 0;
 }
 
@@ -1260,6 +1444,19 @@ memtx_tree_func_index_replace(struct index *base, struct tuple *old_tuple,
 			tuple_chunk_delete(undo->key.tuple,
 					   (const char *)undo->key.hint);
 		}
+		/*
+		 * A non-multikey function returns one key per tuple,
+		 * and if the new tuple has replaced an entry of the
+		 * old one, it was the only one. That's the case of
+		 * any update that doesn't change the key, so don't
+		 * call the function once again to find out that
+		 * there's nothing to delete.
+		 */
+		struct func *func = index_def->key_def->func_index_func;
+		if (*result != NULL && !func->def->opts.is_multikey) {
+			rc = 0;
+			goto end;
+		}
 	}
 	if (old_tuple != NULL) {
 		if (key_list_iterator_create(&it, old_tuple, index_def, false,
@@ -1334,9 +1531,35 @@ memtx_tree_index_create_iterator(struct index *base, enum iterator_type type,
 		it->key_data.set_hint(key_hint(key, part_count, cmp_def));
 	invalidate_tree_iterator(&it->tree_iterator);
 	it->current.tuple = NULL;
+	it->offset = 0;
 	return (struct iterator *)it;
 }
 
+template <bool USE_HINT>
+static struct iterator *
+memtx_tree_index_create_iterator_with_offset(struct index *base,
+					     enum iterator_type type,
+					     const char *key,
+					     uint32_t part_count,
+					     uint32_t *offset)
+{
+	struct iterator *iterator =
+		memtx_tree_index_create_iterator<USE_HINT>(base, type, key,
+							   part_count);
+	/*
+	 * With MVCC the positions in the tree don't match the
+	 * positions of visible tuples, so the caller has to skip
+	 * the tuples one by one.
+	 */
+	if (iterator == NULL || memtx_tx_manager_use_mvcc_engine)
+		return iterator;
+	struct tree_iterator<USE_HINT> *it =
+		get_tree_iterator<USE_HINT>(iterator);
+	it->offset = *offset;
+	*offset = 0;
+	return iterator;
+}
+
 template <bool USE_HINT>
 static void
 memtx_tree_index_begin_build(struct index *base)
@@ -1512,14 +1735,24 @@ memtx_tree_index_build_array_deduplicate(struct memtx_tree_index<USE_HINT> *inde
 
 template <bool USE_HINT>
 static void
-memtx_tree_index_end_build(struct index *base)
+memtx_tree_index_sort_build_array_tpl(struct memtx_tree_index<USE_HINT> *index)
 {
-	struct memtx_tree_index<USE_HINT> *index =
-		(struct memtx_tree_index<USE_HINT> *)base;
 	struct key_def *cmp_def = memtx_tree_cmp_def(&index->tree);
 	qsort_arg(index->build_array, index->build_array_size,
 		  sizeof(index->build_array[0]),
 		  memtx_tree_qcompare<USE_HINT>, cmp_def);
+	index->build_array_is_sorted = true;
+}
+
+template <bool USE_HINT>
+static void
+memtx_tree_index_end_build(struct index *base)
+{
+	struct memtx_tree_index<USE_HINT> *index =
+		(struct memtx_tree_index<USE_HINT> *)base;
+	struct key_def *cmp_def = memtx_tree_cmp_def(&index->tree);
+	if (!index->build_array_is_sorted)
+		memtx_tree_index_sort_build_array_tpl<USE_HINT>(index);
 	if (cmp_def->is_multikey) {
 		/*
 		 * Multikey index may have equal(in terms of
@@ -1540,6 +1773,7 @@ memtx_tree_index_end_build(struct index *base)
 	index->build_array = NULL;
 	index->build_array_size = 0;
 	index->build_array_alloc_size = 0;
+	index->build_array_is_sorted = false;
 }
 
 template <bool USE_HINT>
@@ -1632,6 +1866,163 @@ memtx_tree_index_create_snapshot_iterator(struct index *base)
 	return (struct snapshot_iterator *) it;
 }
 
+template <bool USE_HINT>
+struct tree_read_view_iterator {
+	struct snapshot_iterator base;
+	struct memtx_tree_index<USE_HINT> *index;
+	/** Frozen tree iterator positioned at the next tuple. */
+	memtx_tree_iterator_t<USE_HINT> tree_iterator;
+	/**
+	 * Tuple next to the last one matching the key (EQ and REQ)
+	 * or NULL if the iteration ends at the end of the tree. We
+	 * can compare tuple pointers, because a tuple is stored in
+	 * a tree index only once, unless the index is multikey.
+	 */
+	struct tuple *end;
+	/** Set if the tree is iterated backwards. */
+	bool is_reverse;
+	/** Set if there's no more tuples to return. */
+	bool is_done;
+	struct memtx_tx_snapshot_cleaner cleaner;
+};
+
+template <bool USE_HINT>
+static void
+tree_read_view_iterator_free(struct snapshot_iterator *iterator)
+{
+	assert(iterator->free == &tree_read_view_iterator_free<USE_HINT>);
+	struct tree_read_view_iterator<USE_HINT> *it =
+		(struct tree_read_view_iterator<USE_HINT> *)iterator;
+	memtx_leave_delayed_free_mode((struct memtx_engine *)
+				      it->index->base.engine);
+	memtx_tree_iterator_destroy(&it->index->tree, &it->tree_iterator);
+	index_unref(&it->index->base);
+	memtx_tx_snapshot_cleaner_destroy(&it->cleaner);
+	free(iterator);
+}
+
+template <bool USE_HINT>
+static int
+tree_read_view_iterator_next(struct snapshot_iterator *iterator,
+			     const char **data, uint32_t *size)
+{
+	assert(iterator->free == &tree_read_view_iterator_free<USE_HINT>);
+	struct tree_read_view_iterator<USE_HINT> *it =
+		(struct tree_read_view_iterator<USE_HINT> *)iterator;
+	memtx_tree_t<USE_HINT> *tree = &it->index->tree;
+
+	*data = NULL;
+	while (!it->is_done) {
+		struct memtx_tree_data<USE_HINT> *res =
+			memtx_tree_iterator_get_elem(tree, &it->tree_iterator);
+		if (res == NULL || res->tuple == it->end) {
+			it->is_done = true;
+			break;
+		}
+		if (it->is_reverse)
+			memtx_tree_iterator_prev(tree, &it->tree_iterator);
+		else
+			memtx_tree_iterator_next(tree, &it->tree_iterator);
+
+		struct tuple *tuple = res->tuple;
+		tuple = memtx_tx_snapshot_clarify(&it->cleaner, tuple);
+		if (tuple != NULL) {
+			*data = tuple_data_range(tuple, size);
+			break;
+		}
+	}
+	return 0;
+}
+
+/**
+ * Create an iterator with personal read view positioned in the
+ * same way as tree_iterator_start() does. All key comparisons are
+ * done here, so advancing the iterator doesn't need to look up
+ * tuple formats and thus can be done from another thread.
+ */
+template <bool USE_HINT>
+static struct snapshot_iterator *
+memtx_tree_index_create_read_view_iterator(struct index *base,
+					   enum iterator_type type,
+					   const char *key, uint32_t part_count)
+{
+	struct memtx_tree_index<USE_HINT> *index =
+		(struct memtx_tree_index<USE_HINT> *)base;
+	struct key_def *cmp_def = memtx_tree_cmp_def(&index->tree);
+	memtx_tree_t<USE_HINT> *tree = &index->tree;
+
+	assert(part_count == 0 || key != NULL);
+	if (type > ITER_GT) {
+		diag_set(UnsupportedIndexFeature, base->def,
+			 "requested iterator type");
+		return NULL;
+	}
+	if (part_count == 0) {
+		type = iterator_type_is_reverse(type) ? ITER_LE : ITER_GE;
+		key = NULL;
+	}
+
+	struct tree_read_view_iterator<USE_HINT> *it =
+		(struct tree_read_view_iterator<USE_HINT> *)
+		calloc(1, sizeof(*it));
+	if (it == NULL) {
+		diag_set(OutOfMemory,
+			 sizeof(struct tree_read_view_iterator<USE_HINT>),
+			 "memtx_tree_index", "create_read_view_iterator");
+		return NULL;
+	}
+
+	struct space *space = space_cache_find(base->def->space_id);
+	memtx_tx_snapshot_cleaner_create(&it->cleaner, space);
+
+	it->base.free = tree_read_view_iterator_free<USE_HINT>;
+	it->base.next = tree_read_view_iterator_next<USE_HINT>;
+	it->index = index;
+	it->is_reverse = iterator_type_is_reverse(type);
+	index_ref(base);
+
+	struct memtx_tree_key_data<USE_HINT> key_data;
+	key_data.key = key;
+	key_data.part_count = part_count;
+	if (USE_HINT)
+		key_data.set_hint(key_hint(key, part_count, cmp_def));
+	bool equals = false;
+	if (key == NULL) {
+		if (it->is_reverse)
+			invalidate_tree_iterator(&it->tree_iterator);
+		else
+			it->tree_iterator = memtx_tree_iterator_first(tree);
+	} else if (type == ITER_ALL || type == ITER_EQ ||
+		   type == ITER_GE || type == ITER_LT) {
+		it->tree_iterator = memtx_tree_lower_bound(tree, &key_data,
+							   &equals);
+	} else { // ITER_GT, ITER_REQ, ITER_LE
+		it->tree_iterator = memtx_tree_upper_bound(tree, &key_data,
+							   &equals);
+	}
+	if (type == ITER_EQ || type == ITER_REQ) {
+		if (!equals)
+			it->is_done = true;
+		/* Find the first tuple following the equal ones. */
+		memtx_tree_iterator_t<USE_HINT> end;
+		if (type == ITER_EQ) {
+			end = memtx_tree_upper_bound(tree, &key_data, NULL);
+		} else {
+			end = memtx_tree_lower_bound(tree, &key_data, NULL);
+			memtx_tree_iterator_prev(tree, &end);
+		}
+		struct memtx_tree_data<USE_HINT> *res =
+			memtx_tree_iterator_get_elem(tree, &end);
+		it->end = res != NULL ? res->tuple : NULL;
+	}
+	/* See the comment in tree_iterator_start(). */
+	if (it->is_reverse)
+		memtx_tree_iterator_prev(tree, &it->tree_iterator);
+	memtx_tree_iterator_freeze(tree, &it->tree_iterator);
+	memtx_enter_delayed_free_mode((struct memtx_engine *)base->engine);
+	return (struct snapshot_iterator *)it;
+}
+
 static const struct index_vtab memtx_tree_no_hint_index_vtab = {
 	/* .destroy = */ memtx_tree_index_destroy<false>,
 	/* .commit_create = */ generic_index_commit_create,
@@ -1649,10 +2040,15 @@ static const struct index_vtab memtx_tree_no_hint_index_vtab = {
 	/* .random = */ memtx_tree_index_random<false>,
 	/* .count = */ memtx_tree_index_count<false>,
 	/* .get = */ memtx_tree_index_get<false>,
+	/* .get_many = */ memtx_tree_index_get_many<false>,
 	/* .replace = */ memtx_tree_index_replace<false>,
 	/* .create_iterator = */ memtx_tree_index_create_iterator<false>,
+	/* .create_iterator_with_offset = */
+		memtx_tree_index_create_iterator_with_offset<false>,
 	/* .create_snapshot_iterator = */
 		memtx_tree_index_create_snapshot_iterator<false>,
+	/* .create_read_view_iterator = */
+		memtx_tree_index_create_read_view_iterator<false>,
 	/* .stat = */ generic_index_stat,
 	/* .compact = */ generic_index_compact,
 	/* .reset_stat = */ generic_index_reset_stat,
@@ -1679,10 +2075,15 @@ static const struct index_vtab memtx_tree_use_hint_index_vtab = {
 	/* .random = */ memtx_tree_index_random<true>,
 	/* .count = */ memtx_tree_index_count<true>,
 	/* .get = */ memtx_tree_index_get<true>,
+	/* .get_many = */ memtx_tree_index_get_many<true>,
 	/* .replace = */ memtx_tree_index_replace<true>,
 	/* .create_iterator = */ memtx_tree_index_create_iterator<true>,
+	/* .create_iterator_with_offset = */
+		memtx_tree_index_create_iterator_with_offset<true>,
 	/* .create_snapshot_iterator = */
 		memtx_tree_index_create_snapshot_iterator<true>,
+	/* .create_read_view_iterator = */
+		memtx_tree_index_create_read_view_iterator<true>,
 	/* .stat = */ generic_index_stat,
 	/* .compact = */ generic_index_compact,
 	/* .reset_stat = */ generic_index_reset_stat,
@@ -1709,10 +2110,15 @@ static const struct index_vtab memtx_tree_index_multikey_vtab = {
 	/* .random = */ memtx_tree_index_random<true>,
 	/* .count = */ memtx_tree_index_count<true>,
 	/* .get = */ memtx_tree_index_get<true>,
+	/* .get_many = */ memtx_tree_index_get_many<true>,
 	/* .replace = */ memtx_tree_index_replace_multikey,
 	/* .create_iterator = */ memtx_tree_index_create_iterator<true>,
+	/* .create_iterator_with_offset = */
+		memtx_tree_index_create_iterator_with_offset<true>,
 	/* .create_snapshot_iterator = */
 		memtx_tree_index_create_snapshot_iterator<true>,
+	/* .create_read_view_iterator = */
+		generic_index_create_read_view_iterator,
 	/* .stat = */ generic_index_stat,
 	/* .compact = */ generic_index_compact,
 	/* .reset_stat = */ generic_index_reset_stat,
@@ -1739,10 +2145,15 @@ static const struct index_vtab memtx_tree_func_index_vtab = {
 	/* .random = */ memtx_tree_index_random<true>,
 	/* .count = */ memtx_tree_index_count<true>,
 	/* .get = */ memtx_tree_index_get<true>,
+	/* .get_many = */ memtx_tree_index_get_many<true>,
 	/* .replace = */ memtx_tree_func_index_replace,
 	/* .create_iterator = */ memtx_tree_index_create_iterator<true>,
+	/* .create_iterator_with_offset = */
+		memtx_tree_index_create_iterator_with_offset<true>,
 	/* .create_snapshot_iterator = */
 		memtx_tree_index_create_snapshot_iterator<true>,
+	/* .create_read_view_iterator = */
+		generic_index_create_read_view_iterator,
 	/* .stat = */ generic_index_stat,
 	/* .compact = */ generic_index_compact,
 	/* .reset_stat = */ generic_index_reset_stat,
@@ -1775,10 +2186,15 @@ static const struct index_vtab memtx_tree_disabled_index_vtab = {
 	/* .random = */ generic_index_random,
 	/* .count = */ generic_index_count,
 	/* .get = */ generic_index_get,
+	/* .get_many = */ generic_index_get_many,
 	/* .replace = */ disabled_index_replace,
 	/* .create_iterator = */ generic_index_create_iterator,
+	/* .create_iterator_with_offset = */
+		generic_index_create_iterator_with_offset,
 	/* .create_snapshot_iterator = */
 		generic_index_create_snapshot_iterator,
+	/* .create_read_view_iterator = */
+		generic_index_create_read_view_iterator,
 	/* .stat = */ generic_index_stat,
 	/* .compact = */ generic_index_compact,
 	/* .reset_stat = */ generic_index_reset_stat,
@@ -1817,6 +2233,18 @@ memtx_tree_index_new_tpl(struct memtx_engine *memtx, struct index_def *def,
 	return &index->base;
 }
 
+void
+memtx_tree_index_sort_build_array(struct index *index)
+{
+	if (index->vtab == &memtx_tree_no_hint_index_vtab) {
+		memtx_tree_index_sort_build_array_tpl<false>(
+			(struct memtx_tree_index<false> *)index);
+	} else {
+		memtx_tree_index_sort_build_array_tpl<true>(
+			(struct memtx_tree_index<true> *)index);
+	}
+}
+
 struct index *
 memtx_tree_index_new(struct memtx_engine *memtx, struct index_def *def)
 {
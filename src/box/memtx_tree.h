@@ -42,6 +42,15 @@ struct memtx_engine;
 struct index *
 memtx_tree_index_new(struct memtx_engine *memtx, struct index_def *def);
 
+/**
+ * Sort tuples collected by build_next() of a TREE index so that
+ * index_end_build() doesn't have to do it. The function touches
+ * only the index build array, so it may be called from a worker
+ * thread, for different indexes concurrently.
+ */
+void
+memtx_tree_index_sort_build_array(struct index *index);
+
 #if defined(__cplusplus)
 } /* extern "C" */
 #endif /* defined(__cplusplus) */
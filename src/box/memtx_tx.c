@@ -207,6 +207,8 @@ struct tx_manager
 	struct mempool full_scan_item_mempool;
 	/** List of all memtx_story objects. */
 	struct rlist all_stories;
+	/** Number of memtx_story objects in all_stories. */
+	size_t story_count;
 	/** Iterator that sequentially traverses all memtx_story objects. */
 	struct rlist *traverse_all_stories;
 	/** The list containing all transactions. */
@@ -252,6 +254,7 @@ memtx_tx_manager_init()
 	rlist_create(&txm.all_stories);
 	rlist_create(&txm.all_txs);
 	txm.traverse_all_stories = &txm.all_stories;
+	txm.story_count = 0;
 	txm.must_do_gc_steps = 0;
 }
 
@@ -402,6 +405,7 @@ memtx_tx_story_new(struct space *space, struct tuple *tuple)
 	story->del_psn = 0;
 	rlist_create(&story->reader_list);
 	rlist_add_tail(&txm.all_stories, &story->in_all_stories);
+	txm.story_count++;
 	rlist_add(&space->memtx_stories, &story->in_space_stories);
 	for (uint32_t i = 0; i < index_count; i++) {
 		story->link[i].newer_story = story->link[i].older_story = NULL;
@@ -430,6 +434,8 @@ memtx_tx_story_delete(struct memtx_story *story)
 	if (txm.traverse_all_stories == &story->in_all_stories)
 		txm.traverse_all_stories = rlist_next(txm.traverse_all_stories);
 	rlist_del(&story->in_all_stories);
+	assert(txm.story_count > 0);
+	txm.story_count--;
 	rlist_del(&story->in_space_stories);
 
 	mh_int_t pos = mh_history_find(txm.history, story->tuple, 0);
@@ -860,12 +866,27 @@ memtx_tx_story_full_unlink(struct memtx_story *story)
 	}
 }
 
+/**
+ * Return the low-water mark of read views: stories that were added and
+ * deleted before it can't be seen by any transaction.
+ */
+static int64_t
+memtx_tx_lowest_rv_psn(void)
+{
+	if (rlist_empty(&txm.read_view_txs))
+		return txn_last_psn;
+	struct txn *txn = rlist_first_entry(&txm.read_view_txs, struct txn,
+					    in_read_view_txs);
+	assert(txn->rv_psn != 0);
+	return txn->rv_psn;
+}
+
 /**
  * Run one step of a crawler that traverses all stories and removes no more
- * used stories.
+ * used stories. @a lowest_rv_psm is memtx_tx_lowest_rv_psn().
  */
 static void
-memtx_tx_story_gc_step()
+memtx_tx_story_gc_step(int64_t lowest_rv_psm)
 {
 	if (txm.traverse_all_stories == &txm.all_stories) {
 		/* We came to the head of the list. */
@@ -873,16 +894,6 @@ memtx_tx_story_gc_step()
 		return;
 	}
 
-	/* Lowest read view PSN */
-	int64_t lowest_rv_psm = txn_last_psn;
-	if (!rlist_empty(&txm.read_view_txs)) {
-		struct txn *txn =
-			rlist_first_entry(&txm.read_view_txs, struct txn,
-					  in_read_view_txs);
-		assert(txn->rv_psn != 0);
-		lowest_rv_psm = txn->rv_psn;
-	}
-
 	struct memtx_story *story =
 		rlist_entry(txm.traverse_all_stories, struct memtx_story,
 			    in_all_stories);
@@ -911,14 +922,20 @@ memtx_tx_story_gc_step()
 }
 
 /**
- * Run several rounds of memtx_tx_story_gc_step()
+ * Run several rounds of memtx_tx_story_gc_step(). The number of rounds
+ * never exceeds one full pass over the story list (plus its head): after
+ * that the crawler would only revisit stories it has just found in use.
  */
 static void
 memtx_tx_story_gc()
 {
-	for (size_t i = 0; i < txm.must_do_gc_steps; i++)
-		memtx_tx_story_gc_step();
+	if (txm.must_do_gc_steps == 0)
+		return;
+	size_t steps = MIN(txm.must_do_gc_steps, txm.story_count + 1);
 	txm.must_do_gc_steps = 0;
+	int64_t lowest_rv_psn = memtx_tx_lowest_rv_psn();
+	for (size_t i = 0; i < steps; i++)
+		memtx_tx_story_gc_step(lowest_rv_psn);
 }
 
 /**
@@ -1081,6 +1098,12 @@ memtx_tx_check_dup(struct tuple *new_tuple, struct tuple *old_tuple,
 static struct point_hole_item *
 point_hole_storage_find(struct index *index, struct tuple *tuple)
 {
+	/*
+	 * Every insertion into a unique index looks for point holes, and
+	 * there are usually none. Don't hash the tuple for nothing.
+	 */
+	if (txm.point_holes_size == 0)
+		return NULL;
 	struct point_hole_key key;
 	key.index = index;
 	key.tuple = tuple;
@@ -1350,6 +1373,9 @@ memtx_tx_handle_gap_write(struct txn *txn, struct space *space,
 			is_split = true;
 		} else {
 			struct key_def *def = index->def->key_def;
+			/* Select positions have all cmp_def parts. */
+			if (item->part_count > def->part_count)
+				def = index->def->cmp_def;
 			hint_t oh = def->key_hint(item->key, item->part_count, def);
 			hint_t kh = def->tuple_hint(tuple, def);
 			int cmp = def->tuple_compare_with_key(tuple, kh,
@@ -36,9 +36,6 @@
 #include <stdint.h>
 #include <stdlib.h>
 
-#define HEAP_FORWARD_DECLARATION
-#include "salad/heap.h"
-
 #include "diag.h"             /* diag_set() */
 #include "box/tuple.h"        /* tuple_ref(), tuple_unref(),
 				 tuple_validate() */
@@ -54,40 +51,34 @@
  * compare the node against other nodes.
  *
  * The main reason why this structure is separated from a merge
- * source is that a heap node can not be a member of several
- * heaps.
+ * source is that a source can be used by several mergers.
  *
- * The second reason is that it allows to encapsulate all heap
+ * The second reason is that it allows to encapsulate all tree
  * related logic inside this compilation unit, without any traces
  * in externally visible structures.
  */
-struct merger_heap_node {
+struct merger_node {
 	/* A source of tuples. */
 	struct merge_source *source;
 	/*
 	 * A last fetched (refcounted) tuple to compare against
-	 * other nodes.
+	 * other nodes. NULL if the source is exhausted.
 	 */
 	struct tuple *tuple;
-	/* An anchor to make the structure a merger heap node. */
-	struct heap_node in_merger;
 };
 
-static bool
-merge_source_less(const heap_t *heap, const struct merger_heap_node *left,
-		  const struct merger_heap_node *right);
-#define HEAP_NAME merger_heap
-#define HEAP_LESS merge_source_less
-#define heap_value_t struct merger_heap_node
-#define heap_value_attr in_merger
-#include "salad/heap.h"
-#undef HEAP_NAME
-#undef HEAP_LESS
-#undef heap_value_t
-#undef heap_value_attr
-
 /**
- * Holds a heap, parameters of a merge process and utility fields.
+ * Holds a tree of sources, parameters of a merge process and
+ * utility fields.
+ *
+ * Sources are merged with a tree of losers (a tournament tree).
+ * Node i is leaf node_count + i of a complete binary tree, whose
+ * internal vertices 1 .. node_count - 1 store the source that
+ * lost the match at this vertex, and losers[0] stores the overall
+ * winner. When the winner fetches a next tuple, it replays the
+ * matches on the path from its leaf to the root only, which takes
+ * log2(node_count) comparisons, while sifting down a binary heap
+ * takes up to two comparisons per level.
  */
 struct merger {
 	/* A merger is a source. */
@@ -95,22 +86,19 @@ struct merger {
 	/*
 	 * Whether a merge process started.
 	 *
-	 * The merger postpones charging of heap nodes until a
-	 * first output tuple is acquired.
+	 * The merger postpones charging of nodes until a first
+	 * output tuple is acquired.
 	 */
 	bool started;
 	/* A key_def to compare tuples. */
 	struct key_def *key_def;
 	/* A format to acquire compatible tuples from sources. */
 	struct tuple_format *format;
-	/*
-	 * A heap of sources (of nodes that contains a source to
-	 * be exact).
-	 */
-	heap_t heap;
-	/* An array of heap nodes. */
+	/* An array of nodes. */
 	uint32_t node_count;
-	struct merger_heap_node *nodes;
+	struct merger_node *nodes;
+	/* Tree of losers, node_count entries, see above. */
+	uint32_t *losers;
 	/* Ascending (false) / descending (true) order. */
 	bool reverse;
 };
@@ -118,77 +106,83 @@ struct merger {
 /* Helpers */
 
 /**
- * Data comparing function to construct a heap of sources.
+ * Return true if the tuple of node @a left should be output
+ * before the tuple of node @a right. An exhausted node loses to
+ * any other one.
  */
-static bool
-merge_source_less(const heap_t *heap, const struct merger_heap_node *left,
-		  const struct merger_heap_node *right)
+static inline bool
+merger_node_less(struct merger *merger, uint32_t left, uint32_t right)
 {
-	assert(left->tuple != NULL);
-	assert(right->tuple != NULL);
-	struct merger *merger = container_of(heap, struct merger, heap);
-	int cmp = tuple_compare(left->tuple, HINT_NONE, right->tuple, HINT_NONE,
+	struct tuple *left_tuple = merger->nodes[left].tuple;
+	struct tuple *right_tuple = merger->nodes[right].tuple;
+	if (left_tuple == NULL)
+		return false;
+	if (right_tuple == NULL)
+		return true;
+	int cmp = tuple_compare(left_tuple, HINT_NONE, right_tuple, HINT_NONE,
 				merger->key_def);
-	return merger->reverse ? cmp >= 0 : cmp < 0;
+	return merger->reverse ? cmp > 0 : cmp < 0;
+}
+
+/**
+ * Play the matches of the subtree rooted at the given vertex,
+ * store the losers and return the winner.
+ */
+static uint32_t
+merger_tree_build(struct merger *merger, uint32_t vertex)
+{
+	if (vertex >= merger->node_count)
+		return vertex - merger->node_count;
+	uint32_t left = merger_tree_build(merger, 2 * vertex);
+	uint32_t right = merger_tree_build(merger, 2 * vertex + 1);
+	if (merger_node_less(merger, right, left)) {
+		merger->losers[vertex] = left;
+		return right;
+	}
+	merger->losers[vertex] = right;
+	return left;
 }
 
 /**
- * Initialize a new merger heap node.
+ * Replay the matches of the winner after its tuple was changed.
  */
 static void
-merger_heap_node_create(struct merger_heap_node *node,
-			struct merge_source *source)
+merger_tree_update(struct merger *merger)
+{
+	uint32_t winner = merger->losers[0];
+	for (uint32_t vertex = (merger->node_count + winner) / 2; vertex > 0;
+	     vertex /= 2) {
+		uint32_t loser = merger->losers[vertex];
+		if (merger_node_less(merger, loser, winner)) {
+			merger->losers[vertex] = winner;
+			winner = loser;
+		}
+	}
+	merger->losers[0] = winner;
+}
+
+/**
+ * Initialize a new merger node.
+ */
+static void
+merger_node_create(struct merger_node *node, struct merge_source *source)
 {
 	node->source = source;
 	merge_source_ref(node->source);
 	node->tuple = NULL;
-	heap_node_create(&node->in_merger);
 }
 
 /**
- * Free a merger heap node.
+ * Free a merger node.
  */
 static void
-merger_heap_node_delete(struct merger_heap_node *node)
+merger_node_delete(struct merger_node *node)
 {
 	merge_source_unref(node->source);
 	if (node->tuple != NULL)
 		tuple_unref(node->tuple);
 }
 
-/**
- * The helper to add a new heap node to a merger heap.
- *
- * Return -1 at an error and set a diag.
- *
- * Otherwise store a next tuple in node->tuple, add the node to
- * merger->heap and return 0.
- */
-static int
-merger_add_heap_node(struct merger *merger, struct merger_heap_node *node)
-{
-	struct tuple *tuple = NULL;
-
-	/* Acquire a next tuple. */
-	struct merge_source *source = node->source;
-	if (merge_source_next(source, merger->format, &tuple) != 0)
-		return -1;
-
-	/* Don't add an empty source to a heap. */
-	if (tuple == NULL)
-		return 0;
-
-	node->tuple = tuple;
-
-	/* Add a node to a heap. */
-	if (merger_heap_insert(&merger->heap, node) != 0) {
-		diag_set(OutOfMemory, 0, "malloc", "merger->heap");
-		return -1;
-	}
-
-	return 0;
-}
-
 /* Virtual methods declarations */
 
 static void
@@ -210,20 +204,24 @@ static int
 merger_set_sources(struct merger *merger, struct merge_source **sources,
 		   uint32_t source_count)
 {
-	const size_t nodes_size = sizeof(struct merger_heap_node) *
-		source_count;
-	struct merger_heap_node *nodes = malloc(nodes_size);
+	if (source_count == 0)
+		return 0;
+
+	const size_t nodes_size = sizeof(struct merger_node) * source_count;
+	const size_t losers_size = sizeof(uint32_t) * source_count;
+	struct merger_node *nodes = malloc(nodes_size + losers_size);
 	if (nodes == NULL) {
-		diag_set(OutOfMemory, nodes_size, "malloc",
-			 "merger heap nodes");
+		diag_set(OutOfMemory, nodes_size + losers_size, "malloc",
+			 "merger nodes");
 		return -1;
 	}
 
 	for (uint32_t i = 0; i < source_count; ++i)
-		merger_heap_node_create(&nodes[i], sources[i]);
+		merger_node_create(&nodes[i], sources[i]);
 
 	merger->node_count = source_count;
 	merger->nodes = nodes;
+	merger->losers = (uint32_t *)(nodes + source_count);
 	return 0;
 }
 
@@ -266,15 +264,14 @@ merger_new(struct key_def *key_def, struct merge_source **sources,
 	merger->started = false;
 	merger->key_def = key_def;
 	merger->format = format;
-	merger_heap_create(&merger->heap);
 	merger->node_count = 0;
 	merger->nodes = NULL;
+	merger->losers = NULL;
 	merger->reverse = reverse;
 
 	if (merger_set_sources(merger, sources, source_count) != 0) {
 		key_def_delete(merger->key_def);
 		tuple_format_unref(merger->format);
-		merger_heap_destroy(&merger->heap);
 		free(merger);
 		return NULL;
 	}
@@ -291,10 +288,9 @@ merger_delete(struct merge_source *base)
 
 	key_def_delete(merger->key_def);
 	tuple_format_unref(merger->format);
-	merger_heap_destroy(&merger->heap);
 
 	for (uint32_t i = 0; i < merger->node_count; ++i)
-		merger_heap_node_delete(&merger->nodes[i]);
+		merger_node_delete(&merger->nodes[i]);
 
 	if (merger->nodes != NULL)
 		free(merger->nodes);
@@ -308,46 +304,52 @@ merger_next(struct merge_source *base, struct tuple_format *format,
 {
 	struct merger *merger = container_of(base, struct merger, base);
 
+	if (merger->node_count == 0) {
+		*out = NULL;
+		return 0;
+	}
+
 	/*
-	 * Fetch a first tuple for each source and add all heap
-	 * nodes to a merger heap.
+	 * Fetch a first tuple for each source and play the
+	 * matches of the whole tree.
 	 */
 	if (!merger->started) {
 		for (uint32_t i = 0; i < merger->node_count; ++i) {
-			struct merger_heap_node *node = &merger->nodes[i];
-			if (merger_add_heap_node(merger, node) != 0)
+			struct merger_node *node = &merger->nodes[i];
+			if (node->tuple != NULL)
+				continue;
+			if (merge_source_next(node->source, merger->format,
+					      &node->tuple) != 0)
 				return -1;
 		}
+		merger->losers[0] = merger_tree_build(merger, 1);
 		merger->started = true;
 	}
 
 	/* Get a next tuple. */
-	struct merger_heap_node *node = merger_heap_top(&merger->heap);
-	if (node == NULL) {
+	struct merger_node *node = &merger->nodes[merger->losers[0]];
+	struct tuple *tuple = node->tuple;
+	if (tuple == NULL) {
+		/* All the sources are exhausted. */
 		*out = NULL;
 		return 0;
 	}
-	struct tuple *tuple = node->tuple;
-	assert(tuple != NULL);
 
 	/* Validate the tuple. */
 	if (format != NULL && tuple_validate(format, tuple) != 0)
 		return -1;
 
 	/*
-	 * Note: An old node->tuple pointer will be written to
-	 * *out as refcounted tuple, so we don't unreference it
-	 * here.
+	 * Note: The tuple will be written to *out as refcounted
+	 * tuple, so we don't unreference it here.
 	 */
-	struct merge_source *source = node->source;
-	if (merge_source_next(source, merger->format, &node->tuple) != 0)
+	struct tuple *next;
+	if (merge_source_next(node->source, merger->format, &next) != 0)
 		return -1;
+	node->tuple = next;
 
-	/* Update a heap. */
-	if (node->tuple == NULL)
-		merger_heap_delete(&merger->heap, node);
-	else
-		merger_heap_update(&merger->heap, node);
+	/* Update the tree. */
+	merger_tree_update(merger);
 
 	*out = tuple;
 	return 0;
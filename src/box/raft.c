@@ -30,6 +30,7 @@
  */
 #include "box.h"
 #include "error.h"
+#include "fiber_cond.h"
 #include "journal.h"
 #include "raft.h"
 #include "relay.h"
@@ -63,6 +64,11 @@ struct rlist box_raft_on_broadcast =
 static struct fiber *box_raft_worker = NULL;
 /** Flag installed each time when new work appears for the worker fiber. */
 static bool box_raft_has_work = false;
+/**
+ * Signaled when a lease ack arrives or the Raft state changes, see
+ * box_read_barrier().
+ */
+static struct fiber_cond box_raft_lease_cond;
 
 static void
 box_raft_msg_to_request(const struct raft_msg *msg, struct raft_request *req)
@@ -115,6 +121,8 @@ box_raft_worker_f(va_list args)
 
 		raft_process_async(raft);
 		box_raft_update_synchro_queue(raft);
+		/* The synchro queue could be taken over. */
+		fiber_cond_broadcast(&box_raft_lease_cond);
 
 		if (!box_raft_has_work)
 			fiber_yield();
@@ -163,6 +171,7 @@ box_raft_on_update_f(struct trigger *trigger, void *event)
 	(void)trigger;
 	struct raft *raft = (struct raft *)event;
 	assert(raft == box_raft());
+	fiber_cond_broadcast(&box_raft_lease_cond);
 	/*
 	 * When the instance becomes a follower, it's good to make it read-only
 	 * ASAP. This way we make sure followers don't write anything.
@@ -433,6 +442,21 @@ box_raft_wait_term_persisted(void)
 	return 0;
 }
 
+void
+box_raft_process_lease_ack(uint32_t source, double sent)
+{
+	struct raft *raft = box_raft();
+	raft_process_lease_ack(raft, source, sent);
+	if (raft->state == RAFT_STATE_LEADER)
+		fiber_cond_broadcast(&box_raft_lease_cond);
+}
+
+int
+box_raft_wait_lease(double deadline)
+{
+	return fiber_cond_wait_deadline(&box_raft_lease_cond, deadline);
+}
+
 void
 box_raft_init(void)
 {
@@ -442,6 +466,7 @@ box_raft_init(void)
 		.schedule_async = box_raft_schedule_async,
 	};
 	raft_create(&box_raft_global, &box_raft_vtab);
+	fiber_cond_create(&box_raft_lease_cond);
 	trigger_create(&box_raft_on_update, box_raft_on_update_f, NULL, NULL);
 	raft_on_update(box_raft(), &box_raft_on_update);
 }
@@ -455,6 +480,7 @@ box_raft_free(void)
 	 * yields are not allowed.
 	 */
 	box_raft_worker = NULL;
+	fiber_cond_destroy(&box_raft_lease_cond);
 	raft_destroy(raft);
 	/*
 	 * Invalidate so as box_raft() would fail if any usage attempt happens.
@@ -112,6 +112,20 @@ box_raft_wait_term_outcome(void);
 int
 box_raft_wait_term_persisted(void);
 
+/**
+ * Handle a lease acknowledgement from a node with instance id @a source, see
+ * raft_process_lease_ack().
+ */
+void
+box_raft_process_lease_ack(uint32_t source, double sent);
+
+/**
+ * Block this fiber until the leader lease or the Raft state may have changed
+ * or the deadline (monotonic clock) is reached.
+ */
+int
+box_raft_wait_lease(double deadline);
+
 void
 box_raft_init(void);
 
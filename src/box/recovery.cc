@@ -35,6 +35,7 @@
 #include "trigger.h"
 #include "fiber.h"
 #include "xlog.h"
+#include "xlog_reader.h"
 #include "xrow.h"
 #include "xstream.h"
 #include "wal.h" /* wal_watcher */
@@ -242,6 +243,51 @@ recovery_delete(struct recovery *r)
  * The reading will be stopped on reaching stop_vclock.
  * Use NULL for boundless recover
  */
+/** Apply a row read from a WAL file unless it's already applied. */
+static void
+recover_row(struct recovery *r, struct xstream *stream,
+	    struct xrow_header *row)
+{
+	int64_t current_lsn = vclock_get(&r->vclock, row->replica_id);
+	if (row->lsn <= current_lsn)
+		return; /* already applied, skip */
+
+	/*
+	 * All rows in xlog files have an assigned replica
+	 * id. The only exception are local rows, which
+	 * are signed with a zero replica id.
+	 */
+	assert(row->replica_id != 0 || row->group_id == GROUP_LOCAL);
+	/*
+	 * We can promote the vclock either before or
+	 * after xstream_write(): it only makes any impact
+	 * in case of forced recovery, when we skip the
+	 * failed row anyway.
+	 */
+	vclock_follow_xrow(&r->vclock, row);
+	if (xstream_write(stream, row) != 0) {
+		if (!r->wal_dir.force_recovery)
+			diag_raise();
+
+		say_error("skipping row {%u: %lld}",
+			  (unsigned)row->replica_id, (long long)row->lsn);
+		diag_log();
+	}
+}
+
+/** Account a row read from a WAL file and yield if needed. */
+static void
+recover_count_row(struct xstream *stream)
+{
+	if (++stream->row_count % WAL_ROWS_PER_YIELD == 0) {
+		xstream_yield(stream);
+	}
+	if (stream->row_count % 100000 == 0) {
+		say_info_ratelimited("%.1fM rows processed",
+				     stream->row_count / 1e6);
+	}
+}
+
 static void
 recover_xlog(struct recovery *r, struct xstream *stream,
 	     const struct vclock *stop_vclock)
@@ -249,13 +295,7 @@ recover_xlog(struct recovery *r, struct xstream *stream,
 	struct xrow_header row;
 	while (xlog_cursor_next_xc(&r->cursor, &row,
 				   r->wal_dir.force_recovery) == 0) {
-		if (++stream->row_count % WAL_ROWS_PER_YIELD == 0) {
-			xstream_yield(stream);
-		}
-		if (stream->row_count % 100000 == 0) {
-			say_info_ratelimited("%.1fM rows processed",
-					     stream->row_count / 1e6);
-		}
+		recover_count_row(stream);
 		/*
 		 * Read the next row from xlog file.
 		 *
@@ -267,32 +307,38 @@ recover_xlog(struct recovery *r, struct xstream *stream,
 		if (stop_vclock != NULL &&
 		    r->vclock.signature >= stop_vclock->signature)
 			return;
-		int64_t current_lsn = vclock_get(&r->vclock, row.replica_id);
-		if (row.lsn <= current_lsn)
-			continue; /* already applied, skip */
+		recover_row(r, stream, &row);
+	}
+}
 
-		/*
-		 * All rows in xlog files have an assigned replica
-		 * id. The only exception are local rows, which
-		 * are signed with a zero replica id.
-		 */
-		assert(row.replica_id != 0 || row.group_id == GROUP_LOCAL);
-		/*
-		 * We can promote the vclock either before or
-		 * after xstream_write(): it only makes any impact
-		 * in case of forced recovery, when we skip the
-		 * failed row anyway.
-		 */
-		vclock_follow_xrow(&r->vclock, &row);
-		if (xstream_write(stream, &row) != 0) {
-			if (!r->wal_dir.force_recovery)
-				diag_raise();
-
-			say_error("skipping row {%u: %lld}",
-				  (unsigned)row.replica_id, (long long)row.lsn);
-			diag_log();
-		}
+/**
+ * Read all rows of the file the cursor was just opened for with
+ * a background reader, so that checking, decompressing and
+ * decoding the next rows overlaps with applying the current ones.
+ * The cursor itself isn't advanced: if the EOF marker is found it
+ * is switched to the EOF state, otherwise recover_xlog() will
+ * rescan the file from the start skipping applied rows.
+ */
+static void
+recover_xlog_prefetch(struct recovery *r, struct xstream *stream)
+{
+	assert(!r->wal_dir.force_recovery);
+	struct xlog_reader *reader = xlog_reader_new(r->cursor.name);
+	if (reader == NULL)
+		diag_raise();
+	auto guard = make_scoped_guard([=]{
+		xlog_reader_delete(reader);
+	});
+	struct xrow_header row;
+	int rc;
+	while ((rc = xlog_reader_next(reader, &row)) == 0) {
+		recover_count_row(stream);
+		recover_row(r, stream, &row);
 	}
+	if (rc < 0)
+		diag_raise();
+	if (xlog_reader_is_eof(reader))
+		r->cursor.state = XLOG_CURSOR_EOF;
 }
 
 /**
@@ -351,6 +397,11 @@ recover_remaining_wals(struct recovery *r, struct xstream *stream,
 
 		say_info("recover from `%s'", r->cursor.name);
 
+		if (r->use_reader && stop_vclock == NULL &&
+		    !r->wal_dir.force_recovery) {
+			recover_xlog_prefetch(r, stream);
+			continue;
+		}
 recover_current_wal:
 		recover_xlog(r, stream, stop_vclock);
 	}
@@ -56,6 +56,13 @@ struct recovery {
 	struct fiber *watcher;
 	/** List of triggers invoked when the current WAL is closed. */
 	struct rlist on_close_log;
+	/**
+	 * If set, WAL files that are recovered to the end are read
+	 * by a background thread, which checks, decompresses and
+	 * decodes rows while the caller applies them. May only be
+	 * set if no one appends to the files, i.e. on local recovery.
+	 */
+	bool use_reader;
 };
 
 struct recovery *
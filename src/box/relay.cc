@@ -53,12 +53,28 @@
 #include "xrow.h"
 #include "xrow_io.h"
 #include "xstream.h"
+#include "zstd.h"
 #include "wal.h"
 #include "txn_limbo.h"
 #include "raft.h"
+#include "clock.h"
+#include "rmean.h"
 
 #include <stdlib.h>
 
+enum {
+	/**
+	 * Size of initial join rows accumulated before they are
+	 * written to the socket at once.
+	 */
+	RELAY_JOIN_BATCH_SIZE = 256 * 1024,
+	/**
+	 * Size of uncompressed WAL rows accumulated before they are
+	 * written to the socket at once.
+	 */
+	RELAY_SEND_BATCH_SIZE = 64 * 1024,
+};
+
 /**
  * Cbus message to send status updates from relay to tx thread.
  */
@@ -71,6 +87,8 @@ struct relay_status_msg {
 	struct vclock vclock;
 	/** Last replicated transaction timestamp. */
 	double txn_lag;
+	/** Last lease timestamp acknowledged by the replica. */
+	double lease_ts;
 };
 
 /**
@@ -114,6 +132,16 @@ struct relay {
 	struct recovery *r;
 	/** Xstream argument to recovery */
 	struct xstream stream;
+	/**
+	 * Sequence number of the next WAL batch to read from memory
+	 * or -1 if the relay reads WAL files, see wal_mem_find().
+	 */
+	int64_t mem_seq;
+	/**
+	 * Set if rows were read from memory, so the recovery vclock
+	 * is ahead of the recovery cursor position.
+	 */
+	bool r_is_stale;
 	/** Vclock to stop playing xlogs */
 	struct vclock stop_vclock;
 	/** Remote replica */
@@ -126,6 +154,11 @@ struct relay {
 	struct diag diag;
 	/** Vclock recieved from replica. */
 	struct vclock recv_vclock;
+	/**
+	 * Lease timestamp of the last heartbeat received by the replica, see
+	 * IPROTO_LEASE_TS.
+	 */
+	double recv_lease_ts;
 	/** Replicatoin slave version. */
 	uint32_t version_id;
 	/**
@@ -135,6 +168,39 @@ struct relay {
 	 * is passed by the replica on subscribe.
 	 */
 	uint32_t id_filter;
+	/**
+	 * Filter of rows requested by the subscriber. DML rows that
+	 * don't pass it are sent as NOPs. The space ids are owned
+	 * by the relay.
+	 */
+	struct xrow_subscribe_filter filter;
+	/**
+	 * Compression level of the stream sent to the replica or 0 if
+	 * the stream isn't compressed. Set on subscribe, see
+	 * box.cfg.replication_compression_level.
+	 */
+	int compression_level;
+	/**
+	 * Size of encoded rows accumulated before they are compressed
+	 * and sent, see box.cfg.replication_compression_batch_size.
+	 */
+	size_t compression_batch_size;
+	/** Compression context, NULL if the stream isn't compressed. */
+	ZSTD_CCtx *zctx;
+	/** Compressed data of the current batch. */
+	struct ibuf zdst;
+	/**
+	 * Encoded rows waiting to be written to the socket or, if the
+	 * stream is compressed, to be compressed, see relay_flush().
+	 * Used both by initial join and by the WAL stream. Allocated
+	 * with malloc(), because initial join rows are sent both from
+	 * tx and engine threads.
+	 */
+	char *send_buf;
+	/** Size of the data in send_buf. */
+	size_t send_buf_used;
+	/** Allocated size of send_buf. */
+	size_t send_buf_size;
 	/**
 	 * How many rows has this relay sent to the replica. Used to yield once
 	 * in a while when reading a WAL to unblock the event loop.
@@ -161,6 +227,8 @@ struct relay {
 	struct stailq pending_gc;
 	/** Time when last row was sent to peer. */
 	double last_row_time;
+	/** Time when last heartbeat was sent to peer. */
+	double last_heartbeat_time;
 	/**
 	 * A time difference between the moment when we
 	 * wrote a transaction to the local WAL and when
@@ -171,6 +239,8 @@ struct relay {
 	double txn_lag;
 	/** Relay sync state. */
 	enum relay_state state;
+	/** Statistics, see relay_stat_name. */
+	struct rmean *stat;
 
 	struct {
 		/* Align to prevent false-sharing with tx thread */
@@ -239,9 +309,45 @@ relay_txn_lag(const struct relay *relay)
 	return relay->tx.txn_lag;
 }
 
+/** CPUs to pin relay threads to, see box.cfg.replication_cpu_affinity. */
+static char *relay_cpu_affinity;
+
+void
+relay_set_cpu_affinity(const char *cpus)
+{
+	free(relay_cpu_affinity);
+	relay_cpu_affinity = cpus != NULL ? xstrdup(cpus) : NULL;
+}
+
+/** Pin a just started relay thread to relay_cpu_affinity. */
+static void
+relay_pin_cord(struct relay *relay)
+{
+	if (cord_set_cpu_affinity(&relay->cord, relay_cpu_affinity) != 0)
+		diag_log();
+}
+
+static const char *relay_stat_strs[] = {
+	"ROWS",
+	"BYTES",
+	"READ_TIME",
+	"SEND_TIME",
+};
+
+static_assert(lengthof(relay_stat_strs) == RELAY_STAT_LAST,
+	      "relay_stat_strs must match relay_stat_name");
+
+struct rmean *
+relay_stat(const struct relay *relay)
+{
+	return relay->stat;
+}
+
 static void
 relay_send(struct relay *relay, struct xrow_header *packet);
 static void
+relay_flush(struct relay *relay);
+static void
 relay_send_initial_join_row(struct xstream *stream, struct xrow_header *row);
 static void
 relay_send_row(struct xstream *stream, struct xrow_header *row);
@@ -273,6 +379,13 @@ relay_new(struct replica *replica)
 	assert(relay != NULL);
 
 	memset(relay, 0, sizeof(struct relay));
+	relay->stat = rmean_new(relay_stat_strs, RELAY_STAT_LAST);
+	if (relay->stat == NULL) {
+		diag_set(OutOfMemory, sizeof(struct rmean), "rmean_new",
+			 "relay statistics");
+		free(relay);
+		return NULL;
+	}
 	relay->replica = replica;
 	relay->last_row_time = ev_monotonic_now(loop());
 	fiber_cond_create(&relay->reader_cond);
@@ -305,6 +418,8 @@ relay_start(struct relay *relay, struct iostream *io, uint64_t sync,
 	relay->sync = sync;
 	relay->state = RELAY_FOLLOW;
 	relay->row_count = 0;
+	relay->mem_seq = -1;
+	relay->r_is_stale = false;
 	relay->last_row_time = ev_monotonic_now(loop());
 }
 
@@ -374,6 +489,9 @@ relay_delete(struct relay *relay)
 		relay_stop(relay);
 	fiber_cond_destroy(&relay->reader_cond);
 	diag_destroy(&relay->diag);
+	free(relay->send_buf);
+	free(relay->filter.space_ids);
+	rmean_delete(relay->stat);
 	TRASH(relay);
 	free(relay);
 }
@@ -464,6 +582,45 @@ relay_initial_join(struct iostream *io, uint64_t sync, struct vclock *vclock,
 
 	/* Send read view to the replica. */
 	engine_join_xc(&ctx, &relay->stream);
+	relay_flush(relay);
+}
+
+/**
+ * Create the compression context if the stream is compressed.
+ * Must be called in the relay cord.
+ */
+static void
+relay_create_send_buf(struct relay *relay)
+{
+	if (relay->compression_level == 0)
+		return;
+	relay->zctx = ZSTD_createCCtx();
+	if (relay->zctx == NULL) {
+		say_warn("failed to create compression context, "
+			 "sending uncompressed stream");
+		return;
+	}
+	ZSTD_CCtx_setParameter(relay->zctx, ZSTD_c_compressionLevel,
+			       relay->compression_level);
+	ibuf_create(&relay->zdst, &cord()->slabc, 16 * 1024);
+}
+
+/**
+ * Free the buffer of rows to send and destroy the compression
+ * context created by relay_create_send_buf().
+ */
+static void
+relay_destroy_send_buf(struct relay *relay)
+{
+	free(relay->send_buf);
+	relay->send_buf = NULL;
+	relay->send_buf_used = 0;
+	relay->send_buf_size = 0;
+	if (relay->zctx != NULL) {
+		ZSTD_freeCCtx(relay->zctx);
+		relay->zctx = NULL;
+		ibuf_destroy(&relay->zdst);
+	}
 }
 
 int
@@ -475,10 +632,16 @@ relay_final_join_f(va_list ap)
 	coio_enable();
 	relay_set_cord_name(relay->io->fd);
 
+	relay_create_send_buf(relay);
+	auto send_buf_guard = make_scoped_guard([=] {
+		relay_destroy_send_buf(relay);
+	});
+
 	/* Send all WALs until stop_vclock */
 	assert(relay->stream.write != NULL);
 	recover_remaining_wals(relay->r, &relay->stream,
 			       &relay->stop_vclock, true);
+	relay_flush(relay);
 	assert(vclock_compare(&relay->r->vclock, &relay->stop_vclock) == 0);
 	return 0;
 }
@@ -508,8 +671,10 @@ relay_final_join(struct iostream *io, uint64_t sync,
 
 	int rc = cord_costart(&relay->cord, "final_join",
 			      relay_final_join_f, relay);
-	if (rc == 0)
+	if (rc == 0) {
+		relay_pin_cord(relay);
 		rc = cord_cojoin(&relay->cord);
+	}
 	if (rc != 0)
 		diag_raise();
 
@@ -541,6 +706,10 @@ tx_status_update(struct cmsg *msg)
 	struct relay_status_msg *status = (struct relay_status_msg *)msg;
 	vclock_copy(&status->relay->tx.vclock, &status->vclock);
 	status->relay->tx.txn_lag = status->txn_lag;
+	if (status->lease_ts != 0 && !status->relay->replica->anon) {
+		box_raft_process_lease_ack(status->relay->replica->id,
+					   status->lease_ts);
+	}
 
 	struct replication_ack ack;
 	ack.source = status->relay->replica->id;
@@ -642,6 +811,96 @@ relay_set_error(struct relay *relay, struct error *e)
 		diag_set_error(&relay->diag, e);
 }
 
+/**
+ * Send rows of a WAL batch kept in memory, skipping those that
+ * have already been sent, like recover_xlog() does.
+ */
+static void
+relay_send_mem_batch(struct relay *relay, struct wal_mem_batch *batch)
+{
+	struct recovery *r = relay->r;
+	/*
+	 * The recovery cursor doesn't see the end of the previous
+	 * file, so run the triggers that advance garbage collection.
+	 */
+	if (batch->is_new_file)
+		trigger_run_xc(&r->on_close_log, NULL);
+	const char *pos = batch->data;
+	const char *end = batch->data + batch->size;
+	while (pos < end) {
+		struct xrow_header row;
+		xrow_header_decode_xc(&row, &pos, end, false);
+		if (++relay->stream.row_count % WAL_ROWS_PER_YIELD == 0)
+			xstream_yield(&relay->stream);
+		if (row.lsn <= vclock_get(&r->vclock, row.replica_id))
+			continue;
+		vclock_follow_xrow(&r->vclock, &row);
+		relay_send_row(&relay->stream, &row);
+	}
+}
+
+/**
+ * Send rows written to WAL since the last call from memory,
+ * without reading WAL files. Returns false if the rows aren't
+ * in memory anymore or yet, and the relay has to read the files.
+ */
+static bool
+relay_recover_from_mem(struct relay *relay)
+{
+	if (relay->mem_seq < 0) {
+		relay->mem_seq = wal_mem_find(&relay->r->vclock);
+		if (relay->mem_seq < 0)
+			return false;
+	}
+	while (true) {
+		bool is_lost;
+		struct wal_mem_batch *batch = wal_mem_get(relay->mem_seq,
+							  &is_lost);
+		if (is_lost) {
+			relay->mem_seq = -1;
+			return false;
+		}
+		if (batch == NULL)
+			return true;
+		auto guard = make_scoped_guard([=] {
+			wal_mem_batch_unref(batch);
+		});
+		relay->r_is_stale = true;
+		relay_send_mem_batch(relay, batch);
+		relay->mem_seq++;
+	}
+}
+
+/**
+ * Reopen the recovery at its vclock after reading rows from
+ * memory, so that it continues from the first row not sent yet.
+ */
+static void
+relay_reopen_recovery(struct relay *relay)
+{
+	struct recovery *r = recovery_new(wal_dir(), false, &relay->r->vclock);
+	rlist_swap(&relay->r->on_close_log, &r->on_close_log);
+	recovery_delete(relay->r);
+	relay->r = r;
+	relay->r_is_stale = false;
+}
+
+/**
+ * Account the time passed since @a start as time spent reading WAL,
+ * excluding the time spent sending rows since then. @a send_time is
+ * the send time counter at @a start.
+ */
+static void
+relay_collect_read_time(struct relay *relay, double start,
+			int64_t send_time)
+{
+	int64_t total = (clock_monotonic() - start) * 1e6;
+	int64_t sent = rmean_total(relay->stat, RELAY_STAT_SEND_TIME) -
+		       send_time;
+	if (total > sent)
+		rmean_collect(relay->stat, RELAY_STAT_READ_TIME, total - sent);
+}
+
 static void
 relay_process_wal_event(struct wal_watcher *watcher, unsigned events)
 {
@@ -658,9 +917,24 @@ relay_process_wal_event(struct wal_watcher *watcher, unsigned events)
 		 */
 		return;
 	}
+	double start = clock_monotonic();
+	int64_t send_time = rmean_total(relay->stat, RELAY_STAT_SEND_TIME);
+	auto read_time_guard = make_scoped_guard([&] {
+		relay_collect_read_time(relay, start, send_time);
+	});
 	try {
+		if (relay_recover_from_mem(relay)) {
+			relay_flush(relay);
+			return;
+		}
+		bool scan_dir = (events & WAL_EVENT_ROTATE) != 0;
+		if (relay->r_is_stale) {
+			relay_reopen_recovery(relay);
+			scan_dir = true;
+		}
 		recover_remaining_wals(relay->r, &relay->stream, NULL,
-				       (events & WAL_EVENT_ROTATE) != 0);
+				       scan_dir);
+		relay_flush(relay);
 	} catch (Exception *e) {
 		relay_set_error(relay, e);
 		fiber_cancel(fiber());
@@ -685,6 +959,9 @@ relay_reader_f(va_list ap)
 			coio_read_xrow_timeout_xc(relay->io, &ibuf, &xrow,
 					replication_disconnect_timeout());
 			xrow_decode_vclock_xc(&xrow, &relay->recv_vclock);
+			if (xrow_decode_lease_ts(&xrow,
+						 &relay->recv_lease_ts) != 0)
+				diag_raise();
 			/*
 			 * Replica send us last replicated transaction
 			 * timestamp which is needed for relay lag
@@ -713,8 +990,16 @@ static void
 relay_send_heartbeat(struct relay *relay)
 {
 	struct xrow_header row;
-	xrow_encode_timestamp(&row, instance_id, ev_now(loop()));
+	/*
+	 * The lease timestamp is compared with the monotonic clock of the tx
+	 * thread when the replica echoes it back, see box_read_barrier().
+	 */
+	double now = ev_monotonic_now(loop());
+	relay->last_heartbeat_time = now;
 	try {
+		if (xrow_encode_heartbeat(&row, instance_id, ev_now(loop()),
+					  now) != 0)
+			diag_raise();
 		relay_send(relay, &row);
 	} catch (Exception *e) {
 		relay_set_error(relay, e);
@@ -819,6 +1104,7 @@ relay_subscribe_f(va_list ap)
 
 	coio_enable();
 	relay_set_cord_name(relay->io->fd);
+	relay_create_send_buf(relay);
 
 	/* Create cpipe to tx for propagating vclock. */
 	cbus_endpoint_create(&relay->endpoint, tt_sprintf("relay_%p", relay),
@@ -840,7 +1126,11 @@ relay_subscribe_f(va_list ap)
 	if (!relay->replica->anon)
 		trigger_add(&relay->r->on_close_log, &on_close_log);
 
-	/* Setup WAL watcher for sending new rows to the replica. */
+	/*
+	 * Setup WAL watcher for sending new rows to the replica.
+	 * Once the relay is caught up, it reads them from memory.
+	 */
+	wal_mem_attach();
 	wal_set_watcher(&relay->wal_watcher, relay->endpoint.name,
 			relay_process_wal_event, cbus_process);
 
@@ -870,8 +1160,14 @@ relay_subscribe_f(va_list ap)
 		if (inj != NULL && inj->dparam != 0)
 			timeout = inj->dparam;
 
+		/*
+		 * Heartbeats are also sent under load, because they
+		 * keep the leader lease, see IPROTO_LEASE_TS.
+		 */
 		fiber_cond_wait_deadline(&relay->reader_cond,
-					 relay->last_row_time + timeout);
+					 MIN(relay->last_row_time,
+					     relay->last_heartbeat_time) +
+					 timeout);
 
 		/*
 		 * The fiber can be woken by IO cancel, by a timeout of
@@ -880,7 +1176,9 @@ relay_subscribe_f(va_list ap)
 		 */
 		cbus_process(&relay->endpoint);
 		/* Check for a heartbeat timeout. */
-		if (ev_monotonic_now(loop()) - relay->last_row_time > timeout)
+		double now = ev_monotonic_now(loop());
+		if (now - relay->last_row_time > timeout ||
+		    now - relay->last_heartbeat_time > timeout)
 			relay_send_heartbeat(relay);
 		/*
 		 * Check that the vclock has been updated and the previous
@@ -898,7 +1196,8 @@ relay_subscribe_f(va_list ap)
 		relay_schedule_pending_gc(relay, send_vclock);
 
 		if (vclock_sum(&relay->status_msg.vclock) ==
-		    vclock_sum(send_vclock))
+		    vclock_sum(send_vclock) &&
+		    relay->status_msg.lease_ts == relay->recv_lease_ts)
 			continue;
 		static const struct cmsg_hop route[] = {
 			{tx_status_update, NULL}
@@ -906,6 +1205,7 @@ relay_subscribe_f(va_list ap)
 		cmsg_init(&relay->status_msg.msg, route);
 		vclock_copy(&relay->status_msg.vclock, send_vclock);
 		relay->status_msg.txn_lag = relay->txn_lag;
+		relay->status_msg.lease_ts = relay->recv_lease_ts;
 		relay->status_msg.relay = relay;
 		cpipe_push(&relay->tx_pipe, &relay->status_msg.msg);
 	}
@@ -920,6 +1220,7 @@ relay_subscribe_f(va_list ap)
 	 */
 	trigger_clear(&on_close_log);
 	wal_clear_watcher(&relay->wal_watcher, cbus_process);
+	wal_mem_detach();
 
 	/* Join ack reader fiber. */
 	fiber_cancel(reader);
@@ -931,6 +1232,7 @@ relay_subscribe_f(va_list ap)
 	cbus_endpoint_destroy(&relay->endpoint, cbus_process);
 
 	relay_exit(relay);
+	relay_destroy_send_buf(relay);
 
 	/*
 	 * Log the error that caused the relay to break the loop.
@@ -948,7 +1250,9 @@ relay_subscribe_f(va_list ap)
 void
 relay_subscribe(struct replica *replica, struct iostream *io, uint64_t sync,
 		struct vclock *replica_clock, uint32_t replica_version_id,
-		uint32_t replica_id_filter)
+		uint32_t replica_id_filter,
+		const struct iproto_features *replica_features,
+		const struct xrow_subscribe_filter *filter)
 {
 	assert(replica->anon || replica->id != REPLICA_ID_NIL);
 	struct relay *relay = replica->relay;
@@ -979,35 +1283,200 @@ relay_subscribe(struct replica *replica, struct iostream *io, uint64_t sync,
 	 * always be valid.
 	 */
 	vclock_copy(&relay->recv_vclock, replica_clock);
+	relay->recv_lease_ts = 0;
+	relay->status_msg.lease_ts = 0;
 	relay->r = recovery_new(wal_dir(), false, replica_clock);
 	vclock_copy(&relay->tx.vclock, replica_clock);
 	relay->version_id = replica_version_id;
 
 	relay->id_filter = replica_id_filter;
 
+	free(relay->filter.space_ids);
+	relay->filter = *filter;
+	if (filter->space_ids != NULL) {
+		size_t size = filter->space_id_count * sizeof(uint32_t);
+		relay->filter.space_ids = (uint32_t *)xmalloc(size);
+		memcpy(relay->filter.space_ids, filter->space_ids, size);
+	}
+
+	relay->compression_level = 0;
+	if (replication_compression_level > 0 &&
+	    iproto_features_test(replica_features,
+				 IPROTO_FEATURE_REPLICATION_COMPRESSION)) {
+		relay->compression_level = replication_compression_level;
+		relay->compression_batch_size =
+			replication_compression_batch_size;
+	}
+
 	int rc = cord_costart(&relay->cord, "subscribe",
 			      relay_subscribe_f, relay);
-	if (rc == 0)
+	if (rc == 0) {
+		relay_pin_cord(relay);
 		rc = cord_cojoin(&relay->cord);
+	}
 	if (rc != 0)
 		diag_raise();
 }
 
+/** Write a packet to the replica socket. */
 static void
-relay_send(struct relay *relay, struct xrow_header *packet)
+relay_write(struct relay *relay, struct xrow_header *packet)
 {
 	ERROR_INJECT_YIELD(ERRINJ_RELAY_SEND_DELAY);
 
 	packet->sync = relay->sync;
 	relay->last_row_time = ev_monotonic_now(loop());
-	coio_write_xrow(relay->io, packet);
+	struct iovec iov[XROW_IOVMAX];
+	int iovcnt = xrow_to_iovec_xc(packet, iov);
+	double start = clock_monotonic();
+	ssize_t size = coio_writev(relay->io, iov, iovcnt, 0);
+	if (size < 0)
+		diag_raise();
+	rmean_collect(relay->stat, RELAY_STAT_SEND_TIME,
+		      (clock_monotonic() - start) * 1e6);
+	rmean_collect(relay->stat, RELAY_STAT_BYTES, size);
+	fiber_gc();
+
+	struct errinj *inj = errinj(ERRINJ_RELAY_TIMEOUT, ERRINJ_DOUBLE);
+	if (inj != NULL && inj->dparam > 0)
+		fiber_sleep(inj->dparam);
+}
+
+/**
+ * Check if sending is delayed by an error injection. The delays
+ * are applied per row, so the rows aren't batched then.
+ */
+static inline bool
+relay_is_send_delayed(void)
+{
+	struct errinj *inj = errinj(ERRINJ_RELAY_SEND_DELAY, ERRINJ_BOOL);
+	if (inj != NULL && inj->bparam)
+		return true;
+	inj = errinj(ERRINJ_RELAY_TIMEOUT, ERRINJ_DOUBLE);
+	return inj != NULL && inj->dparam > 0;
+}
+
+/**
+ * Append an encoded row to the buffer of rows to send, see
+ * relay_flush().
+ */
+static void
+relay_append_row(struct relay *relay, struct xrow_header *row)
+{
+	row->sync = relay->sync;
+	struct iovec iov[XROW_IOVMAX];
+	int iovcnt = xrow_to_iovec_xc(row, iov);
+	for (int i = 0; i < iovcnt; i++) {
+		size_t len = iov[i].iov_len;
+		if (relay->send_buf_used + len > relay->send_buf_size) {
+			size_t size = MAX(relay->send_buf_used + len,
+					  (size_t)RELAY_SEND_BATCH_SIZE);
+			size = MAX(size, 2 * relay->send_buf_size);
+			relay->send_buf = (char *)xrealloc(relay->send_buf,
+							   size);
+			relay->send_buf_size = size;
+		}
+		memcpy(relay->send_buf + relay->send_buf_used,
+		       iov[i].iov_base, len);
+		relay->send_buf_used += len;
+	}
 	fiber_gc();
+}
+
+/**
+ * Write rows accumulated by relay_append_row() to the replica
+ * socket at once.
+ */
+static void
+relay_write_batch(struct relay *relay)
+{
+	ERROR_INJECT_YIELD(ERRINJ_RELAY_SEND_DELAY);
+
+	relay->last_row_time = ev_monotonic_now(loop());
+	size_t size = relay->send_buf_used;
+	double start = clock_monotonic();
+	if (coio_write_timeout(relay->io, relay->send_buf, size,
+			       TIMEOUT_INFINITY) < 0)
+		diag_raise();
+	rmean_collect(relay->stat, RELAY_STAT_SEND_TIME,
+		      (clock_monotonic() - start) * 1e6);
+	rmean_collect(relay->stat, RELAY_STAT_BYTES, size);
+	relay->send_buf_used = 0;
 
 	struct errinj *inj = errinj(ERRINJ_RELAY_TIMEOUT, ERRINJ_DOUBLE);
 	if (inj != NULL && inj->dparam > 0)
 		fiber_sleep(inj->dparam);
 }
 
+/**
+ * Send rows accumulated by relay_append_row() to the replica.
+ *
+ * If the stream is compressed, the rows are compressed and sent as
+ * a single packet. The zstd stream is flushed, not finished, so
+ * that the replica can decode all the rows sent so far while the
+ * compression window is preserved across batches.
+ */
+static void
+relay_flush(struct relay *relay)
+{
+	if (relay->send_buf_used == 0)
+		return;
+	if (relay->zctx == NULL) {
+		relay_write_batch(relay);
+		return;
+	}
+	ZSTD_inBuffer input = {relay->send_buf, relay->send_buf_used, 0};
+	size_t rc;
+	do {
+		size_t size = MAX(ZSTD_compressBound(input.size - input.pos),
+				  ZSTD_CStreamOutSize());
+		void *dst = ibuf_reserve(&relay->zdst, size);
+		if (dst == NULL)
+			tnt_raise(OutOfMemory, size, "ibuf", "compressed rows");
+		ZSTD_outBuffer output = {dst, size, 0};
+		rc = ZSTD_compressStream2(relay->zctx, &output, &input,
+					  ZSTD_e_flush);
+		if (ZSTD_isError(rc)) {
+			tnt_raise(ClientError, ER_COMPRESSION,
+				  ZSTD_getErrorName(rc));
+		}
+		ibuf_alloc(&relay->zdst, output.pos);
+	} while (rc != 0);
+	relay->send_buf_used = 0;
+
+	struct xrow_header row;
+	xrow_encode_compressed_rows_xc(&row, relay->zdst.rpos,
+				       ibuf_used(&relay->zdst));
+	relay_write(relay, &row);
+	ibuf_reset(&relay->zdst);
+}
+
+static void
+relay_send(struct relay *relay, struct xrow_header *packet)
+{
+	/* Accumulated rows must go first. */
+	relay_flush(relay);
+	relay_write(relay, packet);
+}
+
+/**
+ * Append a WAL row to the batch of rows to be sent and flush the
+ * batch if it is big enough. Writing rows one by one would cost a
+ * system call per row on a busy master. The batch is also flushed
+ * once the relay runs out of WAL rows.
+ */
+static void
+relay_send_batched(struct relay *relay, struct xrow_header *packet)
+{
+	relay_append_row(relay, packet);
+	size_t batch_size = relay->zctx != NULL ?
+			    relay->compression_batch_size :
+			    (size_t)RELAY_SEND_BATCH_SIZE;
+	if (relay->send_buf_used >= batch_size ||
+	    relay_is_send_delayed())
+		relay_flush(relay);
+}
+
 static void
 relay_send_initial_join_row(struct xstream *stream, struct xrow_header *row)
 {
@@ -1016,8 +1485,18 @@ relay_send_initial_join_row(struct xstream *stream, struct xrow_header *row)
 	 * Ignore replica local requests as we don't need to promote
 	 * vclock while sending a snapshot.
 	 */
-	if (row->group_id != GROUP_LOCAL)
-		relay_send(relay, row);
+	if (row->group_id == GROUP_LOCAL)
+		return;
+	rmean_collect(relay->stat, RELAY_STAT_ROWS, 1);
+	/*
+	 * A snapshot consists of many small rows, so writing them
+	 * one by one would cost a system call per tuple. Accumulate
+	 * them and write in big chunks instead.
+	 */
+	relay_append_row(relay, row);
+	if (relay->send_buf_used >= RELAY_JOIN_BATCH_SIZE ||
+	    relay_is_send_delayed())
+		relay_flush(relay);
 }
 
 /**
@@ -1054,7 +1533,10 @@ relay_restart_recovery(struct relay *relay)
 	rlist_swap(&relay->r->on_close_log, &r->on_close_log);
 	recovery_delete(relay->r);
 	relay->r = r;
+	relay->mem_seq = -1;
+	relay->r_is_stale = false;
 	recover_remaining_wals(relay->r, &relay->stream, NULL, true);
+	relay_flush(relay);
 }
 
 /**
@@ -1141,6 +1623,16 @@ relay_send_row(struct xstream *stream, struct xrow_header *packet)
 	/* Check if the rows from the instance are filtered. */
 	if ((1 << packet->replica_id & relay->id_filter) != 0)
 		return;
+	/*
+	 * Rows filtered out by the subscriber are sent as NOPs
+	 * so that its vclock is promoted.
+	 */
+	if (iproto_type_is_dml(packet->type) && packet->type != IPROTO_NOP &&
+	    !xrow_subscribe_filter_is_empty(&relay->filter) &&
+	    !xrow_subscribe_filter_match(&relay->filter, packet)) {
+		packet->type = IPROTO_NOP;
+		packet->bodycnt = 0;
+	}
 	/*
 	 * We're feeding a WAL, thus responding to FINAL JOIN or SUBSCRIBE
 	 * request. If this is FINAL JOIN (i.e. relay->replica is NULL),
@@ -1165,6 +1657,7 @@ relay_send_row(struct xstream *stream, struct xrow_header *packet)
 			say_warn("injected broken lsn: %lld",
 				 (long long) packet->lsn);
 		}
-		relay_send(relay, packet);
+		rmean_collect(relay->stat, RELAY_STAT_ROWS, 1);
+		relay_send_batched(relay, packet);
 	}
 }
@@ -38,10 +38,12 @@ extern "C" {
 #endif /* defined(__cplusplus) */
 
 struct iostream;
+struct iproto_features;
 struct relay;
 struct replica;
 struct tt_uuid;
 struct vclock;
+struct xrow_subscribe_filter;
 
 enum relay_state {
 	/**
@@ -100,6 +102,26 @@ relay_last_row_time(const struct relay *relay);
 double
 relay_txn_lag(const struct relay *relay);
 
+/** Relay statistics counters, see relay_stat(). */
+enum relay_stat_name {
+	/** Rows sent to the replica. */
+	RELAY_STAT_ROWS,
+	/** Bytes sent to the replica. */
+	RELAY_STAT_BYTES,
+	/** Time spent reading WAL, in microseconds. */
+	RELAY_STAT_READ_TIME,
+	/** Time spent writing to the socket, in microseconds. */
+	RELAY_STAT_SEND_TIME,
+	RELAY_STAT_LAST,
+};
+
+/**
+ * Returns relay's statistics. The counters are updated by the
+ * relay thread atomically and may be read from tx.
+ */
+struct rmean *
+relay_stat(const struct relay *relay);
+
 /**
  * Send a Raft update request to the relay channel. It is not
  * guaranteed that it will be delivered. The connection may break.
@@ -123,6 +145,13 @@ void
 relay_initial_join(struct iostream *io, uint64_t sync, struct vclock *vclock,
 		   uint32_t replica_version_id);
 
+/**
+ * Set the CPUs that relay threads started from now on are pinned
+ * to, see cord_set_cpu_affinity(). NULL means no pinning.
+ */
+void
+relay_set_cpu_affinity(const char *cpus);
+
 /**
  * Send final JOIN rows to the replica.
  *
@@ -141,6 +170,8 @@ relay_final_join(struct iostream *io, uint64_t sync,
 void
 relay_subscribe(struct replica *replica, struct iostream *io, uint64_t sync,
 		struct vclock *replica_vclock, uint32_t replica_version_id,
-		uint32_t replica_id_filter);
+		uint32_t replica_id_filter,
+		const struct iproto_features *replica_features,
+		const struct xrow_subscribe_filter *filter);
 
 #endif /* TARANTOOL_REPLICATION_RELAY_H_INCLUDED */
@@ -56,6 +56,8 @@ double replication_synchro_timeout = 5.0; /* seconds */
 double replication_sync_timeout = 300.0; /* seconds */
 bool replication_skip_conflict = false;
 bool replication_anon = false;
+int replication_compression_level = 0;
+int replication_compression_batch_size = 16 * 1024;
 
 struct replicaset replicaset;
 
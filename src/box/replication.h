@@ -155,6 +155,18 @@ extern bool replication_skip_conflict;
  */
 extern bool replication_anon;
 
+/**
+ * Compression level of replication streams sent to replicas or
+ * 0 if the streams aren't compressed. Applied on subscribe.
+ */
+extern int replication_compression_level;
+
+/**
+ * Size of rows a relay accumulates before compressing and
+ * sending them.
+ */
+extern int replication_compression_batch_size;
+
 /**
  * Wait for the given period of time before trying to reconnect
  * to a master.
@@ -33,6 +33,7 @@
 
 #include <stdint.h>
 #include <stdio.h> /* snprintf */
+#include <string.h>
 #include "error.h"
 #include "space.h"
 
@@ -69,19 +70,29 @@ space_by_name(const char *name);
 uint32_t
 box_schema_version(void);
 
+/** Number of entries in the space_cache_find() cache. */
+enum { SPACE_CACHE_FIND_SIZE = 16 };
+
+/**
+ * Look up a space by id, set diag if it isn't found. The
+ * last found spaces are cached by the lowest bits of their ids,
+ * so that requests to a few spaces in turn don't go to the hash.
+ * The cache is cleared on any change of the space cache.
+ */
 static inline struct space *
 space_cache_find(uint32_t id)
 {
 	static uint32_t prev_space_cache_version = 0;
-	static struct space *space = NULL;
-	if (prev_space_cache_version != space_cache_version)
-		space = NULL;
-	if (space && space->def->id == id)
-		return space;
-	if ((space = space_by_id(id))) {
+	static struct space *cache[SPACE_CACHE_FIND_SIZE];
+	if (prev_space_cache_version != space_cache_version) {
+		memset(cache, 0, sizeof(cache));
 		prev_space_cache_version = space_cache_version;
-		return space;
 	}
+	struct space **space = &cache[id % SPACE_CACHE_FIND_SIZE];
+	if (*space != NULL && (*space)->def->id == id)
+		return *space;
+	if ((*space = space_by_id(id)) != NULL)
+		return *space;
 	diag_set(ClientError, ER_NO_SUCH_SPACE, int2str(id));
 	return NULL;
 }
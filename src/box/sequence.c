@@ -61,6 +61,13 @@ struct sequence_data {
 	uint32_t id;
 	/** Sequence value. */
 	int64_t value;
+	/**
+	 * Sequence value written to _sequence_data. It's equal to
+	 * @value unless sequence_reserve() has preallocated values
+	 * for the sequence, in which case it's the last of them.
+	 * That's what goes to a snapshot.
+	 */
+	int64_t reserved;
 };
 
 static inline bool
@@ -166,6 +173,7 @@ sequence_set(struct sequence *seq, int64_t value)
 	struct sequence_data new_data, old_data;
 	new_data.id = key;
 	new_data.value = value;
+	new_data.reserved = value;
 	if (light_sequence_replace(&sequence_data_index, hash,
 				   new_data, &old_data) != light_sequence_end)
 		return 0;
@@ -175,6 +183,37 @@ sequence_set(struct sequence *seq, int64_t value)
 	return -1;
 }
 
+int
+sequence_set_reserved(struct sequence *seq, int64_t value)
+{
+	uint32_t key = seq->def->id;
+	uint32_t hash = sequence_hash(key);
+	uint32_t pos = light_sequence_find_key(&sequence_data_index, hash, key);
+	if (pos != light_sequence_end) {
+		struct sequence_data data = light_sequence_get(
+			&sequence_data_index, pos);
+		if (data.reserved == value)
+			return 0;
+	}
+	return sequence_set(seq, value);
+}
+
+void
+sequence_cancel_reserve(struct sequence *seq)
+{
+	uint32_t key = seq->def->id;
+	uint32_t hash = sequence_hash(key);
+	uint32_t pos = light_sequence_find_key(&sequence_data_index, hash, key);
+	if (pos == light_sequence_end)
+		return;
+	struct sequence_data data, old_data;
+	data = light_sequence_get(&sequence_data_index, pos);
+	data.reserved = data.value;
+	if (light_sequence_replace(&sequence_data_index, hash,
+				   data, &old_data) == light_sequence_end)
+		unreachable();
+}
+
 int
 sequence_update(struct sequence *seq, int64_t value)
 {
@@ -184,8 +223,12 @@ sequence_update(struct sequence *seq, int64_t value)
 	struct sequence_data new_data, data;
 	new_data.id = key;
 	new_data.value = value;
+	new_data.reserved = value;
 	if (pos != light_sequence_end) {
 		data = light_sequence_get(&sequence_data_index, pos);
+		if ((seq->def->step > 0 && value < data.reserved) ||
+		    (seq->def->step < 0 && value > data.reserved))
+			new_data.reserved = data.reserved;
 		if ((seq->def->step > 0 && value > data.value) ||
 		    (seq->def->step < 0 && value < data.value)) {
 			if (light_sequence_replace(&sequence_data_index, hash,
@@ -212,6 +255,7 @@ sequence_next(struct sequence *seq, int64_t *result)
 	if (pos == light_sequence_end) {
 		new_data.id = key;
 		new_data.value = def->start;
+		new_data.reserved = def->start;
 		if (light_sequence_insert(&sequence_data_index, hash,
 					  new_data) == light_sequence_end)
 			return -1;
@@ -220,9 +264,16 @@ sequence_next(struct sequence *seq, int64_t *result)
 	}
 	old_data = light_sequence_get(&sequence_data_index, pos);
 	value = old_data.value;
+	/*
+	 * The values preallocated by sequence_reserve() are valid
+	 * only as long as the sequence keeps moving towards the last
+	 * of them. If it wraps or jumps to the limit, no values are
+	 * reserved anymore.
+	 */
+	int64_t reserved = old_data.reserved;
 	if (def->step > 0) {
 		if (value < def->min) {
-			value = def->min;
+			value = reserved = def->min;
 			goto done;
 		}
 		if (value >= 0 && def->step > INT64_MAX - value)
@@ -230,10 +281,12 @@ sequence_next(struct sequence *seq, int64_t *result)
 		value += def->step;
 		if (value > def->max)
 			goto overflow;
+		if (value > reserved)
+			reserved = value;
 	} else {
 		assert(def->step < 0);
 		if (value > def->max) {
-			value = def->max;
+			value = reserved = def->max;
 			goto done;
 		}
 		if (value < 0 && def->step < INT64_MIN - value)
@@ -241,11 +294,14 @@ sequence_next(struct sequence *seq, int64_t *result)
 		value += def->step;
 		if (value < def->min)
 			goto overflow;
+		if (value < reserved)
+			reserved = value;
 	}
 done:
 	assert(value >= def->min && value <= def->max);
 	new_data.id = key;
 	new_data.value = value;
+	new_data.reserved = reserved;
 	if (light_sequence_replace(&sequence_data_index, hash,
 				   new_data, &old_data) == light_sequence_end)
 		unreachable();
@@ -256,12 +312,52 @@ overflow:
 		diag_set(ClientError, ER_SEQUENCE_OVERFLOW, def->name);
 		return -1;
 	}
-	value = def->step > 0 ? def->min : def->max;
+	value = reserved = def->step > 0 ? def->min : def->max;
 	goto done;
 }
 
+bool
+sequence_reserve(struct sequence *seq, int64_t *reserved)
+{
+	struct sequence_def *def = seq->def;
+	uint32_t key = def->id;
+	uint32_t hash = sequence_hash(key);
+	uint32_t pos = light_sequence_find_key(&sequence_data_index, hash, key);
+	assert(pos != light_sequence_end);
+	struct sequence_data data, old_data;
+	data = light_sequence_get(&sequence_data_index, pos);
+	if (data.value != data.reserved)
+		return false;
+	if (def->cache > 1) {
+		/*
+		 * Reserve def->cache values following the current
+		 * one, but don't go beyond the limit. The sequence
+		 * value can't be outside [min, max] after
+		 * sequence_next(), so the subtraction can't overflow
+		 * if done in unsigned.
+		 */
+		uint64_t count;
+		if (def->step > 0) {
+			count = ((uint64_t)def->max - (uint64_t)data.value) /
+				(uint64_t)def->step;
+		} else {
+			count = ((uint64_t)data.value - (uint64_t)def->min) /
+				(0 - (uint64_t)def->step);
+		}
+		if (count > (uint64_t)def->cache)
+			count = def->cache;
+		data.reserved = (int64_t)((uint64_t)data.value +
+					  count * (uint64_t)def->step);
+		if (light_sequence_replace(&sequence_data_index, hash, data,
+					   &old_data) == light_sequence_end)
+			unreachable();
+	}
+	*reserved = data.reserved;
+	return true;
+}
+
 int
-access_check_sequence(struct sequence *seq)
+access_check_sequence_slow(struct sequence *seq)
 {
 	struct credentials *cr = effective_user();
 	/*
@@ -329,9 +425,9 @@ sequence_data_iterator_next(struct snapshot_iterator *base,
 	char *buf_end = iter->tuple;
 	buf_end = mp_encode_array(buf_end, 2);
 	buf_end = mp_encode_uint(buf_end, sd->id);
-	buf_end = (sd->value >= 0 ?
-		   mp_encode_uint(buf_end, sd->value) :
-		   mp_encode_int(buf_end, sd->value));
+	buf_end = (sd->reserved >= 0 ?
+		   mp_encode_uint(buf_end, sd->reserved) :
+		   mp_encode_int(buf_end, sd->reserved));
 	assert(buf_end <= iter->tuple + SEQUENCE_TUPLE_BUF_SIZE);
 	*data = iter->tuple;
 	*size = buf_end - iter->tuple;
@@ -37,6 +37,7 @@
 #include <stdint.h>
 
 #include "diag.h"
+#include "session.h"
 #include "user_def.h"
 
 #if defined(__cplusplus)
@@ -64,7 +65,11 @@ struct sequence_def {
 	int64_t max;
 	/** Initial sequence value. */
 	int64_t start;
-	/** Number of values to preallocate. Not implemented yet. */
+	/**
+	 * Number of values to preallocate. If it's greater than 1,
+	 * box_sequence_next() writes to _sequence_data only once per
+	 * this many values, at the cost of a gap after restart.
+	 */
 	int64_t cache;
 	/**
 	 * If this flag is set, the sequence will wrap
@@ -128,6 +133,23 @@ sequence_reset(struct sequence *seq);
 int
 sequence_set(struct sequence *seq, int64_t value);
 
+/**
+ * Set a sequence value written to _sequence_data. If it is
+ * the last value preallocated by sequence_reserve(), the sequence
+ * is left as is, because it's the write of the preallocated block.
+ *
+ * Return 0 on success, -1 on memory allocation failure.
+ */
+int
+sequence_set_reserved(struct sequence *seq, int64_t value);
+
+/**
+ * Forget the values preallocated by sequence_reserve(). Called
+ * if the write of the preallocated block is rolled back.
+ */
+void
+sequence_cancel_reserve(struct sequence *seq);
+
 /**
  * Update the sequence if the given value is newer than
  * the last generated value.
@@ -150,12 +172,41 @@ sequence_update(struct sequence *seq, int64_t value);
 int
 sequence_next(struct sequence *seq, int64_t *result);
 
+/**
+ * Check if the value returned by the last sequence_next() call
+ * must be written to _sequence_data. It must unless it belongs to
+ * the values preallocated earlier. If it does, preallocate the
+ * next sequence_def::cache values, return the value to be written
+ * in @a reserved and return true.
+ */
+bool
+sequence_reserve(struct sequence *seq, int64_t *reserved);
+
 /**
  * Check whether or not the current user can be granted
  * access to the sequence.
  */
 int
-access_check_sequence(struct sequence *seq);
+access_check_sequence_slow(struct sequence *seq);
+
+/**
+ * @copydoc access_check_sequence_slow()
+ *
+ * Takes a couple of loads when universal or object grants of the
+ * user cover the access, see access_check_space().
+ */
+static inline int
+access_check_sequence(struct sequence *seq)
+{
+	struct credentials *cr = effective_user();
+	user_access_t sequence_access = (PRIV_U | PRIV_W) &
+					~cr->universal_access;
+	if (sequence_access == 0 ||
+	    ((sequence_access & PRIV_U) == 0 &&
+	     (sequence_access & ~seq->access[cr->auth_token].effective) == 0))
+		return 0;
+	return access_check_sequence_slow(seq);
+}
 
 /**
  * Create an iterator over sequence data.
@@ -113,7 +113,8 @@ session_watcher_run_f(struct watcher *base)
 	const char *key = watcher_key(base, &key_len);
 	const char *data_end;
 	const char *data = watcher_data(base, &data_end);
-	watcher->cb(watcher->session, key, key_len, data, data_end);
+	watcher->cb(watcher->session, key, key_len, data, data_end,
+		    watcher_version(base));
 }
 
 void
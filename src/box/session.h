@@ -324,9 +324,14 @@ session_run_on_disconnect_triggers(struct session *session);
 int
 session_run_on_auth_triggers(const struct on_auth_trigger_ctx *result);
 
+/**
+ * Notification callback. The version identifies the data: callbacks
+ * invoked for the same key and version get the same data, see
+ * watcher_version().
+ */
 typedef void
 (*session_notify_f)(struct session *session, const char *key, size_t key_len,
-		    const char *data, const char *data_end);
+		    const char *data, const char *data_end, uint64_t version);
 
 /**
  * If there's no watcher registered for the specified key in the given session,
@@ -48,9 +48,10 @@
 #include "ck_constraint.h"
 #include "assoc.h"
 #include "constraint_id.h"
+#include "info/info.h"
 
 int
-access_check_space(struct space *space, user_access_t access)
+access_check_space_slow(struct space *space, user_access_t access)
 {
 	struct credentials *cr = effective_user();
 	/* Any space access also requires global USAGE privilege. */
@@ -520,6 +521,17 @@ out:
 	return rc;
 }
 
+void
+space_hot_keys_add_request(struct space *space, struct request *request)
+{
+	struct index *index = space_index(space, request->index_id);
+	if (likely(index == NULL || index->hot_keys == NULL))
+		return;
+	const char *key = request->key;
+	uint32_t part_count = mp_decode_array(&key);
+	index_hot_keys_add_key(index, key, part_count);
+}
+
 int
 space_execute_dml(struct space *space, struct txn *txn,
 		  struct request *request, struct tuple **result)
@@ -554,6 +566,12 @@ space_execute_dml(struct space *space, struct txn *txn,
 		if (space->vtab->execute_replace(space, txn,
 						 request, result) != 0)
 			return -1;
+		if (request->type == IPROTO_INSERT)
+			space->op_stat.insert++;
+		else
+			space->op_stat.replace++;
+		if (*result != NULL)
+			index_hot_keys_add_tuple(space->index[0], *result);
 		break;
 	case IPROTO_UPDATE:
 		if (space->vtab->execute_update(space, txn,
@@ -567,11 +585,13 @@ space_execute_dml(struct space *space, struct txn *txn,
 			 */
 			request_rebind_to_primary_key(request, space, *result);
 		}
+		space->op_stat.update++;
 		break;
 	case IPROTO_DELETE:
 		if (space->vtab->execute_delete(space, txn,
 						request, result) != 0)
 			return -1;
+		space->op_stat.del++;
 		if (*result != NULL && request->index_id != 0)
 			request_rebind_to_primary_key(request, space, *result);
 		break;
@@ -579,6 +599,7 @@ space_execute_dml(struct space *space, struct txn *txn,
 		*result = NULL;
 		if (space->vtab->execute_upsert(space, txn, request) != 0)
 			return -1;
+		space->op_stat.upsert++;
 		break;
 	default:
 		*result = NULL;
@@ -586,6 +607,35 @@ space_execute_dml(struct space *space, struct txn *txn,
 	return 0;
 }
 
+void
+space_stat(struct space *space, struct info_handler *h)
+{
+	size_t total_index_bsize = 0;
+	for (uint32_t i = 0; i < space->index_count; i++)
+		total_index_bsize += index_bsize(space->index[i]);
+	info_begin(h);
+	info_append_int(h, "bsize", space_bsize(space));
+	info_append_int(h, "index_bsize", total_index_bsize);
+	info_append_int(h, "insert", space->op_stat.insert);
+	info_append_int(h, "replace", space->op_stat.replace);
+	info_append_int(h, "update", space->op_stat.update);
+	info_append_int(h, "upsert", space->op_stat.upsert);
+	info_append_int(h, "delete", space->op_stat.del);
+	info_table_begin(h, "index");
+	for (uint32_t i = 0; i < space->index_count; i++) {
+		struct index *index = space->index[i];
+		info_table_begin(h, index->def->name);
+		info_append_int(h, "bsize", index_bsize(index));
+		info_append_int(h, "get", index->op_stat.get);
+		info_append_int(h, "select", index->op_stat.select);
+		info_append_int(h, "next", index->op_stat.next);
+		info_append_int(h, "write", index->op_stat.write);
+		info_table_end(h);
+	}
+	info_table_end(h);
+	info_end(h);
+}
+
 int
 space_add_ck_constraint(struct space *space, struct ck_constraint *ck)
 {
@@ -38,6 +38,7 @@
 #include "index.h"
 #include "error.h"
 #include "diag.h"
+#include "session.h"
 
 #if defined(__cplusplus)
 extern "C" {
@@ -53,6 +54,7 @@ struct tuple;
 struct tuple_format;
 struct ck_constraint;
 struct constraint_id;
+struct info_handler;
 
 struct space_vtab {
 	/** Free a space instance. */
@@ -152,6 +154,18 @@ struct space_vtab {
 	void (*invalidate)(struct space *space);
 };
 
+/**
+ * Counters of data manipulation requests executed on a space.
+ * Updated by the tx thread only, so they are plain integers.
+ */
+struct space_op_stat {
+	int64_t insert;
+	int64_t replace;
+	int64_t update;
+	int64_t upsert;
+	int64_t del;
+};
+
 struct space {
 	/** Virtual function table. */
 	const struct space_vtab *vtab;
@@ -243,6 +257,8 @@ struct space {
 	 * List of all tx stories in the space.
 	 */
 	struct rlist memtx_stories;
+	/** Request counters, see space_stat(). */
+	struct space_op_stat op_stat;
 };
 
 /** Initialize a base space instance. */
@@ -364,6 +380,18 @@ index_find_unique(struct space *space, uint32_t index_id)
 size_t
 space_bsize(struct space *space);
 
+/**
+ * Report the memory used by a space and its indexes and the
+ * operation counters of the space and its indexes:
+ *
+ *   bsize, index_bsize, insert, replace, update, upsert, delete,
+ *   index = {<name> = {bsize, get, select, next, write}, ...}
+ *
+ * The counters are kept across ALTER of the space.
+ */
+void
+space_stat(struct space *space, struct info_handler *h);
+
 /** Get definition of the n-th index of the space. */
 struct index_def *
 space_index_def(struct space *space, int n);
@@ -385,7 +413,39 @@ index_name_by_id(struct space *space, uint32_t id);
  * the requested access to the space.
  */
 int
-access_check_space(struct space *space, user_access_t access);
+access_check_space_slow(struct space *space, user_access_t access);
+
+/**
+ * @copydoc access_check_space_slow()
+ *
+ * Universal and object grants of the user are already summed up
+ * in the credentials and in the space, so when they cover the
+ * requested access, which is the usual case, the check takes a
+ * couple of loads. The rest, including entity grants and owner
+ * rights, is checked out of line.
+ */
+static inline int
+access_check_space(struct space *space, user_access_t access)
+{
+	struct credentials *cr = effective_user();
+	/* Any space access also requires global USAGE privilege. */
+	user_access_t space_access = (access | PRIV_U) &
+				     ~cr->universal_access;
+	if (space_access == 0 ||
+	    ((space_access & PRIV_U) == 0 &&
+	     (space_access & ~space->access[cr->auth_token].effective) == 0))
+		return 0;
+	return access_check_space_slow(space, access);
+}
+
+/**
+ * Account the key of an update or delete request in the hot key
+ * tracker of the index the request is executed on. Called by the
+ * engines that don't look the key up with index_get(), which does
+ * the accounting itself.
+ */
+void
+space_hot_keys_add_request(struct space *space, struct request *request);
 
 /**
  * Execute a DML request on the given space.
@@ -73,6 +73,11 @@ struct space_opts {
 	 * until replicated to a quorum of replicas.
 	 */
 	bool is_sync;
+	/**
+	 * Allow iproto threads to execute selects from the space
+	 * against a read view instead of doing it in tx.
+	 */
+	bool read_view_enabled;
 	/** SQL statement that produced this space. */
 	char *sql;
 };
@@ -368,7 +368,9 @@ sqlSrcListDelete(struct sql *db, struct SrcList *list);
  * trailing unused bytes that extends the last 'slots' array.
  * The amount of reserved memory should correspond to the problem
  * to be solved and is usually equal to the greatest number of
- * fields in the tuple.
+ * fields in the tuple. The structure and the reserved memory must
+ * be zeroed before the first use, so that a re-initialization
+ * only has to clear the slots used for the previous tuple.
  *
  * +-------------------------+
  * |  struct vdbe_field_ref  |
@@ -393,6 +395,8 @@ struct vdbe_field_ref {
 	 * extra tuple decoding as possible.
 	 */
 	uint64_t slot_bitmask;
+	/** The greatest initialized slot. Slots after it are zero. */
+	uint32_t rightmost_slot;
 	/**
 	 * Array of offsets of tuple fields.
 	 * Only values <= rightmost_slot are valid.
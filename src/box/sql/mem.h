@@ -593,6 +593,36 @@ int
 mem_cmp(const struct Mem *a, const struct Mem *b, int *result,
 	const struct coll *coll);
 
+/**
+ * Compare two MEMs that are both integers or both doubles the same
+ * way mem_cmp() does, but without a function call and type class
+ * dispatch. Return false if the MEMs have to be compared with
+ * mem_cmp().
+ */
+static inline bool
+mem_cmp_num_fast(const struct Mem *a, const struct Mem *b, int *result)
+{
+	if (((a->flags | b->flags) & MEM_Any) != 0)
+		return false;
+	switch (a->type | b->type) {
+	case MEM_TYPE_INT:
+		*result = (a->u.i > b->u.i) - (a->u.i < b->u.i);
+		return true;
+	case MEM_TYPE_UINT:
+		*result = (a->u.u > b->u.u) - (a->u.u < b->u.u);
+		return true;
+	case MEM_TYPE_INT | MEM_TYPE_UINT:
+		/* Negative integers are always less than unsigned ones. */
+		*result = a->type == MEM_TYPE_INT ? -1 : 1;
+		return true;
+	case MEM_TYPE_DOUBLE:
+		*result = (a->u.r > b->u.r) - (a->u.r < b->u.r);
+		return true;
+	default:
+		return false;
+	}
+}
+
 /**
  * Convert the given MEM to INTEGER. This function and the function below define
  * the rules that are used to convert values of all other types to INTEGER. In
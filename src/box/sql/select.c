@@ -5726,6 +5726,80 @@ vdbe_code_raise_on_multiple_rows(struct Parse *parser, int limit_reg, int end_ma
 	sqlReleaseTempReg(parser, r1);
 }
 
+/**
+ * Check if the top-level SELECT reads all columns of a single
+ * space and is filtered only by equality of a column to a
+ * variable, and the column is the only part of a unique index.
+ * Such a statement returns the tuple found by the index, so
+ * mark the VDBE to execute it without interpretation of the
+ * program, see sql_stmt_point_lookup().
+ *
+ * The program is still generated: it is used if the bound value
+ * has to be converted first or the schema has changed.
+ */
+static void
+select_detect_point_lookup(struct Parse *parser, struct Select *select)
+{
+	if (parser->explain || parser->pToplevel != NULL)
+		return;
+	if (select->pPrior != NULL || select->pNext != NULL ||
+	    select->pGroupBy != NULL || select->pHaving != NULL ||
+	    select->pOrderBy != NULL || select->pLimit != NULL ||
+	    select->pOffset != NULL ||
+	    (select->selFlags & (SF_Distinct | SF_Aggregate)) != 0)
+		return;
+	struct SrcList *src = select->pSrc;
+	if (src->nSrc != 1)
+		return;
+	struct SrcList_item *item = &src->a[0];
+	struct space *space = item->space;
+	if (item->pSelect != NULL || space == NULL || space->def->id == 0 ||
+	    space->def->opts.is_view)
+		return;
+	struct ExprList *list = select->pEList;
+	if (list->nExpr != (int)space->def->field_count)
+		return;
+	for (int i = 0; i < list->nExpr; i++) {
+		struct Expr *expr = list->a[i].pExpr;
+		if (expr->op != TK_COLUMN_REF || expr->iTable != item->iCursor ||
+		    expr->iColumn != i)
+			return;
+	}
+	struct Expr *where = select->pWhere;
+	if (where == NULL || where->op != TK_EQ)
+		return;
+	struct Expr *column = where->pLeft;
+	struct Expr *var = where->pRight;
+	if (column->op == TK_VARIABLE)
+		SWAP(column, var);
+	if (column->op != TK_COLUMN_REF || column->iTable != item->iCursor ||
+	    var->op != TK_VARIABLE)
+		return;
+	uint32_t fieldno = column->iColumn;
+	struct field_def *field = &space->def->fields[fieldno];
+	if (field->coll_id != COLL_NONE)
+		return;
+	if (field->type != FIELD_TYPE_UNSIGNED &&
+	    field->type != FIELD_TYPE_INTEGER &&
+	    field->type != FIELD_TYPE_STRING)
+		return;
+	for (uint32_t i = 0; i < space->index_count; i++) {
+		struct index_def *def = space->index[i]->def;
+		struct key_def *key_def = def->key_def;
+		struct key_part *part = &key_def->parts[0];
+		if (!def->opts.is_unique || key_def->part_count != 1 ||
+		    key_def->for_func_index || key_def->is_multikey ||
+		    part->fieldno != fieldno || part->path != NULL ||
+		    part->coll != NULL || part->type != field->type)
+			continue;
+		struct Vdbe *v = sqlGetVdbe(parser);
+		v->point_lookup_space = space;
+		v->point_lookup_index_id = def->iid;
+		v->point_lookup_var = var->iColumn;
+		return;
+	}
+}
+
 /*
  * Generate code for the SELECT statement given in the p argument.
  *
@@ -5800,6 +5874,8 @@ sqlSelect(Parse * pParse,		/* The parser context */
 	if (pParse->is_aborted || db->mallocFailed) {
 		goto select_end;
 	}
+	if (pDest->eDest == SRT_Output)
+		select_detect_point_lookup(pParse, p);
 	assert(p->pEList != 0);
 	isAgg = (p->selFlags & SF_Aggregate) != 0;
 #ifdef SQL_DEBUG
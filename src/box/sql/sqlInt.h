@@ -390,6 +390,25 @@ sql_step(sql_stmt *);
 int
 sql_column_bytes16(sql_stmt *, int iCol);
 
+/**
+ * Execute a point lookup statement (see Vdbe::point_lookup_space)
+ * without the VDBE: encode the bound key, get the tuple from the
+ * index and append it to the port.
+ *
+ * @param stmt Prepared statement with bound variables.
+ * @param region Region to allocate temporary objects.
+ * @param port Port to store the result row.
+ *
+ * @retval  0 Success.
+ * @retval  1 The statement must be executed by the VDBE, because
+ *            it isn't a point lookup or the bound value doesn't
+ *            fit the index as is.
+ * @retval -1 Error.
+ */
+int
+sql_stmt_point_lookup(struct sql_stmt *stmt, struct region *region,
+		      struct port *port);
+
 char *
 sql_stmt_result_to_msgpack(struct sql_stmt *stmt, uint32_t *tuple_size,
 			   struct region *region);
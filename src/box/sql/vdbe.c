@@ -241,6 +241,8 @@ allocateCursor(
 	if (sqlVdbeMemClearAndResize(pMem, nByte) == 0) {
 		p->apCsr[iCur] = pCx = (VdbeCursor*)pMem->z;
 		memset(pCx, 0, offsetof(VdbeCursor,uc));
+		memset(&pCx->field_ref, 0, sizeof(pCx->field_ref) +
+		       sizeof(pCx->field_ref.slots[0]) * nField);
 		pCx->eCurType = eCurType;
 		pCx->nField = nField;
 		if (eCurType==CURTYPE_TARANTOOL) {
@@ -335,6 +337,47 @@ vdbe_field_ref_closest_slotno(struct vdbe_field_ref *field_ref,
 	return 64 - bit_clz_u64(le_mask) - 1;
 }
 
+/** Remember the offset of a field in field_ref's slots. */
+static inline void
+vdbe_field_ref_set_slot(struct vdbe_field_ref *field_ref, uint32_t fieldno,
+			const char *field)
+{
+	field_ref->slots[fieldno] = (uint32_t)(field - field_ref->data);
+	bitmask64_set_bit(&field_ref->slot_bitmask, fieldno);
+	if (fieldno > field_ref->rightmost_slot)
+		field_ref->rightmost_slot = fieldno;
+}
+
+/**
+ * Find the closest indexed field between the initialized slot
+ * prev and a given fieldno, which can be located with the tuple's
+ * field_map without decoding the fields before it.
+ * @param field_ref The vdbe_field_ref instance to use.
+ * @param prev Number of an initialized slot less than fieldno.
+ * @param fieldno Number of a field to get.
+ * @retval Number of the found field with an initialized slot or
+ *         prev if there's no such field.
+ */
+static inline uint32_t
+vdbe_field_ref_closest_indexed(struct vdbe_field_ref *field_ref,
+			       uint32_t prev, uint32_t fieldno)
+{
+	if (field_ref->tuple == NULL)
+		return prev;
+	struct tuple_format *format = tuple_format(field_ref->tuple);
+	for (uint32_t i = MIN(fieldno, format->index_field_count);
+	     i > prev + 1; i--) {
+		const struct tuple_field *field =
+			tuple_format_field(format, i - 1);
+		if (field->offset_slot == TUPLE_OFFSET_SLOT_NIL)
+			continue;
+		vdbe_field_ref_set_slot(field_ref, i - 1,
+					tuple_field(field_ref->tuple, i - 1));
+		return i - 1;
+	}
+	return prev;
+}
+
 /**
  * Get a tuple's field using field_ref's slot_bitmask, and tuple's
  * field_map when possible. Required field must be present in
@@ -364,24 +407,25 @@ vdbe_field_ref_fetch_data(struct vdbe_field_ref *field_ref, uint32_t fieldno)
 			 * Try to find the biggest initialized
 			 * slot.
 			 */
-			for (uint32_t it = fieldno - 1; it > prev; it--) {
+			uint32_t it = MIN(fieldno - 1,
+					  field_ref->rightmost_slot);
+			for (; it > prev; it--) {
 				if (field_ref->slots[it] == 0)
 					continue;
 				prev = it;
 				break;
 			}
 		}
+		prev = vdbe_field_ref_closest_indexed(field_ref, prev,
+						      fieldno);
 		field_begin = field_ref->data + field_ref->slots[prev];
 		for (prev++; prev < fieldno; prev++) {
 			mp_next(&field_begin);
-			field_ref->slots[prev] =
-				(uint32_t)(field_begin - field_ref->data);
-			bitmask64_set_bit(&field_ref->slot_bitmask, prev);
+			vdbe_field_ref_set_slot(field_ref, prev, field_begin);
 		}
 		mp_next(&field_begin);
 	}
-	field_ref->slots[fieldno] = (uint32_t)(field_begin - field_ref->data);
-	bitmask64_set_bit(&field_ref->slot_bitmask, fieldno);
+	vdbe_field_ref_set_slot(field_ref, fieldno, field_begin);
 	return field_begin;
 }
 
@@ -1477,7 +1521,8 @@ case OP_Ne: {             /* same as TK_NE, jump, in1, in3 */
 		break;
 	}
 	int cmp_res;
-	if (mem_cmp(pIn3, pIn1, &cmp_res, pOp->p4.pColl) != 0)
+	if (!mem_cmp_num_fast(pIn3, pIn1, &cmp_res) &&
+	    mem_cmp(pIn3, pIn1, &cmp_res, pOp->p4.pColl) != 0)
 		goto abort_due_to_error;
 	bool result = pOp->opcode == OP_Eq ? cmp_res == 0 : cmp_res != 0;
 	if ((pOp->p5 & SQL_STOREP2) != 0) {
@@ -1539,7 +1584,8 @@ case OP_Ge: {             /* same as TK_GE, jump, in1, in3 */
 		break;
 	}
 	int cmp_res;
-	if (mem_cmp(pIn3, pIn1, &cmp_res, pOp->p4.pColl) != 0)
+	if (!mem_cmp_num_fast(pIn3, pIn1, &cmp_res) &&
+	    mem_cmp(pIn3, pIn1, &cmp_res, pOp->p4.pColl) != 0)
 		goto abort_due_to_error;
 
 	bool result;
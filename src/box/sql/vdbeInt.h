@@ -301,6 +301,17 @@ struct Vdbe {
 	uint32_t sql_flags;
 	/* Anonymous savepoint for aborts only */
 	struct txn_savepoint *anonymous_savepoint;
+	/**
+	 * Set if the statement is a SELECT of all columns of a
+	 * space by a value of the only part of its unique index.
+	 * Such statement is executed without running the program,
+	 * see sql_stmt_point_lookup().
+	 */
+	struct space *point_lookup_space;
+	/** Id of the index used by the point lookup. */
+	uint32_t point_lookup_index_id;
+	/** Number of the variable holding the key, starting from 1. */
+	int point_lookup_var;
 };
 
 /*
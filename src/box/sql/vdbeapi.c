@@ -37,7 +37,13 @@
 #include "sqlInt.h"
 #include "mem.h"
 #include "vdbeInt.h"
+#include "box/index.h"
+#include "box/port.h"
+#include "box/schema.h"
 #include "box/session.h"
+#include "box/space.h"
+#include "box/tuple.h"
+#include "box/txn.h"
 
 /*
  * Invoke the profile callback.  This routine is only called if we already
@@ -207,6 +213,106 @@ sql_data_count(sql_stmt * pStmt)
 	return pVm->nResColumn;
 }
 
+/**
+ * Append the tuple to the port as a row of all columns of the
+ * space, i.e. cut the fields not in the format or add NULLs for
+ * the missing ones.
+ */
+static int
+point_lookup_add_row(struct space *space, struct tuple *tuple,
+		     struct region *region, struct port *port)
+{
+	uint32_t column_count = space->def->field_count;
+	const char *data = tuple_data(tuple);
+	uint32_t field_count = mp_decode_array(&data);
+	if (field_count == column_count)
+		return port_c_add_tuple(port, tuple);
+	const char *data_end = data;
+	for (uint32_t i = 0; i < MIN(field_count, column_count); i++)
+		mp_next(&data_end);
+	uint32_t nil_count = column_count > field_count ?
+			     column_count - field_count : 0;
+	size_t size = mp_sizeof_array(column_count) + (data_end - data) +
+		      nil_count * mp_sizeof_nil();
+	size_t svp = region_used(region);
+	char *row = region_alloc(region, size);
+	if (row == NULL) {
+		diag_set(OutOfMemory, size, "region_alloc", "row");
+		return -1;
+	}
+	char *pos = mp_encode_array(row, column_count);
+	memcpy(pos, data, data_end - data);
+	pos += data_end - data;
+	for (uint32_t i = 0; i < nil_count; i++)
+		pos = mp_encode_nil(pos);
+	assert(pos == row + size);
+	struct tuple *row_tuple = tuple_new(box_tuple_format_default(),
+					    row, pos);
+	region_truncate(region, svp);
+	if (row_tuple == NULL)
+		return -1;
+	return port_c_add_tuple(port, row_tuple);
+}
+
+int
+sql_stmt_point_lookup(struct sql_stmt *stmt, struct region *region,
+		      struct port *port)
+{
+	struct Vdbe *v = (struct Vdbe *)stmt;
+	struct space *space = v->point_lookup_space;
+	if (space == NULL || v->schema_ver != box_schema_version())
+		return 1;
+	assert(v->point_lookup_var > 0 && v->point_lookup_var <= v->nVar);
+	const struct Mem *var = &v->aVar[v->point_lookup_var - 1];
+	struct index *index = space_index(space, v->point_lookup_index_id);
+	assert(index != NULL);
+	/*
+	 * Values of other types are either converted or
+	 * rejected by the VDBE, let it handle them.
+	 */
+	switch (index->def->key_def->parts[0].type) {
+	case FIELD_TYPE_UNSIGNED:
+		if (!mem_is_uint(var))
+			return 1;
+		break;
+	case FIELD_TYPE_INTEGER:
+		if (!mem_is_int(var))
+			return 1;
+		break;
+	case FIELD_TYPE_STRING:
+		if (!mem_is_str(var))
+			return 1;
+		break;
+	default:
+		unreachable();
+	}
+	if (access_check_space(space, PRIV_R) != 0)
+		return -1;
+	size_t svp = region_used(region);
+	uint32_t size;
+	const char *key = mem_encode_array(var, 1, &size, region);
+	if (key == NULL)
+		return -1;
+	mp_decode_array(&key);
+	struct txn *txn;
+	struct txn_ro_savepoint txn_svp;
+	struct tuple *tuple;
+	if (txn_begin_ro_stmt(space, &txn, &txn_svp) != 0)
+		goto error;
+	if (index_get(index, key, 1, &tuple) != 0) {
+		txn_rollback_stmt(txn);
+		goto error;
+	}
+	txn_commit_ro_stmt(txn, &txn_svp);
+	region_truncate(region, svp);
+	if (tuple == NULL)
+		return 0;
+	return point_lookup_add_row(space, tuple, region, port);
+error:
+	region_truncate(region, svp);
+	return -1;
+}
+
 char *
 sql_stmt_result_to_msgpack(struct sql_stmt *stmt, uint32_t *tuple_size,
 			   struct region *region)
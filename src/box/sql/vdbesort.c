@@ -317,6 +317,11 @@ struct VdbeSorter {
 	int iMemory;		/* Offset of free space in list.aMemory */
 	int nMemory;		/* Size of list.aMemory allocation in bytes */
 	u8 bUsePMA;		/* True if one or more PMAs created */
+	/**
+	 * Types of the first key field of all written records,
+	 * a mask of SORTER_TYPE_* flags. Used to choose a
+	 * comparator that doesn't unpack records.
+	 */
 	u8 typeMask;
 	SortSubtask aTask;	/* A single subtask */
 };
@@ -787,6 +792,77 @@ vdbeSorterCompare(struct SortSubtask *task, bool *key2_cached,
 	return sqlVdbeRecordCompareMsgpack(key1, r2);
 }
 
+/**
+ * Decode an integer sorter record field as a sign and a module.
+ * The MessagePack encoder only uses MP_INT for negative values,
+ * but don't rely on it.
+ */
+static inline uint64_t
+vdbe_sorter_decode_int(const char **field, bool *is_neg)
+{
+	if (mp_typeof(**field) == MP_UINT) {
+		*is_neg = false;
+		return mp_decode_uint(field);
+	}
+	int64_t value = mp_decode_int(field);
+	*is_neg = value < 0;
+	return *is_neg ? -(uint64_t)value : (uint64_t)value;
+}
+
+/**
+ * Compare two sorter records, the first fields of which are
+ * integers, by the first field without unpacking the records.
+ * If the fields are equal, compare the records with
+ * vdbeSorterCompare().
+ */
+static int
+vdbe_sorter_compare_int(struct SortSubtask *task, bool *key2_cached,
+			const void *key1, const void *key2)
+{
+	const char *field1 = key1, *field2 = key2;
+	mp_decode_array(&field1);
+	mp_decode_array(&field2);
+	bool is_neg1, is_neg2;
+	uint64_t value1 = vdbe_sorter_decode_int(&field1, &is_neg1);
+	uint64_t value2 = vdbe_sorter_decode_int(&field2, &is_neg2);
+	int rc;
+	if (is_neg1 != is_neg2)
+		rc = is_neg1 ? -1 : 1;
+	else if (value1 == value2)
+		return vdbeSorterCompare(task, key2_cached, key1, key2);
+	else
+		rc = (value1 < value2) != is_neg1 ? -1 : 1;
+	if (task->pSorter->key_def->parts[0].sort_order != SORT_ORDER_ASC)
+		return -rc;
+	return rc;
+}
+
+/**
+ * Compare two sorter records, the first fields of which are
+ * strings without a collation, by the first field without
+ * unpacking the records. If the fields are equal, compare the
+ * records with vdbeSorterCompare().
+ */
+static int
+vdbe_sorter_compare_text(struct SortSubtask *task, bool *key2_cached,
+			 const void *key1, const void *key2)
+{
+	const char *field1 = key1, *field2 = key2;
+	mp_decode_array(&field1);
+	mp_decode_array(&field2);
+	uint32_t len1, len2;
+	const char *str1 = mp_decode_str(&field1, &len1);
+	const char *str2 = mp_decode_str(&field2, &len2);
+	int rc = memcmp(str1, str2, MIN(len1, len2));
+	if (rc == 0 && len1 == len2)
+		return vdbeSorterCompare(task, key2_cached, key1, key2);
+	if (rc == 0)
+		rc = len1 < len2 ? -1 : 1;
+	if (task->pSorter->key_def->parts[0].sort_order != SORT_ORDER_ASC)
+		return -rc;
+	return rc;
+}
+
 /*
  * Initialize the temporary index cursor just opened as a sorter cursor.
  *
@@ -843,9 +919,9 @@ sqlVdbeSorterInit(sql * db,	/* Database connection (for malloc()) */
 	if (!pSorter->list.aMemory)
 		rc = -1;
 
-	if (pCsr->key_def->part_count < 13 &&
-	    pCsr->key_def->parts[0].coll == NULL)
-		pSorter->typeMask = SORTER_TYPE_INTEGER | SORTER_TYPE_TEXT;
+	pSorter->typeMask = SORTER_TYPE_INTEGER;
+	if (pCsr->key_def->parts[0].coll == NULL)
+		pSorter->typeMask |= SORTER_TYPE_TEXT;
 
 	return rc;
 }
@@ -1107,7 +1183,10 @@ vdbeSorterMerge(SortSubtask * pTask,	/* Calling thread context */
 static SorterCompare
 vdbeSorterGetCompare(VdbeSorter * p)
 {
-	(void)p;
+	if (p->typeMask == SORTER_TYPE_INTEGER)
+		return vdbe_sorter_compare_int;
+	if (p->typeMask == SORTER_TYPE_TEXT)
+		return vdbe_sorter_compare_text;
 	return vdbeSorterCompare;
 }
 
@@ -1448,17 +1527,25 @@ sqlVdbeSorterWrite(const VdbeCursor * pCsr,	/* Sorter cursor */
 	int bFlush;		/* True to flush contents of memory to PMA */
 	int nReq;		/* Bytes of memory required */
 	int nPMA;		/* Bytes of PMA space required */
-	int t;			/* serial type of first record field */
 
 	assert(pCsr->eCurType == CURTYPE_SORTER);
 	pSorter = pCsr->uc.pSorter;
-	getVarint32((const u8 *)&pVal->z[1], t);
-	if (t > 0 && t < 10 && t != 7) {
-		pSorter->typeMask &= SORTER_TYPE_INTEGER;
-	} else if (t > 10 && (t & 0x01)) {
-		pSorter->typeMask &= SORTER_TYPE_TEXT;
-	} else {
+	const char *field = pVal->z;
+	if (mp_decode_array(&field) == 0) {
 		pSorter->typeMask = 0;
+	} else {
+		switch (mp_typeof(*field)) {
+		case MP_UINT:
+		case MP_INT:
+			pSorter->typeMask &= SORTER_TYPE_INTEGER;
+			break;
+		case MP_STR:
+			pSorter->typeMask &= SORTER_TYPE_TEXT;
+			break;
+		default:
+			pSorter->typeMask = 0;
+			break;
+		}
 	}
 
 	assert(pSorter);
@@ -120,9 +120,16 @@ static void
 sql_stmt_cache_gc(void)
 {
 	struct stmt_cache_entry *entry, *next;
-	rlist_foreach_entry_safe(entry, &sql_stmt_cache.gc_queue, link, next)
+	rlist_foreach_entry_safe(entry, &sql_stmt_cache.gc_queue, link, next) {
+		/*
+		 * An unreferenced statement may still be executed
+		 * by sql_prepare_and_execute(), which reuses cached
+		 * statements. Delete it on the next cycle.
+		 */
+		if (sql_stmt_busy(entry->stmt))
+			continue;
 		sql_stmt_cache_delete(entry);
-	assert(rlist_empty(&sql_stmt_cache.gc_queue));
+	}
 }
 
 /**
@@ -32,6 +32,17 @@
 
 #include <small/quota.h>
 
+#if defined(__APPLE__)
+#include <malloc/malloc.h>
+#define sys_usable_size(ptr) malloc_size(ptr)
+#elif defined(__FreeBSD__)
+#include <malloc_np.h>
+#define sys_usable_size(ptr) malloc_usable_size(ptr)
+#else
+#include <malloc.h>
+#define sys_usable_size(ptr) malloc_usable_size(ptr)
+#endif
+
 struct container {
 	struct rlist rlist;
 	size_t bytes;
@@ -41,6 +52,8 @@ void
 sys_alloc_create(struct sys_alloc *alloc, struct quota *quota)
 {
 	alloc->used_bytes = 0;
+	alloc->quota_bytes = 0;
+	alloc->total_bytes = 0;
 	alloc->quota = quota;
 	rlist_create(&alloc->allocations);
 #ifndef _NDEBUG
@@ -56,6 +69,50 @@ sys_alloc_destroy(struct sys_alloc *alloc)
 	rlist_foreach_entry_safe(item, &alloc->allocations, rlist, tmp)
 		sysfree(alloc, ((void *)item) + sizeof(struct container), item->bytes);
 	assert(alloc->used_bytes == 0);
+	assert(alloc->total_bytes == 0);
+	if (alloc->quota_bytes > 0)
+		quota_release(alloc->quota, alloc->quota_bytes);
+	alloc->quota_bytes = 0;
+}
+
+/**
+ * Take quota for @a bytes more bytes if the quota taken so far is
+ * not enough. The quota is taken in batches, but near the limit
+ * only as much as needed is taken.
+ */
+static int
+sys_alloc_use_quota(struct sys_alloc *alloc, size_t bytes)
+{
+	if (alloc->used_bytes + bytes <= alloc->quota_bytes)
+		return 0;
+	size_t needed = alloc->used_bytes + bytes - alloc->quota_bytes;
+	size_t size = small_align(needed, SYS_ALLOC_QUOTA_BATCH);
+	if (quota_use(alloc->quota, size) < 0) {
+		size = small_align(needed, QUOTA_UNIT_SIZE);
+		if (quota_use(alloc->quota, size) < 0)
+			return -1;
+	}
+	alloc->quota_bytes += size;
+	return 0;
+}
+
+/**
+ * Give the quota back to the source if the allocator holds more
+ * than 2 * SYS_ALLOC_QUOTA_BATCH bytes of it unused. The batch is
+ * kept to avoid taking and releasing the quota on every allocation
+ * and free of a workload that stays at one level of memory usage.
+ */
+static void
+sys_alloc_release_quota(struct sys_alloc *alloc)
+{
+	assert(alloc->quota_bytes >= alloc->used_bytes);
+	size_t unused = alloc->quota_bytes - alloc->used_bytes;
+	if (unused <= 2 * SYS_ALLOC_QUOTA_BATCH)
+		return;
+	size_t size = (unused - SYS_ALLOC_QUOTA_BATCH) /
+		      QUOTA_UNIT_SIZE * QUOTA_UNIT_SIZE;
+	quota_release(alloc->quota, size);
+	alloc->quota_bytes -= size;
 }
 
 void *
@@ -67,25 +124,14 @@ sysalloc(struct sys_alloc *alloc, size_t bytes)
 		return NULL;
 	/*
 	 * The limit on the amount of memory available to allocator
-	 * is stored in struct quota. We request from the quota at least
-	 * QUOTA_UNIT_SIZE bytes. Divide the requested bytes into two parts:
-	 * integer number of blocks by QUOTA_UNIT_SIZE bytes and remaining
-	 * bytes count.
+	 * is stored in struct quota.
 	 */
-	size_t remaining = bytes % QUOTA_UNIT_SIZE;
-	size_t units = bytes / QUOTA_UNIT_SIZE;
-	/*
-	 * Check that we need one more quota block for remaining bytes
-	 */
-	if (small_align(alloc->used_bytes, QUOTA_UNIT_SIZE) <
-	    small_align(alloc->used_bytes + remaining, QUOTA_UNIT_SIZE))
-			units++;
-	if (units > 0 &&
-	    quota_use(alloc->quota, units * QUOTA_UNIT_SIZE) < 0) {
+	if (sys_alloc_use_quota(alloc, bytes) != 0) {
 		free(ptr);
 		return NULL;
 	}
 	alloc->used_bytes += bytes;
+	alloc->total_bytes += sys_usable_size(ptr);
 	((struct container *)ptr)->bytes = bytes;
 	rlist_add_entry(&alloc->allocations, (struct container *)ptr, rlist);
 	return ptr + sizeof(struct container);
@@ -96,18 +142,9 @@ sysfree(struct sys_alloc *alloc, void *ptr, size_t bytes)
 {
 	assert(alloc->thread_id == pthread_self());
 	ptr -= sizeof(struct container);
-	size_t remaining = bytes % QUOTA_UNIT_SIZE;
-	size_t units = bytes / QUOTA_UNIT_SIZE;
-	/*
-	 * Check that we can free one more quota block when we
-	 * released remaining bytes
-	 */
-	if (small_align(alloc->used_bytes, QUOTA_UNIT_SIZE) >
-	    small_align(alloc->used_bytes - remaining, QUOTA_UNIT_SIZE))
-		units++;
 	alloc->used_bytes -= bytes;
-	if (units > 0)
-		quota_release(alloc->quota, units * QUOTA_UNIT_SIZE);
+	alloc->total_bytes -= sys_usable_size(ptr);
+	sys_alloc_release_quota(alloc);
 	rlist_del_entry((struct container *)ptr, rlist);
 	free(ptr);
 }
@@ -30,6 +30,7 @@
  * SUCH DAMAGE.
  */
 #include <small/small.h>
+#include <small/quota.h>
 
 #include <pthread.h>
 
@@ -37,13 +38,33 @@
 extern "C" {
 #endif /* defined(__cplusplus) */
 
+enum {
+	/**
+	 * Quota is taken from the source in batches of this size, so
+	 * that most allocations and frees only update the counters of
+	 * the allocator and don't touch the shared quota.
+	 */
+	SYS_ALLOC_QUOTA_BATCH = 64 * QUOTA_UNIT_SIZE,
+};
+
 struct sys_stats {
+	/** Bytes requested by allocations. */
 	size_t used;
+	/** Bytes taken from malloc, including its overhead. */
+	size_t total;
 };
 
 struct sys_alloc {
 	/** Allocated bytes */
 	uint64_t used_bytes;
+	/**
+	 * Bytes taken from the quota, a multiple of QUOTA_UNIT_SIZE.
+	 * Not less than used_bytes and not greater than used_bytes
+	 * plus 2 * SYS_ALLOC_QUOTA_BATCH.
+	 */
+	uint64_t quota_bytes;
+	/** Bytes taken from malloc, including its overhead. */
+	uint64_t total_bytes;
 	/** The source of allocations */
 	struct quota *quota;
 	/**
@@ -64,6 +85,7 @@ static inline void
 sys_stats(struct sys_alloc *alloc, struct sys_stats *totals)
 {
 	totals->used = alloc->used_bytes;
+	totals->total = alloc->total_bytes;
 }
 
 void
@@ -193,10 +193,15 @@ static const struct index_vtab sysview_index_vtab = {
 	/* .random = */ generic_index_random,
 	/* .count = */ generic_index_count,
 	/* .get = */ sysview_index_get,
+	/* .get_many = */ generic_index_get_many,
 	/* .replace = */ generic_index_replace,
 	/* .create_iterator = */ sysview_index_create_iterator,
+	/* .create_iterator_with_offset = */
+		generic_index_create_iterator_with_offset,
 	/* .create_snapshot_iterator = */
 		generic_index_create_snapshot_iterator,
+	/* .create_read_view_iterator = */
+		generic_index_create_read_view_iterator,
 	/* .stat = */ generic_index_stat,
 	/* .compact = */ generic_index_compact,
 	/* .reset_stat = */ generic_index_reset_stat,
@@ -475,13 +475,59 @@ tuple_go_to_path(const char **data, const char *path, uint32_t path_len,
 	return rc != 0 ? -1 : 0;
 }
 
-const char *
-tuple_field_raw_by_full_path(struct tuple_format *format, const char *tuple,
-			     const uint32_t *field_map, const char *path,
-			     uint32_t path_len, uint32_t path_hash)
-{
-	assert(path_len > 0);
+enum {
+	/** Number of entries in the JSON path cache, a power of 2. */
+	TUPLE_PATH_CACHE_SIZE = 256,
+	/** Max length of a path that can be stored in the cache. */
+	TUPLE_PATH_CACHE_PATH_MAX = 48,
+};
+
+/**
+ * A full JSON path resolved against a tuple format, see
+ * tuple_field_raw_by_full_path().
+ */
+struct tuple_path_cache_entry {
+	/** Epoch of the format, 0 if the entry is unused. */
+	uint64_t format_epoch;
+	/** Version of the format dictionary. */
+	uint32_t dict_version;
+	/** Number of the root field. */
 	uint32_t fieldno;
+	/**
+	 * Offset of the path relative to the root field in the
+	 * full path, or UINT32_MAX if the full path is the name
+	 * of the root field.
+	 */
+	uint32_t rel_offset;
+	/**
+	 * Offset slot of the field if it's indexed, otherwise
+	 * TUPLE_OFFSET_SLOT_NIL.
+	 */
+	int32_t offset_slot;
+	uint32_t path_len;
+	char path[TUPLE_PATH_CACHE_PATH_MAX];
+};
+
+/**
+ * Cache of JSON paths used to access tuple fields from Lua and
+ * the module API. Direct-mapped by the path hash: a new path
+ * evicts the one that was stored in its slot.
+ */
+static __thread struct tuple_path_cache_entry
+tuple_path_cache[TUPLE_PATH_CACHE_SIZE];
+
+/**
+ * Find the root field number of a full JSON path and the offset
+ * of the rest of the path. If the full path is a field name,
+ * @a rel_offset is set to UINT32_MAX.
+ * Return 0 on success, -1 if there's no such field.
+ */
+static int
+tuple_format_resolve_full_path(struct tuple_format *format,
+			       const char *path, uint32_t path_len,
+			       uint32_t path_hash, uint32_t *fieldno,
+			       uint32_t *rel_offset)
+{
 	/*
 	 * It is possible, that a field has a name as
 	 * well-formatted JSON. For example 'a.b.c.d' or '[1]' can
@@ -489,16 +535,18 @@ tuple_field_raw_by_full_path(struct tuple_format *format, const char *tuple,
 	 * use the path as a field name.
 	 */
 	if (tuple_fieldno_by_name(format->dict, path, path_len, path_hash,
-				  &fieldno) == 0)
-		return tuple_field_raw(format, tuple, field_map, fieldno);
+				  fieldno) == 0) {
+		*rel_offset = UINT32_MAX;
+		return 0;
+	}
 	struct json_lexer lexer;
 	struct json_token token;
 	json_lexer_create(&lexer, path, path_len, TUPLE_INDEX_BASE);
 	if (json_lexer_next_token(&lexer, &token) != 0)
-		return NULL;
+		return -1;
 	switch(token.type) {
 	case JSON_TOKEN_NUM: {
-		fieldno = token.num;
+		*fieldno = token.num;
 		break;
 	}
 	case JSON_TOKEN_STR: {
@@ -516,18 +564,91 @@ tuple_field_raw_by_full_path(struct tuple_format *format, const char *tuple,
 			name_hash = field_name_hash(token.str, token.len);
 		}
 		if (tuple_fieldno_by_name(format->dict, token.str, token.len,
-					  name_hash, &fieldno) != 0)
-			return NULL;
+					  name_hash, fieldno) != 0)
+			return -1;
 		break;
 	}
 	default:
 		assert(token.type == JSON_TOKEN_END ||
 		       token.type == JSON_TOKEN_ANY);
+		return -1;
+	}
+	*rel_offset = lexer.offset;
+	return 0;
+}
+
+/**
+ * Fill a JSON path cache entry. The offset slot is cached only
+ * for indexed fields that aren't a part of a multikey index,
+ * because the latter can't be accessed without a multikey index.
+ */
+static void
+tuple_path_cache_entry_fill(struct tuple_path_cache_entry *entry,
+			    struct tuple_format *format, const char *path,
+			    uint32_t path_len, uint32_t fieldno,
+			    uint32_t rel_offset)
+{
+	entry->format_epoch = format->epoch;
+	entry->dict_version = format->dict->version;
+	entry->fieldno = fieldno;
+	entry->rel_offset = rel_offset;
+	entry->offset_slot = TUPLE_OFFSET_SLOT_NIL;
+	entry->path_len = path_len;
+	memcpy(entry->path, path, path_len);
+	if (fieldno >= format->index_field_count)
+		return;
+	struct tuple_field *field;
+	if (rel_offset == UINT32_MAX) {
+		field = tuple_format_field(format, fieldno);
+	} else {
+		field = tuple_format_field_by_path(format, fieldno,
+						   path + rel_offset,
+						   path_len - rel_offset);
+	}
+	if (field != NULL && !field->is_multikey_part)
+		entry->offset_slot = field->offset_slot;
+}
+
+const char *
+tuple_field_raw_by_full_path(struct tuple_format *format, const char *tuple,
+			     const uint32_t *field_map, const char *path,
+			     uint32_t path_len, uint32_t path_hash)
+{
+	assert(path_len > 0);
+	uint32_t fieldno;
+	uint32_t rel_offset;
+	struct tuple_path_cache_entry *entry = NULL;
+	if (path_len <= TUPLE_PATH_CACHE_PATH_MAX && format->epoch != 0) {
+		entry = &tuple_path_cache[path_hash &
+					  (TUPLE_PATH_CACHE_SIZE - 1)];
+		if (entry->format_epoch == format->epoch &&
+		    entry->dict_version == format->dict->version &&
+		    entry->path_len == path_len &&
+		    memcmp(entry->path, path, path_len) == 0)
+			goto found;
+	}
+	if (tuple_format_resolve_full_path(format, path, path_len, path_hash,
+					   &fieldno, &rel_offset) != 0)
 		return NULL;
+	if (entry == NULL)
+		goto access;
+	tuple_path_cache_entry_fill(entry, format, path, path_len,
+				    fieldno, rel_offset);
+found:
+	fieldno = entry->fieldno;
+	rel_offset = entry->rel_offset;
+	if (entry->offset_slot != TUPLE_OFFSET_SLOT_NIL) {
+		int32_t offset_slot = entry->offset_slot;
+		uint32_t offset = field_map_get_offset(field_map, offset_slot,
+						       MULTIKEY_NONE);
+		return offset != 0 ? tuple + offset : NULL;
 	}
+access:
+	if (rel_offset == UINT32_MAX)
+		return tuple_field_raw(format, tuple, field_map, fieldno);
 	return tuple_field_raw_by_path(format, tuple, field_map, fieldno,
-				       path + lexer.offset,
-				       path_len - lexer.offset,
+				       path + rel_offset,
+				       path_len - rel_offset,
 				       NULL, MULTIKEY_NONE);
 }
 
@@ -635,6 +756,19 @@ box_tuple_field(box_tuple_t *tuple, uint32_t fieldno)
 	return tuple_field(tuple, fieldno);
 }
 
+const char *
+box_tuple_field_by_path(struct tuple *tuple, const char *path,
+			uint32_t path_len)
+{
+	assert(tuple != NULL);
+	assert(path_len > 0);
+	return tuple_field_raw_by_full_path(tuple_format(tuple),
+					    tuple_data(tuple),
+					    tuple_field_map(tuple), path,
+					    path_len,
+					    field_name_hash(path, path_len));
+}
+
 typedef struct tuple_iterator box_tuple_iterator_t;
 
 box_tuple_iterator_t *
@@ -815,8 +815,14 @@ tuple_field_raw_by_path(struct tuple_format *format, const char *tuple,
 		if (path != NULL && field == NULL)
 			goto parse;
 		offset_slot = field->offset_slot;
-		if (offset_slot == TUPLE_OFFSET_SLOT_NIL)
-			goto parse;
+		if (offset_slot == TUPLE_OFFSET_SLOT_NIL) {
+			if (field->fixed_offset == TUPLE_FIXED_OFFSET_NIL)
+				goto parse;
+			/* All the fields before this one are fixed-size. */
+			if (unlikely(fieldno >= mp_decode_array(&tuple)))
+				return NULL;
+			return tuple + field->fixed_offset;
+		}
 		if (offset_slot_hint != NULL) {
 			*offset_slot_hint = offset_slot;
 			/*
@@ -942,6 +948,19 @@ tuple_field_raw_by_full_path(struct tuple_format *format, const char *tuple,
 			     const uint32_t *field_map, const char *path,
 			     uint32_t path_len, uint32_t path_hash);
 
+/**
+ * Get a tuple field by its name or by a JSON path, the way
+ * tuple['name'] does in Lua. Used by Lua via FFI, so that field
+ * access by name can be compiled by LuaJIT.
+ * @param tuple Tuple to get the field from.
+ * @param path Field name or JSON path.
+ * @param path_len Length of @a path, must be > 0.
+ * @retval field data if the field exists or NULL
+ */
+const char *
+box_tuple_field_by_path(struct tuple *tuple, const char *path,
+			uint32_t path_len);
+
 /**
  * Get a tuple field pointed to by an index part and multikey
  * index hint.
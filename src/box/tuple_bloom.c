@@ -216,16 +216,21 @@ tuple_bloom_maybe_has(const struct tuple_bloom *bloom, struct tuple *tuple,
 	uint32_t h = HASH_SEED;
 	uint32_t carry = 0;
 	uint32_t total_size = 0;
+	uint32_t prev_hash = 0;
 
 	for (uint32_t i = 0; i < key_def->part_count; i++) {
 		total_size += tuple_hash_key_part(&h, &carry, tuple,
 						  &key_def->parts[i],
 						  multikey_idx);
 		uint32_t hash = PMurHash32_Result(h, carry, total_size);
-		if (!bloom_maybe_has(&bloom->parts[i], hash))
+		bloom_prefetch(&bloom->parts[i], hash);
+		/* See the comment in tuple_bloom_maybe_has_key(). */
+		if (i > 0 && !bloom_maybe_has(&bloom->parts[i - 1], prev_hash))
 			return false;
+		prev_hash = hash;
 	}
-	return true;
+	return bloom_maybe_has(&bloom->parts[key_def->part_count - 1],
+			       prev_hash);
 }
 
 bool
@@ -243,18 +248,31 @@ tuple_bloom_maybe_has_key(const struct tuple_bloom *bloom,
 	assert(part_count <= key_def->part_count);
 	assert(bloom->part_count == key_def->part_count);
 
+	if (part_count == 0)
+		return true;
+
 	uint32_t h = HASH_SEED;
 	uint32_t carry = 0;
 	uint32_t total_size = 0;
+	uint32_t prev_hash = 0;
 
 	for (uint32_t i = 0; i < part_count; i++) {
 		total_size += tuple_hash_field(&h, &carry, &key,
 					       key_def->parts[i].coll);
 		uint32_t hash = PMurHash32_Result(h, carry, total_size);
-		if (!bloom_maybe_has(&bloom->parts[i], hash))
+		/*
+		 * Each partial key is checked against its own bloom
+		 * filter, so a lookup touches a cache line per key
+		 * part. Prefetch the block for the current part and
+		 * check the previous one while it's being loaded so
+		 * that the cache misses overlap with hashing.
+		 */
+		bloom_prefetch(&bloom->parts[i], hash);
+		if (i > 0 && !bloom_maybe_has(&bloom->parts[i - 1], prev_hash))
 			return false;
+		prev_hash = hash;
 	}
-	return true;
+	return bloom_maybe_has(&bloom->parts[part_count - 1], prev_hash);
 }
 
 static size_t
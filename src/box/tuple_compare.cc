@@ -37,6 +37,11 @@
 #include "mp_decimal.h"
 #include "mp_extension_types.h"
 #include "mp_uuid.h"
+#include "cpu_feature.h"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif /* defined(__x86_64__) */
 
 /* {{{ tuple_compare */
 
@@ -217,6 +222,25 @@ mp_compare_double_any_number(double lhs, const char *rhs,
 static int
 mp_compare_decimal(const char *lhs, const char *rhs)
 {
+	/*
+	 * Most decimals are small enough to be compared as
+	 * scaled integers without unpacking them to decimal_t.
+	 */
+	int8_t ext_type;
+	const char *lhs_data = lhs, *rhs_data = rhs;
+	uint32_t lhs_len = mp_decode_extl(&lhs_data, &ext_type);
+	assert(ext_type == MP_DECIMAL);
+	uint32_t rhs_len = mp_decode_extl(&rhs_data, &ext_type);
+	assert(ext_type == MP_DECIMAL);
+	int64_t lhs_coef, rhs_coef;
+	int32_t lhs_scale, rhs_scale;
+	int res;
+	if (decimal_unpack_small(lhs_data, lhs_len, &lhs_coef, &lhs_scale) &&
+	    decimal_unpack_small(rhs_data, rhs_len, &rhs_coef, &rhs_scale) &&
+	    decimal_compare_small(lhs_coef, lhs_scale, rhs_coef, rhs_scale,
+				  &res))
+		return res;
+
 	decimal_t lhs_dec, rhs_dec;
 	decimal_t *ret;
 	ret = mp_decode_decimal(&lhs, &lhs_dec);
@@ -978,9 +1002,6 @@ tuple_compare_sequential(struct tuple *tuple_a, hint_t tuple_a_hint,
 	return 0;
 }
 
-template <int TYPE>
-static inline int
-field_compare(const char **field_a, const char **field_b);
 
 template <>
 inline int
@@ -1033,6 +1054,133 @@ field_compare_and_next<FIELD_TYPE_STRING>(const char **field_a,
 	return r;
 }
 
+#if defined(__x86_64__)
+
+enum {
+	/**
+	 * Max number of leading bytes of two tuples compared in
+	 * bulk by tuple_compare_sequential_prefix().
+	 */
+	TUPLE_COMPARE_PREFIX_MAX = 128,
+};
+
+/**
+ * Return the length of the common prefix of two buffers. Compares
+ * 16 bytes at a time with SSE2, which is always available on
+ * x86_64. Never reads beyond len bytes.
+ */
+static inline size_t
+mem_common_prefix_sse2(const char *a, const char *b, size_t len)
+{
+	size_t i = 0;
+	for (; i + 16 <= len; i += 16) {
+		__m128i va = _mm_loadu_si128((const __m128i *)(a + i));
+		__m128i vb = _mm_loadu_si128((const __m128i *)(b + i));
+		unsigned mask = _mm_movemask_epi8(_mm_cmpeq_epi8(va, vb));
+		if (mask != 0xffff)
+			return i + __builtin_ctz(~mask);
+	}
+	while (i < len && a[i] == b[i])
+		i++;
+	return i;
+}
+
+/** Same as mem_common_prefix_sse2(), but compares 32 bytes at a time. */
+static __attribute__((target("avx2"))) size_t
+mem_common_prefix_avx2(const char *a, const char *b, size_t len)
+{
+	size_t i = 0;
+	for (; i + 32 <= len; i += 32) {
+		__m256i va = _mm256_loadu_si256((const __m256i *)(a + i));
+		__m256i vb = _mm256_loadu_si256((const __m256i *)(b + i));
+		unsigned mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(va, vb));
+		if (mask != 0xffffffff)
+			return i + __builtin_ctz(~mask);
+	}
+	return i + mem_common_prefix_sse2(a + i, b + i, len - i);
+}
+
+/**
+ * Comparator for sequential non-nullable keys consisting of
+ * unsigned and string parts only.
+ *
+ * Byte-wise equal MsgPack of such fields means equal values, so
+ * instead of decoding the tuples field by field, the comparator
+ * first finds the common prefix of the tuples with SIMD and skips
+ * the key parts that lie in it entirely, only looking at their
+ * headers. The remaining parts are compared as usual. Since an
+ * unsigned value may have more than one encoding, a mismatch in
+ * bytes doesn't mean a mismatch in values, so the scalar loop
+ * doesn't stop at the first part that is equal by value.
+ */
+template <bool use_avx2>
+static int
+tuple_compare_sequential_prefix(struct tuple *tuple_a, hint_t tuple_a_hint,
+				struct tuple *tuple_b, hint_t tuple_b_hint,
+				struct key_def *key_def)
+{
+	assert(key_def_is_sequential(key_def));
+	assert(!key_def->is_nullable);
+	int rc = hint_cmp(tuple_a_hint, tuple_b_hint);
+	if (rc != 0)
+		return rc;
+	uint32_t bsize_a, bsize_b;
+	const char *field_a = tuple_data_range(tuple_a, &bsize_a);
+	const char *field_b = tuple_data_range(tuple_b, &bsize_b);
+	const char *end_a = field_a + bsize_a;
+	const char *end_b = field_b + bsize_b;
+	mp_decode_array(&field_a);
+	mp_decode_array(&field_b);
+	size_t len = MIN(end_a - field_a, end_b - field_b);
+	len = MIN(len, (size_t)TUPLE_COMPARE_PREFIX_MAX);
+	size_t common = use_avx2 ?
+			mem_common_prefix_avx2(field_a, field_b, len) :
+			mem_common_prefix_sse2(field_a, field_b, len);
+	const char *common_end = field_a + common;
+	struct key_part *part = key_def->parts;
+	struct key_part *parts_end = part + key_def->part_count;
+	for (; part < parts_end; part++) {
+		const char *next_a = field_a;
+		mp_next(&next_a);
+		if (next_a > common_end)
+			break;
+		field_b += next_a - field_a;
+		field_a = next_a;
+	}
+	for (; part < parts_end; part++) {
+		if (part->type == FIELD_TYPE_UNSIGNED) {
+			rc = field_compare_and_next<FIELD_TYPE_UNSIGNED>(
+						&field_a, &field_b);
+		} else {
+			assert(part->type == FIELD_TYPE_STRING);
+			rc = field_compare_and_next<FIELD_TYPE_STRING>(
+						&field_a, &field_b);
+		}
+		if (rc != 0)
+			return rc;
+	}
+	return 0;
+}
+
+/**
+ * Return true if tuple_compare_sequential_prefix() can be used
+ * for the given key definition.
+ */
+static bool
+key_def_is_sequential_prefix_comparable(struct key_def *def)
+{
+	if (def->part_count < 2 || !key_def_is_sequential(def))
+		return false;
+	for (uint32_t i = 0; i < def->part_count; i++) {
+		if (def->parts[i].type != FIELD_TYPE_UNSIGNED &&
+		    def->parts[i].type != FIELD_TYPE_STRING)
+			return false;
+	}
+	return true;
+}
+
+#endif /* defined(__x86_64__) */
+
 /* Tuple comparator */
 namespace /* local symbols */ {
 
@@ -1450,7 +1598,8 @@ func_index_compare_with_key(struct tuple *tuple, hint_t tuple_hint,
  * For simplicity we construct it using the first key part only;
  * other key parts don't participate in hint construction. As a
  * consequence, tuple hints are useless if the first key part
- * doesn't differ among indexed tuples.
+ * doesn't differ among indexed tuples. For such indexes there's
+ * a multipart hint layout, see multipart_hint_create().
  *
  * Hint class stores one of mp_class enum values corresponding
  * to the field type. We store it in upper bits of a hint so
@@ -1595,6 +1744,28 @@ hint_decimal(decimal_t *dec)
 	return hint_create(MP_CLASS_NUMBER, val);
 }
 
+/**
+ * Calculate the hint of a packed decimal of size @a len, without
+ * unpacking it to decimal_t if it's small enough.
+ */
+static inline hint_t
+hint_decimal_raw(const char *data, uint32_t len)
+{
+	int64_t coef, num;
+	int32_t scale;
+	if (decimal_unpack_small(data, len, &coef, &scale) &&
+	    decimal_small_to_int64(coef, scale, &num)) {
+		uint64_t val = 0;
+		if (num >= HINT_VALUE_INT_MIN && num <= HINT_VALUE_INT_MAX)
+			val = num - HINT_VALUE_INT_MIN;
+		else if (num > 0)
+			val = HINT_VALUE_MAX;
+		return hint_create(MP_CLASS_NUMBER, val);
+	}
+	decimal_t dec;
+	return hint_decimal(decimal_unpack(&data, len, &dec));
+}
+
 static inline hint_t
 hint_uuid_raw(const char *data)
 {
@@ -1699,10 +1870,7 @@ field_hint_number(const char *field)
 		uint32_t len = mp_decode_extl(&field, &ext_type);
 		switch (ext_type) {
 		case MP_DECIMAL:
-		{
-			decimal_t dec;
-			return hint_decimal(decimal_unpack(&field, len, &dec));
-		}
+			return hint_decimal_raw(field, len);
 		default:
 			unreachable();
 		}
@@ -1721,10 +1889,7 @@ field_hint_decimal(const char *field)
 	uint32_t len = mp_decode_extl(&field, &ext_type);
 	switch (ext_type) {
 	case MP_DECIMAL:
-	{
-		decimal_t dec;
-		return hint_decimal(decimal_unpack(&field, len, &dec));
-	}
+		return hint_decimal_raw(field, len);
 	default:
 		unreachable();
 	}
@@ -1786,10 +1951,7 @@ field_hint_scalar(const char *field, struct coll *coll)
 		uint32_t len = mp_decode_extl(&field, &ext_type);
 		switch (ext_type) {
 		case MP_DECIMAL:
-		{
-			decimal_t dec;
-			return hint_decimal(decimal_unpack(&field, len, &dec));
-		}
+			return hint_decimal_raw(field, len);
 		case MP_UUID:
 			return hint_uuid_raw(field);
 		default:
@@ -1857,6 +2019,167 @@ tuple_hint(struct tuple *tuple, struct key_def *key_def)
 	return field_hint<type, is_nullable>(field, key_def->parts->coll);
 }
 
+/**
+ * A multipart hint is built from the first two key parts and has
+ * the following layout:
+ *
+ *     [         head          |         tail          ]
+ *      <-- HINT_HEAD_BITS ---> <-- HINT_TAIL_BITS --->
+ *
+ * The head is computed from the first key part of a small range
+ * type (boolean, unsigned or integer). Values that don't fit in
+ * the head are saturated to the min or the max head value. If the
+ * head value is exact, the tail is computed from the second key
+ * part similarly to an ordinary hint value, but without the class
+ * bits. Otherwise, the tail is 0, because tuples sharing the same
+ * saturated head may have different first parts and so their
+ * second parts must not affect the order of the hints.
+ *
+ * A saturated head can't be all ones with a zero tail, so the
+ * hint never equals HINT_NONE.
+ *
+ * A key with less than two parts gets HINT_NONE.
+ */
+#define HINT_HEAD_BITS		8
+#define HINT_TAIL_BITS		(HINT_BITS - HINT_HEAD_BITS)
+#define HINT_HEAD_MAX		((1ULL << HINT_HEAD_BITS) - 1)
+#define HINT_TAIL_MAX		((1ULL << HINT_TAIL_BITS) - 1)
+
+/**
+ * Max absolute value of an integer that is stored exactly in
+ * the head. Integers from [-HINT_HEAD_INT_MAX, HINT_HEAD_INT_MAX]
+ * are mapped to [1, 2 * HINT_HEAD_INT_MAX + 1].
+ */
+#define HINT_HEAD_INT_MAX	((int64_t)(HINT_HEAD_MAX / 2 - 1))
+
+/**
+ * Offset added to an integer stored in the tail so that all the
+ * integers from [-HINT_TAIL_INT_OFFSET, HINT_TAIL_INT_OFFSET)
+ * are stored exactly.
+ */
+#define HINT_TAIL_INT_OFFSET	(1ULL << (HINT_TAIL_BITS - 1))
+
+static_assert(CHAR_BIT * HINT_VALUE_BYTES == HINT_TAIL_BITS,
+	      "string hint must fit in multipart hint tail");
+
+static inline hint_t
+multipart_hint_create(uint64_t head, uint64_t tail)
+{
+	assert(head <= HINT_HEAD_MAX);
+	assert(tail <= HINT_TAIL_MAX);
+	return (hint_t)((head << HINT_TAIL_BITS) | tail);
+}
+
+/**
+ * Compute the head of a multipart hint. Sets is_exact to true if
+ * the head is the same only for equal fields.
+ */
+template <enum field_type type>
+static inline uint64_t
+multipart_hint_head(const char *field, bool *is_exact)
+{
+	*is_exact = true;
+	switch (type) {
+	case FIELD_TYPE_BOOLEAN:
+		return mp_decode_bool(&field) ? 1 : 0;
+	case FIELD_TYPE_UNSIGNED: {
+		uint64_t u = mp_decode_uint(&field);
+		if (u < HINT_HEAD_MAX)
+			return u;
+		break;
+	}
+	case FIELD_TYPE_INTEGER: {
+		if (mp_typeof(*field) == MP_UINT) {
+			uint64_t u = mp_decode_uint(&field);
+			if (u <= (uint64_t)HINT_HEAD_INT_MAX)
+				return u + HINT_HEAD_INT_MAX + 1;
+			break;
+		}
+		int64_t i = mp_decode_int(&field);
+		if (i > HINT_HEAD_INT_MAX)
+			break;
+		if (i < -HINT_HEAD_INT_MAX) {
+			*is_exact = false;
+			return 0;
+		}
+		return i + HINT_HEAD_INT_MAX + 1;
+	}
+	default:
+		unreachable();
+	}
+	*is_exact = false;
+	return HINT_HEAD_MAX;
+}
+
+/** Compute the tail of a multipart hint. */
+template <enum field_type type>
+static inline uint64_t
+multipart_hint_tail(const char *field)
+{
+	switch (type) {
+	case FIELD_TYPE_BOOLEAN:
+		return mp_decode_bool(&field) ? 1 : 0;
+	case FIELD_TYPE_UNSIGNED:
+		return MIN(mp_decode_uint(&field), HINT_TAIL_MAX);
+	case FIELD_TYPE_INTEGER: {
+		uint64_t u;
+		if (mp_typeof(*field) == MP_UINT) {
+			u = mp_decode_uint(&field);
+		} else {
+			int64_t i = mp_decode_int(&field);
+			if (i < 0) {
+				return i < -(int64_t)HINT_TAIL_INT_OFFSET ? 0 :
+				       (uint64_t)(i + HINT_TAIL_INT_OFFSET);
+			}
+			u = i;
+		}
+		return u < HINT_TAIL_INT_OFFSET ? u + HINT_TAIL_INT_OFFSET :
+		       HINT_TAIL_MAX;
+	}
+	case FIELD_TYPE_STRING: {
+		uint32_t len;
+		const char *s = mp_decode_str(&field, &len);
+		return hint_str_raw(s, len);
+	}
+	default:
+		unreachable();
+	}
+	return 0;
+}
+
+template <enum field_type head_type, enum field_type tail_type>
+static hint_t
+key_hint_multipart(const char *key, uint32_t part_count,
+		   struct key_def *key_def)
+{
+	(void)key_def;
+	assert(!key_def->is_multikey);
+	if (part_count < 2)
+		return HINT_NONE;
+	bool is_exact;
+	uint64_t head = multipart_hint_head<head_type>(key, &is_exact);
+	if (!is_exact)
+		return multipart_hint_create(head, 0);
+	mp_next(&key);
+	return multipart_hint_create(head, multipart_hint_tail<tail_type>(key));
+}
+
+template <enum field_type head_type, enum field_type tail_type>
+static hint_t
+tuple_hint_multipart(struct tuple *tuple, struct key_def *key_def)
+{
+	assert(!key_def->is_multikey);
+	const char *field = tuple_field_by_part(tuple, &key_def->parts[0],
+						MULTIKEY_NONE);
+	bool is_exact;
+	uint64_t head = multipart_hint_head<head_type>(field, &is_exact);
+	if (!is_exact)
+		return multipart_hint_create(head, 0);
+	field = tuple_field_by_part(tuple, &key_def->parts[1], MULTIKEY_NONE);
+	return multipart_hint_create(head,
+				     multipart_hint_tail<tail_type>(field));
+}
+
 static hint_t
 key_hint_stub(const char *key, uint32_t part_count, struct key_def *key_def)
 {
@@ -1904,6 +2227,67 @@ key_def_set_hint_func(struct key_def *def)
 		key_def_set_hint_func<type, false>(def);
 }
 
+template<enum field_type head_type, enum field_type tail_type>
+static void
+key_def_set_multipart_hint_func(struct key_def *def)
+{
+	def->key_hint = key_hint_multipart<head_type, tail_type>;
+	def->tuple_hint = tuple_hint_multipart<head_type, tail_type>;
+}
+
+template<enum field_type head_type>
+static bool
+key_def_set_multipart_hint_func(struct key_def *def)
+{
+	switch (def->parts[1].type) {
+	case FIELD_TYPE_BOOLEAN:
+		key_def_set_multipart_hint_func<head_type,
+						FIELD_TYPE_BOOLEAN>(def);
+		return true;
+	case FIELD_TYPE_UNSIGNED:
+		key_def_set_multipart_hint_func<head_type,
+						FIELD_TYPE_UNSIGNED>(def);
+		return true;
+	case FIELD_TYPE_INTEGER:
+		key_def_set_multipart_hint_func<head_type,
+						FIELD_TYPE_INTEGER>(def);
+		return true;
+	case FIELD_TYPE_STRING:
+		key_def_set_multipart_hint_func<head_type,
+						FIELD_TYPE_STRING>(def);
+		return true;
+	default:
+		return false;
+	}
+}
+
+/**
+ * Set multipart hint functions if the key definition allows it.
+ * Returns false if the first two key parts can't be used for a
+ * multipart hint.
+ */
+static bool
+key_def_set_multipart_hint_func(struct key_def *def)
+{
+	if (def->part_count < 2 || def->has_json_paths)
+		return false;
+	for (uint32_t i = 0; i < 2; i++) {
+		if (key_part_is_nullable(&def->parts[i]) ||
+		    def->parts[i].coll != NULL)
+			return false;
+	}
+	switch (def->parts[0].type) {
+	case FIELD_TYPE_BOOLEAN:
+		return key_def_set_multipart_hint_func<FIELD_TYPE_BOOLEAN>(def);
+	case FIELD_TYPE_UNSIGNED:
+		return key_def_set_multipart_hint_func<FIELD_TYPE_UNSIGNED>(def);
+	case FIELD_TYPE_INTEGER:
+		return key_def_set_multipart_hint_func<FIELD_TYPE_INTEGER>(def);
+	default:
+		return false;
+	}
+}
+
 static void
 key_def_set_hint_func(struct key_def *def)
 {
@@ -1912,6 +2296,8 @@ key_def_set_hint_func(struct key_def *def)
 		def->tuple_hint = key_hint_stub;
 		return;
 	}
+	if (def->multipart_hint && key_def_set_multipart_hint_func(def))
+		return;
 	switch (def->parts->type) {
 	case FIELD_TYPE_BOOLEAN:
 		key_def_set_hint_func<FIELD_TYPE_BOOLEAN>(def);
@@ -1992,6 +2378,20 @@ key_def_set_compare_func_fast(struct key_def *def)
 			break;
 		}
 	}
+#if defined(__x86_64__)
+	/*
+	 * A composite key of unsigned and string parts benefits
+	 * more from skipping the common prefix in bulk than from
+	 * a pre-compiled comparator.
+	 */
+	if (key_def_is_sequential_prefix_comparable(def)) {
+		static int has_avx2 = -1;
+		if (has_avx2 < 0)
+			has_avx2 = avx2_enabled_cpu();
+		cmp = has_avx2 ? tuple_compare_sequential_prefix<true> :
+				 tuple_compare_sequential_prefix<false>;
+	}
+#endif /* defined(__x86_64__) */
 	if (cmp == NULL) {
 		cmp = is_sequential ?
 			tuple_compare_sequential<false, false> :
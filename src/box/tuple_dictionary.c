@@ -195,11 +195,15 @@ tuple_dictionary_swap(struct tuple_dictionary *a, struct tuple_dictionary *b)
 {
 	int a_refs = a->refs;
 	int b_refs = b->refs;
+	uint32_t a_version = a->version;
+	uint32_t b_version = b->version;
 	struct tuple_dictionary t = *a;
 	*a = *b;
 	*b = t;
 	a->refs = a_refs;
 	b->refs = b_refs;
+	a->version = a_version + 1;
+	b->version = b_version + 1;
 }
 
 void
@@ -57,6 +57,12 @@ struct tuple_dictionary {
 	uint32_t name_count;
 	/** Reference counter. */
 	int refs;
+	/**
+	 * Incremented every time the names are changed in place
+	 * with tuple_dictionary_swap(), so that field numbers
+	 * cached by name can be invalidated.
+	 */
+	uint32_t version;
 };
 
 /**
@@ -85,7 +91,7 @@ tuple_dictionary_cmp(const struct tuple_dictionary *a,
 
 /**
  * Swap content of two dictionaries. Reference counters are not
- * swaped.
+ * swaped. Versions of both dictionaries are incremented.
  */
 void
 tuple_dictionary_swap(struct tuple_dictionary *a, struct tuple_dictionary *b);
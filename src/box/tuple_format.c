@@ -152,6 +152,7 @@ tuple_field_new(void)
 	field->token.type = JSON_TOKEN_END;
 	field->type = FIELD_TYPE_ANY;
 	field->offset_slot = TUPLE_OFFSET_SLOT_NIL;
+	field->fixed_offset = TUPLE_FIXED_OFFSET_NIL;
 	field->coll_id = COLL_NONE;
 	field->nullable_action = ON_CONFLICT_ACTION_NONE;
 	field->multikey_required_fields = NULL;
@@ -428,6 +429,88 @@ tuple_format_use_key_part(struct tuple_format *format, uint32_t field_count,
 	return 0;
 }
 
+/** Check if a field can be skipped with a single mp_next() call. */
+static inline bool
+tuple_field_is_scalar(struct tuple_field *field)
+{
+	return field->type != FIELD_TYPE_ANY &&
+	       field->type != FIELD_TYPE_ARRAY &&
+	       field->type != FIELD_TYPE_MAP &&
+	       json_token_is_leaf(&field->token);
+}
+
+/**
+ * Return the MsgPack size of a field if it is the same for all
+ * tuples of the format, 0 otherwise. Only MP_BOOL, MP_NIL and
+ * MP_DOUBLE have a fixed size: integers and strings are encoded
+ * in the shortest form, and extensions may use either a fixext or
+ * an ext header.
+ */
+static inline uint32_t
+tuple_field_fixed_size(struct tuple_field *field)
+{
+	if (!json_token_is_leaf(&field->token))
+		return 0;
+	switch (field->type) {
+	case FIELD_TYPE_BOOLEAN:
+		/* Both true/false and nil are one byte long. */
+		return 1;
+	case FIELD_TYPE_DOUBLE:
+		return tuple_field_is_nullable(field) ? 0 : mp_sizeof_double(0);
+	default:
+		return 0;
+	}
+}
+
+/**
+ * Don't store offsets of the top-level fields which are cheap to find
+ * by decoding the tuple, see TUPLE_FORMAT_SCAN_FIELD_COUNT_MAX, or
+ * which don't need decoding at all, see tuple_field::fixed_offset.
+ * The remaining offset slots are renumbered so the field map stays
+ * dense.
+ */
+static void
+tuple_format_drop_cheap_offset_slots(struct tuple_format *format,
+				     int *current_slot)
+{
+	uint32_t count = tuple_format_field_count(format);
+	if (count > 0)
+		tuple_format_field(format, 0)->fixed_offset = 0;
+	uint32_t offset = 0;
+	bool is_scalar = true;
+	bool is_changed = false;
+	for (uint32_t fieldno = 1; fieldno < count; fieldno++) {
+		struct tuple_field *prev = tuple_format_field(format,
+							      fieldno - 1);
+		uint32_t size = tuple_field_fixed_size(prev);
+		if (offset != TUPLE_FIXED_OFFSET_NIL && size > 0)
+			offset += size;
+		else
+			offset = TUPLE_FIXED_OFFSET_NIL;
+		is_scalar = is_scalar && tuple_field_is_scalar(prev) &&
+			    fieldno < TUPLE_FORMAT_SCAN_FIELD_COUNT_MAX;
+		if (offset == TUPLE_FIXED_OFFSET_NIL && !is_scalar)
+			break;
+		struct tuple_field *field = tuple_format_field(format, fieldno);
+		field->fixed_offset = offset;
+		if (field->offset_slot == TUPLE_OFFSET_SLOT_NIL ||
+		    !json_token_is_leaf(&field->token))
+			continue;
+		field->offset_slot = TUPLE_OFFSET_SLOT_NIL;
+		is_changed = true;
+	}
+	if (!is_changed)
+		return;
+	int slot = 0;
+	struct tuple_field *field;
+	json_tree_foreach_entry_preorder(field, &format->fields.root,
+					 struct tuple_field, token) {
+		if (field->offset_slot != TUPLE_OFFSET_SLOT_NIL)
+			field->offset_slot = --slot;
+	}
+	*current_slot = slot;
+}
+
 /**
  * Extract all available type info from keys and field
  * definitions.
@@ -489,6 +572,8 @@ tuple_format_create(struct tuple_format *format, struct key_def * const *keys,
 		}
 	}
 
+	tuple_format_drop_cheap_offset_slots(format, &current_slot);
+
 	assert(tuple_format_field(format, 0)->offset_slot == TUPLE_OFFSET_SLOT_NIL
 	       || json_token_is_multikey(&tuple_format_field(format, 0)->token));
 	size_t field_map_size = -current_slot * sizeof(uint32_t);
@@ -854,6 +939,16 @@ tuple_field_map_create_plain(struct tuple_format *format, const char *tuple,
 			 (unsigned) format->exact_field_count);
 		return -1;
 	}
+	/* Nothing to check and no offsets to store, don't decode. */
+	if (!validate && format->field_map_size == 0)
+		return 0;
+	/*
+	 * All fields of a plain format are top-level, so a tuple that
+	 * has at least min_field_count fields has all required ones,
+	 * and there's no need to track them in a bitmap.
+	 */
+	bool check_required = validate &&
+			      defined_field_count < format->min_field_count;
 	defined_field_count = MIN(defined_field_count,
 				  tuple_format_field_count(format));
 
@@ -865,7 +960,7 @@ tuple_field_map_create_plain(struct tuple_format *format, const char *tuple,
 		goto end;
 	}
 
-	if (validate) {
+	if (check_required) {
 		required_fields = region_alloc(region, required_fields_sz);
 		memcpy(required_fields, format->required_fields,
 		       required_fields_sz);
@@ -885,7 +980,8 @@ tuple_field_map_create_plain(struct tuple_format *format, const char *tuple,
 					 mp_type_strs[mp_typeof(*pos)]);
 				return -1;
 			}
-			bit_clear(required_fields, field->id);
+			if (check_required)
+				bit_clear(required_fields, field->id);
 		}
 		if (field->offset_slot != TUPLE_OFFSET_SLOT_NIL &&
 		    field_map_builder_set_slot(builder, field->offset_slot,
@@ -896,7 +992,7 @@ tuple_field_map_create_plain(struct tuple_format *format, const char *tuple,
 	}
 
 end:
-	if (!validate)
+	if (!check_required)
 		return 0;
 
 	return tuple_format_required_fields_validate(format, required_fields,
@@ -62,6 +62,18 @@ enum { TUPLE_INDEX_BASE = 1 };
  * an offset for a field_id.
  */
 enum { TUPLE_OFFSET_SLOT_NIL = INT32_MAX };
+/*
+ * Fields with numbers below this one are not stored in the field map
+ * if they are preceded only by scalar fields, because they are found
+ * with a few mp_next() calls. It saves 4 bytes per field for tuples of
+ * small records.
+ */
+enum { TUPLE_FORMAT_SCAN_FIELD_COUNT_MAX = 4 };
+/*
+ * tuple_field::fixed_offset value of a field preceded by a field with
+ * a variable MsgPack size.
+ */
+enum { TUPLE_FIXED_OFFSET_NIL = UINT32_MAX };
 
 struct tuple;
 struct tuple_chunk;
@@ -124,6 +136,14 @@ struct tuple_field {
 	 * field map is negative.
 	 */
 	int32_t offset_slot;
+	/**
+	 * Offset of a top-level field from the first field of
+	 * a tuple. It is known at format creation if all the
+	 * fields before this one have a fixed MsgPack size, see
+	 * tuple_field_fixed_size(). Such a field is never given
+	 * an offset slot. Otherwise TUPLE_FIXED_OFFSET_NIL.
+	 */
+	uint32_t fixed_offset;
 	/** True if this field is used by an index. */
 	bool is_key_part;
 	/** True if this field is used by multikey index. */
@@ -35,9 +35,12 @@
 #include "tuple.h"
 #include "journal.h"
 #include <fiber.h>
+#include "fiber_pool.h"
+#include "clock.h"
 #include "xrow.h"
 #include "errinj.h"
 #include "iproto_constants.h"
+#include "trivia/probe.h"
 #include "box.h"
 
 double too_long_threshold;
@@ -126,18 +129,18 @@ txn_add_redo(struct txn *txn, struct txn_stmt *stmt, struct request *request)
 
 /** Initialize a new stmt object within txn. */
 static struct txn_stmt *
-txn_stmt_new(struct region *region)
+txn_stmt_new(struct txn *txn)
 {
 	int size;
 	struct txn_stmt *stmt;
-	stmt = region_alloc_object(region, struct txn_stmt, &size);
+	stmt = region_alloc_object(&txn->region, struct txn_stmt, &size);
 	if (stmt == NULL) {
 		diag_set(OutOfMemory, size, "region_alloc_object", "stmt");
 		return NULL;
 	}
 
 	/* Initialize members explicitly to save time on memset() */
-	stmt->txn = in_txn();
+	stmt->txn = txn;
 	stmt->space = NULL;
 	stmt->old_tuple = NULL;
 	stmt->new_tuple = NULL;
@@ -389,7 +392,7 @@ txn_begin_stmt(struct txn *txn, struct space *space, uint16_t type)
 	if (txn_check_can_continue(txn) != 0)
 		return -1;
 
-	struct txn_stmt *stmt = txn_stmt_new(&txn->region);
+	struct txn_stmt *stmt = txn_stmt_new(txn);
 	if (stmt == NULL)
 		return -1;
 
@@ -917,6 +920,7 @@ txn_commit(struct txn *txn)
 	struct txn_limbo_entry *limbo_entry = NULL;
 
 	txn->fiber = fiber();
+	TT_PROBE(txn_commit_begin, txn->id);
 
 	if (txn_prepare(txn) != 0)
 		goto rollback_abort;
@@ -954,8 +958,14 @@ txn_commit(struct txn *txn)
 	}
 
 	fiber_set_txn(fiber(), NULL);
-	if (journal_write(req) != 0)
+	double wal_start = clock_monotonic();
+	/* Let the pool run other requests while this one waits for WAL. */
+	fiber_pool_block_begin();
+	int rc = journal_write(req);
+	fiber_pool_block_end();
+	if (rc != 0)
 		goto rollback_io;
+	fiber()->storage.net.wal_wait += clock_monotonic() - wal_start;
 	if (req->res < 0) {
 		diag_set_journal_res(req->res);
 		goto rollback_io;
@@ -973,11 +983,16 @@ txn_commit(struct txn *txn)
 			/* Local WAL write is a first 'ACK'. */
 			txn_limbo_ack(&txn_limbo, txn_limbo.owner_id, lsn);
 		}
-		if (txn_limbo_wait_complete(&txn_limbo, limbo_entry) < 0)
+		double limbo_start = clock_monotonic();
+		rc = txn_limbo_wait_complete(&txn_limbo, limbo_entry);
+		fiber()->storage.net.limbo_wait +=
+			clock_monotonic() - limbo_start;
+		if (rc < 0)
 			goto rollback;
 	}
 	assert(txn_has_flag(txn, TXN_IS_DONE));
 	assert(txn->signature >= 0);
+	TT_PROBE(txn_commit_end, txn->id, txn->signature);
 
 	/* Synchronous transactions are freed by the calling fiber. */
 	txn_free(txn);
@@ -1105,6 +1120,84 @@ box_txn_commit(void)
 	return rc;
 }
 
+/** Completion callback of box_txn_commit_async() and its triggers. */
+struct txn_commit_async_ctx {
+	box_txn_commit_cb_t cb;
+	void *arg;
+	struct trigger on_commit;
+	struct trigger on_rollback;
+};
+
+static int
+txn_commit_async_on_commit(struct trigger *trigger, void *event)
+{
+	(void)event;
+	struct txn_commit_async_ctx *ctx = trigger->data;
+	ctx->cb(0, ctx->arg);
+	return 0;
+}
+
+static int
+txn_commit_async_on_rollback(struct trigger *trigger, void *event)
+{
+	struct txn *txn = event;
+	struct txn_commit_async_ctx *ctx = trigger->data;
+	if (txn->signature != TXN_SIGNATURE_ABORT)
+		diag_set_txn_sign(txn->signature);
+	else if (diag_is_empty(diag_get()))
+		diag_set(ClientError, ER_TXN_ROLLBACK);
+	ctx->cb(-1, ctx->arg);
+	return 0;
+}
+
+int
+box_txn_commit_async(box_txn_commit_cb_t cb, void *arg)
+{
+	struct txn *txn = in_txn();
+	if (txn == NULL) {
+		/* Nothing to commit, like in box_txn_commit(). */
+		cb(0, arg);
+		return 0;
+	}
+	if (txn->in_sub_stmt) {
+		diag_set(ClientError, ER_COMMIT_IN_SUB_STMT);
+		return -1;
+	}
+	/*
+	 * A local synchronous transaction needs the LSN of its WAL
+	 * write to be assigned to its limbo entry, which only the
+	 * blocking commit does.
+	 */
+	struct txn_stmt *stmt;
+	stailq_foreach_entry(stmt, &txn->stmts, next) {
+		if (!txn_has_flag(txn, TXN_FORCE_ASYNC) &&
+		    stmt->space != NULL && stmt->space->def->opts.is_sync) {
+			diag_set(ClientError, ER_UNSUPPORTED,
+				 "box_txn_commit_async()",
+				 "synchronous spaces");
+			return -1;
+		}
+	}
+	size_t size;
+	struct txn_commit_async_ctx *ctx =
+		region_alloc_object(&txn->region, typeof(*ctx), &size);
+	if (ctx == NULL) {
+		diag_set(OutOfMemory, size, "region_alloc_object", "ctx");
+		return -1;
+	}
+	ctx->cb = cb;
+	ctx->arg = arg;
+	trigger_create(&ctx->on_commit, txn_commit_async_on_commit, ctx, NULL);
+	trigger_create(&ctx->on_rollback, txn_commit_async_on_rollback, ctx,
+		       NULL);
+	txn_on_commit(txn, &ctx->on_commit);
+	txn_on_rollback(txn, &ctx->on_rollback);
+	/* The outcome is reported by the triggers. */
+	(void)txn_commit_try_async(txn);
+	fiber_gc();
+	return 0;
+}
+
 int
 box_txn_rollback(void)
 {
@@ -825,6 +825,37 @@ box_txn_begin(void);
 API_EXPORT int
 box_txn_commit(void);
 
+/**
+ * Callback passed to box_txn_commit_async().
+ *
+ * @param rc - 0 if the transaction is committed, -1 if it is
+ *             rolled back, in which case the error is set in diag.
+ * @param arg - the argument passed to box_txn_commit_async().
+ */
+typedef void (*box_txn_commit_cb_t)(int rc, void *arg);
+
+/**
+ * Commit the current transaction without waiting for the WAL
+ * write. The transaction is detached from the fiber, and @a cb
+ * is called once the transaction is committed or rolled back.
+ * It may be called before this function returns, for example for
+ * a read-only transaction or if the commit fails right away.
+ *
+ * The callback is called from the WAL completion context. It
+ * must not yield or throw, and must not start transactions.
+ *
+ * The function may yield if the WAL queue is full (see
+ * box.cfg.wal_queue_max_size), which throttles the writers.
+ *
+ * Transactions writing to synchronous spaces are not supported.
+ *
+ * @retval 0 - the commit is started, @a cb reports the outcome
+ * @retval -1 - failed to start the commit, the transaction is
+ *              still active, and @a cb won't be called
+ */
+API_EXPORT int
+box_txn_commit_async(box_txn_commit_cb_t cb, void *arg);
+
 /**
  * Rollback the current transaction.
  * May fail if called from a nested
@@ -50,6 +50,7 @@ txn_limbo_create(struct txn_limbo *limbo)
 	limbo->confirmed_lsn = 0;
 	limbo->rollback_count = 0;
 	limbo->is_in_rollback = false;
+	limbo->is_in_confirm = false;
 }
 
 bool
@@ -368,11 +369,38 @@ fail:
  */
 static void
 txn_limbo_write_confirm(struct txn_limbo *limbo, int64_t lsn)
+{
+	assert(lsn <= limbo->confirmed_lsn);
+	assert(!limbo->is_in_rollback);
+	txn_limbo_write_synchro(limbo, IPROTO_RAFT_CONFIRM, lsn, 0);
+}
+
+static void
+txn_limbo_read_confirm(struct txn_limbo *limbo, int64_t lsn);
+
+/**
+ * Confirm all the entries <= @a lsn, which have gathered a quorum.
+ * If another fiber is writing a CONFIRM already, only remember the
+ * LSN: the writer covers it with one more CONFIRM as soon as the
+ * current one is written. So at most one CONFIRM is in progress at
+ * a time, and acks collected during its WAL write are confirmed
+ * with a single entry rather than a CONFIRM per ack.
+ */
+static void
+txn_limbo_confirm(struct txn_limbo *limbo, int64_t lsn)
 {
 	assert(lsn > limbo->confirmed_lsn);
 	assert(!limbo->is_in_rollback);
 	limbo->confirmed_lsn = lsn;
-	txn_limbo_write_synchro(limbo, IPROTO_RAFT_CONFIRM, lsn, 0);
+	if (limbo->is_in_confirm)
+		return;
+	limbo->is_in_confirm = true;
+	do {
+		lsn = limbo->confirmed_lsn;
+		txn_limbo_write_confirm(limbo, lsn);
+		txn_limbo_read_confirm(limbo, lsn);
+	} while (lsn < limbo->confirmed_lsn && !limbo->is_in_rollback);
+	limbo->is_in_confirm = false;
 }
 
 /** Confirm all the entries <= @a lsn. */
@@ -594,8 +622,7 @@ txn_limbo_ack(struct txn_limbo *limbo, uint32_t replica_id, int64_t lsn)
 	}
 	if (confirm_lsn == -1 || confirm_lsn <= limbo->confirmed_lsn)
 		return;
-	txn_limbo_write_confirm(limbo, confirm_lsn);
-	txn_limbo_read_confirm(limbo, confirm_lsn);
+	txn_limbo_confirm(limbo, confirm_lsn);
 }
 
 /**
@@ -805,10 +832,8 @@ txn_limbo_on_parameters_change(struct txn_limbo *limbo)
 			assert(confirm_lsn > 0);
 		}
 	}
-	if (confirm_lsn > limbo->confirmed_lsn && !limbo->is_in_rollback) {
-		txn_limbo_write_confirm(limbo, confirm_lsn);
-		txn_limbo_read_confirm(limbo, confirm_lsn);
-	}
+	if (confirm_lsn > limbo->confirmed_lsn && !limbo->is_in_rollback)
+		txn_limbo_confirm(limbo, confirm_lsn);
 	/*
 	 * Wakeup all the others - timed out will rollback. Also
 	 * there can be non-transactional waiters, such as CONFIRM
@@ -149,12 +149,19 @@ struct txn_limbo {
 	uint64_t promote_greatest_term;
 	/**
 	 * Maximal LSN gathered quorum and either already confirmed in WAL, or
-	 * whose confirmation is in progress right now. Any attempt to confirm
+	 * whose confirmation is in progress right now, or going to be written
+	 * once the CONFIRM in progress is finished. Any attempt to confirm
 	 * something smaller than this value can be safely ignored. Moreover,
 	 * any attempt to rollback something starting from <= this LSN is
 	 * illegal.
 	 */
 	int64_t confirmed_lsn;
+	/**
+	 * Whether a fiber is writing CONFIRM to WAL. New confirmations
+	 * only advance confirmed_lsn meanwhile, and that fiber writes
+	 * one more CONFIRM covering all of them when it's done.
+	 */
+	bool is_in_confirm;
 	/**
 	 * Total number of performed rollbacks. It used as a guard
 	 * to do some actions assuming all limbo transactions will
@@ -51,6 +51,7 @@
 #include <stdint.h>
 #include <stdlib.h>
 
+#include <qsort_arg.h>
 #include <small/lsregion.h>
 #include <small/region.h>
 #include <small/mempool.h>
@@ -298,6 +299,7 @@ vy_info_append_memory(struct vy_env *env, struct info_handler *h)
 	info_append_int(h, "tuple_cache", env->cache_env.mem_used);
 	info_append_int(h, "page_index", env->lsm_env.page_index_size);
 	info_append_int(h, "bloom_filter", env->lsm_env.bloom_size);
+	info_append_int(h, "page_cache", env->run_env.page_cache_used);
 	info_table_end(h); /* memory */
 }
 
@@ -426,6 +428,22 @@ vinyl_index_stat(struct index *index, struct info_handler *h)
 	info_table_end(h); /* compaction */
 	info_append_int(h, "index_size", lsm->page_index_size);
 	info_append_int(h, "bloom_size", lsm->bloom_size);
+	/*
+	 * Write amplification is the ratio of the amount of data
+	 * written to disk by dumps and compactions to the amount
+	 * of data written by dumps. Space amplification is the
+	 * ratio of the disk size to the size of the last level,
+	 * which stores most of the data.
+	 */
+	int64_t dump_bytes = stat->disk.dump.output.bytes;
+	int64_t last_level_bytes = stat->disk.last_level_count.bytes;
+	info_append_double(h, "write_amplification", dump_bytes == 0 ? 0 :
+			   (double)(dump_bytes +
+				    stat->disk.compaction.output.bytes) /
+			   dump_bytes);
+	info_append_double(h, "space_amplification",
+			   last_level_bytes == 0 ? 0 :
+			   (double)stat->disk.count.bytes / last_level_bytes);
 	info_table_end(h); /* disk */
 
 	info_table_begin(h, "cache");
@@ -583,6 +601,11 @@ vinyl_engine_check_space_def(struct space_def *def)
 			 def->name, "engine does not support temporary flag");
 		return -1;
 	}
+	if (def->opts.read_view_enabled) {
+		diag_set(ClientError, ER_ALTER_SPACE, def->name,
+			 "engine does not support read_view_enabled flag");
+		return -1;
+	}
 	return 0;
 }
 
@@ -677,6 +700,11 @@ vinyl_space_check_index_def(struct space *space, struct index_def *index_def)
 			 "functional index");
 		return -1;
 	}
+	if (index_def->opts.multipart_hint) {
+		diag_set(ClientError, ER_UNSUPPORTED, "Vinyl",
+			 "multipart hints");
+		return -1;
+	}
 	return 0;
 }
 
@@ -2356,6 +2384,7 @@ vinyl_space_execute_delete(struct space *space, struct txn *txn,
 	struct txn_stmt *stmt = txn_current_stmt(txn);
 	if (vy_delete(env, tx, stmt, space, request))
 		return -1;
+	space_hot_keys_add_request(space, request);
 	/*
 	 * Delete may or may not set stmt->old_tuple,
 	 * but we always return NULL.
@@ -2373,6 +2402,7 @@ vinyl_space_execute_update(struct space *space, struct txn *txn,
 	struct txn_stmt *stmt = txn_current_stmt(txn);
 	if (vy_update(env, tx, stmt, space, request) != 0)
 		return -1;
+	space_hot_keys_add_request(space, request);
 	*result = stmt->new_tuple;
 	return 0;
 }
@@ -2384,7 +2414,12 @@ vinyl_space_execute_upsert(struct space *space, struct txn *txn,
 	struct vy_env *env = vy_env(space->engine);
 	struct vy_tx *tx = txn->engine_tx;
 	struct txn_stmt *stmt = txn_current_stmt(txn);
-	return vy_upsert(env, tx, stmt, space, request);
+	if (vy_upsert(env, tx, stmt, space, request) != 0)
+		return -1;
+	/* Memtx accounts upserts in index_get(). */
+	index_hot_keys_add_raw(space->index[0], request->tuple,
+			       request->tuple_end);
+	return 0;
 }
 
 static int
@@ -2619,6 +2654,7 @@ vy_env_new(const char *path, size_t memory,
 	               sizeof(struct vinyl_iterator));
 	vy_cache_env_create(&e->cache_env, slab_cache);
 	vy_run_env_create(&e->run_env, read_threads);
+	e->run_env.snap_io_rate_factor_f = wal_background_rate_factor;
 	vy_log_init(e->path);
 	return e;
 
@@ -2697,6 +2733,20 @@ vinyl_engine_set_cache(struct engine *engine, size_t quota)
 	vy_cache_env_set_quota(&env->cache_env, quota);
 }
 
+int
+vinyl_engine_set_cache_scan_resistant(struct engine *engine, bool value)
+{
+	struct vy_env *env = vy_env(engine);
+	return vy_cache_env_set_scan_resistant(&env->cache_env, value);
+}
+
+void
+vinyl_engine_set_page_cache(struct engine *engine, size_t quota)
+{
+	struct vy_env *env = vy_env(engine);
+	vy_run_env_set_page_cache_quota(&env->run_env, quota);
+}
+
 int
 vinyl_engine_set_memory(struct engine *engine, size_t size)
 {
@@ -2717,6 +2767,15 @@ vinyl_engine_set_max_tuple_size(struct engine *engine, size_t max_size)
 	env->stmt_env.max_tuple_size = max_size;
 }
 
+void
+vinyl_engine_set_upsert_squash_threshold(struct engine *engine,
+					 int threshold)
+{
+	struct vy_env *env = vy_env(engine);
+	assert(threshold > 0 && threshold <= VY_UPSERT_THRESHOLD_MAX);
+	env->mem_env.upsert_threshold = threshold;
+}
+
 void
 vinyl_engine_set_timeout(struct engine *engine, double timeout)
 {
@@ -2742,6 +2801,13 @@ vinyl_engine_set_snap_io_rate_limit(struct engine *engine, double limit)
 	vy_regulator_reset_dump_bandwidth(&env->regulator, limit_in_bytes);
 }
 
+void
+vinyl_engine_set_compression_level(struct engine *engine, int level)
+{
+	struct vy_env *env = vy_env(engine);
+	env->run_env.compression_level = level;
+}
+
 /** }}} Environment */
 
 /* {{{ Checkpoint */
@@ -3181,9 +3247,12 @@ vinyl_engine_collect_garbage(struct engine *engine, const struct vclock *vclock)
 
 static int
 vinyl_engine_backup(struct engine *engine, const struct vclock *vclock,
+		    const struct engine_backup_point *since,
+		    struct engine_backup_point *point,
 		    engine_backup_cb cb, void *cb_arg)
 {
 	struct vy_env *env = vy_env(engine);
+	point->vy_max_id = -1;
 
 	/* Backup the metadata log. */
 	const char *path = vy_log_backup_path(vclock);
@@ -3200,9 +3269,26 @@ vinyl_engine_backup(struct engine *engine, const struct vclock *vclock,
 		say_error("failed to recover vylog for backup");
 		return -1;
 	}
+	/*
+	 * Run ids grow monotonically so the runs listed by this backup
+	 * are those with ids up to the max id found in the log, except
+	 * runs that were still being written at the checkpoint. They
+	 * may be committed later and must be listed by the next
+	 * incremental backup.
+	 */
+	point->vy_max_id = recovery->max_id;
+	int64_t since_id = since != NULL ? since->vy_max_id : -1;
 	int rc = 0;
 	int loops = 0;
 	struct vy_lsm_recovery_info *lsm_info;
+	rlist_foreach_entry(lsm_info, &recovery->lsms, in_recovery) {
+		struct vy_run_recovery_info *run_info;
+		rlist_foreach_entry(run_info, &lsm_info->runs, in_lsm) {
+			if (run_info->is_incomplete &&
+			    run_info->id <= point->vy_max_id)
+				point->vy_max_id = run_info->id - 1;
+		}
+	}
 	rlist_foreach_entry(lsm_info, &recovery->lsms, in_recovery) {
 		if (lsm_info->drop_lsn >= 0 || lsm_info->create_lsn < 0) {
 			/* Dropped or not yet built LSM tree. */
@@ -3212,6 +3298,9 @@ vinyl_engine_backup(struct engine *engine, const struct vclock *vclock,
 		rlist_foreach_entry(run_info, &lsm_info->runs, in_lsm) {
 			if (run_info->is_dropped || run_info->is_incomplete)
 				continue;
+			/* Immutable run file listed by an earlier backup. */
+			if (run_info->id <= since_id)
+				continue;
 			char path[PATH_MAX];
 			for (int type = 0; type < vy_file_MAX; type++) {
 				if (type == VY_FILE_RUN_INPROGRESS ||
@@ -3344,8 +3433,10 @@ vy_squash_process(struct vy_squash *squash)
 			break;
 		assert(vy_stmt_lsn(mem_entry.stmt) >= MAX_LSN);
 		vy_stmt_set_n_upserts(mem_entry.stmt, n_upserts);
-		if (n_upserts <= VY_UPSERT_THRESHOLD)
+		if (n_upserts < env->mem_env.upsert_threshold)
 			++n_upserts;
+		else
+			n_upserts = VY_UPSERT_INF;
 		vy_mem_tree_iterator_prev(&mem->tree, &mem_itr);
 	}
 
@@ -3799,6 +3890,130 @@ vinyl_index_get(struct index *index, const char *key,
 	return 0;
 }
 
+/** A key of a batched lookup and its position in the batch. */
+struct vy_get_many_key {
+	struct vy_entry entry;
+	uint32_t pos;
+};
+
+static int
+vy_get_many_key_cmp(const void *a, const void *b, void *arg)
+{
+	const struct vy_get_many_key *key_a = a;
+	const struct vy_get_many_key *key_b = b;
+	struct key_def *cmp_def = arg;
+	int rc = vy_entry_compare(key_a->entry, key_b->entry, cmp_def);
+	if (rc != 0)
+		return rc;
+	return key_a->pos < key_b->pos ? -1 : key_a->pos > key_b->pos;
+}
+
+static int
+vinyl_index_get_many(struct index *index, const char **keys,
+		     uint32_t count, struct port *result)
+{
+	struct vy_lsm *lsm = vy_lsm(index);
+	/*
+	 * A lookup in a secondary index needs a lookup in the
+	 * primary index for each found tuple, which isn't batched.
+	 */
+	if (lsm->index_id > 0 || count <= 1)
+		return generic_index_get_many(index, keys, count, result);
+
+	struct vy_env *env = vy_env(index->engine);
+	struct vy_tx *tx = in_txn() ? in_txn()->engine_tx : NULL;
+	const struct vy_read_view **rv = (tx != NULL ? vy_tx_read_view(tx) :
+					  &env->xm->p_global_read_view);
+	if (tx != NULL && tx->state == VINYL_TX_ABORT) {
+		diag_set(ClientError, ER_TRANSACTION_CONFLICT);
+		return -1;
+	}
+
+	struct region *region = &fiber()->gc;
+	size_t region_svp = region_used(region);
+	size_t sorted_size, entries_size, found_size, tuples_size;
+	struct vy_get_many_key *sorted =
+		region_alloc_array(region, typeof(sorted[0]), count,
+				   &sorted_size);
+	struct vy_entry *entries =
+		region_alloc_array(region, typeof(entries[0]), count,
+				   &entries_size);
+	struct vy_entry *found =
+		region_alloc_array(region, typeof(found[0]), count,
+				   &found_size);
+	struct tuple **tuples =
+		region_alloc_array(region, typeof(tuples[0]), count,
+				   &tuples_size);
+	if (sorted == NULL || entries == NULL || found == NULL ||
+	    tuples == NULL) {
+		diag_set(OutOfMemory, sorted_size + entries_size +
+			 found_size + tuples_size, "region_alloc_array",
+			 "keys");
+		region_truncate(region, region_svp);
+		return -1;
+	}
+	int rc = -1;
+	uint32_t part_count = index->def->key_def->part_count;
+	uint32_t key_count = 0;
+	for (; key_count < count; key_count++) {
+		struct tuple *stmt = vy_key_new(lsm->env->key_format,
+						keys[key_count], part_count);
+		if (stmt == NULL)
+			goto out;
+		sorted[key_count].entry.stmt = stmt;
+		sorted[key_count].entry.hint = vy_stmt_hint(stmt,
+							    lsm->cmp_def);
+		sorted[key_count].pos = key_count;
+	}
+	/*
+	 * Look up the keys in ascending order so that keys
+	 * stored in the same page share the page read.
+	 */
+	qsort_arg(sorted, count, sizeof(sorted[0]), vy_get_many_key_cmp,
+		  lsm->cmp_def);
+	for (uint32_t i = 0; i < count; i++) {
+		entries[i] = sorted[i].entry;
+		if (tx != NULL && vy_tx_track_point(tx, lsm, entries[i]) != 0)
+			goto out;
+	}
+
+	/*
+	 * Make sure the LSM tree isn't deleted while we are
+	 * reading from it.
+	 */
+	vy_lsm_ref(lsm);
+	lsm->stat.lookup += count;
+	rc = vy_point_lookup_batch(lsm, tx, rv, entries, count, found);
+	vy_lsm_unref(lsm);
+	if (rc != 0)
+		goto out;
+
+	for (uint32_t i = 0; i < count; i++) {
+		if ((*rv)->vlsn == INT64_MAX) {
+			vy_cache_add(&lsm->cache, found[i], vy_entry_none(),
+				     sorted[i].entry, ITER_EQ);
+		}
+		if (found[i].stmt != NULL)
+			vy_stmt_counter_acct_tuple(&lsm->stat.get,
+						   found[i].stmt);
+	}
+	/* Return the tuples in the order of keys. */
+	for (uint32_t i = 0; i < count; i++)
+		tuples[sorted[i].pos] = found[i].stmt;
+	for (uint32_t i = 0; i < count; i++) {
+		if (tuples[i] == NULL)
+			continue;
+		if (rc == 0 && port_c_add_tuple(result, tuples[i]) != 0)
+			rc = -1;
+		tuple_unref(tuples[i]);
+	}
+out:
+	for (uint32_t i = 0; i < key_count; i++)
+		tuple_unref(sorted[i].entry.stmt);
+	region_truncate(region, region_svp);
+	return rc;
+}
+
 /*** }}} Cursor */
 
 /* {{{ Index build */
@@ -4576,10 +4791,15 @@ static const struct index_vtab vinyl_index_vtab = {
 	/* .random = */ generic_index_random,
 	/* .count = */ generic_index_count,
 	/* .get = */ vinyl_index_get,
+	/* .get_many = */ vinyl_index_get_many,
 	/* .replace = */ generic_index_replace,
 	/* .create_iterator = */ vinyl_index_create_iterator,
+	/* .create_iterator_with_offset = */
+		generic_index_create_iterator_with_offset,
 	/* .create_snapshot_iterator = */
 		vinyl_index_create_snapshot_iterator,
+	/* .create_read_view_iterator = */
+		generic_index_create_read_view_iterator,
 	/* .stat = */ vinyl_index_stat,
 	/* .compact = */ vinyl_index_compact,
 	/* .reset_stat = */ vinyl_index_reset_stat,
@@ -57,6 +57,18 @@ vinyl_engine_stat(struct engine *engine, struct info_handler *handler);
 void
 vinyl_engine_set_cache(struct engine *engine, size_t quota);
 
+/**
+ * Enable or disable the scan resistant mode of vinyl tuple cache.
+ */
+int
+vinyl_engine_set_cache_scan_resistant(struct engine *engine, bool value);
+
+/**
+ * Update vinyl page cache size.
+ */
+void
+vinyl_engine_set_page_cache(struct engine *engine, size_t quota);
+
 /**
  * Update vinyl memory size.
  */
@@ -69,6 +81,14 @@ vinyl_engine_set_memory(struct engine *engine, size_t size);
 void
 vinyl_engine_set_max_tuple_size(struct engine *engine, size_t max_size);
 
+/**
+ * Update the number of successive upserts for the same key
+ * after which they are squashed in background.
+ */
+void
+vinyl_engine_set_upsert_squash_threshold(struct engine *engine,
+					 int threshold);
+
 /**
  * Update query timeout.
  */
@@ -88,6 +108,12 @@ vinyl_engine_set_too_long_threshold(struct engine *engine,
 void
 vinyl_engine_set_snap_io_rate_limit(struct engine *engine, double limit);
 
+/**
+ * Update vinyl_compression_level.
+ */
+void
+vinyl_engine_set_compression_level(struct engine *engine, int level);
+
 #ifdef __cplusplus
 } /* extern "C" */
 
@@ -112,6 +138,13 @@ vinyl_engine_set_memory_xc(struct engine *engine, size_t size)
 		diag_raise();
 }
 
+static inline void
+vinyl_engine_set_cache_scan_resistant_xc(struct engine *engine, bool value)
+{
+	if (vinyl_engine_set_cache_scan_resistant(engine, value) != 0)
+		diag_raise();
+}
+
 #endif /* defined(__plusplus) */
 
 #endif /* INCLUDES_TARANTOOL_BOX_VINYL_H */
@@ -50,6 +50,9 @@ enum {
 	/* Max number of deletes that are made by cleanup action per one
 	 * cache operation */
 	VY_CACHE_CLEANUP_MAX_STEPS = 10,
+	/* Expected memory used by one cache node, including the tuple,
+	 * used for sizing the frequency sketch */
+	VY_CACHE_SKETCH_NODE_SIZE = 256,
 };
 
 void
@@ -58,6 +61,7 @@ vy_cache_env_create(struct vy_cache_env *e, struct slab_cache *slab_cache)
 	rlist_create(&e->cache_lru);
 	e->mem_used = 0;
 	e->mem_quota = 0;
+	e->is_scan_resistant = false;
 	mempool_create(&e->cache_node_mempool, slab_cache,
 		       sizeof(struct vy_cache_node));
 }
@@ -65,9 +69,41 @@ vy_cache_env_create(struct vy_cache_env *e, struct slab_cache *slab_cache)
 void
 vy_cache_env_destroy(struct vy_cache_env *e)
 {
+	if (e->is_scan_resistant)
+		cm_sketch_destroy(&e->sketch);
 	mempool_destroy(&e->cache_node_mempool);
 }
 
+/**
+ * Allocate a frequency sketch big enough for the cache quota.
+ */
+static int
+vy_cache_env_create_sketch(struct vy_cache_env *env, struct cm_sketch *sketch)
+{
+	size_t width = env->mem_quota / VY_CACHE_SKETCH_NODE_SIZE;
+	if (cm_sketch_create(sketch, MIN(width, UINT32_MAX)) != 0) {
+		diag_set(OutOfMemory, width * CM_SKETCH_DEPTH, "malloc",
+			 "vinyl cache sketch");
+		return -1;
+	}
+	return 0;
+}
+
+int
+vy_cache_env_set_scan_resistant(struct vy_cache_env *env, bool value)
+{
+	if (value == env->is_scan_resistant)
+		return 0;
+	if (value) {
+		if (vy_cache_env_create_sketch(env, &env->sketch) != 0)
+			return -1;
+	} else {
+		cm_sketch_destroy(&env->sketch);
+	}
+	env->is_scan_resistant = value;
+	return 0;
+}
+
 static inline size_t
 vy_cache_node_size(const struct vy_cache_node *node)
 {
@@ -214,6 +250,16 @@ void
 vy_cache_env_set_quota(struct vy_cache_env *env, size_t quota)
 {
 	env->mem_quota = quota;
+	if (env->is_scan_resistant) {
+		/* Resize the sketch, keep the old one on failure. */
+		struct cm_sketch sketch;
+		if (vy_cache_env_create_sketch(env, &sketch) == 0) {
+			cm_sketch_destroy(&env->sketch);
+			env->sketch = sketch;
+		} else {
+			diag_log();
+		}
+	}
 	while (env->mem_used > env->mem_quota) {
 		vy_cache_gc(env);
 		/*
@@ -224,6 +270,52 @@ vy_cache_env_set_quota(struct vy_cache_env *env, size_t quota)
 	}
 }
 
+/**
+ * Check if the TinyLFU admission policy works for a cache. It
+ * identifies tuples by the hash of the key, which isn't defined
+ * for multikey and functional indexes.
+ */
+static inline bool
+vy_cache_has_admission(struct vy_cache *cache)
+{
+	return cache->env->is_scan_resistant &&
+	       !cache->cmp_def->is_multikey && !cache->cmp_def->for_func_index;
+}
+
+/**
+ * TinyLFU admission policy. Count a read of the statement in the
+ * frequency sketch and, if the cache is full, admit the statement
+ * only if it is read more often than the least recently used one,
+ * which would be evicted to make room for it. This keeps the hot
+ * working set when a lot of tuples are read once.
+ */
+static bool
+vy_cache_admit(struct vy_cache *cache, struct vy_entry entry)
+{
+	struct vy_cache_env *env = cache->env;
+	if (!vy_cache_has_admission(cache))
+		return true;
+	uint32_t hash = tuple_hash(entry.stmt, cache->cmp_def);
+	cm_sketch_add(&env->sketch, hash);
+	size_t size = sizeof(struct vy_cache_node);
+	if (cache->is_primary)
+		size += tuple_size(entry.stmt);
+	if (env->mem_used + size <= env->mem_quota ||
+	    rlist_empty(&env->cache_lru))
+		return true;
+	/* Replacing a cached statement doesn't need any room. */
+	if (vy_cache_tree_find(&cache->cache_tree, entry) != NULL)
+		return true;
+	struct vy_cache_node *victim =
+		rlist_last_entry(&env->cache_lru, struct vy_cache_node, in_lru);
+	if (!vy_cache_has_admission(victim->cache))
+		return true;
+	uint32_t victim_hash = tuple_hash(victim->entry.stmt,
+					  victim->cache->cmp_def);
+	return cm_sketch_estimate(&env->sketch, hash) >
+	       cm_sketch_estimate(&env->sketch, victim_hash);
+}
+
 void
 vy_cache_add(struct vy_cache *cache, struct vy_entry curr,
 	     struct vy_entry prev, struct vy_entry key,
@@ -298,6 +390,8 @@ vy_cache_add(struct vy_cache *cache, struct vy_entry curr,
 	assert(prev.stmt == NULL ||
 	       vy_stmt_type(prev.stmt) == IPROTO_INSERT ||
 	       vy_stmt_type(prev.stmt) == IPROTO_REPLACE);
+	if (!vy_cache_admit(cache, curr))
+		return;
 	cache->version++;
 
 	/* Insert/replace new node to the tree */
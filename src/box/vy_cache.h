@@ -41,6 +41,7 @@
 #include "vy_read_view.h"
 #include "vy_stat.h"
 #include "small/mempool.h"
+#include "salad/cm_sketch.h"
 
 #if defined(__cplusplus)
 extern "C" {
@@ -123,6 +124,15 @@ struct vy_cache_env {
 	size_t mem_used;
 	/** Max memory size that can be used for cache */
 	size_t mem_quota;
+	/**
+	 * Set if the cache is scan resistant: when the cache is
+	 * full, a new tuple is admitted only if it is read more
+	 * often than the tuple it would evict (TinyLFU), and full
+	 * scans don't add tuples to the cache.
+	 */
+	bool is_scan_resistant;
+	/** Recent read frequencies, used if the cache is scan resistant. */
+	struct cm_sketch sketch;
 };
 
 /**
@@ -151,6 +161,15 @@ vy_cache_env_destroy(struct vy_cache_env *e);
 void
 vy_cache_env_set_quota(struct vy_cache_env *e, size_t quota);
 
+/**
+ * Enable or disable the scan resistant mode of the cache.
+ * @param e - the environment.
+ * @param value - true to enable the mode.
+ * @return 0 - OK, -1 - memory error.
+ */
+int
+vy_cache_env_set_scan_resistant(struct vy_cache_env *e, bool value);
+
 /**
  * Tuple cache (of one particular LSM tree)
  */
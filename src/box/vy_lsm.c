@@ -40,6 +40,7 @@
 #include "diag.h"
 #include "fiber.h"
 #include "errcode.h"
+#include "errinj.h"
 #include "histogram.h"
 #include "index_def.h"
 #include "say.h"
@@ -70,6 +71,21 @@ static const int64_t VY_MIN_RANGE_SIZE = 128 * 1024 * 1024;
  */
 static const int64_t VY_MAX_RANGE_SIZE = 2LL * 1024 * 1024 * 1024;
 
+/**
+ * For the same reason we split a range before compaction if the
+ * compaction is going to write more than this, even if the range
+ * is within the target size, e.g. if it has never been compacted.
+ */
+static int64_t
+vy_lsm_max_compaction_size(void)
+{
+	struct errinj *inj = errinj(ERRINJ_VY_MAX_COMPACTION_SIZE,
+				    ERRINJ_INT);
+	if (inj != NULL && inj->iparam > 0)
+		return inj->iparam;
+	return VY_MAX_RANGE_SIZE;
+}
+
 int
 vy_lsm_env_create(struct vy_lsm_env *env, const char *path,
 		  int64_t *p_generation, struct tuple_format *key_format,
@@ -973,7 +989,7 @@ vy_lsm_commit_upsert(struct vy_lsm *lsm, struct vy_mem *mem,
 	 */
 	if (n_upserts == VY_UPSERT_INF) {
 		/*
-		 * If UPSERT has n_upserts > VY_UPSERT_THRESHOLD,
+		 * If UPSERT has n_upserts > threshold,
 		 * it means the mem has older UPSERTs for the same
 		 * key which already are beeing processed in the
 		 * squashing task. At the end, the squashing task
@@ -982,7 +998,7 @@ vy_lsm_commit_upsert(struct vy_lsm *lsm, struct vy_mem *mem,
 		 */
 		return;
 	}
-	if (n_upserts == VY_UPSERT_THRESHOLD) {
+	if (n_upserts == mem->env->upsert_threshold) {
 		/*
 		 * Start single squashing task per one-mem and
 		 * one-key continous UPSERTs sequence.
@@ -991,7 +1007,7 @@ vy_lsm_commit_upsert(struct vy_lsm *lsm, struct vy_mem *mem,
 		older = vy_mem_older_lsn(mem, entry);
 		assert(older.stmt != NULL &&
 		       vy_stmt_type(older.stmt) == IPROTO_UPSERT &&
-		       vy_stmt_n_upserts(older.stmt) == VY_UPSERT_THRESHOLD - 1);
+		       vy_stmt_n_upserts(older.stmt) != VY_UPSERT_INF);
 #endif
 		if (lsm->env->upsert_thresh_cb == NULL) {
 			/* Squash callback is not installed. */
@@ -1133,6 +1149,7 @@ vy_lsm_split_range(struct vy_lsm *lsm, struct vy_range *range)
 
 	const char *split_key_raw;
 	if (!vy_range_needs_split(range, vy_lsm_range_size(lsm),
+				  vy_lsm_max_compaction_size(),
 				  &split_key_raw))
 		return false;
 
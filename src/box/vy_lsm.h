@@ -81,7 +81,7 @@ struct vy_lsm_env {
 	double too_long_threshold;
 	/**
 	 * Callback invoked when the number of upserts for
-	 * the same key exceeds VY_UPSERT_THRESHOLD.
+	 * the same key reaches vy_mem_env::upsert_threshold.
 	 */
 	vy_upsert_thresh_cb upsert_thresh_cb;
 	/** Argument passed to upsert_thresh_cb. */
@@ -57,6 +57,7 @@ vy_mem_env_create(struct vy_mem_env *env, size_t memory)
 			   SLAB_SIZE, false, "vinyl");
 	lsregion_create(&env->allocator, &env->arena);
 	env->tree_extent_size = 0;
+	env->upsert_threshold = VY_UPSERT_THRESHOLD;
 }
 
 void
@@ -187,9 +188,9 @@ vy_mem_insert_upsert(struct vy_mem *mem, struct vy_entry entry)
 	 * UPSERT, n = 1,
 	 *         ...
 	 * UPSERT, n = threshold,
-	 * UPSERT, n = threshold + 1,
-	 * UPSERT, n = threshold + 1, all following ones have
-	 *         ...                threshold + 1.
+	 * UPSERT, n = inf,
+	 * UPSERT, n = inf, all following ones have
+	 *         ...      inf.
 	 * These values are used by vy_lsm_commit_upsert to squash
 	 * UPSERTs subsequence.
 	 */
@@ -200,14 +201,20 @@ vy_mem_insert_upsert(struct vy_mem *mem, struct vy_entry entry)
 	    vy_entry_compare(entry, *older, mem->cmp_def) != 0)
 		return 0;
 	uint8_t n_upserts = vy_stmt_n_upserts(older->stmt);
+	uint8_t threshold = mem->env->upsert_threshold;
 	/*
 	 * Stop increment if the threshold is reached to avoid
-	 * creation of multiple squashing tasks.
+	 * creation of multiple squashing tasks. If the threshold
+	 * was lowered after the chain had grown longer than that,
+	 * let the new UPSERT start a squashing task, because none
+	 * was started for the chain.
 	 */
-	if (n_upserts <= VY_UPSERT_THRESHOLD)
+	if (n_upserts < threshold)
 		n_upserts++;
+	else if (n_upserts == threshold || n_upserts == VY_UPSERT_INF)
+		n_upserts = VY_UPSERT_INF;
 	else
-		assert(n_upserts == VY_UPSERT_INF);
+		n_upserts = threshold;
 	vy_stmt_set_n_upserts(entry.stmt, n_upserts);
 	return 0;
 }
@@ -59,6 +59,12 @@ struct vy_mem_env {
 	struct quota quota;
 	/** Size of memory used for storing tree extents. */
 	size_t tree_extent_size;
+	/**
+	 * Number of successive upserts for the same key in a mem
+	 * after which they are squashed in background.
+	 * @see box.cfg.vinyl_upsert_squash_threshold
+	 */
+	uint8_t upsert_threshold;
 };
 
 /**
@@ -205,7 +211,8 @@ struct vy_mem {
 	 *
 	 * Incremented for modified in-memory trees when
 	 * preparing a transaction. Decremented after writing
-	 * to WAL or rollback.
+	 * to WAL or rollback. Transactions that are still
+	 * executing statements don't pin in-memory trees.
 	 */
 	int pin_count;
 	/**
@@ -153,11 +153,101 @@ vy_point_lookup_scan_slice(struct vy_lsm *lsm, struct vy_slice *slice,
 	return rc;
 }
 
+/** A slice scanned concurrently with other slices. */
+struct vy_point_lookup_slice {
+	struct vy_lsm *lsm;
+	struct vy_slice *slice;
+	const struct vy_read_view **rv;
+	struct vy_entry key;
+	/** Statements found in the slice. */
+	struct vy_history history;
+	/**
+	 * Fiber scanning the slice or NULL if the slice has been
+	 * scanned by the caller.
+	 */
+	struct fiber *fiber;
+};
+
+static int
+vy_point_lookup_scan_slice_f(va_list ap)
+{
+	struct vy_point_lookup_slice *s =
+		va_arg(ap, struct vy_point_lookup_slice *);
+	return vy_point_lookup_scan_slice(s->lsm, s->slice, s->rv, s->key,
+					  &s->history);
+}
+
+/**
+ * Scan the given slices concurrently, each in its own fiber, so
+ * that their pages are read by different reader threads at the
+ * same time, then add found statements to the history list in
+ * the order of slices, up to terminal statement.
+ */
+static int
+vy_point_lookup_scan_slices_parallel(struct vy_lsm *lsm,
+				     struct vy_slice **slices, int slice_count,
+				     const struct vy_read_view **rv,
+				     struct vy_entry key,
+				     struct vy_history *history)
+{
+	size_t size;
+	struct vy_point_lookup_slice *scans =
+		region_alloc_array(&fiber()->gc, typeof(scans[0]),
+				   slice_count, &size);
+	if (scans == NULL) {
+		diag_set(OutOfMemory, size, "region_alloc_array", "scans");
+		return -1;
+	}
+	int rc = 0;
+	for (int i = 0; i < slice_count; i++) {
+		struct vy_point_lookup_slice *s = &scans[i];
+		s->lsm = lsm;
+		s->slice = slices[i];
+		s->rv = rv;
+		s->key = key;
+		vy_history_create(&s->history, &lsm->env->history_node_pool);
+		/* The newest slice is scanned by the caller. */
+		s->fiber = NULL;
+		if (i > 0)
+			s->fiber = fiber_new("vinyl.lookup",
+					     vy_point_lookup_scan_slice_f);
+		if (s->fiber == NULL) {
+			diag_clear(diag_get());
+			continue;
+		}
+		fiber_set_joinable(s->fiber, true);
+		fiber_start(s->fiber, s);
+	}
+	for (int i = 0; i < slice_count; i++) {
+		struct vy_point_lookup_slice *s = &scans[i];
+		if (s->fiber != NULL) {
+			if (fiber_join(s->fiber) != 0)
+				rc = -1;
+		} else if (rc == 0 && vy_point_lookup_scan_slice(
+				lsm, s->slice, rv, key, &s->history) != 0) {
+			rc = -1;
+		}
+	}
+	for (int i = 0; i < slice_count; i++) {
+		struct vy_point_lookup_slice *s = &scans[i];
+		if (rc == 0 && !vy_history_is_terminal(history))
+			vy_history_splice(history, &s->history);
+		else
+			vy_history_cleanup(&s->history);
+	}
+	return rc;
+}
+
 /**
  * Find a range and scan all slices that belongs to the range.
  * Add found statements to the history list up to terminal statement.
  * All slices are pinned before first slice scan, so it's guaranteed
  * that complete history from runs will be extracted.
+ *
+ * Bloom filters of all slices are checked first. If more than one
+ * slice may contain the key and pages are read by reader threads,
+ * the slices are scanned concurrently, because otherwise a key
+ * that was written long ago costs a disk read per level.
  */
 static int
 vy_point_lookup_scan_slices(struct vy_lsm *lsm, const struct vy_read_view **rv,
@@ -182,8 +272,33 @@ vy_point_lookup_scan_slices(struct vy_lsm *lsm, const struct vy_read_view **rv,
 		slices[i++] = slice;
 	}
 	assert(i == slice_count);
-	int rc = 0;
+	/*
+	 * Skip slices that can't contain the key. Their runs can't
+	 * be deleted while the range has other pinned slices, so
+	 * they may be unpinned right away.
+	 */
+	int candidate_count = 0;
 	for (i = 0; i < slice_count; i++) {
+		struct tuple_bloom *bloom = slices[i]->run->info.bloom;
+		if (bloom != NULL &&
+		    !vy_bloom_maybe_has(bloom, key, lsm->key_def)) {
+			lsm->stat.disk.iterator.bloom_hit++;
+			vy_slice_unpin(slices[i]);
+			continue;
+		}
+		slices[candidate_count++] = slices[i];
+	}
+	int rc = 0;
+	if (candidate_count > 1 &&
+	    slices[0]->run->env->reader_pool != NULL) {
+		rc = vy_point_lookup_scan_slices_parallel(lsm, slices,
+							  candidate_count,
+							  rv, key, history);
+		for (i = 0; i < candidate_count; i++)
+			vy_slice_unpin(slices[i]);
+		return rc;
+	}
+	for (i = 0; i < candidate_count; i++) {
 		if (rc == 0 && !vy_history_is_terminal(history))
 			rc = vy_point_lookup_scan_slice(lsm, slices[i],
 							rv, key, history);
@@ -296,6 +411,217 @@ done:
 	return 0;
 }
 
+/**
+ * Scan run slices for a sorted batch of keys. @a need_disk[i] is
+ * set if the history of keys[i] must be completed from disk, in
+ * which case found statements are added to @a history[i] up to
+ * terminal statement.
+ *
+ * Keys are processed range by range. All slices of a range are
+ * pinned before the first slice scan, and each slice is scanned
+ * with one iterator for all keys of the range in ascending order,
+ * so the pages it reads are reused by the following keys.
+ */
+static int
+vy_point_lookup_scan_slices_batch(struct vy_lsm *lsm,
+				  const struct vy_read_view **rv,
+				  const struct vy_entry *keys, int count,
+				  const bool *need_disk,
+				  struct vy_history *history)
+{
+	struct region *region = &fiber()->gc;
+	int rc = 0;
+	int begin = 0;
+	while (rc == 0 && begin < count) {
+		if (!need_disk[begin]) {
+			begin++;
+			continue;
+		}
+		struct vy_range *range = vy_range_tree_find_by_key(
+			&lsm->range_tree, ITER_EQ, keys[begin]);
+		assert(range != NULL);
+		int end = begin + 1;
+		while (end < count && (range->end.stmt == NULL ||
+				       vy_entry_compare(keys[end], range->end,
+							lsm->cmp_def) < 0))
+			end++;
+		int slice_count = range->slice_count;
+		size_t size;
+		struct vy_slice **slices =
+			region_alloc_array(region, typeof(slices[0]),
+					   slice_count, &size);
+		if (slices == NULL) {
+			diag_set(OutOfMemory, size, "region_alloc_array",
+				 "slices");
+			return -1;
+		}
+		int i = 0;
+		struct vy_slice *slice;
+		rlist_foreach_entry(slice, &range->slices, in_range) {
+			vy_slice_pin(slice);
+			slices[i++] = slice;
+		}
+		assert(i == slice_count);
+		for (i = 0; i < slice_count; i++) {
+			struct vy_run_iterator run_itr;
+			vy_run_iterator_open(&run_itr, &lsm->stat.disk.iterator,
+					     slices[i], ITER_EQ, keys[begin],
+					     rv, lsm->cmp_def, lsm->key_def,
+					     lsm->disk_format);
+			for (int k = begin; rc == 0 && k < end; k++) {
+				if (!need_disk[k] ||
+				    vy_history_is_terminal(&history[k]))
+					continue;
+				struct vy_history slice_history;
+				vy_history_create(&slice_history,
+						  &lsm->env->history_node_pool);
+				vy_run_iterator_reset(&run_itr, keys[k]);
+				rc = vy_run_iterator_next(&run_itr,
+							  &slice_history);
+				vy_history_splice(&history[k], &slice_history);
+			}
+			vy_run_iterator_close(&run_itr);
+			vy_slice_unpin(slices[i]);
+		}
+		begin = end;
+	}
+	return rc;
+}
+
+int
+vy_point_lookup_batch(struct vy_lsm *lsm, struct vy_tx *tx,
+		      const struct vy_read_view **rv,
+		      const struct vy_entry *keys, int count,
+		      struct vy_entry *ret)
+{
+	assert(tx == NULL || tx->state == VINYL_TX_READY);
+	struct region *region = &fiber()->gc;
+	size_t history_size, flags_size;
+	struct vy_history *history =
+		region_alloc_array(region, typeof(history[0]), 3 * count,
+				   &history_size);
+	if (history == NULL) {
+		diag_set(OutOfMemory, history_size, "region_alloc_array",
+			 "history");
+		return -1;
+	}
+	bool *flags = region_alloc_array(region, typeof(flags[0]), 2 * count,
+					 &flags_size);
+	if (flags == NULL) {
+		diag_set(OutOfMemory, flags_size, "region_alloc_array",
+			 "flags");
+		return -1;
+	}
+	/* History from txw and cache, mems and runs for each key. */
+	struct vy_history *mem_history = history + count;
+	struct vy_history *disk_history = history + 2 * count;
+	/* Set for keys whose history must be completed from mems. */
+	bool *need_mem = flags;
+	/* Set for keys whose history must be completed from runs. */
+	bool *need_disk = flags + count;
+	int rc = 0;
+	for (int i = 0; i < count; i++) {
+		/* All key parts must be set for a point lookup. */
+		assert(vy_stmt_is_full_key(keys[i].stmt, lsm->cmp_def));
+		assert(i == 0 || vy_entry_compare(keys[i - 1], keys[i],
+						  lsm->cmp_def) <= 0);
+		ret[i] = vy_entry_none();
+		vy_history_create(&history[i], &lsm->env->history_node_pool);
+		vy_history_create(&mem_history[i],
+				  &lsm->env->history_node_pool);
+		vy_history_create(&disk_history[i],
+				  &lsm->env->history_node_pool);
+		need_mem[i] = false;
+		if (rc != 0)
+			continue;
+		rc = vy_point_lookup_scan_txw(lsm, tx, keys[i], &history[i]);
+		if (rc != 0 || vy_history_is_terminal(&history[i]))
+			continue;
+		rc = vy_point_lookup_scan_cache(lsm, rv, keys[i], &history[i]);
+		if (rc != 0 || vy_history_is_terminal(&history[i]))
+			continue;
+		need_mem[i] = true;
+	}
+	if (rc != 0)
+		goto done;
+restart:
+	for (int i = 0; i < count; i++) {
+		need_disk[i] = false;
+		if (!need_mem[i])
+			continue;
+		rc = vy_point_lookup_scan_mems(lsm, rv, keys[i],
+					       &mem_history[i]);
+		if (rc != 0)
+			goto done;
+		need_disk[i] = !vy_history_is_terminal(&mem_history[i]);
+	}
+
+	/* Save version before yield */
+	uint32_t mem_version = lsm->mem->version;
+	uint32_t mem_list_version = lsm->mem_list_version;
+
+	rc = vy_point_lookup_scan_slices_batch(lsm, rv, keys, count,
+					       need_disk, disk_history);
+	if (rc != 0)
+		goto done;
+
+	if (tx != NULL && tx->state == VINYL_TX_ABORT) {
+		/* See the comment in vy_point_lookup(). */
+		diag_set(ClientError, ER_TRANSACTION_CONFLICT);
+		rc = -1;
+		goto done;
+	}
+
+	if (mem_list_version != lsm->mem_list_version) {
+		/* See the comment in vy_point_lookup(). */
+		for (int i = 0; i < count; i++) {
+			vy_history_cleanup(&mem_history[i]);
+			vy_history_cleanup(&disk_history[i]);
+		}
+		goto restart;
+	}
+
+	if (mem_version != lsm->mem->version) {
+		/*
+		 * Rescan the memory level if its version changed while we
+		 * were reading disk, because there may be new statements
+		 * matching the search keys.
+		 */
+		for (int i = 0; i < count; i++) {
+			if (!need_mem[i])
+				continue;
+			vy_history_cleanup(&mem_history[i]);
+			rc = vy_point_lookup_scan_mems(lsm, rv, keys[i],
+						       &mem_history[i]);
+			if (rc != 0)
+				goto done;
+			if (vy_history_is_terminal(&mem_history[i]))
+				vy_history_cleanup(&disk_history[i]);
+		}
+	}
+done:
+	for (int i = 0; i < count; i++) {
+		vy_history_splice(&history[i], &mem_history[i]);
+		vy_history_splice(&history[i], &disk_history[i]);
+		if (rc == 0) {
+			int upserts_applied;
+			rc = vy_history_apply(&history[i], lsm->cmp_def,
+					      false, &upserts_applied, &ret[i]);
+			lsm->stat.upsert.applied += upserts_applied;
+		}
+		vy_history_cleanup(&history[i]);
+	}
+	if (rc != 0) {
+		for (int i = 0; i < count; i++) {
+			if (ret[i].stmt != NULL)
+				tuple_unref(ret[i].stmt);
+			ret[i] = vy_entry_none();
+		}
+		return -1;
+	}
+	return 0;
+}
+
 int
 vy_point_lookup_mem(struct vy_lsm *lsm, const struct vy_read_view **rv,
 		    struct vy_entry key, struct vy_entry *ret)
@@ -70,6 +70,22 @@ vy_point_lookup(struct vy_lsm *lsm, struct vy_tx *tx,
 		const struct vy_read_view **rv,
 		struct vy_entry key, struct vy_entry *ret);
 
+/**
+ * Look up tuples for a batch of keys, see vy_point_lookup().
+ * The keys must be sorted in ascending order. The tuple found
+ * for keys[i] is returned in ret[i].
+ *
+ * Unlike calling vy_point_lookup() for each key, this function
+ * scans each run slice with one iterator for all keys that fall
+ * in its range, so keys stored in the same page share the page
+ * read.
+ */
+int
+vy_point_lookup_batch(struct vy_lsm *lsm, struct vy_tx *tx,
+		      const struct vy_read_view **rv,
+		      const struct vy_entry *keys, int count,
+		      struct vy_entry *ret);
+
 /**
  * Look up a tuple by key in memory.
  *
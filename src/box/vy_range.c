@@ -415,10 +415,14 @@ vy_range_update_compaction_priority(struct vy_range *range,
 		}
 	}
 
-	if (level_run_count > 1) {
+	if (level_run_count > 1 &&
+	    opts->compaction_strategy == COMPACTION_STRATEGY_LEVELED) {
 		/*
 		 * Do not store more than one run at the last level
-		 * to keep space amplification low.
+		 * to keep space amplification low. The tiered strategy
+		 * allows as many runs at the last level as at any other
+		 * level so as not to rewrite the biggest run each time
+		 * a compacted run reaches the last level.
 		 */
 		range->compaction_priority = total_run_count;
 		range->compaction_queue = total_stmt_count;
@@ -449,24 +453,44 @@ vy_range_update_dumps_per_compaction(struct vy_range *range)
  * - We should split around the last run middle key.
  * - We should only split if the last run size is greater than
  *   4/3 * range_size.
+ * - However, if the next compaction is going to write more than
+ *   max_compaction_size, we should split the range regardless,
+ *   around the middle key of the biggest run to be compacted, so
+ *   that the parts are compacted concurrently by different workers
+ *   rather than by one long task.
  */
 bool
 vy_range_needs_split(struct vy_range *range, int64_t range_size,
-		     const char **p_split_key)
+		     int64_t max_compaction_size, const char **p_split_key)
 {
 	struct vy_slice *slice;
 
-	/* The range hasn't been merged yet - too early to split it. */
-	if (range->n_compactions < 1)
-		return false;
-
 	/* Find the oldest run. */
 	assert(!rlist_empty(&range->slices));
 	slice = rlist_last_entry(&range->slices, struct vy_slice, in_range);
 
-	/* The range is too small to be split. */
-	if (slice->count.bytes < range_size * 4 / 3)
-		return false;
+	if (range->n_compactions < 1 ||
+	    slice->count.bytes < range_size * 4 / 3) {
+		/*
+		 * The range hasn't been merged yet or it is too
+		 * small to be split, unless the next compaction
+		 * is too big to be done by one task.
+		 */
+		if (range->compaction_queue.bytes <=
+		    MAX(max_compaction_size, 2 * range_size))
+			return false;
+		struct vy_slice *biggest = NULL;
+		int n = range->compaction_priority;
+		rlist_foreach_entry(slice, &range->slices, in_range) {
+			if (biggest == NULL ||
+			    slice->count.bytes > biggest->count.bytes)
+				biggest = slice;
+			if (--n == 0)
+				break;
+		}
+		assert(biggest != NULL);
+		slice = biggest;
+	}
 
 	/* Find the median key in the oldest run (approximately). */
 	struct vy_page_info *mid_page;
@@ -256,15 +256,17 @@ vy_range_update_dumps_per_compaction(struct vy_range *range);
 /**
  * Check if a range needs to be split in two.
  *
- * @param range             The range.
- * @param range_size        Target range size.
- * @param[out] p_split_key  Key to split the range by.
+ * @param range                The range.
+ * @param range_size           Target range size.
+ * @param max_compaction_size  Max amount of data a compaction of
+ *                             the range may write.
+ * @param[out] p_split_key     Key to split the range by.
  *
- * @retval true             If the range needs to be split.
+ * @retval true                If the range needs to be split.
  */
 bool
 vy_range_needs_split(struct vy_range *range, int64_t range_size,
-		     const char **p_split_key);
+		     int64_t max_compaction_size, const char **p_split_key);
 
 /**
  * Check if a range needs to be coalesced with adjacent
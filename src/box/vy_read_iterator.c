@@ -847,7 +847,13 @@ next_key:
 void
 vy_read_iterator_cache_add(struct vy_read_iterator *itr, struct vy_entry entry)
 {
-	if ((**itr->read_view).vlsn != INT64_MAX) {
+	/*
+	 * A full scan reads every tuple once, so in the scan resistant
+	 * mode it doesn't populate the cache.
+	 */
+	bool is_full_scan = itr->lsm->cache.env->is_scan_resistant &&
+			    vy_stmt_is_empty_key(itr->key.stmt);
+	if ((**itr->read_view).vlsn != INT64_MAX || is_full_scan) {
 		if (itr->last_cached.stmt != NULL)
 			tuple_unref(itr->last_cached.stmt);
 		itr->last_cached = vy_entry_none();
@@ -83,36 +83,63 @@ static const size_t VY_DUMP_SIZE_ACCT_MIN = 1024 * 1024;
  */
 static const int VY_RECENT_DUMP_COUNT = 100;
 
+/**
+ * Update the write rate limit while a memory dump is in progress.
+ */
 static void
-vy_regulator_trigger_dump(struct vy_regulator *regulator)
+vy_regulator_update_dump_rate_limit(struct vy_regulator *regulator)
 {
-	if (regulator->dump_in_progress)
-		return;
-
-	if (regulator->trigger_dump_cb(regulator) != 0)
+	if (!regulator->dump_in_progress)
 		return;
-
-	regulator->dump_in_progress = true;
-
 	/*
 	 * To avoid unpredictably long stalls, we must limit
 	 * the write rate when a dump is in progress so that
 	 * we don't hit the hard limit before the dump has
 	 * completed, i.e.
 	 *
-	 *    mem_left        mem_used
-	 *   ---------- >= --------------
-	 *   write_rate    dump_bandwidth
+	 *    mem_left
+	 *   ---------- >= dump_time_left
+	 *   write_rate
+	 *
+	 * where dump_time_left is the time the dump is expected
+	 * to take given the dump bandwidth minus the time that
+	 * has passed since it started. Memory is freed only when
+	 * the dump completes, so we recalculate the limit every
+	 * time the timer fires: the less memory is left and the
+	 * closer the dump is to completion, the more precise the
+	 * limit is. This way writers are slowed down gradually
+	 * rather than stalled abruptly when they hit the hard
+	 * limit. If the dump takes longer than expected, assume
+	 * it will complete within the next timer period.
 	 */
 	struct vy_quota *quota = regulator->quota;
 	size_t mem_left = (quota->used < quota->limit ?
 			   quota->limit - quota->used : 0);
-	size_t mem_used = quota->used;
-	size_t max_write_rate = (double)mem_left / (mem_used + 1) *
-					regulator->dump_bandwidth;
+	double dump_time = (double)regulator->dump_size /
+			   (regulator->dump_bandwidth + 1);
+	double dump_time_left = dump_time -
+			(ev_monotonic_now(loop()) - regulator->dump_start_time);
+	dump_time_left = MAX(dump_time_left, VY_REGULATOR_TIMER_PERIOD);
+	double max_write_rate = mem_left / dump_time_left;
 	max_write_rate = MIN(max_write_rate, regulator->dump_bandwidth);
 	vy_quota_set_rate_limit(quota, VY_QUOTA_RESOURCE_MEMORY,
 				max_write_rate);
+}
+
+static void
+vy_regulator_trigger_dump(struct vy_regulator *regulator)
+{
+	if (regulator->dump_in_progress)
+		return;
+
+	if (regulator->trigger_dump_cb(regulator) != 0)
+		return;
+
+	struct vy_quota *quota = regulator->quota;
+	regulator->dump_in_progress = true;
+	regulator->dump_start_time = ev_monotonic_now(loop());
+	regulator->dump_size = quota->used;
+	vy_regulator_update_dump_rate_limit(regulator);
 
 	say_info("dumping %zu bytes, expected rate %.1f MB/s, "
 		 "ETA %.1f s, write rate (avg/max) %.1f/%.1f MB/s",
@@ -200,6 +227,7 @@ vy_regulator_timer_cb(ev_loop *loop, ev_timer *timer, int events)
 	vy_regulator_update_write_rate(regulator);
 	vy_regulator_update_dump_watermark(regulator);
 	vy_regulator_check_dump_watermark(regulator);
+	vy_regulator_update_dump_rate_limit(regulator);
 }
 
 void
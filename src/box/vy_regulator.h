@@ -114,6 +114,13 @@ struct vy_regulator {
 	 * but vy_regulator_dump_complete() hasn't been called yet.
 	 */
 	bool dump_in_progress;
+	/**
+	 * Time when the last memory dump was triggered and amount
+	 * of memory that was used at that moment. Needed to predict
+	 * when the dump in progress will complete.
+	 */
+	double dump_start_time;
+	size_t dump_size;
 	/**
 	 * Snapshot of scheduler statistics taken at the time of
 	 * the last rate limit update.
@@ -44,6 +44,7 @@
 #include "xlog.h"
 #include "xrow.h"
 #include "vy_history.h"
+#include "trivia/probe.h"
 
 static const uint64_t vy_page_info_key_map = (1 << VY_PAGE_INFO_OFFSET) |
 					     (1 << VY_PAGE_INFO_SIZE) |
@@ -111,6 +112,39 @@ struct vy_page_read_task {
 	struct vy_page *page;
 };
 
+/**
+ * Cbus message used for reading a page ahead of a run iterator.
+ * Unlike vy_page_read_task, the iterator doesn't wait for it to
+ * complete, so it may outlive the iterator.
+ */
+struct vy_page_read_ahead {
+	struct cmsg base;
+	/** Reader thread hop and tx hop. */
+	struct cmsg_hop route[2];
+	/** Iterator that requested the page or NULL if it is gone. */
+	struct vy_run_iterator *itr;
+	/** Link in vy_run_iterator::read_ahead. */
+	struct rlist in_iterator;
+	/** Run to read the page from - ref. counted. */
+	struct vy_run *run;
+	/** Number of the page to read. */
+	uint32_t page_no;
+	/** Page to read the data to. */
+	struct vy_page *page;
+	/** Set when the page has been read. */
+	bool is_done;
+	/** Set if the page was read successfully. */
+	bool is_ok;
+	/** Signaled when the page has been read. */
+	struct fiber_cond cond;
+};
+
+/**
+ * Max number of pages a run iterator reads ahead of
+ * the current page during a sequential scan.
+ */
+enum { VY_RUN_READ_AHEAD_PAGES = 2 };
+
 /** Destructor for env->zdctx_key thread-local variable */
 static void
 vy_free_zdctx(void *arg)
@@ -180,12 +214,19 @@ vy_run_env_create(struct vy_run_env *env, int read_threads)
 {
 	memset(env, 0, sizeof(*env));
 	env->reader_pool_size = read_threads;
+	env->compression_level = XLOG_COMPRESSION_LEVEL_DEFAULT;
 	tt_pthread_key_create(&env->zdctx_key, vy_free_zdctx);
 	mempool_create(&env->read_task_pool, cord_slab_cache(),
 		       sizeof(struct vy_page_read_task));
+	mempool_create(&env->read_ahead_pool, cord_slab_cache(),
+		       sizeof(struct vy_page_read_ahead));
 	env->initial_join = false;
+	rlist_create(&env->page_cache_lru);
 }
 
+static void
+vy_page_cache_evict(struct vy_run_env *env, struct vy_page *page);
+
 /**
  * Destroy vinyl run environment
  */
@@ -194,7 +235,12 @@ vy_run_env_destroy(struct vy_run_env *env)
 {
 	if (env->reader_pool != NULL)
 		vy_run_env_stop_readers(env);
+	while (!rlist_empty(&env->page_cache_lru)) {
+		vy_page_cache_evict(env, rlist_first_entry(
+				&env->page_cache_lru, struct vy_page, in_lru));
+	}
 	mempool_destroy(&env->read_task_pool);
+	mempool_destroy(&env->read_ahead_pool);
 	tt_pthread_key_delete(env->zdctx_key);
 }
 
@@ -209,6 +255,16 @@ vy_run_env_enable_coio(struct vy_run_env *env)
 	vy_run_env_start_readers(env);
 }
 
+/** Pick a reader thread to process the next read request. */
+static struct vy_run_reader *
+vy_run_env_next_reader(struct vy_run_env *env)
+{
+	assert(env->reader_pool != NULL);
+	struct vy_run_reader *reader = &env->reader_pool[env->next_reader++];
+	env->next_reader %= env->reader_pool_size;
+	return reader;
+}
+
 /**
  * Execute a task on behalf of a reader thread.
  */
@@ -220,10 +276,7 @@ vy_run_env_coio_call(struct vy_run_env *env, struct cbus_call_msg *msg,
 	if (env->reader_pool == NULL)
 		return func(msg);
 
-	/* Pick a reader thread. */
-	struct vy_run_reader *reader;
-	reader = &env->reader_pool[env->next_reader++];
-	env->next_reader %= env->reader_pool_size;
+	struct vy_run_reader *reader = vy_run_env_next_reader(env);
 
 	/* Post the task to the reader thread. */
 	bool cancellable = fiber_set_cancellable(false);
@@ -293,6 +346,15 @@ vy_run_new(struct vy_run_env *env, int64_t id)
 static void
 vy_run_clear(struct vy_run *run)
 {
+	if (run->cached_pages != NULL) {
+		for (uint32_t i = 0; i < run->info.page_count; i++) {
+			if (run->cached_pages[i] != NULL)
+				vy_page_cache_evict(run->env,
+						    run->cached_pages[i]);
+		}
+		free(run->cached_pages);
+		run->cached_pages = NULL;
+	}
 	if (run->page_info != NULL) {
 		uint32_t page_no;
 		for (page_no = 0; page_no < run->info.page_count; ++page_no)
@@ -712,6 +774,9 @@ vy_page_new(const struct vy_page_info *page_info)
 			 "load_page", "page cache");
 		return NULL;
 	}
+	page->refs = 1;
+	page->run = NULL;
+	rlist_create(&page->in_lru);
 	page->unpacked_size = page_info->unpacked_size;
 	page->row_count = page_info->row_count;
 	page->row_index = calloc(page_info->row_count, sizeof(uint32_t));
@@ -748,6 +813,110 @@ vy_page_delete(struct vy_page *page)
 	free(page);
 }
 
+static inline void
+vy_page_ref(struct vy_page *page)
+{
+	assert(page->refs > 0);
+	page->refs++;
+}
+
+static inline void
+vy_page_unref(struct vy_page *page)
+{
+	assert(page->refs > 0);
+	if (--page->refs == 0)
+		vy_page_delete(page);
+}
+
+/** Return the amount of memory used by a page. */
+static inline size_t
+vy_page_mem_used(struct vy_page *page)
+{
+	return sizeof(*page) + page->unpacked_size +
+	       page->row_count * sizeof(*page->row_index);
+}
+
+/** Remove a page from the page cache. */
+static void
+vy_page_cache_evict(struct vy_run_env *env, struct vy_page *page)
+{
+	struct vy_run *run = page->run;
+	assert(run != NULL);
+	assert(run->cached_pages[page->page_no] == page);
+	run->cached_pages[page->page_no] = NULL;
+	page->run = NULL;
+	rlist_del_entry(page, in_lru);
+	assert(env->page_cache_used >= vy_page_mem_used(page));
+	env->page_cache_used -= vy_page_mem_used(page);
+	vy_page_unref(page);
+}
+
+/** Evict the least recently used pages until the quota is met. */
+static void
+vy_page_cache_enforce_quota(struct vy_run_env *env)
+{
+	while (env->page_cache_used > env->page_cache_quota) {
+		assert(!rlist_empty(&env->page_cache_lru));
+		vy_page_cache_evict(env, rlist_first_entry(
+				&env->page_cache_lru, struct vy_page, in_lru));
+	}
+}
+
+/**
+ * Look up a page of a run in the page cache. If found, the page
+ * is moved to the tail of the LRU list.
+ */
+static struct vy_page *
+vy_page_cache_get(struct vy_run *run, uint32_t page_no)
+{
+	if (run->cached_pages == NULL)
+		return NULL;
+	struct vy_page *page = run->cached_pages[page_no];
+	if (page != NULL)
+		rlist_move_tail_entry(&run->env->page_cache_lru, page, in_lru);
+	return page;
+}
+
+/**
+ * Add a page that has just been read from disk to the page cache.
+ * The function silently does nothing if the cache is disabled or
+ * there isn't enough memory for it.
+ */
+static void
+vy_page_cache_put(struct vy_run *run, struct vy_page *page)
+{
+	struct vy_run_env *env = run->env;
+	size_t size = vy_page_mem_used(page);
+	if (size > env->page_cache_quota)
+		return;
+	if (run->cached_pages == NULL) {
+		run->cached_pages = calloc(run->info.page_count,
+					   sizeof(*run->cached_pages));
+		if (run->cached_pages == NULL)
+			return;
+	}
+	/*
+	 * The page may have been read by another fiber while
+	 * we were waiting for the reader thread.
+	 */
+	if (run->cached_pages[page->page_no] != NULL)
+		return;
+	assert(page->run == NULL);
+	vy_page_ref(page);
+	page->run = run;
+	run->cached_pages[page->page_no] = page;
+	rlist_add_tail_entry(&env->page_cache_lru, page, in_lru);
+	env->page_cache_used += size;
+	vy_page_cache_enforce_quota(env);
+}
+
+void
+vy_run_env_set_page_cache_quota(struct vy_run_env *env, size_t quota)
+{
+	env->page_cache_quota = quota;
+	vy_page_cache_enforce_quota(env);
+}
+
 static int
 vy_page_xrow(struct vy_page *page, uint32_t stmt_no,
 	     struct xrow_header *xrow)
@@ -826,17 +995,21 @@ vy_page_find_key(struct vy_page *page, struct vy_entry key,
 /**
  * End iteration and free cached data.
  */
+static void
+vy_run_iterator_cancel_read_ahead(struct vy_run_iterator *itr);
+
 static void
 vy_run_iterator_stop(struct vy_run_iterator *itr)
 {
+	vy_run_iterator_cancel_read_ahead(itr);
 	if (itr->curr.stmt != NULL) {
 		tuple_unref(itr->curr.stmt);
 		itr->curr = vy_entry_none();
 	}
-	if (itr->curr_page != NULL) {
-		vy_page_delete(itr->curr_page);
+	if (itr->curr_page != NULL && !itr->keep_pages) {
+		vy_page_unref(itr->curr_page);
 		if (itr->prev_page != NULL)
-			vy_page_delete(itr->prev_page);
+			vy_page_unref(itr->prev_page);
 		itr->curr_page = itr->prev_page = NULL;
 	}
 }
@@ -892,6 +1065,8 @@ static int
 vy_page_read(struct vy_page *page, const struct vy_page_info *page_info,
 	     struct vy_run *run, ZSTD_DStream *zdctx)
 {
+	TT_PROBE(vy_page_read_begin, run->id, page_info->offset,
+		 page_info->size);
 	/* read xlog tx from xlog file */
 	size_t region_svp = region_used(&fiber()->gc);
 	char *data = (char *)region_alloc(&fiber()->gc, page_info->size);
@@ -946,6 +1121,8 @@ vy_page_read(struct vy_page *page, const struct vy_page_info *page_info,
 	ERROR_INJECT(ERRINJ_VY_READ_PAGE, {
 		diag_set(ClientError, ER_INJECTION, "vinyl page read");
 		return -1;});
+	TT_PROBE(vy_page_read_end, run->id, page_info->offset,
+		 page_info->unpacked_size);
 	return 0;
 error:
 	region_truncate(&fiber()->gc, region_svp);
@@ -996,46 +1173,176 @@ vy_page_read_cb(struct cbus_call_msg *base)
 	return 0;
 }
 
+static void
+vy_page_read_ahead_delete(struct vy_page_read_ahead *task)
+{
+	struct vy_run_env *env = task->run->env;
+	if (task->page != NULL)
+		vy_page_delete(task->page);
+	fiber_cond_destroy(&task->cond);
+	vy_run_unref(task->run);
+	mempool_free(&env->read_ahead_pool, task);
+}
+
+/** Read a page ahead of a run iterator. Runs in a reader thread. */
+static void
+vy_page_read_ahead_f(struct cmsg *base)
+{
+	struct vy_page_read_ahead *task = (struct vy_page_read_ahead *)base;
+	struct vy_run *run = task->run;
+	ZSTD_DStream *zdctx = vy_env_get_zdctx(run->env);
+	task->is_ok = zdctx != NULL &&
+		      vy_page_read(task->page,
+				   vy_run_page_info(run, task->page_no),
+				   run, zdctx) == 0;
+	/* On failure, the iterator will reread the page by itself. */
+	diag_clear(diag_get());
+}
+
+/** Complete a read ahead request. Runs in tx. */
+static void
+vy_page_read_ahead_complete_f(struct cmsg *base)
+{
+	struct vy_page_read_ahead *task = (struct vy_page_read_ahead *)base;
+	task->is_done = true;
+	if (task->itr == NULL)
+		vy_page_read_ahead_delete(task);
+	else
+		fiber_cond_broadcast(&task->cond);
+}
+
 /**
- * Read a page from disk given its number.
- * The function caches two most recently read pages.
- *
- * @retval 0 success
- * @retval -1 critical error
+ * Start reading a page ahead of a run iterator unless it's already
+ * being read or cached. Reading ahead is optional so errors are
+ * silently ignored.
  */
-static NODISCARD int
-vy_run_iterator_load_page(struct vy_run_iterator *itr, uint32_t page_no,
-			  struct vy_entry key, enum iterator_type iterator_type,
-			  struct vy_page **result, uint32_t *pos_in_page,
-			  bool *equal_found)
+static void
+vy_run_iterator_start_read_ahead(struct vy_run_iterator *itr,
+				 uint32_t page_no)
+{
+	struct vy_run *run = itr->slice->run;
+	struct vy_run_env *env = run->env;
+	struct vy_page_read_ahead *task;
+	rlist_foreach_entry(task, &itr->read_ahead, in_iterator) {
+		if (task->page_no == page_no)
+			return;
+	}
+	if (vy_page_cache_get(run, page_no) != NULL)
+		return;
+	task = mempool_alloc(&env->read_ahead_pool);
+	if (task == NULL)
+		return;
+	task->page = vy_page_new(vy_run_page_info(run, page_no));
+	if (task->page == NULL) {
+		diag_clear(diag_get());
+		mempool_free(&env->read_ahead_pool, task);
+		return;
+	}
+	vy_run_ref(run);
+	task->run = run;
+	task->page_no = page_no;
+	task->itr = itr;
+	task->is_done = false;
+	task->is_ok = false;
+	fiber_cond_create(&task->cond);
+	rlist_add_tail_entry(&itr->read_ahead, task, in_iterator);
+
+	struct vy_run_reader *reader = vy_run_env_next_reader(env);
+	task->route[0].f = vy_page_read_ahead_f;
+	task->route[0].pipe = &reader->tx_pipe;
+	task->route[1].f = vy_page_read_ahead_complete_f;
+	task->route[1].pipe = NULL;
+	cmsg_init(&task->base, task->route);
+	cpipe_push(&reader->reader_pipe, &task->base);
+}
+
+/**
+ * Read pages following the given one in the iteration direction
+ * ahead of a run iterator so that disk access and decompression
+ * overlap with processing of the current page.
+ */
+static void
+vy_run_iterator_read_ahead(struct vy_run_iterator *itr, uint32_t page_no)
 {
 	struct vy_slice *slice = itr->slice;
-	struct vy_run_env *env = slice->run->env;
+	/* Reads are blocking during WAL recovery. */
+	if (slice->run->env->reader_pool == NULL)
+		return;
+	int dir = iterator_direction(itr->iterator_type);
+	for (int i = 1; i <= VY_RUN_READ_AHEAD_PAGES; i++) {
+		int64_t next = (int64_t)page_no + i * dir;
+		if (next < slice->first_page_no || next > slice->last_page_no)
+			break;
+		vy_run_iterator_start_read_ahead(itr, next);
+	}
+}
 
-	/* Check cache */
-	struct vy_page *page = NULL;
-	if (itr->curr_page != NULL &&
-	    itr->curr_page->page_no == page_no) {
-		page = itr->curr_page;
-	} else if (itr->prev_page != NULL &&
-		   itr->prev_page->page_no == page_no) {
-		SWAP(itr->prev_page, itr->curr_page);
-		page = itr->curr_page;
+/**
+ * Take a page read ahead by a run iterator, waiting for the read
+ * to complete if necessary. Returns NULL if the page wasn't read
+ * ahead or the read failed.
+ */
+static struct vy_page *
+vy_run_iterator_take_read_ahead(struct vy_run_iterator *itr,
+				uint32_t page_no)
+{
+	struct vy_page_read_ahead *task;
+	rlist_foreach_entry(task, &itr->read_ahead, in_iterator) {
+		if (task->page_no != page_no)
+			continue;
+		bool cancellable = fiber_set_cancellable(false);
+		while (!task->is_done)
+			fiber_cond_wait(&task->cond);
+		fiber_set_cancellable(cancellable);
+		rlist_del_entry(task, in_iterator);
+		struct vy_page *page = NULL;
+		if (task->is_ok) {
+			page = task->page;
+			task->page = NULL;
+		}
+		vy_page_read_ahead_delete(task);
+		return page;
 	}
-	if (page != NULL) {
-		if (key.stmt != NULL)
-			*pos_in_page = vy_page_find_key(page, key, itr->cmp_def,
-							itr->format, iterator_type,
-							equal_found);
-		*result = page;
-		return 0;
+	return NULL;
+}
+
+/**
+ * Abandon all pages read ahead by a run iterator. Requests that
+ * are still in progress are freed when they complete.
+ */
+static void
+vy_run_iterator_cancel_read_ahead(struct vy_run_iterator *itr)
+{
+	struct vy_page_read_ahead *task, *tmp;
+	rlist_foreach_entry_safe(task, &itr->read_ahead, in_iterator, tmp) {
+		rlist_del_entry(task, in_iterator);
+		if (task->is_done)
+			vy_page_read_ahead_delete(task);
+		else
+			task->itr = NULL;
 	}
+}
 
-	/* Allocate buffers */
+/**
+ * Read a page from disk in a reader thread and look up the given
+ * key in it (pass an empty entry to skip the lookup).
+ *
+ * @retval page on success
+ * @retval NULL on error, check diag
+ */
+static struct vy_page *
+vy_run_iterator_read_page(struct vy_run_iterator *itr, uint32_t page_no,
+			  struct vy_entry key, enum iterator_type iterator_type,
+			  uint32_t *pos_in_page, bool *equal_found)
+{
+	struct vy_slice *slice = itr->slice;
+	struct vy_run_env *env = slice->run->env;
 	struct vy_page_info *page_info = vy_run_page_info(slice->run, page_no);
-	page = vy_page_new(page_info);
+
+	/* Allocate buffers */
+	struct vy_page *page = vy_page_new(page_info);
 	if (page == NULL)
-		return -1;
+		return NULL;
 
 	/* Read page data from the disk */
 	struct vy_page_read_task *task = mempool_alloc(&env->read_task_pool);
@@ -1043,7 +1350,7 @@ vy_run_iterator_load_page(struct vy_run_iterator *itr, uint32_t page_no,
 		diag_set(OutOfMemory, sizeof(*task),
 			 "mempool", "vy_page_read_task");
 		vy_page_delete(page);
-		return -1;
+		return NULL;
 	}
 	task->run = slice->run;
 	task->page_info = page_info;
@@ -1063,15 +1370,87 @@ vy_run_iterator_load_page(struct vy_run_iterator *itr, uint32_t page_no,
 	mempool_free(&env->read_task_pool, task);
 	if (rc != 0) {
 		vy_page_delete(page);
-		return -1;
+		return NULL;
+	}
+	return page;
+}
+
+/**
+ * Read a page from disk given its number.
+ * The function caches two most recently read pages in the iterator
+ * and looks up the page in the page cache before going to disk.
+ * If it detects a sequential scan, it also starts reading the next
+ * pages ahead of the iterator.
+ *
+ * @retval 0 success
+ * @retval -1 critical error
+ */
+static NODISCARD int
+vy_run_iterator_load_page(struct vy_run_iterator *itr, uint32_t page_no,
+			  struct vy_entry key, enum iterator_type iterator_type,
+			  struct vy_page **result, uint32_t *pos_in_page,
+			  bool *equal_found)
+{
+	struct vy_slice *slice = itr->slice;
+
+	/* Check cache */
+	struct vy_page *page = NULL;
+	if (itr->curr_page != NULL &&
+	    itr->curr_page->page_no == page_no) {
+		page = itr->curr_page;
+	} else if (itr->prev_page != NULL &&
+		   itr->prev_page->page_no == page_no) {
+		SWAP(itr->prev_page, itr->curr_page);
+		page = itr->curr_page;
+	} else {
+		page = vy_page_cache_get(slice->run, page_no);
+		if (page != NULL) {
+			vy_page_ref(page);
+			if (itr->prev_page != NULL)
+				vy_page_unref(itr->prev_page);
+			itr->prev_page = itr->curr_page;
+			itr->curr_page = page;
+		}
+	}
+	if (page != NULL) {
+		if (key.stmt != NULL)
+			*pos_in_page = vy_page_find_key(page, key, itr->cmp_def,
+							itr->format, iterator_type,
+							equal_found);
+		*result = page;
+		return 0;
+	}
+
+	/*
+	 * The scan is sequential if the page follows the current
+	 * page in the iteration direction.
+	 */
+	int dir = iterator_direction(itr->iterator_type);
+	bool is_sequential = itr->curr_page != NULL &&
+			     (int64_t)itr->curr_page->page_no + dir == page_no;
+
+	struct vy_page_info *page_info = vy_run_page_info(slice->run, page_no);
+	page = vy_run_iterator_take_read_ahead(itr, page_no);
+	if (page != NULL) {
+		if (key.stmt != NULL)
+			*pos_in_page = vy_page_find_key(page, key, itr->cmp_def,
+							itr->format, iterator_type,
+							equal_found);
+	} else {
+		page = vy_run_iterator_read_page(itr, page_no, key,
+						 iterator_type, pos_in_page,
+						 equal_found);
+		if (page == NULL)
+			return -1;
 	}
 
 	/* Update cache */
 	if (itr->prev_page != NULL)
-		vy_page_delete(itr->prev_page);
+		vy_page_unref(itr->prev_page);
 	itr->prev_page = itr->curr_page;
 	itr->curr_page = page;
 	page->page_no = page_no;
+	vy_page_cache_put(slice->run, page);
 
 	/* Update read statistics. */
 	itr->stat->read.rows += page_info->row_count;
@@ -1079,6 +1458,9 @@ vy_run_iterator_load_page(struct vy_run_iterator *itr, uint32_t page_no,
 	itr->stat->read.bytes_compressed += page_info->size;
 	itr->stat->read.pages++;
 
+	if (is_sequential)
+		vy_run_iterator_read_ahead(itr, page_no);
+
 	*result = page;
 	return 0;
 }
@@ -1331,6 +1713,51 @@ vy_run_iterator_do_seek(struct vy_run_iterator *itr,
 	}
 }
 
+/**
+ * Compare a key with a raw key stored in the run info.
+ */
+static int
+vy_run_info_compare_key(struct vy_entry key, const char *run_key,
+			struct key_def *cmp_def)
+{
+	const char *data = run_key;
+	uint32_t part_count = mp_decode_array(&data);
+	hint_t hint = key_hint(data, part_count, cmp_def);
+	return vy_entry_compare_with_raw_key(key, run_key, hint, cmp_def);
+}
+
+/**
+ * Check if a run may have statements satisfying the given search
+ * criteria judging by the min and max keys of the run. This lets
+ * us skip a run without reading any of its pages if the search key
+ * is beyond the run boundaries, which is common for scans over
+ * a key prefix, because in this case the page index lookup would
+ * still point to the first or the last page of the run.
+ */
+static bool
+vy_run_may_have_key(struct vy_run *run, enum iterator_type iterator_type,
+		    struct vy_entry key, struct key_def *cmp_def)
+{
+	if (vy_stmt_is_empty_key(key.stmt) || run->info.min_key == NULL)
+		return true;
+	assert(run->info.max_key != NULL);
+	if (iterator_type == ITER_EQ || iterator_type == ITER_GE ||
+	    iterator_type == ITER_GT) {
+		int cmp = vy_run_info_compare_key(key, run->info.max_key,
+						  cmp_def);
+		if (cmp > 0 || (cmp == 0 && iterator_type == ITER_GT))
+			return false;
+	}
+	if (iterator_type == ITER_EQ || iterator_type == ITER_LE ||
+	    iterator_type == ITER_LT) {
+		int cmp = vy_run_info_compare_key(key, run->info.min_key,
+						  cmp_def);
+		if (cmp < 0 || (cmp == 0 && iterator_type == ITER_LT))
+			return false;
+	}
+	return true;
+}
+
 /**
  * Position the iterator to the first statement satisfying
  * the iterator search criteria and following the given key
@@ -1426,6 +1853,10 @@ vy_run_iterator_seek(struct vy_run_iterator *itr, struct vy_entry last,
 		}
 	}
 
+	/* Skip the run if the key is beyond its boundaries. */
+	if (!vy_run_may_have_key(slice->run, iterator_type, key, cmp_def))
+		goto not_found;
+
 	/* Perform a lookup in the run. */
 	itr->stat->lookup++;
 	int rc = vy_run_iterator_do_seek(itr, iterator_type, key);
@@ -1484,6 +1915,8 @@ vy_run_iterator_open(struct vy_run_iterator *itr,
 	itr->curr_page = NULL;
 	itr->prev_page = NULL;
 	itr->search_started = false;
+	itr->keep_pages = false;
+	rlist_create(&itr->read_ahead);
 
 	/*
 	 * Make sure the format we use to create tuples won't
@@ -1632,9 +2065,24 @@ vy_run_iterator_skip(struct vy_run_iterator *itr, struct vy_entry last,
 	return 0;
 }
 
+void
+vy_run_iterator_reset(struct vy_run_iterator *itr, struct vy_entry key)
+{
+	assert(itr->iterator_type == ITER_EQ);
+	itr->keep_pages = true;
+	if (itr->curr.stmt != NULL) {
+		tuple_unref(itr->curr.stmt);
+		itr->curr = vy_entry_none();
+	}
+	itr->key = key;
+	itr->curr_pos.page_no = itr->slice->run->info.page_count;
+	itr->search_started = false;
+}
+
 void
 vy_run_iterator_close(struct vy_run_iterator *itr)
 {
+	itr->keep_pages = false;
 	vy_run_iterator_stop(itr);
 	tuple_format_unref(itr->format);
 	TRASH(itr);
@@ -2061,7 +2509,9 @@ vy_run_write_index(struct vy_run *run, const char *dirpath,
 			 NULL, NULL);
 	struct xlog_opts opts = xlog_opts_default;
 	opts.rate_limit = run->env->snap_io_rate_limit;
+	opts.rate_factor_f = run->env->snap_io_rate_factor_f;
 	opts.sync_interval = VY_RUN_SYNC_INTERVAL;
+	opts.compression_level = run->env->compression_level;
 	if (xlog_create(&index_xlog, path, 0, &meta, &opts) < 0)
 		return -1;
 
@@ -2159,7 +2609,9 @@ vy_run_writer_create_xlog(struct vy_run_writer *writer)
 			 NULL, NULL);
 	struct xlog_opts opts = xlog_opts_default;
 	opts.rate_limit = writer->run->env->snap_io_rate_limit;
+	opts.rate_factor_f = writer->run->env->snap_io_rate_factor_f;
 	opts.sync_interval = VY_RUN_SYNC_INTERVAL;
+	opts.compression_level = writer->run->env->compression_level;
 	opts.no_compression = writer->no_compression;
 	if (xlog_create(&writer->data_xlog, path, 0, &meta, &opts) != 0)
 		return -1;
@@ -56,8 +56,14 @@ struct vy_run_reader;
 struct vy_run_env {
 	/** Write rate limit, in bytes per second. */
 	uint64_t snap_io_rate_limit;
+	/** Write rate factor, see xlog_opts::rate_factor_f. */
+	double (*snap_io_rate_factor_f)(void);
+	/** zstd compression level used for run files. */
+	int compression_level;
 	/** Mempool for struct vy_page_read_task */
 	struct mempool read_task_pool;
+	/** Mempool for struct vy_page_read_ahead */
+	struct mempool read_ahead_pool;
 	/** Key for thread-local ZSTD context */
 	pthread_key_t zdctx_key;
 	/** Pool of threads used for reading run files. */
@@ -74,6 +80,16 @@ struct vy_run_env {
 	 * unconditionally remove unused runs' files in-place.
 	 */
 	bool initial_join;
+	/**
+	 * Decompressed pages kept in memory so that repeated reads
+	 * of the same page don't go to disk, linked by vy_page::in_lru
+	 * in the order of access, the least recently used first.
+	 */
+	struct rlist page_cache_lru;
+	/** Memory used by cached pages, in bytes. */
+	size_t page_cache_used;
+	/** Max memory that may be used by cached pages, in bytes. */
+	size_t page_cache_quota;
 };
 
 /**
@@ -126,6 +142,11 @@ struct vy_run {
 	struct vy_run_info info;
 	/** Info about the run pages stored in the index file. */
 	struct vy_page_info *page_info;
+	/**
+	 * Pages of this run stored in the page cache, indexed by
+	 * page number, or NULL if none has been cached yet.
+	 */
+	struct vy_page **cached_pages;
 	/** Run data file. */
 	int fd;
 	/** Unique ID of this run. */
@@ -286,12 +307,33 @@ struct vy_run_iterator {
 	struct vy_page *prev_page;
 	/** Is false until first .._get or .._next_.. method is called */
 	bool search_started;
+	/**
+	 * Set if the iterator is reused for looking up several
+	 * keys, see vy_run_iterator_reset(). The pages read so far
+	 * aren't freed when the iterator stops then.
+	 */
+	bool keep_pages;
+	/**
+	 * Pages that are being read ahead by reader threads,
+	 * linked by vy_page_read_ahead::in_iterator. Populated
+	 * when the iterator detects a sequential scan.
+	 */
+	struct rlist read_ahead;
 };
 
 /**
  * Vinyl page stored in memory.
  */
 struct vy_page {
+	/**
+	 * Number of run iterators using the page plus one if it
+	 * is stored in the page cache.
+	 */
+	int refs;
+	/** Run the page belongs to if it is stored in the page cache. */
+	struct vy_run *run;
+	/** Link in vy_run_env::page_cache_lru. */
+	struct rlist in_lru;
 	/** Page position in the run file. */
 	uint32_t page_no;
 	/** Size of page data in memory, i.e. unpacked. */
@@ -320,6 +362,13 @@ vy_run_env_create(struct vy_run_env *env, int read_threads);
 void
 vy_run_env_destroy(struct vy_run_env *env);
 
+/**
+ * Set the max amount of memory that may be used for caching
+ * decompressed run pages. Zero disables the cache.
+ */
+void
+vy_run_env_set_page_cache_quota(struct vy_run_env *env, size_t quota);
+
 /**
  * Enable coio reads for a vinyl run environment.
  *
@@ -547,6 +596,15 @@ NODISCARD int
 vy_run_iterator_skip(struct vy_run_iterator *itr, struct vy_entry last,
 		     struct vy_history *history);
 
+/**
+ * Reposition an EQ run iterator to look up another key. The last
+ * two pages read by the iterator are kept until it's closed, so
+ * looking up keys in ascending order reads and decompresses each
+ * page only once.
+ */
+void
+vy_run_iterator_reset(struct vy_run_iterator *itr, struct vy_entry key);
+
 /**
  * Close a run iterator.
  */
@@ -59,6 +59,7 @@
 #include "vy_run.h"
 #include "vy_write_iterator.h"
 #include "trivia/util.h"
+#include "trivia/probe.h"
 
 /* Min and max values for vy_scheduler::timeout. */
 #define VY_SCHEDULER_TIMEOUT_MIN	1
@@ -1120,12 +1121,17 @@ static int
 vy_task_dump_execute(struct vy_task *task)
 {
 	ERROR_INJECT_SLEEP(ERRINJ_VY_DUMP_DELAY);
+	TT_PROBE(vy_dump_begin, task->lsm->space_id, task->lsm->index_id,
+		 task->new_run->id);
 	/*
 	 * Don't compress L1 runs as they are most frequently read
 	 * and smallest runs at the same time and so we would gain
 	 * nothing by compressing them.
 	 */
-	return vy_task_write_run(task, true);
+	int rc = vy_task_write_run(task, true);
+	TT_PROBE(vy_dump_end, task->lsm->space_id, task->lsm->index_id,
+		 task->new_run->id, rc);
+	return rc;
 }
 
 static int
@@ -1346,6 +1352,16 @@ vy_task_dump_new(struct vy_scheduler *scheduler, struct vy_worker *worker,
 	/*
 	 * Wait until all active writes to in-memory trees
 	 * eligible for dump are over.
+	 *
+	 * Writers don't wait here: they insert into the new active
+	 * tree created by the rotation above. A tree is pinned by
+	 * a transaction only from prepare until its WAL write is
+	 * complete (see vy_tx_prepare()), not for the lifetime of
+	 * the transaction, so the wait is bounded by the WAL
+	 * latency. Skipping a pinned LSM tree and dumping another
+	 * one meanwhile isn't an option, because the primary index
+	 * of a space must not be dumped before its secondary
+	 * indexes, see vy_dump_heap_less().
 	 */
 	int64_t dump_lsn = -1;
 	struct vy_mem *mem, *next_mem;
@@ -1443,7 +1459,12 @@ static int
 vy_task_compaction_execute(struct vy_task *task)
 {
 	ERROR_INJECT_SLEEP(ERRINJ_VY_COMPACTION_DELAY);
-	return vy_task_write_run(task, false);
+	TT_PROBE(vy_compaction_begin, task->lsm->space_id,
+		 task->lsm->index_id, task->new_run->id);
+	int rc = vy_task_write_run(task, false);
+	TT_PROBE(vy_compaction_end, task->lsm->space_id,
+		 task->lsm->index_id, task->new_run->id, rc);
+	return rc;
 }
 
 static int
@@ -58,12 +58,22 @@ struct iovec;
 #define MAX_LSN (INT64_MAX / 2)
 
 enum {
+	/**
+	 * Default number of successive upserts for the same key
+	 * in a mem after which they are squashed in background.
+	 * @see box.cfg.vinyl_upsert_squash_threshold
+	 */
 	VY_UPSERT_THRESHOLD = 128,
-	VY_UPSERT_INF,
+	/** Max allowed value of the upsert squash threshold. */
+	VY_UPSERT_THRESHOLD_MAX = UINT8_MAX - 1,
+	/**
+	 * Value of n_upserts of an upsert that follows a chain of
+	 * upserts for which a squashing task has already started.
+	 */
+	VY_UPSERT_INF = UINT8_MAX,
 };
-static_assert(VY_UPSERT_THRESHOLD <= UINT8_MAX, "n_upserts max value");
-static_assert(VY_UPSERT_INF == VY_UPSERT_THRESHOLD + 1,
-	      "inf must be threshold + 1");
+static_assert(VY_UPSERT_THRESHOLD <= VY_UPSERT_THRESHOLD_MAX,
+	      "n_upserts max value");
 
 /** Vinyl statement environment. */
 struct vy_stmt_env {
@@ -1045,6 +1045,24 @@ vy_tx_track_point(struct vy_tx *tx, struct vy_lsm *lsm, struct vy_entry entry)
 	return vy_tx_track(tx, lsm, entry, true, entry, true);
 }
 
+/**
+ * Find the statement of a transaction overwritten by a new one.
+ * Large transactions often write keys in ascending order, so the
+ * last statement of the write set is checked first: if the new key
+ * is greater, there's nothing to overwrite and the tree lookup is
+ * skipped. Finding the last statement takes no comparisons.
+ */
+static struct txv *
+vy_tx_find_overwritten(struct vy_tx *tx, struct vy_lsm *lsm,
+		       struct vy_entry entry)
+{
+	struct write_set_key key = { .lsm = lsm, .entry = entry };
+	struct txv *last = write_set_last(&tx->write_set);
+	if (last == NULL || write_set_key_cmp(&key, last) > 0)
+		return NULL;
+	return write_set_search(&tx->write_set, &key);
+}
+
 /**
  * Add one statement entry to a transaction. We add one entry
  * for each index, and with multikey indexes it is possible there
@@ -1061,7 +1079,7 @@ vy_tx_set_entry(struct vy_tx *tx, struct vy_lsm *lsm, struct vy_entry entry)
 	vy_stmt_set_lsn(entry.stmt, INT64_MAX);
 	struct vy_entry applied = vy_entry_none();
 
-	struct txv *old = write_set_search_key(&tx->write_set, lsm, entry);
+	struct txv *old = vy_tx_find_overwritten(tx, lsm, entry);
 	/* Found a match of the previous action of this transaction */
 	if (old != NULL && vy_stmt_type(entry.stmt) == IPROTO_UPSERT) {
 		assert(lsm->index_id == 0);
@@ -31,6 +31,7 @@
 #include "wal.h"
 
 #include "fiber.h"
+#include "clock.h"
 #include "fio.h"
 #include "errinj.h"
 #include "error.h"
@@ -42,6 +43,12 @@
 #include "cbus.h"
 #include "coio_task.h"
 #include "replication.h"
+#include "histogram.h"
+#include "info/info.h"
+#include "trivia/probe.h"
+
+#include <fcntl.h>
+#include <pmatomic.h>
 
 enum {
 	/**
@@ -55,12 +62,38 @@ enum {
 	WAL_FALLOCATE_LEN = 1024 * 1024,
 };
 
+enum {
+	/** Background write rate factor of 1, in fixed point. */
+	WAL_RATE_FACTOR_MAX = 1024,
+	/** Min background write rate factor, 1/64. */
+	WAL_RATE_FACTOR_MIN = WAL_RATE_FACTOR_MAX / 64,
+	/** Background write rate factor increment, 1/16. */
+	WAL_RATE_FACTOR_STEP = WAL_RATE_FACTOR_MAX / 16,
+};
+
+/**
+ * How often the background write rate factor is adjusted to
+ * the WAL write latency, in seconds.
+ */
+static const double WAL_RATE_PERIOD = 0.1;
+
+/**
+ * If WAL hasn't written anything for this long, in seconds,
+ * background writers aren't slowed down.
+ */
+static const double WAL_RATE_IDLE_TIMEOUT = 1;
+
 const char *wal_mode_STRS[WAL_MODE_MAX] = {
 	[WAL_NONE]	= "none",
 	[WAL_WRITE]	= "write",
 	[WAL_FSYNC]	= "fsync",
 };
 
+const char *wal_io_mode_STRS[WAL_IO_MODE_MAX] = {
+	[WAL_IO_BUFFERED]	= "buffered",
+	[WAL_IO_DSYNC]		= "dsync",
+};
+
 int wal_dir_lock = -1;
 
 static int
@@ -75,6 +108,37 @@ wal_write_none_async(struct journal *, struct journal_entry *);
 static int
 wal_write_none(struct journal *, struct journal_entry *);
 
+enum {
+	/** Max number of batches kept in memory for relays. */
+	WAL_MEM_BATCH_MAX = 4096,
+	/** Max total size of batches kept in memory for relays. */
+	WAL_MEM_SIZE_MAX = 32 * 1024 * 1024,
+};
+
+/**
+ * Ring of batches recently written to WAL, see wal_mem_find().
+ * Filled by the WAL thread, read by relay threads.
+ */
+struct wal_mem {
+	/** Protects the batches and the sequence numbers. */
+	pthread_mutex_t mutex;
+	/** Batch with sequence number N is stored at N % MAX. */
+	struct wal_mem_batch *batches[WAL_MEM_BATCH_MAX];
+	/** Sequence number of the oldest batch kept in memory. */
+	int64_t first_seq;
+	/** Sequence number of the next batch to be written. */
+	int64_t next_seq;
+	/** Total size of batches kept in memory. */
+	size_t size;
+	/** Number of readers, updated atomically. */
+	int reader_count;
+	/**
+	 * Set if the next batch is going to be the first one
+	 * in a new WAL file. Accessed only by the WAL thread.
+	 */
+	bool is_new_file;
+};
+
 /*
  * WAL writer - maintain a Write Ahead Log for every change
  * in the data state.
@@ -112,6 +176,13 @@ struct wal_writer
 	int64_t wal_max_size;
 	/** Another one - wal_mode */
 	enum wal_mode wal_mode;
+	/**
+	 * Set if wal_mode is 'fsync' and WAL files are opened
+	 * with O_DSYNC, see box.cfg.wal_io_mode. Writes are
+	 * synced by the kernel then, so the writer doesn't call
+	 * fdatasync() after each batch.
+	 */
+	bool is_dsync;
 	/** wal_dir, from the configuration file. */
 	struct xdir wal_dir;
 	/** 'wal' thread doing the writes. */
@@ -170,6 +241,60 @@ struct wal_writer
 	 * Used for replication relays.
 	 */
 	struct rlist watchers;
+	/**
+	 * Max time the WAL thread may wait for more requests
+	 * to merge them into a single write, in seconds.
+	 * 0 disables group commit, see wal_write_group().
+	 */
+	double group_commit_delay;
+	/**
+	 * Approximate size of merged requests that ends the
+	 * group commit window.
+	 */
+	int64_t group_commit_max_size;
+	/**
+	 * Set if the last group commit window expired without
+	 * collecting a single extra request, i.e. there's only
+	 * one writer and waiting for others just adds latency.
+	 * The next batch is written right away unless there's
+	 * a backlog of requests to merge.
+	 */
+	bool group_commit_is_idle;
+	/** Number of writes to disk, for box.stat.wal(). */
+	int64_t write_count;
+	/** Number of requests written to disk. */
+	int64_t entry_count;
+	/** Number of bytes written to disk. */
+	int64_t write_bytes;
+	/** Histogram of the number of requests per write. */
+	struct histogram *batch_hist;
+	/** Recently written rows read by relays. */
+	struct wal_mem mem;
+	/**
+	 * Target latency of a write to disk, in seconds, see
+	 * box.cfg.snap_io_latency_target. 0 if disabled.
+	 */
+	double latency_target;
+	/** Max latency of a write seen in the current period. */
+	double latency_max;
+	/** Time when the current period started. */
+	double latency_period_start;
+	/**
+	 * Factor by which background writers must reduce their
+	 * write rate, in 1/WAL_RATE_FACTOR_MAX units. Read from
+	 * other threads, see wal_background_rate_factor().
+	 */
+	uint32_t rate_factor;
+	/**
+	 * clock_monotonic64() of the last write to disk. Read from
+	 * other threads, see wal_background_rate_factor().
+	 */
+	uint64_t last_write_time;
+	/**
+	 * Set while the spare WAL file is being created in
+	 * background, see wal_create_spare().
+	 */
+	bool spare_in_progress;
 };
 
 struct wal_msg {
@@ -185,6 +310,12 @@ struct wal_msg {
 	struct stailq rollback;
 	/** vclock after the batch processed. */
 	struct vclock vclock;
+	/**
+	 * Set if the requests of this batch were moved to
+	 * a preceding batch by group commit, so there's nothing
+	 * to write.
+	 */
+	bool is_merged;
 };
 
 /**
@@ -229,6 +360,7 @@ wal_msg_create(struct wal_msg *batch)
 	stailq_create(&batch->commit);
 	stailq_create(&batch->rollback);
 	vclock_create(&batch->vclock);
+	batch->is_merged = false;
 }
 
 static struct wal_msg *
@@ -406,6 +538,208 @@ tx_notify_checkpoint(struct cmsg *msg)
 	free(msg);
 }
 
+/* {{{ WAL rows kept in memory for relays */
+
+static void
+wal_mem_batch_delete(struct wal_mem_batch *batch)
+{
+	free(batch->data);
+	free(batch);
+}
+
+void
+wal_mem_batch_unref(struct wal_mem_batch *batch)
+{
+	assert(pm_atomic_load(&batch->refs) > 0);
+	if (pm_atomic_fetch_sub(&batch->refs, 1) == 1)
+		wal_mem_batch_delete(batch);
+}
+
+/**
+ * Encode the rows of the given journal entries into a new batch.
+ * Returns NULL on memory allocation error: the batch is skipped
+ * then and relays read it from the file.
+ */
+static struct wal_mem_batch *
+wal_mem_batch_new(const struct vclock *vclock, bool is_new_file,
+		  struct stailq *entries, size_t approx_len)
+{
+	struct wal_mem_batch *batch = malloc(sizeof(*batch));
+	if (batch == NULL)
+		return NULL;
+	size_t capacity = MAX(approx_len, (size_t)1024);
+	batch->data = malloc(capacity);
+	if (batch->data == NULL)
+		goto fail;
+	batch->size = 0;
+	struct journal_entry *entry;
+	stailq_foreach_entry(entry, entries, fifo) {
+		for (int i = 0; i < entry->n_rows; i++) {
+			struct iovec iov[XROW_IOVMAX];
+			int iovcnt = xrow_header_encode(entry->rows[i], 0,
+							iov, 0);
+			if (iovcnt < 0) {
+				diag_clear(diag_get());
+				goto fail;
+			}
+			for (int j = 0; j < iovcnt; j++) {
+				size_t len = iov[j].iov_len;
+				if (batch->size + len > capacity) {
+					capacity = MAX(batch->size + len,
+						       2 * capacity);
+					char *data = realloc(batch->data,
+							     capacity);
+					if (data == NULL)
+						goto fail;
+					batch->data = data;
+				}
+				memcpy(batch->data + batch->size,
+				       iov[j].iov_base, len);
+				batch->size += len;
+			}
+		}
+	}
+	batch->refs = 1;
+	batch->is_new_file = is_new_file;
+	vclock_copy(&batch->vclock, vclock);
+	return batch;
+fail:
+	free(batch->data);
+	free(batch);
+	return NULL;
+}
+
+static void
+wal_mem_create(struct wal_mem *mem)
+{
+	tt_pthread_mutex_init(&mem->mutex, NULL);
+	memset(mem->batches, 0, sizeof(mem->batches));
+	mem->first_seq = 0;
+	mem->next_seq = 0;
+	mem->size = 0;
+	mem->reader_count = 0;
+	mem->is_new_file = false;
+}
+
+/**
+ * Drop the oldest batch kept in memory. The batch is freed when
+ * the readers release it. Called with the mutex locked.
+ */
+static void
+wal_mem_drop_first(struct wal_mem *mem)
+{
+	assert(mem->first_seq < mem->next_seq);
+	struct wal_mem_batch **slot =
+		&mem->batches[mem->first_seq % WAL_MEM_BATCH_MAX];
+	mem->size -= (*slot)->size;
+	wal_mem_batch_unref(*slot);
+	*slot = NULL;
+	mem->first_seq++;
+}
+
+static void
+wal_mem_destroy(struct wal_mem *mem)
+{
+	while (mem->first_seq < mem->next_seq)
+		wal_mem_drop_first(mem);
+	tt_pthread_mutex_destroy(&mem->mutex);
+}
+
+/**
+ * Keep the rows of committed journal entries in memory for relays.
+ * @a vclock is the WAL vclock before the entries were written.
+ * Called by the WAL thread after each write to disk.
+ */
+static void
+wal_mem_append(struct wal_mem *mem, const struct vclock *vclock,
+	       struct stailq *entries, size_t approx_len)
+{
+	bool is_new_file = mem->is_new_file;
+	mem->is_new_file = false;
+	struct wal_mem_batch *batch = NULL;
+	if (pm_atomic_load(&mem->reader_count) > 0 && !stailq_empty(entries))
+		batch = wal_mem_batch_new(vclock, is_new_file, entries,
+					  approx_len);
+	tt_pthread_mutex_lock(&mem->mutex);
+	if (batch == NULL) {
+		/*
+		 * Nobody reads from memory or the batch couldn't be
+		 * created. Drop all batches and skip the sequence number
+		 * so that a reader that has just attached doesn't miss
+		 * the rows of this batch.
+		 */
+		while (mem->first_seq < mem->next_seq)
+			wal_mem_drop_first(mem);
+		mem->next_seq++;
+		mem->first_seq = mem->next_seq;
+	} else {
+		while (mem->first_seq < mem->next_seq &&
+		       (mem->next_seq - mem->first_seq >= WAL_MEM_BATCH_MAX ||
+			mem->size + batch->size > WAL_MEM_SIZE_MAX))
+			wal_mem_drop_first(mem);
+		mem->batches[mem->next_seq % WAL_MEM_BATCH_MAX] = batch;
+		mem->size += batch->size;
+		mem->next_seq++;
+	}
+	tt_pthread_mutex_unlock(&mem->mutex);
+}
+
+void
+wal_mem_attach(void)
+{
+	pm_atomic_fetch_add(&wal_writer_singleton.mem.reader_count, 1);
+}
+
+void
+wal_mem_detach(void)
+{
+	pm_atomic_fetch_sub(&wal_writer_singleton.mem.reader_count, 1);
+}
+
+int64_t
+wal_mem_find(const struct vclock *vclock)
+{
+	struct wal_mem *mem = &wal_writer_singleton.mem;
+	tt_pthread_mutex_lock(&mem->mutex);
+	/*
+	 * Batch vclocks only grow so the batches that may be used
+	 * go first and we can use binary search.
+	 */
+	int64_t begin = mem->first_seq;
+	int64_t end = mem->next_seq;
+	while (begin < end) {
+		int64_t mid = begin + (end - begin) / 2;
+		struct wal_mem_batch *batch =
+			mem->batches[mid % WAL_MEM_BATCH_MAX];
+		if (vclock_compare_ignore0(&batch->vclock, vclock) <= 0)
+			begin = mid + 1;
+		else
+			end = mid;
+	}
+	int64_t seq = begin > mem->first_seq ? begin - 1 : -1;
+	tt_pthread_mutex_unlock(&mem->mutex);
+	return seq;
+}
+
+struct wal_mem_batch *
+wal_mem_get(int64_t seq, bool *is_lost)
+{
+	struct wal_mem *mem = &wal_writer_singleton.mem;
+	struct wal_mem_batch *batch = NULL;
+	*is_lost = false;
+	tt_pthread_mutex_lock(&mem->mutex);
+	if (seq < mem->first_seq) {
+		*is_lost = true;
+	} else if (seq < mem->next_seq) {
+		batch = mem->batches[seq % WAL_MEM_BATCH_MAX];
+		pm_atomic_fetch_add(&batch->refs, 1);
+	}
+	tt_pthread_mutex_unlock(&mem->mutex);
+	return batch;
+}
+
+/* }}} */
+
 /**
  * Initialize WAL writer context. Even though it's a singleton,
  * encapsulate the details just in case we may use
@@ -413,8 +747,9 @@ tx_notify_checkpoint(struct cmsg *msg)
  */
 static void
 wal_writer_create(struct wal_writer *writer, enum wal_mode wal_mode,
+		  enum wal_io_mode wal_io_mode,
 		  const char *wal_dirname, int64_t wal_max_size,
-		  const struct tt_uuid *instance_uuid,
+		  int compression_level, const struct tt_uuid *instance_uuid,
 		  wal_on_garbage_collection_f on_garbage_collection,
 		  wal_on_checkpoint_threshold_f on_checkpoint_threshold)
 {
@@ -429,10 +764,13 @@ wal_writer_create(struct wal_writer *writer, enum wal_mode wal_mode,
 
 	struct xlog_opts opts = xlog_opts_default;
 	opts.sync_is_async = true;
+	opts.compression_level = compression_level;
 	xdir_create(&writer->wal_dir, wal_dirname, XLOG, instance_uuid, &opts);
 	xlog_clear(&writer->current_wal);
-	if (wal_mode == WAL_FSYNC)
-		writer->wal_dir.open_wflags |= O_SYNC;
+	writer->is_dsync = wal_mode == WAL_FSYNC &&
+			   wal_io_mode == WAL_IO_DSYNC;
+	if (writer->is_dsync)
+		writer->wal_dir.open_wflags |= O_DSYNC;
 
 	stailq_create(&writer->rollback);
 	writer->is_in_rollback = false;
@@ -443,7 +781,28 @@ wal_writer_create(struct wal_writer *writer, enum wal_mode wal_mode,
 
 	vclock_create(&writer->vclock);
 	vclock_create(&writer->checkpoint_vclock);
+
+	writer->group_commit_delay = 0;
+	writer->group_commit_max_size = 0;
+	writer->group_commit_is_idle = false;
+	writer->write_count = 0;
+	writer->entry_count = 0;
+	writer->write_bytes = 0;
+	writer->latency_target = 0;
+	writer->latency_max = 0;
+	writer->latency_period_start = 0;
+	writer->rate_factor = WAL_RATE_FACTOR_MAX;
+	writer->last_write_time = 0;
+	static const int64_t batch_buckets[] = {
+		1, 2, 3, 4, 5, 10, 20, 50, 100, 200, 500, 1000, 10000,
+	};
+	writer->batch_hist = histogram_new(batch_buckets,
+					   lengthof(batch_buckets));
+	if (writer->batch_hist == NULL)
+		panic("failed to allocate WAL batch histogram");
+
 	rlist_create(&writer->watchers);
+	wal_mem_create(&writer->mem);
 
 	writer->on_garbage_collection = on_garbage_collection;
 	writer->on_checkpoint_threshold = on_checkpoint_threshold;
@@ -457,6 +816,8 @@ static void
 wal_writer_destroy(struct wal_writer *writer)
 {
 	xdir_destroy(&writer->wal_dir);
+	histogram_delete(writer->batch_hist);
+	wal_mem_destroy(&writer->mem);
 }
 
 /** WAL writer thread routine. */
@@ -533,15 +894,17 @@ wal_open(struct wal_writer *writer)
 }
 
 int
-wal_init(enum wal_mode wal_mode, const char *wal_dirname,
-	 int64_t wal_max_size, const struct tt_uuid *instance_uuid,
+wal_init(enum wal_mode wal_mode, enum wal_io_mode wal_io_mode,
+	 const char *wal_dirname, int64_t wal_max_size, int compression_level,
+	 const struct tt_uuid *instance_uuid,
 	 wal_on_garbage_collection_f on_garbage_collection,
 	 wal_on_checkpoint_threshold_f on_checkpoint_threshold)
 {
 	/* Initialize the state. */
 	struct wal_writer *writer = &wal_writer_singleton;
-	wal_writer_create(writer, wal_mode, wal_dirname, wal_max_size,
-			  instance_uuid, on_garbage_collection,
+	wal_writer_create(writer, wal_mode, wal_io_mode, wal_dirname,
+			  wal_max_size, compression_level, instance_uuid,
+			  on_garbage_collection,
 			  on_checkpoint_threshold);
 
 	/* Start WAL thread. */
@@ -554,6 +917,12 @@ wal_init(enum wal_mode wal_mode, const char *wal_dirname,
 	return 0;
 }
 
+int
+wal_set_cpu_affinity(const char *cpus)
+{
+	return cord_set_cpu_affinity(&wal_writer_singleton.cord, cpus);
+}
+
 int
 wal_enable(void)
 {
@@ -771,6 +1140,153 @@ wal_set_checkpoint_threshold(int64_t threshold)
 	fiber_set_cancellable(cancellable);
 }
 
+struct wal_set_group_commit_msg {
+	struct cbus_call_msg base;
+	double delay;
+	int64_t max_size;
+};
+
+static int
+wal_set_group_commit_f(struct cbus_call_msg *data)
+{
+	struct wal_writer *writer = &wal_writer_singleton;
+	struct wal_set_group_commit_msg *msg;
+	msg = (struct wal_set_group_commit_msg *)data;
+	writer->group_commit_delay = msg->delay;
+	writer->group_commit_max_size = msg->max_size;
+	writer->group_commit_is_idle = false;
+	return 0;
+}
+
+void
+wal_set_group_commit(double delay, int64_t max_size)
+{
+	struct wal_writer *writer = &wal_writer_singleton;
+	if (writer->wal_mode == WAL_NONE)
+		return;
+	struct wal_set_group_commit_msg msg;
+	msg.delay = delay;
+	msg.max_size = max_size;
+	bool cancellable = fiber_set_cancellable(false);
+	cbus_call(&writer->wal_pipe, &writer->tx_prio_pipe,
+		  &msg.base, wal_set_group_commit_f, NULL,
+		  TIMEOUT_INFINITY);
+	fiber_set_cancellable(cancellable);
+}
+
+struct wal_set_latency_target_msg {
+	struct cbus_call_msg base;
+	double latency_target;
+};
+
+static int
+wal_set_latency_target_f(struct cbus_call_msg *data)
+{
+	struct wal_writer *writer = &wal_writer_singleton;
+	struct wal_set_latency_target_msg *msg;
+	msg = (struct wal_set_latency_target_msg *)data;
+	writer->latency_target = msg->latency_target;
+	writer->latency_max = 0;
+	writer->latency_period_start = ev_monotonic_now(loop());
+	pm_atomic_store(&writer->rate_factor, WAL_RATE_FACTOR_MAX);
+	return 0;
+}
+
+void
+wal_set_latency_target(double target)
+{
+	struct wal_writer *writer = &wal_writer_singleton;
+	if (writer->wal_mode == WAL_NONE)
+		return;
+	struct wal_set_latency_target_msg msg;
+	msg.latency_target = target;
+	bool cancellable = fiber_set_cancellable(false);
+	cbus_call(&writer->wal_pipe, &writer->tx_prio_pipe,
+		  &msg.base, wal_set_latency_target_f, NULL,
+		  TIMEOUT_INFINITY);
+	fiber_set_cancellable(cancellable);
+}
+
+double
+wal_background_rate_factor(void)
+{
+	struct wal_writer *writer = &wal_writer_singleton;
+	uint64_t last_write_time = pm_atomic_load(&writer->last_write_time);
+	if (clock_monotonic64() - last_write_time >
+	    (uint64_t)(WAL_RATE_IDLE_TIMEOUT * 1e9))
+		return 1;
+	return (double)pm_atomic_load(&writer->rate_factor) /
+	       WAL_RATE_FACTOR_MAX;
+}
+
+/**
+ * Account the latency of a write to disk and adjust the rate
+ * factor of background writers: halve it if a write in the last
+ * period took longer than the target, increase it otherwise.
+ */
+static void
+wal_update_rate_factor(struct wal_writer *writer, double latency)
+{
+	pm_atomic_store(&writer->last_write_time, clock_monotonic64());
+	if (writer->latency_target == 0)
+		return;
+	writer->latency_max = MAX(writer->latency_max, latency);
+	double now = ev_monotonic_now(loop());
+	if (now - writer->latency_period_start < WAL_RATE_PERIOD)
+		return;
+	uint32_t factor = pm_atomic_load(&writer->rate_factor);
+	if (writer->latency_max > writer->latency_target)
+		factor = MAX(factor / 2, (uint32_t)WAL_RATE_FACTOR_MIN);
+	else
+		factor = MIN(factor + WAL_RATE_FACTOR_STEP,
+			     (uint32_t)WAL_RATE_FACTOR_MAX);
+	pm_atomic_store(&writer->rate_factor, factor);
+	writer->latency_max = 0;
+	writer->latency_period_start = now;
+}
+
+struct wal_stat_msg {
+	struct cbus_call_msg base;
+	int64_t write_count;
+	int64_t entry_count;
+	int64_t write_bytes;
+	/** String representation of wal_writer::batch_hist. */
+	char batch_hist[256];
+};
+
+static int
+wal_stat_f(struct cbus_call_msg *data)
+{
+	struct wal_writer *writer = &wal_writer_singleton;
+	struct wal_stat_msg *msg = (struct wal_stat_msg *)data;
+	msg->write_count = writer->write_count;
+	msg->entry_count = writer->entry_count;
+	msg->write_bytes = writer->write_bytes;
+	histogram_snprint(msg->batch_hist, sizeof(msg->batch_hist),
+			  writer->batch_hist);
+	return 0;
+}
+
+void
+wal_stat(struct info_handler *h)
+{
+	struct wal_writer *writer = &wal_writer_singleton;
+	struct wal_stat_msg msg;
+	memset(&msg, 0, sizeof(msg));
+	if (writer->wal_mode != WAL_NONE) {
+		bool cancellable = fiber_set_cancellable(false);
+		cbus_call(&writer->wal_pipe, &writer->tx_prio_pipe,
+			  &msg.base, wal_stat_f, NULL, TIMEOUT_INFINITY);
+		fiber_set_cancellable(cancellable);
+	}
+	info_begin(h);
+	info_append_int(h, "writes", msg.write_count);
+	info_append_int(h, "entries", msg.entry_count);
+	info_append_int(h, "bytes", msg.write_bytes);
+	info_append_str(h, "batch_histogram", msg.batch_hist);
+	info_end(h);
+}
+
 void
 wal_set_queue_max_size(int64_t size)
 {
@@ -870,11 +1386,52 @@ wal_opt_rotate(struct wal_writer *writer)
 	 * collection, see wal_collect_garbage().
 	 */
 	xdir_add_vclock(&writer->wal_dir, &writer->vclock);
+	writer->mem.is_new_file = true;
 
 	wal_notify_watchers(writer, WAL_EVENT_ROTATE);
+	wal_create_spare(writer);
+	return 0;
+}
+
+static void
+wal_create_spare_f(eio_req *req)
+{
+	struct wal_writer *writer = (struct wal_writer *)req->data;
+	req->result = xdir_create_spare(&writer->wal_dir,
+					writer->wal_max_size);
+	if (req->result != 0)
+		diag_log();
+}
+
+static int
+wal_create_spare_cb(eio_req *req)
+{
+	struct wal_writer *writer = (struct wal_writer *)req->data;
+	assert(writer->spare_in_progress);
+	writer->spare_in_progress = false;
+	if (req->result == 0)
+		writer->wal_dir.spare_size = writer->wal_max_size;
+	else
+		say_warn("failed to preallocate the next WAL file");
 	return 0;
 }
 
+/**
+ * Preallocate disk space for the next WAL file in a coio thread
+ * so that the WAL thread doesn't stall on fallocate() and file
+ * creation when the current WAL file gets full.
+ */
+static void
+wal_create_spare(struct wal_writer *writer)
+{
+	if (writer->wal_mode == WAL_NONE || writer->spare_in_progress ||
+	    writer->wal_dir.spare_size > 0)
+		return;
+	writer->spare_in_progress = true;
+	eio_custom(wal_create_spare_f, EIO_PRI_DEFAULT,
+		   wal_create_spare_cb, writer);
+}
+
 /**
  * Make sure there's enough disk space to append @len bytes
  * of data to the current WAL.
@@ -916,6 +1473,12 @@ retry:
 	}
 	if (errno != ENOSPC)
 		goto error;
+	if (writer->wal_dir.spare_size > 0) {
+		/* The spare file is the first to go. */
+		say_warn("ran out of disk space, remove the spare WAL file");
+		xdir_remove_spare(&writer->wal_dir);
+		goto retry;
+	}
 	if (!xdir_has_garbage(&writer->wal_dir, gc_lsn))
 		goto error;
 
@@ -1031,6 +1594,25 @@ wal_assign_lsn(struct vclock *vclock_diff, struct vclock *base,
 		(*row)->tsn = tsn;
 }
 
+/**
+ * Flush the data of the WAL file written so far to disk.
+ */
+static int
+wal_sync_batch(struct xlog *l)
+{
+	TT_PROBE(wal_sync_begin, l->fd);
+	ERROR_INJECT(ERRINJ_WAL_SYNC_BATCH, {
+		diag_set(ClientError, ER_INJECTION, "wal sync batch");
+		return -1;
+	});
+	if (fdatasync(l->fd) != 0) {
+		diag_set(SystemError, "failed to sync '%s' file", l->filename);
+		return -1;
+	}
+	TT_PROBE(wal_sync_end, l->fd);
+	return 0;
+}
+
 static void
 wal_write_to_disk(struct cmsg *msg)
 {
@@ -1040,8 +1622,15 @@ wal_write_to_disk(struct cmsg *msg)
 	struct stailq_entry *last_committed = NULL;
 	struct journal_entry *entry;
 	struct error *error;
+	if (wal_msg->is_merged) {
+		/* The requests were written with a preceding batch. */
+		assert(stailq_empty(&wal_msg->commit));
+		vclock_copy(&wal_msg->vclock, &writer->vclock);
+		return;
+	}
 	if (stailq_empty(&wal_msg->commit))
 		panic("Attempted to write an empty batch to WAL");
+	TT_PROBE(wal_write_begin, wal_msg);
 
 	/*
 	 * Track all vclock changes made by this batch into
@@ -1050,6 +1639,9 @@ wal_write_to_disk(struct cmsg *msg)
 	 */
 	struct vclock vclock_diff;
 	vclock_create(&vclock_diff);
+	/* WAL vclock before the batch, for relays reading from memory. */
+	struct vclock mem_vclock;
+	vclock_copy(&mem_vclock, &writer->vclock);
 
 	ERROR_INJECT_SLEEP(ERRINJ_WAL_DELAY);
 
@@ -1076,6 +1668,7 @@ wal_write_to_disk(struct cmsg *msg)
 		err_code = JOURNAL_ENTRY_ERR_IO;
 		goto done;
 	}
+	double write_start = ev_monotonic_time();
 
 	/*
 	 * This code tries to write queued requests (=transactions) using as
@@ -1099,12 +1692,20 @@ wal_write_to_disk(struct cmsg *msg)
 	 */
 
 	struct xlog *l = &writer->current_wal;
+	/* Where to truncate the file if the batch fails to sync. */
+	off_t batch_offset = l->offset;
+	int64_t batch_rows = l->rows;
+	struct vclock batch_vclock;
+	vclock_copy(&batch_vclock, &writer->vclock);
 
 	/*
 	 * Iterate over requests (transactions)
 	 */
 	int rc;
+	int64_t entry_count = 0;
+	int64_t write_bytes = 0;
 	stailq_foreach_entry(entry, &wal_msg->commit, fifo) {
+		entry_count++;
 		wal_assign_lsn(&vclock_diff, &writer->vclock, entry);
 		entry->res = vclock_sum(&vclock_diff) +
 			     vclock_sum(&writer->vclock);
@@ -1115,6 +1716,7 @@ wal_write_to_disk(struct cmsg *msg)
 		}
 		if (rc > 0) {
 			writer->checkpoint_wal_size += rc;
+			write_bytes += rc;
 			last_committed = &entry->fifo;
 			vclock_merge(&writer->vclock, &vclock_diff);
 		}
@@ -1125,11 +1727,46 @@ wal_write_to_disk(struct cmsg *msg)
 		err_code= JOURNAL_ENTRY_ERR_IO;
 		goto done;
 	}
+	/*
+	 * In fsync mode, sync the whole batch with one call rather
+	 * than open the file with O_SYNC, which would sync every
+	 * write of a big batch separately, unless the user asked
+	 * for O_DSYNC explicitly.
+	 */
+	if (writer->wal_mode == WAL_FSYNC && !writer->is_dsync &&
+	    wal_sync_batch(l) != 0) {
+		/*
+		 * The batch is going to be rolled back, so remove
+		 * it from the file, otherwise it would be recovered.
+		 */
+		if (lseek(l->fd, batch_offset, SEEK_SET) < 0 ||
+		    ftruncate(l->fd, batch_offset) != 0)
+			panic_syserror("failed to truncate xlog after sync error");
+		/*
+		 * Only the bytes written by xlog_write_entry() were
+		 * accounted, the final xlog_flush() wasn't yet.
+		 */
+		writer->checkpoint_wal_size -= write_bytes;
+		l->offset = batch_offset;
+		l->rows = batch_rows;
+		l->allocated = 0;
+		vclock_copy(&writer->vclock, &batch_vclock);
+		last_committed = NULL;
+		err_code = JOURNAL_ENTRY_ERR_IO;
+		goto done;
+	}
 
 	writer->checkpoint_wal_size += rc;
 	last_committed = stailq_last(&wal_msg->commit);
 	vclock_merge(&writer->vclock, &vclock_diff);
 
+	writer->write_count++;
+	writer->entry_count += entry_count;
+	writer->write_bytes += write_bytes + rc;
+	histogram_collect(writer->batch_hist, entry_count);
+	wal_update_rate_factor(writer, ev_monotonic_time() - write_start);
+	TT_PROBE(wal_write_end, wal_msg, entry_count, write_bytes + rc);
+
 	/*
 	 * Notify TX if the checkpoint threshold has been exceeded.
 	 * Use malloc() for allocating the notification message and
@@ -1186,11 +1823,106 @@ done:
 	} else {
 		assert(err_code == JOURNAL_ENTRY_ERR_UNKNOWN);
 	}
+	wal_mem_append(&writer->mem, &mem_vclock, &wal_msg->commit,
+		       wal_msg->approx_len);
 	fiber_gc();
 	wal_notify_watchers(writer, WAL_EVENT_WRITE);
 	ERROR_INJECT_SLEEP(ERRINJ_RELAY_FASTER_THAN_TX);
 }
 
+/**
+ * Group commit: write the WAL batch at the head of @a input
+ * together with the WAL batches following it, so that they
+ * share one write and one sync.
+ *
+ * If group commit is enabled, the WAL thread waits for more
+ * batches to arrive until the total size of requests reaches
+ * wal_group_commit_max_size or wal_group_commit_delay expires.
+ * The wait is skipped if the previous window didn't catch
+ * anything and there's no backlog, since in this case there's
+ * nobody to merge with.
+ *
+ * Requests of merged batches are moved to the first one, which
+ * is written to disk. The rest are passed back to tx empty, in
+ * the original order.
+ */
+static void
+wal_write_group(struct wal_writer *writer, struct cbus_endpoint *endpoint,
+		struct stailq *input)
+{
+	struct wal_msg *batch = wal_msg(stailq_shift_entry(input, struct cmsg,
+							   fifo));
+	assert(batch != NULL);
+	struct stailq merged;
+	stailq_create(&merged);
+	if (writer->group_commit_delay > 0) {
+		double deadline = ev_monotonic_now(loop()) +
+				  writer->group_commit_delay;
+		bool wait = !writer->group_commit_is_idle ||
+			    !stailq_empty(input);
+		bool is_idle = true;
+		while ((int64_t)batch->approx_len <
+		       writer->group_commit_max_size) {
+			if (stailq_empty(input)) {
+				double timeout = deadline -
+						 ev_monotonic_now(loop());
+				if (!wait || timeout <= 0)
+					break;
+				fiber_yield_timeout(timeout);
+				cbus_endpoint_fetch(endpoint, input);
+				continue;
+			}
+			struct wal_msg *next = wal_msg(stailq_first_entry(
+				input, struct cmsg, fifo));
+			if (next == NULL) {
+				/* Don't reorder requests of other kinds. */
+				break;
+			}
+			stailq_shift(input);
+			stailq_concat(&batch->commit, &next->commit);
+			batch->approx_len += next->approx_len;
+			next->approx_len = 0;
+			next->is_merged = true;
+			stailq_add_tail_entry(&merged, next, base.fifo);
+			is_idle = false;
+		}
+		writer->group_commit_is_idle = is_idle;
+	}
+	cmsg_deliver(&batch->base);
+	struct wal_msg *next, *tmp;
+	stailq_foreach_entry_safe(next, tmp, &merged, base.fifo)
+		cmsg_deliver(&next->base);
+}
+
+/**
+ * Process messages received by the WAL thread until it's
+ * stopped. Same as cbus_loop(), but lets wal_write_group()
+ * merge adjacent WAL batches.
+ */
+static void
+wal_writer_loop(struct wal_writer *writer, struct cbus_endpoint *endpoint)
+{
+	struct stailq input;
+	stailq_create(&input);
+	while (true) {
+		cbus_endpoint_fetch(endpoint, &input);
+		while (!stailq_empty(&input)) {
+			struct cmsg *msg = stailq_first_entry(&input,
+							      struct cmsg,
+							      fifo);
+			if (wal_msg(msg) != NULL) {
+				wal_write_group(writer, endpoint, &input);
+			} else {
+				stailq_shift(&input);
+				cmsg_deliver(msg);
+			}
+		}
+		if (fiber_is_cancelled())
+			break;
+		fiber_yield();
+	}
+}
+
 /** WAL writer main loop.  */
 static int
 wal_writer_f(va_list ap)
@@ -1210,7 +1942,8 @@ wal_writer_f(va_list ap)
 	 */
 	cpipe_create(&writer->tx_prio_pipe, "tx_prio");
 
-	cbus_loop(&endpoint);
+	wal_create_spare(writer);
+	wal_writer_loop(writer, &endpoint);
 
 	/*
 	 * Create a new empty WAL on shutdown so that we don't
@@ -1232,6 +1965,8 @@ wal_writer_f(va_list ap)
 	if (xlog_is_open(&writer->current_wal))
 		xlog_close(&writer->current_wal, false);
 
+	xdir_remove_spare(&writer->wal_dir);
+
 	if (xlog_is_open(&vy_log_writer.xlog))
 		xlog_close(&vy_log_writer.xlog, false);
 
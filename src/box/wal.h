@@ -40,6 +40,7 @@
 struct fiber;
 struct wal_writer;
 struct tt_uuid;
+struct info_handler;
 
 enum wal_mode {
 	/**
@@ -62,6 +63,20 @@ enum wal_mode {
 	WAL_MODE_MAX
 };
 
+/** How WAL files are synced in wal_mode = 'fsync'. */
+enum wal_io_mode {
+	/** Write through the page cache, then call fdatasync(). */
+	WAL_IO_BUFFERED = 0,
+	/**
+	 * Open WAL files with O_DSYNC so that each write returns
+	 * when the data is on the storage device, which avoids a
+	 * separate flush request on devices that support FUA.
+	 */
+	WAL_IO_DSYNC,
+
+	WAL_IO_MODE_MAX
+};
+
 enum {
 	/**
 	 * Recovery yields once per that number of rows read and
@@ -74,6 +89,9 @@ enum {
 /** String constants for the supported modes. */
 extern const char *wal_mode_STRS[];
 
+/** String constants for the supported I/O modes. */
+extern const char *wal_io_mode_STRS[];
+
 extern int wal_dir_lock;
 
 #if defined(__cplusplus)
@@ -100,11 +118,18 @@ typedef void (*wal_on_checkpoint_threshold_f)(void);
  * Start WAL thread and initialize WAL writer.
  */
 int
-wal_init(enum wal_mode wal_mode, const char *wal_dirname,
-	 int64_t wal_max_size, const struct tt_uuid *instance_uuid,
+wal_init(enum wal_mode wal_mode, enum wal_io_mode wal_io_mode,
+	 const char *wal_dirname, int64_t wal_max_size, int compression_level,
+	 const struct tt_uuid *instance_uuid,
 	 wal_on_garbage_collection_f on_garbage_collection,
 	 wal_on_checkpoint_threshold_f on_checkpoint_threshold);
 
+/**
+ * Pin the WAL thread to the given CPUs, see cord_set_cpu_affinity().
+ */
+int
+wal_set_cpu_affinity(const char *cpus);
+
 /**
  * Setup WAL writer as journaling subsystem.
  */
@@ -199,6 +224,62 @@ void
 wal_clear_watcher(struct wal_watcher *watcher,
 		  void (*process_cb)(struct cbus_endpoint *));
 
+/**
+ * Rows written to WAL by one write to disk and kept in memory so
+ * that relays which are caught up don't need to read them back
+ * from the file. Batches are shared by all relays and freed when
+ * the last reference is dropped.
+ */
+struct wal_mem_batch {
+	/** Reference counter, updated atomically. */
+	int refs;
+	/** Set if the batch is the first one in a new WAL file. */
+	bool is_new_file;
+	/** WAL vclock before the batch was written. */
+	struct vclock vclock;
+	/** Encoded rows, without fixheaders, as stored in xlog. */
+	char *data;
+	/** Size of the encoded rows. */
+	size_t size;
+};
+
+/**
+ * Start reading WAL from memory. While there's at least one
+ * reader, the WAL thread keeps recently written batches in
+ * memory, see wal_mem_find(). Thread-safe.
+ */
+void
+wal_mem_attach(void);
+
+/** Stop reading WAL from memory. Thread-safe. */
+void
+wal_mem_detach(void);
+
+/**
+ * Find a batch kept in memory that a reader with the given vclock
+ * may start reading from, i.e. the latest batch such that all rows
+ * written before it are included in @a vclock. Returns the sequence
+ * number of the batch or -1 if there's no such batch, in which case
+ * the reader has to read WAL files. Thread-safe.
+ */
+int64_t
+wal_mem_find(const struct vclock *vclock);
+
+/**
+ * Get the batch with the given sequence number, returned either by
+ * wal_mem_find() or by incrementing the number of a batch that has
+ * already been read. Returns NULL if the batch hasn't been written
+ * yet. If the batch has already been dropped from memory, returns
+ * NULL and sets @a is_lost. The returned batch must be released
+ * with wal_mem_batch_unref(). Thread-safe.
+ */
+struct wal_mem_batch *
+wal_mem_get(int64_t seq, bool *is_lost);
+
+/** Release a batch returned by wal_mem_get(). Thread-safe. */
+void
+wal_mem_batch_unref(struct wal_mem_batch *batch);
+
 void
 wal_atfork(void);
 
@@ -263,6 +344,39 @@ wal_set_checkpoint_threshold(int64_t threshold);
 void
 wal_set_queue_max_size(int64_t size);
 
+/**
+ * Configure WAL group commit: let the WAL thread wait up to
+ * @a delay seconds for more requests to write them together
+ * with one write and one sync, until their total size reaches
+ * @a max_size bytes. 0 @a delay disables group commit.
+ */
+void
+wal_set_group_commit(double delay, int64_t max_size);
+
+/**
+ * Set the target latency of a WAL write to disk, in seconds.
+ * Background writers are slowed down while WAL writes take longer,
+ * see wal_background_rate_factor(). 0 disables the adjustment.
+ */
+void
+wal_set_latency_target(double target);
+
+/**
+ * Return the factor in (0, 1] by which background writers, like
+ * checkpoint and vinyl dump, should reduce their write rate to
+ * keep the WAL write latency within the target. It's halved while
+ * WAL writes take longer than the target and grows back when they
+ * don't. Thread-safe.
+ */
+double
+wal_background_rate_factor(void);
+
+/**
+ * Append WAL writer statistics to @a h.
+ */
+void
+wal_stat(struct info_handler *h);
+
 /**
  * Remove WAL files that are not needed by consumers reading
  * rows at @vclock or newer.
@@ -341,6 +341,7 @@ watchable_create(struct watchable *watchable)
 {
 	watchable->node_by_key = mh_strnptr_new();
 	rlist_create(&watchable->pending_watchers);
+	watchable->version = 0;
 	watchable->worker = NULL;
 }
 
@@ -393,7 +394,7 @@ watchable_broadcast(struct watchable *watchable,
 			return;
 		}
 	}
-	node->version++;
+	node->version = ++watchable->version;
 	watchable_schedule_node(watchable, node);
 }
 
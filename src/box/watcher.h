@@ -102,7 +102,10 @@ struct watchable_node {
 	/** End of the data. */
 	char *data_end;
 	/**
-	 * Version of the data, incremented every time the data is updated.
+	 * Version of the data, updated every time the data is updated.
+	 * Versions are taken from watchable::version so they are unique
+	 * across all nodes of a watchable: a key and a version identify
+	 * the data sent to watchers. Zero means the data was never set.
 	 *
 	 * We remember the version before running a watcher callback. When the
 	 * callback returns, we compare the version we saw with the current
@@ -151,6 +154,8 @@ struct watchable {
 	 * Linked by watcher::in_idle_or_pending.
 	 */
 	struct rlist pending_watchers;
+	/** Last version assigned to a node, see watchable_node::version. */
+	uint64_t version;
 	/** Background fiber that runs watcher callbacks. */
 	struct fiber *worker;
 };
@@ -189,6 +194,18 @@ watcher_data(const struct watcher *watcher, const char **end)
 	return node->data;
 }
 
+/**
+ * Returns the version of the data passed to the running watcher callback.
+ * Watchers of the same key see the same data if their versions are equal.
+ * Must not be used in watcher_destroy_f.
+ */
+static inline uint64_t
+watcher_version(const struct watcher *watcher)
+{
+	assert(watcher->node != NULL);
+	return watcher->version;
+}
+
 /**
  * Acknowledges a notification.
  *
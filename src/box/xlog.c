@@ -32,6 +32,8 @@
 #include <dirent.h>
 #include <fcntl.h>
 #include <ctype.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #include "fiber.h"
 #include "exception.h"
@@ -46,7 +48,9 @@
 #include "xrow.h"
 #include "iproto_constants.h"
 #include "errinj.h"
+#include "salad/stailq.h"
 #include "trivia/util.h"
+#include "tt_pthread.h"
 
 /*
  * FALLOC_FL_KEEP_SIZE flag has existed since fallocate() was
@@ -92,10 +96,14 @@ enum {
 
 const struct xlog_opts xlog_opts_default = {
 	.rate_limit = 0,
+	.rate_factor_f = NULL,
 	.sync_interval = 0,
 	.free_cache = false,
 	.sync_is_async = false,
 	.no_compression = false,
+	.compression_level = XLOG_COMPRESSION_LEVEL_DEFAULT,
+	.compress_threads = 0,
+	.read_mmap = false,
 };
 
 /* {{{ struct xlog_meta */
@@ -445,7 +453,10 @@ xdir_open_cursor(struct xdir *dir, int64_t signature,
 		diag_set(SystemError, "failed to open '%s' file", filename);
 		return -1;
 	}
-	if (xlog_cursor_openfd(cursor, fd, filename) < 0) {
+	int rc = dir->opts.read_mmap ?
+		 xlog_cursor_openfd_mmap(cursor, fd, filename) :
+		 xlog_cursor_openfd(cursor, fd, filename);
+	if (rc < 0) {
 		close(fd);
 		return -1;
 	}
@@ -658,6 +669,18 @@ xdir_format_filename(struct xdir *dir, int64_t signature,
 					      inprogress_suffix : "");
 }
 
+/**
+ * Format the path of the spare file of a directory. The file
+ * has the .inprogress suffix so that xdir_scan() ignores it and
+ * the garbage collector removes it if it's left after a crash.
+ */
+static void
+xdir_format_spare_path(const struct xdir *dir, char *buf, size_t size)
+{
+	snprintf(buf, size, "%s/spare%s%s", dir->dirname,
+		 dir->filename_ext, inprogress_suffix);
+}
+
 static void
 xdir_say_gc(int result, int errorno, const char *filename)
 {
@@ -784,6 +807,12 @@ xlog_rename(struct xlog *l)
 	return 0;
 }
 
+static struct xlog_zpool *
+xlog_zpool_new(int thread_count, int compression_level);
+
+static void
+xlog_zpool_delete(struct xlog_zpool *pool);
+
 static int
 xlog_init(struct xlog *xlog, const struct xlog_opts *opts)
 {
@@ -800,6 +829,15 @@ xlog_init(struct xlog *xlog, const struct xlog_opts *opts)
 				 "failed to create context");
 			return -1;
 		}
+		if (opts->compress_threads > 0) {
+			xlog->zpool = xlog_zpool_new(opts->compress_threads,
+						     opts->compression_level);
+			if (xlog->zpool == NULL) {
+				ZSTD_freeCCtx(xlog->zctx);
+				xlog->zctx = NULL;
+				return -1;
+			}
+		}
 	}
 	return 0;
 }
@@ -819,13 +857,42 @@ xlog_destroy(struct xlog *xlog)
 	obuf_destroy(&xlog->obuf);
 	obuf_destroy(&xlog->zbuf);
 	ZSTD_freeCCtx(xlog->zctx);
+	if (xlog->zpool != NULL)
+		xlog_zpool_delete(xlog->zpool);
 	TRASH(xlog);
 	xlog->fd = -1;
 }
 
-int
-xlog_create(struct xlog *xlog, const char *name, int flags,
-	    const struct xlog_meta *meta, const struct xlog_opts *opts)
+/**
+ * Take the spare file created by xdir_create_spare() for a new
+ * xlog: rename it to the xlog file name and open it.
+ * Return the file descriptor or -1 on error.
+ */
+static int
+xlog_take_spare(struct xlog *xlog, const char *spare, int flags)
+{
+	if (rename(spare, xlog->filename) != 0) {
+		say_syserror("can't rename %s to %s", spare,
+			     xlog->filename);
+		return -1;
+	}
+	int fd = open(xlog->filename, flags | O_RDWR);
+	if (fd < 0) {
+		say_syserror("open, [%s]", xlog->filename);
+		unlink(xlog->filename);
+	}
+	return fd;
+}
+
+/**
+ * Create a new xlog file. If @a spare is not NULL, it's the path
+ * of a spare file with @a spare_size bytes preallocated, which is
+ * used for the new xlog instead of creating a new file.
+ */
+static int
+xlog_create_impl(struct xlog *xlog, const char *name, int flags,
+		 const struct xlog_meta *meta, const struct xlog_opts *opts,
+		 const char *spare, size_t spare_size)
 {
 	char meta_buf[XLOG_META_LEN_MAX];
 	int meta_len;
@@ -854,6 +921,12 @@ xlog_create(struct xlog *xlog, const char *name, int flags,
 		goto err;
 	}
 
+	xlog->fd = -1;
+	if (spare != NULL)
+		xlog->fd = xlog_take_spare(xlog, spare, flags);
+	if (xlog->fd >= 0)
+		goto write_meta;
+
 	flags |= O_RDWR | O_CREAT | O_EXCL;
 
 	/*
@@ -873,7 +946,8 @@ xlog_create(struct xlog *xlog, const char *name, int flags,
 			 xlog->filename);
 		goto err_open;
 	}
-
+	spare_size = 0;
+write_meta:
 	/* Format metadata */
 	meta_len = xlog_meta_format(&xlog->meta, meta_buf, sizeof(meta_buf));
 	if (meta_len < 0)
@@ -889,6 +963,8 @@ xlog_create(struct xlog *xlog, const char *name, int flags,
 	}
 
 	xlog->offset = meta_len; /* first log starts after meta */
+	if (spare_size > (size_t)meta_len)
+		xlog->allocated = spare_size - meta_len;
 	return 0;
 err_write:
 	close(xlog->fd);
@@ -899,6 +975,13 @@ err:
 	return -1;
 }
 
+int
+xlog_create(struct xlog *xlog, const char *name, int flags,
+	    const struct xlog_meta *meta, const struct xlog_opts *opts)
+{
+	return xlog_create_impl(xlog, name, flags, meta, opts, NULL, 0);
+}
+
 int
 xlog_open(struct xlog *xlog, const char *name, const struct xlog_opts *opts)
 {
@@ -1016,8 +1099,16 @@ xdir_create_xlog(struct xdir *dir, struct xlog *xlog,
 			 vclock, prev_vclock);
 
 	const char *filename = xdir_format_filename(dir, signature, NONE);
-	if (xlog_create(xlog, filename, dir->open_wflags, &meta,
-			&dir->opts) != 0)
+	const char *spare = NULL;
+	char spare_path[PATH_MAX];
+	size_t spare_size = dir->spare_size;
+	if (spare_size > 0) {
+		xdir_format_spare_path(dir, spare_path, sizeof(spare_path));
+		spare = spare_path;
+		dir->spare_size = 0;
+	}
+	if (xlog_create_impl(xlog, filename, dir->open_wflags, &meta,
+			     &dir->opts, spare, spare_size) != 0)
 		return -1;
 
 	/* Rename xlog file */
@@ -1031,6 +1122,55 @@ xdir_create_xlog(struct xdir *dir, struct xlog *xlog,
 	return 0;
 }
 
+int
+xdir_create_spare(const struct xdir *dir, size_t size)
+{
+	char path[PATH_MAX];
+	xdir_format_spare_path(dir, path, sizeof(path));
+	int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, dir->mode);
+	if (fd < 0) {
+		diag_set(SystemError, "failed to create file '%s'", path);
+		return -1;
+	}
+#ifdef HAVE_FALLOCATE
+	/*
+	 * Keep the file size zero, like xlog_fallocate() does,
+	 * so that the file can be taken for a new xlog as is.
+	 */
+	if (fallocate(fd, FALLOC_FL_KEEP_SIZE, 0, size) != 0) {
+		diag_set(SystemError, "%s: can't allocate disk space", path);
+		goto fail;
+	}
+#else
+	(void)size;
+	errno = EOPNOTSUPP;
+	diag_set(SystemError, "%s: can't allocate disk space", path);
+	goto fail;
+#endif
+	if (fsync(fd) != 0) {
+		diag_set(SystemError, "%s: fsync failed", path);
+		goto fail;
+	}
+	close(fd);
+	return 0;
+fail:
+	close(fd);
+	unlink(path);
+	return -1;
+}
+
+void
+xdir_remove_spare(struct xdir *dir)
+{
+	if (dir->spare_size == 0)
+		return;
+	dir->spare_size = 0;
+	char path[PATH_MAX];
+	xdir_format_spare_path(dir, path, sizeof(path));
+	if (unlink(path) != 0 && errno != ENOENT)
+		say_syserror("error while removing %s", path);
+}
+
 ssize_t
 xlog_fallocate(struct xlog *log, size_t len)
 {
@@ -1066,6 +1206,35 @@ xlog_fallocate(struct xlog *log, size_t len)
 #endif /* HAVE_FALLOCATE */
 }
 
+/**
+ * Encode a fixed header of a transaction block with the given
+ * magic, length and crc32 checksum of the data that follows.
+ */
+static void
+xlog_fixheader_encode(char *fixheader, log_magic_t magic, size_t len,
+		      uint32_t crc32c)
+{
+	*(log_magic_t *)fixheader = magic;
+	char *data = fixheader + sizeof(log_magic_t);
+	data = mp_encode_uint(data, len);
+	/* Encode crc32 for previous row */
+	data = mp_encode_uint(data, 0);
+	/* Encode crc32 for current row */
+	data = mp_encode_uint(data, crc32c);
+	/*
+	 * Encode a padding, to ensure the resulting
+	 * fixheader always has the same size.
+	 */
+	ssize_t padding = XLOG_FIXHEADER_SIZE - (data - fixheader);
+	if (padding > 0) {
+		data = mp_encode_strl(data, padding - 1);
+		if (padding > 1) {
+			memset(data, 0, padding - 1);
+			data += padding - 1;
+		}
+	}
+}
+
 /**
  * Write a sequence of uncompressed xrow objects.
  *
@@ -1080,14 +1249,6 @@ xlog_tx_write_plain(struct xlog *log)
 	 * now populate it with data.
 	 */
 	char *fixheader = (char *)log->obuf.iov[0].iov_base;
-	*(log_magic_t *)fixheader = row_marker;
-	char *data = fixheader + sizeof(log_magic_t);
-
-	data = mp_encode_uint(data,
-			      obuf_size(&log->obuf) - XLOG_FIXHEADER_SIZE);
-	/* Encode crc32 for previous row */
-	data = mp_encode_uint(data, 0);
-	/* Encode crc32 for current row */
 	uint32_t crc32c = 0;
 	struct iovec *iov;
 	size_t offset = XLOG_FIXHEADER_SIZE;
@@ -1097,19 +1258,9 @@ xlog_tx_write_plain(struct xlog *log)
 				    iov->iov_len - offset);
 		offset = 0;
 	}
-	data = mp_encode_uint(data, crc32c);
-	/*
-	 * Encode a padding, to ensure the resulting
-	 * fixheader always has the same size.
-	 */
-	ssize_t padding = XLOG_FIXHEADER_SIZE - (data - fixheader);
-	if (padding > 0) {
-		data = mp_encode_strl(data, padding - 1);
-		if (padding > 1) {
-			memset(data, 0, padding - 1);
-			data += padding - 1;
-		}
-	}
+	xlog_fixheader_encode(fixheader, row_marker,
+			      obuf_size(&log->obuf) - XLOG_FIXHEADER_SIZE,
+			      crc32c);
 
 	ERROR_INJECT(ERRINJ_WAL_WRITE_DISK, {
 		diag_set(ClientError, ER_INJECTION, "xlog write injection");
@@ -1138,8 +1289,7 @@ xlog_tx_write_zstd(struct xlog *log)
 
 	uint32_t crc32c = 0;
 	struct iovec *iov;
-	/* 3 is compression level. */
-	ZSTD_compressBegin(log->zctx, 3);
+	ZSTD_compressBegin(log->zctx, log->opts.compression_level);
 	size_t offset = XLOG_FIXHEADER_SIZE;
 	for (iov = log->obuf.iov; iov->iov_len; ++iov) {
 		/* Estimate max output buffer size. */
@@ -1179,25 +1329,9 @@ xlog_tx_write_zstd(struct xlog *log)
 		offset = 0;
 	}
 
-	*(log_magic_t *)fixheader = zrow_marker;
-	char *data;
-	data = fixheader + sizeof(log_magic_t);
-	data = mp_encode_uint(data,
-			      obuf_size(&log->zbuf) - XLOG_FIXHEADER_SIZE);
-	/* Encode crc32 for previous row */
-	data = mp_encode_uint(data, 0);
-	/* Encode crc32 for current row */
-	data = mp_encode_uint(data, crc32c);
-	/* Encode padding */
-	ssize_t padding;
-	padding = XLOG_FIXHEADER_SIZE - (data - fixheader);
-	if (padding > 0) {
-		data = mp_encode_strl(data, padding - 1);
-		if (padding > 1) {
-			memset(data, 0, padding - 1);
-			data += padding - 1;
-		}
-	}
+	xlog_fixheader_encode(fixheader, zrow_marker,
+			      obuf_size(&log->zbuf) - XLOG_FIXHEADER_SIZE,
+			      crc32c);
 
 	ERROR_INJECT(ERRINJ_WAL_WRITE_DISK, {
 		diag_set(ClientError, ER_INJECTION, "xlog write injection");
@@ -1226,27 +1360,17 @@ error:
 #define SYNC_ROUND_UP(size)	(SYNC_ROUND_DOWN(size + SYNC_MASK))
 
 /**
- * Writes xlog batch to file
+ * Account a transaction block written to the file at the current
+ * offset: advance the offset, sync the file and throttle the writer
+ * if necessary. On write failure (@a written < 0), truncate the file
+ * to the last successfully written block.
+ *
+ * @retval -1 the block wasn't written
+ * @retval >= 0 the number of bytes written
  */
 static ssize_t
-xlog_tx_write(struct xlog *log)
+xlog_tx_write_done(struct xlog *log, ssize_t written)
 {
-	if (obuf_size(&log->obuf) == XLOG_FIXHEADER_SIZE)
-		return 0;
-	ssize_t written;
-
-	if (!log->opts.no_compression &&
-	    obuf_size(&log->obuf) >= XLOG_TX_COMPRESS_THRESHOLD) {
-		written = xlog_tx_write_zstd(log);
-	} else {
-		written = xlog_tx_write_plain(log);
-	}
-	ERROR_INJECT(ERRINJ_WAL_WRITE, {
-		diag_set(ClientError, ER_INJECTION, "xlog write injection");
-		written = -1;
-	});
-
-	obuf_reset(&log->obuf);
 	/*
 	 * Simplify recovery after a temporary write failure:
 	 * truncate the file to the best known good write
@@ -1264,8 +1388,6 @@ xlog_tx_write(struct xlog *log)
 	else
 		log->allocated = 0;
 	log->offset += written;
-	log->rows += log->tx_rows;
-	log->tx_rows = 0;
 	if ((log->opts.sync_interval && log->offset >=
 	    (off_t)(log->synced_size + log->opts.sync_interval)) ||
 	    (log->opts.rate_limit && log->offset >=
@@ -1273,10 +1395,17 @@ xlog_tx_write(struct xlog *log)
 		off_t sync_from = SYNC_ROUND_DOWN(log->synced_size);
 		size_t sync_len = SYNC_ROUND_UP(log->offset) -
 				  sync_from;
-		if (log->opts.rate_limit > 0) {
-			double throttle_time;
-			throttle_time = (double)sync_len / log->opts.rate_limit -
-					(ev_monotonic_time() - log->sync_time);
+		if (log->opts.rate_limit > 0 ||
+		    log->opts.rate_factor_f != NULL) {
+			double elapsed = ev_monotonic_time() - log->sync_time;
+			double duration = elapsed;
+			if (log->opts.rate_limit > 0) {
+				duration = MAX(duration, (double)sync_len /
+					       log->opts.rate_limit);
+			}
+			if (log->opts.rate_factor_f != NULL)
+				duration /= log->opts.rate_factor_f();
+			double throttle_time = duration - elapsed;
 			if (throttle_time > 0)
 				ev_sleep(throttle_time);
 		}
@@ -1307,6 +1436,328 @@ xlog_tx_write(struct xlog *log)
 	return written;
 }
 
+/* {{{ Compression thread pool */
+
+enum {
+	/**
+	 * Max number of transaction blocks per compression thread
+	 * that may be waiting to be written to the file.
+	 */
+	XLOG_ZPOOL_BLOCKS_PER_THREAD = 2,
+};
+
+/** A transaction block compressed by a pool thread. */
+struct xlog_zblock {
+	/** Link in xlog_zpool::input. */
+	struct stailq_entry in_input;
+	/** Link in xlog_zpool::pending. */
+	struct stailq_entry in_pending;
+	/** Encoded rows, without the fixed header. */
+	char *data;
+	/** Size of @data. */
+	size_t size;
+	/** Fixed header followed by the compressed rows. */
+	char *out;
+	/** Size of @out. */
+	size_t out_size;
+	/** Compression error message or NULL on success. */
+	const char *error;
+	/** Set when the block has been processed by a thread. */
+	bool is_ready;
+};
+
+/**
+ * A pool of threads compressing transaction blocks of an xlog.
+ * All members except the thread array are protected by @mutex.
+ */
+struct xlog_zpool {
+	pthread_mutex_t mutex;
+	/** Signaled when a block is added to @input or on stop. */
+	pthread_cond_t input_cond;
+	/** Signaled when a block is compressed. */
+	pthread_cond_t ready_cond;
+	/** Blocks waiting for a thread, linked by in_input. */
+	struct stailq input;
+	/**
+	 * All blocks not yet written to the file, in the order
+	 * they were submitted, linked by in_pending.
+	 */
+	struct stailq pending;
+	/** Length of @pending. */
+	int pending_count;
+	/** Max length of @pending the submitter doesn't wait for. */
+	int pending_max;
+	/** zstd compression level. */
+	int compression_level;
+	/** Set if the threads must exit. */
+	bool is_stopping;
+	/** Number of threads in @threads. */
+	int thread_count;
+	/** Compression threads. */
+	struct cord *threads;
+};
+
+static void
+xlog_zblock_delete(struct xlog_zblock *block)
+{
+	free(block->data);
+	free(block->out);
+	free(block);
+}
+
+/**
+ * Compress a block with zstd and prepend a fixed header to it.
+ * Called from a pool thread.
+ */
+static void
+xlog_zblock_compress(struct xlog_zblock *block, ZSTD_CCtx *zctx, int level)
+{
+	if (zctx == NULL) {
+		block->error = "failed to create context";
+		return;
+	}
+	size_t zmax_size = ZSTD_compressBound(block->size);
+	block->out = xmalloc(XLOG_FIXHEADER_SIZE + zmax_size);
+	char *zdst = block->out + XLOG_FIXHEADER_SIZE;
+	size_t zsize = ZSTD_compressCCtx(zctx, zdst, zmax_size,
+					 block->data, block->size, level);
+	if (ZSTD_isError(zsize)) {
+		block->error = ZSTD_getErrorName(zsize);
+		return;
+	}
+	uint32_t crc32c = crc32_calc(0, zdst, zsize);
+	xlog_fixheader_encode(block->out, zrow_marker, zsize, crc32c);
+	block->out_size = XLOG_FIXHEADER_SIZE + zsize;
+	/* The rows aren't needed anymore. */
+	free(block->data);
+	block->data = NULL;
+}
+
+/** Compression thread function. */
+static void *
+xlog_zpool_f(void *arg)
+{
+	struct xlog_zpool *pool = (struct xlog_zpool *)arg;
+	ZSTD_CCtx *zctx = ZSTD_createCCtx();
+	tt_pthread_mutex_lock(&pool->mutex);
+	while (true) {
+		while (stailq_empty(&pool->input) && !pool->is_stopping)
+			tt_pthread_cond_wait(&pool->input_cond, &pool->mutex);
+		if (pool->is_stopping)
+			break;
+		struct xlog_zblock *block = stailq_shift_entry(
+			&pool->input, struct xlog_zblock, in_input);
+		tt_pthread_mutex_unlock(&pool->mutex);
+		xlog_zblock_compress(block, zctx, pool->compression_level);
+		tt_pthread_mutex_lock(&pool->mutex);
+		block->is_ready = true;
+		tt_pthread_cond_signal(&pool->ready_cond);
+	}
+	tt_pthread_mutex_unlock(&pool->mutex);
+	ZSTD_freeCCtx(zctx);
+	return NULL;
+}
+
+static struct xlog_zpool *
+xlog_zpool_new(int thread_count, int compression_level)
+{
+	assert(thread_count > 0);
+	struct xlog_zpool *pool = xcalloc(1, sizeof(*pool));
+	tt_pthread_mutex_init(&pool->mutex, NULL);
+	tt_pthread_cond_init(&pool->input_cond, NULL);
+	tt_pthread_cond_init(&pool->ready_cond, NULL);
+	stailq_create(&pool->input);
+	stailq_create(&pool->pending);
+	pool->pending_max = thread_count * XLOG_ZPOOL_BLOCKS_PER_THREAD;
+	pool->compression_level = compression_level;
+	pool->threads = xcalloc(thread_count, sizeof(*pool->threads));
+	for (int i = 0; i < thread_count; i++) {
+		char name[FIBER_NAME_MAX];
+		snprintf(name, sizeof(name), "xlog.zstd.%d", i);
+		if (cord_start(&pool->threads[i], name,
+			       xlog_zpool_f, pool) != 0) {
+			xlog_zpool_delete(pool);
+			return NULL;
+		}
+		pool->thread_count++;
+	}
+	return pool;
+}
+
+/**
+ * Stop the pool threads and free the pool. Blocks that haven't
+ * been written to the file yet are discarded.
+ */
+static void
+xlog_zpool_delete(struct xlog_zpool *pool)
+{
+	tt_pthread_mutex_lock(&pool->mutex);
+	pool->is_stopping = true;
+	tt_pthread_cond_broadcast(&pool->input_cond);
+	tt_pthread_mutex_unlock(&pool->mutex);
+	for (int i = 0; i < pool->thread_count; i++) {
+		if (cord_join(&pool->threads[i]) != 0)
+			diag_log();
+	}
+	struct xlog_zblock *block, *tmp;
+	stailq_foreach_entry_safe(block, tmp, &pool->pending, in_pending)
+		xlog_zblock_delete(block);
+	tt_pthread_cond_destroy(&pool->ready_cond);
+	tt_pthread_cond_destroy(&pool->input_cond);
+	tt_pthread_mutex_destroy(&pool->mutex);
+	free(pool->threads);
+	free(pool);
+}
+
+/**
+ * Write a compressed block to the file.
+ *
+ * @retval -1 error
+ * @retval >= 0 the number of bytes written
+ */
+static ssize_t
+xlog_zblock_write(struct xlog *log, struct xlog_zblock *block)
+{
+	ssize_t written = -1;
+	if (block->error != NULL) {
+		diag_set(ClientError, ER_COMPRESSION, block->error);
+		goto out;
+	}
+	ERROR_INJECT(ERRINJ_WAL_WRITE_DISK, {
+		diag_set(ClientError, ER_INJECTION, "xlog write injection");
+		goto out;
+	});
+	if (fio_writen(log->fd, block->out, block->out_size) < 0) {
+		diag_set(SystemError, "failed to write to '%s' file",
+			 log->filename);
+		goto out;
+	}
+	written = block->out_size;
+out:
+	return xlog_tx_write_done(log, written);
+}
+
+/**
+ * Write compressed blocks to the file in the order they were
+ * submitted. Stops at the first block that hasn't been compressed
+ * yet unless @a flush is set or there are too many blocks pending,
+ * in which case waits for the compression threads.
+ *
+ * On error, discards all pending blocks so that the file doesn't
+ * have a gap in it.
+ *
+ * @retval -1 error
+ * @retval >= 0 the number of bytes written
+ */
+static ssize_t
+xlog_zpool_write(struct xlog *log, bool flush)
+{
+	struct xlog_zpool *pool = log->zpool;
+	ssize_t total = 0;
+	tt_pthread_mutex_lock(&pool->mutex);
+	while (!stailq_empty(&pool->pending)) {
+		struct xlog_zblock *block = stailq_first_entry(
+			&pool->pending, struct xlog_zblock, in_pending);
+		if (!block->is_ready) {
+			if (!flush && total >= 0 &&
+			    pool->pending_count <= pool->pending_max)
+				break;
+			tt_pthread_cond_wait(&pool->ready_cond, &pool->mutex);
+			continue;
+		}
+		stailq_shift(&pool->pending);
+		pool->pending_count--;
+		tt_pthread_mutex_unlock(&pool->mutex);
+		if (total >= 0) {
+			ssize_t written = xlog_zblock_write(log, block);
+			total = written < 0 ? -1 : total + written;
+		}
+		xlog_zblock_delete(block);
+		tt_pthread_mutex_lock(&pool->mutex);
+	}
+	tt_pthread_mutex_unlock(&pool->mutex);
+	return total;
+}
+
+/**
+ * Pass the transaction accumulated in the output buffer to the
+ * compression threads and write out those blocks that are ready.
+ *
+ * @retval -1 error
+ * @retval >= 0 the number of bytes written
+ */
+static ssize_t
+xlog_tx_write_async(struct xlog *log)
+{
+	struct xlog_zpool *pool = log->zpool;
+	struct xlog_zblock *block = xcalloc(1, sizeof(*block));
+	block->size = obuf_size(&log->obuf) - XLOG_FIXHEADER_SIZE;
+	block->data = xmalloc(block->size);
+	char *pos = block->data;
+	size_t offset = XLOG_FIXHEADER_SIZE;
+	for (struct iovec *iov = log->obuf.iov; iov->iov_len; ++iov) {
+		memcpy(pos, (char *)iov->iov_base + offset,
+		       iov->iov_len - offset);
+		pos += iov->iov_len - offset;
+		offset = 0;
+	}
+	assert(pos == block->data + block->size);
+	obuf_reset(&log->obuf);
+	/*
+	 * The rows are accounted on submission so that the
+	 * owner can number rows with xlog::rows + xlog::tx_rows.
+	 */
+	log->rows += log->tx_rows;
+	log->tx_rows = 0;
+
+	tt_pthread_mutex_lock(&pool->mutex);
+	stailq_add_tail_entry(&pool->input, block, in_input);
+	stailq_add_tail_entry(&pool->pending, block, in_pending);
+	pool->pending_count++;
+	tt_pthread_cond_signal(&pool->input_cond);
+	tt_pthread_mutex_unlock(&pool->mutex);
+	return xlog_zpool_write(log, false);
+}
+
+/* }}} */
+
+/**
+ * Writes xlog batch to file
+ */
+static ssize_t
+xlog_tx_write(struct xlog *log)
+{
+	if (obuf_size(&log->obuf) == XLOG_FIXHEADER_SIZE)
+		return 0;
+	ssize_t written;
+
+	if (!log->opts.no_compression &&
+	    obuf_size(&log->obuf) >= XLOG_TX_COMPRESS_THRESHOLD) {
+		if (log->zpool != NULL)
+			return xlog_tx_write_async(log);
+		written = xlog_tx_write_zstd(log);
+	} else {
+		/* Keep the order of transactions in the file. */
+		if (log->zpool != NULL && xlog_zpool_write(log, true) < 0) {
+			obuf_reset(&log->obuf);
+			return -1;
+		}
+		written = xlog_tx_write_plain(log);
+	}
+	ERROR_INJECT(ERRINJ_WAL_WRITE, {
+		diag_set(ClientError, ER_INJECTION, "xlog write injection");
+		written = -1;
+	});
+
+	obuf_reset(&log->obuf);
+	written = xlog_tx_write_done(log, written);
+	if (written < 0)
+		return -1;
+	log->rows += log->tx_rows;
+	log->tx_rows = 0;
+	return written;
+}
+
 /*
  * Add a row to a log and possibly flush the log.
  *
@@ -1417,9 +1868,14 @@ ssize_t
 xlog_flush(struct xlog *log)
 {
 	assert(log->is_autocommit);
-	if (log->obuf.used == 0)
-		return 0;
-	return xlog_tx_write(log);
+	ssize_t written = 0;
+	if (log->obuf.used != 0)
+		written = xlog_tx_write(log);
+	if (written >= 0 && log->zpool != NULL) {
+		ssize_t rc = xlog_zpool_write(log, true);
+		written = rc < 0 ? -1 : written + rc;
+	}
+	return written;
 }
 
 static int
@@ -1526,6 +1982,60 @@ xlog_atfork(struct xlog *xlog)
 
 #define XLOG_READ_AHEAD		(1 << 14)
 
+/**
+ * Map the part of the file that was appended since the last call
+ * into memory. The whole file is remapped, because the mapping
+ * has to be contiguous.
+ *
+ * @retval 0 at least count bytes are in read buf
+ * @retval 1 if eof
+ * @retval -1 if error
+ */
+static int
+xlog_cursor_ensure_mapped(struct xlog_cursor *cursor, size_t count)
+{
+	struct errinj *inj = errinj(ERRINJ_XLOG_READ, ERRINJ_INT);
+	if (inj != NULL && inj->iparam >= 0 &&
+	    inj->iparam < cursor->read_offset) {
+		errno = EIO;
+		diag_set(SystemError, "failed to read '%s' file",
+			 cursor->name);
+		return -1;
+	}
+	struct stat st;
+	if (fstat(cursor->fd, &st) < 0) {
+		diag_set(SystemError, "failed to stat '%s' file",
+			 cursor->name);
+		return -1;
+	}
+	size_t size = st.st_size;
+	if (size <= cursor->map_size)
+		return 1;
+	/*
+	 * The mapping is private and writable so that rows can
+	 * be decoded in place, like in the read buffer.
+	 */
+	char *map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+			 cursor->fd, 0);
+	if (map == MAP_FAILED) {
+		diag_set(SystemError, "failed to map '%s' file",
+			 cursor->name);
+		return -1;
+	}
+	(void)madvise(map, size, MADV_SEQUENTIAL);
+	size_t offset = 0;
+	if (cursor->map != NULL) {
+		offset = cursor->rbuf.rpos - cursor->map;
+		munmap(cursor->map, cursor->map_size);
+	}
+	cursor->map = map;
+	cursor->map_size = size;
+	cursor->rbuf.rpos = map + offset;
+	cursor->rbuf.wpos = map + size;
+	cursor->read_offset = size;
+	return ibuf_used(&cursor->rbuf) >= count ? 0 : 1;
+}
+
 /**
  * Ensure that at least count bytes are in read buffer
  *
@@ -1541,6 +2051,8 @@ xlog_cursor_ensure(struct xlog_cursor *cursor, size_t count)
 	/* in-memory mode */
 	if (cursor->fd < 0)
 		return 1;
+	if (cursor->is_mapped)
+		return xlog_cursor_ensure_mapped(cursor, count);
 
 	size_t to_load = count - ibuf_used(&cursor->rbuf);
 	to_load += XLOG_READ_AHEAD;
@@ -1756,7 +2268,7 @@ xlog_tx_decode(const char *data, const char *data_end,
 ssize_t
 xlog_tx_cursor_create(struct xlog_tx_cursor *tx_cursor,
 		      const char **data, const char *data_end,
-		      ZSTD_DStream *zdctx)
+		      ZSTD_DStream *zdctx, bool no_copy)
 {
 	const char *rpos = *data;
 	struct xlog_fixheader fixheader;
@@ -1782,6 +2294,17 @@ xlog_tx_cursor_create(struct xlog_tx_cursor *tx_cursor,
 
 	ibuf_create(&tx_cursor->rows, &cord()->slabc,
 		    XLOG_TX_AUTOCOMMIT_THRESHOLD);
+	if (fixheader.magic == row_marker && no_copy) {
+		/*
+		 * The buffer doesn't own any memory so destroying
+		 * it is a no-op.
+		 */
+		tx_cursor->rows.rpos = (char *)rpos;
+		tx_cursor->rows.wpos = (char *)rpos + fixheader.len;
+		*data = rpos + fixheader.len;
+		tx_cursor->size = fixheader.len;
+		return 0;
+	}
 	if (fixheader.magic == row_marker) {
 		void *dst = ibuf_alloc(&tx_cursor->rows, fixheader.len);
 		if (dst == NULL) {
@@ -1895,7 +2418,8 @@ xlog_cursor_next_tx(struct xlog_cursor *i)
 	ssize_t to_load;
 	while ((to_load = xlog_tx_cursor_create(&i->tx_cursor,
 						(const char **)&i->rbuf.rpos,
-						i->rbuf.wpos, i->zdctx)) > 0) {
+						i->rbuf.wpos, i->zdctx,
+						i->is_mapped)) > 0) {
 		/* not enough data in read buffer */
 		int rc = xlog_cursor_ensure(i, ibuf_used(&i->rbuf) + to_load);
 		if (rc < 0)
@@ -1975,11 +2499,13 @@ xlog_cursor_next(struct xlog_cursor *cursor,
 	return 0;
 }
 
-int
-xlog_cursor_openfd(struct xlog_cursor *i, int fd, const char *name)
+static int
+xlog_cursor_openfd_impl(struct xlog_cursor *i, int fd, const char *name,
+			bool is_mapped)
 {
 	memset(i, 0, sizeof(*i));
 	i->fd = fd;
+	i->is_mapped = is_mapped;
 	ibuf_create(&i->rbuf, &cord()->slabc,
 		    XLOG_TX_AUTOCOMMIT_THRESHOLD << 1);
 
@@ -2010,10 +2536,24 @@ xlog_cursor_openfd(struct xlog_cursor *i, int fd, const char *name)
 	i->state = XLOG_CURSOR_ACTIVE;
 	return 0;
 error:
+	if (i->map != NULL)
+		munmap(i->map, i->map_size);
 	ibuf_destroy(&i->rbuf);
 	return -1;
 }
 
+int
+xlog_cursor_openfd(struct xlog_cursor *i, int fd, const char *name)
+{
+	return xlog_cursor_openfd_impl(i, fd, name, false);
+}
+
+int
+xlog_cursor_openfd_mmap(struct xlog_cursor *i, int fd, const char *name)
+{
+	return xlog_cursor_openfd_impl(i, fd, name, true);
+}
+
 int
 xlog_cursor_open(struct xlog_cursor *i, const char *name)
 {
@@ -2081,6 +2621,10 @@ xlog_cursor_close(struct xlog_cursor *i, bool reuse_fd)
 	ibuf_destroy(&i->rbuf);
 	if (i->state == XLOG_CURSOR_TX)
 		xlog_tx_cursor_destroy(&i->tx_cursor);
+	if (i->map != NULL) {
+		munmap(i->map, i->map_size);
+		i->map = NULL;
+	}
 	ZSTD_freeDStream(i->zdctx);
 	i->state = (i->state == XLOG_CURSOR_EOF ?
 		    XLOG_CURSOR_EOF_CLOSED : XLOG_CURSOR_CLOSED);
@@ -44,6 +44,7 @@
 
 struct iovec;
 struct xrow_header;
+struct xlog_zpool;
 
 #if defined(__cplusplus)
 extern "C" {
@@ -56,6 +57,16 @@ extern "C" {
 struct xlog_opts {
 	/** Write rate limit, in bytes per second. */
 	uint64_t rate_limit;
+	/**
+	 * If set, the function is called each time the writer syncs
+	 * the file and returns a factor in (0, 1] by which the write
+	 * rate must be reduced, in addition to @rate_limit. Works
+	 * only if @rate_limit or @sync_interval is set.
+	 *
+	 * This option is useful for checkpoint and vinyl run files,
+	 * which shouldn't slow down WAL writes.
+	 */
+	double (*rate_factor_f)(void);
 	/** Sync interval, in bytes. */
 	uint64_t sync_interval;
 	/**
@@ -82,6 +93,40 @@ struct xlog_opts {
 	 * to be read frequently, e.g. L1 run files in Vinyl.
 	 */
 	bool no_compression;
+	/** zstd compression level. */
+	int compression_level;
+	/**
+	 * Number of threads used for compressing the file.
+	 * If greater than 0, compression of big transactions is
+	 * offloaded to a pool of threads, which compress several
+	 * transactions in parallel, while the xlog owner keeps
+	 * encoding rows and writes compressed data to the file
+	 * in the original order. Write errors may be reported
+	 * with a delay, by a subsequent write or by xlog_flush().
+	 *
+	 * This option is useful for memtx snapshots, which are
+	 * written in big batches and where zstd compression is
+	 * usually the bottleneck.
+	 */
+	int compress_threads;
+	/**
+	 * If this flag is set, cursors opened with xdir_open_cursor()
+	 * map files into memory instead of reading them with pread().
+	 *
+	 * It is only used for reading WAL files on local recovery,
+	 * when the WAL directory is locked and the files can't change.
+	 * Relays and hot standby must not use it: the file they read
+	 * may be truncated by the WAL writer after a write error, and
+	 * accessing a truncated part of a mapping raises SIGBUS.
+	 */
+	bool read_mmap;
+};
+
+enum {
+	/** Max value of xlog_opts::compress_threads. */
+	XLOG_COMPRESS_THREADS_MAX = 64,
+	/** Default value of xlog_opts::compression_level. */
+	XLOG_COMPRESSION_LEVEL_DEFAULT = 3,
 };
 
 extern const struct xlog_opts xlog_opts_default;
@@ -165,6 +210,13 @@ struct xdir {
 	char dirname[PATH_MAX];
 	/** Snapshots or xlogs */
 	enum xdir_type type;
+	/**
+	 * Size of disk space preallocated for the spare file
+	 * created with xdir_create_spare(), or 0 if there's no
+	 * spare file. The next xdir_create_xlog() takes the
+	 * spare file instead of creating a new one.
+	 */
+	size_t spare_size;
 };
 
 /**
@@ -395,6 +447,11 @@ struct xlog {
 	 * Compressed output buffer
 	 */
 	struct obuf zbuf;
+	/**
+	 * Pool of compression threads or NULL if compression
+	 * is done by the xlog owner, see xlog_opts::compress_threads.
+	 */
+	struct xlog_zpool *zpool;
 	/**
 	 * Synced file size
 	 */
@@ -434,6 +491,26 @@ int
 xdir_create_xlog(struct xdir *dir, struct xlog *xlog,
 		 const struct vclock *vclock);
 
+/**
+ * Create a spare file in a directory and preallocate @a size bytes
+ * of disk space for it. The caller is supposed to set
+ * xdir::spare_size on success so that the next xdir_create_xlog()
+ * uses the file. The function blocks and must not be called
+ * from a thread with an event loop that has to stay responsive.
+ *
+ * @retval 0 if OK
+ * @retval -1 if error
+ */
+int
+xdir_create_spare(const struct xdir *dir, size_t size);
+
+/**
+ * Remove the spare file of a directory, if any, releasing the
+ * disk space preallocated for it.
+ */
+void
+xdir_remove_spare(struct xdir *dir);
+
 /**
  * Create new xlog writer based on fd.
  * @param fd            file descriptor
@@ -582,6 +659,10 @@ struct xlog_tx_cursor
  * Create xlog tx iterator from memory data.
  * *data will be adjusted to end of tx
  *
+ * If @a no_copy is set, rows of an uncompressed tx aren't copied:
+ * the cursor references @a data, which must stay valid until the
+ * cursor is destroyed.
+ *
  * @retval 0 for Ok
  * @retval -1 for error
  * @retval >0 how many additional bytes should be read to parse tx
@@ -589,7 +670,7 @@ struct xlog_tx_cursor
 ssize_t
 xlog_tx_cursor_create(struct xlog_tx_cursor *cursor,
 		      const char **data, const char *data_end,
-		      ZSTD_DStream *zdctx);
+		      ZSTD_DStream *zdctx, bool no_copy);
 
 /**
  * Destroy xlog tx cursor and free all associated memory
@@ -666,10 +747,21 @@ struct xlog_cursor {
 	struct xlog_meta meta;
 	/** associated file name */
 	char name[PATH_MAX];
-	/** file read buffer */
+	/**
+	 * file read buffer
+	 *
+	 * If the file is mapped into memory, the buffer doesn't
+	 * own any memory: rpos and wpos point into the mapping.
+	 */
 	struct ibuf rbuf;
 	/** file read position */
 	off_t read_offset;
+	/** Set if the file is read with mmap() rather than pread(). */
+	bool is_mapped;
+	/** Start of the file mapping or NULL. */
+	char *map;
+	/** Size of the file mapping. */
+	size_t map_size;
 	/** cursor for current tx */
 	struct xlog_tx_cursor tx_cursor;
 	/** ZSTD context for decompression */
@@ -710,6 +802,21 @@ xlog_cursor_is_eof(const struct xlog_cursor *cursor)
 int
 xlog_cursor_openfd(struct xlog_cursor *cursor, int fd, const char *name);
 
+/**
+ * Open cursor from file descriptor and read the file by mapping
+ * it into memory. Rows of uncompressed transactions are decoded
+ * right from the mapping, without copying. The mapping grows if
+ * the file is appended to while the cursor is open.
+ *
+ * @param cursor cursor
+ * @param fd file descriptor
+ * @param name associated file name
+ * @retval 0 succes
+ * @retval -1 error, check diag
+ */
+int
+xlog_cursor_openfd_mmap(struct xlog_cursor *cursor, int fd, const char *name);
+
 /**
  * Open cursor from file
  * @param cursor cursor
@@ -0,0 +1,345 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2021, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#include "box/xlog_reader.h"
+
+#include <assert.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cbus.h"
+#include "diag.h"
+#include "error.h"
+#include "fiber.h"
+#include "fiber_cond.h"
+#include "salad/stailq.h"
+#include "trivia/util.h"
+#include "xlog.h"
+#include "xrow.h"
+
+enum {
+	/**
+	 * Approximate amount of decompressed row data the reader
+	 * thread passes to the consumer in one message.
+	 */
+	XLOG_READER_BATCH_SIZE = 1024 * 1024,
+	/**
+	 * Max number of batches read ahead of the consumer.
+	 */
+	XLOG_READER_QUEUE_MAX = 4,
+};
+
+/** A bunch of rows read by the reader thread. */
+struct xlog_reader_batch {
+	/** Link in xlog_reader::queue. */
+	struct stailq_entry in_queue;
+	/** Decompressed rows. Row bodies point here. */
+	char *data;
+	/** Decoded row headers. */
+	struct xrow_header *rows;
+	/** Number of rows in the batch. */
+	int row_count;
+	/** Index of the next row to return to the consumer. */
+	int row_pos;
+};
+
+struct xlog_reader {
+	/** Reader thread. */
+	struct cord cord;
+	/** Pipe from the consumer thread to the reader thread. */
+	struct cpipe reader_pipe;
+	/** Pipe from the reader thread to the consumer thread. */
+	struct cpipe tx_pipe;
+	/**
+	 * Cursor used for reading the file. Accessed only from
+	 * the reader thread, because it allocates its buffers
+	 * on the thread slab cache.
+	 */
+	struct xlog_cursor cursor;
+	/** Name of the file to read. */
+	char filename[PATH_MAX];
+	/**
+	 * Fiber that forwards read requests to the reader thread
+	 * and fills the queue while the consumer applies rows.
+	 */
+	struct fiber *prefetch_fiber;
+	/** Batches read ahead, linked by in_queue. */
+	struct stailq queue;
+	/** Number of batches in the queue. */
+	int queue_len;
+	/** Batch the consumer is currently reading. */
+	struct xlog_reader_batch *batch;
+	/** Signaled when the queue or the reader state changes. */
+	struct fiber_cond cond;
+	/** Set if the prefetch fiber has nothing more to read. */
+	bool is_done;
+	/** Set if the consumer wants the prefetch fiber to stop. */
+	bool is_stopping;
+	/** Set if the reader has found the EOF marker. */
+	bool is_eof;
+	/** Error that stopped the prefetch fiber. */
+	struct diag diag;
+};
+
+/** Message sent to the reader thread to read the next batch. */
+struct xlog_reader_msg {
+	struct cbus_call_msg base;
+	struct xlog_reader *reader;
+	/** [out] Read batch or NULL if there's no more rows. */
+	struct xlog_reader_batch *batch;
+	/** [out] Set if there's nothing more to read. */
+	bool is_done;
+	/** [out] Set if the EOF marker was found. */
+	bool is_eof;
+};
+
+static void
+xlog_reader_batch_delete(struct xlog_reader_batch *batch)
+{
+	free(batch->rows);
+	free(batch->data);
+	free(batch);
+}
+
+/**
+ * Read the next batch of rows. Runs in the reader thread.
+ */
+static int
+xlog_reader_read_f(struct cbus_call_msg *base)
+{
+	struct xlog_reader_msg *msg = (struct xlog_reader_msg *)base;
+	struct xlog_reader *reader = msg->reader;
+	struct xlog_cursor *cursor = &reader->cursor;
+
+	if (cursor->state == XLOG_CURSOR_NEW &&
+	    xlog_cursor_open(cursor, reader->filename) != 0)
+		return -1;
+
+	char *data = NULL;
+	size_t size = 0;
+	size_t capacity = 0;
+	while (size < XLOG_READER_BATCH_SIZE) {
+		int rc = xlog_cursor_next_tx(cursor);
+		if (rc < 0)
+			goto fail;
+		if (rc > 0) {
+			msg->is_done = true;
+			msg->is_eof = xlog_cursor_is_eof(cursor);
+			break;
+		}
+		struct ibuf *rows = &cursor->tx_cursor.rows;
+		size_t len = ibuf_used(rows);
+		if (size + len > capacity) {
+			capacity = MAX(size + len, 2 * capacity);
+			data = xrealloc(data, capacity);
+		}
+		memcpy(data + size, rows->rpos, len);
+		size += len;
+		/*
+		 * The rows were copied, discard them so that
+		 * the cursor closes the current transaction.
+		 */
+		ibuf_reset(rows);
+		struct xrow_header unused;
+		rc = xlog_cursor_next_row(cursor, &unused);
+		assert(rc == 1);
+		(void)rc;
+	}
+	if (size == 0) {
+		free(data);
+		return 0;
+	}
+
+	struct xlog_reader_batch *batch = xmalloc(sizeof(*batch));
+	batch->data = data;
+	batch->rows = NULL;
+	batch->row_count = 0;
+	batch->row_pos = 0;
+	int row_capacity = 0;
+	const char *pos = data;
+	const char *end = data + size;
+	while (pos < end) {
+		if (batch->row_count == row_capacity) {
+			row_capacity = MAX(2 * row_capacity, 64);
+			batch->rows = xrealloc(batch->rows, row_capacity *
+					       sizeof(*batch->rows));
+		}
+		struct xrow_header *row = &batch->rows[batch->row_count];
+		if (xrow_header_decode(row, &pos, end, false) != 0) {
+			diag_set(XlogError, "can't parse row");
+			xlog_reader_batch_delete(batch);
+			return -1;
+		}
+		batch->row_count++;
+	}
+	msg->batch = batch;
+	return 0;
+fail:
+	free(data);
+	return -1;
+}
+
+/** Reader thread function. */
+static int
+xlog_reader_f(va_list ap)
+{
+	struct xlog_reader *reader = va_arg(ap, struct xlog_reader *);
+	struct cbus_endpoint endpoint;
+
+	cpipe_create(&reader->tx_pipe, "tx_prio");
+	cbus_endpoint_create(&endpoint, cord_name(cord()),
+			     fiber_schedule_cb, fiber());
+	cbus_loop(&endpoint);
+	cbus_endpoint_destroy(&endpoint, cbus_process);
+	cpipe_destroy(&reader->tx_pipe);
+	if (xlog_cursor_is_open(&reader->cursor))
+		xlog_cursor_close(&reader->cursor, false);
+	return 0;
+}
+
+/**
+ * Prefetch fiber function. Keeps the queue filled with batches
+ * read by the reader thread.
+ */
+static int
+xlog_reader_prefetch_f(va_list ap)
+{
+	struct xlog_reader *reader = va_arg(ap, struct xlog_reader *);
+	while (!reader->is_done) {
+		if (reader->is_stopping)
+			break;
+		if (reader->queue_len >= XLOG_READER_QUEUE_MAX) {
+			fiber_cond_wait(&reader->cond);
+			continue;
+		}
+		struct xlog_reader_msg msg;
+		msg.reader = reader;
+		msg.batch = NULL;
+		msg.is_done = false;
+		msg.is_eof = false;
+		bool cancellable = fiber_set_cancellable(false);
+		int rc = cbus_call(&reader->reader_pipe, &reader->tx_pipe,
+				   &msg.base, xlog_reader_read_f, NULL,
+				   TIMEOUT_INFINITY);
+		fiber_set_cancellable(cancellable);
+		if (rc != 0) {
+			diag_move(diag_get(), &reader->diag);
+			reader->is_done = true;
+		} else {
+			if (msg.batch != NULL) {
+				stailq_add_tail_entry(&reader->queue,
+						      msg.batch, in_queue);
+				reader->queue_len++;
+			}
+			reader->is_done = msg.is_done;
+			reader->is_eof = msg.is_eof;
+		}
+		fiber_cond_broadcast(&reader->cond);
+	}
+	return 0;
+}
+
+struct xlog_reader *
+xlog_reader_new(const char *filename)
+{
+	static unsigned reader_id;
+	struct xlog_reader *reader = xcalloc(1, sizeof(*reader));
+	snprintf(reader->filename, sizeof(reader->filename), "%s", filename);
+	stailq_create(&reader->queue);
+	fiber_cond_create(&reader->cond);
+	diag_create(&reader->diag);
+
+	char name[FIBER_NAME_MAX];
+	snprintf(name, sizeof(name), "xlog.reader.%u", reader_id++);
+	if (cord_costart(&reader->cord, name, xlog_reader_f, reader) != 0)
+		goto fail;
+	cpipe_create(&reader->reader_pipe, name);
+
+	reader->prefetch_fiber = fiber_new("xlog.prefetch",
+					   xlog_reader_prefetch_f);
+	if (reader->prefetch_fiber == NULL) {
+		cbus_stop_loop(&reader->reader_pipe);
+		cpipe_destroy(&reader->reader_pipe);
+		cord_join(&reader->cord);
+		goto fail;
+	}
+	fiber_set_joinable(reader->prefetch_fiber, true);
+	fiber_start(reader->prefetch_fiber, reader);
+	return reader;
+fail:
+	fiber_cond_destroy(&reader->cond);
+	diag_destroy(&reader->diag);
+	free(reader);
+	return NULL;
+}
+
+void
+xlog_reader_delete(struct xlog_reader *reader)
+{
+	reader->is_stopping = true;
+	fiber_cond_broadcast(&reader->cond);
+	fiber_join(reader->prefetch_fiber);
+
+	cbus_stop_loop(&reader->reader_pipe);
+	cpipe_destroy(&reader->reader_pipe);
+	if (cord_cojoin(&reader->cord) != 0)
+		diag_log();
+
+	if (reader->batch != NULL)
+		xlog_reader_batch_delete(reader->batch);
+	struct xlog_reader_batch *batch, *tmp;
+	stailq_foreach_entry_safe(batch, tmp, &reader->queue, in_queue)
+		xlog_reader_batch_delete(batch);
+	fiber_cond_destroy(&reader->cond);
+	diag_destroy(&reader->diag);
+	free(reader);
+}
+
+int
+xlog_reader_next(struct xlog_reader *reader, struct xrow_header *row)
+{
+	struct xlog_reader_batch *batch = reader->batch;
+	while (batch == NULL || batch->row_pos == batch->row_count) {
+		if (batch != NULL) {
+			xlog_reader_batch_delete(batch);
+			reader->batch = batch = NULL;
+		}
+		while (stailq_empty(&reader->queue) && !reader->is_done) {
+			if (fiber_cond_wait(&reader->cond) != 0)
+				return -1;
+		}
+		if (stailq_empty(&reader->queue)) {
+			if (!diag_is_empty(&reader->diag)) {
+				diag_move(&reader->diag, diag_get());
+				return -1;
+			}
+			return 1;
+		}
+		batch = stailq_shift_entry(&reader->queue,
+					   struct xlog_reader_batch, in_queue);
+		reader->queue_len--;
+		reader->batch = batch;
+		fiber_cond_broadcast(&reader->cond);
+	}
+	*row = batch->rows[batch->row_pos++];
+	return 0;
+}
+
+bool
+xlog_reader_is_eof(struct xlog_reader *reader)
+{
+	return reader->is_eof;
+}
+
+const char *
+xlog_reader_name(struct xlog_reader *reader)
+{
+	return reader->filename;
+}
@@ -0,0 +1,63 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2021, Tarantool AUTHORS, please see AUTHORS file.
+ */
+#pragma once
+
+#include <stdbool.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+struct xlog_reader;
+struct xrow_header;
+
+/**
+ * Create a reader for the xlog file with the given name.
+ *
+ * The reader starts a background thread which reads the file,
+ * verifies checksums, decompresses transactions and decodes row
+ * headers ahead of the consumer, so that the calling thread only
+ * has to apply the rows it fetches with xlog_reader_next().
+ *
+ * Returns NULL and sets diag on failure.
+ */
+struct xlog_reader *
+xlog_reader_new(const char *filename);
+
+/**
+ * Stop the background thread and free the reader.
+ */
+void
+xlog_reader_delete(struct xlog_reader *reader);
+
+/**
+ * Fetch the next row from the reader. Yields if the background
+ * thread hasn't read it yet. The row body points to memory owned
+ * by the reader and remains valid until the next call.
+ *
+ * @retval 0 success
+ * @retval 1 no more rows
+ * @retval -1 error, check diag
+ */
+int
+xlog_reader_next(struct xlog_reader *reader, struct xrow_header *row);
+
+/**
+ * Return true if the reader has reached the EOF marker of the
+ * file. Makes sense only after xlog_reader_next() returned 1.
+ */
+bool
+xlog_reader_is_eof(struct xlog_reader *reader);
+
+/**
+ * Return the name of the file the reader reads.
+ */
+const char *
+xlog_reader_name(struct xlog_reader *reader);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
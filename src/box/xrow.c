@@ -41,6 +41,7 @@
 #include "tt_static.h"
 #include "error.h"
 #include "mp_error.h"
+#include "mp_skip.h"
 #include "scramble.h"
 #include "iproto_constants.h"
 #include "iproto_features.h"
@@ -146,7 +147,7 @@ xrow_header_decode(struct xrow_header *header, const char **pos,
 	memset(header, 0, sizeof(struct xrow_header));
 	const char *tmp = *pos;
 	const char * const start = *pos;
-	if (mp_check(&tmp, end) != 0)
+	if (mp_check_fast(&tmp, end) != 0)
 		goto bad_header;
 	if (mp_typeof(**pos) != MP_MAP)
 		goto bad_header;
@@ -194,6 +195,9 @@ xrow_header_decode(struct xrow_header *header, const char **pos,
 		case IPROTO_STREAM_ID:
 			header->stream_id = mp_decode_uint(pos);
 			break;
+		case IPROTO_REQUEST_TIMEOUT:
+			header->timeout = mp_decode_double(pos);
+			break;
 		default:
 			/* unknown header */
 			mp_next(pos);
@@ -213,7 +217,7 @@ xrow_header_decode(struct xrow_header *header, const char **pos,
 	/* Nop requests aren't supposed to have a body. */
 	if (*pos < end && header->type != IPROTO_NOP) {
 		const char *body = *pos;
-		if (mp_check(pos, end))
+		if (mp_check_fast(pos, end))
 			goto bad_body;
 		header->bodycnt = 1;
 		header->body[0].iov_base = (void *) body;
@@ -667,16 +671,58 @@ iproto_prepare_header(struct obuf *buf, struct obuf_svp *svp, size_t size)
 void
 iproto_reply_select(struct obuf *buf, struct obuf_svp *svp, uint64_t sync,
 		    uint32_t schema_version, uint32_t count)
+{
+	iproto_reply_select_ext(buf, svp, sync, schema_version, count, 0);
+}
+
+int
+iproto_reply_select_with_position(struct obuf *buf, struct obuf_svp *svp,
+				  uint64_t sync, uint32_t schema_version,
+				  uint32_t count, const char *packed_pos,
+				  const char *packed_pos_end)
+{
+	uint32_t pos_size = packed_pos_end - packed_pos;
+	size_t size = mp_sizeof_uint(IPROTO_POSITION) +
+		      mp_sizeof_str(pos_size);
+	char *ptr = (char *)obuf_alloc(buf, size);
+	if (ptr == NULL) {
+		diag_set(OutOfMemory, size, "obuf_alloc", "ptr");
+		return -1;
+	}
+	ptr = mp_encode_uint(ptr, IPROTO_POSITION);
+	mp_encode_str(ptr, packed_pos, pos_size);
+	iproto_reply_select(buf, svp, sync, schema_version, count);
+	/* The body is a map of IPROTO_DATA and IPROTO_POSITION. */
+	char *body = (char *)obuf_svp_to_ptr(buf, svp) + IPROTO_HEADER_LEN;
+	assert(*body == (char)0x81);
+	*body = (char)0x82;
+	return 0;
+}
+
+void
+iproto_reply_select_ext(struct obuf *buf, struct obuf_svp *svp,
+			uint64_t sync, uint32_t schema_version,
+			uint32_t count, size_t ext_size)
 {
 	char *pos = (char *) obuf_svp_to_ptr(buf, svp);
-	iproto_header_encode(pos, IPROTO_OK, sync, schema_version,
-			        obuf_size(buf) - svp->used -
-				IPROTO_HEADER_LEN);
+	iproto_select_header_encode(pos, sync, schema_version, count,
+				    obuf_size(buf) - svp->used -
+				    IPROTO_SELECT_HEADER_LEN + ext_size);
+}
+
+void
+iproto_select_header_encode(char *data, uint64_t sync,
+			    uint32_t schema_version, uint32_t count,
+			    size_t data_size)
+{
+	iproto_header_encode(data, IPROTO_OK, sync, schema_version,
+			     IPROTO_SELECT_HEADER_LEN - IPROTO_HEADER_LEN +
+			     data_size);
 
 	struct iproto_body_bin body = iproto_body_bin;
 	body.v_data_len = mp_bswap_u32(count);
 
-	memcpy(pos + IPROTO_HEADER_LEN, &body, sizeof(body));
+	memcpy(data + IPROTO_HEADER_LEN, &body, sizeof(body));
 }
 
 int
@@ -751,11 +797,9 @@ iproto_reply_chunk(struct obuf *buf, struct obuf_svp *svp, uint64_t sync,
 	memcpy(pos + IPROTO_HEADER_LEN, &body, sizeof(body));
 }
 
-int
-iproto_send_event(struct obuf *out, const char *key, size_t key_len,
-		  const char *data, const char *data_end)
+size_t
+iproto_event_size(size_t key_len, const char *data, const char *data_end)
 {
-	/* Calculate the packet size. */
 	size_t size = 5;
 	/* Packet header. Note: no sync and schema version. */
 	size += mp_sizeof_map(1);
@@ -769,12 +813,14 @@ iproto_send_event(struct obuf *out, const char *key, size_t key_len,
 		size += mp_sizeof_uint(IPROTO_EVENT_DATA);
 		size += data_end - data;
 	}
-	/* Encode the packet. */
-	char *buf = obuf_alloc(out, size);
-	if (buf == NULL) {
-		diag_set(OutOfMemory, size, "obuf_alloc", "buf");
-		return -1;
-	}
+	return size;
+}
+
+void
+iproto_encode_event(char *buf, size_t size, const char *key, size_t key_len,
+		    const char *data, const char *data_end)
+{
+	assert(size == iproto_event_size(key_len, data, data_end));
 	char *p = buf;
 	/* Fix header. */
 	*(p++) = 0xce;
@@ -795,7 +841,6 @@ iproto_send_event(struct obuf *out, const char *key, size_t key_len,
 	}
 	assert(size == (size_t)(p - buf));
 	(void)p;
-	return 0;
 }
 
 int
@@ -811,6 +856,7 @@ xrow_decode_dml(struct xrow_header *row, struct request *request,
 
 	assert(row->bodycnt == 1);
 	const char *data = (const char *) row->body[0].iov_base;
+	const char *end = data + row->body[0].iov_len;
 	if (mp_typeof(*data) != MP_MAP) {
 error:
 		xrow_on_decode_err(row, ER_INVALID_MSGPACK, "packet body");
@@ -826,7 +872,18 @@ error:
 		}
 		uint64_t key = mp_decode_uint(&data);
 		const char *value = data;
-		mp_next(&data);
+		if (i == size - 1) {
+			/*
+			 * The body is exactly one MsgPack map, so its last
+			 * value ends where the body ends. Clients usually
+			 * put the tuple last, so big tuples aren't walked
+			 * once again after the body check.
+			 */
+			data = end;
+		} else {
+			/* Tuples and keys are mostly runs of small integers. */
+			mp_next_fast(&data, end);
+		}
 		if (key >= IPROTO_KEY_MAX ||
 		    iproto_key_type[key] != mp_typeof(*value))
 			goto error;
@@ -866,6 +923,20 @@ error:
 			request->tuple_meta = value;
 			request->tuple_meta_end = data;
 			break;
+		case IPROTO_AFTER_POSITION: {
+			uint32_t len;
+			request->after_position = mp_decode_str(&value, &len);
+			request->after_position_end =
+				request->after_position + len;
+			break;
+		}
+		case IPROTO_AFTER_TUPLE:
+			request->after_tuple = value;
+			request->after_tuple_end = data;
+			break;
+		case IPROTO_FETCH_POSITION:
+			request->fetch_position = mp_decode_bool(&value);
+			break;
 		default:
 			break;
 		}
@@ -1674,16 +1745,78 @@ xrow_encode_register(struct xrow_header *row,
 	return 0;
 }
 
+static int
+xrow_subscribe_filter_cmp_space_id(const void *a, const void *b)
+{
+	uint32_t lhs = *(const uint32_t *)a;
+	uint32_t rhs = *(const uint32_t *)b;
+	return lhs < rhs ? -1 : lhs > rhs;
+}
+
+bool
+xrow_subscribe_filter_match(const struct xrow_subscribe_filter *filter,
+			    const struct xrow_header *row)
+{
+	assert(iproto_type_is_dml(row->type));
+	if (filter->type_mask != 0 &&
+	    (row->type >= 64 || (filter->type_mask & (1ULL << row->type)) == 0))
+		return false;
+	if (filter->space_ids == NULL)
+		return true;
+	if (row->bodycnt == 0)
+		return false;
+	assert(row->bodycnt == 1);
+	const char *d = (const char *)row->body[0].iov_base;
+	if (mp_typeof(*d) != MP_MAP)
+		return false;
+	uint32_t map_size = mp_decode_map(&d);
+	for (uint32_t i = 0; i < map_size; i++) {
+		if (mp_typeof(*d) != MP_UINT) {
+			mp_next(&d); /* key */
+			mp_next(&d); /* value */
+			continue;
+		}
+		uint64_t key = mp_decode_uint(&d);
+		if (key != IPROTO_SPACE_ID) {
+			mp_next(&d); /* value */
+			continue;
+		}
+		if (mp_typeof(*d) != MP_UINT)
+			return false;
+		uint64_t space_id = mp_decode_uint(&d);
+		if (space_id > UINT32_MAX)
+			return false;
+		uint32_t id = space_id;
+		return bsearch(&id, filter->space_ids, filter->space_id_count,
+			       sizeof(id),
+			       xrow_subscribe_filter_cmp_space_id) != NULL;
+	}
+	return false;
+}
+
 int
 xrow_encode_subscribe(struct xrow_header *row,
 		      const struct tt_uuid *replicaset_uuid,
 		      const struct tt_uuid *instance_uuid,
 		      const struct vclock *vclock, bool anon,
-		      uint32_t id_filter)
+		      uint32_t id_filter,
+		      const struct iproto_features *features,
+		      const struct xrow_subscribe_filter *filter)
 {
 	memset(row, 0, sizeof(*row));
+	if (filter != NULL && xrow_subscribe_filter_is_empty(filter))
+		filter = NULL;
 	size_t size = XROW_BODY_LEN_MAX +
-		      mp_sizeof_vclock_ignore0(vclock);
+		      mp_sizeof_vclock_ignore0(vclock) +
+		      mp_sizeof_uint(IPROTO_FEATURES) +
+		      mp_sizeof_iproto_features(features);
+	if (filter != NULL) {
+		size += mp_sizeof_uint(IPROTO_SPACE_FILTER) +
+			mp_sizeof_array(filter->space_id_count) +
+			filter->space_id_count * mp_sizeof_uint(UINT32_MAX) +
+			mp_sizeof_uint(IPROTO_TYPE_FILTER) +
+			mp_sizeof_array(64) + 64 * mp_sizeof_uint(63);
+	}
 	char *buf = (char *) region_alloc(&fiber()->gc, size);
 	if (buf == NULL) {
 		diag_set(OutOfMemory, size, "region_alloc", "buf");
@@ -1691,7 +1824,12 @@ xrow_encode_subscribe(struct xrow_header *row,
 	}
 	char *data = buf;
 	int filter_size = bit_count_u32(id_filter);
-	data = mp_encode_map(data, filter_size != 0 ? 6 : 5);
+	uint32_t map_size = filter_size != 0 ? 7 : 6;
+	if (filter != NULL) {
+		map_size += (filter->space_ids != NULL) +
+			    (filter->type_mask != 0);
+	}
+	data = mp_encode_map(data, map_size);
 	data = mp_encode_uint(data, IPROTO_CLUSTER_UUID);
 	data = xrow_encode_uuid(data, replicaset_uuid);
 	data = mp_encode_uint(data, IPROTO_INSTANCE_UUID);
@@ -1702,6 +1840,8 @@ xrow_encode_subscribe(struct xrow_header *row,
 	data = mp_encode_uint(data, tarantool_version_id());
 	data = mp_encode_uint(data, IPROTO_REPLICA_ANON);
 	data = mp_encode_bool(data, anon);
+	data = mp_encode_uint(data, IPROTO_FEATURES);
+	data = mp_encode_iproto_features(data, features);
 	if (filter_size != 0) {
 		data = mp_encode_uint(data, IPROTO_ID_FILTER);
 		data = mp_encode_array(data, filter_size);
@@ -1713,6 +1853,23 @@ xrow_encode_subscribe(struct xrow_header *row,
 			data = mp_encode_uint(data, id);
 		}
 	}
+	if (filter != NULL && filter->space_ids != NULL) {
+		data = mp_encode_uint(data, IPROTO_SPACE_FILTER);
+		data = mp_encode_array(data, filter->space_id_count);
+		for (uint32_t i = 0; i < filter->space_id_count; i++)
+			data = mp_encode_uint(data, filter->space_ids[i]);
+	}
+	if (filter != NULL && filter->type_mask != 0) {
+		data = mp_encode_uint(data, IPROTO_TYPE_FILTER);
+		data = mp_encode_array(data, bit_count_u64(filter->type_mask));
+		struct bit_iterator it;
+		bit_iterator_init(&it, &filter->type_mask,
+				  sizeof(filter->type_mask), true);
+		for (size_t type = bit_iterator_next(&it); type != SIZE_MAX;
+		     type = bit_iterator_next(&it)) {
+			data = mp_encode_uint(data, type);
+		}
+	}
 	assert(data <= buf + size);
 	row->body[0].iov_base = buf;
 	row->body[0].iov_len = (data - buf);
@@ -1725,7 +1882,9 @@ int
 xrow_decode_subscribe(const struct xrow_header *row,
 		      struct tt_uuid *replicaset_uuid,
 		      struct tt_uuid *instance_uuid, struct vclock *vclock,
-		      uint32_t *version_id, bool *anon, uint32_t *id_filter)
+		      uint32_t *version_id, bool *anon, uint32_t *id_filter,
+		      struct iproto_features *features,
+		      struct xrow_subscribe_filter *filter)
 {
 	if (row->bodycnt == 0) {
 		diag_set(ClientError, ER_INVALID_MSGPACK, "request body");
@@ -1750,6 +1909,10 @@ xrow_decode_subscribe(const struct xrow_header *row,
 		*anon = false;
 	if (id_filter != NULL)
 		*id_filter = 0;
+	if (features != NULL)
+		iproto_features_create(features);
+	if (filter != NULL)
+		xrow_subscribe_filter_create(filter);
 
 	uint32_t map_size = mp_decode_map(&d);
 	for (uint32_t i = 0; i < map_size; i++) {
@@ -1825,6 +1988,68 @@ id_filter_decode_err:		xrow_on_decode_err(row, ER_INVALID_MSGPACK,
 				*id_filter |= 1 << val;
 			}
 			break;
+		case IPROTO_SPACE_FILTER: {
+			if (filter == NULL)
+				goto skip;
+			if (mp_typeof(*d) != MP_ARRAY) {
+space_filter_decode_err:	xrow_on_decode_err(row, ER_INVALID_MSGPACK,
+						   "invalid SPACE_FILTER");
+				return -1;
+			}
+			uint32_t count = mp_decode_array(&d);
+			if (count == 0)
+				break;
+			size_t size;
+			uint32_t *ids = region_alloc_array(&fiber()->gc,
+							   uint32_t, count,
+							   &size);
+			if (ids == NULL) {
+				diag_set(OutOfMemory, size,
+					 "region_alloc_array", "ids");
+				return -1;
+			}
+			for (uint32_t i = 0; i < count; i++) {
+				if (mp_typeof(*d) != MP_UINT)
+					goto space_filter_decode_err;
+				uint64_t val = mp_decode_uint(&d);
+				if (val > UINT32_MAX)
+					goto space_filter_decode_err;
+				ids[i] = val;
+			}
+			qsort(ids, count, sizeof(*ids),
+			      xrow_subscribe_filter_cmp_space_id);
+			filter->space_ids = ids;
+			filter->space_id_count = count;
+			break;
+		}
+		case IPROTO_TYPE_FILTER: {
+			if (filter == NULL)
+				goto skip;
+			if (mp_typeof(*d) != MP_ARRAY) {
+type_filter_decode_err:		xrow_on_decode_err(row, ER_INVALID_MSGPACK,
+						   "invalid TYPE_FILTER");
+				return -1;
+			}
+			uint32_t count = mp_decode_array(&d);
+			for (uint32_t i = 0; i < count; i++) {
+				if (mp_typeof(*d) != MP_UINT)
+					goto type_filter_decode_err;
+				uint64_t val = mp_decode_uint(&d);
+				if (val >= 64)
+					goto type_filter_decode_err;
+				filter->type_mask |= 1ULL << val;
+			}
+			break;
+		}
+		case IPROTO_FEATURES:
+			if (features == NULL)
+				goto skip;
+			if (mp_decode_iproto_features(&d, features) != 0) {
+				xrow_on_decode_err(row, ER_INVALID_MSGPACK,
+						   "invalid FEATURES");
+				return -1;
+			}
+			break;
 		default: skip:
 			mp_next(&d); /* value */
 		}
@@ -1922,6 +2147,157 @@ xrow_encode_timestamp(struct xrow_header *row, uint32_t replica_id, double tm)
 	row->tm = tm;
 }
 
+int
+xrow_encode_heartbeat(struct xrow_header *row, uint32_t replica_id, double tm,
+		      double lease_ts)
+{
+	xrow_encode_timestamp(row, replica_id, tm);
+	if (lease_ts == 0)
+		return 0;
+	size_t size = mp_sizeof_map(1) + mp_sizeof_uint(IPROTO_LEASE_TS) +
+		      mp_sizeof_double(lease_ts);
+	char *buf = (char *)region_alloc(&fiber()->gc, size);
+	if (buf == NULL) {
+		diag_set(OutOfMemory, size, "region_alloc", "buf");
+		return -1;
+	}
+	char *data = buf;
+	data = mp_encode_map(data, 1);
+	data = mp_encode_uint(data, IPROTO_LEASE_TS);
+	data = mp_encode_double(data, lease_ts);
+	assert(data <= buf + size);
+	row->body[0].iov_base = buf;
+	row->body[0].iov_len = (data - buf);
+	row->bodycnt = 1;
+	return 0;
+}
+
+int
+xrow_encode_ack(struct xrow_header *row, const struct vclock *vclock,
+		double lease_ts)
+{
+	memset(row, 0, sizeof(*row));
+	size_t size = mp_sizeof_map(2) + mp_sizeof_uint(IPROTO_VCLOCK) +
+		      mp_sizeof_vclock_ignore0(vclock) +
+		      mp_sizeof_uint(IPROTO_LEASE_TS) +
+		      mp_sizeof_double(lease_ts);
+	char *buf = (char *)region_alloc(&fiber()->gc, size);
+	if (buf == NULL) {
+		diag_set(OutOfMemory, size, "region_alloc", "buf");
+		return -1;
+	}
+	char *data = buf;
+	data = mp_encode_map(data, lease_ts != 0 ? 2 : 1);
+	data = mp_encode_uint(data, IPROTO_VCLOCK);
+	data = mp_encode_vclock_ignore0(data, vclock);
+	if (lease_ts != 0) {
+		data = mp_encode_uint(data, IPROTO_LEASE_TS);
+		data = mp_encode_double(data, lease_ts);
+	}
+	assert(data <= buf + size);
+	row->body[0].iov_base = buf;
+	row->body[0].iov_len = (data - buf);
+	row->bodycnt = 1;
+	row->type = IPROTO_OK;
+	return 0;
+}
+
+int
+xrow_decode_lease_ts(const struct xrow_header *row, double *lease_ts)
+{
+	*lease_ts = 0;
+	if (row->bodycnt == 0)
+		return 0;
+	assert(row->bodycnt == 1);
+	const char *d = (const char *)row->body[0].iov_base;
+	if (mp_typeof(*d) != MP_MAP) {
+		xrow_on_decode_err(row, ER_INVALID_MSGPACK, "request body");
+		return -1;
+	}
+	uint32_t map_size = mp_decode_map(&d);
+	for (uint32_t i = 0; i < map_size; i++) {
+		if (mp_typeof(*d) != MP_UINT) {
+			mp_next(&d); /* key */
+			mp_next(&d); /* value */
+			continue;
+		}
+		if (mp_decode_uint(&d) != IPROTO_LEASE_TS) {
+			mp_next(&d);
+			continue;
+		}
+		if (mp_read_double(&d, lease_ts) != 0) {
+			xrow_on_decode_err(row, ER_INVALID_MSGPACK,
+					   "lease timestamp");
+			return -1;
+		}
+		return 0;
+	}
+	return 0;
+}
+
+int
+xrow_encode_compressed_rows(struct xrow_header *row, const char *data,
+			    size_t size)
+{
+	memset(row, 0, sizeof(*row));
+	size_t prefix_size = mp_sizeof_map(1) + mp_sizeof_uint(IPROTO_DATA) +
+			     mp_sizeof_binl(size);
+	char *buf = (char *)region_alloc(&fiber()->gc, prefix_size);
+	if (buf == NULL) {
+		diag_set(OutOfMemory, prefix_size, "region_alloc", "buf");
+		return -1;
+	}
+	char *p = buf;
+	p = mp_encode_map(p, 1);
+	p = mp_encode_uint(p, IPROTO_DATA);
+	p = mp_encode_binl(p, size);
+	assert(p == buf + prefix_size);
+	row->body[0].iov_base = buf;
+	row->body[0].iov_len = prefix_size;
+	row->body[1].iov_base = (char *)data;
+	row->body[1].iov_len = size;
+	row->bodycnt = 2;
+	row->type = IPROTO_COMPRESSED_ROWS;
+	return 0;
+}
+
+int
+xrow_decode_compressed_rows(const struct xrow_header *row, const char **data,
+			    size_t *size)
+{
+	if (row->bodycnt == 0) {
+		diag_set(ClientError, ER_INVALID_MSGPACK, "request body");
+		return -1;
+	}
+	assert(row->bodycnt == 1);
+	const char *d = (const char *)row->body[0].iov_base;
+	if (mp_typeof(*d) != MP_MAP)
+		goto error;
+	*data = NULL;
+	*size = 0;
+	uint32_t map_size = mp_decode_map(&d);
+	for (uint32_t i = 0; i < map_size; i++) {
+		if (mp_typeof(*d) != MP_UINT)
+			goto error;
+		uint64_t key = mp_decode_uint(&d);
+		if (key != IPROTO_DATA) {
+			mp_next(&d);
+			continue;
+		}
+		if (mp_typeof(*d) != MP_BIN)
+			goto error;
+		uint32_t len;
+		*data = mp_decode_bin(&d, &len);
+		*size = len;
+	}
+	if (*data == NULL)
+		goto error;
+	return 0;
+error:
+	xrow_on_decode_err(row, ER_INVALID_MSGPACK, "compressed rows");
+	return -1;
+}
+
 void
 xrow_encode_type(struct xrow_header *row, uint16_t type)
 {
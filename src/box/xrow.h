@@ -88,6 +88,12 @@ struct xrow_header {
 	 * Zero if stream is not used.
 	 */
 	uint64_t stream_id;
+	/**
+	 * Time the client is going to wait for the reply to the
+	 * request, in seconds. Zero if not set. Never written to
+	 * the write ahead log.
+	 */
+	double timeout;
 	/** Transaction meta flags set only in the last transaction row. */
 	union {
 		uint8_t flags;
@@ -196,6 +202,14 @@ struct request {
 	const char *tuple_meta_end;
 	/** Base field offset for UPDATE/UPSERT, e.g. 0 for C and 1 for Lua. */
 	int index_base;
+	/** Select position to start after. */
+	const char *after_position;
+	const char *after_position_end;
+	/** Select tuple to start after. */
+	const char *after_tuple;
+	const char *after_tuple_end;
+	/** Return the position of the last selected tuple. */
+	bool fetch_position;
 };
 
 /**
@@ -467,6 +481,50 @@ xrow_encode_register(struct xrow_header *row,
 		     const struct tt_uuid *instance_uuid,
 		     const struct vclock *vclock);
 
+/**
+ * Filter of rows sent to a subscriber, see IPROTO_SPACE_FILTER
+ * and IPROTO_TYPE_FILTER.
+ */
+struct xrow_subscribe_filter {
+	/**
+	 * Sorted ids of spaces to send rows of. NULL if rows of
+	 * all spaces are sent, which is also what an empty
+	 * IPROTO_SPACE_FILTER means.
+	 */
+	uint32_t *space_ids;
+	/** Number of ids in @a space_ids. */
+	uint32_t space_id_count;
+	/**
+	 * Mask of request types to send, with bit N set for type
+	 * N. 0 if rows of all types are sent.
+	 */
+	uint64_t type_mask;
+};
+
+/** Initialize a filter that lets all rows through. */
+static inline void
+xrow_subscribe_filter_create(struct xrow_subscribe_filter *filter)
+{
+	filter->space_ids = NULL;
+	filter->space_id_count = 0;
+	filter->type_mask = 0;
+}
+
+/** Return true if the filter lets all rows through. */
+static inline bool
+xrow_subscribe_filter_is_empty(const struct xrow_subscribe_filter *filter)
+{
+	return filter->space_ids == NULL && filter->type_mask == 0;
+}
+
+/**
+ * Check if a DML row passes a subscribe filter. The space id is
+ * looked up in the encoded row body, which isn't decoded.
+ */
+bool
+xrow_subscribe_filter_match(const struct xrow_subscribe_filter *filter,
+			    const struct xrow_header *row);
+
 /**
  * Encode SUBSCRIBE command.
  * @param[out] Row.
@@ -476,6 +534,8 @@ xrow_encode_register(struct xrow_header *row,
  * @param anon Whether it is an anonymous subscribe request or not.
  * @param id_filter A List of replica ids to skip rows from
  *		    when feeding a replica.
+ * @param features Protocol features supported by the replica.
+ * @param filter Filter of rows to send or NULL.
  *
  * @retval  0 Success.
  * @retval -1 Memory error.
@@ -485,7 +545,9 @@ xrow_encode_subscribe(struct xrow_header *row,
 		      const struct tt_uuid *replicaset_uuid,
 		      const struct tt_uuid *instance_uuid,
 		      const struct vclock *vclock, bool anon,
-		      uint32_t id_filter);
+		      uint32_t id_filter,
+		      const struct iproto_features *features,
+		      const struct xrow_subscribe_filter *filter);
 
 /**
  * Decode SUBSCRIBE command.
@@ -497,6 +559,9 @@ xrow_encode_subscribe(struct xrow_header *row,
  * @param[out] anon Whether it is an anonymous subscribe.
  * @param[out] id_filter A list of ids to skip rows from when
  *			 feeding a replica.
+ * @param[out] features Protocol features supported by the replica.
+ * @param[out] filter Filter of rows to send. The space ids are
+ *			allocated on the fiber region.
  *
  * @retval  0 Success.
  * @retval -1 Memory or format error.
@@ -505,7 +570,9 @@ int
 xrow_decode_subscribe(const struct xrow_header *row,
 		      struct tt_uuid *replicaset_uuid,
 		      struct tt_uuid *instance_uuid, struct vclock *vclock,
-		      uint32_t *version_id, bool *anon, uint32_t *id_filter);
+		      uint32_t *version_id, bool *anon, uint32_t *id_filter,
+		      struct iproto_features *features,
+		      struct xrow_subscribe_filter *filter);
 
 /**
  * Encode JOIN command.
@@ -532,7 +599,7 @@ xrow_decode_join(const struct xrow_header *row, struct tt_uuid *instance_uuid,
 		 uint32_t *version_id)
 {
 	return xrow_decode_subscribe(row, NULL, instance_uuid, NULL, version_id,
-				     NULL, NULL);
+				     NULL, NULL, NULL);
 }
 
 /**
@@ -551,7 +618,7 @@ xrow_decode_register(const struct xrow_header *row,
 		     uint32_t *version_id)
 {
 	return xrow_decode_subscribe(row, NULL, instance_uuid, vclock,
-				     version_id, NULL, NULL);
+				     version_id, NULL, NULL, NULL);
 }
 
 /**
@@ -576,7 +643,8 @@ xrow_encode_vclock(struct xrow_header *row, const struct vclock *vclock);
 static inline int
 xrow_decode_vclock(const struct xrow_header *row, struct vclock *vclock)
 {
-	return xrow_decode_subscribe(row, NULL, NULL, vclock, NULL, NULL, NULL);
+	return xrow_decode_subscribe(row, NULL, NULL, vclock, NULL, NULL, NULL,
+				     NULL);
 }
 
 /**
@@ -608,7 +676,7 @@ xrow_decode_subscribe_response(const struct xrow_header *row,
 			       struct vclock *vclock)
 {
 	return xrow_decode_subscribe(row, replicaset_uuid, NULL, vclock, NULL,
-				     NULL, NULL);
+				     NULL, NULL, NULL);
 }
 
 /**
@@ -620,6 +688,71 @@ xrow_decode_subscribe_response(const struct xrow_header *row,
 void
 xrow_encode_timestamp(struct xrow_header *row, uint32_t replica_id, double tm);
 
+/**
+ * Encode a heartbeat message carrying a leader lease timestamp.
+ * @param row[out] Row to encode into.
+ * @param replica_id Instance id.
+ * @param tm Time stamp.
+ * @param lease_ts Lease timestamp, omitted if 0.
+ *
+ * @retval  0 Success.
+ * @retval -1 Memory error.
+ */
+int
+xrow_encode_heartbeat(struct xrow_header *row, uint32_t replica_id, double tm,
+		      double lease_ts);
+
+/**
+ * Encode an ack sent by a replica to its master.
+ * @param row[out] Row to encode into.
+ * @param vclock Replica vclock.
+ * @param lease_ts Last lease timestamp received from the master,
+ *        omitted if 0.
+ *
+ * @retval  0 Success.
+ * @retval -1 Memory error.
+ */
+int
+xrow_encode_ack(struct xrow_header *row, const struct vclock *vclock,
+		double lease_ts);
+
+/**
+ * Decode a leader lease timestamp from a heartbeat or an ack.
+ * @param row Row to decode.
+ * @param[out] lease_ts Lease timestamp, 0 if there's none.
+ *
+ * @retval  0 Success.
+ * @retval -1 Format error.
+ */
+int
+xrow_decode_lease_ts(const struct xrow_header *row, double *lease_ts);
+
+/**
+ * Encode a batch of compressed rows.
+ * @param row[out] Row to encode into.
+ * @param data Compressed data. Not copied.
+ * @param size Size of the compressed data.
+ *
+ * @retval  0 Success.
+ * @retval -1 Memory error.
+ */
+int
+xrow_encode_compressed_rows(struct xrow_header *row, const char *data,
+			    size_t size);
+
+/**
+ * Decode a batch of compressed rows.
+ * @param row Row to decode.
+ * @param[out] data Compressed data. Points to the row body.
+ * @param[out] size Size of the compressed data.
+ *
+ * @retval  0 Success.
+ * @retval -1 Format error.
+ */
+int
+xrow_decode_compressed_rows(const struct xrow_header *row, const char **data,
+			    size_t *size);
+
 /**
  * Encode any bodyless message.
  * @param row[out] Row to encode into.
@@ -682,6 +815,38 @@ void
 iproto_reply_select(struct obuf *buf, struct obuf_svp *svp, uint64_t sync,
 		    uint32_t schema_version, uint32_t count);
 
+/**
+ * Same as iproto_reply_select(), but also appends IPROTO_POSITION
+ * with the given position to the response body after the result set.
+ * @retval  0 Success.
+ * @retval -1 Memory error.
+ */
+int
+iproto_reply_select_with_position(struct obuf *buf, struct obuf_svp *svp,
+				  uint64_t sync, uint32_t schema_version,
+				  uint32_t count, const char *packed_pos,
+				  const char *packed_pos_end);
+
+/**
+ * Same as iproto_reply_select(), but the result set isn't stored
+ * in the buffer: it is sent separately right after the header.
+ * @param ext_size Size of the result set data.
+ */
+void
+iproto_reply_select_ext(struct obuf *buf, struct obuf_svp *svp,
+			uint64_t sync, uint32_t schema_version,
+			uint32_t count, size_t ext_size);
+
+/**
+ * Encode a select response header to a buffer that is
+ * IPROTO_SELECT_HEADER_LEN bytes long.
+ * @param data_size Size of the result set following the header.
+ */
+void
+iproto_select_header_encode(char *data, uint64_t sync,
+			    uint32_t schema_version, uint32_t count,
+			    size_t data_size);
+
 /**
  * Encode iproto header with IPROTO_OK response code.
  * @param out Encode to.
@@ -789,19 +954,27 @@ iproto_reply_chunk(struct obuf *buf, struct obuf_svp *svp, uint64_t sync,
 		   uint32_t schema_version);
 
 /**
- * Encode IPROTO_EVENT packet.
- * @param out Encode to.
+ * Return the size of IPROTO_EVENT packet.
+ * @param key_len Length of the notification key name.
+ * @param data Notification data (MsgPack) or NULL.
+ * @param data_end End of notification data.
+ */
+size_t
+iproto_event_size(size_t key_len, const char *data, const char *data_end);
+
+/**
+ * Encode IPROTO_EVENT packet. The packet has no sync so it's the
+ * same for all sessions and may be sent to many of them.
+ * @param buf Encode to.
+ * @param size Size of the packet, see iproto_event_size().
  * @param key Notification key name.
  * @param key_len Length of the notification key name.
- * @param data Notification data (MsgPack).
+ * @param data Notification data (MsgPack) or NULL.
  * @param data_end End of notification data.
- *
- * @retval  0 Success.
- * @retval -1 Memory error.
  */
-int
-iproto_send_event(struct obuf *out, const char *key, size_t key_len,
-		  const char *data, const char *data_end);
+void
+iproto_encode_event(char *buf, size_t size, const char *key, size_t key_len,
+		    const char *data, const char *data_end);
 
 /** Write error directly to a socket. */
 void
@@ -1042,10 +1215,13 @@ xrow_encode_subscribe_xc(struct xrow_header *row,
 			 const struct tt_uuid *replicaset_uuid,
 			 const struct tt_uuid *instance_uuid,
 			 const struct vclock *vclock, bool anon,
-			 uint32_t id_filter)
+			 uint32_t id_filter,
+			 const struct iproto_features *features,
+			 const struct xrow_subscribe_filter *filter)
 {
 	if (xrow_encode_subscribe(row, replicaset_uuid, instance_uuid,
-				  vclock, anon, id_filter) != 0)
+				  vclock, anon, id_filter, features,
+				  filter) != 0)
 		diag_raise();
 }
 
@@ -1055,11 +1231,12 @@ xrow_decode_subscribe_xc(const struct xrow_header *row,
 			 struct tt_uuid *replicaset_uuid,
 			 struct tt_uuid *instance_uuid, struct vclock *vclock,
 			 uint32_t *replica_version_id, bool *anon,
-			 uint32_t *id_filter)
+			 uint32_t *id_filter, struct iproto_features *features,
+			 struct xrow_subscribe_filter *filter)
 {
 	if (xrow_decode_subscribe(row, replicaset_uuid, instance_uuid,
 				  vclock, replica_version_id, anon,
-				  id_filter) != 0)
+				  id_filter, features, filter) != 0)
 		diag_raise();
 }
 
@@ -1127,6 +1304,24 @@ xrow_decode_subscribe_response_xc(const struct xrow_header *row,
 		diag_raise();
 }
 
+/** @copydoc xrow_encode_compressed_rows. */
+static inline void
+xrow_encode_compressed_rows_xc(struct xrow_header *row, const char *data,
+			       size_t size)
+{
+	if (xrow_encode_compressed_rows(row, data, size) != 0)
+		diag_raise();
+}
+
+/** @copydoc xrow_decode_compressed_rows. */
+static inline void
+xrow_decode_compressed_rows_xc(const struct xrow_header *row,
+			       const char **data, size_t *size)
+{
+	if (xrow_decode_compressed_rows(row, data, size) != 0)
+		diag_raise();
+}
+
 /** @copydoc iproto_reply_ok. */
 static inline void
 iproto_reply_ok_xc(struct obuf *out, uint64_t sync, uint32_t schema_version)
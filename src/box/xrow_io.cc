@@ -62,7 +62,7 @@ coio_read_xrow(struct iostream *io, struct ibuf *in, struct xrow_header *row)
 			      true);
 }
 
-void
+size_t
 coio_read_xrow_timeout_xc(struct iostream *io, struct ibuf *in,
 			  struct xrow_header *row, ev_tstamp timeout)
 {
@@ -92,6 +92,7 @@ coio_read_xrow_timeout_xc(struct iostream *io, struct ibuf *in,
 
 	xrow_header_decode_xc(row, (const char **) &in->rpos, in->rpos + len,
 			      true);
+	return mp_sizeof_uint(len) + len;
 }
 
 
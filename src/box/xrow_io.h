@@ -41,7 +41,11 @@ struct xrow_header;
 void
 coio_read_xrow(struct iostream *io, struct ibuf *in, struct xrow_header *row);
 
-void
+/**
+ * Read a row with a timeout. Returns the size of the packet
+ * including the length prefix.
+ */
+size_t
 coio_read_xrow_timeout_xc(struct iostream *io, struct ibuf *in,
 			  struct xrow_header *row, double timeout);
 
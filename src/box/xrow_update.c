@@ -337,6 +337,83 @@ xrow_upsert_do_ops(struct xrow_update *update, const char *header,
 	return 0;
 }
 
+/**
+ * Apply an update consisting of a single set, arithmetic or
+ * bitwise operation on an existing top-level field, like an
+ * increment of a counter, without building the update tree: the
+ * new tuple is the old one with the single field replaced.
+ *
+ * @retval  1 The update isn't of this kind and must be done with
+ *            the update tree. The operation isn't changed.
+ * @retval  0 Success, the new tuple is returned on the region.
+ * @retval -1 Error, diag is set.
+ */
+static int
+xrow_update_do_single_op(struct xrow_update *update, const char *header,
+			 const char *old_data, const char *old_data_end,
+			 uint32_t field_count, struct tuple_format *format,
+			 const char **p_tuple, uint32_t *p_tuple_len)
+{
+	if (update->op_count != 1)
+		return 1;
+	struct xrow_update_op *op = update->ops;
+	if (op->is_for_root || op->is_token_consumed ||
+	    op->token_type != JSON_TOKEN_NUM || !xrow_update_op_is_term(op))
+		return 1;
+	int32_t field_no = op->field_no;
+	if (field_no < 0)
+		field_no += field_count;
+	if (field_no < 0 || (uint32_t)field_no >= field_count)
+		return 1;
+	const char *field = old_data;
+	for (int32_t i = 0; i < field_no; i++)
+		mp_next(&field);
+	const char *field_end = field;
+	mp_next(&field_end);
+	switch (op->opcode) {
+	case '=':
+		op->new_field_len = op->arg.set.length;
+		break;
+	case '+':
+	case '-':
+		if (xrow_update_op_do_arith(op, field) != 0)
+			return -1;
+		break;
+	case '&':
+	case '|':
+	case '^':
+		if (xrow_update_op_do_bit(op, field) != 0)
+			return -1;
+		break;
+	default:
+		return 1;
+	}
+	op->field_no = field_no;
+	size_t head_len = field - header;
+	size_t tail_len = old_data_end - field_end;
+	size_t tuple_len = head_len + op->new_field_len + tail_len;
+	char *buffer = (char *)region_alloc(&fiber()->gc, tuple_len);
+	if (buffer == NULL) {
+		diag_set(OutOfMemory, tuple_len, "region_alloc", "buffer");
+		return -1;
+	}
+	struct json_token token;
+	token.type = JSON_TOKEN_NUM;
+	token.num = field_no;
+	struct json_token *this_node =
+		json_tree_lookup(&format->fields, &format->fields.root, &token);
+	char *pos = buffer;
+	memcpy(pos, header, head_len);
+	pos += head_len;
+	pos += op->meta->store(op, &format->fields, this_node, field, pos);
+	memcpy(pos, field_end, tail_len);
+	pos += tail_len;
+	assert(pos <= buffer + tuple_len);
+	*p_tuple = buffer;
+	*p_tuple_len = pos - buffer;
+	return 0;
+}
+
 static void
 xrow_update_init(struct xrow_update *update, int index_base)
 {
@@ -384,11 +461,19 @@ xrow_update_execute(const char *expr,const char *expr_end,
 	if (xrow_update_read_ops(&update, expr, expr_end, format->dict,
 				 field_count) != 0)
 		return NULL;
-	if (xrow_update_do_ops(&update, header, old_data, old_data_end,
-			       field_count) != 0)
+	const char *new_data;
+	int rc = xrow_update_do_single_op(&update, header, old_data,
+					  old_data_end, field_count, format,
+					  &new_data, p_tuple_len);
+	if (rc < 0)
+		return NULL;
+	if (rc > 0 && xrow_update_do_ops(&update, header, old_data,
+					 old_data_end, field_count) != 0)
 		return NULL;
 	if (column_mask)
 		*column_mask = update.column_mask;
+	if (rc == 0)
+		return new_data;
 
 	return xrow_update_finish(&update, format, p_tuple_len);
 }
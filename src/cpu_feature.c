@@ -114,6 +114,26 @@ sse42_enabled_cpu()
 	return (cx & (1 << 20)) != 0;
 }
 
+bool
+avx2_enabled_cpu()
+{
+	unsigned int ax, bx, cx, dx;
+
+	if (__get_cpuid(1, &ax, &bx, &cx, &dx) == 0)
+		return false;
+	/* AVX and the OS saves YMM registers on context switch. */
+	if ((cx & (1 << 27)) == 0 || (cx & (1 << 28)) == 0)
+		return false;
+	unsigned int xcr0_lo, xcr0_hi;
+	__asm__ __volatile__("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+	if ((xcr0_lo & 0x6) != 0x6)
+		return false;
+	if (__get_cpuid_max(0, NULL) < 7)
+		return false;
+	__cpuid_count(7, 0, ax, bx, cx, dx);
+	return (bx & (1 << 5)) != 0;
+}
+
 #else /* !(defined (__x86_64__) || defined (__i386__)) */
 
 bool
@@ -122,4 +142,64 @@ sse42_enabled_cpu()
 	return false;
 }
 
+bool
+avx2_enabled_cpu()
+{
+	return false;
+}
+
+#endif
+
+#if defined(__aarch64__) && !defined(__AARCH64EB__)
+
+#include <arm_acle.h>
+#include <string.h>
+#if defined(HAVE_GETAUXVAL)
+#include <sys/auxv.h>
+#endif
+
+bool
+arm_crc32_enabled_cpu()
+{
+#if defined(__ARM_FEATURE_CRC32) || defined(__APPLE__)
+	/* Enabled by the compiler flags or on all Apple CPUs. */
+	return true;
+#elif defined(HAVE_GETAUXVAL) && defined(HWCAP_CRC32)
+	return (getauxval(AT_HWCAP) & HWCAP_CRC32) != 0;
+#else
+	return false;
+#endif
+}
+
+__attribute__((target("+crc")))
+uint32_t
+crc32c_arm(uint32_t crc, const char *buf, unsigned int len)
+{
+	/* See crc32c_hw() on why the words are aligned. */
+	while (len > 0 && (uintptr_t)buf % sizeof(uint64_t) != 0) {
+		crc = __crc32cb(crc, *buf++);
+		len--;
+	}
+	while (len >= sizeof(uint64_t)) {
+		uint64_t word;
+		memcpy(&word, buf, sizeof(word));
+		crc = __crc32cd(crc, word);
+		buf += sizeof(word);
+		len -= sizeof(word);
+	}
+	while (len > 0) {
+		crc = __crc32cb(crc, *buf++);
+		len--;
+	}
+	return crc;
+}
+
+#else /* !(defined(__aarch64__) && !defined(__AARCH64EB__)) */
+
+bool
+arm_crc32_enabled_cpu()
+{
+	return false;
+}
+
 #endif
@@ -42,6 +42,20 @@
  */
 bool sse42_enabled_cpu();
 
+/*
+ * Check whether CPU and OS support AVX2 instructions.
+ *
+ * @return	true if AVX2 is available, false if unavailable.
+ */
+bool avx2_enabled_cpu();
+
+/*
+ * Check whether CPU supports the ARMv8 CRC32 instructions.
+ *
+ * @return	true if CRC32 instructions are available, false if unavailable.
+ */
+bool arm_crc32_enabled_cpu();
+
 #if defined (__x86_64__) || defined (__i386__)
 /* Hardware-calculate CRC32 for the given data buffer.
  *
@@ -55,5 +69,18 @@ bool sse42_enabled_cpu();
 uint32_t crc32c_hw(uint32_t crc, const char *buf, unsigned int len);
 #endif
 
+#if defined(__aarch64__) && !defined(__AARCH64EB__)
+/* Calculate CRC32 for the given data buffer with ARMv8 instructions.
+ *
+ * @param	crc 		initial CRC
+ * @param	buf			data buffer
+ * @param	len			buffer length
+ *
+ * @pre 	true == arm_crc32_enabled_cpu()
+ * @return	CRC32 value
+ */
+uint32_t crc32c_arm(uint32_t crc, const char *buf, unsigned int len);
+#endif
+
 #endif /* TARANTOOL_CPU_FEATURES_H */
 
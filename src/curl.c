@@ -248,6 +248,25 @@ curl_env_create(struct curl_env *env, long max_conns, long max_total_conns)
 #else
 	(void) max_total_conns;
 #endif
+#if LIBCURL_VERSION_NUM >= 0x072b00
+	/*
+	 * Let HTTP/2 requests to the same host go as streams of
+	 * one connection. It is the default since libcurl 7.62.0.
+	 */
+	curl_multi_setopt(env->multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+#endif
+
+	env->share = curl_share_init();
+	if (env->share == NULL) {
+		diag_set(SystemError, "failed to init share handler");
+		goto error_exit;
+	}
+	/*
+	 * The share handle is used by one thread only, so it needs
+	 * no lock callbacks.
+	 */
+	curl_share_setopt(env->share, CURLSHOPT_SHARE,
+			  CURL_LOCK_DATA_SSL_SESSION);
 
 	return 0;
 
@@ -262,18 +281,21 @@ curl_env_destroy(struct curl_env *env)
 	assert(env);
 	if (env->multi != NULL)
 		curl_multi_cleanup(env->multi);
+	if (env->share != NULL)
+		curl_share_cleanup(env->share);
 
 	mempool_destroy(&env->sock_pool);
 }
 
 int
-curl_request_create(struct curl_request *curl_request)
+curl_request_create(struct curl_request *curl_request, struct curl_env *env)
 {
 	curl_request->easy = curl_easy_init();
 	if (curl_request->easy == NULL) {
 		diag_set(OutOfMemory, 0, "curl", "easy");
 		return -1;
 	}
+	curl_easy_setopt(curl_request->easy, CURLOPT_SHARE, env->share);
 	curl_request->in_progress = false;
 	curl_request->code = CURLE_OK;
 	fiber_cond_create(&curl_request->cond);
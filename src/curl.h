@@ -54,6 +54,14 @@ struct curl_stat {
 struct curl_env {
 	/** libcurl multi handler. */
 	CURLM *multi;
+	/**
+	 * libcurl share handle. The connection and DNS caches
+	 * belong to the multi handle and are shared by all its
+	 * requests, this one shares TLS sessions, so that new
+	 * connections to the same host resume them instead of
+	 * doing a full handshake.
+	 */
+	CURLSH *share;
 	/** Memory pool for sockets. */
 	struct mempool sock_pool;
 	/** libev timer watcher. */
@@ -99,11 +107,12 @@ curl_env_destroy(struct curl_env *env);
 /**
  * Initialize a new CURL request
  * @param curl_request request
+ * @param env environment
  * @retval  0 success
  * @retval -1 error, check diag
  */
 int
-curl_request_create(struct curl_request *curl_request);
+curl_request_create(struct curl_request *curl_request, struct curl_env *env);
 
 /**
  * Cleanup CURL request
@@ -132,7 +132,7 @@ histogram_discard(struct histogram *hist, int64_t val)
 }
 
 int64_t
-histogram_percentile(struct histogram *hist, int pct)
+histogram_percentile(struct histogram *hist, double pct)
 {
 	size_t count = 0;
 
@@ -146,7 +146,7 @@ histogram_percentile(struct histogram *hist, int pct)
 }
 
 int64_t
-histogram_percentile_lower(struct histogram *hist, int pct)
+histogram_percentile_lower(struct histogram *hist, double pct)
 {
 	size_t count = 0;
 
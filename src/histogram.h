@@ -87,14 +87,14 @@ histogram_discard(struct histogram *hist, int64_t val);
  * percentage of observations fall.
  */
 int64_t
-histogram_percentile(struct histogram *hist, int pct);
+histogram_percentile(struct histogram *hist, double pct);
 
 /**
  * Same as histogram_percentile(), but return a lower bound
  * estimate of the percentile.
  */
 int64_t
-histogram_percentile_lower(struct histogram *hist, int pct);
+histogram_percentile_lower(struct histogram *hist, double pct);
 
 /**
  * Print string representation of a histogram.
@@ -39,6 +39,12 @@
 
 #define MAX_HEADER_LEN 8192
 
+/**
+ * The initial size of the response body buffer. libcurl passes
+ * at most CURL_MAX_WRITE_SIZE bytes to the write callback.
+ */
+#define HTTPC_BODY_BUF_SIZE CURL_MAX_WRITE_SIZE
+
 static_assert(MAX_HEADER_LEN < SMALL_STATIC_SIZE,
 	      "HTTP header fits into the static buffer");
 
@@ -57,7 +63,7 @@ curl_easy_write_cb(char *ptr, size_t size, size_t nmemb, void *ctx)
 	struct httpc_request *req = (struct httpc_request *) ctx;
 	const size_t bytes = size * nmemb;
 
-	char *p = region_alloc(&req->resp_body, bytes);
+	char *p = ibuf_alloc(&req->resp_body, bytes);
 	if (p == NULL) {
 		diag_set(OutOfMemory, bytes, "ibuf", "httpc body");
 		return 0;
@@ -119,9 +125,9 @@ httpc_request_new(struct httpc_env *env, const char *method,
 	req->set_connection_header = true;
 	req->set_keep_alive_header = true;
 	region_create(&req->resp_headers, &cord()->slabc);
-	region_create(&req->resp_body, &cord()->slabc);
+	ibuf_create(&req->resp_body, &cord()->slabc, HTTPC_BODY_BUF_SIZE);
 
-	if (curl_request_create(&req->curl_request) != 0)
+	if (curl_request_create(&req->curl_request, &env->curl_env) != 0)
 		return NULL;
 
 	if (strcmp(method, "GET") == 0) {
@@ -173,7 +179,7 @@ httpc_request_delete(struct httpc_request *req)
 
 	ibuf_destroy(&req->body);
 	region_destroy(&req->resp_headers);
-	region_destroy(&req->resp_body);
+	ibuf_destroy(&req->resp_body);
 
 	mempool_free(&req->env->req_pool, req);
 }
@@ -361,6 +367,32 @@ httpc_set_follow_location(struct httpc_request *req, long follow)
 			 follow);
 }
 
+void
+httpc_set_http2(struct httpc_request *req, bool http2)
+{
+	if (!http2) {
+		curl_easy_setopt(req->curl_request.easy, CURLOPT_HTTP_VERSION,
+				 CURL_HTTP_VERSION_1_1);
+		return;
+	}
+#if LIBCURL_VERSION_NUM >= 0x072f00
+	if ((curl_version_info(CURLVERSION_NOW)->features &
+	     CURL_VERSION_HTTP2) == 0)
+		return;
+	curl_easy_setopt(req->curl_request.easy, CURLOPT_HTTP_VERSION,
+			 CURL_HTTP_VERSION_2TLS);
+	/*
+	 * Wait for a connection to the host being established to
+	 * tell whether it can be multiplexed instead of opening
+	 * another one.
+	 */
+	curl_easy_setopt(req->curl_request.easy, CURLOPT_PIPEWAIT, 1L);
+	/* Connection-specific headers are forbidden in HTTP/2. */
+	req->set_connection_header = false;
+	req->set_keep_alive_header = false;
+#endif
+}
+
 void
 httpc_set_accept_encoding(struct httpc_request *req, const char *encoding)
 {
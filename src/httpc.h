@@ -108,7 +108,7 @@ struct httpc_request {
 	/** buffer of headers */
 	struct region resp_headers;
 	/** buffer of body */
-	struct region resp_body;
+	struct ibuf resp_body;
 	/**
 	 * Idle delay, in seconds, that the operating system will
 	 * wait while the connection is idle before sending
@@ -402,6 +402,22 @@ httpc_set_follow_location(struct httpc_request *req, long follow);
 void
 httpc_set_accept_encoding(struct httpc_request *req, const char *encoding);
 
+/**
+ * Prefer HTTP/2 for HTTPS requests, falling back to HTTP/1.1 if
+ * the server doesn't support it. Requests to the same host are
+ * multiplexed over one connection. Plain HTTP requests and
+ * libcurl built without HTTP/2 support always use HTTP/1.1.
+ *
+ * The Connection and Keep-Alive headers are not set by the client
+ * for such requests.
+ *
+ * @param req request
+ * @param http2 flag
+ * @see https://curl.haxx.se/libcurl/c/CURLOPT_HTTP_VERSION.html
+ */
+void
+httpc_set_http2(struct httpc_request *req, bool http2);
+
 /**
  * This function does async HTTP request
  * @param request - reference to request object with filled fields
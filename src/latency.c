@@ -90,7 +90,7 @@ latency_collect(struct latency *latency, double value)
 }
 
 double
-latency_get(struct latency *latency, int pct)
+latency_get(struct latency *latency, double pct)
 {
 	int64_t value_usec = histogram_percentile(latency->histogram, pct);
 	return (double)value_usec / USEC_PER_SEC;
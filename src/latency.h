@@ -75,6 +75,6 @@ latency_collect(struct latency *latency, double value);
  * Returns @pct-th percentile of all observations.
  */
 double
-latency_get(struct latency *latency, int pct);
+latency_get(struct latency *latency, double pct);
 
 #endif /* TARANTOOL_LATENCY_H_INCLUDED */
@@ -80,7 +80,78 @@ tt_bitset_test(struct tt_bitset *bitset, size_t pos)
 
 	assert(page->first_pos <= pos && pos < page->first_pos +
 	       BITSET_PAGE_DATA_SIZE * CHAR_BIT);
-	return bit_test(tt_bitset_page_data(page), pos - page->first_pos);
+	uint16_t offset = pos - page->first_pos;
+	if (tt_bitset_page_is_array(page)) {
+		uint32_t i = tt_bitset_page_array_find(page, offset);
+		return i < page->cardinality &&
+		       tt_bitset_page_array(page)[i] == offset;
+	}
+	return bit_test(tt_bitset_page_data(page), offset);
+}
+
+/**
+ * Replace a page in the pages tree with a page of another layout
+ * and copy set bits to it. The old page is freed.
+ */
+static void
+tt_bitset_replace_page(struct tt_bitset *bitset, struct tt_bitset_page *old,
+		       struct tt_bitset_page *new)
+{
+	new->first_pos = old->first_pos;
+	new->cardinality = old->cardinality;
+	if (tt_bitset_page_is_array(old) && tt_bitset_page_is_array(new)) {
+		memcpy(tt_bitset_page_array(new), tt_bitset_page_array(old),
+		       old->cardinality * sizeof(uint16_t));
+	} else if (tt_bitset_page_is_array(old)) {
+		tt_bitset_page_or(new, old);
+	} else {
+		assert(tt_bitset_page_is_array(new));
+		assert(new->array_capacity >= old->cardinality);
+		uint16_t *array = tt_bitset_page_array(new);
+		struct bit_iterator it;
+		bit_iterator_init(&it, tt_bitset_page_data(old),
+				  BITSET_PAGE_DATA_SIZE, true);
+		size_t offset;
+		uint32_t count = 0;
+		while ((offset = bit_iterator_next(&it)) != SIZE_MAX)
+			array[count++] = offset;
+		assert(count == old->cardinality);
+	}
+	tt_bitset_pages_remove(&bitset->pages, old);
+	tt_bitset_pages_insert(&bitset->pages, new);
+	tt_bitset_page_destroy(old);
+	bitset->realloc(old, 0);
+}
+
+/**
+ * Make room for one more offset in a full sparse page: grow the
+ * array or, if it has reached the maximal size, convert the page
+ * to a bitmap. Returns the new page or NULL on allocation failure,
+ * in which case the old page is left intact.
+ */
+static struct tt_bitset_page *
+tt_bitset_grow_page(struct tt_bitset *bitset, struct tt_bitset_page *page)
+{
+	assert(page->cardinality == page->array_capacity);
+	struct tt_bitset_page *new;
+	if (page->array_capacity < BITSET_PAGE_ARRAY_MAX) {
+		uint32_t capacity = page->array_capacity * 2;
+		if (capacity > BITSET_PAGE_ARRAY_MAX)
+			capacity = BITSET_PAGE_ARRAY_MAX;
+		new = bitset->realloc(NULL,
+				tt_bitset_page_array_alloc_size(capacity));
+		if (new == NULL)
+			return NULL;
+		tt_bitset_page_array_create(new, capacity);
+	} else {
+		new = bitset->realloc(NULL,
+				tt_bitset_page_alloc_size(bitset->realloc));
+		if (new == NULL)
+			return NULL;
+		tt_bitset_page_create(new);
+	}
+	tt_bitset_replace_page(bitset, page, new);
+	return new;
 }
 
 int
@@ -93,13 +164,14 @@ tt_bitset_set(struct tt_bitset *bitset, size_t pos)
 	struct tt_bitset_page *page =
 		tt_bitset_pages_search(&bitset->pages, &key);
 	if (page == NULL) {
-		/* Allocate a new page */
-		size_t size = tt_bitset_page_alloc_size(bitset->realloc);
+		/* Allocate a new sparse page */
+		size_t size =
+			tt_bitset_page_array_alloc_size(BITSET_PAGE_ARRAY_MIN);
 		page = bitset->realloc(NULL, size);
 		if (page == NULL)
 			return -1;
 
-		tt_bitset_page_create(page);
+		tt_bitset_page_array_create(page, BITSET_PAGE_ARRAY_MIN);
 		page->first_pos = key.first_pos;
 
 		/* Insert the page into pages tree */
@@ -108,10 +180,32 @@ tt_bitset_set(struct tt_bitset *bitset, size_t pos)
 
 	assert(page->first_pos <= pos && pos < page->first_pos +
 	       BITSET_PAGE_DATA_SIZE * CHAR_BIT);
-	bool prev = bit_set(tt_bitset_page_data(page), pos - page->first_pos);
-	if (prev) {
-		/* Value has not changed */
-		return 1;
+	uint16_t offset = pos - page->first_pos;
+	if (tt_bitset_page_is_array(page)) {
+		uint32_t i = tt_bitset_page_array_find(page, offset);
+		if (i < page->cardinality &&
+		    tt_bitset_page_array(page)[i] == offset) {
+			/* Value has not changed */
+			return 1;
+		}
+		if (page->cardinality == page->array_capacity) {
+			page = tt_bitset_grow_page(bitset, page);
+			if (page == NULL)
+				return -1;
+		}
+	}
+	if (tt_bitset_page_is_array(page)) {
+		uint32_t i = tt_bitset_page_array_find(page, offset);
+		uint16_t *array = tt_bitset_page_array(page);
+		memmove(array + i + 1, array + i,
+			(page->cardinality - i) * sizeof(uint16_t));
+		array[i] = offset;
+	} else {
+		bool prev = bit_set(tt_bitset_page_data(page), offset);
+		if (prev) {
+			/* Value has not changed */
+			return 1;
+		}
 	}
 
 	bitset->cardinality++;
@@ -134,9 +228,19 @@ tt_bitset_clear(struct tt_bitset *bitset, size_t pos)
 
 	assert(page->first_pos <= pos && pos < page->first_pos +
 	       BITSET_PAGE_DATA_SIZE * CHAR_BIT);
-	bool prev = bit_clear(tt_bitset_page_data(page), pos - page->first_pos);
-	if (!prev) {
-		return 0;
+	uint16_t offset = pos - page->first_pos;
+	if (tt_bitset_page_is_array(page)) {
+		uint32_t i = tt_bitset_page_array_find(page, offset);
+		uint16_t *array = tt_bitset_page_array(page);
+		if (i == page->cardinality || array[i] != offset)
+			return 0;
+		memmove(array + i, array + i + 1,
+			(page->cardinality - i - 1) * sizeof(uint16_t));
+	} else {
+		bool prev = bit_clear(tt_bitset_page_data(page), offset);
+		if (!prev) {
+			return 0;
+		}
 	}
 
 	assert(bitset->cardinality > 0);
@@ -150,6 +254,22 @@ tt_bitset_clear(struct tt_bitset *bitset, size_t pos)
 		/* Free the page */
 		tt_bitset_page_destroy(page);
 		bitset->realloc(page, 0);
+	} else if (!tt_bitset_page_is_array(page) &&
+		   page->cardinality == BITSET_PAGE_ARRAY_MAX / 2) {
+		/*
+		 * The page has become sparse, convert it back to
+		 * an array. The threshold is lower than the one used
+		 * by tt_bitset_set() so that a page doesn't flip
+		 * between layouts on every update. Clearing a bit
+		 * must never fail, so keep the bitmap if there's
+		 * no memory.
+		 */
+		struct tt_bitset_page *new = bitset->realloc(NULL,
+			tt_bitset_page_array_alloc_size(page->cardinality));
+		if (new != NULL) {
+			tt_bitset_page_array_create(new, page->cardinality);
+			tt_bitset_replace_page(bitset, page, new);
+		}
 	}
 
 	return 1;
@@ -170,6 +290,13 @@ tt_bitset_info(struct tt_bitset *bitset, struct tt_bitset_info *info)
 	struct tt_bitset_page *page = tt_bitset_pages_first(&bitset->pages);
 	while (page != NULL) {
 		info->pages++;
+		if (tt_bitset_page_is_array(page)) {
+			info->array_pages++;
+			info->mem_total += tt_bitset_page_array_alloc_size(
+						page->array_capacity);
+		} else {
+			info->mem_total += info->page_total_size;
+		}
 		cardinality_check += page->cardinality;
 		page = tt_bitset_pages_next(&bitset->pages, page);
 	}
@@ -211,7 +338,7 @@ tt_bitset_dump(struct tt_bitset *bitset, int verbose, FILE *stream)
 			"utilization = undefined\n");
 	}
 	size_t mem_data  = info.page_data_size * info.pages;
-	size_t mem_total = info.page_total_size * info.pages;
+	size_t mem_total = info.mem_total;
 
 	fprintf(stream, "    " "mem_data    = %zu bytes\n", mem_data);
 	fprintf(stream, "    " "mem_total   = %zu bytes "
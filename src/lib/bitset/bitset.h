@@ -68,7 +68,12 @@ extern "C" {
 struct tt_bitset_page {
 	size_t first_pos;
 	rb_node(struct tt_bitset_page) node;
-	size_t cardinality;
+	uint32_t cardinality;
+	/**
+	 * Capacity of a sparse page, which stores a sorted array of
+	 * offsets of set bits instead of a bitmap. 0 for a bitmap page.
+	 */
+	uint32_t array_capacity;
 	uint8_t data[];
 };
 
@@ -157,6 +162,10 @@ struct tt_bitset_info {
 	size_t page_total_size;
 	/** A multiplier by which an address of page data is aligned **/
 	size_t page_data_alignment;
+	/** Number of sparse pages, included in \a pages */
+	size_t array_pages;
+	/** Memory used by all pages (in bytes) */
+	size_t mem_total;
 };
 
 /**
@@ -41,6 +41,21 @@ tt_bitset_page_data(struct tt_bitset_page *page);
 extern inline void
 tt_bitset_page_create(struct tt_bitset_page *page);
 
+extern inline size_t
+tt_bitset_page_array_alloc_size(uint32_t capacity);
+
+extern inline void
+tt_bitset_page_array_create(struct tt_bitset_page *page, uint32_t capacity);
+
+extern inline bool
+tt_bitset_page_is_array(const struct tt_bitset_page *page);
+
+extern inline uint16_t *
+tt_bitset_page_array(struct tt_bitset_page *page);
+
+extern inline uint32_t
+tt_bitset_page_array_find(struct tt_bitset_page *page, uint16_t offset);
+
 extern inline void
 tt_bitset_page_destroy(struct tt_bitset_page *page);
 
@@ -55,7 +55,14 @@ extern "C" {
 
 enum {
 	/** How many bytes to store in one page */
-	BITSET_PAGE_DATA_SIZE = 160
+	BITSET_PAGE_DATA_SIZE = 160,
+	/**
+	 * Maximal number of set bits in a sparse page. The array of
+	 * offsets takes as much memory as the bitmap then.
+	 */
+	BITSET_PAGE_ARRAY_MAX = BITSET_PAGE_DATA_SIZE / sizeof(uint16_t),
+	/** Capacity of a new sparse page */
+	BITSET_PAGE_ARRAY_MIN = 4,
 };
 
 #if defined(ENABLE_AVX)
@@ -122,6 +129,53 @@ tt_bitset_page_create(struct tt_bitset_page *page)
 	memset(page, 0, size);
 }
 
+inline size_t
+tt_bitset_page_array_alloc_size(uint32_t capacity)
+{
+	return sizeof(struct tt_bitset_page) + capacity * sizeof(uint16_t);
+}
+
+inline void
+tt_bitset_page_array_create(struct tt_bitset_page *page, uint32_t capacity)
+{
+	assert(capacity > 0 && capacity <= BITSET_PAGE_ARRAY_MAX);
+	memset(page, 0, sizeof(*page));
+	page->array_capacity = capacity;
+}
+
+inline bool
+tt_bitset_page_is_array(const struct tt_bitset_page *page)
+{
+	return page->array_capacity != 0;
+}
+
+/** Sorted offsets of set bits of a sparse page */
+inline uint16_t *
+tt_bitset_page_array(struct tt_bitset_page *page)
+{
+	assert(tt_bitset_page_is_array(page));
+	return (uint16_t *) page->data;
+}
+
+/**
+ * Index of the first offset in a sparse page that is not less than
+ * \a offset, page->cardinality if there's no such offset.
+ */
+inline uint32_t
+tt_bitset_page_array_find(struct tt_bitset_page *page, uint16_t offset)
+{
+	const uint16_t *array = tt_bitset_page_array(page);
+	uint32_t begin = 0, end = page->cardinality;
+	while (begin < end) {
+		uint32_t mid = begin + (end - begin) / 2;
+		if (array[mid] < offset)
+			begin = mid + 1;
+		else
+			end = mid;
+	}
+	return begin;
+}
+
 inline void
 tt_bitset_page_destroy(struct tt_bitset_page *page)
 {
@@ -151,6 +205,22 @@ tt_bitset_page_set_ones(struct tt_bitset_page *page)
 inline void
 tt_bitset_page_and(struct tt_bitset_page *dst, struct tt_bitset_page *src)
 {
+	assert(!tt_bitset_page_is_array(dst));
+	if (tt_bitset_page_is_array(src)) {
+		/* Keep only the bits listed in src */
+		void *data = tt_bitset_page_data(dst);
+		const uint16_t *array = tt_bitset_page_array(src);
+		uint16_t kept[BITSET_PAGE_ARRAY_MAX];
+		uint32_t count = 0;
+		for (uint32_t i = 0; i < src->cardinality; i++) {
+			if (bit_test(data, array[i]))
+				kept[count++] = array[i];
+		}
+		memset(data, 0, BITSET_PAGE_DATA_SIZE);
+		for (uint32_t i = 0; i < count; i++)
+			bit_set(data, kept[i]);
+		return;
+	}
 	tt_bitset_word_t *d = (tt_bitset_word_t *) tt_bitset_page_data(dst);
 	tt_bitset_word_t *s = (tt_bitset_word_t *) tt_bitset_page_data(src);
 
@@ -164,6 +234,14 @@ tt_bitset_page_and(struct tt_bitset_page *dst, struct tt_bitset_page *src)
 inline void
 tt_bitset_page_nand(struct tt_bitset_page *dst, struct tt_bitset_page *src)
 {
+	assert(!tt_bitset_page_is_array(dst));
+	if (tt_bitset_page_is_array(src)) {
+		void *data = tt_bitset_page_data(dst);
+		const uint16_t *array = tt_bitset_page_array(src);
+		for (uint32_t i = 0; i < src->cardinality; i++)
+			bit_clear(data, array[i]);
+		return;
+	}
 	tt_bitset_word_t *d = (tt_bitset_word_t *) tt_bitset_page_data(dst);
 	tt_bitset_word_t *s = (tt_bitset_word_t *) tt_bitset_page_data(src);
 
@@ -177,6 +255,14 @@ tt_bitset_page_nand(struct tt_bitset_page *dst, struct tt_bitset_page *src)
 inline void
 tt_bitset_page_or(struct tt_bitset_page *dst, struct tt_bitset_page *src)
 {
+	assert(!tt_bitset_page_is_array(dst));
+	if (tt_bitset_page_is_array(src)) {
+		void *data = tt_bitset_page_data(dst);
+		const uint16_t *array = tt_bitset_page_array(src);
+		for (uint32_t i = 0; i < src->cardinality; i++)
+			bit_set(data, array[i]);
+		return;
+	}
 	tt_bitset_word_t *d = (tt_bitset_word_t *) tt_bitset_page_data(dst);
 	tt_bitset_word_t *s = (tt_bitset_word_t *) tt_bitset_page_data(src);
 
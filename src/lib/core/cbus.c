@@ -112,6 +112,32 @@ cpipe_create(struct cpipe *pipe, const char *consumer)
 	tt_pthread_mutex_unlock(&cbus.mutex);
 }
 
+/**
+ * Move all messages from the list to the endpoint queue without
+ * taking a lock. Returns true if the queue was empty, i.e. the
+ * consumer must be woken up.
+ *
+ * The queue is a stack, so the list is reversed before it is
+ * pushed, and cbus_endpoint_fetch() reverses it back. Since the
+ * consumer never removes single messages, but grabs the whole
+ * stack at once, the CAS loop isn't prone to the ABA problem.
+ */
+static bool
+cbus_endpoint_push(struct cbus_endpoint *endpoint, struct stailq *list)
+{
+	assert(!stailq_empty(list));
+	stailq_reverse(list);
+	struct stailq_entry *first = stailq_first(list);
+	struct stailq_entry *last = stailq_last(list);
+	struct stailq_entry *head = pm_atomic_load(&endpoint->output);
+	do {
+		last->next = head;
+	} while (!pm_atomic_compare_exchange_weak(&endpoint->output,
+						  &head, first));
+	stailq_create(list);
+	return head == NULL;
+}
+
 struct cmsg_poison {
 	struct cmsg msg;
 	struct cbus_endpoint *endpoint;
@@ -156,11 +182,11 @@ cpipe_destroy(struct cpipe *pipe)
 	 * delivered.
 	 */
 	tt_pthread_mutex_lock(&endpoint->mutex);
+	/* Add the pipe shutdown message as the last one. */
+	stailq_add_tail_entry(&pipe->input, poison, msg.fifo);
 	/* Flush input */
-	stailq_concat(&endpoint->output, &pipe->input);
+	cbus_endpoint_push(endpoint, &pipe->input);
 	pipe->n_input = 0;
-	/* Add the pipe shutdown message as the last one. */
-	stailq_add_tail_entry(&endpoint->output, poison, msg.fifo);
 	/* Count statistics */
 	rmean_collect(cbus.stats, CBUS_STAT_EVENTS, 1);
 	/*
@@ -227,7 +253,7 @@ cbus_endpoint_create(struct cbus_endpoint *endpoint, const char *name,
 	endpoint->n_pipes = 0;
 	fiber_cond_create(&endpoint->cond);
 	tt_pthread_mutex_init(&endpoint->mutex, NULL);
-	stailq_create(&endpoint->output);
+	endpoint->output = NULL;
 	ev_async_init(&endpoint->async,
 		      (void (*)(ev_loop *, struct ev_async *, int)) fetch_cb);
 	endpoint->async.data = fetch_data;
@@ -261,7 +287,8 @@ cbus_endpoint_destroy(struct cbus_endpoint *endpoint,
 	while (true) {
 		if (process_cb)
 			process_cb(endpoint);
-		if (endpoint->n_pipes == 0 && stailq_empty(&endpoint->output))
+		if (endpoint->n_pipes == 0 &&
+		    pm_atomic_load(&endpoint->output) == NULL)
 			break;
 		 fiber_cond_wait(&endpoint->cond);
 	}
@@ -304,11 +331,8 @@ cpipe_flush_cb(ev_loop *loop, struct ev_async *watcher, int events)
 	int old_cancel_state;
 	tt_pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &old_cancel_state);
 
-	tt_pthread_mutex_lock(&endpoint->mutex);
-	output_was_empty = stailq_empty(&endpoint->output);
 	/** Flush input */
-	stailq_concat(&endpoint->output, &pipe->input);
-	tt_pthread_mutex_unlock(&endpoint->mutex);
+	output_was_empty = cbus_endpoint_push(endpoint, &pipe->input);
 
 	pipe->n_input = 0;
 	if (output_was_empty) {
@@ -372,6 +396,7 @@ cmsg_deliver(struct cmsg *msg)
 	 * on the last hop.
 	 */
 	struct cpipe *pipe = msg->hop->pipe;
+	TT_PROBE(cbus_deliver, msg, msg->hop->f);
 	msg->hop->f(msg);
 	cmsg_dispatch(pipe, msg);
 }
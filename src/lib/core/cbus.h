@@ -35,6 +35,8 @@
 #include "rmean.h"
 #include "small/rlist.h"
 #include "salad/stailq.h"
+#include <pmatomic.h>
+#include "trivia/probe.h"
 
 #if defined(__cplusplus)
 extern "C" {
@@ -223,6 +225,7 @@ cpipe_push_input(struct cpipe *pipe, struct cmsg *msg)
 {
 	assert(loop() == pipe->producer);
 
+	TT_PROBE(cbus_push, pipe, msg);
 	stailq_add_tail_entry(&pipe->input, msg, fifo);
 	pipe->n_input++;
 	if (pipe->n_input >= pipe->max_input)
@@ -255,10 +258,18 @@ struct cbus_endpoint {
 	char name[FIBER_NAME_MAX];
 	/** Member of cbus->endpoints */
 	struct rlist in_cbus;
-	/** The lock around the pipe. */
+	/**
+	 * The lock held by cpipe_destroy() while it sends the
+	 * poison message, see cbus_endpoint_destroy().
+	 */
 	pthread_mutex_t mutex;
-	/** A queue with incoming messages. */
-	struct stailq output;
+	/**
+	 * Incoming messages linked by cmsg::fifo in the reverse
+	 * order. Producers push whole batches with a CAS, the
+	 * consumer grabs all of them with a single exchange, so
+	 * neither side ever takes a lock.
+	 */
+	struct stailq_entry *output;
 	/** Consumer cord loop */
 	ev_loop *consumer;
 	/** Async to notify the consumer */
@@ -270,14 +281,22 @@ struct cbus_endpoint {
 };
 
 /**
- * Fetch incomming messages to output
+ * Fetch incoming messages to output
  */
 static inline void
 cbus_endpoint_fetch(struct cbus_endpoint *endpoint, struct stailq *output)
 {
-	tt_pthread_mutex_lock(&endpoint->mutex);
-	stailq_concat(output, &endpoint->output);
-	tt_pthread_mutex_unlock(&endpoint->mutex);
+	struct stailq_entry *item = pm_atomic_exchange(&endpoint->output,
+						       NULL);
+	/* Restore the order in which the messages were pushed. */
+	struct stailq batch;
+	stailq_create(&batch);
+	while (item != NULL) {
+		struct stailq_entry *next = item->next;
+		stailq_add(&batch, item);
+		item = next;
+	}
+	stailq_concat(output, &batch);
 }
 
 /** Initialize the global singleton bus. */
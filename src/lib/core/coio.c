@@ -470,7 +470,8 @@ coio_writev_timeout(struct iostream *io, struct iovec *iov, int iovcnt,
 
 static int
 coio_service_on_accept(struct evio_service *evio_service,
-		       int fd, struct sockaddr *addr, socklen_t addrlen)
+		       struct iostream *io, struct sockaddr *addr,
+		       socklen_t addrlen)
 {
 	struct coio_service *service = (struct coio_service *)
 			evio_service->on_accept_param;
@@ -488,10 +489,11 @@ coio_service_on_accept(struct evio_service *evio_service,
 		return -1;
 	}
 	/*
-	 * Start the created fiber. It becomes the socket fd owner
-	 * and will have to close it before termination.
+	 * Start the created fiber. It becomes the stream owner
+	 * and will have to move it before the first yield and to
+	 * close it before termination.
 	 */
-	fiber_start(f, fd, addr, addrlen, service->handler_param);
+	fiber_start(f, io, addr, addrlen, service->handler_param);
 	return 0;
 }
 
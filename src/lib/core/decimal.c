@@ -449,6 +449,147 @@ decimal_pack(char *data, const decimal_t *dec)
 	return data;
 }
 
+/** Powers of 10 that fit in int64_t. */
+static const int64_t decimal_pow10[DECIMAL_SMALL_MAX_DIGITS + 1] = {
+	1LL,
+	10LL,
+	100LL,
+	1000LL,
+	10000LL,
+	100000LL,
+	1000000LL,
+	10000000LL,
+	100000000LL,
+	1000000000LL,
+	10000000000LL,
+	100000000000LL,
+	1000000000000LL,
+	10000000000000LL,
+	100000000000000LL,
+	1000000000000000LL,
+	10000000000000000LL,
+	100000000000000000LL,
+	1000000000000000000LL,
+};
+
+bool
+decimal_unpack_small(const char *data, uint32_t len, int64_t *coef,
+		     int32_t *scale)
+{
+	const char *svp = data;
+	if (mp_typeof(*data) == MP_UINT) {
+		uint64_t val = mp_decode_uint(&data);
+		if (val > DECIMAL_MAX_DIGITS)
+			return false;
+		*scale = val;
+	} else if (mp_typeof(*data) == MP_INT) {
+		int64_t val = mp_decode_int(&data);
+		if (val <= -DECIMAL_MAX_DIGITS)
+			return false;
+		*scale = val;
+	} else {
+		return false;
+	}
+	if ((uint32_t)(data - svp) >= len)
+		return false;
+	/*
+	 * Packed BCD: two digits per byte, the last byte holds
+	 * the last digit and the sign. An even number of digits
+	 * is padded with a leading zero.
+	 */
+	uint32_t size = len - (data - svp);
+	const uint8_t *bcd = (const uint8_t *)data;
+	uint32_t digits = size * 2 - 1;
+	if (digits > DECIMAL_SMALL_MAX_DIGITS + 1 ||
+	    (digits > DECIMAL_SMALL_MAX_DIGITS && (bcd[0] >> 4) != 0))
+		return false;
+	int64_t val = 0;
+	for (uint32_t i = 0; i < size - 1; i++) {
+		uint8_t hi = bcd[i] >> 4;
+		uint8_t lo = bcd[i] & 0x0f;
+		if (hi > 9 || lo > 9)
+			return false;
+		val = val * 100 + hi * 10 + lo;
+	}
+	uint8_t hi = bcd[size - 1] >> 4;
+	uint8_t sign = bcd[size - 1] & 0x0f;
+	if (hi > 9)
+		return false;
+	val = val * 10 + hi;
+	switch (sign) {
+	case DECPMINUS:
+	case DECPMINUSALT:
+		val = -val;
+		break;
+	case DECPPLUS:
+	case DECPPLUSALT:
+	case DECPPLUSALT2:
+	case DECPUNSIGNED:
+		break;
+	default:
+		return false;
+	}
+	*coef = val;
+	return true;
+}
+
+/**
+ * Multiply a coefficient by 10^digits.
+ * Return false on overflow.
+ */
+static bool
+decimal_small_rescale(int64_t *coef, int32_t digits)
+{
+	assert(digits >= 0);
+	if (*coef == 0)
+		return true;
+	if (digits > DECIMAL_SMALL_MAX_DIGITS)
+		return false;
+	int64_t mul = decimal_pow10[digits];
+	if (*coef > INT64_MAX / mul || *coef < -(INT64_MAX / mul))
+		return false;
+	*coef *= mul;
+	return true;
+}
+
+bool
+decimal_compare_small(int64_t lhs_coef, int32_t lhs_scale,
+		      int64_t rhs_coef, int32_t rhs_scale, int *res)
+{
+	int lhs_sign = (lhs_coef > 0) - (lhs_coef < 0);
+	int rhs_sign = (rhs_coef > 0) - (rhs_coef < 0);
+	if (lhs_sign != rhs_sign || lhs_sign == 0) {
+		*res = (lhs_sign > rhs_sign) - (lhs_sign < rhs_sign);
+		return true;
+	}
+	if (lhs_scale < rhs_scale) {
+		if (!decimal_small_rescale(&lhs_coef, rhs_scale - lhs_scale))
+			return false;
+	} else if (lhs_scale > rhs_scale) {
+		if (!decimal_small_rescale(&rhs_coef, lhs_scale - rhs_scale))
+			return false;
+	}
+	*res = (lhs_coef > rhs_coef) - (lhs_coef < rhs_coef);
+	return true;
+}
+
+bool
+decimal_small_to_int64(int64_t coef, int32_t scale, int64_t *num)
+{
+	if (scale <= 0) {
+		if (!decimal_small_rescale(&coef, -scale))
+			return false;
+		*num = coef;
+		return true;
+	}
+	/* The coefficient has at most DECIMAL_SMALL_MAX_DIGITS digits. */
+	if (scale > DECIMAL_SMALL_MAX_DIGITS)
+		*num = 0;
+	else
+		*num = coef / decimal_pow10[scale];
+	return true;
+}
+
 decimal_t *
 decimal_unpack(const char **data, uint32_t len, decimal_t *dec)
 {
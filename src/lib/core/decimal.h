@@ -282,6 +282,51 @@ decimal_pack(char *data, const decimal_t *dec);
 decimal_t *
 decimal_unpack(const char **data, uint32_t len, decimal_t *dec);
 
+enum {
+	/**
+	 * Max number of digits of a decimal that can be unpacked
+	 * with decimal_unpack_small(), so that its coefficient
+	 * fits in int64_t.
+	 */
+	DECIMAL_SMALL_MAX_DIGITS = 18,
+};
+
+/**
+ * Using a packed representation of size \a len pointed to by
+ * \a data, unpack it as \a coef * 10^(-\a scale) without
+ * converting it to decimal_t. It's much faster than
+ * decimal_unpack() and is meant for comparisons.
+ *
+ * @return false if the value has more than
+ *         DECIMAL_SMALL_MAX_DIGITS digits or its encoding is
+ *         incorrect, true otherwise.
+ */
+bool
+decimal_unpack_small(const char *data, uint32_t len, int64_t *coef,
+		     int32_t *scale);
+
+/**
+ * Compare 2 decimal values unpacked with decimal_unpack_small().
+ * Store the result, as returned by decimal_compare(), in \a res.
+ *
+ * @return false if the values can't be compared without
+ *         decimal_t, true otherwise.
+ */
+bool
+decimal_compare_small(int64_t lhs_coef, int32_t lhs_scale,
+		      int64_t rhs_coef, int32_t rhs_scale, int *res);
+
+/**
+ * Convert a decimal value unpacked with decimal_unpack_small()
+ * to int64_t, truncating the fractional part, like
+ * decimal_to_int64() does.
+ *
+ * @return false if the value doesn't fit in int64_t,
+ *         true otherwise.
+ */
+bool
+decimal_small_to_int64(int64_t coef, int32_t scale, int64_t *num);
+
 #if defined(__cplusplus)
 } /* extern "C" */
 #endif /* defined(__cplusplus) */
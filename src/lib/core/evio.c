@@ -55,6 +55,20 @@ struct evio_service_entry {
 	struct ev_io ev;
 	/** Pointer to the root evio_service, which contains this object */
 	struct evio_service *service;
+	/** Context of the streams of accepted connections. */
+	struct iostream_ctx io_ctx;
+	/**
+	 * Set if the socket is bound with SO_REUSEPORT, so that
+	 * other services can bind their own sockets to the same
+	 * address with evio_service_attach_reuse_port().
+	 */
+	bool reuse_port;
+	/**
+	 * Set if the socket was bound by this entry rather than
+	 * shared with another service. Such a socket is closed
+	 * on detach.
+	 */
+	bool is_private;
 };
 
 static inline bool
@@ -190,10 +204,15 @@ evio_service_entry_accept_cb(ev_loop *loop, ev_io *watcher, int events)
 		if (evio_setsockopt_client(fd, entry->addr.sa_family,
 					   SOCK_STREAM) != 0)
 			break;
-		if (entry->service->on_accept(entry->service, fd,
+		struct iostream io;
+		if (iostream_create_with_ctx(&io, fd, &entry->io_ctx) != 0)
+			break;
+		if (entry->service->on_accept(entry->service, &io,
 					      (struct sockaddr *)&addr,
-					      addrlen) != 0)
+					      addrlen) != 0) {
+			iostream_destroy(&io);
 			break;
+		}
 	}
 	if (fd >= 0)
 		close(fd);
@@ -255,6 +274,18 @@ evio_service_entry_bind_addr(struct evio_service_entry *entry)
 				   SOCK_STREAM) != 0)
 		goto error;
 
+	if (entry->reuse_port && entry->addr.sa_family != AF_UNIX) {
+#ifdef SO_REUSEPORT
+		int on = 1;
+		if (sio_setsockopt(fd, SOL_SOCKET, SO_REUSEPORT,
+				   &on, sizeof(on)) != 0)
+			goto error;
+#else
+		diag_set(IllegalParams, "SO_REUSEPORT is not supported");
+		goto error;
+#endif
+	}
+
 	if (sio_bind(fd, &entry->addr, entry->addr_len) != 0)
 		goto error;
 
@@ -317,6 +348,18 @@ evio_service_entry_create(struct evio_service_entry *entry,
 static int
 evio_service_entry_bind(struct evio_service_entry *entry, const struct uri *u)
 {
+	const char *reuse_port = uri_param(u, "reuseport", 0);
+	if (reuse_port != NULL) {
+		if (strcmp(reuse_port, "true") != 0 &&
+		    strcmp(reuse_port, "false") != 0) {
+			diag_set(IllegalParams, "invalid reuseport value: %s",
+				 reuse_port);
+			return -1;
+		}
+		entry->reuse_port = strcmp(reuse_port, "true") == 0;
+	}
+	if (iostream_ctx_create(&entry->io_ctx, IOSTREAM_SERVER, u) != 0)
+		return -1;
 	entry->serv[0] = entry->host[0] = '\0';
 	assert(u->service != NULL);
 	strlcpy(entry->serv, u->service, sizeof(entry->serv));
@@ -372,7 +415,11 @@ evio_service_entry_detach(struct evio_service_entry *entry)
 		ev_io_stop(entry->service->loop, &entry->ev);
 		entry->addr_len = 0;
 	}
+	if (entry->is_private && entry->ev.fd >= 0 &&
+	    close(entry->ev.fd) < 0)
+		say_error("Failed to close socket: %s", strerror(errno));
 	ev_io_set(&entry->ev, -1, 0);
+	iostream_ctx_destroy(&entry->io_ctx);
 }
 
 /** It's safe to stop a service entry which is not started yet. */
@@ -380,8 +427,9 @@ static void
 evio_service_entry_stop(struct evio_service_entry *entry)
 {
 	int service_fd = entry->ev.fd;
+	bool is_private = entry->is_private;
 	evio_service_entry_detach(entry);
-	if (service_fd < 0)
+	if (service_fd < 0 || is_private)
 		return;
 
 	if (close(service_fd) < 0)
@@ -405,9 +453,29 @@ evio_service_entry_attach(struct evio_service_entry *dst,
 	strcpy(dst->serv, src->serv);
 	dst->addrstorage = src->addrstorage;
 	dst->addr_len = src->addr_len;
+	dst->reuse_port = src->reuse_port;
+	iostream_ctx_copy(&dst->io_ctx, &src->io_ctx);
 	ev_io_set(&dst->ev, src->ev.fd, EV_READ);
 }
 
+/**
+ * Same as evio_service_entry_attach(), but bind a new socket to
+ * the address of @a src if it's bound with SO_REUSEPORT.
+ */
+static int
+evio_service_entry_attach_reuse_port(struct evio_service_entry *dst,
+				     const struct evio_service_entry *src)
+{
+	evio_service_entry_attach(dst, src);
+	if (!src->reuse_port || src->addr.sa_family == AF_UNIX)
+		return 0;
+	ev_io_set(&dst->ev, -1, 0);
+	if (evio_service_entry_bind_addr(dst) != 0)
+		return -1;
+	dst->is_private = true;
+	return 0;
+}
+
 static inline int
 evio_service_reuse_addr(const struct uri_set *uri_set)
 {
@@ -465,6 +533,20 @@ evio_service_attach(struct evio_service *dst, const struct evio_service *src)
 		evio_service_entry_attach(&dst->entries[i], &src->entries[i]);
 }
 
+int
+evio_service_attach_reuse_port(struct evio_service *dst,
+			       const struct evio_service *src)
+{
+	assert(dst->entry_count == 0);
+	evio_service_create_entries(dst, src->entry_count);
+	for (int i = 0; i < src->entry_count; i++) {
+		if (evio_service_entry_attach_reuse_port(
+				&dst->entries[i], &src->entries[i]) != 0)
+			return -1;
+	}
+	return 0;
+}
+
 void
 evio_service_detach(struct evio_service *service)
 {
@@ -36,6 +36,7 @@
  */
 #include <stdbool.h>
 #include "tarantool_ev.h"
+#include "iostream.h"
 #include "sio.h"
 #include "uri/uri.h"
 
@@ -65,8 +66,8 @@ extern "C" {
 struct evio_service_entry;
 struct evio_service;
 
-typedef int (*evio_accept_f)(struct evio_service *, int, struct sockaddr *,
-			     socklen_t);
+typedef int (*evio_accept_f)(struct evio_service *, struct iostream *,
+			     struct sockaddr *, socklen_t);
 
 struct evio_service {
         /** Total count of services */
@@ -77,8 +78,11 @@ struct evio_service {
         char name[SERVICE_NAME_MAXLEN];
         /**
          * A callback invoked on every accepted client socket.
-         * If a callback returned != 0, the accepted socket is
-         * closed and the error is logged.
+         * The stream is created according to the "transport"
+         * parameter of the URI the socket was accepted on. On
+         * success the callback takes ownership of the stream,
+         * e.g. with iostream_move(). If a callback returned != 0,
+         * the accepted socket is closed and the error is logged.
          */
         evio_accept_f on_accept;
         void *on_accept_param;
@@ -130,6 +134,17 @@ evio_service_stop(struct evio_service *service);
 void
 evio_service_attach(struct evio_service *dst, const struct evio_service *src);
 
+/**
+ * Same as evio_service_attach(), but for each socket of @a src
+ * bound with SO_REUSEPORT (URI parameter reuseport=true) bind
+ * a new socket to the same address, so that the kernel balances
+ * incoming connections between the services. Such sockets are
+ * closed on detach. Returns -1 and sets diag on error.
+ */
+int
+evio_service_attach_reuse_port(struct evio_service *dst,
+			       const struct evio_service *src);
+
 bool
 evio_service_is_active(const struct evio_service *service);
 
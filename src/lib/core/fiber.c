@@ -32,6 +32,7 @@
 
 #include <trivia/config.h>
 #include <trivia/util.h>
+#include <trivia/probe.h>
 #include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -39,6 +40,7 @@
 #include <pmatomic.h>
 
 #include "assoc.h"
+#include "clock.h"
 #include "memory.h"
 #include "trigger.h"
 #include "errinj.h"
@@ -215,6 +217,37 @@ fiber_mprotect(void *addr, size_t len, int prot)
 static __thread bool fiber_top_enabled = false;
 #endif /* ENABLE_FIBER_TOP */
 
+/**
+ * Account the run of a fiber that is switched from, if it isn't
+ * the scheduler, and start the run of the next one.
+ */
+static void
+loop_stat_on_csw(struct loop_stat *stat, struct fiber *caller)
+{
+	double now = clock_monotonic();
+	double duration = now - stat->run_start;
+	stat->run_start = now;
+	if (caller == &cord()->sched)
+		return;
+	stat->run_count++;
+	int bucket = 0;
+	uint64_t usec = duration * 1e6;
+	if (usec > 1)
+		bucket = 64 - __builtin_clzll(usec - 1);
+	bucket = MIN(bucket, LOOP_STAT_RUN_BUCKET_COUNT - 1);
+	stat->run_hist[bucket]++;
+	struct loop_stat_run *longest = stat->longest;
+	int i = LOOP_STAT_LONGEST_RUN_COUNT - 1;
+	if (duration <= longest[i].duration)
+		return;
+	for (; i > 0 && longest[i - 1].duration < duration; i--)
+		longest[i] = longest[i - 1];
+	longest[i].duration = duration;
+	longest[i].end_time = clock_realtime();
+	longest[i].fid = caller->fid;
+	strlcpy(longest[i].name, fiber_name(caller), LOOP_STAT_NAME_MAX);
+}
+
 /**
  * An action performed each time a context switch happens.
  * Used to count each fiber's processing time.
@@ -224,6 +257,10 @@ clock_set_on_csw(struct fiber *caller)
 {
 	caller->csw++;
 
+	struct loop_stat *loop_stat = &cord()->loop_stat;
+	if (unlikely(loop_stat->is_enabled))
+		loop_stat_on_csw(loop_stat, caller);
+
 #if ENABLE_FIBER_TOP
 	if (!fiber_top_enabled)
 		return;
@@ -399,6 +436,8 @@ fiber_call_impl(struct fiber *callee)
 	assert((caller->flags & FIBER_IS_RUNNING) != 0);
 	assert((callee->flags & FIBER_IS_RUNNING) == 0);
 
+	TT_PROBE(fiber_yield, caller->fid, callee->fid);
+
 	caller->flags &= ~FIBER_IS_RUNNING;
 	cord->fiber = callee;
 	callee->flags = (callee->flags & ~FIBER_IS_READY) | FIBER_IS_RUNNING;
@@ -500,8 +539,10 @@ fiber_wakeup(struct fiber *f)
 	 */
 	assert((f->flags & FIBER_IS_DEAD) == 0);
 	const int no_flags = FIBER_IS_READY | FIBER_IS_DEAD | FIBER_IS_RUNNING;
-	if ((f->flags & no_flags) == 0)
+	if ((f->flags & no_flags) == 0) {
+		TT_PROBE(fiber_wakeup, f->fid);
 		fiber_make_ready(f);
+	}
 }
 
 /** Cancel the subject fiber.
@@ -856,7 +897,13 @@ fiber_self(void)
 void
 fiber_gc(void)
 {
-	if (region_used(&fiber()->gc) < 128 * 1024) {
+	/*
+	 * Check the memory held by the region rather than the
+	 * memory used by the last request: region_reset() keeps
+	 * all slabs, so an occasional big request would pin them
+	 * to the fiber until it dies.
+	 */
+	if (region_total(&fiber()->gc) <= FIBER_GC_REGION_MAX) {
 		region_reset(&fiber()->gc);
 		return;
 	}
@@ -894,6 +941,7 @@ fiber_recycle(struct fiber *fiber)
 	fiber->name[0] = '\0';
 	fiber->f = NULL;
 	fiber->wait_pad = NULL;
+	fiber->pool = NULL;
 	memset(&fiber->storage, 0, sizeof(fiber->storage));
 	fiber->storage.lua.storage_ref = FIBER_LUA_NOREF;
 	fiber->storage.lua.fid_ref = FIBER_LUA_NOREF;
@@ -1032,6 +1080,39 @@ stack_put_watermark(void *addr)
 	}
 }
 
+#ifdef HAVE_MADV_FREE
+/**
+ * Set if the kernel doesn't support MADV_FREE (it appeared in
+ * Linux 4.5). Written at most once, so races are harmless.
+ */
+static bool stack_madv_free_unsupported;
+#endif /* HAVE_MADV_FREE */
+
+/**
+ * Give unused stack pages back to the OS. MADV_FREE is preferred:
+ * the kernel reclaims such pages only under memory pressure, so
+ * a fiber that touches them again soon, which is likely for a
+ * fiber that has already used this much stack, doesn't take a
+ * page fault and a page clearing for each of them. Errors are
+ * ignored because this is just a hint for the OS.
+ */
+static void
+fiber_stack_release(void *addr, size_t len)
+{
+#ifdef HAVE_MADV_FREE
+	bool use_madv_free = !stack_madv_free_unsupported;
+	/* Let the injection be handled by fiber_madvise(). */
+	ERROR_INJECT(ERRINJ_FIBER_MADVISE, { use_madv_free = false; });
+	if (use_madv_free) {
+		if (madvise(addr, len, MADV_FREE) == 0)
+			return;
+		if (errno == EINVAL)
+			stack_madv_free_unsupported = true;
+	}
+#endif /* HAVE_MADV_FREE */
+	fiber_madvise(addr, len, MADV_DONTNEED);
+}
+
 /**
  * Free stack memory above the watermark when a fiber is recycled.
  * To avoid a pointless syscall invocation in case the fiber hasn't
@@ -1058,12 +1139,7 @@ fiber_stack_recycle(struct fiber *fiber)
 		end = fiber->stack + fiber->stack_size;
 	}
 
-	/*
-	 * Ignore errors on MADV_DONTNEED because this is
-	 * just a hint for OS and not critical for
-	 * functionality.
-	 */
-	fiber_madvise(start, end - start, MADV_DONTNEED);
+	fiber_stack_release(start, end - start);
 	stack_put_watermark(fiber->stack_watermark);
 }
 
@@ -1081,11 +1157,9 @@ fiber_stack_watermark_create(struct fiber *fiber)
 
 	/*
 	 * We don't expect the whole stack usage in regular
-	 * loads, let's try to minimize rss pressure. But do
-	 * not exit if MADV_DONTNEED failed, it is just a hint
-	 * for OS, not critical one.
+	 * loads, let's try to minimize rss pressure.
 	 */
-	fiber_madvise(fiber->stack, fiber->stack_size, MADV_DONTNEED);
+	fiber_stack_release(fiber->stack, fiber->stack_size);
 
 	/*
 	 * To increase probability of stack overflow detection
@@ -1410,6 +1484,97 @@ fiber_top_disable(void)
 }
 #endif /* ENABLE_FIBER_TOP */
 
+static void
+loop_stat_on_iteration_start(ev_loop *loop, ev_check *watcher, int revents)
+{
+	(void)loop;
+	(void)revents;
+	struct loop_stat *stat = (struct loop_stat *)watcher->data;
+	double now = clock_monotonic();
+	stat->idle_time += now - stat->iteration_time;
+	stat->iteration_time = now;
+	stat->run_start = now;
+}
+
+static void
+loop_stat_on_iteration_end(ev_loop *loop, ev_prepare *watcher, int revents)
+{
+	(void)loop;
+	(void)revents;
+	struct loop_stat *stat = (struct loop_stat *)watcher->data;
+	double now = clock_monotonic();
+	double busy = now - stat->iteration_time;
+	stat->busy_time += busy;
+	stat->window_busy_time += busy;
+	stat->iteration_time = now;
+	double window = now - stat->window_start;
+	if (window >= 1) {
+		stat->utilization = stat->window_busy_time / window;
+		stat->window_start = now;
+		stat->window_busy_time = 0;
+	}
+}
+
+void
+loop_stat_enable(void)
+{
+	struct loop_stat *stat = &cord()->loop_stat;
+	if (stat->is_enabled)
+		return;
+	double now = clock_monotonic();
+	stat->busy_time = 0;
+	stat->idle_time = 0;
+	stat->utilization = 0;
+	stat->window_start = now;
+	stat->window_busy_time = 0;
+	stat->iteration_time = now;
+	stat->run_start = now;
+	stat->run_count = 0;
+	memset(stat->run_hist, 0, sizeof(stat->run_hist));
+	memset(stat->longest, 0, sizeof(stat->longest));
+	ev_check_start(cord()->loop, &stat->check_event);
+	ev_prepare_start(cord()->loop, &stat->prepare_event);
+	stat->is_enabled = true;
+}
+
+void
+loop_stat_disable(void)
+{
+	struct loop_stat *stat = &cord()->loop_stat;
+	if (!stat->is_enabled)
+		return;
+	ev_check_stop(cord()->loop, &stat->check_event);
+	ev_prepare_stop(cord()->loop, &stat->prepare_event);
+	stat->is_enabled = false;
+}
+
+double
+loop_stat_run_percentile(double percentile)
+{
+	struct loop_stat *stat = &cord()->loop_stat;
+	if (stat->run_count == 0)
+		return 0;
+	uint64_t threshold = stat->run_count * percentile / 100;
+	uint64_t count = 0;
+	int i;
+	for (i = 0; i < LOOP_STAT_RUN_BUCKET_COUNT - 1; i++) {
+		count += stat->run_hist[i];
+		if (count > threshold)
+			break;
+	}
+	return (double)(1ULL << i) / 1e6;
+}
+
+size_t
+loop_stat_ready_count(void)
+{
+	size_t count = 0;
+	struct fiber *fiber;
+	rlist_foreach_entry(fiber, &cord()->ready, state)
+		count++;
+	return count;
+}
+
 size_t
 box_region_used(void)
 {
@@ -1476,6 +1641,14 @@ cord_create(struct cord *cord, const char *name)
 
 	ev_idle_init(&cord->idle_event, fiber_schedule_idle);
 
+	cord->loop_stat.is_enabled = false;
+	ev_check_init(&cord->loop_stat.check_event,
+		      loop_stat_on_iteration_start);
+	cord->loop_stat.check_event.data = &cord->loop_stat;
+	ev_prepare_init(&cord->loop_stat.prepare_event,
+			loop_stat_on_iteration_end);
+	cord->loop_stat.prepare_event.data = &cord->loop_stat;
+
 #if ENABLE_FIBER_TOP
 	/* fiber.top() currently works only for the main thread. */
 	if (cord_is_main()) {
@@ -1564,6 +1737,9 @@ void *cord_thread_func(void *p)
 	return res;
 }
 
+static void
+cord_reset_cpu_affinity(struct cord *cord);
+
 int
 cord_start(struct cord *cord, const char *name, void *(*f)(void *), void *arg)
 {
@@ -1581,6 +1757,7 @@ cord_start(struct cord *cord, const char *name, void *(*f)(void *), void *arg)
 		diag_set(SystemError, "failed to create thread");
 		goto end;
 	}
+	cord_reset_cpu_affinity(cord);
 	res = 0;
 	while (! ct_arg.is_started)
 		tt_pthread_cond_wait(&ct_arg.start_cond, &ct_arg.start_mutex);
@@ -1784,6 +1961,124 @@ cord_set_name(const char *name)
 	tt_pthread_setname(name);
 }
 
+#if defined(__linux__)
+
+/**
+ * CPU affinity of the process before the first thread was pinned
+ * with cord_set_cpu_affinity(). Threads started after that get it
+ * instead of the affinity of the thread that starts them, so that
+ * pinning tx doesn't pin all the workers it starts later.
+ */
+static cpu_set_t cord_default_cpu_set;
+static bool cord_default_cpu_set_is_saved = false;
+
+/** Parse a list of CPUs like "0-3,8" into a CPU set. */
+static int
+cpu_set_parse(const char *cpus, cpu_set_t *set)
+{
+	CPU_ZERO(set);
+	const char *p = cpus;
+	while (true) {
+		char *end;
+		errno = 0;
+		long first = strtol(p, &end, 10);
+		if (end == p || errno != 0 || first < 0)
+			goto error;
+		long last = first;
+		p = end;
+		if (*p == '-') {
+			p++;
+			last = strtol(p, &end, 10);
+			if (end == p || errno != 0 || last < first)
+				goto error;
+			p = end;
+		}
+		if (last >= CPU_SETSIZE)
+			goto error;
+		for (long cpu = first; cpu <= last; cpu++)
+			CPU_SET(cpu, set);
+		if (*p == '\0')
+			return 0;
+		if (*p != ',')
+			goto error;
+		p++;
+	}
+error:
+	diag_set(IllegalParams, "invalid CPU list '%s'", cpus);
+	return -1;
+}
+
+int
+cord_check_cpu_affinity(const char *cpus)
+{
+	if (cpus == NULL || *cpus == '\0')
+		return 0;
+	cpu_set_t set;
+	return cpu_set_parse(cpus, &set);
+}
+
+int
+cord_set_cpu_affinity(struct cord *cord, const char *cpus)
+{
+	if (cpus == NULL || *cpus == '\0')
+		return 0;
+	cpu_set_t set;
+	if (cpu_set_parse(cpus, &set) != 0)
+		return -1;
+	if (!cord_default_cpu_set_is_saved) {
+		if (sched_getaffinity(0, sizeof(cord_default_cpu_set),
+				      &cord_default_cpu_set) != 0) {
+			diag_set(SystemError, "failed to get CPU affinity");
+			return -1;
+		}
+		cord_default_cpu_set_is_saved = true;
+	}
+	int rc = pthread_setaffinity_np(cord->id, sizeof(set), &set);
+	if (rc != 0) {
+		errno = rc;
+		diag_set(SystemError, "failed to pin thread '%s' to CPUs '%s'",
+			 cord_name(cord), cpus);
+		return -1;
+	}
+	return 0;
+}
+
+/** Give a just started thread the default CPU affinity. */
+static void
+cord_reset_cpu_affinity(struct cord *cord)
+{
+	if (cord_default_cpu_set_is_saved)
+		pthread_setaffinity_np(cord->id, sizeof(cord_default_cpu_set),
+				       &cord_default_cpu_set);
+}
+
+#else /* !defined(__linux__) */
+
+static void
+cord_reset_cpu_affinity(struct cord *cord)
+{
+	(void)cord;
+}
+
+int
+cord_check_cpu_affinity(const char *cpus)
+{
+	if (cpus == NULL || *cpus == '\0')
+		return 0;
+	diag_set(IllegalParams, "CPU affinity is not supported on this "
+		 "platform");
+	return -1;
+}
+
+int
+cord_set_cpu_affinity(struct cord *cord, const char *cpus)
+{
+	(void)cord;
+	return cord_check_cpu_affinity(cpus);
+}
+
+#endif /* !defined(__linux__) */
+
 bool
 cord_is_main(void)
 {
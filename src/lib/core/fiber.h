@@ -121,6 +121,68 @@ struct cpu_stat {
 
 #endif /* ENABLE_FIBER_TOP */
 
+enum {
+	/** Number of the longest fiber runs kept in loop_stat. */
+	LOOP_STAT_LONGEST_RUN_COUNT = 5,
+	/**
+	 * Number of buckets in the histogram of fiber run times.
+	 * Bucket i counts runs that took up to 2^i microseconds.
+	 */
+	LOOP_STAT_RUN_BUCKET_COUNT = 32,
+	/** Length of a fiber name kept for a long run. */
+	LOOP_STAT_NAME_MAX = 32,
+};
+
+/** A fiber run without yields, see loop_stat. */
+struct loop_stat_run {
+	/** Duration of the run, in seconds. */
+	double duration;
+	/** Realtime when the run ended. */
+	double end_time;
+	/** Id of the fiber. */
+	uint64_t fid;
+	/** Name of the fiber, truncated. */
+	char name[LOOP_STAT_NAME_MAX];
+};
+
+/**
+ * Event loop statistics of a cord, collected when enabled with
+ * loop_stat_enable(). A fiber run is the time between switching
+ * to a fiber and switching from it, i.e. the time the fiber
+ * holds the thread without yielding.
+ */
+struct loop_stat {
+	/** True if the statistics is being collected. */
+	bool is_enabled;
+	/** Time spent processing events since enabled, in seconds. */
+	double busy_time;
+	/** Time spent waiting for events since enabled, in seconds. */
+	double idle_time;
+	/**
+	 * Share of time spent processing events over the last
+	 * second, from 0 to 1.
+	 */
+	double utilization;
+	/** Start of the current utilization measurement window. */
+	double window_start;
+	/** Time spent processing events in the current window. */
+	double window_busy_time;
+	/** Time when the loop woke up or went to sleep last time. */
+	double iteration_time;
+	/** Time when the current fiber run started. */
+	double run_start;
+	/** Number of fiber runs since enabled. */
+	uint64_t run_count;
+	/** Histogram of fiber run times. */
+	uint64_t run_hist[LOOP_STAT_RUN_BUCKET_COUNT];
+	/** The longest fiber runs, sorted by duration, descending. */
+	struct loop_stat_run longest[LOOP_STAT_LONGEST_RUN_COUNT];
+	/** An event triggered on every event loop iteration start. */
+	ev_check check_event;
+	/** An event triggered on every event loop iteration end. */
+	ev_prepare prepare_event;
+};
+
 enum {
 	/** Both limits include terminating 0. */
 	FIBER_NAME_INLINE = 40,
@@ -648,10 +710,23 @@ struct fiber {
 		 */
 		struct {
 			uint64_t sync;
+			/**
+			 * Time the current request has spent
+			 * waiting for WAL, in seconds.
+			 */
+			double wal_wait;
+			/**
+			 * Time the current request has spent
+			 * waiting for synchronous replication,
+			 * in seconds.
+			 */
+			double limbo_wait;
 		} net;
 	} storage;
 	/** An object to wait for incoming message or a reader. */
 	struct ipc_wait_pad *wait_pad;
+	/** Fiber pool this fiber is a worker of or NULL. */
+	struct fiber_pool *pool;
 	/** Exception which caused this fiber's death. */
 	struct diag diag;
 	/**
@@ -727,6 +802,8 @@ struct cord {
 	struct slab_cache slabc;
 	/** The "main" fiber of this cord, the scheduler. */
 	struct fiber sched;
+	/** Event loop statistics, see loop_stat_enable(). */
+	struct loop_stat loop_stat;
 	char name[FIBER_NAME_INLINE];
 };
 
@@ -798,6 +875,26 @@ cord_join(struct cord *cord);
 void
 cord_set_name(const char *name);
 
+/**
+ * Pin the thread of \a cord to the CPUs listed in \a cpus.
+ * The list is a comma-separated list of CPU numbers and ranges,
+ * e.g. "0-3,8". NULL or an empty string leaves the affinity as is.
+ *
+ * @return 0 on success, -1 and sets diag if the list is invalid
+ * or the affinity can't be set.
+ */
+int
+cord_set_cpu_affinity(struct cord *cord, const char *cpus);
+
+/**
+ * Check that \a cpus is a valid CPU list for cord_set_cpu_affinity()
+ * without pinning any thread.
+ *
+ * @return 0 on success, -1 and sets diag on error.
+ */
+int
+cord_check_cpu_affinity(const char *cpus);
+
 static inline const char *
 cord_name(struct cord *cord)
 {
@@ -841,6 +938,16 @@ fiber_yield_timeout(ev_tstamp delay);
 void
 fiber_destroy_all(struct cord *cord);
 
+/**
+ * Max size of the memory a fiber region may keep after fiber_gc().
+ * A region that has grown above it returns all its slabs to the
+ * cord slab cache, so that other fibers can reuse them.
+ */
+enum { FIBER_GC_REGION_MAX = 128 * 1024 };
+
+/**
+ * Discard all allocations on the region of the current fiber.
+ */
 void
 fiber_gc(void);
 
@@ -875,6 +982,28 @@ void
 fiber_top_disable(void);
 #endif /* ENABLE_FIBER_TOP */
 
+/**
+ * Start collecting event loop statistics of the current cord,
+ * see struct loop_stat. Resets the statistics collected before.
+ */
+void
+loop_stat_enable(void);
+
+/** Stop collecting event loop statistics of the current cord. */
+void
+loop_stat_disable(void);
+
+/**
+ * Return the upper bound of the given percentile of fiber run
+ * times of the current cord, in seconds.
+ */
+double
+loop_stat_run_percentile(double percentile);
+
+/** Return the number of fibers ready to run in the current cord. */
+size_t
+loop_stat_ready_count(void);
+
 /** Useful for C unit tests */
 static inline int
 fiber_c_invoke(fiber_func f, va_list ap)
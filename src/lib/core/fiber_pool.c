@@ -29,6 +29,25 @@
  * SUCH DAMAGE.
  */
 #include "fiber_pool.h"
+
+/** Check if the pool is allowed to start one more worker. */
+static inline bool
+fiber_pool_can_grow(struct fiber_pool *pool)
+{
+	return pool->size - pool->blocked < pool->max_size &&
+	       pool->size < pool->max_size * FIBER_POOL_BLOCKED_SIZE_FACTOR;
+}
+
+/**
+ * Check if the pool has more workers than allowed, not counting
+ * the blocked ones, so the current one should leave the pool.
+ */
+static inline bool
+fiber_pool_is_oversized(struct fiber_pool *pool)
+{
+	return pool->size - pool->blocked > pool->max_size;
+}
+
 /**
  * Main function of the fiber invoked to handle all outstanding
  * tasks in a queue.
@@ -44,6 +63,7 @@ fiber_pool_f(va_list ap)
 	struct cmsg *msg;
 	ev_tstamp last_active_at = ev_monotonic_now(loop);
 	pool->size++;
+	f->pool = pool;
 restart:
 	msg = NULL;
 	while (!stailq_empty(output) && !fiber_is_cancelled()) {
@@ -74,8 +94,9 @@ restart:
 		fiber_on_stop(f);
 	}
 	/** Put the current fiber into a fiber cache. */
-	if (!fiber_is_cancelled() && (msg != NULL ||
-	    ev_monotonic_now(loop) - last_active_at < pool->idle_timeout)) {
+	if (!fiber_is_cancelled() && !fiber_pool_is_oversized(pool) &&
+	    (msg != NULL ||
+	     ev_monotonic_now(loop) - last_active_at < pool->idle_timeout)) {
 		if (msg != NULL)
 			last_active_at = ev_monotonic_now(loop);
 		/*
@@ -83,6 +104,14 @@ restart:
 		 * it is most likely to get scheduled again.
 		 */
 		f->flags |= FIBER_IS_IDLE;
+		/*
+		 * An idle worker doesn't need its region. Return
+		 * the slabs to the cord slab cache, so that the
+		 * pool memory doesn't grow with the number of
+		 * workers and the next busy worker reuses slabs
+		 * that are still hot in the CPU cache.
+		 */
+		region_free(&f->gc);
 		rlist_add_entry(&pool->idle, fiber(), state);
 		fiber_yield();
 		f->flags &= ~FIBER_IS_IDLE;
@@ -90,6 +119,7 @@ restart:
 		goto restart;
 	}
 	pool->size--;
+	f->pool = NULL;
 	fiber_cond_signal(&pool->worker_cond);
 
 	return 0;
@@ -129,7 +159,7 @@ fiber_pool_cb(ev_loop *loop, struct ev_watcher *watcher, int events)
 		if (! rlist_empty(&pool->idle)) {
 			f = rlist_shift_entry(&pool->idle, struct fiber, state);
 			fiber_call(f);
-		} else if (pool->size < pool->max_size) {
+		} else if (fiber_pool_can_grow(pool)) {
 			f = fiber_new(cord_name(cord()), fiber_pool_f);
 			if (f == NULL) {
 				diag_log();
@@ -149,6 +179,32 @@ fiber_pool_cb(ev_loop *loop, struct ev_watcher *watcher, int events)
 	}
 }
 
+void
+fiber_pool_block_begin(void)
+{
+	struct fiber_pool *pool = fiber()->pool;
+	if (pool == NULL)
+		return;
+	pool->blocked++;
+	/*
+	 * Let the pool callback start a new worker for the queued
+	 * messages, if any. It runs from the scheduler, so the
+	 * current fiber isn't delayed by the new one.
+	 */
+	if (!stailq_empty(&pool->output))
+		ev_feed_event(pool->consumer, &pool->endpoint.async, EV_CUSTOM);
+}
+
+void
+fiber_pool_block_end(void)
+{
+	struct fiber_pool *pool = fiber()->pool;
+	if (pool == NULL)
+		return;
+	assert(pool->blocked > 0);
+	pool->blocked--;
+}
+
 void
 fiber_pool_set_max_size(struct fiber_pool *pool, int new_max_size)
 {
@@ -167,6 +223,7 @@ fiber_pool_create(struct fiber_pool *pool, const char *name, int max_pool_size,
 	pool->idle_timer.data = pool;
 	ev_timer_again(loop(), &pool->idle_timer);
 	pool->size = 0;
+	pool->blocked = 0;
 	pool->max_size = max_pool_size;
 	stailq_create(&pool->output);
 	fiber_cond_create(&pool->worker_cond);
@@ -44,6 +44,13 @@ extern "C" {
 /** Period after which an idle fiber in the pool is shut down. */
 enum { FIBER_POOL_IDLE_TIMEOUT = 1 };
 
+/**
+ * Hard limit on the pool size, as a multiple of the maximal
+ * pool size, when some workers are blocked, see
+ * fiber_pool_block_begin().
+ */
+enum { FIBER_POOL_BLOCKED_SIZE_FACTOR = 2 };
+
 /**
  * A pool of worker fibers to handle messages,
  * so that each message is handled in its own fiber.
@@ -56,6 +63,12 @@ struct fiber_pool {
 		int size;
 		/** The limit on the number of fibers working on tasks. */
 		int max_size;
+		/**
+		 * The number of fibers blocked on a wait that
+		 * doesn't need CPU, like a WAL write. They aren't
+		 * counted against max_size.
+		 */
+		int blocked;
 		/**
 		 * Fibers in leave the pool if they have nothing to do
 		 * for longer than this.
@@ -92,6 +105,23 @@ fiber_pool_create(struct fiber_pool *pool, const char *name, int max_pool_size,
 void
 fiber_pool_set_max_size(struct fiber_pool *pool, int new_max_size);
 
+/**
+ * Mark the current fiber as blocked on a long wait that doesn't
+ * need CPU, like a WAL write, until fiber_pool_block_end(). While
+ * a worker is blocked, it isn't counted against the pool size
+ * limit, so that the messages queued in the pool are handled by
+ * new workers instead of waiting for the blocked ones. The pool
+ * never grows beyond FIBER_POOL_BLOCKED_SIZE_FACTOR * max_size,
+ * and the extra workers leave the pool as soon as they are done.
+ * Does nothing if the current fiber isn't a pool worker.
+ */
+void
+fiber_pool_block_begin(void);
+
+/** Counterpart of fiber_pool_block_begin(). */
+void
+fiber_pool_block_end(void);
+
 /**
  * Destroy a fiber pool
  */
@@ -8,10 +8,14 @@
 
 #include <assert.h>
 #include <errno.h>
+#include <string.h>
 #include <sys/types.h>
 #include <unistd.h>
 
+#include "diag.h"
 #include "sio.h"
+#include "ssl_iostream.h"
+#include "uri/uri.h"
 
 static const struct iostream_vtab plain_iostream_vtab;
 
@@ -24,6 +28,57 @@ iostream_create(struct iostream *io, int fd)
 	io->fd = fd;
 }
 
+bool
+iostream_is_plain(const struct iostream *io)
+{
+	return io->vtab == &plain_iostream_vtab;
+}
+
+int
+iostream_ctx_create(struct iostream_ctx *ctx, enum iostream_mode mode,
+		    const struct uri *uri)
+{
+	assert(mode == IOSTREAM_SERVER || mode == IOSTREAM_CLIENT);
+	iostream_ctx_clear(ctx);
+	const char *transport = uri_param(uri, "transport", 0);
+	if (transport != NULL && strcmp(transport, "ssl") == 0) {
+		ctx->ssl = ssl_iostream_ctx_new(mode, uri);
+		if (ctx->ssl == NULL)
+			return -1;
+	} else if (transport != NULL && strcmp(transport, "plain") != 0) {
+		diag_set(IllegalParams, "invalid transport: %s", transport);
+		return -1;
+	}
+	ctx->mode = mode;
+	return 0;
+}
+
+void
+iostream_ctx_copy(struct iostream_ctx *dst, const struct iostream_ctx *src)
+{
+	dst->mode = src->mode;
+	dst->ssl = src->ssl != NULL ? ssl_iostream_ctx_ref(src->ssl) : NULL;
+}
+
+void
+iostream_ctx_destroy(struct iostream_ctx *ctx)
+{
+	if (ctx->ssl != NULL)
+		ssl_iostream_ctx_unref(ctx->ssl);
+	iostream_ctx_clear(ctx);
+}
+
+int
+iostream_create_with_ctx(struct iostream *io, int fd,
+			 const struct iostream_ctx *ctx)
+{
+	assert(ctx->mode != IOSTREAM_MODE_UNINITIALIZED);
+	if (ctx->ssl != NULL)
+		return ssl_iostream_create(io, fd, ctx->mode, ctx->ssl);
+	iostream_create(io, fd);
+	return 0;
+}
+
 void
 iostream_close(struct iostream *io)
 {
@@ -79,4 +134,5 @@ static const struct iostream_vtab plain_iostream_vtab = {
 	/* .read = */ plain_iostream_read,
 	/* .write = */ plain_iostream_write,
 	/* .writev = */ plain_iostream_writev,
+	/* .pending = */ NULL,
 };
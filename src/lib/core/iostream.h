@@ -19,6 +19,8 @@ extern "C" {
 
 struct iostream;
 struct iovec;
+struct ssl_iostream_ctx;
+struct uri;
 
 /**
  * A negative status code is returned by an iostream read/write operation
@@ -74,6 +76,9 @@ struct iostream_vtab {
 	/** See iostream_writev. */
 	ssize_t
 	(*writev)(struct iostream *io, const struct iovec *iov, int iovcnt);
+	/** See iostream_pending. May be NULL. */
+	size_t
+	(*pending)(struct iostream *io);
 };
 
 /**
@@ -118,6 +123,86 @@ iostream_is_initialized(struct iostream *io)
 void
 iostream_create(struct iostream *io, int fd);
 
+/**
+ * Returns true if the stream was created with iostream_create().
+ * A plain stream has no state except the fd, so it may be read in
+ * one thread and written in another one at the same time.
+ */
+bool
+iostream_is_plain(const struct iostream *io);
+
+/**
+ * Moves a stream from src to dst. The src stream is cleared.
+ */
+static inline void
+iostream_move(struct iostream *dst, struct iostream *src)
+{
+	*dst = *src;
+	iostream_clear(src);
+}
+
+/** Side of a connection, which matters for encrypted streams. */
+enum iostream_mode {
+	/** Context is not initialized. */
+	IOSTREAM_MODE_UNINITIALIZED = 0,
+	/** Accepted connection. */
+	IOSTREAM_SERVER,
+	/** Outgoing connection. */
+	IOSTREAM_CLIENT,
+};
+
+/**
+ * Context used for creating streams of a particular kind, e.g.
+ * of the connections accepted on a listening socket.
+ */
+struct iostream_ctx {
+	enum iostream_mode mode;
+	/** SSL context or NULL for plain streams. */
+	struct ssl_iostream_ctx *ssl;
+};
+
+/**
+ * Clears a stream context so that it can be passed to
+ * iostream_ctx_destroy().
+ */
+static inline void
+iostream_ctx_clear(struct iostream_ctx *ctx)
+{
+	ctx->mode = IOSTREAM_MODE_UNINITIALIZED;
+	ctx->ssl = NULL;
+}
+
+/**
+ * Creates a stream context for the given URI. A plain context is
+ * created unless the URI has the "transport=ssl" parameter, see
+ * ssl_iostream_ctx_new() for SSL parameters. Returns -1 and sets
+ * diag on error.
+ */
+int
+iostream_ctx_create(struct iostream_ctx *ctx, enum iostream_mode mode,
+		    const struct uri *uri);
+
+/**
+ * Makes dst refer to the same stream parameters as src. Both have
+ * to be destroyed. Can be used for sharing a context between
+ * threads.
+ */
+void
+iostream_ctx_copy(struct iostream_ctx *dst, const struct iostream_ctx *src);
+
+/** Destroys a stream context. */
+void
+iostream_ctx_destroy(struct iostream_ctx *ctx);
+
+/**
+ * Creates a stream for the given file descriptor according to
+ * the context. Returns -1 and sets diag on error, the fd is not
+ * closed in this case.
+ */
+int
+iostream_create_with_ctx(struct iostream *io, int fd,
+			 const struct iostream_ctx *ctx);
+
 /**
  * Destroys a stream and closes its fd. The stream fd is set to -1.
  */
@@ -169,6 +254,20 @@ iostream_writev(struct iostream *io, const struct iovec *iov, int iovcnt)
 	return io->vtab->writev(io, iov, iovcnt);
 }
 
+/**
+ * Returns the number of bytes that were received and processed
+ * by the stream, but not returned by iostream_read yet. A reader
+ * that doesn't read until IOSTREAM_WANT_READ must not wait for
+ * the fd to become readable if there are such bytes.
+ */
+static inline size_t
+iostream_pending(struct iostream *io)
+{
+	if (io->vtab->pending == NULL)
+		return 0;
+	return io->vtab->pending(io);
+}
+
 #if defined(__cplusplus)
 } /* extern "C" */
 #endif /* defined(__cplusplus) */
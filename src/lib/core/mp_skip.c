@@ -0,0 +1,196 @@
+/*
+ * Copyright 2026, Tarantool AUTHORS, please see AUTHORS file.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above
+ *    copyright notice, this list of conditions and the
+ *    following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY <COPYRIGHT HOLDER> ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * <COPYRIGHT HOLDER> OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+#include "mp_skip.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "msgpuck.h"
+#include "trivia/util.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/**
+ * Check if a byte is a complete MsgPack value: a positive or
+ * negative fixint, nil, false or true.
+ */
+static inline bool
+mp_is_one_byte_value(uint8_t c)
+{
+	return c <= 0x7f || c >= 0xe0 || c == 0xc0 || c == 0xc2 ||
+	       c == 0xc3;
+}
+
+/**
+ * Skip at most @a k one-byte values starting at @a p and return
+ * the number of skipped values, which is also the number of bytes.
+ */
+static inline size_t
+mp_skip_one_byte_values(const char *p, const char *end, int64_t k)
+{
+	const char *start = p;
+#if defined(__SSE2__)
+	/* Fixints are the bytes that are >= -32 as signed. */
+	const __m128i fixint_min = _mm_set1_epi8(-33);
+	const __m128i nil = _mm_set1_epi8((char)0xc0);
+	const __m128i false_ = _mm_set1_epi8((char)0xc2);
+	const __m128i true_ = _mm_set1_epi8((char)0xc3);
+	while (k >= 16 && end - p >= 16) {
+		__m128i v = _mm_loadu_si128((const __m128i *)p);
+		__m128i m = _mm_cmpgt_epi8(v, fixint_min);
+		m = _mm_or_si128(m, _mm_cmpeq_epi8(v, nil));
+		m = _mm_or_si128(m, _mm_cmpeq_epi8(v, false_));
+		m = _mm_or_si128(m, _mm_cmpeq_epi8(v, true_));
+		unsigned mask = _mm_movemask_epi8(m);
+		if (mask != 0xffff)
+			return p - start + __builtin_ctz(~mask);
+		p += 16;
+		k -= 16;
+	}
+#endif
+	while (k > 0 && p < end && mp_is_one_byte_value(*p)) {
+		p++;
+		k--;
+	}
+	return p - start;
+}
+
+/**
+ * If @a p points to an array or map header, check it, set @a count
+ * to the number of values it contains, advance @a p past it and
+ * return true. Otherwise return false. Sets @a is_valid to false
+ * if the header is truncated.
+ */
+static inline bool
+mp_check_container(const char **p, const char *end, int64_t *count,
+		   bool *is_valid)
+{
+	const char *pos = *p;
+	uint8_t c = *pos;
+	int64_t header_size;
+	int64_t multiplier = 1;
+	switch (c) {
+	case 0x80 ... 0x8f:
+		*count = 2 * (c & 0x0f);
+		*p = pos + 1;
+		return true;
+	case 0x90 ... 0x9f:
+		*count = c & 0x0f;
+		*p = pos + 1;
+		return true;
+	case 0xde:
+		multiplier = 2;
+		FALLTHROUGH;
+	case 0xdc:
+		header_size = 3;
+		break;
+	case 0xdf:
+		multiplier = 2;
+		FALLTHROUGH;
+	case 0xdd:
+		header_size = 5;
+		break;
+	default:
+		return false;
+	}
+	if (end - pos < header_size) {
+		*is_valid = false;
+		return true;
+	}
+	pos++;
+	if (header_size == 3)
+		*count = multiplier * mp_load_u16(&pos);
+	else
+		*count = multiplier * mp_load_u32(&pos);
+	*p = pos;
+	return true;
+}
+
+int
+mp_check_fast(const char **data, const char *end)
+{
+	const char *p = *data;
+	/* Number of values left to check. */
+	int64_t k = 1;
+	while (k > 0) {
+		size_t n = mp_skip_one_byte_values(p, end, k);
+		p += n;
+		k -= n;
+		if (k == 0)
+			break;
+		if (p >= end)
+			return 1;
+		int64_t count;
+		bool is_valid = true;
+		if (mp_check_container(&p, end, &count, &is_valid)) {
+			if (!is_valid)
+				return 1;
+			k += count - 1;
+			continue;
+		}
+		/* A scalar value, check it as is. */
+		if (mp_check(&p, end) != 0)
+			return 1;
+		k--;
+	}
+	*data = p;
+	return 0;
+}
+
+void
+mp_next_fast(const char **data, const char *end)
+{
+	const char *p = *data;
+	int64_t k = 1;
+	while (k > 0) {
+		size_t n = mp_skip_one_byte_values(p, end, k);
+		p += n;
+		k -= n;
+		if (k == 0)
+			break;
+		switch (mp_typeof(*p)) {
+		case MP_ARRAY:
+			k += (int64_t)mp_decode_array(&p) - 1;
+			break;
+		case MP_MAP:
+			k += 2 * (int64_t)mp_decode_map(&p) - 1;
+			break;
+		default:
+			mp_next(&p);
+			k--;
+			break;
+		}
+	}
+	*data = p;
+}
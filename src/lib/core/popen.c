@@ -400,6 +400,34 @@ popen_write_timeout(struct popen_handle *handle, const void *buf,
 	return rc;
 }
 
+/**
+ * Return the index of the stream that the @a flags request to
+ * read from, or -1 and set a diag if they are invalid.
+ */
+static int
+popen_read_idx(struct popen_handle *handle, unsigned int flags)
+{
+	if (!(flags & (POPEN_FLAG_FD_STDOUT | POPEN_FLAG_FD_STDERR))) {
+		diag_set(IllegalParams,
+			 "popen: neither stdout nor stderr is set");
+		return -1;
+	}
+
+	if (flags & POPEN_FLAG_FD_STDOUT && flags & POPEN_FLAG_FD_STDERR) {
+		diag_set(IllegalParams, "popen: reading from both stdout and "
+			 "stderr at one call is not supported");
+		return -1;
+	}
+
+	int idx = flags & POPEN_FLAG_FD_STDOUT ?
+		STDOUT_FILENO : STDERR_FILENO;
+
+	if (popen_may_io(handle, idx, flags) != 0)
+		return -1;
+
+	return idx;
+}
+
 /**
  * Read data from a child's peer with timeout.
  *
@@ -436,31 +464,101 @@ popen_read_timeout(struct popen_handle *handle, void *buf,
 		return -1;
 	}
 
-	if (!(flags & (POPEN_FLAG_FD_STDOUT | POPEN_FLAG_FD_STDERR))) {
-		diag_set(IllegalParams,
-			 "popen: neither stdout nor stderr is set");
+	int idx = popen_read_idx(handle, flags);
+	if (idx < 0)
 		return -1;
-	}
 
-	if (flags & POPEN_FLAG_FD_STDOUT && flags & POPEN_FLAG_FD_STDERR) {
-		diag_set(IllegalParams, "popen: reading from both stdout and "
-			 "stderr at one call is not supported");
+	say_debug("popen: %d: read idx [%s:%d] buf %p count %zu "
+		  "fds %d timeout %.9g",
+		  handle->pid, stdX_str(idx), idx, buf, count,
+		  handle->ios[idx].fd, timeout);
+
+	return coio_read_ahead_timeout(&handle->ios[idx], buf, 1, count,
+				       timeout);
+}
+
+/**
+ * Move data from a child's peer to a file descriptor with timeout,
+ * without copying it to user space.
+ *
+ * Yield until some data is moved. The destination @a fd may be a
+ * non-blocking socket or pipe or a regular file. Writes to a file
+ * are done synchronously, like write() to the page cache.
+ *
+ * Returns amount of moved bytes at success, otherwise returns -1
+ * and set a diag.
+ *
+ * Zero return value means EOF.
+ *
+ * Possible errors are the same as for popen_read_timeout(),
+ * plus:
+ *
+ * - IllegalParams: splice() is not supported on this platform.
+ * - SystemError: an IO error occurs at splice().
+ */
+ssize_t
+popen_splice_timeout(struct popen_handle *handle, int fd,
+		     size_t count, unsigned int flags,
+		     ev_tstamp timeout)
+{
+	assert(handle != NULL);
+
+	if (count > (size_t)SSIZE_MAX) {
+		diag_set(IllegalParams, "popen: count is too big");
 		return -1;
 	}
 
-	int idx = flags & POPEN_FLAG_FD_STDOUT ?
-		STDOUT_FILENO : STDERR_FILENO;
-
-	if (popen_may_io(handle, idx, flags) != 0)
+	int idx = popen_read_idx(handle, flags);
+	if (idx < 0)
 		return -1;
 
-	say_debug("popen: %d: read idx [%s:%d] buf %p count %zu "
+	say_debug("popen: %d: splice idx [%s:%d] fd %d count %zu "
 		  "fds %d timeout %.9g",
-		  handle->pid, stdX_str(idx), idx, buf, count,
+		  handle->pid, stdX_str(idx), idx, fd, count,
 		  handle->ios[idx].fd, timeout);
 
-	return coio_read_ahead_timeout(&handle->ios[idx], buf, 1, count,
-				       timeout);
+#ifdef TARGET_OS_LINUX
+	int src_fd = handle->ios[idx].fd;
+	ev_tstamp start, delay;
+	coio_timeout_init(&start, &delay, timeout);
+	while (true) {
+		ssize_t rc = splice(src_fd, NULL, fd, NULL, count,
+				    SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+		if (rc >= 0)
+			return rc;
+		if (errno == EINTR)
+			continue;
+		if (errno != EAGAIN && errno != EWOULDBLOCK) {
+			diag_set(SystemError, "popen: can't splice to fd %d",
+				 fd);
+			return -1;
+		}
+		if (delay <= 0) {
+			diag_set(TimedOut);
+			return -1;
+		}
+		/*
+		 * EAGAIN means that either the pipe is empty or the
+		 * destination is full. Wait for the pipe unless it
+		 * has data already.
+		 */
+		struct pollfd pfd = {.fd = src_fd, .events = POLLIN};
+		if (poll(&pfd, 1, 0) > 0)
+			coio_wait(fd, COIO_WRITE, delay);
+		else
+			coio_wait(src_fd, COIO_READ, delay);
+		if (fiber_is_cancelled()) {
+			diag_set(FiberIsCancelled);
+			return -1;
+		}
+		coio_timeout_update(&start, &delay);
+	}
+#else
+	(void)fd;
+	diag_set(IllegalParams,
+		 "popen: splice is not supported on this platform");
+	return -1;
+#endif
 }
 
 /**
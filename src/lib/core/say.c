@@ -639,6 +639,7 @@ log_create(struct log *log, const char *init_str, int nonblock)
 	log->format_func = NULL;
 	log->level = S_INFO;
 	log->rotating_threads = 0;
+	log->async = NULL;
 	fiber_cond_create(&log->rotate_cond);
 	ev_async_init(&log->log_async, log_rotate_async_cb);
 	setvbuf(stderr, NULL, _IONBF, 0);
@@ -692,7 +693,7 @@ say_logger_initialized(void)
 }
 
 void
-say_logger_init(const char *init_str, int level, int nonblock,
+say_logger_init(const char *init_str, int level, int nonblock, int async,
 		const char *format, int background)
 {
 	/*
@@ -724,6 +725,10 @@ say_logger_init(const char *init_str, int level, int nonblock,
 	log_pid = log_default->pid;
 	say_set_log_format(say_format_by_name(format));
 
+	if (async &&
+	    log_async_enable(log_default, LOG_ASYNC_RING_SIZE_DEFAULT) != 0)
+		goto fail;
+
 	if (background) {
 		fflush(stderr);
 		fflush(stdout);
@@ -1030,7 +1035,7 @@ say_default(int level, const char *filename, int line, const char *error,
  * File and pipe logger
  */
 static void
-write_to_file(struct log *log, int total)
+write_to_file(struct log *log, const char *buf, int total)
 {
 	assert(log->type == SAY_LOGGER_FILE ||
 	       log->type == SAY_LOGGER_PIPE ||
@@ -1044,7 +1049,7 @@ write_to_file(struct log *log, int total)
  * Syslog logger
  */
 static void
-write_to_syslog(struct log *log, int total)
+write_to_syslog(struct log *log, const char *buf, int total)
 {
 	assert(log->type == SAY_LOGGER_SYSLOG);
 	assert(total >= 0);
@@ -1074,6 +1079,348 @@ write_to_syslog(struct log *log, int total)
 
 /** Loggers }}} */
 
+/** {{{ Asynchronous logging */
+
+enum {
+	/** Size of a slot of the log ring buffer. */
+	LOG_RING_SLOT_SIZE = 128,
+	/** Size of the buffer the logger thread writes from. */
+	LOG_ASYNC_BUF_SIZE = 64 * 1024,
+};
+
+/**
+ * A slot of the log ring buffer. A message takes as many
+ * consecutive slots as needed to fit it.
+ */
+struct log_ring_slot {
+	/**
+	 * Position of the slot in the ring plus one once the
+	 * producer has written it, so that the consumer can tell
+	 * a written slot from a reserved or a stale one.
+	 */
+	uint64_t seq;
+	/** Size of the message if it starts in this slot. */
+	uint32_t size;
+	/** Message data. */
+	char data[LOG_RING_SLOT_SIZE - 2 * sizeof(uint64_t)];
+};
+
+/**
+ * Ring buffer and logger thread of an asynchronous log.
+ *
+ * The ring is a multiple producer single consumer queue of slots.
+ * A producer reserves slots by advancing the head with a CAS, so
+ * producers never wait for each other, then writes the message
+ * and publishes each slot by setting its sequence number. The
+ * logger thread reads messages from the tail, writes them and
+ * advances the tail, which frees the slots for producers.
+ */
+struct log_async {
+	/** Ring slots, the count is a power of two. */
+	struct log_ring_slot *slots;
+	/** Number of slots minus one. */
+	uint64_t mask;
+	/** Position of the next slot to reserve. */
+	alignas(CACHELINE_SIZE) uint64_t head;
+	/** Number of messages dropped because the ring was full. */
+	uint64_t dropped;
+	/** Position of the next slot to read. */
+	alignas(CACHELINE_SIZE) uint64_t tail;
+	/** Number of dropped messages the consumer has reported. */
+	uint64_t dropped_reported;
+	/** Set to stop the logger thread. */
+	bool is_stopping;
+	/** Logger thread. */
+	struct cord cord;
+	/** Wakes up the logger thread when a message is pushed. */
+	struct ev_async wakeup;
+	/** Signalled when the logger thread is ready. */
+	pthread_mutex_t start_mutex;
+	pthread_cond_t start_cond;
+	bool is_started;
+	/** Buffer for writing many messages at once. */
+	char buf[LOG_ASYNC_BUF_SIZE];
+};
+
+/** Copy a formatted message to the ring, drop it if it's full. */
+static void
+log_async_push(struct log_async *async, const char *data, int size)
+{
+	if (size <= 0)
+		return;
+	const size_t slot_data_size = sizeof(async->slots[0].data);
+	uint64_t count = (size + slot_data_size - 1) / slot_data_size;
+	uint64_t head = pm_atomic_load_explicit(&async->head,
+						pm_memory_order_relaxed);
+	do {
+		uint64_t tail = pm_atomic_load_explicit(
+			&async->tail, pm_memory_order_acquire);
+		if (head + count - tail > async->mask + 1) {
+			pm_atomic_fetch_add_explicit(&async->dropped, 1,
+						     pm_memory_order_relaxed);
+			return;
+		}
+	} while (!pm_atomic_compare_exchange_weak_explicit(
+			&async->head, &head, head + count,
+			pm_memory_order_relaxed, pm_memory_order_relaxed));
+	for (uint64_t i = 0; i < count; i++) {
+		struct log_ring_slot *slot =
+			&async->slots[(head + i) & async->mask];
+		size_t len = MIN((size_t)size, slot_data_size);
+		slot->size = size;
+		memcpy(slot->data, data, len);
+		data += len;
+		size -= len;
+		pm_atomic_store_explicit(&slot->seq, head + i + 1,
+					 pm_memory_order_release);
+	}
+	ev_async_send(async->cord.loop, &async->wakeup);
+}
+
+/** Write a buffer to a file or pipe log, handling partial writes. */
+static void
+log_async_write(struct log *log, const char *data, size_t size)
+{
+	while (size > 0) {
+		ssize_t r = write(log->fd, data, size);
+		if (r < 0) {
+			if (errno == EINTR)
+				continue;
+			return;
+		}
+		data += r;
+		size -= r;
+	}
+}
+
+/** Format a message of the logger thread itself to its buffer. */
+static int
+log_async_format(struct log *log, char *data, int len, int level,
+		 const char *format, ...)
+{
+	va_list ap;
+	va_start(ap, format);
+	int total = log->format_func(log, data, len, level, __FILE__,
+				     __LINE__, NULL, format, ap);
+	va_end(ap);
+	return total;
+}
+
+/**
+ * Write the messages queued in the ring. Messages of a file or
+ * pipe log are written in batches, syslog needs one write per
+ * message.
+ */
+static void
+log_async_flush(struct log *log)
+{
+	struct log_async *async = log->async;
+	const size_t slot_data_size = sizeof(async->slots[0].data);
+	bool is_syslog = log->type == SAY_LOGGER_SYSLOG;
+	uint64_t tail = async->tail;
+	size_t used = 0;
+	while (true) {
+		struct log_ring_slot *slot = &async->slots[tail & async->mask];
+		if (pm_atomic_load_explicit(&slot->seq,
+					    pm_memory_order_acquire) != tail + 1)
+			break;
+		size_t size = slot->size;
+		uint64_t count = (size + slot_data_size - 1) / slot_data_size;
+		/*
+		 * The rest of the message may be still being written,
+		 * its producer wakes us up when it's done.
+		 */
+		bool is_ready = true;
+		for (uint64_t i = 1; i < count && is_ready; i++) {
+			slot = &async->slots[(tail + i) & async->mask];
+			is_ready = pm_atomic_load_explicit(
+				&slot->seq, pm_memory_order_acquire) ==
+				tail + i + 1;
+		}
+		if (!is_ready)
+			break;
+		assert(size <= sizeof(async->buf));
+		if (used + size > sizeof(async->buf)) {
+			log_async_write(log, async->buf, used);
+			used = 0;
+		}
+		for (uint64_t i = 0; i < count; i++) {
+			slot = &async->slots[(tail + i) & async->mask];
+			size_t len = MIN(size, slot_data_size);
+			memcpy(async->buf + used, slot->data, len);
+			used += len;
+			size -= len;
+		}
+		tail += count;
+		pm_atomic_store_explicit(&async->tail, tail,
+					 pm_memory_order_release);
+		if (is_syslog) {
+			write_to_syslog(log, async->buf, used);
+			used = 0;
+		}
+	}
+	if (used > 0)
+		log_async_write(log, async->buf, used);
+	uint64_t dropped = pm_atomic_load_explicit(&async->dropped,
+						   pm_memory_order_relaxed);
+	if (dropped != async->dropped_reported) {
+		int total = log_async_format(
+			log, async->buf, sizeof(async->buf), S_WARN,
+			"%llu log messages were dropped, the log ring "
+			"buffer is full",
+			(unsigned long long)(dropped - async->dropped_reported));
+		if (is_syslog)
+			write_to_syslog(log, async->buf, total);
+		else
+			log_async_write(log, async->buf, total);
+		async->dropped_reported = dropped;
+	}
+}
+
+static void
+log_async_wakeup_cb(struct ev_loop *loop, struct ev_async *watcher,
+		    int events)
+{
+	(void)events;
+	struct log *log = watcher->data;
+	log_async_flush(log);
+	if (pm_atomic_load(&log->async->is_stopping))
+		ev_break(loop, EVBREAK_ALL);
+}
+
+static void *
+log_async_f(void *arg)
+{
+	struct log *log = arg;
+	struct log_async *async = log->async;
+	ev_async_start(loop(), &async->wakeup);
+	tt_pthread_mutex_lock(&async->start_mutex);
+	async->is_started = true;
+	tt_pthread_cond_signal(&async->start_cond);
+	tt_pthread_mutex_unlock(&async->start_mutex);
+	ev_run(loop(), 0);
+	/* Write what was pushed after the last wakeup. */
+	log_async_flush(log);
+	ev_async_stop(loop(), &async->wakeup);
+	return NULL;
+}
+
+/**
+ * Start the logger thread. Producers may call ev_async_send() only
+ * after the watcher has been started in the logger thread, so wait
+ * for it before returning.
+ */
+static int
+log_async_start(struct log *log)
+{
+	struct log_async *async = log->async;
+	async->is_started = false;
+	async->is_stopping = false;
+	ev_async_init(&async->wakeup, log_async_wakeup_cb);
+	async->wakeup.data = log;
+	if (cord_start(&async->cord, "log", log_async_f, log) != 0)
+		return -1;
+	tt_pthread_mutex_lock(&async->start_mutex);
+	while (!async->is_started)
+		tt_pthread_cond_wait(&async->start_cond, &async->start_mutex);
+	tt_pthread_mutex_unlock(&async->start_mutex);
+	return 0;
+}
+
+int
+log_async_enable(struct log *log, size_t size)
+{
+	assert(log->async == NULL);
+	size_t slot_count = 1;
+	while (slot_count * LOG_RING_SLOT_SIZE < size)
+		slot_count *= 2;
+	/* A message of the maximal size must fit. */
+	while (slot_count * LOG_RING_SLOT_SIZE < 2 * SAY_BUF_LEN_MAX)
+		slot_count *= 2;
+	struct log_async *async = calloc(1, sizeof(*async));
+	if (async == NULL) {
+		diag_set(OutOfMemory, sizeof(*async), "calloc",
+			 "struct log_async");
+		return -1;
+	}
+	async->slots = calloc(slot_count, sizeof(async->slots[0]));
+	if (async->slots == NULL) {
+		diag_set(OutOfMemory, slot_count * sizeof(async->slots[0]),
+			 "calloc", "log ring");
+		free(async);
+		return -1;
+	}
+	async->mask = slot_count - 1;
+	tt_pthread_mutex_init(&async->start_mutex, NULL);
+	tt_pthread_cond_init(&async->start_cond, NULL);
+	/* Writes block the logger thread only. */
+	if (log->nonblock) {
+		int flags = fcntl(log->fd, F_GETFL, 0);
+		if (flags >= 0)
+			fcntl(log->fd, F_SETFL, flags & ~O_NONBLOCK);
+		log->nonblock = false;
+	}
+	log->async = async;
+	if (log_async_start(log) != 0) {
+		log->async = NULL;
+		tt_pthread_mutex_destroy(&async->start_mutex);
+		tt_pthread_cond_destroy(&async->start_cond);
+		free(async->slots);
+		free(async);
+		return -1;
+	}
+	return 0;
+}
+
+uint64_t
+log_async_dropped(struct log *log)
+{
+	if (log->async == NULL)
+		return 0;
+	return pm_atomic_load_explicit(&log->async->dropped,
+				       pm_memory_order_relaxed);
+}
+
+/** Stop the logger thread after writing all queued messages. */
+static void
+log_async_destroy(struct log *log)
+{
+	struct log_async *async = log->async;
+	pm_atomic_store(&async->is_stopping, true);
+	ev_async_send(async->cord.loop, &async->wakeup);
+	if (cord_join(&async->cord) != 0)
+		diag_log();
+	log->async = NULL;
+	tt_pthread_mutex_destroy(&async->start_mutex);
+	tt_pthread_cond_destroy(&async->start_cond);
+	free(async->slots);
+	free(async);
+}
+
+void
+say_logger_atfork(void)
+{
+	struct log_async *async = log_std.async;
+	if (async == NULL)
+		return;
+	/*
+	 * Only the forking thread survives fork(). The messages
+	 * left in the ring belong to the parent, which writes them.
+	 */
+	async->tail = async->head;
+	async->dropped_reported = async->dropped;
+	memset(&async->cord, 0, sizeof(async->cord));
+	tt_pthread_mutex_init(&async->start_mutex, NULL);
+	tt_pthread_cond_init(&async->start_cond, NULL);
+	if (log_async_start(&log_std) != 0) {
+		/* Fall back to synchronous writes. */
+		diag_log();
+		log_std.async = NULL;
+	}
+}
+
+/** Asynchronous logging }}} */
+
 /*
  * Init string parser(s)
  */
@@ -1221,6 +1568,8 @@ log_destroy(struct log *log)
 	assert(log != NULL);
 	while(log->rotating_threads > 0)
 		fiber_cond_wait(&log->rotate_cond);
+	if (log->async != NULL)
+		log_async_destroy(log);
 	pm_atomic_store(&log->type, SAY_LOGGER_BOOT);
 
 	if (log->fd != -1)
@@ -1242,14 +1591,19 @@ log_vsay(struct log *log, int level, const char *filename, int line,
 	}
 	int total = log->format_func(log, buf, sizeof(buf), level,
 				     filename, line, error, format, ap);
+	if (log->async != NULL && level != S_FATAL) {
+		log_async_push(log->async, buf, total);
+		errno = errsv;
+		return total;
+	}
 	switch (log->type) {
 	case SAY_LOGGER_FILE:
 	case SAY_LOGGER_PIPE:
 	case SAY_LOGGER_STDERR:
-		write_to_file(log, total);
+		write_to_file(log, buf, total);
 		break;
 	case SAY_LOGGER_SYSLOG:
-		write_to_syslog(log, total);
+		write_to_syslog(log, buf, total);
 		if (level == S_FATAL && log->fd != STDERR_FILENO)
 			(void) safe_write(STDERR_FILENO, buf, total);
 		break;
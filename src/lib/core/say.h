@@ -135,6 +135,7 @@ enum syslog_facility {
 };
 
 struct log;
+struct log_async;
 
 typedef int (*log_format_func_t)(struct log *log, char *buf, int len, int level,
 				 const char *filename, int line, const char *error,
@@ -175,6 +176,11 @@ struct log {
 	int rotating_threads;
 	enum syslog_facility syslog_facility;
 	struct rlist in_log_list;
+	/**
+	 * Logger thread and ring buffer if writes are asynchronous,
+	 * see log_async_enable(), NULL otherwise.
+	 */
+	struct log_async *async;
 };
 
 /**
@@ -191,6 +197,35 @@ log_create(struct log *log, const char *init_str, int nonblock);
 void
 log_destroy(struct log *log);
 
+enum {
+	/** Default size of the ring buffer of an asynchronous log. */
+	LOG_ASYNC_RING_SIZE_DEFAULT = 4 * 1024 * 1024,
+};
+
+/**
+ * Make writes to a log asynchronous. Messages are still formatted
+ * by the calling thread, but then they are copied to a lock-free
+ * ring buffer shared by all threads, and a logger thread writes
+ * them to the log. If the ring is full, a message is dropped and
+ * counted, the logger thread reports the number of dropped messages
+ * to the log. Fatal messages are written synchronously.
+ *
+ * Must be called before the log is used by other threads. The
+ * logger thread is stopped by log_destroy() after writing all
+ * queued messages.
+ *
+ * @param log	log object
+ * @param size	size of the ring buffer in bytes
+ * @return 0 on success, -1 on error, the error is saved in
+ * the diagnostics area
+ */
+int
+log_async_enable(struct log *log, size_t size);
+
+/** Number of messages dropped because the ring buffer was full. */
+uint64_t
+log_async_dropped(struct log *log);
+
 /** Perform log write. */
 int
 log_say(struct log *log, int level, const char *filename,
@@ -267,13 +302,24 @@ struct ev_signal;
 void
 say_logrotate(struct ev_loop *, struct ev_signal *, int /* revents */);
 
-/** Init default logger. */
+/**
+ * Init default logger.
+ * If async is set, writes are done by a logger thread, see
+ * log_async_enable(); nonblock is ignored then.
+ */
 void
 say_logger_init(const char *init_str,
-		int log_level, int nonblock,
+		int log_level, int nonblock, int async,
 		const char *log_format,
 		int background);
 
+/**
+ * Must be called in a child process after fork(). Restarts the
+ * logger thread of the default logger, which doesn't survive fork.
+ */
+void
+say_logger_atfork(void);
+
 /** Test if logger is initialized. */
 bool
 say_logger_initialized(void);
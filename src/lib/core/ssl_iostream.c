@@ -0,0 +1,337 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2021, Tarantool AUTHORS, please see AUTHORS file.
+ */
+
+#include "ssl_iostream.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <sys/uio.h>
+
+#include <openssl/err.h>
+#include <openssl/ssl.h>
+
+#include "diag.h"
+#include "sio.h"
+#include "trivia/util.h"
+#include "tt_static.h"
+#include "uri/uri.h"
+
+struct ssl_iostream_ctx {
+	SSL_CTX *ssl_ctx;
+	/** Reference counter, accessed atomically. */
+	int refs;
+};
+
+/** Stream context, see iostream::ctx. */
+struct ssl_iostream {
+	SSL *ssl;
+	/**
+	 * Set if the last SSL_write() returned SSL_ERROR_WANT_*.
+	 * OpenSSL requires it to be retried with the same data.
+	 */
+	bool is_write_pending;
+};
+
+/** Sets diag from the OpenSSL error queue and clears the queue. */
+static void
+diag_set_ssl_error(const char *what)
+{
+	unsigned long code = ERR_get_error();
+	if (code == 0) {
+		diag_set(CryptoError, "%s failed", what);
+	} else {
+		char buf[256];
+		ERR_error_string_n(code, buf, sizeof(buf));
+		diag_set(CryptoError, "%s: %s", what, buf);
+	}
+	ERR_clear_error();
+}
+
+struct ssl_iostream_ctx *
+ssl_iostream_ctx_new(enum iostream_mode mode, const struct uri *uri)
+{
+	assert(mode == IOSTREAM_SERVER || mode == IOSTREAM_CLIENT);
+	const char *key_file = uri_param(uri, "ssl_key_file", 0);
+	const char *cert_file = uri_param(uri, "ssl_cert_file", 0);
+	const char *ca_file = uri_param(uri, "ssl_ca_file", 0);
+	const char *ciphers = uri_param(uri, "ssl_ciphers", 0);
+	if (mode == IOSTREAM_SERVER && (key_file == NULL ||
+					cert_file == NULL)) {
+		diag_set(IllegalParams, "ssl_key_file and ssl_cert_file "
+			 "parameters are required for SSL server");
+		return NULL;
+	}
+	if ((key_file == NULL) != (cert_file == NULL)) {
+		diag_set(IllegalParams, "ssl_key_file and ssl_cert_file "
+			 "parameters must be set together");
+		return NULL;
+	}
+	ERR_clear_error();
+	SSL_CTX *ssl_ctx = SSL_CTX_new(mode == IOSTREAM_SERVER ?
+				       TLS_server_method() :
+				       TLS_client_method());
+	if (ssl_ctx == NULL) {
+		diag_set_ssl_error("SSL_CTX_new");
+		return NULL;
+	}
+	SSL_CTX_set_min_proto_version(ssl_ctx, TLS1_2_VERSION);
+	/* Let writes return after a record is sent, like write(2). */
+	SSL_CTX_set_mode(ssl_ctx, SSL_MODE_ENABLE_PARTIAL_WRITE |
+				  SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER);
+#ifdef SSL_OP_ENABLE_KTLS
+	SSL_CTX_set_options(ssl_ctx, SSL_OP_ENABLE_KTLS);
+#endif
+#ifdef SSL_OP_IGNORE_UNEXPECTED_EOF
+	/* Connections are closed without close_notify. */
+	SSL_CTX_set_options(ssl_ctx, SSL_OP_IGNORE_UNEXPECTED_EOF);
+#endif
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L
+	/*
+	 * Sessions aren't resumed, and with tickets the server
+	 * would have to write them after the handshake, which
+	 * doesn't let writes bypass OpenSSL with kernel TLS.
+	 */
+	if (mode == IOSTREAM_SERVER)
+		SSL_CTX_set_num_tickets(ssl_ctx, 0);
+#endif
+	if (cert_file != NULL &&
+	    SSL_CTX_use_certificate_chain_file(ssl_ctx, cert_file) != 1) {
+		diag_set_ssl_error(tt_sprintf("can't load ssl_cert_file '%s'",
+					      cert_file));
+		goto error;
+	}
+	if (key_file != NULL &&
+	    (SSL_CTX_use_PrivateKey_file(ssl_ctx, key_file,
+					 SSL_FILETYPE_PEM) != 1 ||
+	     SSL_CTX_check_private_key(ssl_ctx) != 1)) {
+		diag_set_ssl_error(tt_sprintf("can't load ssl_key_file '%s'",
+					      key_file));
+		goto error;
+	}
+	if (ca_file != NULL) {
+		if (SSL_CTX_load_verify_locations(ssl_ctx, ca_file,
+						  NULL) != 1) {
+			diag_set_ssl_error(tt_sprintf("can't load ssl_ca_file "
+						      "'%s'", ca_file));
+			goto error;
+		}
+		SSL_CTX_set_verify(ssl_ctx, SSL_VERIFY_PEER |
+				   SSL_VERIFY_FAIL_IF_NO_PEER_CERT, NULL);
+	}
+	if (ciphers != NULL &&
+	    SSL_CTX_set_cipher_list(ssl_ctx, ciphers) != 1) {
+		diag_set_ssl_error(tt_sprintf("invalid ssl_ciphers '%s'",
+					      ciphers));
+		goto error;
+	}
+	struct ssl_iostream_ctx *ctx = xmalloc(sizeof(*ctx));
+	ctx->ssl_ctx = ssl_ctx;
+	ctx->refs = 1;
+	return ctx;
+error:
+	SSL_CTX_free(ssl_ctx);
+	return NULL;
+}
+
+struct ssl_iostream_ctx *
+ssl_iostream_ctx_ref(struct ssl_iostream_ctx *ctx)
+{
+	__atomic_add_fetch(&ctx->refs, 1, __ATOMIC_RELAXED);
+	return ctx;
+}
+
+void
+ssl_iostream_ctx_unref(struct ssl_iostream_ctx *ctx)
+{
+	if (__atomic_sub_fetch(&ctx->refs, 1, __ATOMIC_ACQ_REL) > 0)
+		return;
+	SSL_CTX_free(ctx->ssl_ctx);
+	free(ctx);
+}
+
+static const struct iostream_vtab ssl_iostream_vtab;
+
+int
+ssl_iostream_create(struct iostream *io, int fd, enum iostream_mode mode,
+		    struct ssl_iostream_ctx *ctx)
+{
+	assert(fd >= 0);
+	ERR_clear_error();
+	SSL *ssl = SSL_new(ctx->ssl_ctx);
+	if (ssl == NULL) {
+		diag_set_ssl_error("SSL_new");
+		return -1;
+	}
+	if (SSL_set_fd(ssl, fd) != 1) {
+		diag_set_ssl_error("SSL_set_fd");
+		SSL_free(ssl);
+		return -1;
+	}
+	if (mode == IOSTREAM_SERVER)
+		SSL_set_accept_state(ssl);
+	else
+		SSL_set_connect_state(ssl);
+	struct ssl_iostream *stream = xmalloc(sizeof(*stream));
+	stream->ssl = ssl;
+	stream->is_write_pending = false;
+	io->vtab = &ssl_iostream_vtab;
+	io->ctx = stream;
+	io->fd = fd;
+	return 0;
+}
+
+static void
+ssl_iostream_delete_ctx(void *ctx)
+{
+	struct ssl_iostream *stream = ctx;
+	SSL_free(stream->ssl);
+	free(stream);
+}
+
+/**
+ * Converts a failed SSL_read() or SSL_write() return value to
+ * iostream_status or 0 on EOF.
+ */
+static ssize_t
+ssl_iostream_status(struct iostream *io, int ret, const char *what)
+{
+	struct ssl_iostream *stream = io->ctx;
+	int saved_errno = errno;
+	switch (SSL_get_error(stream->ssl, ret)) {
+	case SSL_ERROR_ZERO_RETURN:
+		return 0;
+	case SSL_ERROR_WANT_READ:
+		return IOSTREAM_WANT_READ;
+	case SSL_ERROR_WANT_WRITE:
+		return IOSTREAM_WANT_WRITE;
+	case SSL_ERROR_SYSCALL:
+		if (ERR_peek_error() == 0) {
+			/* OpenSSL < 3.0 reports EOF this way. */
+			if (saved_errno == 0)
+				return 0;
+			errno = saved_errno;
+			diag_set(SocketError, sio_socketname(io->fd), "%s",
+				 what);
+			return IOSTREAM_ERROR;
+		}
+		FALLTHROUGH;
+	default:
+		diag_set_ssl_error(what);
+		return IOSTREAM_ERROR;
+	}
+}
+
+static ssize_t
+ssl_iostream_read(struct iostream *io, void *buf, size_t count)
+{
+	assert(io->fd >= 0);
+	struct ssl_iostream *stream = io->ctx;
+	ERR_clear_error();
+	errno = 0;
+	int ret = SSL_read(stream->ssl, buf, MIN(count, (size_t)INT_MAX));
+	if (ret > 0)
+		return ret;
+	return ssl_iostream_status(io, ret, "SSL_read");
+}
+
+/**
+ * Returns true if records are encrypted by the kernel and there's
+ * nothing buffered in OpenSSL, so plain writes to the socket are
+ * sent as application data.
+ */
+static inline bool
+ssl_iostream_can_bypass_write(struct ssl_iostream *stream)
+{
+#ifdef BIO_get_ktls_send
+	return !stream->is_write_pending &&
+	       SSL_is_init_finished(stream->ssl) &&
+	       BIO_get_ktls_send(SSL_get_wbio(stream->ssl));
+#else
+	(void)stream;
+	return false;
+#endif
+}
+
+/** Converts the result of a write syscall to iostream_status. */
+static inline ssize_t
+ssl_iostream_sio_status(ssize_t ret)
+{
+	if (ret >= 0)
+		return ret;
+	if (sio_wouldblock(errno))
+		return IOSTREAM_WANT_WRITE;
+	return IOSTREAM_ERROR;
+}
+
+static ssize_t
+ssl_iostream_write(struct iostream *io, const void *buf, size_t count)
+{
+	assert(io->fd >= 0);
+	struct ssl_iostream *stream = io->ctx;
+	if (count == 0)
+		return 0;
+	if (ssl_iostream_can_bypass_write(stream))
+		return ssl_iostream_sio_status(sio_write(io->fd, buf, count));
+	ERR_clear_error();
+	errno = 0;
+	int ret = SSL_write(stream->ssl, buf, MIN(count, (size_t)INT_MAX));
+	if (ret > 0) {
+		stream->is_write_pending = false;
+		return ret;
+	}
+	ssize_t status = ssl_iostream_status(io, ret, "SSL_write");
+	if (status == 0) {
+		diag_set(SocketError, sio_socketname(io->fd), "SSL_write");
+		return IOSTREAM_ERROR;
+	}
+	if (status != IOSTREAM_ERROR)
+		stream->is_write_pending = true;
+	return status;
+}
+
+static ssize_t
+ssl_iostream_writev(struct iostream *io, const struct iovec *iov, int iovcnt)
+{
+	assert(io->fd >= 0);
+	struct ssl_iostream *stream = io->ctx;
+	if (ssl_iostream_can_bypass_write(stream)) {
+		return ssl_iostream_sio_status(
+			sio_writev(io->fd, iov, iovcnt));
+	}
+	/*
+	 * Without kernel TLS each buffer is encrypted into its own
+	 * records. Stop at the first incomplete write, the caller
+	 * retries from there.
+	 */
+	ssize_t total = 0;
+	for (int i = 0; i < iovcnt; i++) {
+		ssize_t ret = ssl_iostream_write(io, iov[i].iov_base,
+						 iov[i].iov_len);
+		if (ret < 0)
+			return total > 0 && ret != IOSTREAM_ERROR ? total : ret;
+		total += ret;
+		if ((size_t)ret < iov[i].iov_len)
+			break;
+	}
+	return total;
+}
+
+static size_t
+ssl_iostream_pending(struct iostream *io)
+{
+	struct ssl_iostream *stream = io->ctx;
+	return SSL_pending(stream->ssl);
+}
+
+static const struct iostream_vtab ssl_iostream_vtab = {
+	/* .delete_ctx = */ ssl_iostream_delete_ctx,
+	/* .read = */ ssl_iostream_read,
+	/* .write = */ ssl_iostream_write,
+	/* .writev = */ ssl_iostream_writev,
+	/* .pending = */ ssl_iostream_pending,
+};
@@ -0,0 +1,55 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright 2010-2021, Tarantool AUTHORS, please see AUTHORS file.
+ */
+
+#pragma once
+
+#include "iostream.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+struct ssl_iostream_ctx;
+struct uri;
+
+/**
+ * Creates an SSL context from the URI parameters:
+ *
+ *  - ssl_key_file, ssl_cert_file: PEM files with the private key
+ *    and the certificate chain of this side. Required for servers.
+ *  - ssl_ca_file: PEM file with trusted certificates. If set, the
+ *    peer must present a certificate signed by one of them.
+ *  - ssl_ciphers: colon-separated list of TLSv1.2 ciphers.
+ *
+ * Kernel TLS is enabled if OpenSSL and the kernel support it, so
+ * that after the handshake records are encrypted by the kernel.
+ *
+ * The context is reference counted and may be used in several
+ * threads. Returns NULL and sets diag on error.
+ */
+struct ssl_iostream_ctx *
+ssl_iostream_ctx_new(enum iostream_mode mode, const struct uri *uri);
+
+/** Takes a reference to a context and returns it. */
+struct ssl_iostream_ctx *
+ssl_iostream_ctx_ref(struct ssl_iostream_ctx *ctx);
+
+/** Releases a reference to a context. */
+void
+ssl_iostream_ctx_unref(struct ssl_iostream_ctx *ctx);
+
+/**
+ * Creates an SSL stream for the given file descriptor. The
+ * handshake is done by the first read or write. Returns -1 and
+ * sets diag on error.
+ */
+int
+ssl_iostream_create(struct iostream *io, int fd, enum iostream_mode mode,
+		    struct ssl_iostream_ctx *ctx);
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
@@ -117,6 +117,56 @@ csv_setopt(struct csv *csv, int opt, ...)
 	va_end(args);
 }
 
+/**
+ * Append @a size bytes to the field buffer, growing it if needed.
+ * The buffer must be allocated already.
+ */
+static int
+csv_buf_append(struct csv *csv, const char *data, size_t size)
+{
+	assert(csv->buf != NULL && csv->bufp != NULL);
+	size_t used = csv->bufp - csv->buf;
+	if (csv->buf_len < used + size + 1) {
+		size_t new_size = csv->buf_len;
+		while (new_size < used + size + 1)
+			new_size *= 2;
+		char *new_buf = (char *)csv->realloc(csv->buf, new_size);
+		if (new_buf == NULL) {
+			csv->error_status = CSV_ER_MEMORY_ERROR;
+			return -1;
+		}
+		csv->buf_len = new_size;
+		csv->buf = new_buf;
+		csv->bufp = new_buf + used;
+	}
+	memcpy(csv->bufp, data, size);
+	csv->bufp += size;
+	return 0;
+}
+
+/**
+ * Return the end of the run of characters starting at @a p that
+ * the parser copies to the field as is in the current state: all
+ * but the quote inside quotes, and all but the quote, the delimiter,
+ * line ends and spaces outside quotes.
+ */
+static const char *
+csv_skip_plain(struct csv *csv, const char *p, const char *end)
+{
+	if (csv->state == CSV_IN_QUOTES) {
+		const char *q = memchr(p, csv->quote_char, end - p);
+		return q != NULL ? q : end;
+	}
+	assert(csv->state == CSV_OUT_OF_QUOTES);
+	for (; p != end; p++) {
+		char c = *p;
+		if (c == csv->delimiter || c == csv->quote_char ||
+		    c == '\n' || c == '\r' || c == ' ')
+			break;
+	}
+	return p;
+}
+
 /**
   * both of methods (emitting and iterating) are implementing by one function
   * firstonly == true means iteration method.
@@ -131,6 +181,23 @@ csv_parse_impl(struct csv *csv, const char *s, const char *end, bool firstonly)
 	assert(csv->emit_field);
 	assert(csv->emit_row);
 	for (const char *p = s; p != end; p++) {
+		/*
+		 * Copy a run of plain characters of a field at once
+		 * instead of passing each one through the state machine.
+		 */
+		if ((csv->state == CSV_IN_QUOTES ||
+		     csv->state == CSV_OUT_OF_QUOTES) && csv->bufp != NULL) {
+			const char *q = csv_skip_plain(csv, p, end);
+			if (q != p) {
+				if (csv_buf_append(csv, p, q - p) != 0)
+					return NULL;
+				csv->prev_symbol = q[-1];
+				csv->ending_spaces = 0;
+				p = q;
+				if (p == end)
+					break;
+			}
+		}
 		bool is_line_end = (*p == '\n' || *p == '\r');
 		/* realloc buffer */
 		if (csv->buf == NULL ||
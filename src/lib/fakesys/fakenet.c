@@ -325,6 +325,10 @@ fakenet_recvfrom(int fd, void *buffer, size_t size, struct sockaddr *addr,
 	 */
 	struct fakenet_fd *dst = &fakenet_fd[fd - FAKE_FD_BASE];
 	assert(dst->is_opened);
+	if (rlist_empty(&dst->recv_queue)) {
+		errno = EAGAIN;
+		return -1;
+	}
 	struct fakenet_packet *p =
 		rlist_shift_entry(&dst->recv_queue, struct fakenet_packet,
 				  in_queue);
@@ -34,6 +34,8 @@
 #include "fiber.h"
 #include "tt_static.h"
 
+#include <stdlib.h>
+
 /**
  * Maximal random deviation of the election timeout. From the configured value.
  */
@@ -156,6 +158,18 @@ raft_can_vote_for(const struct raft *raft, const struct vclock *v)
 static void
 raft_schedule_broadcast(struct raft *raft);
 
+/**
+ * Check if the node has heard from the leader less than death timeout ago and
+ * must not let other candidates in to keep the leader lease valid.
+ */
+static inline bool
+raft_is_lease_protected(const struct raft *raft)
+{
+	return raft->is_lease_enabled && raft->state == RAFT_STATE_FOLLOWER &&
+	       raft_ev_monotonic_now(raft_loop()) <
+	       raft->leader_last_seen + raft->death_timeout;
+}
+
 /** Raft state machine methods. 'sm' stands for State Machine. */
 
 /**
@@ -327,6 +341,19 @@ raft_process_msg(struct raft *raft, const struct raft_msg *req, uint32_t source)
 		return 0;
 	}
 
+	/*
+	 * The leader may hold a lease relying on this node not voting for
+	 * anybody else for a while. A new term can only be started by a leader
+	 * then, and the current leader can always resign.
+	 */
+	if (req->state != RAFT_STATE_LEADER && source != raft->leader &&
+	    (req->term > raft->volatile_term ||
+	     req->state == RAFT_STATE_CANDIDATE) &&
+	    raft_is_lease_protected(raft)) {
+		say_info("RAFT: the message is ignored - the leader lease is "
+			 "active");
+		return 0;
+	}
 	/* Term bump. */
 	if (req->term > raft->volatile_term)
 		raft_sm_schedule_new_term(raft, req->term);
@@ -420,6 +447,8 @@ raft_process_msg(struct raft *raft, const struct raft_msg *req, uint32_t source)
 			 * it manually.
 			 */
 			raft->leader = 0;
+			/* The lease is given up with the leadership. */
+			raft->leader_last_seen = 0;
 			if (raft->is_candidate)
 				raft_sm_schedule_new_election(raft);
 		}
@@ -454,6 +483,8 @@ raft_process_heartbeat(struct raft *raft, uint32_t source)
 	 */
 	if (source == 0)
 		return;
+	if (source == raft->leader && raft->state == RAFT_STATE_FOLLOWER)
+		raft->leader_last_seen = raft_ev_monotonic_now(raft_loop());
 	/*
 	 * When not a candidate - don't wait for anything. Therefore do not care
 	 * about the leader being dead.
@@ -612,6 +643,9 @@ raft_sm_become_leader(struct raft *raft)
 	assert(!raft->is_write_in_progress);
 	raft->state = RAFT_STATE_LEADER;
 	raft->leader = raft->self;
+	/* Acks given to this leader in the past don't hold anymore. */
+	raft->leader_since = raft_ev_monotonic_now(raft_loop());
+	memset(raft->lease_acks, 0, sizeof(raft->lease_acks));
 	raft_ev_timer_stop(raft_loop(), &raft->timer);
 	/* State is visible and it is changed - broadcast. */
 	raft_schedule_broadcast(raft);
@@ -625,6 +659,7 @@ raft_sm_follow_leader(struct raft *raft, uint32_t leader)
 	assert(raft->leader == 0);
 	raft->state = RAFT_STATE_FOLLOWER;
 	raft->leader = leader;
+	raft->leader_last_seen = raft_ev_monotonic_now(raft_loop());
 	if (!raft->is_write_in_progress && raft->is_candidate) {
 		raft_ev_timer_stop(raft_loop(), &raft->timer);
 		raft_sm_wait_leader_dead(raft);
@@ -764,6 +799,12 @@ raft_sm_start(struct raft *raft)
 	assert(raft->state == RAFT_STATE_FOLLOWER);
 	raft->is_enabled = true;
 	raft->is_candidate = raft->is_cfg_candidate;
+	/*
+	 * The node could have been following a leader holding a lease before
+	 * a restart, so it must not vote for anybody else for a while.
+	 */
+	if (raft->is_lease_enabled)
+		raft->leader_last_seen = raft_ev_monotonic_now(raft_loop());
 	if (raft->is_write_in_progress) {
 		/*
 		 * Nop. If write is in progress, the state machine is frozen. It
@@ -977,6 +1018,78 @@ raft_cfg_death_timeout(struct raft *raft, double death_timeout)
 	}
 }
 
+void
+raft_cfg_is_lease_enabled(struct raft *raft, bool is_lease_enabled)
+{
+	if (is_lease_enabled == raft->is_lease_enabled)
+		return;
+	raft->is_lease_enabled = is_lease_enabled;
+	/*
+	 * The node may have voted for another candidate recently, so it
+	 * mustn't give a lease to anybody right away.
+	 */
+	if (is_lease_enabled)
+		raft->leader_last_seen = raft_ev_monotonic_now(raft_loop());
+	memset(raft->lease_acks, 0, sizeof(raft->lease_acks));
+}
+
+void
+raft_process_lease_ack(struct raft *raft, uint32_t source, double sent)
+{
+	assert(source < VCLOCK_MAX);
+	if (raft->state != RAFT_STATE_LEADER || source == raft->self)
+		return;
+	/* The message was sent before this node became the leader. */
+	if (sent < raft->leader_since)
+		return;
+	if (sent > raft->lease_acks[source])
+		raft->lease_acks[source] = sent;
+}
+
+static int
+raft_lease_ack_cmp(const void *a, const void *b)
+{
+	double l = *(const double *)a;
+	double r = *(const double *)b;
+	return l < r ? 1 : l > r ? -1 : 0;
+}
+
+double
+raft_lease_deadline(const struct raft *raft)
+{
+	if (!raft->is_lease_enabled || raft->state != RAFT_STATE_LEADER)
+		return 0;
+	/*
+	 * The leader counts itself. If it's enough for a quorum, anybody can
+	 * be elected alone, and there's no lease.
+	 */
+	int count = raft->election_quorum - 1;
+	if (count <= 0)
+		return 0;
+	double acks[VCLOCK_MAX];
+	int ack_count = 0;
+	for (int i = 0; i < VCLOCK_MAX; i++) {
+		if (raft->lease_acks[i] > 0)
+			acks[ack_count++] = raft->lease_acks[i];
+	}
+	if (ack_count < count)
+		return 0;
+	qsort(acks, ack_count, sizeof(acks[0]), raft_lease_ack_cmp);
+	/*
+	 * Each of the quorum nodes heard from the leader after acks[count - 1]
+	 * and won't let other candidates in for death timeout by its clock.
+	 * Any other quorum intersects with this one.
+	 */
+	return acks[count - 1] + raft->death_timeout *
+	       (100 - RAFT_LEASE_MAX_CLOCK_DRIFT_PCT) / 100;
+}
+
+bool
+raft_has_lease(const struct raft *raft)
+{
+	return raft_ev_monotonic_now(raft_loop()) < raft_lease_deadline(raft);
+}
+
 void
 raft_cfg_instance_id(struct raft *raft, uint32_t instance_id)
 {
@@ -138,6 +138,15 @@ struct raft_vtab {
 	raft_schedule_async_f schedule_async;
 };
 
+enum {
+	/**
+	 * Max relative clock rate difference between nodes tolerated by the
+	 * leader lease. The lease ends earlier than the followers' death
+	 * timeout by this fraction of it.
+	 */
+	RAFT_LEASE_MAX_CLOCK_DRIFT_PCT = 10,
+};
+
 struct raft {
 	/** Instance ID of this node. */
 	uint32_t self;
@@ -216,6 +225,28 @@ struct raft {
 	 * elections can be started.
 	 */
 	double death_timeout;
+	/**
+	 * Flag whether the leader lease is enabled. When it is, a node which
+	 * has heard from the leader less than death timeout ago doesn't let
+	 * other candidates start a new term. So as long as a quorum has heard
+	 * from the leader recently, no other leader can be elected, and the
+	 * leader may serve linearizable reads without a quorum round trip.
+	 */
+	bool is_lease_enabled;
+	/**
+	 * Time when the leader was last heard from. Also set when the lease is
+	 * enabled or Raft is started, because the node doesn't know whether it
+	 * took part in a lease before.
+	 */
+	double leader_last_seen;
+	/** Time when this instance became the leader. */
+	double leader_since;
+	/**
+	 * Lease acknowledgements of the other nodes, indexed by instance ID.
+	 * Each one is the time when this leader sent a message which the node
+	 * received while following this leader.
+	 */
+	double lease_acks[VCLOCK_MAX];
 	/** Virtual table to perform application-specific actions. */
 	const struct raft_vtab *vtab;
 	/**
@@ -263,6 +294,29 @@ raft_process_async(struct raft *raft);
 void
 raft_process_heartbeat(struct raft *raft, uint32_t source);
 
+/**
+ * Process a lease acknowledgement from an instance with the given ID: the node
+ * has received a message sent by this leader at @a sent time, according to the
+ * Raft event loop clock, while following this leader.
+ */
+void
+raft_process_lease_ack(struct raft *raft, uint32_t source, double sent);
+
+/**
+ * Return the time until which the leader lease is valid or 0 if this instance
+ * is not a leader holding a lease.
+ */
+double
+raft_lease_deadline(const struct raft *raft);
+
+/** Check if this instance is the leader and its lease hasn't expired yet. */
+bool
+raft_has_lease(const struct raft *raft);
+
+/** Configure whether the leader lease is enabled. */
+void
+raft_cfg_is_lease_enabled(struct raft *raft, bool is_lease_enabled);
+
 /** Configure whether Raft is enabled. */
 void
 raft_cfg_is_enabled(struct raft *raft, bool is_enabled);
@@ -120,6 +120,16 @@ bloom_add(struct bloom *bloom, bloom_hash_t hash);
 static bool
 bloom_maybe_has(const struct bloom *bloom, bloom_hash_t hash);
 
+/**
+ * Prefetch the block that bloom_maybe_has() checks for the given
+ * hash, so that the check doesn't stall on a cache miss if there
+ * is some other work to do before it.
+ * @param bloom - the bloom filter
+ * @param hash - hash of the value
+ */
+static void
+bloom_prefetch(const struct bloom *bloom, bloom_hash_t hash);
+
 /**
  * Return the expected false positive rate of a bloom filter.
  * @param bloom - the bloom filter
@@ -204,6 +214,12 @@ bloom_maybe_has(const struct bloom *bloom, bloom_hash_t hash)
 	return true;
 }
 
+static inline void
+bloom_prefetch(const struct bloom *bloom, bloom_hash_t hash)
+{
+	__builtin_prefetch(bloom->table + hash % bloom->table_size, 0);
+}
+
 /* }}} API definition */
 
 #if defined(__cplusplus)
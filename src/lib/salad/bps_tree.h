@@ -137,6 +137,7 @@
  * void bps_tree_destroy(tree);
  * int bps_tree_build(tree, sorted_array, array_size);
  * bps_tree_elem_t *bps_tree_find(tree, key);
+ * void bps_tree_find_batch(tree, keys, count, results);
  * int bps_tree_insert(tree, new_elem, replaced_elem, before_elem);
  * int bps_tree_insert_get_iterator(tree, new_elem, replaced_elem,
  * 				    inserted_iterator)
@@ -163,6 +164,10 @@
  * bool bps_tree_iterator_prev(tree, itr);
  * void bps_tree_iterator_freeze(tree, itr);
  * void bps_tree_iterator_destroy(tree, itr);
+ * // order statistics (only with BPS_INNER_CARD):
+ * size_t bps_tree_lower_bound_offset(tree, key, exact);
+ * size_t bps_tree_upper_bound_offset(tree, key, exact);
+ * struct bps_tree_iterator bps_tree_iterator_at(tree, offset);
  */
 /* }}} */
 
@@ -302,6 +307,18 @@
  * #define BPS_BLOCK_LINEAR_SEARCH
  */
 
+/**
+ * A switch that makes the tree an order-statistic tree. Every inner
+ * block stores the number of elements (cardinality) of each child
+ * subtree, that allows to find the offset of a key and an element
+ * by its offset in logarithmic time (see bps_tree_lower_bound_offset,
+ * bps_tree_upper_bound_offset and bps_tree_iterator_at).
+ * The price is a lower fanout of inner blocks and additional work
+ * on insertion and deletion to update the cardinalities along the
+ * path. To turn it on,
+ * #define BPS_INNER_CARD
+ */
+
 /**
  * A switch that enables collection of executions of different
  * branches of code. Used only for debug purposes, I hope you
@@ -372,6 +389,7 @@ typedef uint32_t bps_tree_block_id_t;
 #define bps_tree_build _api_name(build)
 #define bps_tree_destroy _api_name(destroy)
 #define bps_tree_find _api_name(find)
+#define bps_tree_find_batch _api_name(find_batch)
 #define bps_tree_insert _api_name(insert)
 #define bps_tree_insert_get_iterator _api_name(insert_get_iterator)
 #define bps_tree_delete _api_name(delete)
@@ -389,6 +407,9 @@ typedef uint32_t bps_tree_block_id_t;
 #define bps_tree_lower_bound_elem _api_name(lower_bound_elem)
 #define bps_tree_upper_bound_elem _api_name(upper_bound_elem)
 #define bps_tree_approximate_count _api_name(approximate_count)
+#define bps_tree_lower_bound_offset _api_name(lower_bound_offset)
+#define bps_tree_upper_bound_offset _api_name(upper_bound_offset)
+#define bps_tree_iterator_at _api_name(iterator_at)
 #define bps_tree_iterator_get_elem _api_name(iterator_get_elem)
 #define bps_tree_iterator_next _api_name(iterator_next)
 #define bps_tree_iterator_prev _api_name(iterator_prev)
@@ -412,6 +433,12 @@ typedef uint32_t bps_tree_block_id_t;
 #define bps_tree_restore_block_ver _bps_tree(restore_block_ver)
 #define bps_tree_root _bps_tree(root)
 #define bps_tree_touch_block _bps_tree(touch_block)
+#define bps_tree_block_card _bps_tree(block_card)
+#define bps_tree_build_cards _bps_tree(build_cards)
+#define bps_tree_add_path_card _bps_tree(add_path_card)
+#define bps_tree_sum_cards _bps_tree(sum_cards)
+#define bps_tree_move_children _bps_tree(move_children)
+#define bps_tree_set_child _bps_tree(set_child)
 #define bps_tree_find_ins_point_key _bps_tree(find_ins_point_key)
 #define bps_tree_find_ins_point_elem _bps_tree(find_ins_point_elem)
 #define bps_tree_find_after_ins_point_key _bps_tree(find_after_ins_point_key)
@@ -534,6 +561,15 @@ struct bps_tree {
 	bps_tree_elem_t max_elem;
 	/* Special allocator of blocks and their IDs */
 	struct matras matras;
+#ifdef BPS_INNER_CARD
+	/*
+	 * Cardinality of blocks that have no slot in a parent: the
+	 * root and new blocks that are not linked to the parent yet.
+	 * The value is meaningless, it's only updated along with the
+	 * cardinalities of other blocks to avoid special cases.
+	 */
+	size_t orphan_card;
+#endif
 #ifdef BPS_TREE_DEBUG_BRANCH_VISIT
 	/* Bit masks of different branches visits */
 	uint32_t debug_insert_leaf_branches_mask;
@@ -623,6 +659,21 @@ bps_tree_destroy(struct bps_tree *tree);
 static inline bps_tree_elem_t *
 bps_tree_find(const struct bps_tree *tree, bps_tree_key_t key);
 
+/**
+ * @brief Find the first element that is equal to each of the keys.
+ * Same as calling bps_tree_find() for each key, but descends the tree
+ * for several keys at once level by level and prefetches the blocks
+ * of the next level, so that cache misses for different keys overlap.
+ * @param tree - pointer to a tree
+ * @param keys - array of keys that will be compared with elements
+ * @param count - number of keys
+ * @param results - array of count pointers that receive the first
+ *  equal element or NULL if not found for each key
+ */
+static inline void
+bps_tree_find_batch(const struct bps_tree *tree, const bps_tree_key_t *keys,
+		    size_t count, bps_tree_elem_t **results);
+
 /**
  * @brief Insert an element to the tree or replace an element in the tree
  * In case of replacing, if 'replaced' argument is not null,
@@ -806,6 +857,51 @@ bps_tree_upper_bound_elem(const struct bps_tree *tree, bps_tree_elem_t key,
 static inline size_t
 bps_tree_approximate_count(const struct bps_tree *tree, bps_tree_key_t key);
 
+#ifdef BPS_INNER_CARD
+
+/**
+ * @brief Get the number of elements that are less than the key,
+ * i.e. the offset of the lower bound of the key.
+ * @param tree - pointer to a tree
+ * @param key - key that will be compared with elements
+ * @param exact - pointer to a bool value, that will be set to true if
+ *  an element equal to the key is found, false otherwise.
+ *  Pass NULL if you don't need that info.
+ * @return - offset of the lower bound, tree size if all elements
+ *  are less than the key.
+ */
+static inline size_t
+bps_tree_lower_bound_offset(const struct bps_tree *tree, bps_tree_key_t key,
+			    bool *exact);
+
+/**
+ * @brief Get the number of elements that are less than or equal
+ * to the key, i.e. the offset of the upper bound of the key.
+ * @param tree - pointer to a tree
+ * @param key - key that will be compared with elements
+ * @param exact - pointer to a bool value, that will be set to true if
+ *  an element equal to the key is found, false otherwise.
+ *  Pass NULL if you don't need that info.
+ * @return - offset of the upper bound, tree size if all elements
+ *  are less than or equal to the key.
+ */
+static inline size_t
+bps_tree_upper_bound_offset(const struct bps_tree *tree, bps_tree_key_t key,
+			    bool *exact);
+
+/**
+ * @brief Get an iterator to the element with the given offset,
+ * i.e. to the element that has exactly offset elements before it.
+ * @param tree - pointer to a tree
+ * @param offset - offset of the element
+ * @return - Iterator to the element. Invalid if the offset is not
+ *  less than the tree size.
+ */
+static inline struct bps_tree_iterator
+bps_tree_iterator_at(const struct bps_tree *tree, size_t offset);
+
+#endif /* BPS_INNER_CARD */
+
 /**
  * @brief Get a pointer to the element pointed by iterator.
  *  If iterator is detected as broken, it is invalidated and NULL returned.
@@ -911,6 +1007,13 @@ bps_tree_debug_check_internal_functions(bool assertme);
 #define BPS_TREE_DATAMOVE(dst, src, num, dst_bck, src_bck) \
 	BPS_TREE_MEMMOVE(dst, src, (num) * sizeof((dst)[0]), dst_bck, src_bck)
 
+/* Zero initializer of path element structures */
+#ifdef BPS_INNER_CARD
+#define BPS_TREE_PATH_ELEM_INITIALIZER {0, 0, 0, 0, 0, 0, 0, 0, 0}
+#else
+#define BPS_TREE_PATH_ELEM_INITIALIZER {0, 0, 0, 0, 0, 0, 0, 0}
+#endif
+
 /**
  * Types of a block
  */
@@ -938,9 +1041,18 @@ enum bps_tree_max_sizes {
 		(BPS_TREE_BLOCK_SIZE - sizeof(struct bps_block)
 		 - 2 * sizeof(bps_tree_block_id_t) )
 		/ sizeof(bps_tree_elem_t),
+#ifdef BPS_INNER_CARD
+	/* Reserve sizeof(size_t) for alignment of child_cards. */
+	BPS_TREE_MAX_COUNT_IN_INNER =
+		(BPS_TREE_BLOCK_SIZE - sizeof(struct bps_block)
+		 - sizeof(size_t))
+		/ (sizeof(bps_tree_elem_t) + sizeof(bps_tree_block_id_t)
+		   + sizeof(size_t)),
+#else
 	BPS_TREE_MAX_COUNT_IN_INNER =
 		(BPS_TREE_BLOCK_SIZE - sizeof(struct bps_block))
 		/ (sizeof(bps_tree_elem_t) + sizeof(bps_tree_block_id_t)),
+#endif
 	BPS_TREE_MAX_DEPTH = 16
 };
 
@@ -978,6 +1090,8 @@ CT_ASSERT_G(sizeof(struct bps_leaf) <= BPS_TREE_BLOCK_SIZE);
  * last child subtree does not have corresponding element copy in
  * this array (but it has a copy of maximal element somewhere in
  * parent's arrays on in tree struct)
+ * With BPS_INNER_CARD it also contains the number of elements
+ * in each child subtree.
  */
 struct bps_inner {
 	/* Block header */
@@ -986,6 +1100,10 @@ struct bps_inner {
 	bps_tree_elem_t elems[BPS_TREE_MAX_COUNT_IN_INNER - 1];
 	/* Corresponding child IDs */
 	bps_tree_block_id_t child_ids[BPS_TREE_MAX_COUNT_IN_INNER];
+#ifdef BPS_INNER_CARD
+	/* Numbers of elements in the corresponding child subtrees */
+	size_t child_cards[BPS_TREE_MAX_COUNT_IN_INNER];
+#endif
 };
 
 /**
@@ -1035,6 +1153,10 @@ struct bps_inner_path_elem {
 	bps_tree_block_id_t max_elem_block_id;
 	/* Holder of max_elem_copy (pos) */
 	bps_tree_pos_t max_elem_pos;
+#ifdef BPS_INNER_CARD
+	/* Pointer to the number of elements in the subtree */
+	size_t *card;
+#endif
 };
 
 /**
@@ -1059,6 +1181,10 @@ struct bps_leaf_path_elem {
 	bps_tree_block_id_t max_elem_block_id;
 	/* Holder of max_elem_copy (pos) */
 	bps_tree_pos_t max_elem_pos;
+#ifdef BPS_INNER_CARD
+	/* Pointer to the number of elements in the subtree */
+	size_t *card;
+#endif
 };
 
 /**
@@ -1088,6 +1214,9 @@ bps_tree_create(struct bps_tree *tree, bps_tree_arg_t arg,
 	tree->garbage_head_id = (bps_tree_block_id_t)(-1);
 	tree->arg = arg;
 	memset(&tree->max_elem, 0, sizeof(tree->max_elem));
+#ifdef BPS_INNER_CARD
+	tree->orphan_card = 0;
+#endif
 
 	matras_create(&tree->matras,
 		      BPS_TREE_EXTENT_SIZE, BPS_TREE_BLOCK_SIZE,
@@ -1107,6 +1236,32 @@ bps_tree_create(struct bps_tree *tree, bps_tree_arg_t arg,
 #endif
 }
 
+#ifdef BPS_INNER_CARD
+/**
+ * @brief Fill cardinalities of children of inner blocks in a subtree
+ *  that is made by bps_tree_build.
+ * @param tree - pointer to a tree
+ * @param id - ID of the root block of the subtree
+ * @return number of elements in the subtree
+ */
+static inline size_t
+bps_tree_build_cards(struct bps_tree *tree, bps_tree_block_id_t id)
+{
+	struct bps_block *block =
+		(struct bps_block *)matras_get(&tree->matras, id);
+	if (block->type == BPS_TREE_BT_LEAF)
+		return block->size;
+	struct bps_inner *inner = (struct bps_inner *)block;
+	size_t card = 0;
+	for (bps_tree_pos_t i = 0; i < block->size; i++) {
+		inner->child_cards[i] =
+			bps_tree_build_cards(tree, inner->child_ids[i]);
+		card += inner->child_cards[i];
+	}
+	return card;
+}
+#endif
+
 /**
  * @brief Fills a new (asserted) tree with values from sorted array.
  *  Elements are copied from the array. Array is not checked to be sorted!
@@ -1246,6 +1401,9 @@ bps_tree_build(struct bps_tree *tree, bps_tree_elem_t *sorted_array,
 	} else {
 		tree->root_id = root_if_inner_id;
 	}
+#ifdef BPS_INNER_CARD
+	bps_tree_build_cards(tree, tree->root_id);
+#endif
 	return 0;
 }
 
@@ -1321,6 +1479,34 @@ bps_tree_touch_block(struct bps_tree *tree, bps_tree_block_id_t id)
 	return (struct bps_block *)matras_touch(&tree->matras, id);
 }
 
+#ifdef BPS_INNER_CARD
+/**
+ * @brief Get the sum of cardinalities of a number of children
+ *  of an inner block.
+ */
+static inline size_t
+bps_tree_sum_cards(const struct bps_inner *inner, bps_tree_pos_t pos,
+		   bps_tree_pos_t num)
+{
+	size_t card = 0;
+	for (bps_tree_pos_t i = pos; i < pos + num; i++)
+		card += inner->child_cards[i];
+	return card;
+}
+
+/**
+ * @brief Get the number of elements in a subtree by ID of its root.
+ */
+static inline size_t
+bps_tree_block_card(const struct bps_tree *tree, bps_tree_block_id_t id)
+{
+	struct bps_block *block = bps_tree_restore_block(tree, id);
+	if (block->type == BPS_TREE_BT_LEAF)
+		return block->size;
+	return bps_tree_sum_cards((struct bps_inner *)block, 0, block->size);
+}
+#endif
+
 /**
  * @brief Get a random element in a tree.
  * @param tree - pointer to a tree
@@ -1974,6 +2160,130 @@ bps_tree_approximate_count(const struct bps_tree *tree, bps_tree_key_t key)
 	return result;
 }
 
+#ifdef BPS_INNER_CARD
+
+/**
+ * @brief Get the number of elements that are less than the key,
+ * i.e. the offset of the lower bound of the key.
+ * @param tree - pointer to a tree
+ * @param key - key that will be compared with elements
+ * @param exact - pointer to a bool value, that will be set to true if
+ *  an element equal to the key is found, false otherwise.
+ *  Pass NULL if you don't need that info.
+ * @return - offset of the lower bound, tree size if all elements
+ *  are less than the key.
+ */
+static inline size_t
+bps_tree_lower_bound_offset(const struct bps_tree *tree, bps_tree_key_t key,
+			    bool *exact)
+{
+	bool local_result;
+	if (!exact)
+		exact = &local_result;
+	*exact = false;
+	if (tree->root_id == (bps_tree_block_id_t)(-1))
+		return 0;
+	size_t offset = 0;
+	struct bps_block *block = bps_tree_root(tree);
+	for (bps_tree_block_id_t i = 0; i < tree->depth - 1; i++) {
+		struct bps_inner *inner = (struct bps_inner *)block;
+		bps_tree_pos_t pos;
+		pos = bps_tree_find_ins_point_key(tree, inner->elems,
+						  inner->header.size - 1,
+						  key, exact);
+		for (bps_tree_pos_t j = 0; j < pos; j++)
+			offset += inner->child_cards[j];
+		block = bps_tree_restore_block(tree, inner->child_ids[pos]);
+	}
+
+	struct bps_leaf *leaf = (struct bps_leaf *)block;
+	offset += bps_tree_find_ins_point_key(tree, leaf->elems,
+					      leaf->header.size, key, exact);
+	return offset;
+}
+
+/**
+ * @brief Get the number of elements that are less than or equal
+ * to the key, i.e. the offset of the upper bound of the key.
+ * @param tree - pointer to a tree
+ * @param key - key that will be compared with elements
+ * @param exact - pointer to a bool value, that will be set to true if
+ *  an element equal to the key is found, false otherwise.
+ *  Pass NULL if you don't need that info.
+ * @return - offset of the upper bound, tree size if all elements
+ *  are less than or equal to the key.
+ */
+static inline size_t
+bps_tree_upper_bound_offset(const struct bps_tree *tree, bps_tree_key_t key,
+			    bool *exact)
+{
+	bool local_result;
+	if (!exact)
+		exact = &local_result;
+	*exact = false;
+	bool exact_test;
+	if (tree->root_id == (bps_tree_block_id_t)(-1))
+		return 0;
+	size_t offset = 0;
+	struct bps_block *block = bps_tree_root(tree);
+	for (bps_tree_block_id_t i = 0; i < tree->depth - 1; i++) {
+		struct bps_inner *inner = (struct bps_inner *)block;
+		bps_tree_pos_t pos;
+		pos = bps_tree_find_after_ins_point_key(tree, inner->elems,
+							inner->header.size - 1,
+							key, &exact_test);
+		if (exact_test)
+			*exact = true;
+		for (bps_tree_pos_t j = 0; j < pos; j++)
+			offset += inner->child_cards[j];
+		block = bps_tree_restore_block(tree, inner->child_ids[pos]);
+	}
+
+	struct bps_leaf *leaf = (struct bps_leaf *)block;
+	offset += bps_tree_find_after_ins_point_key(tree, leaf->elems,
+						    leaf->header.size,
+						    key, &exact_test);
+	if (exact_test)
+		*exact = true;
+	return offset;
+}
+
+/**
+ * @brief Get an iterator to the element with the given offset,
+ * i.e. to the element that has exactly offset elements before it.
+ * @param tree - pointer to a tree
+ * @param offset - offset of the element
+ * @return - Iterator to the element. Invalid if the offset is not
+ *  less than the tree size.
+ */
+static inline struct bps_tree_iterator
+bps_tree_iterator_at(const struct bps_tree *tree, size_t offset)
+{
+	if (offset >= tree->size)
+		return bps_tree_invalid_iterator();
+	struct bps_block *block = bps_tree_root(tree);
+	bps_tree_block_id_t block_id = tree->root_id;
+	for (bps_tree_block_id_t i = 0; i < tree->depth - 1; i++) {
+		struct bps_inner *inner = (struct bps_inner *)block;
+		bps_tree_pos_t pos = 0;
+		while (offset >= inner->child_cards[pos]) {
+			offset -= inner->child_cards[pos];
+			pos++;
+			assert(pos < inner->header.size);
+		}
+		block_id = inner->child_ids[pos];
+		block = bps_tree_restore_block(tree, block_id);
+	}
+	assert(offset < (size_t)block->size);
+	struct bps_tree_iterator itr;
+	itr.block_id = block_id;
+	itr.pos = (bps_tree_pos_t)offset;
+	matras_head_read_view(&itr.view);
+	return itr;
+}
+
+#endif /* BPS_INNER_CARD */
+
 /**
  * @brief Get a pointer to the element pointed by iterator.
  *  If iterator is detected as broken, it is invalidated and NULL returned.
@@ -2112,6 +2422,64 @@ bps_tree_find(const struct bps_tree *tree, bps_tree_key_t key)
 		return 0;
 }
 
+static inline void
+bps_tree_find_batch(const struct bps_tree *tree, const bps_tree_key_t *keys,
+		    size_t count, bps_tree_elem_t **results)
+{
+	if (tree->root_id == (bps_tree_block_id_t)(-1)) {
+		for (size_t i = 0; i < count; i++)
+			results[i] = 0;
+		return;
+	}
+	/*
+	 * Number of descents interleaved. Should be enough to keep
+	 * all line fill buffers of a core busy.
+	 */
+	enum { BATCH_SIZE = 16 };
+	struct bps_block *blocks[BATCH_SIZE];
+	struct bps_block *root = bps_tree_root(tree);
+	bool exact = false;
+	for (; count > 0; ) {
+		size_t n = count < (size_t)BATCH_SIZE ?
+			   count : (size_t)BATCH_SIZE;
+		for (size_t j = 0; j < n; j++)
+			blocks[j] = root;
+		for (bps_tree_block_id_t i = 0; i < tree->depth - 1; i++) {
+			for (size_t j = 0; j < n; j++) {
+				struct bps_inner *inner =
+					(struct bps_inner *)blocks[j];
+				bps_tree_pos_t pos;
+				pos = bps_tree_find_ins_point_key(
+					tree, inner->elems,
+					inner->header.size - 1, keys[j],
+					&exact);
+				struct bps_block *child =
+					bps_tree_restore_block(
+						tree, inner->child_ids[pos]);
+				/*
+				 * Binary search starts with the header
+				 * and the middle of the block.
+				 */
+				__builtin_prefetch(child);
+				__builtin_prefetch((char *)child +
+						   BPS_TREE_BLOCK_SIZE / 2);
+				blocks[j] = child;
+			}
+		}
+		for (size_t j = 0; j < n; j++) {
+			struct bps_leaf *leaf = (struct bps_leaf *)blocks[j];
+			bps_tree_pos_t pos;
+			pos = bps_tree_find_ins_point_key(tree, leaf->elems,
+							  leaf->header.size,
+							  keys[j], &exact);
+			results[j] = exact ? leaf->elems + pos : 0;
+		}
+		keys += n;
+		results += n;
+		count -= n;
+	}
+}
+
 /**
  * @brief Add a block to the garbage for future reuse
  */
@@ -2267,6 +2635,9 @@ bps_tree_collect_path(struct bps_tree *tree, bps_tree_elem_t new_elem,
 	bps_tree_elem_t *max_elem_copy = &tree->max_elem;
 	bps_tree_block_id_t max_elem_block_id = (bps_tree_block_id_t)-1;
 	bps_tree_pos_t max_elem_pos = (bps_tree_pos_t)-1;
+#ifdef BPS_INNER_CARD
+	size_t *card = &tree->orphan_card;
+#endif
 	for (bps_tree_block_id_t i = 0; i < tree->depth - 1; i++) {
 		struct bps_inner *inner = (struct bps_inner *)block;
 		bps_tree_pos_t pos;
@@ -2285,6 +2656,10 @@ bps_tree_collect_path(struct bps_tree *tree, bps_tree_elem_t new_elem,
 		path[i].max_elem_copy = max_elem_copy;
 		path[i].max_elem_block_id = max_elem_block_id;
 		path[i].max_elem_pos = max_elem_pos;
+#ifdef BPS_INNER_CARD
+		path[i].card = card;
+		card = inner->child_cards + pos;
+#endif
 
 		if (pos < inner->header.size - 1) {
 			max_elem_copy = inner->elems + pos;
@@ -2314,6 +2689,9 @@ bps_tree_collect_path(struct bps_tree *tree, bps_tree_elem_t new_elem,
 	leaf_path_elem->max_elem_copy = max_elem_copy;
 	leaf_path_elem->max_elem_block_id = max_elem_block_id;
 	leaf_path_elem->max_elem_pos = max_elem_pos;
+#ifdef BPS_INNER_CARD
+	leaf_path_elem->card = card;
+#endif
 }
 
 /**
@@ -2339,10 +2717,20 @@ bps_tree_touch_path(struct bps_tree *tree,
 			     struct bps_leaf_path_elem *leaf_path_elem)
 {
 	bps_tree_touch_leaf_path_max_elem(tree, leaf_path_elem);
+#ifdef BPS_INNER_CARD
+	size_t **card = &leaf_path_elem->card;
+	bps_tree_pos_t pos_in_parent = leaf_path_elem->pos_in_parent;
+#endif
 	for (struct bps_inner_path_elem *path = leaf_path_elem->parent;
 	     path; path = path->parent) {
 		path->block = (struct bps_inner *)
 			bps_tree_touch_block(tree, path->block_id);
+#ifdef BPS_INNER_CARD
+		/* The child's cardinality is stored in the touched block. */
+		*card = path->block->child_cards + pos_in_parent;
+		card = &path->card;
+		pos_in_parent = path->pos_in_parent;
+#endif
 		if (path->max_elem_block_id == (bps_tree_block_id_t)-1)
 			continue;
 		struct bps_inner *holder = (struct bps_inner *)
@@ -2351,6 +2739,21 @@ bps_tree_touch_path(struct bps_tree *tree,
 	}
 }
 
+#ifdef BPS_INNER_CARD
+/**
+ * @brief Add a number to cardinalities of all blocks of a path.
+ *  The path must be touched.
+ */
+static inline void
+bps_tree_add_path_card(struct bps_leaf_path_elem *leaf_path_elem, int diff)
+{
+	*leaf_path_elem->card += diff;
+	for (struct bps_inner_path_elem *path = leaf_path_elem->parent;
+	     path; path = path->parent)
+		*path->card += diff;
+}
+#endif
+
 /**
  * @brief Replace element by it's path and fill the *replaced argument
  */
@@ -2436,6 +2839,16 @@ bps_tree_debug_memmove(void *dst_arg, void *src_arg, size_t num,
 				assert(src < ((char *)src_inner->elems) +
 				       (BPS_TREE_MAX_COUNT_IN_INNER - 1) *
 				       sizeof(bps_tree_elem_t));
+#ifdef BPS_INNER_CARD
+			} else if (dst >= (char *)dst_inner->child_cards) {
+				assert(dst < ((char *)dst_inner->child_cards) +
+				       BPS_TREE_MAX_COUNT_IN_INNER *
+				       sizeof(size_t));
+				assert(src >= (char *)src_inner->child_cards);
+				assert(src < ((char *)src_inner->child_cards) +
+				       BPS_TREE_MAX_COUNT_IN_INNER *
+				       sizeof(size_t));
+#endif
 			} else {
 				assert(dst >= ((char *)dst_inner->child_ids));
 				assert(dst < ((char *)dst_inner->child_ids) +
@@ -2456,6 +2869,16 @@ bps_tree_debug_memmove(void *dst_arg, void *src_arg, size_t num,
 					(BPS_TREE_MAX_COUNT_IN_INNER - 1) *
 					sizeof(bps_tree_elem_t)) {
 				/* nothing to do due to if condition */
+#ifdef BPS_INNER_CARD
+			} else if (dst >= (char *)dst_inner->child_cards) {
+				assert(dst <= ((char *)dst_inner->child_cards) +
+				       BPS_TREE_MAX_COUNT_IN_INNER *
+				       sizeof(size_t));
+				assert(src >= (char *)src_inner->child_cards);
+				assert(src <= ((char *)src_inner->child_cards) +
+				       BPS_TREE_MAX_COUNT_IN_INNER *
+				       sizeof(size_t));
+#endif
 			} else {
 				assert(dst >= ((char *)dst_inner->child_ids));
 				assert(dst <= ((char *)dst_inner->child_ids) +
@@ -2473,6 +2896,45 @@ bps_tree_debug_memmove(void *dst_arg, void *src_arg, size_t num,
 }
 #endif
 
+/**
+ * @brief Move a number of children from one position of an inner
+ *  block to another position of the same or another inner block.
+ */
+static inline void
+bps_tree_move_children(struct bps_inner *dst, bps_tree_pos_t dst_pos,
+		       struct bps_inner *src, bps_tree_pos_t src_pos,
+		       bps_tree_pos_t num)
+{
+	BPS_TREE_DATAMOVE(dst->child_ids + dst_pos, src->child_ids + src_pos,
+			  num, dst, src);
+#ifdef BPS_INNER_CARD
+	BPS_TREE_DATAMOVE(dst->child_cards + dst_pos,
+			  src->child_cards + src_pos, num, dst, src);
+#endif
+}
+
+/**
+ * @brief Set a child of an inner block.
+ */
+static inline void
+bps_tree_set_child(struct bps_tree *tree, struct bps_inner *inner,
+		   bps_tree_pos_t pos, bps_tree_block_id_t block_id)
+{
+	(void)tree;
+	inner->child_ids[pos] = block_id;
+#ifdef BPS_INNER_CARD
+	/*
+	 * exclusive behaviuor for debug checks: their blocks don't
+	 * belong to the tree, so the child ID is used as its number
+	 * of elements.
+	 */
+	if (tree->root_id == (bps_tree_block_id_t) -1)
+		inner->child_cards[pos] = block_id;
+	else
+		inner->child_cards[pos] = bps_tree_block_card(tree, block_id);
+#endif
+}
+
 /**
  * @breif Insert an element into leaf block. There must be enough space.
  */
@@ -2527,15 +2989,14 @@ bps_tree_insert_into_inner(struct bps_tree *tree,
 		BPS_TREE_DATAMOVE(inner->elems + pos + 1, inner->elems + pos,
 				  inner->header.size - pos - 1, inner, inner);
 		inner->elems[pos] = max_elem;
-		BPS_TREE_DATAMOVE(inner->child_ids + pos + 1,
-				  inner->child_ids + pos,
-				  inner->header.size - pos, inner, inner);
+		bps_tree_move_children(inner, pos + 1, inner, pos,
+				       inner->header.size - pos);
 	} else {
 		if (pos > 0)
 			inner->elems[pos - 1] = *inner_path_elem->max_elem_copy;
 		*inner_path_elem->max_elem_copy = max_elem;
 	}
-	inner->child_ids[pos] = block_id;
+	bps_tree_set_child(tree, inner, pos, block_id);
 
 	inner->header.size++;
 }
@@ -2591,9 +3052,8 @@ bps_tree_delete_from_inner(struct bps_tree *tree,
 	if (pos < inner->header.size - 1) {
 		BPS_TREE_DATAMOVE(inner->elems + pos, inner->elems + pos + 1,
 				  inner->header.size - 2 - pos, inner, inner);
-		BPS_TREE_DATAMOVE(inner->child_ids + pos,
-				  inner->child_ids + pos + 1,
-				  inner->header.size - 1 - pos, inner, inner);
+		bps_tree_move_children(inner, pos, inner, pos + 1,
+				       inner->header.size - 1 - pos);
 	} else if (pos > 0) {
 		*inner_path_elem->max_elem_copy = inner->elems[pos - 1];
 	}
@@ -2636,6 +3096,10 @@ bps_tree_move_elems_to_right_leaf(struct bps_tree *tree,
 		*a_leaf_path_elem->max_elem_copy =
 			a->elems[a->header.size - 1];
 	*b_leaf_path_elem->max_elem_copy = b->elems[b->header.size - 1];
+#ifdef BPS_INNER_CARD
+	*a_leaf_path_elem->card -= num;
+	*b_leaf_path_elem->card += num;
+#endif
 }
 
 /**
@@ -2663,10 +3127,8 @@ bps_tree_move_elems_to_right_inner(struct bps_tree *tree,
 	assert(a->header.size >= num);
 	assert(b->header.size + num <= BPS_TREE_MAX_COUNT_IN_INNER);
 
-	BPS_TREE_DATAMOVE(b->child_ids + num, b->child_ids,
-			  b->header.size, b, b);
-	BPS_TREE_DATAMOVE(b->child_ids, a->child_ids + a->header.size - num,
-			  num, b, a);
+	bps_tree_move_children(b, num, b, 0, b->header.size);
+	bps_tree_move_children(b, 0, a, a->header.size - num, num);
 
 	if (!move_to_empty)
 		BPS_TREE_DATAMOVE(b->elems + num, b->elems,
@@ -2684,6 +3146,11 @@ bps_tree_move_elems_to_right_inner(struct bps_tree *tree,
 
 	a->header.size -= num;
 	b->header.size += num;
+#ifdef BPS_INNER_CARD
+	size_t card = bps_tree_sum_cards(b, 0, num);
+	*a_inner_path_elem->card -= card;
+	*b_inner_path_elem->card += card;
+#endif
 }
 
 /**
@@ -2716,6 +3183,10 @@ bps_tree_move_elems_to_left_leaf(struct bps_tree *tree,
 	a->header.size += num;
 	b->header.size -= num;
 	*a_leaf_path_elem->max_elem_copy = a->elems[a->header.size - 1];
+#ifdef BPS_INNER_CARD
+	*a_leaf_path_elem->card += num;
+	*b_leaf_path_elem->card -= num;
+#endif
 }
 
 /**
@@ -2743,10 +3214,8 @@ bps_tree_move_elems_to_left_inner(struct bps_tree *tree,
 	assert(b->header.size >= num);
 	assert(a->header.size + num <= BPS_TREE_MAX_COUNT_IN_INNER);
 
-	BPS_TREE_DATAMOVE(a->child_ids + a->header.size, b->child_ids,
-			  num, a, b);
-	BPS_TREE_DATAMOVE(b->child_ids, b->child_ids + num,
-			  b->header.size - num, b, b);
+	bps_tree_move_children(a, a->header.size, b, 0, num);
+	bps_tree_move_children(b, 0, b, num, b->header.size - num);
 
 	if (!move_to_empty)
 		a->elems[a->header.size - 1] =
@@ -2763,6 +3232,11 @@ bps_tree_move_elems_to_left_inner(struct bps_tree *tree,
 
 	a->header.size += num;
 	b->header.size -= num;
+#ifdef BPS_INNER_CARD
+	size_t card = bps_tree_sum_cards(a, a->header.size - num, num);
+	*a_inner_path_elem->card += card;
+	*b_inner_path_elem->card -= card;
+#endif
 }
 
 /**
@@ -2830,6 +3304,10 @@ bps_tree_insert_and_move_elems_to_right_leaf(struct bps_tree *tree,
 	if (move_to_empty)
 		*b_leaf_path_elem->max_elem_copy =
 			b->elems[b->header.size - 1];
+#ifdef BPS_INNER_CARD
+	*a_leaf_path_elem->card -= num;
+	*b_leaf_path_elem->card += num;
+#endif
 	tree->size++;
 	return ret;
 }
@@ -2867,8 +3345,7 @@ bps_tree_insert_and_move_elems_to_right_inner(struct bps_tree *tree,
 	assert(pos >= 0);
 
 	if (!move_to_empty) {
-		BPS_TREE_DATAMOVE(b->child_ids + num, b->child_ids,
-				  b->header.size, b, b);
+		bps_tree_move_children(b, num, b, 0, b->header.size);
 		BPS_TREE_DATAMOVE(b->elems + num, b->elems,
 				  b->header.size - 1, b, b);
 	}
@@ -2876,12 +3353,9 @@ bps_tree_insert_and_move_elems_to_right_inner(struct bps_tree *tree,
 	bps_tree_pos_t mid_part_size = a->header.size - pos;
 	if (mid_part_size > num) {
 		/* In fact insert to 'a' block, to the internal position */
-		BPS_TREE_DATAMOVE(b->child_ids,
-				  a->child_ids + a->header.size - num,
-				  num, b, a);
-		BPS_TREE_DATAMOVE(a->child_ids + pos + 1, a->child_ids + pos,
-				  mid_part_size - num, a, a);
-		a->child_ids[pos] = block_id;
+		bps_tree_move_children(b, 0, a, a->header.size - num, num);
+		bps_tree_move_children(a, pos + 1, a, pos, mid_part_size - num);
+		bps_tree_set_child(tree, a, pos, block_id);
 
 		BPS_TREE_DATAMOVE(b->elems, a->elems + (a->header.size - num),
 				  num - 1, b, a);
@@ -2898,12 +3372,9 @@ bps_tree_insert_and_move_elems_to_right_inner(struct bps_tree *tree,
 		a->elems[pos] = max_elem;
 	} else if (mid_part_size == num) {
 		/* In fact insert to 'a' block, to the last position */
-		BPS_TREE_DATAMOVE(b->child_ids,
-				  a->child_ids + a->header.size - num,
-				  num, b, a);
-		BPS_TREE_DATAMOVE(a->child_ids + pos + 1, a->child_ids + pos,
-				  mid_part_size - num, a, a);
-		a->child_ids[pos] = block_id;
+		bps_tree_move_children(b, 0, a, a->header.size - num, num);
+		bps_tree_move_children(a, pos + 1, a, pos, mid_part_size - num);
+		bps_tree_set_child(tree, a, pos, block_id);
 
 		BPS_TREE_DATAMOVE(b->elems, a->elems + (a->header.size - num),
 				  num - 1, b, a);
@@ -2917,12 +3388,10 @@ bps_tree_insert_and_move_elems_to_right_inner(struct bps_tree *tree,
 	} else {
 		/* In fact insert to 'b' block */
 		bps_tree_pos_t new_pos = num - mid_part_size - 1;/* Can be 0 */
-		BPS_TREE_DATAMOVE(b->child_ids,
-				  a->child_ids + a->header.size - num + 1,
-				  new_pos, b, a);
-		b->child_ids[new_pos] = block_id;
-		BPS_TREE_DATAMOVE(b->child_ids + new_pos + 1,
-				  a->child_ids + pos, mid_part_size, b, a);
+		bps_tree_move_children(b, 0, a, a->header.size - num + 1,
+				       new_pos);
+		bps_tree_set_child(tree, b, new_pos, block_id);
+		bps_tree_move_children(b, new_pos + 1, a, pos, mid_part_size);
 
 		if (pos == a->header.size) {
 			/* +1 */
@@ -2967,6 +3436,11 @@ bps_tree_insert_and_move_elems_to_right_inner(struct bps_tree *tree,
 
 	a->header.size -= (num - 1);
 	b->header.size += num;
+#ifdef BPS_INNER_CARD
+	size_t card = bps_tree_sum_cards(b, 0, num);
+	*a_inner_path_elem->card -= card;
+	*b_inner_path_elem->card += card;
+#endif
 }
 
 /**
@@ -3033,6 +3507,10 @@ bps_tree_insert_and_move_elems_to_left_leaf(struct bps_tree *tree,
 	if (!move_all)
 		*b_leaf_path_elem->max_elem_copy =
 			b->elems[b->header.size - 1];
+#ifdef BPS_INNER_CARD
+	*a_leaf_path_elem->card += num;
+	*b_leaf_path_elem->card -= num;
+#endif
 	tree->size++;
 	return ret;
 }
@@ -3072,14 +3550,11 @@ bps_tree_insert_and_move_elems_to_left_inner(struct bps_tree *tree,
 	if (pos >= num) {
 		/* In fact insert to 'b' block */
 		bps_tree_pos_t new_pos = pos - num; /* Can be 0 */
-		BPS_TREE_DATAMOVE(a->child_ids + a->header.size, b->child_ids,
-				  num, a, b);
-		BPS_TREE_DATAMOVE(b->child_ids, b->child_ids + num,
-				  new_pos, b, b);
-		b->child_ids[new_pos] = block_id;
-		BPS_TREE_DATAMOVE(b->child_ids + new_pos + 1,
-				  b->child_ids + pos,
-				  b->header.size - pos, b, b);
+		bps_tree_move_children(a, a->header.size, b, 0, num);
+		bps_tree_move_children(b, 0, b, num, new_pos);
+		bps_tree_set_child(tree, b, new_pos, block_id);
+		bps_tree_move_children(b, new_pos + 1, b, pos,
+				       b->header.size - pos);
 
 		if (!move_to_empty)
 			a->elems[a->header.size - 1] =
@@ -3113,14 +3588,12 @@ bps_tree_insert_and_move_elems_to_left_inner(struct bps_tree *tree,
 	} else {
 		/* In fact insert to 'a' block */
 		bps_tree_pos_t new_pos = a->header.size + pos; /* Can be 0 */
-		BPS_TREE_DATAMOVE(a->child_ids + a->header.size,
-				  b->child_ids, pos, a, b);
-		a->child_ids[new_pos] = block_id;
-		BPS_TREE_DATAMOVE(a->child_ids + new_pos + 1,
-				  b->child_ids + pos, num - 1 - pos, a, b);
+		bps_tree_move_children(a, a->header.size, b, 0, pos);
+		bps_tree_set_child(tree, a, new_pos, block_id);
+		bps_tree_move_children(a, new_pos + 1, b, pos, num - 1 - pos);
 		if (!move_all)
-			BPS_TREE_DATAMOVE(b->child_ids, b->child_ids + num - 1,
-					  b->header.size - num + 1, b, b);
+			bps_tree_move_children(b, 0, b, num - 1,
+					       b->header.size - num + 1);
 
 		if (!move_to_empty)
 			a->elems[a->header.size - 1] =
@@ -3165,6 +3638,11 @@ bps_tree_insert_and_move_elems_to_left_inner(struct bps_tree *tree,
 
 	a->header.size += num;
 	b->header.size -= (num - 1);
+#ifdef BPS_INNER_CARD
+	size_t card = bps_tree_sum_cards(a, a->header.size - num, num);
+	*a_inner_path_elem->card += card;
+	*b_inner_path_elem->card -= card;
+#endif
 }
 
 /**
@@ -3225,6 +3703,10 @@ bps_tree_collect_left_path_elem_leaf(struct bps_tree *tree,
 		bps_tree_restore_block(tree, new_path_elem->block_id);
 	new_path_elem->max_elem_copy =
 		parent->block->elems + new_path_elem->pos_in_parent;
+#ifdef BPS_INNER_CARD
+	new_path_elem->card =
+		parent->block->child_cards + new_path_elem->pos_in_parent;
+#endif
 	new_path_elem->insertion_point = (bps_tree_pos_t)(-1); /* unused */
 	return true;
 }
@@ -3252,6 +3734,10 @@ bps_tree_collect_left_path_elem_inner(struct bps_tree *tree,
 		bps_tree_restore_block(tree, new_path_elem->block_id);
 	new_path_elem->max_elem_copy = parent->block->elems +
 		new_path_elem->pos_in_parent;
+#ifdef BPS_INNER_CARD
+	new_path_elem->card =
+		parent->block->child_cards + new_path_elem->pos_in_parent;
+#endif
 	new_path_elem->insertion_point = (bps_tree_pos_t)(-1); /* unused */
 	return true;
 }
@@ -3281,6 +3767,10 @@ bps_tree_collect_right_ext_leaf(struct bps_tree *tree,
 	else
 		new_path_elem->max_elem_copy = parent->block->elems +
 			new_path_elem->pos_in_parent;
+#ifdef BPS_INNER_CARD
+	new_path_elem->card =
+		parent->block->child_cards + new_path_elem->pos_in_parent;
+#endif
 	new_path_elem->insertion_point = (bps_tree_pos_t)(-1); /* unused */
 	return true;
 }
@@ -3311,6 +3801,10 @@ bps_tree_collect_right_ext_inner(struct bps_tree *tree,
 	else
 		new_path_elem->max_elem_copy = parent->block->elems +
 			new_path_elem->pos_in_parent;
+#ifdef BPS_INNER_CARD
+	new_path_elem->card =
+		parent->block->child_cards + new_path_elem->pos_in_parent;
+#endif
 	new_path_elem->insertion_point = (bps_tree_pos_t)(-1); /* unused */
 	return true;
 }
@@ -3372,6 +3866,10 @@ bps_tree_process_insert_leaf(struct bps_tree *tree,
 			     bps_tree_pos_t *inserted_in_pos)
 {
 	if (bps_tree_leaf_free_size(leaf_path_elem->block)) {
+#ifdef BPS_INNER_CARD
+		bps_tree_touch_path(tree, leaf_path_elem);
+		bps_tree_add_path_card(leaf_path_elem, 1);
+#endif
 		bps_tree_insert_into_leaf(tree, leaf_path_elem, new_elem);
 		BPS_TREE_BRANCH_TRACE(tree, insert_leaf, 1 << 0x0);
 		*inserted_in_block = leaf_path_elem->block_id;
@@ -3379,11 +3877,18 @@ bps_tree_process_insert_leaf(struct bps_tree *tree,
 		return 0;
 	}
 	bps_tree_touch_path(tree, leaf_path_elem);
+#ifdef BPS_INNER_CARD
+	/*
+	 * Account the new element in advance, the moves below only
+	 * redistribute it between the blocks.
+	 */
+	bps_tree_add_path_card(leaf_path_elem, 1);
+#endif
 
-	struct bps_leaf_path_elem left_ext = {0, 0, 0, 0, 0, 0, 0, 0},
-			right_ext = {0, 0, 0, 0, 0, 0, 0, 0},
-			left_left_ext = {0, 0, 0, 0, 0, 0, 0, 0},
-			right_right_ext = {0, 0, 0, 0, 0, 0, 0, 0};
+	struct bps_leaf_path_elem left_ext = BPS_TREE_PATH_ELEM_INITIALIZER,
+			right_ext = BPS_TREE_PATH_ELEM_INITIALIZER,
+			left_left_ext = BPS_TREE_PATH_ELEM_INITIALIZER,
+			right_right_ext = BPS_TREE_PATH_ELEM_INITIALIZER;
 	bool has_left_ext =
 		bps_tree_collect_left_path_elem_leaf(tree, leaf_path_elem,
 						     &left_ext);
@@ -3485,6 +3990,9 @@ bps_tree_process_insert_leaf(struct bps_tree *tree,
 	}
 
 	if (!bps_tree_reserve_blocks(tree, tree->depth + 1)) {
+#ifdef BPS_INNER_CARD
+		bps_tree_add_path_card(leaf_path_elem, -1);
+#endif
 		return -1;
 	}
 	bps_tree_block_id_t new_block_id = (bps_tree_block_id_t)(-1);
@@ -3510,6 +4018,9 @@ bps_tree_process_insert_leaf(struct bps_tree *tree,
 	bps_tree_elem_t new_max_elem = tree->max_elem;
 	bps_tree_prepare_new_ext_leaf(leaf_path_elem, &new_path_elem, new_leaf,
 				      new_block_id, &new_max_elem);
+#ifdef BPS_INNER_CARD
+	new_path_elem.card = &tree->orphan_card;
+#endif
 	if (has_left_ext && has_right_ext) {
 		/*
 		 * The block has MAX elems and +1 elem is inserted,
@@ -3728,8 +4239,8 @@ bps_tree_process_insert_leaf(struct bps_tree *tree,
 		struct bps_inner *new_root = bps_tree_create_inner(tree,
 				&new_root_id);
 		new_root->header.size = 2;
-		new_root->child_ids[0] = tree->root_id;
-		new_root->child_ids[1] = new_block_id;
+		bps_tree_set_child(tree, new_root, 0, tree->root_id);
+		bps_tree_set_child(tree, new_root, 1, new_block_id);
 		new_root->elems[0] = tree->max_elem;
 		tree->root_id = new_root_id;
 		tree->max_elem = new_max_elem;
@@ -3765,10 +4276,10 @@ bps_tree_process_insert_inner(struct bps_tree *tree,
 		BPS_TREE_BRANCH_TRACE(tree, insert_inner, 1 << 0x0);
 		return 0;
 	}
-	struct bps_inner_path_elem left_ext = {0, 0, 0, 0, 0, 0, 0, 0},
-		right_ext = {0, 0, 0, 0, 0, 0, 0, 0},
-		left_left_ext = {0, 0, 0, 0, 0, 0, 0, 0},
-		right_right_ext = {0, 0, 0, 0, 0, 0, 0, 0};
+	struct bps_inner_path_elem left_ext = BPS_TREE_PATH_ELEM_INITIALIZER,
+		right_ext = BPS_TREE_PATH_ELEM_INITIALIZER,
+		left_left_ext = BPS_TREE_PATH_ELEM_INITIALIZER,
+		right_right_ext = BPS_TREE_PATH_ELEM_INITIALIZER;
 	bool has_left_ext =
 		bps_tree_collect_left_path_elem_inner(tree, inner_path_elem,
 						      &left_ext);
@@ -3858,6 +4369,9 @@ bps_tree_process_insert_inner(struct bps_tree *tree,
 	bps_tree_elem_t new_max_elem = tree->max_elem;
 	bps_tree_prepare_new_ext_inner(inner_path_elem, &new_path_elem,
 				       new_inner, new_block_id, &new_max_elem);
+#ifdef BPS_INNER_CARD
+	new_path_elem.card = &tree->orphan_card;
+#endif
 	if (has_left_ext && has_right_ext) {
 		/*
 		 * The block has MAX elems and +1 elem is inserted,
@@ -4048,8 +4562,8 @@ bps_tree_process_insert_inner(struct bps_tree *tree,
 		struct bps_inner *new_root =
 			bps_tree_create_inner(tree, &new_root_id);
 		new_root->header.size = 2;
-		new_root->child_ids[0] = tree->root_id;
-		new_root->child_ids[1] = new_block_id;
+		bps_tree_set_child(tree, new_root, 0, tree->root_id);
+		bps_tree_set_child(tree, new_root, 1, new_block_id);
 		new_root->elems[0] = tree->max_elem;
 		tree->root_id = new_root_id;
 		tree->max_elem = new_max_elem;
@@ -4079,6 +4593,10 @@ static inline void
 bps_tree_process_delete_leaf(struct bps_tree *tree,
 			     struct bps_leaf_path_elem *leaf_path_elem)
 {
+#ifdef BPS_INNER_CARD
+	bps_tree_touch_path(tree, leaf_path_elem);
+	bps_tree_add_path_card(leaf_path_elem, -1);
+#endif
 	bps_tree_delete_from_leaf(tree, leaf_path_elem);
 
 	if (leaf_path_elem->block->header.size >=
@@ -4089,10 +4607,10 @@ bps_tree_process_delete_leaf(struct bps_tree *tree,
 
 	bps_tree_touch_path(tree, leaf_path_elem);
 
-	struct bps_leaf_path_elem left_ext = {0, 0, 0, 0, 0, 0, 0, 0},
-		right_ext = {0, 0, 0, 0, 0, 0, 0, 0},
-		left_left_ext = {0, 0, 0, 0, 0, 0, 0, 0},
-		right_right_ext = {0, 0, 0, 0, 0, 0, 0, 0};
+	struct bps_leaf_path_elem left_ext = BPS_TREE_PATH_ELEM_INITIALIZER,
+		right_ext = BPS_TREE_PATH_ELEM_INITIALIZER,
+		left_left_ext = BPS_TREE_PATH_ELEM_INITIALIZER,
+		right_right_ext = BPS_TREE_PATH_ELEM_INITIALIZER;
 	bool has_left_ext =
 		bps_tree_collect_left_path_elem_leaf(tree, leaf_path_elem,
 						     &left_ext);
@@ -4275,10 +4793,10 @@ bps_tree_process_delete_inner(struct bps_tree *tree,
 		return;
 	}
 
-	struct bps_inner_path_elem left_ext = {0, 0, 0, 0, 0, 0, 0, 0},
-		right_ext = {0, 0, 0, 0, 0, 0, 0, 0},
-		left_left_ext = {0, 0, 0, 0, 0, 0, 0, 0},
-		right_right_ext = {0, 0, 0, 0, 0, 0, 0, 0};
+	struct bps_inner_path_elem left_ext = BPS_TREE_PATH_ELEM_INITIALIZER,
+		right_ext = BPS_TREE_PATH_ELEM_INITIALIZER,
+		left_left_ext = BPS_TREE_PATH_ELEM_INITIALIZER,
+		right_right_ext = BPS_TREE_PATH_ELEM_INITIALIZER;
 	bool has_left_ext =
 		bps_tree_collect_left_path_elem_inner(tree, inner_path_elem,
 						      &left_ext);
@@ -4687,13 +5205,22 @@ bps_tree_debug_check_block(const struct bps_tree *tree, struct bps_block *block,
 				result |= 0x4000000;
 		}
 
-		for (bps_tree_pos_t i = 0; i < block->size; i++)
+		for (bps_tree_pos_t i = 0; i < block->size; i++) {
+#ifdef BPS_INNER_CARD
+			size_t child_count = *calc_count;
+#endif
 			result |= bps_tree_debug_check_block(tree,
 				bps_tree_restore_block(tree,
 						       inner->child_ids[i]),
 				inner->child_ids[i], level - 1, calc_count,
 				expected_prev_id, expected_this_id,
 				check_fullness_next);
+#ifdef BPS_INNER_CARD
+			child_count = *calc_count - child_count;
+			if (inner->child_cards[i] != child_count)
+				result |= 0x8000000;
+#endif
+		}
 		return result;
 	}
 }
@@ -4846,6 +5373,9 @@ bps_tree_print(const struct bps_tree *tree, const char *elem_fmt)
  * Debug utilities for testing base operation on blocks:
  * inserting, deleting, moving to left and right blocks,
  * and (inserting and moving)
+ * With BPS_INNER_CARD the blocks don't belong to a tree, so the
+ * number of elements in a child subtree is its ID, see
+ * bps_tree_set_child().
  */
 
 /**
@@ -4903,6 +5433,44 @@ bps_tree_debug_get_elem_inner(const struct bps_inner_path_elem *path_elem,
 		return bps_tree_debug_get_elem(path_elem->max_elem_copy);
 }
 
+#ifdef BPS_INNER_CARD
+/**
+ * @brief Set the numbers of elements in child subtrees of an inner
+ *  block equal to the child IDs.
+ * Used for debug self-check
+ */
+static inline void
+bps_tree_debug_set_cards(struct bps_inner *block)
+{
+	for (bps_tree_pos_t i = 0; i < BPS_TREE_MAX_COUNT_IN_INNER; i++)
+		block->child_cards[i] = block->child_ids[i];
+}
+
+/**
+ * @brief Check that the numbers of elements in child subtrees of an
+ *  inner block were moved together with the child IDs.
+ * Used for debug self-check
+ */
+static inline bool
+bps_tree_debug_check_cards(const struct bps_inner *block)
+{
+	for (bps_tree_pos_t i = 0; i < block->header.size; i++)
+		if (block->child_cards[i] != block->child_ids[i])
+			return false;
+	return true;
+}
+
+/**
+ * @brief Get the number of elements in the subtree of an inner block.
+ * Used for debug self-check
+ */
+static inline size_t
+bps_tree_debug_sum_cards(const struct bps_inner *block)
+{
+	return bps_tree_sum_cards(block, 0, block->header.size);
+}
+#endif
+
 /**
  * @brief Check all possible insertions into a leaf.
  * Used for debug self-check
@@ -5072,9 +5640,21 @@ bps_tree_debug_check_move_to_right_leaf(struct bps_tree *tree, bool assertme)
 				a_path_elem.block_id = 0;
 				b_path_elem.block_id = 0;
 
+#ifdef BPS_INNER_CARD
+				size_t a_card = i, b_card = j;
+				a_path_elem.card = &a_card;
+				b_path_elem.card = &b_card;
+#endif
 				bps_tree_move_elems_to_right_leaf(tree,
 					&a_path_elem, &b_path_elem,
 					(bps_tree_pos_t) k);
+#ifdef BPS_INNER_CARD
+				if (a_card != (size_t)a.header.size ||
+				    b_card != (size_t)b.header.size) {
+					result |= (1 << 24);
+					assert(!assertme);
+				}
+#endif
 
 				if (a.header.size != (bps_tree_pos_t) (i - k)) {
 					result |= (1 << 4);
@@ -5175,9 +5755,21 @@ bps_tree_debug_check_move_to_left_leaf(struct bps_tree *tree, bool assertme)
 				a_path_elem.block_id = 0;
 				b_path_elem.block_id = 0;
 
+#ifdef BPS_INNER_CARD
+				size_t a_card = i, b_card = j;
+				a_path_elem.card = &a_card;
+				b_path_elem.card = &b_card;
+#endif
 				bps_tree_move_elems_to_left_leaf(tree,
 					&a_path_elem, &b_path_elem,
 					(bps_tree_pos_t) k);
+#ifdef BPS_INNER_CARD
+				if (a_card != (size_t)a.header.size ||
+				    b_card != (size_t)b.header.size) {
+					result |= (1 << 24);
+					assert(!assertme);
+				}
+#endif
 
 				if (a.header.size != (bps_tree_pos_t) (i + k)) {
 					result |= (1 << 6);
@@ -5289,10 +5881,26 @@ bps_tree_debug_check_insert_and_move_to_right_leaf(struct bps_tree *tree,
 					bps_tree_elem_t ins;
 					bps_tree_debug_set_elem(&ins, ic);
 
+#ifdef BPS_INNER_CARD
+					/*
+					 * The caller accounts the inserted
+					 * element in advance.
+					 */
+					size_t a_card = i + 1, b_card = j;
+					a_path_elem.card = &a_card;
+					b_path_elem.card = &b_card;
+#endif
 					bps_tree_insert_and_move_elems_to_right_leaf(
 						tree, &a_path_elem,
 						&b_path_elem,
 						(bps_tree_pos_t) u, ins);
+#ifdef BPS_INNER_CARD
+					if (a_card != (size_t)a.header.size ||
+					    b_card != (size_t)b.header.size) {
+						result |= (1 << 24);
+						assert(!assertme);
+					}
+#endif
 
 					if (a.header.size
 						!= (bps_tree_pos_t) (i - u + 1)) {
@@ -5406,10 +6014,26 @@ bps_tree_debug_check_insert_and_move_to_left_leaf(struct bps_tree *tree,
 					bps_tree_elem_t ins;
 					bps_tree_debug_set_elem(&ins, ic);
 
+#ifdef BPS_INNER_CARD
+					/*
+					 * The caller accounts the inserted
+					 * element in advance.
+					 */
+					size_t a_card = i, b_card = j + 1;
+					a_path_elem.card = &a_card;
+					b_path_elem.card = &b_card;
+#endif
 					bps_tree_insert_and_move_elems_to_left_leaf(
 						tree, &a_path_elem,
 						&b_path_elem,
 						(bps_tree_pos_t) u, ins);
+#ifdef BPS_INNER_CARD
+					if (a_card != (size_t)a.header.size ||
+					    b_card != (size_t)b.header.size) {
+						result |= (1 << 24);
+						assert(!assertme);
+					}
+#endif
 
 					if (a.header.size
 						!= (bps_tree_pos_t) (i + u)) {
@@ -5511,9 +6135,18 @@ bps_tree_debug_check_insert_into_inner(struct bps_tree *tree, bool assertme)
 					block.child_ids[k] =
 						(bps_tree_block_id_t) (k + 1);
 
+#ifdef BPS_INNER_CARD
+			bps_tree_debug_set_cards(&block);
+#endif
 			bps_tree_insert_into_inner(tree, &path_elem,
 				(bps_tree_block_id_t) j, (bps_tree_pos_t) j,
 				ins);
+#ifdef BPS_INNER_CARD
+			if (!bps_tree_debug_check_cards(&block)) {
+				result |= (1 << 25);
+				assert(!assertme);
+			}
+#endif
 
 			for (unsigned int k = 0; k <= i; k++) {
 				if (bps_tree_debug_get_elem_inner(&path_elem, k)
@@ -5563,7 +6196,16 @@ bps_tree_debug_check_delete_from_inner(struct bps_tree *tree, bool assertme)
 			path_elem.max_elem_block_id = -1;
 			path_elem.max_elem_pos = -1;
 
+#ifdef BPS_INNER_CARD
+			bps_tree_debug_set_cards(&block);
+#endif
 			bps_tree_delete_from_inner(tree, &path_elem);
+#ifdef BPS_INNER_CARD
+			if (!bps_tree_debug_check_cards(&block)) {
+				result |= (1 << 25);
+				assert(!assertme);
+			}
+#endif
 
 			unsigned char c = 0;
 			bps_tree_block_id_t kk = 0;
@@ -5642,9 +6284,26 @@ bps_tree_debug_check_move_to_right_inner(struct bps_tree *tree, bool assertme)
 					b.child_ids[u] = kk++;
 				}
 
+#ifdef BPS_INNER_CARD
+				bps_tree_debug_set_cards(&a);
+				bps_tree_debug_set_cards(&b);
+				size_t a_card = bps_tree_debug_sum_cards(&a);
+				size_t b_card = bps_tree_debug_sum_cards(&b);
+				a_path_elem.card = &a_card;
+				b_path_elem.card = &b_card;
+#endif
 				bps_tree_move_elems_to_right_inner(tree,
 					&a_path_elem, &b_path_elem,
 					(bps_tree_pos_t) k);
+#ifdef BPS_INNER_CARD
+				if (!bps_tree_debug_check_cards(&a) ||
+				    !bps_tree_debug_check_cards(&b) ||
+				    a_card != bps_tree_debug_sum_cards(&a) ||
+				    b_card != bps_tree_debug_sum_cards(&b)) {
+					result |= (1 << 25);
+					assert(!assertme);
+				}
+#endif
 
 				if (a.header.size != (bps_tree_pos_t) (i - k)) {
 					result |= (1 << 16);
@@ -5742,9 +6401,26 @@ bps_tree_debug_check_move_to_left_inner(struct bps_tree *tree, bool assertme)
 					b.child_ids[u] = kk++;
 				}
 
+#ifdef BPS_INNER_CARD
+				bps_tree_debug_set_cards(&a);
+				bps_tree_debug_set_cards(&b);
+				size_t a_card = bps_tree_debug_sum_cards(&a);
+				size_t b_card = bps_tree_debug_sum_cards(&b);
+				a_path_elem.card = &a_card;
+				b_path_elem.card = &b_card;
+#endif
 				bps_tree_move_elems_to_left_inner(tree,
 					&a_path_elem, &b_path_elem,
 					(bps_tree_pos_t) k);
+#ifdef BPS_INNER_CARD
+				if (!bps_tree_debug_check_cards(&a) ||
+				    !bps_tree_debug_check_cards(&b) ||
+				    a_card != bps_tree_debug_sum_cards(&a) ||
+				    b_card != bps_tree_debug_sum_cards(&b)) {
+					result |= (1 << 25);
+					assert(!assertme);
+				}
+#endif
 
 				if (a.header.size != (bps_tree_pos_t) (i + k)) {
 					result |= (1 << 18);
@@ -5864,11 +6540,37 @@ bps_tree_debug_check_insert_and_move_to_right_inner(struct bps_tree *tree,
 					bps_tree_elem_t ins;
 					bps_tree_debug_set_elem(&ins, ic);
 
+#ifdef BPS_INNER_CARD
+					bps_tree_debug_set_cards(&a);
+					bps_tree_debug_set_cards(&b);
+					size_t a_card =
+						bps_tree_debug_sum_cards(&a);
+					size_t b_card =
+						bps_tree_debug_sum_cards(&b);
+					/*
+					 * The caller accounts the inserted
+					 * child in advance.
+					 */
+					a_card += ikk;
+					a_path_elem.card = &a_card;
+					b_path_elem.card = &b_card;
+#endif
 					bps_tree_insert_and_move_elems_to_right_inner(
 						tree, &a_path_elem,
 						&b_path_elem,
 						(bps_tree_pos_t) u, ikk,
 						(bps_tree_pos_t) k, ins);
+#ifdef BPS_INNER_CARD
+					if (!bps_tree_debug_check_cards(&a) ||
+					    !bps_tree_debug_check_cards(&b) ||
+					    a_card !=
+					    bps_tree_debug_sum_cards(&a) ||
+					    b_card !=
+					    bps_tree_debug_sum_cards(&b)) {
+						result |= (1 << 25);
+						assert(!assertme);
+					}
+#endif
 
 					if (a.header.size
 						!= (bps_tree_pos_t) (i - u + 1)) {
@@ -5991,11 +6693,37 @@ bps_tree_debug_check_insert_and_move_to_left_inner(struct bps_tree *tree,
 					bps_tree_elem_t ins;
 					bps_tree_debug_set_elem(&ins, ic);
 
+#ifdef BPS_INNER_CARD
+					bps_tree_debug_set_cards(&a);
+					bps_tree_debug_set_cards(&b);
+					size_t a_card =
+						bps_tree_debug_sum_cards(&a);
+					size_t b_card =
+						bps_tree_debug_sum_cards(&b);
+					/*
+					 * The caller accounts the inserted
+					 * child in advance.
+					 */
+					b_card += ikk;
+					a_path_elem.card = &a_card;
+					b_path_elem.card = &b_card;
+#endif
 					bps_tree_insert_and_move_elems_to_left_inner(
 						tree, &a_path_elem,
 						&b_path_elem,
 						(bps_tree_pos_t) u, ikk,
 						(bps_tree_pos_t) k, ins);
+#ifdef BPS_INNER_CARD
+					if (!bps_tree_debug_check_cards(&a) ||
+					    !bps_tree_debug_check_cards(&b) ||
+					    a_card !=
+					    bps_tree_debug_sum_cards(&a) ||
+					    b_card !=
+					    bps_tree_debug_sum_cards(&b)) {
+						result |= (1 << 25);
+						assert(!assertme);
+					}
+#endif
 
 					if (a.header.size
 						!= (bps_tree_pos_t) (i + u)) {
@@ -6085,6 +6813,7 @@ bps_tree_debug_check_internal_functions(bool assertme)
 
 #undef BPS_TREE_MEMMOVE
 #undef BPS_TREE_DATAMOVE
+#undef BPS_TREE_PATH_ELEM_INITIALIZER
 #undef BPS_TREE_BRANCH_TRACE
 
 /* {{{ Macros for custom naming of structs and functions */
@@ -6108,6 +6837,7 @@ bps_tree_debug_check_internal_functions(bool assertme)
 #undef bps_tree_build
 #undef bps_tree_destroy
 #undef bps_tree_find
+#undef bps_tree_find_batch
 #undef bps_tree_insert
 #undef bps_tree_delete
 #undef bps_tree_delete_value
@@ -6124,6 +6854,9 @@ bps_tree_debug_check_internal_functions(bool assertme)
 #undef bps_tree_lower_bound_elem
 #undef bps_tree_upper_bound_elem
 #undef bps_tree_approximate_count
+#undef bps_tree_lower_bound_offset
+#undef bps_tree_upper_bound_offset
+#undef bps_tree_iterator_at
 #undef bps_tree_iterator_get_elem
 #undef bps_tree_iterator_next
 #undef bps_tree_iterator_prev
@@ -6146,6 +6879,12 @@ bps_tree_debug_check_internal_functions(bool assertme)
 #undef bps_tree_restore_block_ver
 #undef bps_tree_root
 #undef bps_tree_touch_block
+#undef bps_tree_block_card
+#undef bps_tree_build_cards
+#undef bps_tree_add_path_card
+#undef bps_tree_sum_cards
+#undef bps_tree_move_children
+#undef bps_tree_set_child
 #undef bps_tree_find_ins_point_key
 #undef bps_tree_find_ins_point_elem
 #undef bps_tree_find_after_ins_point_key
@@ -0,0 +1,64 @@
+/*
+ * Copyright 2010-2026, Tarantool AUTHORS, please see AUTHORS file.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above
+ *    copyright notice, this list of conditions and the
+ *    following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY <COPYRIGHT HOLDER> ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * <COPYRIGHT HOLDER> OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#include "cm_sketch.h"
+#include <stdlib.h>
+
+int
+cm_sketch_create(struct cm_sketch *sketch, uint32_t width)
+{
+	uint32_t size = 64;
+	while (size < width && size < (1U << 26))
+		size *= 2;
+	sketch->table = calloc((size_t)size * CM_SKETCH_DEPTH,
+			       sizeof(*sketch->table));
+	if (sketch->table == NULL)
+		return -1;
+	sketch->mask = size - 1;
+	sketch->additions = 0;
+	sketch->sample_size = size * CM_SKETCH_SAMPLE_FACTOR;
+	return 0;
+}
+
+void
+cm_sketch_destroy(struct cm_sketch *sketch)
+{
+	free(sketch->table);
+}
+
+void
+cm_sketch_age(struct cm_sketch *sketch)
+{
+	size_t size = (size_t)(sketch->mask + 1) * CM_SKETCH_DEPTH;
+	for (size_t i = 0; i < size; i++)
+		sketch->table[i] >>= 1;
+	sketch->additions /= 2;
+}
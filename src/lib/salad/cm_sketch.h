@@ -0,0 +1,187 @@
+#ifndef TARANTOOL_LIB_SALAD_CM_SKETCH_H_INCLUDED
+#define TARANTOOL_LIB_SALAD_CM_SKETCH_H_INCLUDED
+/*
+ * Copyright 2010-2026, Tarantool AUTHORS, please see AUTHORS file.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above
+ *    copyright notice, this list of conditions and the
+ *    following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY <COPYRIGHT HOLDER> ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * <COPYRIGHT HOLDER> OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * Count-min sketch with small saturating counters and aging, as
+ * used by the TinyLFU cache admission policy:
+ *  Einziger, G.; Friedman, R.; Manes, B. (2017),
+ *  "TinyLFU: A Highly Efficient Cache Admission Policy"
+ *  https://arxiv.org/abs/1512.00727
+ *
+ * The sketch estimates how many times a value was added recently.
+ * Every value increments one counter in each of CM_SKETCH_DEPTH
+ * rows, and the estimate is the minimum of them, so it may be
+ * greater than the real count because of collisions but never
+ * less, until the counters are aged. Once the number of additions
+ * reaches the sample size, all counters are halved, so values that
+ * were popular long ago lose their weight.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif /* defined(__cplusplus) */
+
+enum {
+	/* Number of rows, each with its own hash function. */
+	CM_SKETCH_DEPTH = 4,
+	/* Max value of a counter. */
+	CM_SKETCH_COUNTER_MAX = 15,
+	/* Sample size, in number of additions per counter in a row. */
+	CM_SKETCH_SAMPLE_FACTOR = 10,
+};
+
+/**
+ * Count-min sketch data structure
+ */
+struct cm_sketch {
+	/* Number of counters in a row minus one, a power of 2 minus 1 */
+	uint32_t mask;
+	/* Number of additions since the last aging */
+	uint32_t additions;
+	/* Number of additions after which the counters are aged */
+	uint32_t sample_size;
+	/* CM_SKETCH_DEPTH rows of counters */
+	uint8_t *table;
+};
+
+/* {{{ API declaration */
+
+/**
+ * Allocate and initialize a count-min sketch
+ *
+ * @param sketch - structure to initialize
+ * @param width - number of counters in a row, rounded up to
+ *  a power of 2. Should be about the number of distinct values
+ *  that are worth tracking, e.g. the number of cache entries.
+ * @return 0 - OK, -1 - memory error
+ */
+int
+cm_sketch_create(struct cm_sketch *sketch, uint32_t width);
+
+/**
+ * Free resources of the count-min sketch
+ *
+ * @param sketch - the count-min sketch
+ */
+void
+cm_sketch_destroy(struct cm_sketch *sketch);
+
+/**
+ * Halve all counters of the sketch
+ *
+ * @param sketch - the count-min sketch
+ */
+void
+cm_sketch_age(struct cm_sketch *sketch);
+
+/**
+ * Count one more occurrence of a value
+ * @param sketch - the count-min sketch
+ * @param hash - hash of the value
+ */
+static void
+cm_sketch_add(struct cm_sketch *sketch, uint32_t hash);
+
+/**
+ * Estimate the number of occurrences of a value
+ * @param sketch - the count-min sketch
+ * @param hash - hash of the value
+ * @return - estimated count, at most CM_SKETCH_COUNTER_MAX
+ */
+static uint32_t
+cm_sketch_estimate(const struct cm_sketch *sketch, uint32_t hash);
+
+/* }}} API declaration */
+
+/* {{{ API definition */
+
+/**
+ * Position of the counter of a value in the given row. Every row
+ * mixes the hash with its own odd multiplier.
+ */
+static inline uint32_t
+cm_sketch_pos(const struct cm_sketch *sketch, uint32_t hash, uint32_t row)
+{
+	static const uint32_t seeds[CM_SKETCH_DEPTH] = {
+		0x9e3779b1, 0x85ebca77, 0xc2b2ae3d, 0x27d4eb2f,
+	};
+	uint32_t h = hash * seeds[row];
+	h ^= h >> 15;
+	return row * (sketch->mask + 1) + (h & sketch->mask);
+}
+
+static inline void
+cm_sketch_add(struct cm_sketch *sketch, uint32_t hash)
+{
+	/*
+	 * Conservative update: increment only the counters that are
+	 * equal to the current estimate. The others are already
+	 * overestimated because of collisions.
+	 */
+	uint32_t min = cm_sketch_estimate(sketch, hash);
+	if (min < CM_SKETCH_COUNTER_MAX) {
+		for (uint32_t row = 0; row < CM_SKETCH_DEPTH; row++) {
+			uint8_t *counter =
+				&sketch->table[cm_sketch_pos(sketch, hash,
+							     row)];
+			if (*counter == min)
+				(*counter)++;
+		}
+	}
+	if (++sketch->additions >= sketch->sample_size)
+		cm_sketch_age(sketch);
+}
+
+static inline uint32_t
+cm_sketch_estimate(const struct cm_sketch *sketch, uint32_t hash)
+{
+	uint32_t min = CM_SKETCH_COUNTER_MAX;
+	for (uint32_t row = 0; row < CM_SKETCH_DEPTH; row++) {
+		uint32_t counter =
+			sketch->table[cm_sketch_pos(sketch, hash, row)];
+		if (counter < min)
+			min = counter;
+	}
+	return min;
+}
+
+/* }}} API definition */
+
+#if defined(__cplusplus)
+} /* extern "C" */
+#endif /* defined(__cplusplus) */
+
+#endif /* TARANTOOL_LIB_SALAD_CM_SKETCH_H_INCLUDED */
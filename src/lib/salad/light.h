@@ -334,6 +334,27 @@ LIGHT(iterator_freeze)(struct LIGHT(core) *ht, struct LIGHT(iterator) *itr);
 static inline void
 LIGHT(iterator_destroy)(struct LIGHT(core) *ht, struct LIGHT(iterator) *itr);
 
+/**
+ * @brief Grow the hash table in advance, so that it can hold the given
+ * number of values without growing on insertion.
+ * @param ht - pointer to a hash table struct
+ * @param size - number of values to reserve space for
+ * @return 0 on success, -1 on memory failure
+ */
+static inline int
+LIGHT(reserve)(struct LIGHT(core) *ht, uint32_t size);
+
+/**
+ * @brief Get the length of the chain that starts in the given slot.
+ * @param ht - pointer to a hash table struct
+ * @param slotpos - ID of a record
+ *  ID must be in valid range [0, ht->table_size) (asserted).
+ * @return number of values in the chain or 0 if the slot is empty or
+ *  holds a value of another chain
+ */
+static inline uint32_t
+LIGHT(chain_length)(const struct LIGHT(core) *ht, uint32_t slotpos);
+
 /* Functions definition */
 
 /**
@@ -655,7 +676,6 @@ LIGHT(prepare_first_insert)(struct LIGHT(core) *ht)
 static inline int
 LIGHT(grow)(struct LIGHT(core) *ht)
 {
-	assert(ht->empty_slot == LIGHT(end));
 	uint32_t new_slot;
 	struct LIGHT(record) *new_record = (struct LIGHT(record) *)
 		matras_alloc_range(&ht->mtable, &new_slot, LIGHT_GROW_INCREMENT);
@@ -1056,6 +1076,43 @@ LIGHT(iterator_destroy)(struct LIGHT(core) *ht, struct LIGHT(iterator) *itr)
 	matras_destroy_read_view(&ht->mtable, &itr->view);
 }
 
+static inline int
+LIGHT(reserve)(struct LIGHT(core) *ht, uint32_t size)
+{
+	if (size <= ht->table_size)
+		return 0;
+	if (ht->table_size == 0 && LIGHT(prepare_first_insert)(ht) != 0)
+		return -1;
+	/*
+	 * Growing doesn't depend on the number of empty slots, so
+	 * it can be done ahead of time. Each step splits the chains
+	 * the same way an insertion into a full table does.
+	 */
+	while (ht->table_size < size) {
+		if (LIGHT(grow)(ht) != 0)
+			return -1;
+	}
+	return 0;
+}
+
+static inline uint32_t
+LIGHT(chain_length)(const struct LIGHT(core) *ht, uint32_t slotpos)
+{
+	assert(slotpos < ht->table_size);
+	struct LIGHT(record) *record = (struct LIGHT(record) *)
+		matras_get(&ht->mtable, slotpos);
+	if (record->next == slotpos ||
+	    LIGHT(slot)(ht, record->hash) != slotpos)
+		return 0;
+	uint32_t length = 1;
+	while (record->next != LIGHT(end)) {
+		record = (struct LIGHT(record) *)
+			matras_get(&ht->mtable, record->next);
+		length++;
+	}
+	return length;
+}
+
 /*
  * Selfcheck of the internal state of hash table. Used only for debugging.
  * That means that you should not use this function.
@@ -29,6 +29,8 @@
  * SUCH DAMAGE.
  */
 #include "rtree.h"
+#include <qsort_arg.h>
+#include <stdlib.h>
 #include <string.h>
 #include <assert.h>
 #include <limits.h>
@@ -75,18 +77,25 @@ struct rtree_reinsert_list {
 	int level;
 };
 
-static int
-neighbor_cmp(const struct rtree_neighbor *a, const struct rtree_neighbor *b)
+static bool
+neighbor_less(const struct rtree_neighbor *a, const struct rtree_neighbor *b)
 {
-	return a->distance < b->distance ? -1 :
-	       a->distance > b->distance ? 1 :
-	       a->level < b->level ? -1 :
-	       a->level > b->level ? 1 :
-	       a < b ? -1 : a > b ? 1 : 0;
-	return 0;
+	return a->distance < b->distance ? true :
+	       a->distance > b->distance ? false :
+	       a->level < b->level ? true :
+	       a->level > b->level ? false :
+	       a < b;
 }
 
-rb_gen(, rtnt_, rtnt_t, struct rtree_neighbor, link, neighbor_cmp);
+#define HEAP_NAME rtnt
+#define HEAP_LESS(h, a, b) neighbor_less(a, b)
+#define heap_value_t struct rtree_neighbor
+#define heap_value_attr in_heap
+#include "salad/heap.h"
+#undef HEAP_NAME
+#undef HEAP_LESS
+#undef heap_value_t
+#undef heap_value_attr
 
 /*------------------------------------------------------------------------- */
 /* R-tree rectangle methods */
@@ -132,6 +141,19 @@ rtree_set2dp(struct rtree_rect *rect, coord_t x, coord_t y)
 	rect->coords[3] = y;
 }
 
+/*
+ * Distance from a coordinate to a segment, 0 if it's inside.
+ * Computed without branches, because the comparison outcome is
+ * random for the children of a page.
+ */
+static inline sq_coord_t
+rtree_rect_neigh_diff(const coord_t *coords, coord_t neigh_coord)
+{
+	coord_t below = coords[0] - neigh_coord;
+	coord_t above = neigh_coord - coords[1];
+	return (sq_coord_t)((below > 0 ? below : 0) + (above > 0 ? above : 0));
+}
+
 /* Manhattan distance */
 static sq_coord_t
 rtree_rect_neigh_distance(const struct rtree_rect *rect,
@@ -140,15 +162,8 @@ rtree_rect_neigh_distance(const struct rtree_rect *rect,
 {
 	sq_coord_t result = 0;
 	for (int i = dimension; --i >= 0; ) {
-		const coord_t *coords = &rect->coords[2 * i];
-		coord_t neigh_coord = neigh_rect->coords[2 * i];
-		if (neigh_coord < coords[0]) {
-			sq_coord_t diff = (sq_coord_t)(neigh_coord - coords[0]);
-			result += -diff;
-		} else if (neigh_coord > coords[1]) {
-			sq_coord_t diff = (sq_coord_t)(neigh_coord - coords[1]);
-			result += diff;
-		}
+		result += rtree_rect_neigh_diff(&rect->coords[2 * i],
+						neigh_rect->coords[2 * i]);
 	}
 	return result;
 }
@@ -161,15 +176,9 @@ rtree_rect_neigh_distance2(const struct rtree_rect *rect,
 {
 	sq_coord_t result = 0;
 	for (int i = dimension; --i >= 0; ) {
-		const coord_t *coords = &rect->coords[2 * i];
-		coord_t neigh_coord = neigh_rect->coords[2 * i];
-		if (neigh_coord < coords[0]) {
-			sq_coord_t diff = (sq_coord_t)(neigh_coord - coords[0]);
-			result += diff * diff;
-		} else if (neigh_coord > coords[1]) {
-			sq_coord_t diff = (sq_coord_t)(neigh_coord - coords[1]);
-			result += diff * diff;
-		}
+		sq_coord_t diff = rtree_rect_neigh_diff(&rect->coords[2 * i],
+							neigh_rect->coords[2 * i]);
+		result += diff * diff;
 	}
 	return result;
 }
@@ -795,23 +804,9 @@ rtree_iterator_destroy(struct rtree_iterator *itr)
 	}
 	itr->page_list = NULL;
 	itr->page_pos = INT_MAX;
-}
-
-struct rtree_neighbor *
-rtree_iterator_reset_cb(rtnt_t *t, struct rtree_neighbor *n, void *d)
-{
-	(void) t;
-	struct rtree_iterator *itr = (struct rtree_iterator *)d;
-	n->next = itr->neigh_free_list;
-	itr->neigh_free_list = n;
-	return 0;
-}
-
-static void
-rtree_iterator_reset(struct rtree_iterator *itr)
-{
-	rtnt_iter(&itr->neigh_tree, 0, rtree_iterator_reset_cb, (void *)itr);
-	rtnt_new(&itr->neigh_tree);
+	itr->neigh_free_list = NULL;
+	rtnt_destroy(&itr->neigh_heap);
+	rtnt_create(&itr->neigh_heap);
 }
 
 static struct rtree_neighbor *
@@ -851,17 +846,32 @@ rtree_iterator_free_neighbor(struct rtree_iterator *itr,
 	itr->neigh_free_list = n;
 }
 
+static void
+rtree_iterator_reset(struct rtree_iterator *itr)
+{
+	struct heap_iterator it;
+	rtnt_iterator_init(&itr->neigh_heap, &it);
+	struct rtree_neighbor *n;
+	while ((n = rtnt_iterator_next(&it)) != NULL)
+		rtree_iterator_free_neighbor(itr, n);
+	itr->neigh_heap.size = 0;
+}
+
 void
 rtree_iterator_init(struct rtree_iterator *itr)
 {
 	itr->tree = 0;
-	rtnt_new(&itr->neigh_tree);
+	rtnt_create(&itr->neigh_heap);
 	itr->neigh_free_list = NULL;
 	itr->page_list = NULL;
 	itr->page_pos = INT_MAX;
 }
 
-static void
+/*
+ * Replace a page popped from the heap with its children.
+ * Returns -1 if the heap couldn't grow.
+ */
+static int
 rtree_iterator_process_neigh(struct rtree_iterator *itr,
 			     struct rtree_neighbor *neighbor)
 {
@@ -870,11 +880,12 @@ rtree_iterator_process_neigh(struct rtree_iterator *itr,
 	struct rtree_page *pg = (struct rtree_page *)child;
 	int level = neighbor->level;
 	rtree_iterator_free_neighbor(itr, neighbor);
+	bool is_euclid = itr->tree->distance_type == RTREE_EUCLID;
 	for (int i = 0, n = pg->n; i < n; i++) {
 		struct rtree_page_branch *b;
 		b = rtree_branch_get(itr->tree, pg, i);
 		coord_t distance;
-		if (itr->tree->distance_type == RTREE_EUCLID)
+		if (is_euclid)
 			distance = rtree_rect_neigh_distance2(&b->rect,
 							      &itr->rect, d);
 		else
@@ -883,8 +894,12 @@ rtree_iterator_process_neigh(struct rtree_iterator *itr,
 		struct rtree_neighbor *neigh =
 			rtree_iterator_new_neighbor(itr, b->data.page,
 						    distance, level - 1);
-		rtnt_insert(&itr->neigh_tree, neigh);
+		if (rtnt_insert(&itr->neigh_heap, neigh) != 0) {
+			rtree_iterator_free_neighbor(itr, neigh);
+			return -1;
+		}
 	}
+	return 0;
 }
 
 
@@ -912,16 +927,21 @@ rtree_iterator_next(struct rtree_iterator *itr)
 		*/
 		while (true) {
 			struct rtree_neighbor *neighbor =
-				rtnt_first(&itr->neigh_tree);
+				rtnt_pop(&itr->neigh_heap);
 			if (neighbor == NULL)
 				return NULL;
-			rtnt_remove(&itr->neigh_tree, neighbor);
 			if (neighbor->level == 0) {
 				void *child = neighbor->child;
 				rtree_iterator_free_neighbor(itr, neighbor);
 				return (record_t)child;
-			} else {
-				rtree_iterator_process_neigh(itr, neighbor);
+			} else if (rtree_iterator_process_neigh(itr,
+								neighbor) != 0) {
+				/*
+				 * Out of memory: the order can't be
+				 * kept anymore, stop the iteration.
+				 */
+				rtree_iterator_reset(itr);
+				return NULL;
 			}
 		}
 	}
@@ -1109,7 +1129,10 @@ rtree_search(const struct rtree *tree, const struct rtree_rect *rect,
 				rtree_iterator_new_neighbor(itr, tree->root,
 							    distance,
 							    tree->height);
-			rtnt_insert(&itr->neigh_tree, n);
+			if (rtnt_insert(&itr->neigh_heap, n) != 0) {
+				rtree_iterator_free_neighbor(itr, n);
+				return false;
+			}
 			return true;
 		} else {
 			return false;
@@ -1138,6 +1161,216 @@ rtree_purge(struct rtree *tree)
 	}
 }
 
+/*------------------------------------------------------------------------- */
+/* R-tree bulk loading */
+/*------------------------------------------------------------------------- */
+
+void
+rtree_builder_create(struct rtree_builder *builder)
+{
+	builder->buf = NULL;
+	builder->count = 0;
+	builder->capacity = 0;
+}
+
+void
+rtree_builder_destroy(struct rtree_builder *builder)
+{
+	free(builder->buf);
+	rtree_builder_create(builder);
+}
+
+int
+rtree_builder_reserve(struct rtree_builder *builder, const struct rtree *tree,
+		      size_t count)
+{
+	if (count <= builder->capacity)
+		return 0;
+	char *buf = (char *)realloc(builder->buf,
+				    count * tree->page_branch_size);
+	if (buf == NULL)
+		return -1;
+	builder->buf = buf;
+	builder->capacity = count;
+	return 0;
+}
+
+int
+rtree_builder_add(struct rtree_builder *builder, const struct rtree *tree,
+		  const struct rtree_rect *rect, record_t obj)
+{
+	if (builder->count == builder->capacity &&
+	    rtree_builder_reserve(builder, tree, builder->capacity < 64 ? 64 :
+				  builder->capacity + builder->capacity / 2) != 0)
+		return -1;
+	struct rtree_page_branch *b = (struct rtree_page_branch *)
+		(builder->buf + builder->count++ * tree->page_branch_size);
+	b->data.record = obj;
+	rtree_rect_copy(&b->rect, rect, tree->dimension);
+	return 0;
+}
+
+/* Number of pages needed to pack given number of branches to one level */
+static size_t
+rtree_bulk_page_count(const struct rtree *tree, size_t count)
+{
+	return (count + tree->page_max_fill - 1) / tree->page_max_fill;
+}
+
+/*
+ * Index of the first branch of a page. Branches are spread evenly, so
+ * every page of a level except the root is at least half full, which
+ * is more than page_min_fill.
+ */
+static size_t
+rtree_bulk_page_start(size_t count, size_t pages, size_t page)
+{
+	return count * page / pages;
+}
+
+/* Smallest number of slabs s such that s^dims >= pages */
+static size_t
+rtree_bulk_slab_count(size_t pages, unsigned dims)
+{
+	for (size_t s = 1; ; s++) {
+		size_t p = 1;
+		for (unsigned i = 0; i < dims && p < pages; i++)
+			p *= s;
+		if (p >= pages)
+			return s;
+	}
+}
+
+/* Compare centers of branch rectangles along a dimension */
+static int
+rtree_bulk_branch_cmp(const void *a, const void *b, void *arg)
+{
+	unsigned d = *(unsigned *)arg;
+	const struct rtree_page_branch *ba = (const struct rtree_page_branch *)a;
+	const struct rtree_page_branch *bb = (const struct rtree_page_branch *)b;
+	coord_t ca = ba->rect.coords[d * 2] + ba->rect.coords[d * 2 + 1];
+	coord_t cb = bb->rect.coords[d * 2] + bb->rect.coords[d * 2 + 1];
+	return ca < cb ? -1 : ca > cb;
+}
+
+/*
+ * Order branches of pages [page_begin, page_end) of a level, so that
+ * every page gets a tile of close rectangles.
+ */
+static void
+rtree_bulk_sort(const struct rtree *tree, char *buf, size_t count,
+		size_t pages, size_t page_begin, size_t page_end, unsigned dim)
+{
+	size_t begin = rtree_bulk_page_start(count, pages, page_begin);
+	size_t end = rtree_bulk_page_start(count, pages, page_end);
+	qsort_arg(buf + begin * tree->page_branch_size, end - begin,
+		  tree->page_branch_size, rtree_bulk_branch_cmp, &dim);
+	if (dim + 1 == tree->dimension || page_end - page_begin <= 1)
+		return;
+	size_t n = page_end - page_begin;
+	size_t slabs = rtree_bulk_slab_count(n, tree->dimension - dim);
+	for (size_t i = 0; i < slabs; i++) {
+		size_t slab_begin = page_begin + n * i / slabs;
+		size_t slab_end = page_begin + n * (i + 1) / slabs;
+		if (slab_begin < slab_end)
+			rtree_bulk_sort(tree, buf, count, pages,
+					slab_begin, slab_end, dim + 1);
+	}
+}
+
+/*
+ * Pack count branches of the buffer to pages of the given level
+ * (1 for leaves). Branches pointing to the new pages are written to
+ * the beginning of the buffer. On failure, frees all pages reachable
+ * from the buffer.
+ */
+static int
+rtree_bulk_load_level(struct rtree *tree, char *buf, size_t count,
+		      size_t pages, int level)
+{
+	unsigned stride = tree->page_branch_size;
+	rtree_bulk_sort(tree, buf, count, pages, 0, pages, 0);
+	for (size_t i = 0; i < pages; i++) {
+		size_t begin = rtree_bulk_page_start(count, pages, i);
+		size_t end = rtree_bulk_page_start(count, pages, i + 1);
+		struct rtree_page *page = rtree_page_alloc(tree);
+		if (page == NULL) {
+			for (size_t j = 0; j < i; j++) {
+				struct rtree_page_branch *b =
+					(struct rtree_page_branch *)
+					(buf + j * stride);
+				rtree_page_purge(tree, b->data.page, level);
+			}
+			for (size_t j = begin; j < count && level > 1; j++) {
+				struct rtree_page_branch *b =
+					(struct rtree_page_branch *)
+					(buf + j * stride);
+				rtree_page_purge(tree, b->data.page,
+						 level - 1);
+			}
+			return -1;
+		}
+		page->n = end - begin;
+		for (size_t j = begin; j < end; j++) {
+			rtree_branch_copy(rtree_branch_get(tree, page, j - begin),
+					  (struct rtree_page_branch *)
+					  (buf + j * stride), tree->dimension);
+		}
+		/*
+		 * The branch of the page is written over the already
+		 * copied ones, because i <= begin.
+		 */
+		struct rtree_page_branch *b =
+			(struct rtree_page_branch *)(buf + i * stride);
+		b->data.page = page;
+		rtree_page_cover(tree, page, &b->rect);
+	}
+	return 0;
+}
+
+int
+rtree_builder_load(struct rtree_builder *builder, struct rtree *tree)
+{
+	assert(tree->root == NULL);
+	size_t n_records = builder->count;
+	size_t count = n_records;
+	builder->count = 0;
+	if (count == 0)
+		return 0;
+	int level = 0;
+	size_t n_pages = 0;
+	do {
+		size_t pages = rtree_bulk_page_count(tree, count);
+		if (rtree_bulk_load_level(tree, builder->buf, count,
+					  pages, ++level) != 0)
+			return -1;
+		n_pages += pages;
+		count = pages;
+	} while (count > 1);
+	assert(level <= RTREE_MAX_HEIGHT);
+	struct rtree_page_branch *root =
+		(struct rtree_page_branch *)builder->buf;
+	tree->root = root->data.page;
+	tree->height = level;
+	tree->n_pages = n_pages;
+	tree->n_records = n_records;
+	tree->version++;
+	return 0;
+}
+
+size_t
+rtree_bulk_load_page_count(const struct rtree *tree, size_t count)
+{
+	size_t total = 0;
+	if (count == 0)
+		return 0;
+	do {
+		count = rtree_bulk_page_count(tree, count);
+		total += count;
+	} while (count > 1);
+	return total;
+}
+
 size_t
 rtree_used_size(const struct rtree *tree)
 {
@@ -34,8 +34,8 @@
 #include <stdbool.h>
 #include "small/matras.h"
 
-#define RB_COMPACT 1
-#include "small/rb.h"
+#define HEAP_FORWARD_DECLARATION
+#include "salad/heap.h"
 
 /**
  * In-memory Guttman's R-tree
@@ -55,15 +55,13 @@ extern "C" {
 #endif /* defined(__cplusplus) */
 
 struct rtree_neighbor {
-	rb_node(struct rtree_neighbor) link;
+	struct heap_node in_heap;
 	struct rtree_neighbor *next;
 	void *child;
 	int level;
 	sq_coord_t distance;
 };
 
-typedef rb_tree(struct rtree_neighbor) rtnt_t;
-
 enum {
 	/** Maximal possible R-tree height */
 	RTREE_MAX_HEIGHT = 16,
@@ -154,6 +152,20 @@ struct rtree
 	enum rtree_distance_type distance_type;
 };
 
+/**
+ * Buffer of records for bulk loading of a tree.
+ * @sa rtree_builder_add(), rtree_builder_load().
+ */
+struct rtree_builder
+{
+	/* Records with their rectangles, tree->page_branch_size each */
+	char *buf;
+	/* Number of records in the buffer */
+	size_t count;
+	/* Number of records the buffer can hold */
+	size_t capacity;
+};
+
 /* Struct for iteration and retrieving rtree values */
 struct rtree_iterator
 {
@@ -168,13 +180,13 @@ struct rtree_iterator
 	/* A verion of a tree when the iterator was created */
 	unsigned version;
 
-	/* Special rb tree of closest neqighbors
+	/* Binary heap of closest neighbors, the closest is on top.
 	 * Used only for iteration with op = SOP_NEIGHBOR
 	 * For allocating list entries, page allocator of tree is used.
 	 * Allocated page is much bigger than list entry and thus
 	 * provides several list entries.
 	 */
-	rtnt_t neigh_tree;
+	heap_t neigh_heap;
 	/* List of unused (deleted) list entries */
 	struct rtree_neighbor *neigh_free_list;
 	/* List of tree pages, allocated for list entries */
@@ -285,6 +297,67 @@ rtree_insert(struct rtree *tree, struct rtree_rect *rect, record_t obj);
 bool
 rtree_remove(struct rtree *tree, const struct rtree_rect *rect, record_t obj);
 
+/**
+ * @brief Initialize a bulk load buffer
+ * @param builder - pointer to a buffer
+ */
+void
+rtree_builder_create(struct rtree_builder *builder);
+
+/**
+ * @brief Free a bulk load buffer
+ * @param builder - pointer to a buffer
+ */
+void
+rtree_builder_destroy(struct rtree_builder *builder);
+
+/**
+ * @brief Make sure that the buffer can hold the given number of records
+ * @param builder - pointer to a buffer
+ * @param tree - pointer to a tree the records are for
+ * @param count - number of records
+ * @return 0 on success, -1 on memory error
+ */
+int
+rtree_builder_reserve(struct rtree_builder *builder, const struct rtree *tree,
+		      size_t count);
+
+/**
+ * @brief Add a record to the buffer
+ * @param builder - pointer to a buffer
+ * @param tree - pointer to a tree the records are for
+ * @param rect - rectangle of the record
+ * @param obj - record to add
+ * @return 0 on success, -1 on memory error
+ */
+int
+rtree_builder_add(struct rtree_builder *builder, const struct rtree *tree,
+		  const struct rtree_rect *rect, record_t obj);
+
+/**
+ * @brief Load all records of the buffer to an empty tree.
+ * Records are packed to full pages with the Sort-Tile-Recursive
+ * algorithm: sorted by the center along the first dimension, cut to
+ * slabs, each slab sorted along the next dimension and so on. Upper
+ * levels are packed the same way. It is faster than inserting records
+ * one by one, and the pages overlap less.
+ * The buffer is consumed and becomes empty.
+ * @param builder - pointer to a buffer
+ * @param tree - pointer to an empty tree
+ * @return 0 on success, -1 if a page allocation failed. In the latter
+ * case the tree stays empty.
+ */
+int
+rtree_builder_load(struct rtree_builder *builder, struct rtree *tree);
+
+/**
+ * @brief Number of pages rtree_builder_load() allocates
+ * @param tree - pointer to a tree
+ * @param count - number of records
+ */
+size_t
+rtree_bulk_load_page_count(const struct rtree *tree, size_t count);
+
 /**
  * @brief Size of memory used by tree
  * @param tree - pointer to a tree
@@ -667,8 +667,9 @@ error:
 }
 
 /**
- * On a new EV_READ event receive an encrypted packet from the
- * network.
+ * On a new EV_READ event receive encrypted packets from the
+ * network. At most SWIM_RECV_BATCH_SIZE packets are received, until
+ * the socket is empty.
  */
 static void
 swim_on_encrypted_input(struct ev_loop *loop, struct ev_io *io, int events)
@@ -681,26 +682,36 @@ swim_on_encrypted_input(struct ev_loop *loop, struct ev_io *io, int events)
 	 */
 	char buf[UDP_PACKET_SIZE];
 	swim_begin_recv(scheduler, loop, io, events);
-
-	char *ibuf = static_alloc(UDP_PACKET_SIZE);
-	assert(ibuf != NULL);
-	ssize_t size = swim_do_recv(scheduler, ibuf, UDP_PACKET_SIZE);
-	if (size > 0) {
+	for (int i = 0; i < SWIM_RECV_BATCH_SIZE; ++i) {
+		char *ibuf = static_alloc(UDP_PACKET_SIZE);
+		assert(ibuf != NULL);
+		ssize_t size = swim_do_recv(scheduler, ibuf, UDP_PACKET_SIZE);
+		if (size <= 0) {
+			swim_complete_recv(scheduler, buf, size);
+			return;
+		}
 		size = swim_decrypt(scheduler->codec, ibuf, size,
 				    buf, UDP_PACKET_SIZE);
+		swim_complete_recv(scheduler, buf, size);
 	}
-	swim_complete_recv(scheduler, buf, size);
 }
 
-/** On a new EV_READ event receive a packet from the network. */
+/**
+ * On a new EV_READ event receive packets from the network, like
+ * swim_on_encrypted_input() does.
+ */
 static void
 swim_on_plain_input(struct ev_loop *loop, struct ev_io *io, int events)
 {
 	struct swim_scheduler *scheduler = (struct swim_scheduler *) io->data;
 	char buf[UDP_PACKET_SIZE];
 	swim_begin_recv(scheduler, loop, io, events);
-	ssize_t size = swim_do_recv(scheduler, buf, UDP_PACKET_SIZE);
-	swim_complete_recv(scheduler, buf, size);
+	for (int i = 0; i < SWIM_RECV_BATCH_SIZE; ++i) {
+		ssize_t size = swim_do_recv(scheduler, buf, UDP_PACKET_SIZE);
+		swim_complete_recv(scheduler, buf, size);
+		if (size <= 0)
+			return;
+	}
 }
 
 int
@@ -69,7 +69,15 @@ enum {
 	 */
 	MAX_PACKET_SIZE = UDP_PACKET_SIZE - CRYPTO_MAX_BLOCK_SIZE -
 			  CRYPTO_MAX_IV_SIZE,
-
+	/**
+	 * Maximal number of packets received on one EV_READ
+	 * event. In big clusters a member gets lots of pings,
+	 * acks and forwarded packets per round, and receiving
+	 * them one per event loop iteration costs an extra poll
+	 * per packet. Sends are not batched, because a send
+	 * completion can delete the SWIM instance.
+	 */
+	SWIM_RECV_BATCH_SIZE = 16,
 };
 
 /**
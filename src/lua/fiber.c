@@ -400,6 +400,73 @@ lbox_fiber_top_disable(struct lua_State *L)
 }
 #endif /* ENABLE_FIBER_TOP */
 
+static int
+lbox_fiber_loop_stat(struct lua_State *L)
+{
+	struct loop_stat *stat = &cord()->loop_stat;
+	if (!stat->is_enabled) {
+		luaL_error(L, "fiber.loop_stat() is disabled. Enable it with"
+			      " fiber.loop_stat_enable() first");
+	}
+	lua_newtable(L);
+	lua_pushnumber(L, stat->utilization);
+	lua_setfield(L, -2, "utilization");
+	lua_pushnumber(L, stat->busy_time);
+	lua_setfield(L, -2, "busy_time");
+	lua_pushnumber(L, stat->idle_time);
+	lua_setfield(L, -2, "idle_time");
+	lua_pushinteger(L, loop_stat_ready_count());
+	lua_setfield(L, -2, "ready");
+
+	lua_newtable(L);
+	luaL_pushuint64(L, stat->run_count);
+	lua_setfield(L, -2, "count");
+	lua_pushnumber(L, loop_stat_run_percentile(50));
+	lua_setfield(L, -2, "p50");
+	lua_pushnumber(L, loop_stat_run_percentile(99));
+	lua_setfield(L, -2, "p99");
+	lua_pushnumber(L, loop_stat_run_percentile(99.9));
+	lua_setfield(L, -2, "p999");
+	lua_pushnumber(L, stat->longest[0].duration);
+	lua_setfield(L, -2, "max");
+	lua_setfield(L, -2, "runs");
+
+	lua_newtable(L);
+	for (int i = 0; i < LOOP_STAT_LONGEST_RUN_COUNT; i++) {
+		struct loop_stat_run *run = &stat->longest[i];
+		if (run->duration == 0)
+			break;
+		lua_newtable(L);
+		luaL_pushuint64(L, run->fid);
+		lua_setfield(L, -2, "fid");
+		lua_pushstring(L, run->name);
+		lua_setfield(L, -2, "name");
+		lua_pushnumber(L, run->duration);
+		lua_setfield(L, -2, "duration");
+		lua_pushnumber(L, run->end_time);
+		lua_setfield(L, -2, "time");
+		lua_rawseti(L, -2, i + 1);
+	}
+	lua_setfield(L, -2, "longest");
+	return 1;
+}
+
+static int
+lbox_fiber_loop_stat_enable(struct lua_State *L)
+{
+	(void)L;
+	loop_stat_enable();
+	return 0;
+}
+
+static int
+lbox_fiber_loop_stat_disable(struct lua_State *L)
+{
+	(void)L;
+	loop_stat_disable();
+	return 0;
+}
+
 #ifdef ENABLE_BACKTRACE
 bool
 lbox_do_backtrace(struct lua_State *L)
@@ -895,6 +962,9 @@ static const struct luaL_Reg fiberlib[] = {
 	{"top_enable", lbox_fiber_top_enable},
 	{"top_disable", lbox_fiber_top_disable},
 #endif /* ENABLE_FIBER_TOP */
+	{"loop_stat", lbox_fiber_loop_stat},
+	{"loop_stat_enable", lbox_fiber_loop_stat_enable},
+	{"loop_stat_disable", lbox_fiber_loop_stat_disable},
 	{"sleep", lbox_fiber_sleep},
 	{"yield", lbox_fiber_yield},
 	{"self", lbox_fiber_self},
@@ -320,6 +320,11 @@ luaT_httpc_request(lua_State *L)
 		httpc_set_accept_encoding(req, lua_tostring(L, -1));
 	lua_pop(L, 1);
 
+	lua_getfield(L, 5, "http2");
+	if (!lua_isnil(L, -1) && lua_isboolean(L, -1))
+		httpc_set_http2(req, lua_toboolean(L, -1));
+	lua_pop(L, 1);
+
 	if (httpc_execute(req, timeout) != 0) {
 		httpc_request_delete(req);
 		return luaT_error(L);
@@ -348,16 +353,10 @@ luaT_httpc_request(lua_State *L)
 			diag_log();
 	}
 
-	size_t body_len = region_used(&req->resp_body);
+	size_t body_len = ibuf_used(&req->resp_body);
 	if (body_len > 0) {
-		char *body = region_join(&req->resp_body, body_len);
-		if (body == NULL) {
-			diag_set(OutOfMemory, body_len, "region", "body");
-			httpc_request_delete(req);
-			return luaT_error(L);
-		}
 		lua_pushstring(L, "body");
-		lua_pushlstring(L, body, body_len);
+		lua_pushlstring(L, req->resp_body.rpos, body_len);
 		lua_settable(L, -3);
 	}
 
@@ -296,6 +296,9 @@ end
 --      accept_encoding - enables automatic decompression of HTTP
 --          responses;
 --
+--      http2 - prefer HTTP/2 for HTTPS requests and multiplex
+--          requests to the same host over one connection;
+--
 --  Returns:
 --      {
 --          status=NUMBER,
@@ -24,7 +24,7 @@ ffi.cdef[[
 
     extern void
     say_logger_init(const char *init_str, int level, int nonblock,
-                    const char *format, int background);
+                    int async, const char *format, int background);
 
     extern bool
     say_logger_initialized(void);
@@ -129,6 +129,7 @@ end
 local log_cfg = {
     log             = nil,
     nonblock        = nil,
+    async           = nil,
     level           = S_INFO,
     format          = fmt_num2str[ffi.C.SF_PLAIN],
 }
@@ -139,6 +140,7 @@ local log_cfg = {
 local log2box_keys = {
     ['log']             = 'log',
     ['nonblock']        = 'log_nonblock',
+    ['async']           = 'log_async',
     ['level']           = 'log_level',
     ['format']          = 'log_format',
 }
@@ -146,6 +148,7 @@ local log2box_keys = {
 local box2log_keys = {
     ['log']             = 'log',
     ['log_nonblock']    = 'nonblock',
+    ['log_async']       = 'async',
     ['log_level']       = 'level',
     ['log_format']      = 'format',
 }
@@ -181,6 +184,7 @@ end
 local cfg_static_keys = {
     log         = true,
     nonblock    = true,
+    async       = true,
 }
 
 -- Test if static key is not changed.
@@ -263,6 +267,7 @@ end
 local verify_ops = {
     ['log']         = verify_static,
     ['nonblock']    = verify_static,
+    ['async']       = verify_static,
     ['format']      = verify_format,
     ['level']       = verify_level,
 }
@@ -511,6 +516,12 @@ local function load_cfg(self, cfg)
         end
     end
 
+    if cfg.async ~= nil then
+        if type(cfg.async) ~= 'boolean' then
+            error("log.cfg: 'async' option must be 'true' or 'false'")
+        end
+    end
+
     if ffi.C.say_logger_initialized() == true then
         return reload_cfg(cfg)
     end
@@ -518,6 +529,7 @@ local function load_cfg(self, cfg)
     cfg.level = cfg.level or log_cfg.level
     cfg.format = cfg.format or log_cfg.format
     cfg.nonblock = cfg.nonblock or log_cfg.nonblock
+    cfg.async = cfg.async or log_cfg.async
 
     -- nonblock is special: it has to become integer
     -- for ffi call but in config we have to save
@@ -539,7 +551,7 @@ local function load_cfg(self, cfg)
     -- mode since we don't know how the box will be configured
     -- later.
     ffi.C.say_logger_init(cfg.log, cfg.level,
-                          nonblock, cfg.format, 0)
+                          nonblock, cfg.async and 1 or 0, cfg.format, 0)
 
     if nonblock == 1 then
         nonblock = true
@@ -552,13 +564,15 @@ local function load_cfg(self, cfg)
     rawset(log_cfg, 'log', cfg.log)
     rawset(log_cfg, 'level', cfg.level)
     rawset(log_cfg, 'nonblock', nonblock)
+    rawset(log_cfg, 'async', cfg.async or nil)
     rawset(log_cfg, 'format', cfg.format)
 
     -- and box.cfg output as well.
     box_cfg_update()
 
-    local m = "log.cfg({log=%s,level=%s,nonblock=%s,format=\'%s\'})"
-    say(S_DEBUG, m:format(cfg.log, cfg.level, cfg.nonblock, cfg.format))
+    local m = "log.cfg({log=%s,level=%s,nonblock=%s,async=%s,format=\'%s\'})"
+    say(S_DEBUG, m:format(cfg.log, cfg.level, cfg.nonblock, cfg.async,
+                          cfg.format))
 end
 
 local compat_warning_said = false
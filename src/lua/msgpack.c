@@ -569,6 +569,443 @@ lua_decode_map_header(lua_State *L)
 	return 2;
 }
 
+/* {{{ Compiled schemas */
+
+/**
+ * Name of the Lua type of a compiled schema returned by
+ * msgpack.compile().
+ */
+static const char luamp_schema_typename[] = "msgpack.schema";
+
+/** Type of a field of a compiled schema. */
+enum luamp_schema_type {
+	LUAMP_SCHEMA_ANY,
+	LUAMP_SCHEMA_UNSIGNED,
+	LUAMP_SCHEMA_INTEGER,
+	LUAMP_SCHEMA_NUMBER,
+	LUAMP_SCHEMA_DOUBLE,
+	LUAMP_SCHEMA_STRING,
+	LUAMP_SCHEMA_BOOLEAN,
+	luamp_schema_type_MAX,
+};
+
+static const char *luamp_schema_type_strs[] = {
+	/* [LUAMP_SCHEMA_ANY]		= */ "any",
+	/* [LUAMP_SCHEMA_UNSIGNED]	= */ "unsigned",
+	/* [LUAMP_SCHEMA_INTEGER]	= */ "integer",
+	/* [LUAMP_SCHEMA_NUMBER]	= */ "number",
+	/* [LUAMP_SCHEMA_DOUBLE]	= */ "double",
+	/* [LUAMP_SCHEMA_STRING]	= */ "string",
+	/* [LUAMP_SCHEMA_BOOLEAN]	= */ "boolean",
+};
+
+struct luamp_schema_field {
+	enum luamp_schema_type type;
+	bool is_nullable;
+};
+
+/**
+ * A fixed record layout. A record is encoded as a MsgPack array
+ * of its fields in the schema order, without the field names, and
+ * is decoded back into a Lua table with the field names as keys.
+ * Since the layout is known in advance, neither the encoder nor
+ * the decoder has to inspect the table or the array to find out
+ * their shape.
+ */
+struct luamp_schema {
+	/** Serializer that created the schema. */
+	struct luaL_serializer *cfg;
+	/** Reference to the serializer, to keep it alive. */
+	int cfg_ref;
+	/** Reference to the array of the field names. */
+	int names_ref;
+	uint32_t field_count;
+	struct luamp_schema_field fields[0];
+};
+
+static struct luamp_schema *
+luamp_check_schema(struct lua_State *L, int idx)
+{
+	return (struct luamp_schema *)
+		luaL_checkudata(L, idx, luamp_schema_typename);
+}
+
+/**
+ * Raise an error about a value of the field @a fieldno that
+ * doesn't match the schema.
+ */
+static int
+luamp_schema_field_error(struct lua_State *L, struct luamp_schema *schema,
+			 uint32_t fieldno, const char *func_name)
+{
+	lua_rawgeti(L, LUA_REGISTRYINDEX, schema->names_ref);
+	lua_rawgeti(L, -1, fieldno + 1);
+	struct luamp_schema_field *field = &schema->fields[fieldno];
+	return luaL_error(L, "%s: field '%s' must be %s%s", func_name,
+			  lua_tostring(L, -1),
+			  luamp_schema_type_strs[field->type],
+			  field->is_nullable ? " or nil" : "");
+}
+
+/**
+ * Encode the field @a fieldno of a record, which is on the top of
+ * the Lua stack.
+ */
+static void
+luamp_schema_encode_field(struct lua_State *L, struct luamp_schema *schema,
+			  uint32_t fieldno, struct mpstream *stream)
+{
+	struct luamp_schema_field *f = &schema->fields[fieldno];
+	int idx = lua_gettop(L);
+	int type = lua_type(L, idx);
+	if (type == LUA_TNIL) {
+		if (!f->is_nullable && f->type != LUAMP_SCHEMA_ANY)
+			goto error;
+		mpstream_encode_nil(stream);
+		return;
+	}
+	switch (f->type) {
+	case LUAMP_SCHEMA_ANY:
+		luamp_encode(L, schema->cfg, stream, idx);
+		return;
+	case LUAMP_SCHEMA_STRING: {
+		if (type != LUA_TSTRING)
+			goto error;
+		size_t len;
+		const char *str = lua_tolstring(L, idx, &len);
+		mpstream_encode_strn(stream, str, len);
+		return;
+	}
+	case LUAMP_SCHEMA_BOOLEAN:
+		if (type != LUA_TBOOLEAN)
+			goto error;
+		mpstream_encode_bool(stream, lua_toboolean(L, idx));
+		return;
+	case LUAMP_SCHEMA_DOUBLE:
+		if (type != LUA_TNUMBER)
+			goto error;
+		mpstream_encode_double(stream, lua_tonumber(L, idx));
+		return;
+	default:
+		break;
+	}
+	/*
+	 * Integers may be Lua numbers or 64-bit cdata, let the
+	 * serializer convert them the way msgpack.encode() does.
+	 */
+	struct luaL_field field;
+	if (luaL_tofield(L, schema->cfg, idx, &field) < 0)
+		luaT_error(L);
+	switch (field.type) {
+	case MP_UINT:
+		mpstream_encode_uint(stream, field.ival);
+		return;
+	case MP_INT:
+		if (f->type == LUAMP_SCHEMA_UNSIGNED)
+			goto error;
+		mpstream_encode_int(stream, field.ival);
+		return;
+	case MP_FLOAT:
+		if (f->type != LUAMP_SCHEMA_NUMBER)
+			goto error;
+		mpstream_encode_float(stream, field.fval);
+		return;
+	case MP_DOUBLE:
+		if (f->type != LUAMP_SCHEMA_NUMBER)
+			goto error;
+		mpstream_encode_double(stream, field.dval);
+		return;
+	default:
+		break;
+	}
+error:
+	luamp_schema_field_error(L, schema, fieldno, "msgpack.schema.encode");
+}
+
+/**
+ * schema:encode(record[, ibuf]) -> string or number of bytes
+ * written to the buffer.
+ */
+static int
+lua_msgpack_schema_encode(struct lua_State *L)
+{
+	struct luamp_schema *schema = luamp_check_schema(L, 1);
+	int index = lua_gettop(L);
+	if (index < 2 || !lua_istable(L, 2))
+		return luaL_error(L, "Usage: schema:encode(record[, ibuf])");
+	struct ibuf *buf;
+	if (index > 2) {
+		buf = luaT_toibuf(L, 3);
+		if (buf == NULL) {
+			return luaL_error(L, "msgpack.schema.encode: "
+					  "argument 2 must be of type "
+					  "'struct ibuf'");
+		}
+	} else {
+		buf = cord_ibuf_take();
+	}
+	size_t used = ibuf_used(buf);
+
+	struct mpstream stream;
+	mpstream_init(&stream, buf, ibuf_reserve_cb, ibuf_alloc_cb,
+		      luamp_error, L);
+	lua_rawgeti(L, LUA_REGISTRYINDEX, schema->names_ref);
+	int names = lua_gettop(L);
+	mpstream_encode_array(&stream, schema->field_count);
+	for (uint32_t i = 0; i < schema->field_count; i++) {
+		lua_rawgeti(L, names, i + 1);
+		lua_gettable(L, 2);
+		luamp_schema_encode_field(L, schema, i, &stream);
+		lua_pop(L, 1);
+	}
+	lua_pop(L, 1);
+	mpstream_flush(&stream);
+
+	if (index > 2) {
+		lua_pushinteger(L, ibuf_used(buf) - used);
+	} else {
+		lua_pushlstring(L, buf->buf, ibuf_used(buf));
+		cord_ibuf_drop(buf);
+	}
+	return 1;
+}
+
+/**
+ * Check that a MessagePack value may be decoded as the field
+ * @a field of a schema.
+ */
+static bool
+luamp_schema_field_is_compatible(const struct luamp_schema_field *field,
+				 enum mp_type type)
+{
+	if (type == MP_NIL)
+		return field->is_nullable || field->type == LUAMP_SCHEMA_ANY;
+	switch (field->type) {
+	case LUAMP_SCHEMA_ANY:
+		return true;
+	case LUAMP_SCHEMA_UNSIGNED:
+		return type == MP_UINT;
+	case LUAMP_SCHEMA_INTEGER:
+		return type == MP_UINT || type == MP_INT;
+	case LUAMP_SCHEMA_NUMBER:
+		return type == MP_UINT || type == MP_INT ||
+		       type == MP_FLOAT || type == MP_DOUBLE;
+	case LUAMP_SCHEMA_DOUBLE:
+		return type == MP_FLOAT || type == MP_DOUBLE;
+	case LUAMP_SCHEMA_STRING:
+		return type == MP_STR;
+	case LUAMP_SCHEMA_BOOLEAN:
+		return type == MP_BOOL;
+	default:
+		unreachable();
+	}
+	return false;
+}
+
+/**
+ * Decode a record encoded by schema:encode() into a new table on
+ * the top of the Lua stack. The data must be valid MessagePack.
+ */
+static void
+luamp_schema_decode(struct lua_State *L, struct luamp_schema *schema,
+		    const char **data)
+{
+	if (mp_typeof(**data) != MP_ARRAY ||
+	    mp_decode_array(data) != schema->field_count) {
+		luaL_error(L, "msgpack.schema.decode: an array of %d fields "
+			   "expected", (int)schema->field_count);
+	}
+	lua_rawgeti(L, LUA_REGISTRYINDEX, schema->names_ref);
+	int names = lua_gettop(L);
+	lua_createtable(L, 0, schema->field_count);
+	for (uint32_t i = 0; i < schema->field_count; i++) {
+		enum mp_type type = mp_typeof(**data);
+		if (!luamp_schema_field_is_compatible(&schema->fields[i],
+						      type)) {
+			luamp_schema_field_error(L, schema, i,
+						 "msgpack.schema.decode");
+		}
+		if (type == MP_NIL) {
+			mp_decode_nil(data);
+			continue;
+		}
+		lua_rawgeti(L, names, i + 1);
+		luamp_decode(L, schema->cfg, data);
+		lua_rawset(L, -3);
+	}
+	lua_remove(L, names);
+}
+
+/**
+ * schema:decode(string[, offset]) -> table, new offset
+ * schema:decode(ptr, size) -> table, new ptr
+ */
+static int
+lua_msgpack_schema_decode(struct lua_State *L)
+{
+	struct luamp_schema *schema = luamp_check_schema(L, 1);
+	int type = lua_gettop(L) >= 2 ? lua_type(L, 2) : LUA_TNONE;
+	if (type == LUA_TCDATA) {
+		const char *data;
+		uint32_t cdata_type;
+		if (luaL_checkconstchar(L, 2, &data, &cdata_type) != 0)
+			goto usage;
+		ptrdiff_t data_len = luaL_checkinteger(L, 3);
+		if (data_len < 0) {
+			return luaL_error(L, "msgpack.schema.decode: size "
+					  "can't be negative");
+		}
+		const char *p = data;
+		if (mp_check(&p, data + data_len) != 0) {
+			return luaL_error(L, "msgpack.schema.decode: "
+					  "invalid MsgPack");
+		}
+		luamp_schema_decode(L, schema, &data);
+		*(const char **)luaL_pushcdata(L, cdata_type) = data;
+		return 2;
+	}
+	if (type == LUA_TSTRING) {
+		ptrdiff_t offset = 0;
+		size_t data_len;
+		const char *data = lua_tolstring(L, 2, &data_len);
+		if (lua_gettop(L) > 2) {
+			offset = luaL_checkinteger(L, 3) - 1;
+			if (offset < 0 || (size_t)offset >= data_len) {
+				return luaL_error(L, "msgpack.schema.decode: "
+						  "offset is out of bounds");
+			}
+		}
+		const char *p = data + offset;
+		if (mp_check(&p, data + data_len) != 0) {
+			return luaL_error(L, "msgpack.schema.decode: "
+					  "invalid MsgPack");
+		}
+		p = data + offset;
+		luamp_schema_decode(L, schema, &p);
+		lua_pushinteger(L, p - data + 1);
+		return 2;
+	}
+usage:
+	return luaL_error(L, "msgpack.schema.decode: "
+			  "a Lua string or 'char *' expected");
+}
+
+static int
+lua_msgpack_schema_gc(struct lua_State *L)
+{
+	struct luamp_schema *schema = luamp_check_schema(L, 1);
+	luaL_unref(L, LUA_REGISTRYINDEX, schema->names_ref);
+	luaL_unref(L, LUA_REGISTRYINDEX, schema->cfg_ref);
+	return 0;
+}
+
+static int
+lua_msgpack_schema_tostring(struct lua_State *L)
+{
+	luamp_check_schema(L, 1);
+	lua_pushstring(L, luamp_schema_typename);
+	return 1;
+}
+
+/**
+ * Parse the field definition on the top of the Lua stack. It is
+ * either a name, or a table {name, type, is_nullable = <boolean>},
+ * or the same table with the name and the type given by 'name' and
+ * 'type' keys. The field name is left on the top of the stack.
+ */
+static void
+luamp_schema_parse_field(struct lua_State *L, uint32_t fieldno,
+			 struct luamp_schema_field *field)
+{
+	int idx = lua_gettop(L);
+	field->type = LUAMP_SCHEMA_ANY;
+	field->is_nullable = false;
+	if (lua_type(L, idx) == LUA_TSTRING)
+		return;
+	if (!lua_istable(L, idx))
+		goto error;
+	lua_rawgeti(L, idx, 1);
+	if (lua_isnil(L, -1)) {
+		lua_pop(L, 1);
+		lua_getfield(L, idx, "name");
+	}
+	if (lua_type(L, -1) != LUA_TSTRING)
+		goto error;
+	lua_rawgeti(L, idx, 2);
+	if (lua_isnil(L, -1)) {
+		lua_pop(L, 1);
+		lua_getfield(L, idx, "type");
+	}
+	if (!lua_isnil(L, -1)) {
+		if (lua_type(L, -1) != LUA_TSTRING)
+			goto error;
+		const char *type = lua_tostring(L, -1);
+		field->type = STR2ENUM(luamp_schema_type, type);
+		if (field->type == luamp_schema_type_MAX) {
+			luaL_error(L, "msgpack.compile: unknown type '%s' of "
+				   "field %d", type, (int)fieldno + 1);
+		}
+	}
+	lua_pop(L, 1);
+	lua_getfield(L, idx, "is_nullable");
+	field->is_nullable = lua_toboolean(L, -1);
+	lua_pop(L, 1);
+	/* Replace the definition with the name. */
+	lua_replace(L, idx);
+	return;
+error:
+	luaL_error(L, "msgpack.compile: field %d must be a name or "
+		   "{name, type}", (int)fieldno + 1);
+}
+
+/**
+ * msgpack.compile({field, ...}) -> schema
+ *
+ * Compile a record layout into an object with encode() and
+ * decode() methods, which are faster than msgpack.encode() and
+ * msgpack.decode() of a map with the same keys.
+ */
+static int
+lua_msgpack_compile(struct lua_State *L)
+{
+	if (lua_gettop(L) != 1 || !lua_istable(L, 1))
+		return luaL_error(L, "Usage: msgpack.compile({field, ...})");
+	uint32_t field_count = lua_objlen(L, 1);
+	if (field_count == 0)
+		return luaL_error(L, "msgpack.compile: no fields given");
+	struct luamp_schema *schema = (struct luamp_schema *)
+		lua_newuserdata(L, sizeof(*schema) +
+				field_count * sizeof(schema->fields[0]));
+	schema->cfg = luaL_checkserializer(L);
+	schema->field_count = field_count;
+	schema->cfg_ref = LUA_NOREF;
+	schema->names_ref = LUA_NOREF;
+	luaL_getmetatable(L, luamp_schema_typename);
+	lua_setmetatable(L, -2);
+
+	lua_createtable(L, field_count, 0);
+	for (uint32_t i = 0; i < field_count; i++) {
+		lua_rawgeti(L, 1, i + 1);
+		luamp_schema_parse_field(L, i, &schema->fields[i]);
+		for (uint32_t j = 0; j < i; j++) {
+			lua_rawgeti(L, -2, j + 1);
+			if (lua_rawequal(L, -1, -2)) {
+				return luaL_error(L, "msgpack.compile: "
+						  "duplicate field '%s'",
+						  lua_tostring(L, -1));
+			}
+			lua_pop(L, 1);
+		}
+		lua_rawseti(L, -2, i + 1);
+	}
+	schema->names_ref = luaL_ref(L, LUA_REGISTRYINDEX);
+	lua_pushvalue(L, lua_upvalueindex(1));
+	schema->cfg_ref = luaL_ref(L, LUA_REGISTRYINDEX);
+	return 1;
+}
+
+/* }}} Compiled schemas */
+
 static int
 lua_msgpack_new(lua_State *L);
 
@@ -579,6 +1016,7 @@ static const luaL_Reg msgpacklib[] = {
 	{ "ibuf_decode", lua_ibuf_msgpack_decode },
 	{ "decode_array_header", lua_decode_array_header },
 	{ "decode_map_header", lua_decode_map_header },
+	{ "compile", lua_msgpack_compile },
 	{ "new", lua_msgpack_new },
 	{ NULL, NULL }
 };
@@ -593,6 +1031,14 @@ lua_msgpack_new(lua_State *L)
 LUALIB_API int
 luaopen_msgpack(lua_State *L)
 {
+	static const struct luaL_Reg luamp_schema_meta[] = {
+		{"__gc", lua_msgpack_schema_gc},
+		{"__tostring", lua_msgpack_schema_tostring},
+		{"encode", lua_msgpack_schema_encode},
+		{"decode", lua_msgpack_schema_decode},
+		{NULL, NULL}
+	};
+	luaL_register_type(L, luamp_schema_typename, luamp_schema_meta);
 	luaL_msgpack_default = luaL_newserializer(L, "msgpack", msgpacklib);
 	return 1;
 }
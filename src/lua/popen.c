@@ -52,7 +52,8 @@
 static const char *popen_handle_uname = "popen_handle";
 static const char *popen_handle_closed_uname = "popen_handle_closed";
 
-#define POPEN_LUA_READ_BUF_SIZE        4096
+#define POPEN_LUA_READ_BUF_SIZE        65536
+#define POPEN_LUA_SPLICE_SIZE          (1 << 20)
 #define POPEN_LUA_WAIT_DELAY           0.1
 #define POPEN_LUA_ENV_CAPACITY_DEFAULT 256
 
@@ -1676,6 +1677,57 @@ lbox_popen_wait(struct lua_State *L)
 	return luaT_push_popen_process_status(L, state, exit_code);
 }
 
+/**
+ * Parse the stdout, stderr and timeout options of ph:read() and
+ * ph:splice() at the given index of the Lua stack.
+ *
+ * Return 0 on success, -1 on an incorrect option.
+ */
+static int
+luaT_popen_parse_read_opts(struct lua_State *L, int idx, unsigned int *flags,
+			   ev_tstamp *timeout)
+{
+	if (!lua_isnoneornil(L, idx)) {
+		if (lua_type(L, idx) != LUA_TTABLE)
+			return -1;
+
+		/* FIXME: Shorten boolean options parsing. */
+
+		lua_getfield(L, idx, "stdout");
+		if (!lua_isnil(L, -1)) {
+			if (lua_type(L, -1) != LUA_TBOOLEAN)
+				return -1;
+			if (lua_toboolean(L, -1) == 0)
+				*flags &= ~POPEN_FLAG_FD_STDOUT;
+			else
+				*flags |= POPEN_FLAG_FD_STDOUT;
+		}
+		lua_pop(L, 1);
+
+		lua_getfield(L, idx, "stderr");
+		if (!lua_isnil(L, -1)) {
+			if (lua_type(L, -1) != LUA_TBOOLEAN)
+				return -1;
+			if (lua_toboolean(L, -1) == 0)
+				*flags &= ~POPEN_FLAG_FD_STDERR;
+			else
+				*flags |= POPEN_FLAG_FD_STDERR;
+		}
+		lua_pop(L, 1);
+
+		lua_getfield(L, idx, "timeout");
+		if (!lua_isnil(L, -1) &&
+		    (*timeout = luaT_check_timeout(L, -1)) < 0.0)
+			return -1;
+		lua_pop(L, 1);
+	}
+
+	/* Read from stdout by default. */
+	if (!(*flags & (POPEN_FLAG_FD_STDOUT | POPEN_FLAG_FD_STDERR)))
+		*flags |= POPEN_FLAG_FD_STDOUT;
+	return 0;
+}
+
 /**
  * Read data from a child peer.
  *
@@ -1741,44 +1793,8 @@ lbox_popen_read(struct lua_State *L)
 		return luaT_popen_handle_closed_error(L);
 
 	/* Extract options. */
-	if (!lua_isnoneornil(L, 2)) {
-		if (lua_type(L, 2) != LUA_TTABLE)
-			goto usage;
-
-		/* FIXME: Shorten boolean options parsing. */
-
-		lua_getfield(L, 2, "stdout");
-		if (!lua_isnil(L, -1)) {
-			if (lua_type(L, -1) != LUA_TBOOLEAN)
-				goto usage;
-			if (lua_toboolean(L, -1) == 0)
-				flags &= ~POPEN_FLAG_FD_STDOUT;
-			else
-				flags |= POPEN_FLAG_FD_STDOUT;
-		}
-		lua_pop(L, 1);
-
-		lua_getfield(L, 2, "stderr");
-		if (!lua_isnil(L, -1)) {
-			if (lua_type(L, -1) != LUA_TBOOLEAN)
-				goto usage;
-			if (lua_toboolean(L, -1) == 0)
-				flags &= ~POPEN_FLAG_FD_STDERR;
-			else
-				flags |= POPEN_FLAG_FD_STDERR;
-		}
-		lua_pop(L, 1);
-
-		lua_getfield(L, 2, "timeout");
-		if (!lua_isnil(L, -1) &&
-		    (timeout = luaT_check_timeout(L, -1)) < 0.0)
-			goto usage;
-		lua_pop(L, 1);
-	}
-
-	/* Read from stdout by default. */
-	if (!(flags & (POPEN_FLAG_FD_STDOUT | POPEN_FLAG_FD_STDERR)))
-		flags |= POPEN_FLAG_FD_STDOUT;
+	if (luaT_popen_parse_read_opts(L, 2, &flags, &timeout) != 0)
+		goto usage;
 
 	size_t size = POPEN_LUA_READ_BUF_SIZE;
 	char *buf = region_alloc(region, size);
@@ -1810,6 +1826,98 @@ err:
 	return luaT_push_nil_and_error(L);
 }
 
+/**
+ * Move data from a child peer to a file descriptor.
+ *
+ * @param handle        handle of a child process
+ * @param fd            a file descriptor to write to, for
+ *                      example, sock:fd() or fh.fh of a fio
+ *                      handle
+ * @param opts          an options table
+ * @param opts.stdout   whether to read from stdout, boolean
+ *                      (default: true)
+ * @param opts.stderr   whether to read from stderr, boolean
+ *                      (default: false)
+ * @param opts.timeout  time quota in seconds
+ *                      (default: 100 years)
+ * @param opts.size     maximal amount of bytes to move
+ *                      (default: 1 MiB)
+ *
+ * Move data from stdout or stderr stream to @a fd like
+ * ph:read() followed by a write to @a fd, but with splice(),
+ * so the data never gets into Lua memory. A socket or a pipe
+ * is written without blocking, a regular file is written
+ * synchronously. Only supported on Linux.
+ *
+ * The stream options are the same as ones of ph:read().
+ *
+ * Raise an error on incorrect parameters or when the fiber is
+ * cancelled, like ph:read() does. Also raise an error if
+ * splice() is not supported on the platform.
+ *
+ * Return the amount of moved bytes on success, zero at EOF.
+ *
+ * Return `nil, err` on a failure. Possible reasons:
+ *
+ * - SystemError: an IO error occurs at splice().
+ * - TimedOut:    @a timeout quota is exceeded.
+ */
+static int
+lbox_popen_splice(struct lua_State *L)
+{
+	struct popen_handle *handle;
+	bool is_closed;
+	unsigned int flags = POPEN_FLAG_NONE;
+	ev_tstamp timeout = TIMEOUT_INFINITY;
+	size_t size = POPEN_LUA_SPLICE_SIZE;
+
+	/* Extract handle. */
+	if ((handle = luaT_check_popen_handle(L, 1, &is_closed)) == NULL)
+		goto usage;
+	if (is_closed)
+		return luaT_popen_handle_closed_error(L);
+
+	/* Extract the file descriptor. */
+	if (lua_type(L, 2) != LUA_TNUMBER || lua_tointeger(L, 2) < 0 ||
+	    lua_tointeger(L, 2) > INT_MAX)
+		goto usage;
+	int fd = lua_tointeger(L, 2);
+
+	/* Extract options. */
+	if (luaT_popen_parse_read_opts(L, 3, &flags, &timeout) != 0)
+		goto usage;
+	if (!lua_isnoneornil(L, 3)) {
+		lua_getfield(L, 3, "size");
+		if (!lua_isnil(L, -1)) {
+			if (lua_type(L, -1) != LUA_TNUMBER ||
+			    lua_tonumber(L, -1) < 1 ||
+			    lua_tonumber(L, -1) > SSIZE_MAX)
+				goto usage;
+			size = lua_tonumber(L, -1);
+		}
+		lua_pop(L, 1);
+	}
+
+	ssize_t rc = popen_splice_timeout(handle, fd, size, flags, timeout);
+	if (rc < 0) {
+		struct error *e = diag_last_error(diag_get());
+		if (e->type == &type_IllegalParams ||
+		    e->type == &type_FiberIsCancelled)
+			return luaT_error(L);
+		return luaT_push_nil_and_error(L);
+	}
+	lua_pushinteger(L, rc);
+	return 1;
+
+usage:
+	diag_set(IllegalParams, "Bad params, use: ph:splice(<fd>, {"
+		 "stdout = <boolean>, "
+		 "stderr = <boolean>, "
+		 "timeout = <number>, "
+		 "size = <number>})");
+	return luaT_error(L);
+}
+
 /**
  * Write data to a child peer.
  *
@@ -2503,6 +2611,7 @@ tarantool_lua_popen_init(struct lua_State *L)
 		{"kill",		lbox_popen_kill,	},
 		{"wait",		lbox_popen_wait,	},
 		{"read",		lbox_popen_read,	},
+		{"splice",		lbox_popen_splice,	},
 		{"write",		lbox_popen_write,	},
 		{"shutdown",		lbox_popen_shutdown,	},
 		{"info",		lbox_popen_info,	},
@@ -49,9 +49,11 @@
 #include <lauxlib.h>
 #include <lualib.h>
 
+#include <small/ibuf.h>
 #include <coio.h> /* coio_wait() */
 #include <coio_task.h> /* coio_getaddrinfo() */
 #include <fiber.h>
+#include "core/cord_buf.h"
 #include "lua/utils.h"
 #include "lua/fiber.h"
 
@@ -998,6 +1000,242 @@ lbox_socket_recvfrom(struct lua_State *L)
 	return 2;
 }
 
+#if defined(HAVE_RECVMMSG) || defined(HAVE_SENDMMSG)
+/** Scratch memory needed by recvmmsg() and sendmmsg() per datagram. */
+#define LBOX_SOCKET_MMSG_SIZE (sizeof(struct mmsghdr) + sizeof(struct iovec))
+
+/**
+ * Fill @a count message headers in @a msgs, followed by their
+ * iovecs, for datagrams at @a datagrams of @a lens bytes to or
+ * from @a addrs, which are @a addr_len bytes each.
+ */
+static void
+lbox_socket_mmsg_create(struct mmsghdr *msgs, int count, char **datagrams,
+			const size_t *lens, struct sockaddr_storage *addrs,
+			size_t addrs_step, socklen_t addr_len)
+{
+	struct iovec *iov = (struct iovec *)(msgs + count);
+	memset(msgs, 0, count * sizeof(*msgs));
+	for (int i = 0; i < count; i++) {
+		iov[i].iov_base = datagrams[i];
+		iov[i].iov_len = lens[i];
+		if (addrs != NULL)
+			msgs[i].msg_hdr.msg_name = &addrs[i * addrs_step];
+		msgs[i].msg_hdr.msg_namelen = addr_len;
+		msgs[i].msg_hdr.msg_iov = &iov[i];
+		msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+}
+#endif
+
+#ifdef HAVE_RECVMMSG
+#define LBOX_SOCKET_RECVMMSG_SIZE LBOX_SOCKET_MMSG_SIZE
+#else
+#define LBOX_SOCKET_RECVMMSG_SIZE 0
+#endif
+
+#ifdef HAVE_SENDMMSG
+#define LBOX_SOCKET_SENDMMSG_SIZE LBOX_SOCKET_MMSG_SIZE
+#else
+#define LBOX_SOCKET_SENDMMSG_SIZE 0
+#endif
+
+/**
+ * Receive at most @a count datagrams of at most lens[i] bytes
+ * into datagrams[i] from @a fh, without waiting for more after the
+ * first one. Lengths of the datagrams and their source addresses
+ * are stored in lens, addrs and addr_lens. @a scratch has
+ * LBOX_SOCKET_RECVMMSG_SIZE bytes per datagram.
+ *
+ * @retval >0 Number of received datagrams.
+ * @retval -1 Nothing received, errno is set.
+ */
+static int
+lbox_socket_do_recvmmsg(int fh, char **datagrams, size_t *lens, int count,
+			int flags, struct sockaddr_storage *addrs,
+			socklen_t *addr_lens, void *scratch)
+{
+#ifdef HAVE_RECVMMSG
+	struct mmsghdr *msgs = scratch;
+	lbox_socket_mmsg_create(msgs, count, datagrams, lens, addrs, 1,
+				sizeof(*addrs));
+	int res = recvmmsg(fh, msgs, count, flags | MSG_WAITFORONE, NULL);
+	for (int i = 0; i < res; i++) {
+		lens[i] = MIN(lens[i], msgs[i].msg_len);
+		addr_lens[i] = msgs[i].msg_hdr.msg_namelen;
+	}
+	return res;
+#else
+	(void)scratch;
+	int i;
+	for (i = 0; i < count; i++) {
+		addr_lens[i] = sizeof(addrs[i]);
+		ssize_t res = recvfrom(fh, datagrams[i], lens[i], flags,
+				       (struct sockaddr *)&addrs[i],
+				       &addr_lens[i]);
+		if (res < 0)
+			break;
+		lens[i] = MIN(lens[i], (size_t)res);
+	}
+	return i > 0 ? i : -1;
+#endif
+}
+
+/**
+ * Receive a batch of datagrams with one syscall where possible.
+ * Takes the socket, the maximal number of datagrams, the maximal
+ * datagram size and flags. Returns a table of datagrams and a
+ * table of their source addresses, or nil if nothing was received.
+ */
+static int
+lbox_socket_recvmmsg(struct lua_State *L)
+{
+	int fh = lua_tointeger(L, 1);
+	int count = lua_tointeger(L, 2);
+	size_t size = lua_tointeger(L, 3);
+	int flags = lua_tointeger(L, 4);
+	assert(count > 0);
+
+	/*
+	 * All the datagrams and their metadata are received into
+	 * one allocation of the global buffer, so it isn't leaked
+	 * if pushing the strings raises a Lua error.
+	 */
+	struct ibuf *ibuf = cord_ibuf_take();
+	size_t dgram_size = LBOX_SOCKET_RECVMMSG_SIZE +
+			    sizeof(struct sockaddr_storage) + sizeof(char *) +
+			    sizeof(size_t) + sizeof(socklen_t) + size;
+	char *scratch = ibuf_alloc(ibuf, count * dgram_size);
+	if (scratch == NULL) {
+		cord_ibuf_put(ibuf);
+		errno = ENOMEM;
+		lua_pushnil(L);
+		return 1;
+	}
+	struct sockaddr_storage *addrs = (struct sockaddr_storage *)
+		(scratch + count * LBOX_SOCKET_RECVMMSG_SIZE);
+	char **datagrams = (char **)(addrs + count);
+	size_t *lens = (size_t *)(datagrams + count);
+	socklen_t *addr_lens = (socklen_t *)(lens + count);
+	char *buf = (char *)(addr_lens + count);
+	for (int i = 0; i < count; i++) {
+		datagrams[i] = buf + i * size;
+		lens[i] = size;
+	}
+	int res = lbox_socket_do_recvmmsg(fh, datagrams, lens, count, flags,
+					  addrs, addr_lens, scratch);
+	if (res < 0) {
+		cord_ibuf_put(ibuf);
+		lua_pushnil(L);
+		return 1;
+	}
+	lua_createtable(L, res, 0);
+	for (int i = 0; i < res; i++) {
+		lua_pushlstring(L, datagrams[i], lens[i]);
+		lua_rawseti(L, -2, i + 1);
+	}
+	lua_createtable(L, res, 0);
+	for (int i = 0; i < res; i++) {
+		lbox_socket_push_addr(L, (struct sockaddr *)&addrs[i],
+				      addr_lens[i]);
+		lua_rawseti(L, -2, i + 1);
+	}
+	cord_ibuf_put(ibuf);
+	return 2;
+}
+
+/**
+ * Send @a count datagrams[i] of lens[i] bytes to @a addr, or to
+ * the peer of a connected socket if @a addr is NULL. @a scratch
+ * has LBOX_SOCKET_SENDMMSG_SIZE bytes per datagram.
+ *
+ * @retval >0 Number of sent datagrams.
+ * @retval -1 Nothing sent, errno is set.
+ */
+static int
+lbox_socket_do_sendmmsg(int fh, char **datagrams, const size_t *lens,
+			int count, int flags, struct sockaddr_storage *addr,
+			socklen_t addr_len, void *scratch)
+{
+#ifdef HAVE_SENDMMSG
+	struct mmsghdr *msgs = scratch;
+	lbox_socket_mmsg_create(msgs, count, datagrams, lens, addr, 0,
+				addr_len);
+	return sendmmsg(fh, msgs, count, flags);
+#else
+	(void)scratch;
+	int i;
+	for (i = 0; i < count; i++) {
+		if (sendto(fh, datagrams[i], lens[i], flags,
+			   (struct sockaddr *)addr, addr_len) < 0)
+			break;
+	}
+	return i > 0 ? i : -1;
+#endif
+}
+
+/**
+ * Send a batch of datagrams with one syscall where possible.
+ * Takes the socket, the destination host and port (nil for a
+ * connected socket), a table of strings and flags. Returns the
+ * number of sent datagrams, or nil if nothing was sent.
+ */
+static int
+lbox_socket_sendmmsg(struct lua_State *L)
+{
+	int fh = lua_tointeger(L, 1);
+	int count = lua_objlen(L, 4);
+	int flags = lua_tointeger(L, 5);
+	assert(count > 0);
+
+	struct sockaddr_storage addr;
+	struct sockaddr_storage *addr_ptr = NULL;
+	socklen_t addr_len = 0;
+	if (!lua_isnil(L, 2)) {
+		addr_ptr = &addr;
+		addr_len = sizeof(addr);
+		if (lbox_socket_local_resolve(lua_tostring(L, 2),
+					      lua_tostring(L, 3),
+					      (struct sockaddr *)addr_ptr,
+					      &addr_len) != 0) {
+			lua_pushnil(L);
+			return 1;
+		}
+	}
+	struct ibuf *ibuf = cord_ibuf_take();
+	size_t dgram_size = LBOX_SOCKET_SENDMMSG_SIZE + sizeof(char *) +
+			    sizeof(size_t);
+	char *scratch = ibuf_alloc(ibuf, count * dgram_size);
+	if (scratch == NULL) {
+		cord_ibuf_put(ibuf);
+		errno = ENOMEM;
+		lua_pushnil(L);
+		return 1;
+	}
+	char **datagrams = (char **)(scratch +
+				     count * LBOX_SOCKET_SENDMMSG_SIZE);
+	size_t *lens = (size_t *)(datagrams + count);
+	for (int i = 0; i < count; i++) {
+		lua_rawgeti(L, 4, i + 1);
+		if (lua_type(L, -1) != LUA_TSTRING) {
+			cord_ibuf_put(ibuf);
+			return luaL_error(L, "datagrams must be strings");
+		}
+		/* The string stays referenced by the table. */
+		datagrams[i] = (char *)lua_tolstring(L, -1, &lens[i]);
+		lua_pop(L, 1);
+	}
+	int res = lbox_socket_do_sendmmsg(fh, datagrams, lens, count, flags,
+					  addr_ptr, addr_len, scratch);
+	cord_ibuf_put(ibuf);
+	if (res < 0) {
+		lua_pushnil(L);
+		return 1;
+	}
+	lua_pushinteger(L, res);
+	return 1;
+}
+
 static void
 lbox_socket_pushsockopt(lua_State *L, const struct lbox_sockopt_reg *reg)
 {
@@ -1031,6 +1269,8 @@ tarantool_lua_socket_init(struct lua_State *L)
 		{ "name",		lbox_socket_soname	},
 		{ "peer",		lbox_socket_peername	},
 		{ "recvfrom",		lbox_socket_recvfrom	},
+		{ "recvmmsg",		lbox_socket_recvmmsg	},
+		{ "sendmmsg",		lbox_socket_sendmmsg	},
 		{ "accept",		lbox_socket_accept	},
 		{ NULL,			NULL			}
 	};
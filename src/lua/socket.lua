@@ -892,6 +892,61 @@ local function socket_recvfrom(self, size, flags)
     return res, from
 end
 
+-- Receive up to count datagrams of at most size bytes each with one
+-- syscall where the platform has recvmmsg(). Doesn't wait for more
+-- datagrams after the first one. Returns a table of datagrams and a
+-- table of their source addresses.
+local function socket_recvmmsg(self, count, size, flags)
+    local fd = check_socket(self)
+    if type(count) ~= 'number' or count < 1 or
+       type(size) ~= 'number' or size < 0 then
+        error('Usage: socket:recvmmsg(count, size[, flags])')
+    end
+    local iflags = get_iflags(internal.SEND_FLAGS, flags)
+    if iflags == nil then
+        self._errno = boxerrno.EINVAL
+        return nil
+    end
+
+    self._errno = nil
+    local datagrams, from = internal.recvmmsg(fd, count, size, iflags)
+    if datagrams == nil then
+        self._errno = boxerrno()
+        return nil
+    end
+    return datagrams, from
+end
+
+-- Send a table of datagrams with one syscall where the platform has
+-- sendmmsg(). host and port may be nil for a connected socket.
+-- Returns the number of sent datagrams.
+local function socket_sendmmsg(self, host, port, datagrams, flags)
+    local fd = check_socket(self)
+    if type(datagrams) ~= 'table' then
+        error('Usage: socket:sendmmsg(host, port, datagrams[, flags])')
+    end
+    local iflags = get_iflags(internal.SEND_FLAGS, flags)
+    if iflags == nil then
+        self._errno = boxerrno.EINVAL
+        return nil
+    end
+
+    self._errno = nil
+    if #datagrams == 0 then
+        return 0
+    end
+    if host ~= nil then
+        host = tostring(host)
+        port = tostring(port)
+    end
+    local res = internal.sendmmsg(fd, host, port, datagrams, iflags)
+    if res == nil then
+        self._errno = boxerrno()
+        return nil
+    end
+    return res
+end
+
 local function socket_sendto(self, host, port, octets, flags)
     local fd = check_socket(self)
     local iflags = get_iflags(internal.SEND_FLAGS, flags)
@@ -1262,6 +1317,8 @@ socket_mt   = {
         recv = socket_recv;
         recvfrom = socket_recvfrom;
         sendto = socket_sendto;
+        recvmmsg = socket_recvmmsg;
+        sendmmsg = socket_sendmmsg;
         name = socket_name;
         peer = socket_peer;
         fd = socket_fd;
@@ -231,6 +231,7 @@ tarantool_atfork(void)
 {
 	signal_reset();
 	box_atfork();
+	say_logger_atfork();
 }
 
 /**
@@ -442,6 +443,7 @@ load_cfg(void)
 	say_logger_init(log,
 			cfg_geti("log_level"),
 			cfg_getb("log_nonblock"),
+			cfg_getb("log_async") == 1,
 			log_format,
 			background);
 
@@ -47,6 +47,11 @@
  */
 #cmakedefine HAVE_CPUID 1
 
+/**
+ * Defined if getauxval() is available.
+ */
+#cmakedefine HAVE_GETAUXVAL 1
+
 /**
  * Defined if strlcpy() string extension helper present.
  */
@@ -76,6 +81,7 @@
 #define MAP_ANONYMOUS MAP_ANON
 #endif
 #cmakedefine HAVE_MADV_DONTNEED 1
+#cmakedefine HAVE_MADV_FREE 1
 /*
  * Defined if O_DSYNC mode exists for open(2).
  */
@@ -119,6 +125,11 @@
  * Defined if this platform has BSD specific sendfile(..).
  */
 #cmakedefine HAVE_SENDFILE_BSD 1
+/*
+ * Defined if this platform has recvmmsg(..) and sendmmsg(..).
+ */
+#cmakedefine HAVE_RECVMMSG 1
+#cmakedefine HAVE_SENDMMSG 1
 /*
  * Set if this is a GNU system and libc has __libc_stack_end.
  */
@@ -181,6 +192,11 @@
 
 #cmakedefine HAVE_PRCTL_H 1
 
+/*
+ * Defined if USDT probes are enabled, see trivia/probe.h.
+ */
+#cmakedefine ENABLE_USDT 1
+
 #cmakedefine HAVE_UUIDGEN 1
 #cmakedefine HAVE_CLOCK_GETTIME 1
 #cmakedefine HAVE_CLOCK_GETTIME_DECL 1
@@ -0,0 +1,73 @@
+#pragma once
+
+/*
+ * Copyright 2026, Tarantool AUTHORS, please see AUTHORS file.
+ *
+ * Redistribution and use in source and binary forms, with or
+ * without modification, are permitted provided that the following
+ * conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above
+ *    copyright notice, this list of conditions and the
+ *    following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY <COPYRIGHT HOLDER> ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+ * <COPYRIGHT HOLDER> OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+
+/**
+ * Static tracepoints (USDT probes) on hot paths.
+ *
+ * With sys/sdt.h available at build time, TT_PROBE(name, ...)
+ * emits a nop instruction and an ELF note that tools like
+ * bpftrace, perf and SystemTap can attach to at runtime, e.g.
+ *
+ *   bpftrace -e 'usdt:./tarantool:tarantool:wal_write_begin {...}'
+ *
+ * A probe costs a nop when nothing is attached. Without sys/sdt.h
+ * or with -DENABLE_USDT=OFF probes are compiled out and their
+ * arguments are not evaluated, so they must not have side effects.
+ *
+ * Probe names use underscores, arguments are integers or pointers,
+ * at most 12 of them. The probes are:
+ *
+ *   iproto_msg_decode(msg, type, sync)       - iproto thread
+ *   tx_process_begin/end(msg, type, sync)    - tx, iproto request
+ *   cbus_push(pipe, msg), cbus_deliver(msg, hop_f)
+ *   txn_commit_begin(txn_id), txn_commit_end(txn_id, signature)
+ *   journal_write_begin(entry, n_rows, approx_len)
+ *   journal_write_end(entry, rc, res)
+ *   wal_write_begin(wal_msg)                  - WAL thread
+ *   wal_write_end(wal_msg, entry_count, bytes)
+ *   wal_sync_begin/end(fd)
+ *   vy_page_read_begin(run_id, offset, size)
+ *   vy_page_read_end(run_id, offset, unpacked_size)
+ *   vy_dump_begin(space_id, index_id, run_id) - vinyl worker
+ *   vy_dump_end(space_id, index_id, run_id, rc)
+ *   vy_compaction_begin/end, same as vy_dump_begin/end
+ *   fiber_yield(fid, to_fid), fiber_wakeup(fid)
+ */
+
+#include "trivia/config.h"
+
+#if defined(ENABLE_USDT)
+#include <sys/sdt.h>
+#define TT_PROBE(name, ...) STAP_PROBEV(tarantool, name, ##__VA_ARGS__)
+#else
+#define TT_PROBE(name, ...) do {} while (0)
+#endif
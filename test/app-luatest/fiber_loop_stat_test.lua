@@ -0,0 +1,57 @@
+local clock = require('clock')
+local fiber = require('fiber')
+local t = require('luatest')
+local g = t.group()
+
+g.after_each(function()
+    fiber.loop_stat_disable()
+end)
+
+g.test_disabled = function()
+    t.assert_error_msg_content_equals(
+        "fiber.loop_stat() is disabled. Enable it with " ..
+        "fiber.loop_stat_enable() first", fiber.loop_stat)
+end
+
+g.test_long_run = function()
+    fiber.loop_stat_enable()
+    local f = fiber.new(function()
+        local deadline = clock.monotonic() + 0.1
+        while clock.monotonic() < deadline do end
+    end)
+    f:set_joinable(true)
+    f:name('busy')
+    local fid = f:id()
+    f:join()
+    -- Let the event loop complete the iteration.
+    fiber.sleep(0.01)
+
+    local stat = fiber.loop_stat()
+    t.assert_ge(stat.utilization, 0)
+    t.assert_le(stat.utilization, 1)
+    t.assert_gt(stat.busy_time, 0.1)
+    t.assert_ge(stat.idle_time, 0)
+    t.assert_type(stat.ready, 'number')
+    t.assert_gt(stat.runs.count, 0)
+    t.assert_ge(stat.runs.max, 0.1)
+    t.assert_le(stat.runs.p50, stat.runs.p99)
+    t.assert_le(stat.runs.p99, stat.runs.p999)
+    local run = stat.longest[1]
+    t.assert_equals(run.fid, fid)
+    t.assert_equals(run.name, 'busy')
+    t.assert_ge(run.duration, 0.1)
+    t.assert_almost_equals(run.time, clock.realtime(), 1)
+    for i = 2, #stat.longest do
+        t.assert_le(stat.longest[i].duration, stat.longest[i - 1].duration)
+    end
+end
+
+g.test_reset = function()
+    fiber.loop_stat_enable()
+    fiber.sleep(0.01)
+    fiber.loop_stat_disable()
+    fiber.loop_stat_enable()
+    local stat = fiber.loop_stat()
+    t.assert_equals(stat.runs.count, 0)
+    t.assert_equals(stat.longest, {})
+end
@@ -181,3 +181,85 @@ g.test_encode_decode_uuid = function()
         t.assert_equals(src, res)
     end
 end
+
+g.test_compile = function()
+    local schema = msgpack.compile({
+        {'id', 'unsigned'},
+        {name = 'name', type = 'string'},
+        {'score', 'number', is_nullable = true},
+        {'ratio', 'double'},
+        {'ok', 'boolean'},
+        {'delta', 'integer'},
+        'extra',
+    })
+    t.assert_equals(tostring(schema), 'msgpack.schema')
+    local rec = {
+        id = 1, name = 'abc', score = 1.5, ratio = 2, ok = true,
+        delta = -10, extra = {1, {a = 2}},
+    }
+    local data = schema:encode(rec)
+    t.assert_equals(msgpack.decode(data),
+                    {1, 'abc', 1.5, 2, true, -10, {1, {a = 2}}})
+    local res, pos = schema:decode(data)
+    t.assert_equals(res, rec)
+    t.assert_equals(pos, #data + 1)
+
+    -- Nullable fields and 'any' fields may be omitted.
+    rec = {id = 2, name = '', ratio = 0.5, ok = false, delta = -3}
+    data = schema:encode({id = 2ULL, name = '', ratio = 0.5, ok = false,
+                          delta = -3LL})
+    t.assert_equals(schema:encode(rec), data)
+    t.assert_equals(msgpack.decode(data),
+                    {2, '', nil, 0.5, false, -3, nil})
+    t.assert_equals(schema:decode(data), rec)
+
+    -- Offset in a string.
+    local two = data .. data
+    res, pos = schema:decode(two, #data + 1)
+    t.assert_equals(res, rec)
+    t.assert_equals(pos, #two + 1)
+
+    -- ibuf and char pointer.
+    local buf = buffer.ibuf()
+    local len = schema:encode(rec, buf)
+    t.assert_equals(len, #data)
+    res, pos = schema:decode(buf.rpos, buf:size())
+    t.assert_equals(res, rec)
+    t.assert_equals(pos, buf.rpos + len)
+    buf:recycle()
+end
+
+g.test_compile_errors = function()
+    t.assert_error_msg_content_equals(
+        "Usage: msgpack.compile({field, ...})",
+        function() msgpack.compile() end)
+    t.assert_error_msg_content_equals(
+        "msgpack.compile: no fields given",
+        function() msgpack.compile({}) end)
+    t.assert_error_msg_content_equals(
+        "msgpack.compile: field 2 must be a name or {name, type}",
+        function() msgpack.compile({'a', 1}) end)
+    t.assert_error_msg_content_equals(
+        "msgpack.compile: unknown type 'map' of field 1",
+        function() msgpack.compile({{'a', 'map'}}) end)
+    t.assert_error_msg_content_equals(
+        "msgpack.compile: duplicate field 'a'",
+        function() msgpack.compile({'a', {'a', 'string'}}) end)
+
+    local schema = msgpack.compile({{'a', 'unsigned'}, {'b', 'string'}})
+    t.assert_error_msg_content_equals(
+        "msgpack.schema.encode: field 'a' must be unsigned",
+        function() schema:encode({a = -1, b = 'x'}) end)
+    t.assert_error_msg_content_equals(
+        "msgpack.schema.encode: field 'b' must be string",
+        function() schema:encode({a = 1}) end)
+    t.assert_error_msg_content_equals(
+        "msgpack.schema.decode: field 'b' must be string",
+        function() schema:decode(msgpack.encode({1, 2})) end)
+    t.assert_error_msg_content_equals(
+        "msgpack.schema.decode: an array of 2 fields expected",
+        function() schema:decode(msgpack.encode({1})) end)
+    t.assert_error_msg_content_equals(
+        "msgpack.schema.decode: invalid MsgPack",
+        function() schema:decode('\x92\x01') end)
+end
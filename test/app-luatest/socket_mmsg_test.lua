@@ -0,0 +1,86 @@
+local socket = require('socket')
+local t = require('luatest')
+local g = t.group()
+
+g.before_each(function(cg)
+    cg.receiver = socket('AF_INET', 'SOCK_DGRAM', 'udp')
+    t.assert(cg.receiver:bind('127.0.0.1', 0))
+    cg.port = cg.receiver:name().port
+    cg.sender = socket('AF_INET', 'SOCK_DGRAM', 'udp')
+end)
+
+g.after_each(function(cg)
+    cg.receiver:close()
+    cg.sender:close()
+end)
+
+g.test_send_recv = function(cg)
+    local datagrams = {'one', 'two', '', string.rep('x', 100)}
+    t.assert_equals(cg.sender:sendmmsg('127.0.0.1', cg.port, datagrams),
+                    #datagrams)
+    t.assert(cg.receiver:readable(1))
+    local received = {}
+    local from
+    while #received < #datagrams do
+        t.assert(cg.receiver:readable(1))
+        local batch
+        batch, from = cg.receiver:recvmmsg(10, 50)
+        t.assert_not_equals(batch, nil, cg.receiver:error())
+        t.assert_equals(#from, #batch)
+        for _, d in ipairs(batch) do
+            table.insert(received, d)
+        end
+    end
+    -- The last datagram is truncated to the buffer size.
+    t.assert_equals(received, {'one', 'two', '', string.rep('x', 50)})
+    t.assert_equals(from[1].host, '127.0.0.1')
+    t.assert_equals(from[1].port, cg.sender:name().port)
+end
+
+g.test_count = function(cg)
+    local datagrams = {}
+    for i = 1, 10 do
+        datagrams[i] = tostring(i)
+    end
+    t.assert_equals(cg.sender:sendmmsg('127.0.0.1', cg.port, datagrams), 10)
+    local received = {}
+    while #received < 10 do
+        t.assert(cg.receiver:readable(1))
+        local batch = cg.receiver:recvmmsg(3, 10)
+        t.assert_le(#batch, 3)
+        for _, d in ipairs(batch) do
+            table.insert(received, d)
+        end
+    end
+    t.assert_equals(received, datagrams)
+end
+
+g.test_connected = function(cg)
+    t.assert(cg.sender:sysconnect('127.0.0.1', cg.port))
+    t.assert_equals(cg.sender:sendmmsg(nil, nil, {'a', 'b'}), 2)
+    local received = {}
+    while #received < 2 do
+        t.assert(cg.receiver:readable(1))
+        for _, d in ipairs(cg.receiver:recvmmsg(10, 10)) do
+            table.insert(received, d)
+        end
+    end
+    t.assert_equals(received, {'a', 'b'})
+end
+
+g.test_empty = function(cg)
+    t.assert_equals(cg.sender:sendmmsg('127.0.0.1', cg.port, {}), 0)
+    t.assert_equals(cg.receiver:recvmmsg(10, 10), nil)
+    t.assert_equals(cg.receiver:errno(), require('errno').EAGAIN)
+end
+
+g.test_errors = function(cg)
+    t.assert_error_msg_contains('Usage: socket:recvmmsg',
+                                cg.receiver.recvmmsg, cg.receiver, 0, 10)
+    t.assert_error_msg_contains('Usage: socket:sendmmsg',
+                                cg.sender.sendmmsg, cg.sender,
+                                '127.0.0.1', cg.port, 'abc')
+    t.assert_error_msg_contains('datagrams must be strings',
+                                cg.sender.sendmmsg, cg.sender,
+                                '127.0.0.1', cg.port, {{}})
+end
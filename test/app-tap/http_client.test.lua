@@ -65,7 +65,7 @@ local function stop_server(test, server)
 end
 
 local function test_http_client(test, url, opts)
-    test:plan(12)
+    test:plan(15)
 
     -- gh-4136: confusing httpc usage error message
     local ok, err = pcall(client.request, client)
@@ -88,6 +88,12 @@ local function test_http_client(test, url, opts)
     local r = client.request('GET', url, nil, opts)
     test:is(r.status, 200, 'request')
 
+    -- Plain HTTP requests fall back to HTTP/1.1.
+    r = client.get(url, merge(opts, {http2 = true}))
+    test:is(r.status, 200, 'http2: status')
+    test:is(r.proto[1], 1, 'http2: proto major http 1.1')
+    test:ok(r.body:match("hello") ~= nil, "http2: body")
+
     -- gh-4119: specify whether to follow 'Location' header
     test:test('gh-4119: follow location', function(test)
         test:plan(7)
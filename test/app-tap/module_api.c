@@ -2379,6 +2379,79 @@ test_tuple_validate_formatted(lua_State *L)
 	return 1;
 }
 
+struct commit_async_result {
+	int count;
+	int rc;
+};
+
+static void
+commit_async_cb(int rc, void *arg)
+{
+	struct commit_async_result *res = arg;
+	res->count++;
+	res->rc = rc;
+}
+
+static int
+test_txn_commit_async(lua_State *L)
+{
+	uint32_t space_id = box_space_id_by_name("test", strlen("test"));
+	assert(space_id != BOX_ID_NIL);
+	int rc;
+
+	/* No transaction. */
+	struct commit_async_result res = {0, -1};
+	rc = box_txn_commit_async(commit_async_cb, &res);
+	assert(rc == 0);
+	assert(res.count == 1 && res.rc == 0);
+
+	/* Several transactions in flight at once. */
+	enum { TXN_COUNT = 10 };
+	struct commit_async_result results[TXN_COUNT];
+	for (int i = 0; i < TXN_COUNT; i++) {
+		results[i].count = 0;
+		results[i].rc = -1;
+		char buf[16];
+		char *end = mp_encode_array(buf, 1);
+		end = mp_encode_uint(end, i);
+		rc = box_txn_begin();
+		assert(rc == 0);
+		rc = box_replace(space_id, buf, end, NULL);
+		assert(rc == 0);
+		rc = box_txn_commit_async(commit_async_cb, &results[i]);
+		assert(rc == 0);
+		assert(!box_txn());
+	}
+	for (int i = 0; i < TXN_COUNT; i++) {
+		while (results[i].count == 0)
+			fiber_sleep(0.001);
+		assert(results[i].count == 1 && results[i].rc == 0);
+	}
+
+	/*
+	 * A failed commit is reported by the callback: a memtx
+	 * transaction is aborted by a yield.
+	 */
+	res.count = 0;
+	char key[16];
+	char *key_end = mp_encode_array(key, 1);
+	key_end = mp_encode_uint(key_end, 0);
+	rc = box_txn_begin();
+	assert(rc == 0);
+	rc = box_delete(space_id, 0, key, key_end, NULL);
+	assert(rc == 0);
+	fiber_sleep(0);
+	rc = box_txn_commit_async(commit_async_cb, &res);
+	assert(rc == 0);
+	assert(res.count == 1 && res.rc == -1);
+	assert(box_error_last() != NULL);
+	assert(!box_txn());
+	(void)rc;
+
+	lua_pushboolean(L, 1);
+	return 1;
+}
+
 LUA_API int
 luaopen_module_api(lua_State *L)
 {
@@ -2422,6 +2495,7 @@ luaopen_module_api(lua_State *L)
 		{"tuple_validate_def", test_tuple_validate_default},
 		{"tuple_validate_fmt", test_tuple_validate_formatted},
 		{"test_key_def_dup", test_key_def_dup},
+		{"test_txn_commit_async", test_txn_commit_async},
 		{NULL, NULL}
 	};
 	luaL_register(L, "module_api", lib);
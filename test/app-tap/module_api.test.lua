@@ -223,7 +223,7 @@ local function test_iscdata(test, module)
 end
 
 require('tap').test("module_api", function(test)
-    test:plan(38)
+    test:plan(39)
     local status, module = pcall(require, 'module_api')
     test:is(status, true, "module")
     test:ok(status, "module is loaded")
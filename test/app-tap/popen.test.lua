@@ -7,6 +7,7 @@ local fiber = require('fiber')
 local clock = require('clock')
 local tap = require('tap')
 local fun = require('fun')
+local fio = require('fio')
 
 -- For process_is_alive().
 ffi.cdef([[
@@ -308,6 +309,49 @@ local function test_read_chunk(test)
     ph:close()
 end
 
+--
+-- Move child's stdout to a file with splice().
+--
+local function test_splice(test)
+    if jit.os ~= 'Linux' then
+        test:plan(1)
+        local ph = popen.shell('printf "hello"', 'r')
+        local ok, err = pcall(ph.splice, ph, 1)
+        test:ok(not ok and err.type == 'IllegalParams',
+                'splice() is not supported')
+        ph:close()
+        return
+    end
+
+    test:plan(3)
+
+    local dir = fio.tempdir()
+    local path = fio.pathjoin(dir, 'out')
+    local fh = fio.open(path, {'O_WRONLY', 'O_CREAT'}, tonumber('644', 8))
+    local script = 'for i in $(seq 1 10000); do echo "line $i"; done'
+    local ph = popen.shell(script, 'r')
+
+    local total = 0
+    local res, err
+    repeat
+        res, err = ph:splice(fh.fh, {size = 4096})
+        total = total + (res or 0)
+    until res == nil or res == 0
+    test:is_deeply({res, err}, {0, nil}, 'splice() moves data until EOF')
+    fh:close()
+    ph:close()
+
+    local lines = {}
+    for i = 1, 10000 do
+        table.insert(lines, ('line %d\n'):format(i))
+    end
+    local expected = table.concat(lines)
+    test:is(total, #expected, 'splice() returns moved amount')
+    test:ok(fio.open(path):read() == expected, 'file content')
+
+    fio.rmtree(dir)
+end
+
 --
 -- Ensure that shutdown() closes asked streams: at least
 -- it is reflected in a handle information.
@@ -458,6 +502,7 @@ local function test_methods_on_closed_handle(test)
         kill      = {},
         wait      = {},
         read      = {},
+        splice    = {1},
         write     = {'hello'},
         info      = {},
         -- Close call is idempotent one.
@@ -485,6 +530,7 @@ local function test_methods_on_invalid_handle(test)
         kill      = {},
         wait      = {},
         read      = {},
+        splice    = {1},
         write     = {'hello'},
         info      = {},
         close     = {},
@@ -517,7 +563,7 @@ local function test_methods_on_invalid_handle(test)
 end
 
 local test = tap.test('popen')
-test:plan(11)
+test:plan(12)
 
 test:test('trivial_echo_output', test_trivial_echo_output)
 test:test('kill_child_process', test_kill_child_process)
@@ -525,6 +571,7 @@ test:test('gc', test_gc)
 test:test('read_write', test_read_write)
 test:test('read_timeout', test_read_timeout)
 test:test('read_chunk', test_read_chunk)
+test:test('splice', test_splice)
 test:test('test_shutdown', test_shutdown)
 test:test('shell_invalid_args', test_shell_invalid_args)
 test:test('new_invalid_args', test_new_invalid_args)
@@ -0,0 +1,129 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+    cg.server:exec(function()
+        box.schema.user.create('alice')
+        box.schema.user.create('bob')
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        box.schema.sequence.create('seq')
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.session.su('admin')
+        box.space.test:truncate()
+        for _, name in ipairs({'alice', 'bob'}) do
+            box.schema.user.drop(name)
+            box.schema.user.create(name)
+        end
+    end)
+end)
+
+-- Checks of space access with grants on every level.
+g.test_space = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local s = box.space.test
+        local denied = "Read access to space 'test' is denied for user 'alice'"
+
+        box.session.su('alice')
+        t.assert_error_msg_content_equals(denied, s.select, s)
+        box.session.su('admin')
+
+        box.schema.user.grant('alice', 'read', 'space', 'test')
+        box.session.su('alice', function()
+            t.assert_equals(s:select(), {})
+            t.assert_error_msg_contains('Write access to space',
+                                        s.insert, s, {1})
+        end)
+
+        box.schema.user.revoke('alice', 'read', 'space', 'test')
+        box.session.su('alice', function()
+            t.assert_error_msg_content_equals(denied, s.select, s)
+        end)
+
+        box.schema.user.grant('alice', 'read,write', 'space')
+        box.session.su('alice', function()
+            s:insert({1})
+            t.assert_equals(s:select(), {{1}})
+        end)
+        box.schema.user.revoke('alice', 'read,write', 'space')
+
+        box.schema.user.grant('alice', 'read,write', 'universe')
+        box.session.su('alice', function()
+            s:replace({2})
+            t.assert_equals(s:select(), {{1}, {2}})
+        end)
+        box.schema.user.revoke('alice', 'read,write', 'universe')
+
+        box.schema.role.create('reader')
+        box.schema.role.grant('reader', 'read', 'space', 'test')
+        box.schema.user.grant('alice', 'reader')
+        box.session.su('alice', function()
+            t.assert_equals(s:select(), {{1}, {2}})
+        end)
+        box.schema.role.revoke('reader', 'read', 'space', 'test')
+        box.session.su('alice', function()
+            t.assert_error_msg_content_equals(denied, s.select, s)
+        end)
+        box.schema.role.drop('reader')
+
+        -- No usage on universe means no access at all.
+        box.schema.user.grant('bob', 'read', 'space', 'test')
+        box.schema.user.revoke('bob', 'usage', 'universe')
+        box.session.su('bob', function()
+            t.assert_error_msg_content_equals(
+                "Usage access to universe '' is denied for user 'bob'",
+                s.select, s)
+        end)
+    end)
+end
+
+-- The owner of a space has full access to it.
+g.test_space_owner = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('owned', {user = 'alice'})
+        s:create_index('pk')
+        box.session.su('alice', function()
+            s:insert({1})
+            t.assert_equals(s:select(), {{1}})
+        end)
+        box.space.owned:drop()
+    end)
+end
+
+g.test_sequence = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local seq = box.sequence.seq
+        box.session.su('alice', function()
+            t.assert_error_msg_contains('Write access to sequence',
+                                        seq.next, seq)
+        end)
+        box.schema.user.grant('alice', 'write', 'sequence', 'seq')
+        box.session.su('alice', function()
+            t.assert_type(seq:next(), 'number')
+        end)
+        box.schema.user.revoke('alice', 'write', 'sequence', 'seq')
+        box.session.su('alice', function()
+            t.assert_error_msg_contains('Write access to sequence',
+                                        seq.next, seq)
+        end)
+        box.schema.user.grant('alice', 'write', 'universe')
+        box.session.su('alice', function()
+            t.assert_type(seq:next(), 'number')
+        end)
+    end)
+end
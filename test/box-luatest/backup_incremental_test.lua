@@ -0,0 +1,111 @@
+local fio = require('fio')
+local fun = require('fun')
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group('backup_incremental')
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+    cg.server:exec(function()
+        for _, engine in ipairs({'memtx', 'vinyl'}) do
+            local s = box.schema.space.create(engine, {engine = engine})
+            s:create_index('pk')
+        end
+    end)
+    cg.restore_dir = fio.pathjoin(cg.server.workdir, 'restore')
+end)
+
+g.after_all(function(cg)
+    if cg.restored ~= nil then
+        cg.restored:drop()
+    end
+    cg.server:drop()
+end)
+
+-- Inserts the given tuples into both spaces, makes a checkpoint and
+-- copies the files of its backup to the restore directory. Returns
+-- the paths of the copied files relative to the work directory and
+-- the backup point.
+local function backup(cg, tuples, since)
+    return cg.server:exec(function(tuples, since, restore_dir)
+        local fio = require('fio')
+        for _, tuple in ipairs(tuples) do
+            box.space.memtx:replace(tuple)
+            box.space.vinyl:replace(tuple)
+        end
+        box.snapshot()
+        local files, point = box.backup.start(0, {since = since})
+        local cwd = fio.cwd()
+        for i, path in ipairs(files) do
+            path = fio.abspath(path):sub(#cwd + 2)
+            local dst = fio.pathjoin(restore_dir, path)
+            fio.mktree(fio.dirname(dst))
+            fio.copyfile(path, dst)
+            files[i] = path
+        end
+        box.backup.stop()
+        table.sort(files)
+        return files, point
+    end, {tuples, since, cg.restore_dir})
+end
+
+local function run_files(files)
+    local result = {}
+    for _, path in ipairs(files) do
+        if path:match('%.run$') or path:match('%.index$') then
+            table.insert(result, path)
+        end
+    end
+    return result
+end
+
+g.test_incremental = function(cg)
+    local full, point1 = backup(cg, {{1}, {2}})
+    t.assert_equals(point1.since, nil)
+    t.assert_gt(point1.vinyl_max_id, 0)
+    local full_runs = run_files(full)
+    t.assert_equals(#full_runs, 2)
+
+    local incr, point2 = backup(cg, {{3}}, point1)
+    t.assert_equals(point2.since, point1.signature)
+    t.assert_gt(point2.signature, point1.signature)
+    t.assert_gt(point2.vinyl_max_id, point1.vinyl_max_id)
+    -- The snapshot and the vylog are listed again, old runs are not.
+    t.assert_equals(#incr, 4, incr)
+    local incr_runs = run_files(incr)
+    t.assert_equals(#incr_runs, 2)
+    for _, path in ipairs(incr_runs) do
+        t.assert_not(fun.index(path, full_runs), path)
+    end
+
+    -- Nothing changed since the last checkpoint.
+    local files, point3 = backup(cg, {}, point2)
+    t.assert_equals(run_files(files), {})
+    t.assert_equals(point3.signature, point2.signature)
+    t.assert_equals(point3.vinyl_max_id, point2.vinyl_max_id)
+
+    -- The chain of the backups restores the last checkpoint.
+    cg.restored = server:new({alias = 'restored', workdir = cg.restore_dir})
+    cg.restored:start()
+    cg.restored:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.space.memtx:select(), {{1}, {2}, {3}})
+        t.assert_equals(box.space.vinyl:select(), {{1}, {2}, {3}})
+    end)
+end
+
+g.test_errors = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        t.assert_error_msg_equals('invalid backup options',
+                                  box.backup.start, 0, 'x')
+        t.assert_error_msg_equals('invalid backup point',
+                                  box.backup.start, 0, {since = {}})
+        t.assert_error_msg_content_equals(
+            "Illegal parameters, incremental backup can't be based " ..
+            "on a newer checkpoint", box.backup.start, 0,
+            {since = {signature = 2^52, vinyl_max_id = 0}})
+    end)
+end
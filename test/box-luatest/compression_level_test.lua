@@ -0,0 +1,65 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group('compression_level')
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        alias = 'master',
+        box_cfg = {
+            memtx_snap_compression_level = 19,
+            vinyl_compression_level = 1,
+            wal_compression_level = 5,
+        },
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_cfg = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.cfg.memtx_snap_compression_level, 19)
+        t.assert_equals(box.cfg.vinyl_compression_level, 1)
+        t.assert_equals(box.cfg.wal_compression_level, 5)
+        for _, option in ipairs({'memtx_snap_compression_level',
+                                 'vinyl_compression_level'}) do
+            t.assert_error_msg_contains(
+                "Incorrect value for option '" .. option .. "'",
+                box.cfg, {[option] = 0})
+        end
+        t.assert_error_msg_contains(
+            "Can't set option 'wal_compression_level' dynamically",
+            box.cfg, {wal_compression_level = 1})
+        box.cfg{memtx_snap_compression_level = 10}
+        t.assert_equals(box.cfg.memtx_snap_compression_level, 10)
+    end)
+end
+
+g.test_recovery = function(cg)
+    cg.server:exec(function()
+        local memtx = box.schema.space.create('memtx')
+        memtx:create_index('pk')
+        local vinyl = box.schema.space.create('vinyl', {engine = 'vinyl'})
+        vinyl:create_index('pk')
+        for i = 1, 1000 do
+            memtx:insert({i, string.rep('x', 100)})
+            vinyl:insert({i, string.rep('y', 100)})
+        end
+        box.snapshot()
+        for i = 1001, 2000 do
+            memtx:insert({i, string.rep('x', 100)})
+        end
+    end)
+    cg.server:restart()
+    cg.server:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.space.memtx:count(), 2000)
+        t.assert_equals(box.space.memtx:get(1500), {1500, string.rep('x', 100)})
+        t.assert_equals(box.space.vinyl:count(), 1000)
+        t.assert_equals(box.space.vinyl:get(500), {500, string.rep('y', 100)})
+    end)
+end
@@ -0,0 +1,71 @@
+local fio = require('fio')
+local net = require('net.box')
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group('cpu_affinity')
+
+-- Returns the first CPU this process may run on.
+local function first_allowed_cpu()
+    local status = fio.open('/proc/self/status'):read()
+    return status:match('Cpus_allowed_list:%s*(%d+)')
+end
+
+g.before_all(function(cg)
+    t.skip_if(jit.os ~= 'Linux', 'CPU affinity is supported only on Linux')
+    cg.cpu = first_allowed_cpu()
+    cg.server = server:new({
+        alias = 'master',
+        box_cfg = {
+            tx_cpu_affinity = cg.cpu,
+            wal_cpu_affinity = cg.cpu,
+            iproto_cpu_affinity = cg.cpu,
+            replication_cpu_affinity = cg.cpu,
+            iproto_busy_poll = 50,
+        },
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    if cg.server ~= nil then
+        cg.server:drop()
+    end
+end)
+
+g.test_cpu_affinity = function(cg)
+    cg.server:exec(function(cpu)
+        local fio = require('fio')
+        local t = require('luatest')
+        -- Map of thread name -> the CPUs it may run on.
+        local threads = {}
+        for _, tid in ipairs(fio.listdir('/proc/self/task')) do
+            local dir = fio.pathjoin('/proc/self/task', tid)
+            local name = fio.open(fio.pathjoin(dir, 'comm')):read()
+            local status = fio.open(fio.pathjoin(dir, 'status')):read()
+            if tonumber(tid) == box.info.pid then
+                name = 'tx'
+            end
+            threads[name:gsub('\n', '')] =
+                status:match('Cpus_allowed_list:%s*([%d,-]+)')
+        end
+        t.assert_equals(threads.tx, cpu)
+        t.assert_equals(threads.wal, cpu)
+        t.assert_equals(threads.iproto, cpu)
+        t.assert_error_msg_contains("Can't set option", box.cfg,
+                                    {tx_cpu_affinity = '0-1'})
+        t.assert_error_msg_contains("Can't set option", box.cfg,
+                                    {iproto_busy_poll = 0})
+    end, {cg.cpu})
+end
+
+g.test_busy_poll = function(cg)
+    t.assert_equals(cg.server:exec(function()
+        return box.cfg.iproto_busy_poll
+    end), 50)
+    local c = net.connect(cg.server.net_box_uri)
+    for _ = 1, 10 do
+        t.assert(c:ping())
+    end
+    c:close()
+end
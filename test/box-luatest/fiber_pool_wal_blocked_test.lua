@@ -0,0 +1,75 @@
+local net_box = require('net.box')
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group('fiber_pool_wal_blocked')
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        box.schema.user.grant('guest', 'super')
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+-- Workers waiting for WAL aren't counted against the TX fiber pool size,
+-- so queued requests start new workers, but at most twice the pool size
+-- (FIBER_POOL_BLOCKED_SIZE_FACTOR) are run at once.
+g.test_blocked_workers = function(cg)
+    local pool_size = 2
+    local request_count = 10
+    cg.server:exec(function(pool_size)
+        local fiber = require('fiber')
+        rawset(_G, 'old_net_msg_max', box.cfg.net_msg_max)
+        box.error.injection.set('ERRINJ_TX_FIBER_POOL_SIZE', pool_size)
+        box.cfg{net_msg_max = 64}
+        rawset(_G, 'active', 0)
+        rawset(_G, 'max_active', 0)
+        rawset(_G, 'insert', function(i)
+            _G.active = _G.active + 1
+            _G.max_active = math.max(_G.max_active, _G.active)
+            box.space.test:insert({i})
+            _G.active = _G.active - 1
+        end)
+        box.error.injection.set('ERRINJ_WAL_DELAY', true)
+        -- The requests below occupy all the workers, so the delay has to
+        -- be removed by a fiber that doesn't need a worker.
+        fiber.new(function()
+            local deadline = fiber.clock() + 60
+            while _G.active < 2 * pool_size and fiber.clock() < deadline do
+                fiber.sleep(0.01)
+            end
+            -- Give the pool a chance to start more workers than allowed.
+            fiber.sleep(0.1)
+            rawset(_G, 'observed_active', _G.active)
+            box.error.injection.set('ERRINJ_WAL_DELAY', false)
+        end)
+    end, {pool_size})
+
+    local conn = net_box.connect(cg.server.net_box_uri)
+    local futures = {}
+    for i = 1, request_count do
+        table.insert(futures, conn:call('insert', {i}, {is_async = true}))
+    end
+    for _, f in ipairs(futures) do
+        t.assert_equals({f:wait_result(60)}, {})
+    end
+    conn:close()
+
+    cg.server:exec(function(pool_size, request_count)
+        local t = require('luatest')
+        t.assert_equals(_G.observed_active, 2 * pool_size)
+        t.assert_equals(_G.max_active, 2 * pool_size)
+        t.assert_equals(box.space.test:count(), request_count)
+        box.error.injection.set('ERRINJ_TX_FIBER_POOL_SIZE', -1)
+        box.cfg{net_msg_max = _G.old_net_msg_max}
+    end, {pool_size, request_count})
+    t.assert(cg.server:grep_log('fiber pool size ' .. pool_size ..
+                                ' reached on endpoint tx'))
+end
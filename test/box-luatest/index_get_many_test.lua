@@ -0,0 +1,85 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group('index_get_many', {
+    {engine = 'memtx', index_type = 'TREE'},
+    {engine = 'memtx', index_type = 'HASH'},
+    {engine = 'vinyl', index_type = 'TREE'},
+})
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_get_many = function(cg)
+    cg.server:exec(function(engine, index_type)
+        local s = box.schema.space.create('test', {engine = engine})
+        s:create_index('pk', {type = index_type})
+        s:create_index('sk', {type = index_type, parts = {{2, 'string'}}})
+        for i = 1, 1000 do
+            s:insert({i, 'v' .. i})
+        end
+        t.assert_equals(s:get_many({}), {})
+        t.assert_equals(s:get_many({1, 0, {1000}, 1001, 500}),
+                        {{1, 'v1'}, {1000, 'v1000'}, {500, 'v500'}})
+        t.assert_equals(s.index.sk:get_many({'v10', 'x', 'v5'}),
+                        {{10, 'v10'}, {5, 'v5'}})
+
+        local keys = {}
+        local expected = {}
+        for i = 2000, 1, -3 do
+            table.insert(keys, i)
+            if i <= 1000 then
+                table.insert(expected, {i, 'v' .. i})
+            end
+        end
+        t.assert_equals(s:get_many(keys), expected)
+
+        -- Changes made in a transaction are visible.
+        box.begin()
+        s:delete(1)
+        s:replace({1001, 'v1001'})
+        t.assert_equals(s:get_many({1, 1001}), {{1001, 'v1001'}})
+        box.rollback()
+        t.assert_equals(s:get_many({1, 1001}), {{1, 'v1'}})
+    end, {cg.params.engine, cg.params.index_type})
+end
+
+g.test_errors = function(cg)
+    cg.server:exec(function(engine, index_type)
+        local s = box.schema.space.create('test', {engine = engine})
+        s:create_index('pk', {type = index_type})
+        s:create_index('sk', {type = 'TREE', unique = false,
+                              parts = {{2, 'string'}}})
+        s:create_index('ck', {type = index_type,
+                              parts = {{2, 'string'}, {3, 'unsigned'}}})
+        s:insert({1, 'a', 1})
+        t.assert_error_msg_content_equals(
+            "Illegal parameters, Usage: index:get_many({key1, key2, ...})",
+            s.get_many, s, 1)
+        t.assert_error_msg_content_equals(
+            "Get() doesn't support partial keys and non-unique indexes",
+            s.index.sk.get_many, s.index.sk, {'a'})
+        t.assert_error_msg_content_equals(
+            "Supplied key type of part 0 does not match index part type: " ..
+            "expected unsigned",
+            s.get_many, s, {1, 'a'})
+        t.assert_error_msg_content_equals(
+            "Invalid key part count in an exact match (expected 2, got 1)",
+            s.index.ck.get_many, s.index.ck, {{'a', 1}, {'a'}})
+        t.assert_equals(s.index.ck:get_many({{'a', 1}}), {{1, 'a', 1}})
+    end, {cg.params.engine, cg.params.index_type})
+end
@@ -0,0 +1,136 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group('index_hot_keys', {
+    {engine = 'memtx', index_type = 'TREE'},
+    {engine = 'memtx', index_type = 'HASH'},
+    {engine = 'vinyl', index_type = 'TREE'},
+})
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.before_each(function(cg)
+    cg.server:exec(function(engine, index_type)
+        local s = box.schema.space.create('test', {engine = engine})
+        s:create_index('pk', {type = index_type})
+        s:create_index('sk', {type = index_type, parts = {{2, 'string'}}})
+        for i = 1, 10 do
+            s:insert({i, 'v' .. i})
+        end
+    end, {cg.params.engine, cg.params.index_type})
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.space.test:drop()
+    end)
+end)
+
+g.test_hot_keys = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        local function hot_keys(index, k)
+            local res = {}
+            for _, v in ipairs(index:hot_keys(k)) do
+                table.insert(res, {v[1]:totable(), v[2]})
+            end
+            return res
+        end
+
+        t.assert_error_msg_content_equals(
+            "hot key tracking is disabled", s.index.pk.hot_keys, s.index.pk)
+
+        s.index.pk:hot_keys_enable({sample_rate = 1})
+        t.assert_equals(hot_keys(s.index.pk), {})
+        for _ = 1, 5 do
+            s:get({3})
+        end
+        for _ = 1, 4 do
+            s:select({7})
+        end
+        s:replace({5, 'v5'})
+        s:update({5}, {{'=', 3, 'x'}})
+        s:upsert({5, 'v5'}, {{'=', 3, 'y'}})
+        -- Partial keys and keys of other iterators aren't accounted.
+        s:select({})
+        s:select({1}, {iterator = 'GT'})
+        s:get({1})
+        t.assert_equals(hot_keys(s.index.pk), {
+            {{3}, 5}, {{7}, 4}, {{5}, 3}, {{1}, 1},
+        })
+        t.assert_equals(hot_keys(s.index.pk, 2), {{{3}, 5}, {{7}, 4}})
+        t.assert_equals(hot_keys(s.index.pk, 0), {})
+
+        -- Other indexes aren't affected.
+        t.assert_error_msg_content_equals(
+            "hot key tracking is disabled", s.index.sk.hot_keys, s.index.sk)
+        s.index.sk:hot_keys_enable({sample_rate = 1})
+        s.index.sk:get({'v2'})
+        s.index.sk:delete({'v2'})
+        t.assert_equals(hot_keys(s.index.sk), {{{'v2'}, 2}})
+        t.assert_equals(#hot_keys(s.index.pk), 4)
+
+        -- Enabling again drops the statistics.
+        s.index.pk:hot_keys_enable()
+        t.assert_equals(hot_keys(s.index.pk), {})
+
+        s.index.pk:hot_keys_disable()
+        t.assert_error_msg_content_equals(
+            "hot key tracking is disabled", s.index.pk.hot_keys, s.index.pk)
+        s.index.pk:hot_keys_disable()
+    end)
+end
+
+g.test_sampling = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        s.index.pk:hot_keys_enable({sample_rate = 4})
+        for _ = 1, 4000 do
+            s:get({1})
+        end
+        for _ = 1, 400 do
+            s:get({2})
+        end
+        local res = s.index.pk:hot_keys()
+        t.assert_equals(#res, 2)
+        t.assert_equals(res[1][1]:totable(), {1})
+        t.assert_almost_equals(res[1][2], 4000, 400)
+        t.assert_equals(res[2][1]:totable(), {2})
+        t.assert_almost_equals(res[2][2], 400, 200)
+    end)
+end
+
+g.test_errors = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        t.assert_error_msg_content_equals(
+            "sample_rate must be in range [1, 1048576]",
+            s.index.pk.hot_keys_enable, s.index.pk, {sample_rate = 0})
+        t.assert_error_msg_content_equals(
+            "unexpected option 'foo'",
+            s.index.pk.hot_keys_enable, s.index.pk, {foo = 1})
+        t.assert_error_msg_content_equals(
+            "Usage: index:hot_keys([k])",
+            s.index.pk.hot_keys, s.index.pk, 'x')
+    end)
+end
+
+g.test_unsupported = function(cg)
+    t.skip_if(cg.params.engine ~= 'memtx' or cg.params.index_type ~= 'TREE')
+    cg.server:exec(function()
+        local s = box.space.test
+        s:create_index('bitset', {type = 'BITSET', unique = false,
+                                  parts = {{2, 'string'}}})
+        t.assert_error_msg_content_equals(
+            "Index 'bitset' (BITSET) of space 'test' (memtx) does not " ..
+            "support hot key tracking",
+            s.index.bitset.hot_keys_enable, s.index.bitset)
+    end)
+end
@@ -0,0 +1,95 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group('index_pairs_batch', {
+    {engine = 'memtx'}, {engine = 'vinyl'},
+})
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.before_each(function(cg)
+    cg.server:exec(function(engine)
+        local s = box.schema.space.create('test', {engine = engine})
+        s:create_index('pk')
+        s:create_index('sk', {unique = false, parts = {{2, 'unsigned'}}})
+        for i = 1, 100 do
+            s:insert({i, i % 7})
+        end
+    end, {cg.params.engine})
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.space.test:drop()
+    end)
+end)
+
+g.test_pairs = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        local iterators = {'EQ', 'REQ', 'ALL', 'LT', 'LE', 'GE', 'GT'}
+        local keys = {
+            pk = {{}, {1}, {50}, {100}},
+            sk = {{}, {0}, {3}, {6}},
+        }
+        for name, index_keys in pairs(keys) do
+            local index = s.index[name]
+            for _, key in ipairs(index_keys) do
+                for _, it in ipairs(iterators) do
+                    local expected = index:select(key, {iterator = it})
+                    for _, size in ipairs({1, 7, 15, 1000}) do
+                        local result = {}
+                        for _, tuple in index:pairs(key, {iterator = it,
+                                                          batch_size = size}) do
+                            table.insert(result, tuple)
+                        end
+                        t.assert_equals(result, expected,
+                                        {name, key, it, size})
+                    end
+                end
+            end
+        end
+        t.assert_equals(s:pairs({}, {batch_size = 10}):totable(),
+                        s:select())
+        t.assert_equals(s:pairs({}, {batch_size = 10}):take(3):totable(),
+                        s:select({}, {limit = 3}))
+    end)
+end
+
+-- Prefetched tuples stay valid when the space is modified while
+-- the loop is running.
+g.test_modify = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        local expected = s:select()
+        local result = {}
+        box.begin()
+        for _, tuple in s:pairs({}, {batch_size = 16}) do
+            s:delete({tuple[1]})
+            table.insert(result, tuple)
+        end
+        box.commit()
+        t.assert_equals(result, expected)
+        t.assert_equals(s:count(), 0)
+        collectgarbage()
+    end)
+end
+
+g.test_errors = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        local msg = "Illegal parameters, options parameter 'batch_size' " ..
+                    "should be a positive integer"
+        for _, size in ipairs({0, -1, 1.5, 'x', 2^32}) do
+            t.assert_error_msg_content_equals(
+                msg, s.pairs, s, {}, {batch_size = size})
+        end
+    end)
+end
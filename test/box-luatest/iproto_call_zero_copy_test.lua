@@ -0,0 +1,61 @@
+local net_box = require('net.box')
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group('iproto_call_zero_copy')
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+    cg.server:exec(function()
+        local build_path = os.getenv('BUILDDIR')
+        package.cpath = build_path .. '/test/box/?.so;' ..
+                        build_path .. '/test/box/?.dylib;' .. package.cpath
+        box.schema.func.create('function1.test_return_repeat',
+                               {language = 'C'})
+        box.schema.user.grant('guest', 'execute', 'function',
+                              'function1.test_return_repeat')
+    end)
+    cg.conn = net_box.connect(cg.server.net_box_uri)
+end)
+
+g.after_all(function(cg)
+    cg.conn:close()
+    cg.server:drop()
+end)
+
+local function expected(count, value)
+    local res = {}
+    for _ = 1, count do
+        table.insert(res, value)
+    end
+    return res
+end
+
+-- Results of C functions bigger than IPROTO_SELECT_ZC_SIZE_MIN are sent
+-- from the port directly, small ones are copied to the output buffer.
+-- Check that both are sent correctly, for MsgPack values and tuples.
+g.test_call = function(cg)
+    local value = {1, string.rep('x', 1000)}
+    for _, count in ipairs({1, 2, 10, 100, 1000}) do
+        local res = {cg.conn:call('function1.test_return_repeat',
+                                  {count, value})}
+        t.assert_equals(res, expected(count, value))
+    end
+end
+
+-- Check that responses to pipelined requests aren't reordered.
+g.test_pipelined = function(cg)
+    local value = {2, string.rep('y', 500)}
+    local futures = {}
+    for i = 1, 20 do
+        local count = i % 2 == 0 and i or 200
+        table.insert(futures, cg.conn:call('function1.test_return_repeat',
+                                           {count, value},
+                                           {is_async = true}))
+    end
+    for i, f in ipairs(futures) do
+        local count = i % 2 == 0 and i or 200
+        t.assert_equals(f:wait_result(), expected(count, value))
+    end
+end
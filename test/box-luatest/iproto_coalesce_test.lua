@@ -0,0 +1,90 @@
+local clock = require('clock')
+local net_box = require('net.box')
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group('iproto_coalesce')
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        box.schema.user.grant('guest', 'read,write', 'space', 'test')
+    end)
+    cg.conn = net_box.connect(cg.server.net_box_uri)
+end)
+
+g.after_all(function(cg)
+    cg.conn:close()
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.cfg{iproto_coalesce_size = 0, iproto_coalesce_timeout = 0.001}
+        box.space.test:truncate()
+    end)
+end)
+
+g.test_cfg = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        t.assert_error_msg_equals(
+            "Incorrect value for option 'iproto_coalesce_size': " ..
+            "specified value is out of bounds",
+            box.cfg, {iproto_coalesce_size = -1})
+        t.assert_error_msg_equals(
+            "Incorrect value for option 'iproto_coalesce_timeout': " ..
+            "value must be >= 0",
+            box.cfg, {iproto_coalesce_timeout = -1})
+        t.assert_equals(box.cfg.iproto_coalesce_size, 0)
+        t.assert_equals(box.cfg.iproto_coalesce_timeout, 0.001)
+    end)
+end
+
+-- Replies are flushed as soon as there are no more requests in
+-- progress, so neither a lone request nor a batch of pipelined
+-- requests waits for the timeout.
+g.test_no_delay = function(cg)
+    cg.server:exec(function()
+        box.cfg{iproto_coalesce_size = 1024 * 1024,
+                iproto_coalesce_timeout = 60}
+    end)
+    local space = cg.conn.space.test
+    local start = clock.monotonic()
+    space:replace({0})
+    t.assert_equals(space:get(0), {0})
+    local futures = {}
+    for i = 1, 100 do
+        table.insert(futures, space:replace({i}, {is_async = true}))
+    end
+    for i, future in ipairs(futures) do
+        t.assert_equals(future:wait_result(), {i})
+    end
+    t.assert_lt(clock.monotonic() - start, 30)
+    t.assert_equals(space:count(), 101)
+end
+
+-- If a request takes long to process, replies to the requests
+-- completed before it are flushed after the timeout.
+g.test_timeout = function(cg)
+    cg.server:exec(function()
+        rawset(_G, 'cond', require('fiber').cond())
+        rawset(_G, 'wait', function() _G.cond:wait() end)
+        box.schema.func.create('wait')
+        box.schema.user.grant('guest', 'execute', 'function', 'wait')
+        box.cfg{iproto_coalesce_size = 1024 * 1024,
+                iproto_coalesce_timeout = 0.01}
+    end)
+    local wait = cg.conn:call('wait', {}, {is_async = true})
+    local future = cg.conn.space.test:replace({1}, {is_async = true})
+    t.assert_equals(future:wait_result(10), {1})
+    t.assert_not(wait:is_ready())
+    cg.server:exec(function()
+        _G.cond:signal()
+        box.schema.func.drop('wait')
+    end)
+    t.assert_equals(wait:wait_result(10), {})
+end
@@ -0,0 +1,121 @@
+local net_box = require('net.box')
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group('iproto_read_view')
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        alias = 'master',
+        box_cfg = {memtx_use_mvcc_engine = true},
+    })
+    cg.server:start()
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {read_view_enabled = true})
+        s:create_index('pk')
+        s:create_index('sk', {parts = {2, 'unsigned'}, unique = false})
+        s:create_index('hash', {type = 'hash', parts = {3, 'string'}})
+        for i = 1, 100 do
+            s:insert({i, i % 10, tostring(i)})
+        end
+        box.schema.user.grant('guest', 'read,write', 'space', 'test')
+    end)
+    cg.conn = net_box.connect(cg.server.net_box_uri)
+end)
+
+g.after_all(function(cg)
+    cg.conn:close()
+    cg.server:drop()
+end)
+
+g.test_space_option = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        t.assert(box.space.test.read_view_enabled)
+        local s = box.schema.space.create('test2')
+        t.assert_not(s.read_view_enabled)
+        s:alter({read_view_enabled = true})
+        t.assert(s.read_view_enabled)
+        s:drop()
+        t.assert_error_msg_contains(
+            'engine does not support read_view_enabled flag',
+            box.schema.space.create, 'test2',
+            {engine = 'vinyl', read_view_enabled = true})
+    end)
+end
+
+-- Results of selects executed against a read view must be the same
+-- as of selects executed in tx.
+g.test_select = function(cg)
+    local requests = {
+        {{}, {}},
+        {{}, {iterator = 'REQ'}},
+        {{50}, {}},
+        {{50}, {iterator = 'GE', limit = 10}},
+        {{50}, {iterator = 'GT', offset = 5, limit = 10}},
+        {{50}, {iterator = 'LE', limit = 10}},
+        {{50}, {iterator = 'LT', offset = 5}},
+        {{1000}, {}},
+        {{1000}, {iterator = 'LT', limit = 3}},
+        {{0}, {iterator = 'GT', limit = 3}},
+    }
+    local index_requests = {
+        {{3}, {}},
+        {{3}, {iterator = 'REQ'}},
+        {{3}, {iterator = 'REQ', limit = 3, offset = 2}},
+        {{0}, {}},
+        {{9}, {iterator = 'REQ'}},
+        {{10}, {}},
+        {{5}, {iterator = 'GT', limit = 15}},
+    }
+    for _, r in ipairs(requests) do
+        local expected = cg.server:exec(function(key, opts)
+            return box.space.test:select(key, opts)
+        end, r)
+        t.assert_equals(cg.conn.space.test:select(r[1], r[2]), expected)
+    end
+    for _, r in ipairs(index_requests) do
+        local expected = cg.server:exec(function(key, opts)
+            return box.space.test.index.sk:select(key, opts)
+        end, r)
+        t.assert_equals(cg.conn.space.test.index.sk:select(r[1], r[2]),
+                        expected)
+    end
+    -- Not supported by read views, executed in tx.
+    t.assert_equals(cg.conn.space.test.index.hash:select({'7'}),
+                    {{7, 7, '7'}})
+end
+
+g.test_changes = function(cg)
+    local s = cg.conn.space.test
+    s:replace({1, 1, 'a'})
+    t.assert_equals(s:select({1}), {{1, 1, 'a'}})
+    s:delete({1})
+    t.assert_equals(s:select({1}), {})
+    s:insert({1, 1, '1'})
+    t.assert_equals(s:select({1}), {{1, 1, '1'}})
+end
+
+-- A select in a stream transaction must see the transaction changes.
+g.test_stream = function(cg)
+    local stream = cg.conn:new_stream()
+    local s = stream.space.test
+    stream:begin()
+    s:replace({1, 1, 'b'})
+    t.assert_equals(s:select({1}), {{1, 1, 'b'}})
+    t.assert_equals(cg.conn.space.test:select({1}), {{1, 1, '1'}})
+    stream:rollback()
+    t.assert_equals(s:select({1}), {{1, 1, '1'}})
+end
+
+g.test_access = function(cg)
+    cg.server:exec(function()
+        box.schema.user.revoke('guest', 'read,write', 'space', 'test')
+    end)
+    t.assert_error_msg_contains("Read access to space 'test' is denied",
+                                cg.conn.space.test.select,
+                                cg.conn.space.test, {})
+    cg.server:exec(function()
+        box.schema.user.grant('guest', 'read,write', 'space', 'test')
+    end)
+end
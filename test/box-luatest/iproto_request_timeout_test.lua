@@ -0,0 +1,128 @@
+local msgpack = require('msgpack')
+local server = require('test.luatest_helpers.server')
+local socket = require('socket')
+local t = require('luatest')
+
+local IPROTO_REQUEST_TYPE = 0x00
+local IPROTO_SYNC = 0x01
+local IPROTO_REQUEST_TIMEOUT = 0x0b
+local IPROTO_SPACE_ID = 0x10
+local IPROTO_TUPLE = 0x21
+local IPROTO_EXPR = 0x27
+local IPROTO_ERROR_24 = 0x31
+
+local IPROTO_INSERT = 2
+local IPROTO_EVAL = 8
+local IPROTO_TYPE_ERROR = 0x8000
+
+local g = t.group('iproto_request_timeout')
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+    cg.space_id = cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        box.schema.user.grant('guest', 'read,write', 'space', 'test')
+        box.schema.user.grant('guest', 'execute', 'universe')
+        return s.id
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.before_each(function(cg)
+    cg.sock = socket.tcp_connect('unix/', cg.server.net_box_uri)
+    t.assert(cg.sock)
+    -- Skip the greeting.
+    t.assert_equals(#cg.sock:read(128), 128)
+end)
+
+g.after_each(function(cg)
+    cg.sock:close()
+    cg.server:exec(function()
+        box.space.test:truncate()
+    end)
+end)
+
+local function encode_request(header, body)
+    header = msgpack.encode(header)
+    body = msgpack.encode(body)
+    return msgpack.encode(#header + #body) .. header .. body
+end
+
+local function read_response(sock)
+    local size = msgpack.decode(sock:read(5))
+    local data = sock:read(size)
+    local header, pos = msgpack.decode(data)
+    local body = msgpack.decode(data, pos)
+    return header, body
+end
+
+local function encode_insert(cg, sync, tuple, timeout)
+    return encode_request({
+        [IPROTO_REQUEST_TYPE] = IPROTO_INSERT,
+        [IPROTO_SYNC] = sync,
+        [IPROTO_REQUEST_TIMEOUT] = timeout,
+    }, {
+        [IPROTO_SPACE_ID] = cg.space_id,
+        [IPROTO_TUPLE] = tuple,
+    })
+end
+
+local function requests_expired(cg)
+    return cg.server:exec(function()
+        return box.stat.net().REQUESTS_EXPIRED.total
+    end)
+end
+
+g.test_expired = function(cg)
+    local expired = requests_expired(cg)
+    -- The insert is queued behind an eval that occupies the tx thread
+    -- without yielding for longer than the insert timeout.
+    local spin = encode_request({
+        [IPROTO_REQUEST_TYPE] = IPROTO_EVAL,
+        [IPROTO_SYNC] = 1,
+    }, {
+        [IPROTO_EXPR] = [[
+            local clock = require('clock')
+            local deadline = clock.monotonic() + 0.3
+            while clock.monotonic() < deadline do end
+        ]],
+        [IPROTO_TUPLE] = {},
+    })
+    cg.sock:write(spin .. encode_insert(cg, 2, {1}, 0.05))
+    local header = read_response(cg.sock)
+    t.assert_equals(header[IPROTO_SYNC], 1)
+    t.assert_equals(header[IPROTO_REQUEST_TYPE], 0)
+    local body
+    header, body = read_response(cg.sock)
+    t.assert_equals(header[IPROTO_SYNC], 2)
+    t.assert_equals(header[IPROTO_REQUEST_TYPE],
+                    bit.bor(IPROTO_TYPE_ERROR, box.error.REQUEST_EXPIRED))
+    t.assert_str_matches(body[IPROTO_ERROR_24],
+                         'Request has waited for [0-9.]+ sec, longer ' ..
+                         'than its timeout 0.050 sec, and was not processed')
+    t.assert_equals(requests_expired(cg), expired + 1)
+    t.assert_equals(cg.server:exec(function()
+        return box.space.test:select()
+    end), {})
+end
+
+g.test_not_expired = function(cg)
+    local expired = requests_expired(cg)
+    cg.sock:write(encode_insert(cg, 1, {1}, 100.5))
+    local header = read_response(cg.sock)
+    t.assert_equals(header[IPROTO_SYNC], 1)
+    t.assert_equals(header[IPROTO_REQUEST_TYPE], 0)
+    cg.sock:write(encode_insert(cg, 2, {2}))
+    header = read_response(cg.sock)
+    t.assert_equals(header[IPROTO_SYNC], 2)
+    t.assert_equals(header[IPROTO_REQUEST_TYPE], 0)
+    t.assert_equals(requests_expired(cg), expired)
+    t.assert_equals(cg.server:exec(function()
+        return box.space.test:select()
+    end), {{1}, {2}})
+end
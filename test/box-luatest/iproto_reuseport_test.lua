@@ -0,0 +1,57 @@
+local net_box = require('net.box')
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group('iproto_reuseport')
+
+local IPROTO_THREADS = 4
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        alias = 'master',
+        box_cfg = {iproto_threads = IPROTO_THREADS},
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_reuseport = function(cg)
+    local uri = cg.server:exec(function()
+        box.cfg{listen = {box.cfg.listen, 'localhost:0?reuseport=true'}}
+        return box.info.listen[2]
+    end)
+    local conns = {}
+    for _ = 1, 10 * IPROTO_THREADS do
+        local conn = net_box.connect(uri)
+        t.assert(conn:ping())
+        table.insert(conns, conn)
+    end
+    cg.server:exec(function(thread_count)
+        local t = require('luatest')
+        local stat = box.stat.net.thread()
+        t.assert_equals(#stat, thread_count)
+        for _, s in ipairs(stat) do
+            t.assert_gt(s.CONNECTIONS.total, 0)
+        end
+    end, {IPROTO_THREADS})
+    for _, conn in ipairs(conns) do
+        conn:close()
+    end
+    cg.server:exec(function()
+        box.cfg{listen = box.cfg.listen[1]}
+    end)
+end
+
+g.test_invalid_value = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local listen = box.cfg.listen
+        t.assert_error_msg_contains(
+            "invalid reuseport value: abc", box.cfg,
+            {listen = {listen, 'localhost:0?reuseport=abc'}})
+        t.assert_equals(box.cfg.listen, listen)
+    end)
+end
@@ -0,0 +1,90 @@
+local net_box = require('net.box')
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group('iproto_select_batch')
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        alias = 'master',
+        box_cfg = {memtx_use_mvcc_engine = true},
+    })
+    cg.server:start()
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:create_index('sk', {parts = {2, 'string'}})
+        s:create_index('nu', {parts = {3, 'unsigned'}, unique = false})
+        for i = 1, 1000 do
+            s:insert({i, 'v' .. i, i % 10})
+        end
+        box.schema.space.create('secret'):create_index('pk')
+        box.schema.user.grant('guest', 'read,write', 'space', 'test')
+    end)
+    cg.conn = net_box.connect(cg.server.net_box_uri)
+end)
+
+g.after_all(function(cg)
+    cg.conn:close()
+    cg.server:drop()
+end)
+
+g.test_get_many = function(cg)
+    local s = cg.conn.space.test
+    t.assert_equals(s:get_many({}), {})
+    t.assert_equals(s:get_many({3, 0, {2}, 1001}),
+                    {{3, 'v3', 3}, {2, 'v2', 2}})
+    t.assert_equals(s.index.sk:get_many({'v10', 'x', 'v7'}),
+                    {{10, 'v10', 0}, {7, 'v7', 7}})
+
+    -- Big result sets are sent by the iproto thread.
+    local keys = {}
+    for i = 1, 1000 do
+        keys[i] = i
+    end
+    local expected = cg.server:exec(function()
+        return box.space.test:select()
+    end)
+    t.assert_equals(s:get_many(keys), expected)
+
+    local stat = cg.server:exec(function()
+        return box.stat().SELECT.total
+    end)
+    s:get_many(keys)
+    t.assert_equals(cg.server:exec(function()
+        return box.stat().SELECT.total
+    end), stat + 1)
+end
+
+g.test_errors = function(cg)
+    local s = cg.conn.space.test
+    t.assert_error_msg_content_equals(
+        "Get() doesn't support partial keys and non-unique indexes",
+        s.index.nu.get_many, s.index.nu, {1})
+    t.assert_error_msg_content_equals(
+        "Supplied key type of part 0 does not match index part type: " ..
+        "expected unsigned",
+        s.get_many, s, {1, 'a'})
+    t.assert_error_msg_content_equals(
+        "Read access to space 'secret' is denied for user 'guest'",
+        function()
+            local secret = cg.server:exec(function()
+                return box.space.secret.id
+            end)
+            cg.conn:_request(net_box._method.get_many, nil, nil, nil,
+                             secret, 0, {{1}})
+        end)
+end
+
+g.test_stream = function(cg)
+    local stream = cg.conn:new_stream()
+    local s = stream.space.test
+    stream:begin()
+    s:replace({1, 'new', 1})
+    s:delete(2)
+    t.assert_equals(s:get_many({1, 2, 3}), {{1, 'new', 1}, {3, 'v3', 3}})
+    t.assert_equals(cg.conn.space.test:get_many({1, 2}),
+                    {{1, 'v1', 1}, {2, 'v2', 2}})
+    stream:rollback()
+    t.assert_equals(s:get_many({1, 2}), {{1, 'v1', 1}, {2, 'v2', 2}})
+end
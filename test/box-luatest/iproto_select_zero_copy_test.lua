@@ -0,0 +1,61 @@
+local net_box = require('net.box')
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group('iproto_select_zero_copy')
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        box.begin()
+        for i = 1, 2000 do
+            s:insert({i, string.rep('x', i % 100)})
+        end
+        box.commit()
+        box.schema.user.grant('guest', 'read', 'space', 'test')
+    end)
+    cg.conn = net_box.connect(cg.server.net_box_uri)
+end)
+
+g.after_all(function(cg)
+    cg.conn:close()
+    cg.server:drop()
+end)
+
+local function expected(from, to)
+    local res = {}
+    for i = from, to do
+        table.insert(res, {i, string.rep('x', i % 100)})
+    end
+    return res
+end
+
+-- Big result sets are sent from the tuples directly, small ones are
+-- copied to the output buffer. Check that both are sent correctly.
+g.test_select = function(cg)
+    local s = cg.conn.space.test
+    t.assert_equals(s:select({}, {limit = 1}), expected(1, 1))
+    t.assert_equals(s:select({}), expected(1, 2000))
+    t.assert_equals(s:select({1000}, {iterator = 'GE', limit = 500}),
+                    expected(1000, 1499))
+end
+
+-- Check that responses to pipelined requests aren't reordered.
+g.test_pipelined = function(cg)
+    local s = cg.conn.space.test
+    local futures = {}
+    for i = 1, 20 do
+        local opts = {is_async = true}
+        if i % 2 == 0 then
+            opts.limit = i
+        end
+        table.insert(futures, s:select({}, opts))
+    end
+    for i, f in ipairs(futures) do
+        local res = f:wait_result()
+        t.assert_equals(res, expected(1, i % 2 == 0 and i or 2000))
+    end
+end
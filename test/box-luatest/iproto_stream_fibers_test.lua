@@ -0,0 +1,62 @@
+local net_box = require('net.box')
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group()
+
+local STREAM_COUNT = 1000
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        alias = 'master',
+        box_cfg = {memtx_use_mvcc_engine = true},
+    })
+    cg.server:start()
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        box.schema.user.grant('guest', 'read,write', 'space', 'test')
+    end)
+    cg.conn = net_box.connect(cg.server.net_box_uri)
+end)
+
+g.after_all(function(cg)
+    cg.conn:close()
+    cg.server:drop()
+end)
+
+-- Transactions of idle streams are detached from fibers, so open
+-- streams don't hold tx fibers.
+g.test_open_transactions_hold_no_fibers = function(cg)
+    local fiber_count = cg.server:exec(function()
+        return require('fun').length(require('fiber').info())
+    end)
+    local streams = {}
+    for i = 1, STREAM_COUNT do
+        local stream = cg.conn:new_stream()
+        stream:begin()
+        stream.space.test:replace({i})
+        streams[i] = stream
+    end
+    cg.server:exec(function(fiber_count, stream_count)
+        local t = require('luatest')
+        local fiber = require('fiber')
+        t.assert_equals(box.space.test:count(), 0)
+        t.assert_equals(box.stat.net().STREAMS.current, stream_count)
+        t.assert_lt(require('fun').length(fiber.info()),
+                    fiber_count + 50)
+    end, {fiber_count, STREAM_COUNT})
+    -- Any tx fiber continues any stream's transaction.
+    for i = STREAM_COUNT, 1, -1 do
+        streams[i].space.test:replace({i, i})
+        streams[i]:commit()
+    end
+    cg.server:exec(function(stream_count)
+        local t = require('luatest')
+        t.assert_equals(box.space.test:count(), stream_count)
+        t.assert_equals(box.space.test:get(1), {1, 1})
+        t.helpers.retrying({}, function()
+            t.assert_equals(box.stat.net().STREAMS.current, 0)
+        end)
+    end, {STREAM_COUNT})
+end
@@ -0,0 +1,130 @@
+local fiber = require('fiber')
+local net_box = require('net.box')
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group('iproto_watch_broadcast', {
+    {iproto_threads = 1},
+    {iproto_threads = 4},
+})
+
+local CONN_COUNT = 100
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        alias = 'master',
+        box_cfg = {iproto_threads = cg.params.iproto_threads},
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.before_each(function(cg)
+    cg.conns = {}
+    for i = 1, CONN_COUNT do
+        cg.conns[i] = net_box.connect(cg.server.net_box_uri)
+    end
+end)
+
+g.after_each(function(cg)
+    for _, conn in ipairs(cg.conns) do
+        conn:close()
+    end
+    cg.server:exec(function()
+        box.broadcast('foo', nil)
+    end)
+end)
+
+-- Every connection gets every key update in order, the last one
+-- being delivered for sure.
+g.test_broadcast = function(cg)
+    local values = {}
+    local watchers = {}
+    local count = 0
+    for i, conn in ipairs(cg.conns) do
+        values[i] = {}
+        watchers[i] = conn:watch('foo', function(key, value)
+            t.assert_equals(key, 'foo')
+            if value == nil then
+                count = count + 1
+            else
+                table.insert(values[i], value)
+            end
+        end)
+    end
+    t.helpers.retrying({}, function()
+        t.assert_equals(count, CONN_COUNT)
+    end)
+    for v = 1, 10 do
+        cg.server:exec(function(v)
+            box.broadcast('foo', {v, string.rep('x', v * 1000)})
+        end, {v})
+    end
+    t.helpers.retrying({}, function()
+        for i = 1, CONN_COUNT do
+            local last = values[i][#values[i]]
+            t.assert_equals(last, {10, string.rep('x', 10000)})
+        end
+    end)
+    for i = 1, CONN_COUNT do
+        local prev = 0
+        for j = 1, #values[i] do
+            t.assert_gt(values[i][j][1], prev)
+            prev = values[i][j][1]
+        end
+        watchers[i]:unregister()
+    end
+end
+
+-- Notifications don't get in the middle of responses.
+g.test_broadcast_with_requests = function(cg)
+    local count = 0
+    for _, conn in ipairs(cg.conns) do
+        conn:watch('foo', function()
+            count = count + 1
+        end)
+    end
+    t.helpers.retrying({}, function()
+        t.assert_equals(count, CONN_COUNT)
+    end)
+    local data = string.rep('y', 100000)
+    local broadcaster = fiber.create(function()
+        for v = 1, 100 do
+            cg.server:exec(function(v)
+                box.broadcast('foo', v)
+            end, {v})
+        end
+    end)
+    broadcaster:set_joinable(true)
+    for _ = 1, 10 do
+        for _, conn in ipairs(cg.conns) do
+            t.assert_equals(conn:eval('return ...', {data}), data)
+        end
+    end
+    broadcaster:join()
+end
+
+-- Closing connections with notifications in flight is fine.
+g.test_close_with_pending_events = function(cg)
+    for _, conn in ipairs(cg.conns) do
+        conn:watch('foo', function() end)
+    end
+    cg.server:exec(function()
+        for v = 1, 100 do
+            box.broadcast('foo', v)
+        end
+    end)
+    for _, conn in ipairs(cg.conns) do
+        conn:close()
+    end
+    local conn = net_box.connect(cg.server.net_box_uri)
+    local value
+    conn:watch('foo', function(_, v) value = v end)
+    t.helpers.retrying({}, function()
+        t.assert_equals(value, 100)
+    end)
+    conn:close()
+end
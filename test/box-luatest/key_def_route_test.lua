@@ -0,0 +1,92 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_bucket_id = function(cg)
+    cg.server:exec(function()
+        local key_def = require('key_def')
+        local kd = key_def.new({{fieldno = 1, type = 'unsigned'},
+                                {fieldno = 2, type = 'string',
+                                 collation = 'unicode_ci'}})
+        local counts = {}
+        for i = 1, 1000 do
+            local bucket_id = kd:bucket_id({i, 'x'}, 10)
+            t.assert(bucket_id >= 1 and bucket_id <= 10)
+            t.assert_equals(kd:bucket_id({i, 'x'}, 10), bucket_id)
+            t.assert_equals(kd:bucket_id(box.tuple.new({i, 'x'}), 10),
+                            bucket_id)
+            counts[bucket_id] = (counts[bucket_id] or 0) + 1
+        end
+        for i = 1, 10 do
+            t.assert_almost_equals(counts[i], 100, 50)
+        end
+        -- Keys equal by the collation are routed to the same bucket.
+        t.assert_equals(kd:bucket_id({1, 'ABC'}, 3000),
+                        kd:bucket_id({1, 'abc'}, 3000))
+        t.assert_equals(kd:bucket_id({1, 'x'}, 1), 1)
+    end)
+end
+
+g.test_route = function(cg)
+    cg.server:exec(function()
+        local key_def = require('key_def')
+        local kd = key_def.new({{fieldno = 1, type = 'string'}})
+        local keys = {}
+        local bucket_ids = {}
+        for i = 1, 100 do
+            keys[i] = {'key' .. i}
+            bucket_ids[i] = kd:bucket_id(keys[i], 16)
+        end
+        t.assert_equals(kd:route(keys, 16), bucket_ids)
+        t.assert_equals(kd:route({}, 16), {})
+
+        local replicasets = {}
+        for i = 1, 16 do
+            replicasets[i] = 'rs' .. (i % 4)
+        end
+        local res = kd:route(keys, replicasets)
+        for i = 1, 100 do
+            t.assert_equals(res[i], replicasets[bucket_ids[i]])
+        end
+    end)
+end
+
+g.test_errors = function(cg)
+    cg.server:exec(function()
+        local key_def = require('key_def')
+        local kd = key_def.new({{fieldno = 1, type = 'unsigned'},
+                                {fieldno = 2, type = 'string'}})
+        t.assert_error_msg_content_equals(
+            "Usage: key_def:bucket_id(key, bucket_count)",
+            kd.bucket_id, kd, {1, 'a'})
+        t.assert_error_msg_content_equals(
+            "Usage: key_def:route(keys, buckets)",
+            kd.route, kd, {{1, 'a'}}, 'x')
+        t.assert_error_msg_content_equals(
+            "bucket count must be in range [1, 4294967295]",
+            kd.bucket_id, kd, {1, 'a'}, 0)
+        t.assert_error_msg_content_equals(
+            "bucket count must be in range [1, 4294967295]",
+            kd.route, kd, {{1, 'a'}}, {})
+        t.assert_error_msg_content_equals(
+            "Invalid key part count in an exact match (expected 2, got 1)",
+            kd.bucket_id, kd, {1}, 10)
+        t.assert_error_msg_content_equals(
+            "Supplied key type of part 1 does not match index part type: " ..
+            "expected string",
+            kd.route, kd, {{1, 'a'}, {1, 2}}, 10)
+        t.assert_error_msg_content_equals(
+            "A tuple or a table expected, got number",
+            kd.route, kd, {1}, 10)
+    end)
+end
@@ -0,0 +1,37 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group('memtx_arena_placement')
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        alias = 'master',
+        -- Failures to apply the placement are only logged, so the
+        -- instance starts on any platform.
+        box_cfg = {memtx_use_huge_pages = true, memtx_numa_node = 0},
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_memtx_arena_placement = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.cfg.memtx_use_huge_pages, true)
+        t.assert_equals(box.cfg.memtx_numa_node, 0)
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        for i = 1, 1000 do
+            s:insert({i, string.rep('x', 100)})
+        end
+        t.assert_equals(s:count(), 1000)
+        s:drop()
+        t.assert_error_msg_contains("Can't set option", box.cfg,
+                                    {memtx_numa_node = 1})
+        t.assert_error_msg_contains("Can't set option", box.cfg,
+                                    {memtx_use_huge_pages = false})
+    end)
+end
@@ -0,0 +1,71 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group('memtx_func_index_replace', {
+    {is_multikey = false}, {is_multikey = true},
+})
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+        if box.func.key ~= nil then
+            box.func.key:drop()
+        end
+    end)
+end)
+
+-- Updates that keep or change the functional key leave exactly one
+-- entry per key in the index.
+g.test_update = function(cg)
+    cg.server:exec(function(is_multikey)
+        local body
+        if is_multikey then
+            body = 'function(tuple) return {{tuple[2]}, {tuple[2] + 100}} end'
+        else
+            body = 'function(tuple) return {tuple[2]} end'
+        end
+        box.schema.func.create('key', {
+            body = body, is_deterministic = true, is_sandboxed = true,
+            opts = {is_multikey = is_multikey},
+        })
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        local sk = s:create_index('sk', {
+            func = 'key', parts = {{1, 'unsigned'}},
+        })
+        local keys = is_multikey and 2 or 1
+        for i = 1, 10 do
+            s:replace({i, i, 'a'})
+        end
+        t.assert_equals(sk:count(), 10 * keys)
+        -- The key doesn't change.
+        for i = 1, 10 do
+            s:update(i, {{'=', 3, 'b'}})
+        end
+        t.assert_equals(sk:count(), 10 * keys)
+        t.assert_equals(sk:get(5), {5, 5, 'b'})
+        -- The key changes.
+        s:update(5, {{'=', 2, 50}})
+        t.assert_equals(sk:count(), 10 * keys)
+        t.assert_equals(sk:get(5), nil)
+        t.assert_equals(sk:get(50), {5, 50, 'b'})
+        -- The new tuple takes the key of another tuple.
+        t.assert_error_msg_contains('Duplicate key exists',
+                                    s.update, s, 6, {{'=', 2, 7}})
+        t.assert_equals(sk:get(6), {6, 6, 'b'})
+        s:delete(5)
+        t.assert_equals(sk:count(), 9 * keys)
+        t.assert_equals(sk:get(50), nil)
+    end, {cg.params.is_multikey})
+end
@@ -0,0 +1,57 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group('memtx_hash_index_stat')
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_stat = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test')
+        s:create_index('pk', {type = 'hash'})
+        local stat = s.index.pk:stat()
+        t.assert_equals(stat.count, 0)
+        t.assert_equals(stat.table_size, 0)
+        t.assert_equals(stat.load_factor, 0)
+        for i = 1, 1000 do
+            s:insert({i})
+        end
+        stat = s.index.pk:stat()
+        t.assert_equals(stat.count, 1000)
+        t.assert_ge(stat.table_size, 1000)
+        t.assert_almost_equals(stat.load_factor, 1000 / stat.table_size,
+                               1e-6)
+        local chains = 0
+        for _, n in pairs(stat.chain_length) do
+            chains = chains + n
+        end
+        t.assert_gt(chains, 0)
+        t.assert_le(chains, 1000)
+        t.assert_not_equals(stat.chain_length['8+'], nil)
+    end)
+end
+
+-- A secondary hash index built on recovery is sized in advance.
+g.test_reserve_on_recovery = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        s:create_index('sk', {type = 'hash', parts = {1, 'unsigned'}})
+        box.snapshot()
+    end)
+    cg.server:restart()
+    cg.server:exec(function()
+        local t = require('luatest')
+        local stat = box.space.test.index.sk:stat()
+        t.assert_equals(stat.count, 1000)
+        t.assert_ge(stat.table_size, 1200)
+        box.space.test:drop()
+    end)
+end
@@ -0,0 +1,87 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group('memtx_multikey_replace', {
+    {unique = true}, {unique = false},
+})
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+-- Replacing a tuple keeps the common keys and removes only the keys
+-- that are gone, including keys repeated in the old or the new tuple.
+g.test_replace = function(cg)
+    cg.server:exec(function(unique)
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:create_index('mk', {parts = {{'[2][*]', 'unsigned'}},
+                              unique = unique})
+        local function keys(id)
+            local res = {}
+            for _, tuple in s.index.mk:pairs() do
+                if tuple[1] == id then
+                    table.insert(res, tuple[2])
+                end
+            end
+            return res
+        end
+        local n = 1000
+        local tags = {}
+        for i = 1, n do
+            tags[i] = i
+        end
+        s:replace({1, tags})
+        t.assert_equals(s.index.mk:count(), n)
+        -- Change one key and repeat another one.
+        tags[1] = n + 1
+        tags[2] = 3
+        s:replace({1, tags})
+        t.assert_equals(s.index.mk:count(), n - 1)
+        t.assert_equals(s.index.mk:select(1), {})
+        t.assert_equals(s.index.mk:select(2), {})
+        t.assert_equals(s.index.mk:select(n + 1)[1][1], 1)
+        t.assert_equals(#keys(1), n - 1)
+        -- Replace a tuple with repeated keys with a smaller one.
+        s:replace({1, {3, 4, 5, 5}})
+        t.assert_equals(s.index.mk:count(), 3)
+        t.assert_equals(s.index.mk:select(5)[1][1], 1)
+        -- A space update keeps the common keys too.
+        s:update(1, {{'=', 2, {5, 6}}})
+        t.assert_equals(s.index.mk:count(), 2)
+        t.assert_equals(s.index.mk:select(3), {})
+        t.assert_equals(s.index.mk:select(6)[1][1], 1)
+        s:delete(1)
+        t.assert_equals(s.index.mk:count(), 0)
+    end, {cg.params.unique})
+end
+
+-- A failed replace doesn't change the index.
+g.test_replace_rollback = function(cg)
+    t.skip_if(not cg.params.unique, 'unique index only')
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:create_index('mk', {parts = {{'[2][*]', 'unsigned'}}})
+        s:replace({1, {1, 2, 3}})
+        s:replace({2, {10}})
+        t.assert_error_msg_contains('Duplicate key exists',
+                                    s.replace, s, {1, {2, 3, 4, 10}})
+        t.assert_equals(s.index.mk:select({}, {iterator = 'all'}),
+                        {{1, {1, 2, 3}}, {1, {1, 2, 3}}, {1, {1, 2, 3}},
+                         {2, {10}}})
+    end)
+end
@@ -0,0 +1,57 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group('memtx_rtree_bulk_load')
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+local function select_all()
+    local s = box.space.test
+    local res = {}
+    res.count = s.index.rt:count()
+    res.box = s.index.rt:select({10, 10, 20, 20}, {iterator = 'le'})
+    res.neighbor = s.index.rt:select({0, 0}, {iterator = 'neighbor',
+                                              limit = 5})
+    local function cmp(a, b) return a[1] < b[1] end
+    table.sort(res.box, cmp)
+    table.sort(res.neighbor, cmp)
+    return res
+end
+
+-- Secondary indexes are built on recovery with the bulk load.
+g.test_recovery = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:create_index('rt', {type = 'rtree', parts = {2, 'array'},
+                              unique = false})
+        box.begin()
+        for i = 1, 10000 do
+            s:insert({i, {i % 100, math.floor(i / 100)}})
+        end
+        box.commit()
+        box.snapshot()
+    end)
+    local before = cg.server:exec(select_all)
+    t.assert_equals(before.count, 10000)
+    t.assert_equals(#before.box, 121)
+    cg.server:restart()
+    t.assert_equals(cg.server:exec(select_all), before)
+    cg.server:exec(function()
+        local t = require('luatest')
+        -- The index is usable for updates after the build.
+        local s = box.space.test
+        s:replace({1, {-1, -1}})
+        s:delete(2)
+        t.assert_equals(s.index.rt:select({-1, -1}), {{1, {-1, -1}}})
+        t.assert_equals(s.index.rt:count(), 9999)
+        s:drop()
+    end)
+end
@@ -0,0 +1,47 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group('memtx_system_allocator')
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        alias = 'master',
+        box_cfg = {memtx_allocator = 'system'},
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_slab_info = function(cg)
+    cg.server:exec(function()
+        local function items_used_ratio(info)
+            return tonumber(info.items_used_ratio:match('^([%d.]+)%%$'))
+        end
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        local info = box.slab.info()
+        local items_used = info.items_used
+        local quota_used = info.quota_used
+        for i = 1, 10000 do
+            s:insert({i, string.rep('x', 200)})
+        end
+        info = box.slab.info()
+        t.assert_ge(info.items_used - items_used, 10000 * 200)
+        t.assert_ge(info.items_size, info.items_used)
+        t.assert_gt(items_used_ratio(info), 50)
+        t.assert_le(items_used_ratio(info), 100)
+        t.assert_ge(info.quota_used - quota_used, 10000 * 200)
+        local quota_used_full = info.quota_used
+        for i = 1, 10000 do
+            s:delete({i})
+        end
+        collectgarbage()
+        info = box.slab.info()
+        t.assert_lt(info.items_used, items_used + 10000)
+        t.assert_lt(info.quota_used, quota_used_full - 10000 * 100)
+        s:drop()
+    end)
+end
@@ -0,0 +1,108 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group('memtx_tree_count_offset', {
+    {mvcc = false}, {mvcc = true},
+})
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        alias = 'master',
+        box_cfg = {memtx_use_mvcc_engine = cg.params.mvcc},
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.before_each(function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:create_index('sk', {unique = false, parts = {{2, 'unsigned'}}})
+        s:create_index('mk', {unique = false,
+                              parts = {{3, 'unsigned', path = '[*]'}}})
+        for i = 1, 1000 do
+            s:insert({i, i % 37, {i % 5, i % 7 + 5}})
+        end
+        for i = 1, 1000, 3 do
+            s:delete({i})
+        end
+    end)
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.space.test:drop()
+    end)
+end)
+
+g.test_count = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        local iterators = {'EQ', 'REQ', 'ALL', 'LT', 'LE', 'GE', 'GT'}
+        local keys = {
+            pk = {{}, {0}, {1}, {2}, {500}, {1000}, {1001}},
+            sk = {{}, {0}, {1}, {18}, {36}, {37}},
+            mk = {{}, {0}, {4}, {5}, {11}, {12}},
+        }
+        for name, index_keys in pairs(keys) do
+            local index = s.index[name]
+            for _, key in ipairs(index_keys) do
+                for _, it in ipairs(iterators) do
+                    local opts = {iterator = it}
+                    t.assert_equals(index:count(key, opts),
+                                    #index:select(key, opts),
+                                    {name, key, it})
+                end
+            end
+        end
+    end)
+end
+
+g.test_offset = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        local iterators = {'EQ', 'REQ', 'ALL', 'LT', 'LE', 'GE', 'GT'}
+        local keys = {
+            pk = {{}, {1}, {500}, {1001}},
+            sk = {{}, {0}, {18}, {37}},
+            mk = {{}, {0}, {5}, {12}},
+        }
+        for name, index_keys in pairs(keys) do
+            local index = s.index[name]
+            for _, key in ipairs(index_keys) do
+                for _, it in ipairs(iterators) do
+                    local all = index:select(key, {iterator = it})
+                    for _, offset in ipairs({0, 1, 10, 300, 700, 2000}) do
+                        local expected = {}
+                        for i = offset + 1, math.min(offset + 5, #all) do
+                            table.insert(expected, all[i])
+                        end
+                        t.assert_equals(index:select(key, {
+                            iterator = it, offset = offset, limit = 5,
+                        }), expected, {name, key, it, offset})
+                    end
+                end
+            end
+        end
+    end)
+end
+
+-- Offsets are counted in tuples visible to the transaction.
+g.test_offset_in_txn = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        box.begin()
+        for i = 2, 100 do
+            s:delete({i})
+        end
+        t.assert_equals(s:count({}, {iterator = 'GE'}), #s:select())
+        t.assert_equals(s:count({101}, {iterator = 'LE'}), 1)
+        t.assert_equals(s:select({}, {offset = 1, limit = 1}),
+                        {s:get({102})})
+        box.rollback()
+    end)
+end
@@ -0,0 +1,159 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group('multipart_hint')
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+    cg.server:exec(function()
+        rawset(_G, 'check_order', function(index, less)
+            local t = require('luatest')
+            local expected = index.space:select()
+            table.sort(expected, function(a, b)
+                return less(a, b)
+            end)
+            t.assert_equals(index:select(), expected)
+            for _, tuple in ipairs(expected) do
+                local key = {}
+                for i, part in ipairs(index.parts) do
+                    key[i] = tuple[part.fieldno]
+                end
+                t.assert_equals(index:select(key), {tuple})
+                local ge = index:select(key, {iterator = 'ge', limit = 1})
+                t.assert_equals(ge, {tuple})
+            end
+        end)
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_unsigned_unsigned = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        local sk = s:create_index('sk', {
+            parts = {{2, 'unsigned'}, {3, 'unsigned'}},
+            multipart_hint = true,
+        })
+        t.assert_equals(sk.multipart_hint, true)
+        t.assert_equals(s.index.pk.multipart_hint, nil)
+        local heads = {0, 1, 253, 254, 255, 256, 1000}
+        local tails = {0, 1, 36028797018963968ULL, 72057594037927935ULL,
+                       72057594037927936ULL, 72057594037927937ULL,
+                       9223372036854775808ULL}
+        local id = 1
+        for _, h in ipairs(heads) do
+            for _, v in ipairs(tails) do
+                s:insert({id, h, v})
+                id = id + 1
+            end
+        end
+        check_order(sk, function(a, b)
+            if a[2] ~= b[2] then
+                return a[2] < b[2]
+            end
+            if a[3] ~= b[3] then
+                return a[3] < b[3]
+            end
+            return a[1] < b[1]
+        end)
+        -- Partial keys.
+        t.assert_equals(#sk:select({255}), #tails)
+        t.assert_equals(#sk:select({255}, {iterator = 'gt'}), #tails * 2)
+    end)
+end
+
+g.test_integer_string = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        local sk = s:create_index('sk', {
+            parts = {{2, 'integer'}, {3, 'string'}},
+            multipart_hint = true,
+        })
+        local heads = {-1000, -128, -127, -126, -1, 0, 1, 126, 127, 128, 1000}
+        local tails = {'', 'a', 'aaaaaaa', 'aaaaaaab', 'aaaaaaaa', 'b'}
+        local id = 1
+        for _, h in ipairs(heads) do
+            for _, v in ipairs(tails) do
+                s:insert({id, h, v})
+                id = id + 1
+            end
+        end
+        check_order(sk, function(a, b)
+            if a[2] ~= b[2] then
+                return a[2] < b[2]
+            end
+            if a[3] ~= b[3] then
+                return a[3] < b[3]
+            end
+            return a[1] < b[1]
+        end)
+    end)
+end
+
+-- Checks that the secondary key is merged with the primary key,
+-- so a single part index gets multipart hints too.
+g.test_boolean_pk = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        local sk = s:create_index('sk', {
+            parts = {{2, 'boolean'}}, unique = false,
+            multipart_hint = true,
+        })
+        for i = 1, 100 do
+            s:insert({i, i % 3 == 0})
+        end
+        check_order(sk, function(a, b)
+            if a[2] ~= b[2] then
+                return not a[2]
+            end
+            return a[1] < b[1]
+        end)
+    end)
+end
+
+g.test_alter = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        local sk = s:create_index('sk', {parts = {{2, 'unsigned'},
+                                                  {3, 'unsigned'}}})
+        for i = 1, 100 do
+            s:insert({i, i % 5, 100 - i})
+        end
+        sk:alter({multipart_hint = true})
+        t.assert_equals(sk.multipart_hint, true)
+        sk:alter({parts = {{2, 'integer'}, {3, 'unsigned'}}})
+        check_order(sk, function(a, b)
+            if a[2] ~= b[2] then
+                return a[2] < b[2]
+            end
+            return a[3] < b[3]
+        end)
+        t.assert_error_msg_contains(
+            "multipart_hint is only reasonable with memtx tree index",
+            s.create_index, s, 'hash', {type = 'hash', multipart_hint = true})
+        local v = box.schema.space.create('test_vinyl', {engine = 'vinyl'})
+        t.assert_error_msg_contains(
+            "multipart_hint is only reasonable with memtx tree index",
+            v.create_index, v, 'pk', {multipart_hint = true})
+        v:drop()
+    end)
+end
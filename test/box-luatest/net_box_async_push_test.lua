@@ -0,0 +1,59 @@
+local net = require('net.box')
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+    cg.server:exec(function()
+        rawset(_G, 'push_n', function(n)
+            for i = 1, n do
+                box.session.push(i)
+            end
+            return n
+        end)
+        box.schema.func.create('push_n')
+        box.schema.user.grant('guest', 'execute', 'function', 'push_n')
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+-- Messages pushed for async requests are returned by future:pairs()
+-- whether they arrive before or after the iteration starts.
+g.test_async_push = function(cg)
+    local c = net.connect(cg.server.net_box_uri)
+    local function collect(future)
+        local res = {}
+        for _, msg in future:pairs() do
+            table.insert(res, msg)
+        end
+        return res
+    end
+    t.assert_equals(collect(c:call('push_n', {0}, {is_async = true})),
+                    {{0}})
+    t.assert_equals(collect(c:call('push_n', {3}, {is_async = true})),
+                    {1, 2, 3, {3}})
+    local future = c:call('push_n', {2}, {is_async = true})
+    t.assert_equals(future:wait_result(), {2})
+    t.assert_equals(collect(future), {1, 2, {2}})
+    local futures = {}
+    for i = 1, 100 do
+        futures[i] = c:call('push_n', {i % 3}, {is_async = true})
+    end
+    for i = 1, 100 do
+        t.assert_equals(futures[i]:wait_result(), {i % 3})
+    end
+    t.assert_equals(#collect(futures[5]), 3)
+    -- Sync requests still invoke the on_push trigger.
+    local pushed = {}
+    t.assert_equals(c:call('push_n', {2}, {
+        on_push = table.insert, on_push_ctx = pushed,
+    }), 2)
+    t.assert_equals(pushed, {1, 2})
+    c:close()
+end
@@ -0,0 +1,111 @@
+local key_def = require('key_def')
+local net_box = require('net.box')
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group('net_box_scatter_gather')
+
+local CONN_COUNT = 3
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+    cg.server:exec(function(conn_count)
+        box.schema.user.grant('guest', 'super')
+        local fiber = require('fiber')
+        local slice = 0
+        -- Every call returns its own slice of 1..3 * conn_count.
+        rawset(_G, 'get_slice', function(reverse)
+            slice = slice + 1
+            local tuples = {}
+            for i = slice, 3 * conn_count, conn_count do
+                table.insert(tuples, box.tuple.new({i}))
+            end
+            if reverse then
+                table.sort(tuples, function(a, b) return a[1] > b[1] end)
+            end
+            return tuples
+        end)
+        rawset(_G, 'reset_slice', function() slice = 0 end)
+        rawset(_G, 'sleep', function() fiber.sleep(10) end)
+    end, {CONN_COUNT})
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.before_each(function(cg)
+    cg.conns = {}
+    for i = 1, CONN_COUNT do
+        cg.conns[i] = net_box.connect(cg.server.net_box_uri)
+    end
+    cg.server:exec(function() _G.reset_slice() end)
+end)
+
+g.after_each(function(cg)
+    for _, conn in ipairs(cg.conns) do
+        conn:close()
+    end
+end)
+
+g.test_merge = function(cg)
+    local kd = key_def.new({{fieldno = 1, type = 'unsigned'}})
+    local source = net_box.scatter_gather(cg.conns, 'get_slice', {false},
+                                          {key_def = kd})
+    local res = source:select()
+    t.assert_equals(#res, 3 * CONN_COUNT)
+    for i, tuple in ipairs(res) do
+        t.assert_equals(tuple:totable(), {i})
+    end
+
+    cg.server:exec(function() _G.reset_slice() end)
+    source = net_box.scatter_gather(cg.conns, 'get_slice', {true},
+                                    {key_def = kd, reverse = true})
+    res = source:select()
+    t.assert_equals(#res, 3 * CONN_COUNT)
+    for i, tuple in ipairs(res) do
+        t.assert_equals(tuple:totable(), {3 * CONN_COUNT - i + 1})
+    end
+
+    -- A function returning nothing gives an empty source.
+    source = net_box.scatter_gather(cg.conns, 'box.session.su',
+                                    {'guest'}, {key_def = kd})
+    t.assert_equals(source:select(), {})
+end
+
+g.test_gather = function(cg)
+    local ids = {}
+    for i, conn in ipairs(cg.conns) do
+        ids[i] = conn:call('box.session.id')
+    end
+    t.assert_equals(net_box.scatter_gather(cg.conns, 'box.session.id'), ids)
+    local sum = net_box.scatter_gather(cg.conns, 'box.session.id', nil, {
+        reduce = function(acc, id) return acc + id end,
+        initial = 0,
+    })
+    local exp = 0
+    for _, id in ipairs(ids) do
+        exp = exp + id
+    end
+    t.assert_equals(sum, exp)
+    t.assert_equals(net_box.scatter_gather({}, 'box.session.id'), {})
+end
+
+g.test_errors = function(cg)
+    t.assert_error_msg_contains('Usage: net_box.scatter_gather',
+                                net_box.scatter_gather, cg.conns)
+    t.assert_error_msg_contains('mutually exclusive',
+                                net_box.scatter_gather, cg.conns, 'f', {},
+                                {key_def = {}, reduce = function() end})
+    t.assert_error_msg_contains("Procedure 'no_such_func' is not defined",
+                                net_box.scatter_gather, cg.conns,
+                                'no_such_func')
+    t.assert_error_msg_contains('Timeout exceeded',
+                                net_box.scatter_gather, cg.conns, 'sleep',
+                                nil, {timeout = 0.1})
+    -- The connections are still usable.
+    for _, conn in ipairs(cg.conns) do
+        t.assert_equals(conn:call('tostring', {1}), '1')
+    end
+end
@@ -0,0 +1,98 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group('read_view')
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+    cg.server:exec(function()
+        for _, name in ipairs({'a', 'b'}) do
+            local s = box.schema.space.create(name, {
+                format = {{'id', 'unsigned'}, {'value', 'string'}},
+            })
+            s:create_index('pk')
+        end
+        box.schema.space.create('v', {engine = 'vinyl'}):create_index('pk')
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.before_each(function(cg)
+    cg.server:exec(function()
+        for _, name in ipairs({'a', 'b'}) do
+            box.space[name]:truncate()
+            for i = 1, 10 do
+                box.space[name]:insert({i, name .. i})
+            end
+        end
+        box.space.v:truncate()
+        box.space.v:insert({1})
+    end)
+end)
+
+g.test_consistent = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local fiber = require('fiber')
+        local rv = box.read_view.open({spaces = {'a', box.space.b.id, 'v'},
+                                       name = 'test'})
+        t.assert_equals(tostring(rv), 'box.read_view')
+        box.begin()
+        box.space.a:delete(1)
+        box.space.b:replace({2, 'new'})
+        box.space.b:insert({11, 'new'})
+        box.commit()
+        box.space.v:insert({2})
+        local info = rv:info()
+        t.assert_equals(info.name, 'test')
+        t.assert_equals(info.spaces, {'a', 'b', 'v'})
+        local list = box.read_view.list()
+        t.assert_equals(#list, 1)
+        t.assert_equals(list[1].id, info.id)
+        local function read(space)
+            local result = {}
+            for _, tuple in rv:pairs(space) do
+                -- A read view doesn't block writers or yields.
+                fiber.yield()
+                box.space.a:replace({tuple.id, 'changed'})
+                table.insert(result, tuple:totable())
+            end
+            return result
+        end
+        local a = read('a')
+        local b = read('b')
+        t.assert_equals(#a, 10)
+        t.assert_equals(a[1], {1, 'a1'})
+        t.assert_equals(#b, 10)
+        t.assert_equals(b[2], {2, 'b2'})
+        t.assert_equals(read('v'), {{1}})
+        t.assert_error_msg_equals("Space 'a' has already been read",
+                                  rv.pairs, rv, 'a')
+        rv:close()
+        t.assert_equals(box.read_view.list(), {})
+        t.assert_error_msg_equals('Read view is closed', rv.close, rv)
+        t.assert_equals(box.space.a:get(2), {2, 'changed'})
+    end)
+end
+
+g.test_errors = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        t.assert_error_msg_contains('Usage', box.read_view.open)
+        t.assert_error_msg_equals('spaces must not be empty',
+                                  box.read_view.open, {spaces = {}})
+        t.assert_error_msg_equals("Space 'c' does not exist",
+                                  box.read_view.open, {spaces = {'a', 'c'}})
+        t.assert_equals(box.read_view.list(), {})
+        local rv = box.read_view.open({spaces = {'a'}})
+        t.assert_error_msg_equals("Space 'b' is not in the read view",
+                                  rv.pairs, rv, 'b')
+        rv = nil -- luacheck: ignore
+        collectgarbage()
+        t.assert_equals(box.read_view.list(), {})
+    end)
+end
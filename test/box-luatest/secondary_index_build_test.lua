@@ -0,0 +1,45 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group('secondary_index_build')
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_index_build_after_recovery = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:create_index('tree', {parts = {2, 'unsigned'}})
+        s:create_index('hash', {type = 'hash', parts = {3, 'string'}})
+        s:create_index('multipart', {parts = {{3, 'string'},
+                                              {2, 'unsigned'}}})
+        for i = 1, 1000 do
+            s:insert({i, 1000 - i, tostring(i)})
+        end
+        box.snapshot()
+    end)
+    cg.server:restart()
+    cg.server:exec(function()
+        local t = require('luatest')
+        local s = box.space.test
+        t.assert_equals(s.index.tree:count(), 1000)
+        t.assert_equals(s.index.tree:min(), {1000, 0, '1000'})
+        t.assert_equals(s.index.hash:get('500'), {500, 500, '500'})
+        t.assert_equals(s.index.multipart:max(), {999, 1, '999'})
+
+        local stat = box.info.memtx().index_build
+        t.assert_type(stat.test, 'table')
+        for _, name in ipairs({'tree', 'hash', 'multipart'}) do
+            t.assert_type(stat.test[name], 'number')
+            t.assert_ge(stat.test[name], 0)
+        end
+        t.assert_equals(stat.test.pk, nil)
+    end)
+end
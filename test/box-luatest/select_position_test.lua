@@ -0,0 +1,163 @@
+local net = require('net.box')
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group('select_position', {
+    {engine = 'memtx'}, {engine = 'vinyl'},
+})
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.before_each(function(cg)
+    cg.server:exec(function(engine)
+        local s = box.schema.space.create('test', {engine = engine})
+        s:create_index('pk')
+        s:create_index('sk', {unique = false, parts = {{2, 'unsigned'}}})
+        s:create_index('nk', {parts = {{3, 'unsigned', is_nullable = true}}})
+        for i = 1, 100 do
+            s:insert({i, i % 7, i % 3 == 0 and box.NULL or i})
+        end
+        box.schema.user.grant('guest', 'read', 'space', 'test')
+    end, {cg.params.engine})
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.space.test:drop()
+    end)
+end)
+
+-- Reads the whole range by pages and checks that the result is the same
+-- as the one of a plain select.
+g.test_pagination = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        local iterators = {'EQ', 'REQ', 'ALL', 'LT', 'LE', 'GE', 'GT'}
+        local keys = {
+            pk = {{}, {1}, {50}, {100}},
+            sk = {{}, {0}, {3}, {6}},
+            nk = {{}, {box.NULL}, {50}},
+        }
+        for name, index_keys in pairs(keys) do
+            local index = s.index[name]
+            for _, key in ipairs(index_keys) do
+                for _, it in ipairs(iterators) do
+                    local expected = index:select(key, {iterator = it})
+                    for _, limit in ipairs({1, 7, 1000}) do
+                        local result = {}
+                        local pos
+                        repeat
+                            local page
+                            page, pos = index:select(key, {
+                                iterator = it, limit = limit,
+                                after = pos, fetch_pos = true,
+                            })
+                            for _, tuple in ipairs(page) do
+                                table.insert(result, tuple)
+                            end
+                        until #page < limit
+                        t.assert_equals(result, expected,
+                                        {name, key, it, limit})
+                    end
+                end
+            end
+        end
+    end)
+end
+
+g.test_after_tuple = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        t.assert_equals(s:select({}, {after = {10, 3, 10}, limit = 2}),
+                        {s:get({11}), s:get({12})})
+        t.assert_equals(s.index.sk:select({3}, {after = s:get({10}),
+                                                limit = 2}),
+                        {s:get({17}), s:get({24})})
+        local pos = s.index.pk:tuple_pos(s:get({99}))
+        t.assert_equals(s:select({}, {after = pos, limit = 2}),
+                        {s:get({100})})
+        local page
+        page, pos = s:select({}, {after = s:get({100}), fetch_pos = true})
+        t.assert_equals(page, {})
+        t.assert_equals(pos, s.index.pk:tuple_pos(s:get({100})))
+    end)
+end
+
+g.test_errors = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        t.assert_error_msg_content_equals(
+            "Illegal parameters, options parameter 'after' should be " ..
+            "of type string, table, tuple",
+            s.select, s, {}, {after = 1})
+        t.assert_error_msg_content_equals(
+            "Illegal parameters, options parameter 'fetch_pos' should " ..
+            "be of type boolean",
+            s.select, s, {}, {fetch_pos = 1})
+        local pos = s.index.sk:tuple_pos({10, 3})
+        t.assert_error_msg_content_equals(
+            "Iterator position is invalid",
+            s.index.sk.select, s.index.sk, {}, {after = 'abc'})
+        t.assert_error_msg_content_equals(
+            "Iterator position is invalid",
+            s.index.sk.select, s.index.sk, {}, {after = pos .. 'x'})
+        t.assert_error_msg_content_equals(
+            "Iterator position is invalid",
+            s.index.pk.select, s.index.pk, {}, {after = pos})
+        -- The position is out of the iterator range.
+        t.assert_error_msg_content_equals(
+            "Iterator position is invalid",
+            s.index.sk.select, s.index.sk, {4}, {after = pos})
+        t.assert_error_msg_content_equals(
+            "Iterator position is invalid",
+            s.index.sk.select, s.index.sk, {2}, {iterator = 'LT',
+                                                after = pos})
+    end)
+end
+
+g.test_unsupported = function(cg)
+    t.skip_if(cg.params.engine ~= 'memtx', 'HASH is memtx only')
+    cg.server:exec(function()
+        local s = box.space.test
+        s:create_index('hk', {type = 'HASH'})
+        t.assert_error_msg_contains(
+            "does not support pagination",
+            s.index.hk.select, s.index.hk, {}, {fetch_pos = true})
+        t.assert_error_msg_contains(
+            "does not support pagination",
+            s.index.hk.tuple_pos, s.index.hk, {1, 2, 3})
+    end)
+end
+
+g.test_net_box = function(cg)
+    local c = net.connect(cg.server.net_box_uri)
+    t.assert(c.peer_protocol_features.pagination)
+    local s = c.space.test
+    local expected = cg.server:exec(function()
+        return box.space.test.index.sk:select({}, {iterator = 'REQ'})
+    end)
+    local result = {}
+    local pos
+    repeat
+        local page
+        page, pos = s.index.sk:select({}, {iterator = 'REQ', limit = 9,
+                                           after = pos, fetch_pos = true})
+        for _, tuple in ipairs(page) do
+            table.insert(result, tuple:totable())
+        end
+    until #page < 9
+    t.assert_equals(result, expected)
+    local page = s:select({}, {after = {10, 3, 10}, limit = 1})
+    t.assert_equals(page[1]:totable(), {11, 4, 11})
+    t.assert_error_msg_content_equals(
+        "Iterator position is invalid",
+        s.select, s, {}, {after = 'abc'})
+    c:close()
+end
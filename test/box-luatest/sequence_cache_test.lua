@@ -0,0 +1,144 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group('sequence_cache')
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.sequence.test ~= nil then
+            box.sequence.test:drop()
+        end
+    end)
+end)
+
+g.test_cache = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local seq = box.schema.sequence.create('test', {cache = 10})
+        local function persisted()
+            return box.space._sequence_data:get(seq.id)[2]
+        end
+        t.assert_equals(seq:next(), 1)
+        t.assert_equals(persisted(), 11)
+        local lsn = box.info.lsn
+        for i = 2, 10 do
+            t.assert_equals(seq:next(), i)
+        end
+        t.assert_equals(box.info.lsn, lsn)
+        t.assert_equals(seq:current(), 10)
+        t.assert_equals(persisted(), 11)
+        t.assert_equals(seq:next(), 11)
+        t.assert_equals(box.info.lsn, lsn + 1)
+        t.assert_equals(persisted(), 21)
+        t.assert_equals(seq:next(), 12)
+
+        -- An explicitly set value is written as is.
+        seq:set(100)
+        t.assert_equals(persisted(), 100)
+        t.assert_equals(seq:next(), 101)
+        t.assert_equals(persisted(), 111)
+        seq:reset()
+        t.assert_equals(seq:next(), 1)
+        t.assert_equals(persisted(), 11)
+    end)
+end
+
+g.test_restart = function(cg)
+    cg.server:exec(function()
+        local seq = box.schema.sequence.create('test', {cache = 10})
+        for _ = 1, 5 do
+            seq:next()
+        end
+    end)
+    cg.server:restart()
+    cg.server:exec(function()
+        local t = require('luatest')
+        local seq = box.sequence.test
+        -- Preallocated values are skipped after restart.
+        t.assert_equals(seq:next(), 12)
+        for _ = 1, 3 do
+            seq:next()
+        end
+        t.assert_equals(seq:current(), 15)
+        box.snapshot()
+    end)
+    cg.server:restart()
+    cg.server:exec(function()
+        local t = require('luatest')
+        -- The snapshot stores the last preallocated value.
+        t.assert_equals(box.sequence.test:next(), 23)
+    end)
+end
+
+g.test_limit = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local seq = box.schema.sequence.create('test', {max = 15, cache = 10})
+        local function persisted()
+            return box.space._sequence_data:get(seq.id)[2]
+        end
+        for i = 1, 11 do
+            t.assert_equals(seq:next(), i)
+        end
+        t.assert_equals(persisted(), 15)
+        for i = 12, 15 do
+            t.assert_equals(seq:next(), i)
+        end
+        t.assert_error_msg_equals(
+            "Sequence 'test' has overflowed", seq.next, seq)
+        seq:drop()
+
+        seq = box.schema.sequence.create('test', {
+            step = -1, min = -15, max = -1, cache = 10,
+        })
+        for i = 1, 11 do
+            t.assert_equals(seq:next(), -i)
+        end
+        t.assert_equals(persisted(), -15)
+    end)
+end
+
+g.test_cycle = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local seq = box.schema.sequence.create('test', {
+            min = 1, max = 5, cycle = true, cache = 10,
+        })
+        local function persisted()
+            return box.space._sequence_data:get(seq.id)[2]
+        end
+        for i = 1, 5 do
+            t.assert_equals(seq:next(), i)
+        end
+        t.assert_equals(persisted(), 5)
+        -- Wrapping around starts a new block.
+        t.assert_equals(seq:next(), 1)
+        t.assert_equals(persisted(), 5)
+        t.assert_equals(seq:next(), 2)
+        t.assert_equals(persisted(), 5)
+    end)
+end
+
+g.test_rollback = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local seq = box.schema.sequence.create('test', {cache = 10})
+        box.begin()
+        t.assert_equals(seq:next(), 1)
+        box.rollback()
+        t.assert_equals(box.space._sequence_data:get(seq.id), nil)
+        -- The preallocated values weren't persisted, so the next
+        -- value is written again.
+        t.assert_equals(seq:next(), 2)
+        t.assert_equals(box.space._sequence_data:get(seq.id)[2], 12)
+    end)
+end
@@ -0,0 +1,101 @@
+local net_box = require('net.box')
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group('slow_request_log')
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        box.schema.user.grant('guest', 'read,write', 'space', 'test')
+        rawset(_G, 'sleep', function(t) require('fiber').sleep(t) end)
+        box.schema.func.create('sleep')
+        box.schema.user.grant('guest', 'execute', 'function', 'sleep')
+    end)
+    cg.conn = net_box.connect(cg.server.net_box_uri)
+end)
+
+g.after_all(function(cg)
+    cg.conn:close()
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.cfg{slow_request_threshold = 0}
+    end)
+end)
+
+g.test_cfg = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.cfg.slow_request_threshold, 0)
+        t.assert_error_msg_equals(
+            "Incorrect value for option 'slow_request_threshold': " ..
+            "value must be >= 0",
+            box.cfg, {slow_request_threshold = -1})
+        t.assert_equals(box.cfg.slow_request_threshold, 0)
+    end)
+end
+
+-- Requests taking longer than the threshold are logged with the
+-- time spent at each stage, faster ones are not.
+g.test_slow_call = function(cg)
+    cg.server:exec(function()
+        box.cfg{slow_request_threshold = 0.1}
+    end)
+    cg.conn:call('sleep', {0})
+    t.assert_not(cg.server:grep_log('slow request CALL'))
+    cg.conn:call('sleep', {0.2})
+    t.helpers.retrying({}, function()
+        t.assert(cg.server:grep_log(
+            'slow request CALL: total 0%.%d+ s, net %d+%.%d+ s, ' ..
+            'cbus %d+%.%d+ s, tx 0%.%d+ s, wal 0%.000 s, sync 0%.000 s'))
+    end)
+end
+
+-- The space, the index and the tuple of a DML request are logged
+-- along with the time spent waiting for synchronous replication.
+g.test_slow_sync_replace = function(cg)
+    cg.server:exec(function()
+        box.schema.space.create('sync', {is_sync = true})
+        box.space.sync:create_index('pk')
+        box.schema.user.grant('guest', 'read,write', 'space', 'sync')
+        box.ctl.promote()
+        box.cfg{
+            replication_synchro_quorum = 2,
+            replication_synchro_timeout = 0.2,
+            slow_request_threshold = 0.1,
+        }
+    end)
+    local space_id = cg.conn:eval('return box.space.sync.id')
+    cg.conn:reload_schema()
+    t.assert_error_msg_content_equals('Quorum collection for a synchronous ' ..
+                                      'transaction is timed out',
+                                      cg.conn.space.sync.replace,
+                                      cg.conn.space.sync, {1, 'abc'})
+    t.helpers.retrying({}, function()
+        t.assert(cg.server:grep_log(
+            'slow request REPLACE space ' .. space_id .. ', index 0, ' ..
+            'tuple %[1, "abc"%]: total 0%.%d+ s, .* sync 0%.[1-9]%d+ s'))
+    end)
+    cg.server:exec(function()
+        box.cfg{replication_synchro_quorum = 1}
+        box.space.sync:drop()
+    end)
+end
+
+-- Long keys are truncated.
+g.test_key_truncation = function(cg)
+    cg.server:exec(function()
+        box.cfg{slow_request_threshold = 1e-9}
+    end)
+    cg.conn.space.test:select({string.rep('x', 200)})
+    t.helpers.retrying({}, function()
+        t.assert(cg.server:grep_log(
+            'slow request SELECT space %d+, index 0, key %["x+%.%.%.:'))
+    end)
+end
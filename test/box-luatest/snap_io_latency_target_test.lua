@@ -0,0 +1,64 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group('snap_io_latency_target')
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_invalid_cfg = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.cfg.snap_io_latency_target, 0)
+        t.assert_error_msg_contains(
+            "Incorrect value for option 'snap_io_latency_target'",
+            box.cfg, {snap_io_latency_target = -1})
+        t.assert_error_msg_contains(
+            "Incorrect value for option 'snap_io_latency_target'",
+            box.cfg, {snap_io_latency_target = 'foo'})
+        t.assert_equals(box.cfg.snap_io_latency_target, 0)
+    end)
+end
+
+g.test_snapshot = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local fiber = require('fiber')
+        local memtx = box.schema.space.create('memtx')
+        memtx:create_index('pk')
+        local vinyl = box.schema.space.create('vinyl', {engine = 'vinyl'})
+        vinyl:create_index('pk')
+        -- Every WAL write is slower than the target, so background
+        -- writes are slowed down as much as possible, but
+        -- checkpointing must still complete.
+        box.cfg{snap_io_latency_target = 1e-9}
+        local done = false
+        local writer = fiber.create(function()
+            local i = 0
+            while not done do
+                i = i + 1
+                memtx:replace({i % 100})
+                vinyl:replace({i % 100})
+            end
+        end)
+        writer:set_joinable(true)
+        for i = 1, 1000 do
+            box.begin()
+            memtx:replace({i, string.rep('x', 1000)})
+            vinyl:replace({i, string.rep('x', 1000)})
+            box.commit()
+        end
+        t.assert_equals(box.snapshot(), 'ok')
+        done = true
+        writer:join()
+        box.cfg{snap_io_latency_target = 0}
+        memtx:drop()
+        vinyl:drop()
+    end)
+end
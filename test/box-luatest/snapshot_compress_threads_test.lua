@@ -0,0 +1,57 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group('snapshot_compress_threads')
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        alias = 'master',
+        box_cfg = {memtx_snap_compress_threads = 4},
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_cfg = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.cfg.memtx_snap_compress_threads, 4)
+        local msg = "Incorrect value for option " ..
+                    "'memtx_snap_compress_threads': must be greater " ..
+                    "than or equal to 0, less than or equal to 64"
+        t.assert_error_msg_content_equals(msg, box.cfg,
+                                          {memtx_snap_compress_threads = -1})
+        t.assert_error_msg_content_equals(msg, box.cfg,
+                                          {memtx_snap_compress_threads = 65})
+        t.assert_equals(box.cfg.memtx_snap_compress_threads, 4)
+    end)
+end
+
+g.test_snapshot_recovery = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        -- Mix big transactions, which are compressed by the pool
+        -- threads, with small ones, which are written as is.
+        for i = 1, 20000 do
+            s:insert({i, string.rep(tostring(i), 10)})
+        end
+        local s2 = box.schema.space.create('small')
+        s2:create_index('pk')
+        s2:insert({1})
+        box.snapshot()
+    end)
+    cg.server:restart()
+    cg.server:exec(function()
+        local t = require('luatest')
+        local s = box.space.test
+        t.assert_equals(s:count(), 20000)
+        t.assert_equals(s:get(1), {1, string.rep('1', 10)})
+        t.assert_equals(s:get(12345), {12345, string.rep('12345', 10)})
+        t.assert_equals(s:max(), {20000, string.rep('20000', 10)})
+        t.assert_equals(box.space.small:select(), {{1}})
+    end)
+end
@@ -0,0 +1,108 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group('space_bulk_load', {{engine = 'memtx'}, {engine = 'vinyl'}})
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.before_each(function(cg)
+    cg.server:exec(function(engine)
+        local s = box.schema.space.create('test', {engine = engine})
+        s:create_index('pk')
+    end, {cg.params.engine})
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.space.test:drop()
+    end)
+end)
+
+g.test_load = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local fun = require('fun')
+        local s = box.space.test
+        local function tuple(i)
+            return {i, 'v' .. i, i % 10}
+        end
+        local tuples = {}
+        for i = 1, 1000 do
+            table.insert(tuples, tuple(i))
+        end
+        t.assert_equals(s:bulk_load(tuples, {batch_size = 100}), 1000)
+        t.assert_equals(s:count(), 1000)
+        t.assert_equals(s:get({500}), tuple(500))
+
+        -- Secondary indexes are built after the load.
+        s:create_index('sk', {parts = {2, 'string'}})
+        s:create_index('nsk', {parts = {3, 'unsigned'}, unique = false})
+        t.assert_equals(s.index.sk:get({'v500'}), tuple(500))
+        t.assert_equals(s.index.nsk:count({3}), 100)
+        s.index.nsk:drop()
+        s.index.sk:drop()
+
+        s:truncate()
+        t.assert_equals(s:bulk_load(fun.range(10):map(tuple)), 10)
+        t.assert_equals(s:select(), fun.range(10):map(tuple):totable())
+
+        -- The source may yield.
+        s:truncate()
+        local i = 0
+        t.assert_equals(s:bulk_load(function()
+            require('fiber').yield()
+            i = i + 1
+            return i <= 5 and tuple(i) or nil
+        end, {batch_size = 2}), 5)
+        t.assert_equals(s.index.pk:max(), tuple(5))
+    end)
+end
+
+g.test_errors = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local s = box.space.test
+        t.assert_error_msg_contains('source should be', s.bulk_load, s, 1)
+        t.assert_error_msg_contains('batch_size', s.bulk_load, s, {},
+                                    {batch_size = 0})
+        box.begin()
+        t.assert_error_msg_contains('active transaction',
+                                    s.bulk_load, s, {})
+        box.rollback()
+        s:insert({1, 'a', 1})
+        t.assert_error_msg_contains('empty space', s.bulk_load, s, {})
+        s:truncate()
+
+        -- Secondary indexes aren't touched while they are in use.
+        s:create_index('sk', {parts = {2, 'string'}})
+        t.assert_error_msg_contains('without secondary indexes',
+                                    s.bulk_load, s, {{1, 'a', 1}})
+        t.assert_equals(s:count(), 0)
+        s.index.sk:drop()
+
+        -- A failed insert leaves the space empty.
+        t.assert_error_msg_contains('Duplicate key', s.bulk_load, s,
+                                    {{1, 'a', 1}, {1, 'b', 2}},
+                                    {batch_size = 1})
+        t.assert_equals(s:count(), 0)
+
+        -- An error raised by the source.
+        local i = 0
+        t.assert_error_msg_contains('source error', s.bulk_load, s,
+                                    function()
+                                        i = i + 1
+                                        if i > 3 then
+                                            error('source error')
+                                        end
+                                        return {i, 'a', 1}
+                                    end, {batch_size = 2})
+        t.assert_equals(s:count(), 0)
+    end)
+end
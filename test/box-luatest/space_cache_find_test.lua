@@ -0,0 +1,48 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+-- Requests to many spaces in turn find the right space, also after
+-- spaces are dropped and recreated with the same ids.
+g.test_many_spaces = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local SPACE_COUNT = 40
+        local function create(round)
+            for i = 1, SPACE_COUNT do
+                local s = box.schema.space.create('test' .. i, {id = 1000 + i})
+                s:create_index('pk')
+                s:insert({i, round})
+            end
+        end
+        local function check(round)
+            for _ = 1, 3 do
+                for i = 1, SPACE_COUNT do
+                    t.assert_equals(box.space['test' .. i]:get(i), {i, round})
+                end
+            end
+        end
+        create(1)
+        check(1)
+        local old = box.space.test1
+        for i = 1, SPACE_COUNT do
+            box.space['test' .. i]:drop()
+        end
+        t.assert_error_msg_contains('does not exist', old.get, old, 1)
+        create(2)
+        check(2)
+        for i = 1, SPACE_COUNT do
+            box.space['test' .. i]:drop()
+        end
+    end)
+end
@@ -0,0 +1,98 @@
+local net = require('net.box')
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group('space_insert_many', {
+    {engine = 'memtx'}, {engine = 'vinyl'},
+})
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.before_each(function(cg)
+    cg.server:exec(function(engine)
+        local s = box.schema.space.create('test', {engine = engine})
+        s:create_index('pk')
+        s:create_index('sk', {parts = {{2, 'unsigned'}}})
+        box.schema.user.grant('guest', 'read,write', 'space', 'test')
+    end, {cg.params.engine})
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.space.test:drop()
+    end)
+end)
+
+g.test_insert_many = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        t.assert_equals(s:insert_many({{1, 10}, {2, 20}, box.tuple.new{3, 30}}),
+                        nil)
+        t.assert_equals(s:select(), {{1, 10}, {2, 20}, {3, 30}})
+        s:insert_many({})
+        t.assert_equals(s:count(), 3)
+        s:replace_many({{1, 11}, {4, 40}})
+        t.assert_equals(s:select(), {{1, 11}, {2, 20}, {3, 30}, {4, 40}})
+    end)
+end
+
+-- A batch is applied atomically.
+g.test_atomicity = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        s:insert({1, 10})
+        t.assert_error_msg_contains(
+            "Duplicate key exists",
+            s.insert_many, s, {{2, 20}, {1, 30}})
+        t.assert_equals(s:select(), {{1, 10}})
+        t.assert_error_msg_contains(
+            "Duplicate key exists",
+            s.replace_many, s, {{2, 20}, {3, 10}})
+        t.assert_equals(s:select(), {{1, 10}})
+        -- Statements done before the batch in the same transaction
+        -- are kept.
+        box.begin()
+        s:insert({5, 50})
+        t.assert_error_msg_contains(
+            "Duplicate key exists",
+            s.insert_many, s, {{6, 60}, {5, 70}})
+        s:insert({7, 70})
+        box.commit()
+        t.assert_equals(s:select(), {{1, 10}, {5, 50}, {7, 70}})
+    end)
+end
+
+g.test_errors = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        t.assert_error_msg_content_equals(
+            "Illegal parameters, Usage: space:insert_many({tuple1, " ..
+            "tuple2, ...})",
+            s.insert_many, s, 1)
+        t.assert_error_msg_content_equals(
+            "Tuple/Key must be MsgPack array",
+            s.insert_many, s, {{1, 10}, 2})
+        t.assert_equals(s:select(), {})
+    end)
+end
+
+g.test_net_box = function(cg)
+    local c = net.connect(cg.server.net_box_uri)
+    local s = c.space.test
+    t.assert_equals(s:insert_many({{1, 10}, {2, 20}}), nil)
+    s:replace_many({{2, 21}, {3, 30}})
+    t.assert_error_msg_contains(
+        "Duplicate key exists",
+        s.insert_many, s, {{4, 40}, {1, 50}})
+    t.assert_equals(cg.server:exec(function()
+        return box.space.test:select()
+    end), {{1, 10}, {2, 21}, {3, 30}})
+    c:close()
+end
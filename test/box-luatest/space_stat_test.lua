@@ -0,0 +1,94 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group('space_stat', {{engine = 'memtx'}, {engine = 'vinyl'}})
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_ops = function(cg)
+    cg.server:exec(function(engine)
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {engine = engine})
+        s:create_index('pk')
+        s:create_index('sk', {parts = {2, 'unsigned'}, unique = false})
+        local stat = s:stat()
+        t.assert_covers(stat, {
+            insert = 0, replace = 0, update = 0, upsert = 0, delete = 0,
+        })
+        t.assert_covers(stat.index.pk, {get = 0, select = 0, next = 0})
+        t.assert_covers(stat.index.sk, {get = 0, select = 0, next = 0})
+
+        for i = 1, 10 do
+            s:insert({i, i % 2})
+        end
+        s:replace({1, 1})
+        s:update({2}, {{'=', 2, 1}})
+        s:upsert({11, 1}, {{'=', 2, 0}})
+        s:delete({3})
+        t.assert_covers(s:stat(), {
+            insert = 10, replace = 1, update = 1, upsert = 1, delete = 1,
+        })
+
+        stat = s:stat()
+        s:get({4})
+        s:get({5})
+        t.assert_equals(#s.index.sk:select({1}), 6)
+        local new_stat = s:stat()
+        t.assert_equals(new_stat.index.pk.get - stat.index.pk.get, 2)
+        t.assert_equals(new_stat.index.sk.select - stat.index.sk.select, 1)
+        -- Six tuples and the end of the iteration.
+        t.assert_equals(new_stat.index.sk.next - stat.index.sk.next, 7)
+
+        -- The counters survive ALTER.
+        s:format({{'a', 'unsigned'}, {'b', 'unsigned'}})
+        t.assert_equals(s:stat().insert, 10)
+        t.assert_equals(s:stat().index.pk.get, new_stat.index.pk.get)
+    end, {cg.params.engine})
+end
+
+g.test_bsize = function(cg)
+    t.skip_if(cg.params.engine ~= 'memtx', 'memory is accounted by memtx')
+    cg.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:create_index('sk', {parts = {2, 'string'}})
+        for i = 1, 1000 do
+            s:insert({i, string.rep('x', 100) .. i})
+        end
+        local stat = s:stat()
+        t.assert_equals(stat.bsize, s:bsize())
+        t.assert_equals(stat.index.pk.bsize, s.index.pk:bsize())
+        t.assert_equals(stat.index.sk.bsize, s.index.sk:bsize())
+        t.assert_equals(stat.index_bsize,
+                        s.index.pk:bsize() + s.index.sk:bsize())
+        t.assert_equals(stat.index.pk.write, 1000)
+    end)
+end
+
+g.test_errors = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test')
+        t.assert_error_msg_contains('Use space:stat(...)',
+                                    s.stat)
+        s:drop()
+        t.assert_error_msg_content_equals("Space '512' does not exist",
+                                          box.internal.space.stat, 512)
+    end)
+end
@@ -0,0 +1,71 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.execute('DROP TABLE IF EXISTS t')
+    end)
+end)
+
+-- A query that has been prepared is executed by text with the
+-- cached statement, until the statement expires.
+g.test_execute_prepared_text = function(cg)
+    cg.server:exec(function()
+        box.execute('CREATE TABLE t (id INT PRIMARY KEY, a INT)')
+        box.execute('INSERT INTO t VALUES (1, 10), (2, 20)')
+        local sql = 'SELECT a FROM t WHERE id = ?'
+        local stmt = box.prepare(sql)
+        local count = box.info.sql().cache.stmt_count
+        t.assert_equals(box.execute(sql, {1}).rows, {{10}})
+        t.assert_equals(box.execute(sql, {2}).rows, {{20}})
+        t.assert_equals(box.execute(sql).rows, {})
+        t.assert_equals(stmt:execute({2}).rows, {{20}})
+        t.assert_equals(box.info.sql().cache.stmt_count, count)
+        -- Errors leave the cached statement usable.
+        local res, err = box.execute(sql, {{[':x'] = 1}})
+        t.assert_equals(res, nil)
+        t.assert_str_contains(err.message, 'was not found')
+        t.assert_equals(box.execute(sql, {1}).rows, {{10}})
+        -- The cached statement has expired.
+        box.execute('ALTER TABLE t ADD COLUMN b INT')
+        t.assert_equals(box.execute('SELECT * FROM t WHERE id = ?',
+                                    {1}).rows, {{1, 10, box.NULL}})
+        t.assert_equals(box.execute(sql, {1}).rows, {{10}})
+        stmt:unprepare()
+        t.assert_equals(box.execute(sql, {2}).rows, {{20}})
+    end)
+end
+
+-- A statement executed by text is not reused while it is running.
+g.test_execute_prepared_text_recursive = function(cg)
+    cg.server:exec(function()
+        box.execute('CREATE TABLE t (id INT PRIMARY KEY, a INT)')
+        box.execute('INSERT INTO t VALUES (1, 10), (2, 20)')
+        local sql = 'SELECT id, A(id) FROM t WHERE id <= ?'
+        box.schema.func.create('A', {
+            language = 'Lua', returns = 'integer', param_list = {'integer'},
+            exports = {'LUA', 'SQL'},
+            body = string.format([[function(id)
+                if id == 2 then
+                    return #box.execute(%q, {1}).rows
+                end
+                return 0
+            end]], sql),
+        })
+        local stmt = box.prepare(sql)
+        t.assert_equals(box.execute(sql, {2}).rows, {{1, 0}, {2, 1}})
+        stmt:unprepare()
+        box.func.A:drop()
+    end)
+end
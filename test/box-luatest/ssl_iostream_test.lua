@@ -0,0 +1,111 @@
+local fio = require('fio')
+local helpers = require('test.luatest_helpers')
+local net_box = require('net.box')
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group('ssl_iostream')
+
+local function run(cmd)
+    local rc = os.execute(cmd .. ' > /dev/null 2>&1')
+    return rc == 0 or rc == true
+end
+
+g.before_all(function(cg)
+    t.skip_if(not run('openssl version'), 'openssl command is not available')
+    cg.dir = fio.tempdir()
+    cg.key_file = fio.pathjoin(cg.dir, 'key.pem')
+    cg.cert_file = fio.pathjoin(cg.dir, 'cert.pem')
+    t.assert(run(('openssl req -x509 -newkey rsa:2048 -nodes -days 1 ' ..
+                  '-subj /CN=localhost -keyout %s -out %s'):format(
+                  cg.key_file, cg.cert_file)))
+    cg.master = server:new({alias = 'master'})
+    cg.master:start()
+    cg.uri = cg.master:exec(function(key_file, cert_file)
+        box.cfg{listen = {box.cfg.listen, {
+            uri = 'localhost:0',
+            params = {
+                transport = 'ssl',
+                ssl_key_file = key_file,
+                ssl_cert_file = cert_file,
+            },
+        }}}
+        return box.info.listen[2]
+    end, {cg.key_file, cg.cert_file})
+end)
+
+g.after_all(function(cg)
+    if cg.replica ~= nil then
+        cg.replica:drop()
+    end
+    if cg.master ~= nil then
+        cg.master:drop()
+    end
+    if cg.dir ~= nil then
+        fio.rmtree(cg.dir)
+    end
+end)
+
+-- The replica has an applier thread, but an SSL stream is read in tx,
+-- because the writer fiber sends ACKs to the same SSL object.
+g.test_replication = function(cg)
+    cg.master:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        for i = 1, 100 do
+            s:insert({i, string.rep('x', i * 100)})
+        end
+    end)
+    cg.replica = server:new({
+        alias = 'replica',
+        box_cfg = {
+            replication = {{
+                uri = cg.uri,
+                params = {transport = 'ssl', ssl_ca_file = cg.cert_file},
+            }},
+            read_only = true,
+            replication_threads = 1,
+        },
+    })
+    cg.replica:start()
+    cg.master:exec(function()
+        box.space.test:insert({101, string.rep('y', 100000)})
+    end)
+    local vclock = helpers:get_vclock(cg.master)
+    vclock[0] = nil
+    helpers:wait_vclock(cg.replica, vclock)
+    cg.replica:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.info.replication[1].upstream.status, 'follow')
+        t.assert_equals(box.space.test:count(), 101)
+        t.assert_equals(box.space.test:get(101)[2], string.rep('y', 100000))
+    end)
+end
+
+g.test_plain_client = function(cg)
+    local conn = net_box.connect(cg.uri, {connect_timeout = 0.5})
+    t.assert_not(conn:is_connected())
+    conn:close()
+end
+
+g.test_invalid_params = function(cg)
+    cg.master:exec(function(cert_file)
+        local t = require('luatest')
+        local listen = box.cfg.listen
+        t.assert_error_msg_contains(
+            'ssl_key_file and ssl_cert_file parameters are required ' ..
+            'for SSL server', box.cfg,
+            {listen = {uri = 'localhost:0', params = {transport = 'ssl'}}})
+        t.assert_error_msg_contains(
+            "can't load ssl_key_file", box.cfg,
+            {listen = {uri = 'localhost:0', params = {
+                transport = 'ssl',
+                ssl_key_file = '/no/such/file',
+                ssl_cert_file = cert_file,
+            }}})
+        t.assert_error_msg_contains(
+            'invalid transport: tls', box.cfg,
+            {listen = {uri = 'localhost:0', params = {transport = 'tls'}}})
+        t.assert_equals(box.cfg.listen, listen)
+    end, {cg.cert_file})
+end
@@ -0,0 +1,59 @@
+local net_box = require('net.box')
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group('stat_latency')
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        box.schema.user.grant('guest', 'read,write', 'space', 'test')
+    end)
+    cg.conn = net_box.connect(cg.server.net_box_uri)
+end)
+
+g.after_all(function(cg)
+    cg.conn:close()
+    cg.server:drop()
+end)
+
+g.test_latency = function(cg)
+    cg.server:exec(function()
+        box.stat.reset()
+        local t = require('luatest')
+        local stat = box.stat.latency()
+        t.assert_equals(stat.SELECT.total, {p50 = 0, p99 = 0, p999 = 0})
+        for _, name in ipairs({'net', 'cbus', 'tx', 'wal'}) do
+            t.assert_equals(stat.REPLACE[name],
+                            {p50 = 0, p99 = 0, p999 = 0}, name)
+        end
+        t.assert_equals(stat.NOP, nil)
+    end)
+
+    for i = 1, 100 do
+        cg.conn.space.test:replace({i})
+        cg.conn.space.test:get(i)
+    end
+
+    cg.server:exec(function()
+        local t = require('luatest')
+        local stat = box.stat.latency()
+        for _, name in ipairs({'SELECT', 'REPLACE'}) do
+            local total = stat[name].total
+            t.assert_gt(total.p50, 0, name)
+            t.assert_ge(total.p99, total.p50, name)
+            t.assert_ge(total.p999, total.p99, name)
+        end
+        -- Only DML requests wait for WAL.
+        t.assert_equals(stat.SELECT.wal.p999, 0)
+        t.assert_gt(stat.REPLACE.wal.p50, 0)
+        t.assert_ge(stat.REPLACE.total.p50, stat.REPLACE.wal.p50)
+
+        box.stat.reset()
+        stat = box.stat.latency()
+        t.assert_equals(stat.REPLACE.total, {p50 = 0, p99 = 0, p999 = 0})
+    end)
+end
@@ -0,0 +1,70 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group('tuple_compare_prefix')
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+-- Checks that a tree index on (unsigned, unsigned, string) orders tuples
+-- the same way as Lua does, including tuples sharing long prefixes.
+g.test_order = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test')
+        s:create_index('pk', {parts = {
+            {1, 'unsigned'}, {2, 'unsigned'}, {3, 'string'},
+        }})
+        local prefix = string.rep('x', 200)
+        local values = {0, 1, 127, 128, 255, 256, 65535, 65536,
+                        4294967295, 4294967296}
+        local expected = {}
+        math.randomseed(42)
+        for _ = 1, 2000 do
+            local a = values[math.random(#values)]
+            local b = values[math.random(#values)]
+            local len = math.random(0, 200)
+            local c = prefix:sub(1, len) .. string.char(math.random(97, 99))
+            if s:get({a, b, c}) == nil then
+                s:insert({a, b, c, 'payload'})
+                table.insert(expected, {a, b, c})
+            end
+        end
+        table.sort(expected, function(x, y)
+            if x[1] ~= y[1] then
+                return x[1] < y[1]
+            end
+            if x[2] ~= y[2] then
+                return x[2] < y[2]
+            end
+            return x[3] < y[3]
+        end)
+        local actual = {}
+        for _, tuple in s:pairs() do
+            table.insert(actual, {tuple[1], tuple[2], tuple[3]})
+        end
+        t.assert_equals(actual, expected)
+        -- Exact matches and range scans.
+        for _, key in ipairs(expected) do
+            t.assert_equals(s:get(key):totable(),
+                            {key[1], key[2], key[3], 'payload'})
+        end
+        local key = expected[math.floor(#expected / 2)]
+        local ge = s:select(key, {iterator = 'ge', limit = 3})
+        t.assert_equals(ge[1]:totable(), {key[1], key[2], key[3], 'payload'})
+    end)
+end
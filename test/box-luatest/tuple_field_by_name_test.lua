@@ -0,0 +1,80 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+-- Field access by name and by JSON path goes through FFI. Check
+-- that it returns the same values as before.
+g.test_field_by_name = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local decimal = require('decimal')
+        local uuid = require('uuid')
+        local datetime = require('datetime')
+        local s = box.schema.space.create('test', {
+            format = {
+                {'id', 'unsigned'},
+                {'str', 'string'},
+                {'map', 'map'},
+                {'dec', 'decimal'},
+                {'uuid', 'uuid'},
+                {'dt', 'datetime'},
+                {'a.b', 'unsigned'},
+                {'bsize', 'unsigned'},
+                {'opt', 'unsigned', is_nullable = true},
+            },
+        })
+        s:create_index('pk')
+        local u = uuid.new()
+        local dt = datetime.new({year = 2026, month = 10, day = 14})
+        local tuple = s:insert({1, 'abc', {x = {10, 20}, y = 'z'},
+                                decimal.new('1.5'), u, dt, 5, 7})
+        t:assert_equals(tuple.id, 1)
+        t:assert_equals(tuple.str, 'abc')
+        t:assert_equals(tuple.map, {x = {10, 20}, y = 'z'})
+        t:assert_equals(tuple['map.x[2]'], 20)
+        t:assert_equals(tuple['[3].y'], 'z')
+        t:assert_equals(tuple['[2]'], 'abc')
+        t:assert_equals(tuple.dec, decimal.new('1.5'))
+        t:assert_equals(tuple.uuid, u)
+        t:assert_equals(tuple.dt, dt)
+        -- A field name that looks like a JSON path.
+        t:assert_equals(tuple['a.b'], 5)
+        -- Fields take precedence over methods.
+        t:assert_equals(tuple.bsize, 7)
+        t:assert_equals(type(tuple.totable), 'function')
+        t:assert_equals(tuple.opt, nil)
+        t:assert_equals(tuple.no_such_field, nil)
+        t:assert_equals(tuple['map.no_such_key'], nil)
+        t:assert_equals(tuple[''], nil)
+        -- The same field of tuples of different formats.
+        local tuples = {tuple, box.tuple.new({1, 2}),
+                        box.space._space:get(s.id)}
+        t:assert_equals(tuples[1].str, 'abc')
+        t:assert_equals(tuples[2].str, nil)
+        t:assert_equals(tuples[3].name, 'test')
+        -- A loop over tuples, which is compiled by LuaJIT.
+        local sum = 0
+        for _ = 1, 1000 do
+            sum = sum + tuple.id + tuple['a.b']
+        end
+        t:assert_equals(sum, 6000)
+    end)
+end
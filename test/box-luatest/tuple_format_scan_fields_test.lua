@@ -0,0 +1,96 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group('tuple_format_scan_fields', {
+    {engine = 'memtx'}, {engine = 'vinyl'},
+})
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+-- Offsets of the leading fields preceded by scalars aren't stored in
+-- the field map. Check that such fields are still accessed correctly.
+g.test_scan_fields = function(cg)
+    cg.server:exec(function(engine)
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {
+            engine = engine,
+            format = {
+                {'a', 'unsigned'},
+                {'b', 'string'},
+                {'c', 'unsigned'},
+                {'d', 'unsigned', is_nullable = true},
+                {'e', 'any', is_nullable = true},
+                {'f', 'unsigned', is_nullable = true},
+            },
+        })
+        s:create_index('pk')
+        s:create_index('c', {parts = {'c'}, unique = false})
+        s:create_index('d', {parts = {'d'}, unique = false})
+        s:create_index('f', {parts = {'f'}, unique = false})
+        for i = 1, 100 do
+            local d = i % 2 == 0 and i or nil
+            s:insert({i, string.rep('x', i), 200 - i, d, {i, {i}}, i * 2})
+        end
+        t.assert_equals(s.index.c:select({150}), {s:get(50)})
+        t.assert_equals(s.index.d:select({50}), {s:get(50)})
+        t.assert_equals(s.index.d:count({box.NULL}), 50)
+        t.assert_equals(s.index.f:select({100}), {s:get(50)})
+        t.assert_equals(s.index.c:select({}, {limit = 1})[1].a, 100)
+        s:update({50}, {{'=', 'c', 1000}, {'=', 'f', 1000}})
+        t.assert_equals(s.index.c:select({1000})[1].a, 50)
+        t.assert_equals(s.index.f:select({1000})[1].a, 50)
+        t.assert_equals(s.index.c:max().a, 50)
+    end, {cg.params.engine})
+end
+
+-- Offsets of the fields preceded only by fixed-size fields are known
+-- without decoding the tuple. Check that such fields are accessed
+-- correctly, including tuples that are shorter than the format.
+g.test_fixed_offset_fields = function(cg)
+    cg.server:exec(function(engine)
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {
+            engine = engine,
+            format = {
+                {'x', 'double'},
+                {'flag', 'boolean', is_nullable = true},
+                {'y', 'double'},
+                {'z', 'double'},
+                {'k', 'unsigned', is_nullable = true},
+            },
+        })
+        s:create_index('pk', {parts = {'x'}})
+        s:create_index('z', {parts = {'z'}})
+        s:create_index('k', {parts = {'k'}, unique = false})
+        local flags = {true, false, box.NULL}
+        for i = 1, 100 do
+            local tuple = {i + 0.5, flags[i % 3 + 1], i + 0.25, -i - 0.5}
+            if i % 2 == 0 then
+                tuple[5] = i
+            end
+            s:insert(tuple)
+        end
+        t.assert_equals(s.index.z:get({-50.5}), s:get({50.5}))
+        t.assert_equals(s.index.z:min().x, 100.5)
+        t.assert_equals(s.index.k:select({50}), {s:get({50.5})})
+        t.assert_equals(s.index.k:count({box.NULL}), 50)
+        s:update({50.5}, {{'=', 'z', 1000.5}, {'=', 'k', 1000}})
+        t.assert_equals(s.index.z:max().x, 50.5)
+        t.assert_equals(s.index.k:max().x, 50.5)
+    end, {cg.params.engine})
+end
@@ -0,0 +1,66 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group('tuple_path_cache')
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_path_access = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {format = {
+            {'id', 'unsigned'}, {'data', 'map'},
+        }})
+        s:create_index('pk')
+        s:create_index('sk', {parts = {{'data.a.b', 'unsigned'}}})
+        s:insert({1, {a = {b = 10, c = {20, 30}}}})
+        s:insert({2, {a = {b = 11, c = {21, 31}}}})
+        for _ = 1, 2 do
+            for i, tuple in s:pairs() do
+                t.assert_equals(tuple['data.a.b'], 9 + i)
+                t.assert_equals(tuple['data.a.c[2]'], 29 + i)
+                t.assert_equals(tuple['[2].a.b'], 9 + i)
+                t.assert_equals(tuple['id'], i)
+                t.assert_equals(tuple['data.x'], nil)
+            end
+        end
+        -- The same path in a tuple of another format.
+        local tuple = box.tuple.new({{a = {b = 12}}, 1})
+        t.assert_equals(tuple['[1].a.b'], 12)
+        t.assert_equals(tuple['data.a.b'], nil)
+    end)
+end
+
+g.test_format_change = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {format = {
+            {'a', 'unsigned'}, {'b', 'unsigned'},
+        }})
+        s:create_index('pk')
+        s:insert({1, 2})
+        local tuple = s:get(1)
+        t.assert_equals(tuple.a, 1)
+        t.assert_equals(tuple['b'], 2)
+        -- Field names are changed in place for the old tuples.
+        s:format({{'b', 'unsigned'}, {'a', 'unsigned'}})
+        t.assert_equals(tuple['a'], 2)
+        t.assert_equals(tuple['b'], 1)
+        t.assert_equals(s:get(1)['a'], 2)
+    end)
+end
@@ -0,0 +1,63 @@
+local net = require('net.box')
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group()
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {format = {
+            {'a', 'unsigned'},
+            {'b', 'string', is_nullable = true},
+            {'c', 'unsigned', is_nullable = true},
+        }})
+        s:create_index('pk')
+        s:create_index('sk', {parts = {{3, 'unsigned'}}})
+        box.schema.user.grant('guest', 'read,write', 'space', 'test')
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.space.test:truncate()
+    end)
+end)
+
+-- Fields required by a format or by an index are checked whether or
+-- not the tuple is long enough to contain them.
+g.test_required_fields = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        t.assert_error_msg_content_equals(
+            "Tuple field 3 (c) required by space format is missing",
+            s.insert, s, {1, 'x'})
+        t.assert_error_msg_content_equals(
+            "Tuple field 3 (c) type does not match one required by " ..
+            "operation: expected unsigned, got nil",
+            s.insert, s, {1, 'x', box.NULL})
+        t.assert_error_msg_content_equals(
+            "Tuple field 2 (b) type does not match one required by " ..
+            "operation: expected string, got unsigned",
+            s.insert, s, {1, 2, 3})
+        t.assert_equals(s:insert({1, box.NULL, 3}).c, 3)
+        t.assert_equals(s:insert({2, 'x', 4, 'extra'}):totable(),
+                        {2, 'x', 4, 'extra'})
+    end)
+end
+
+g.test_net_box_big_tuple = function(cg)
+    local c = net.connect(cg.server.net_box_uri)
+    local tuple = {1, string.rep('x', 100000), 2}
+    for i = 4, 1000 do
+        tuple[i] = i
+    end
+    t.assert_equals(c.space.test:insert(tuple):totable(), tuple)
+    t.assert_equals(c.space.test:get({1}):totable(), tuple)
+    c:close()
+end
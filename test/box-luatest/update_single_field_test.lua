@@ -0,0 +1,87 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group('update_single_field', {
+    {engine = 'memtx'}, {engine = 'vinyl'},
+})
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+-- An update of a single top-level field is applied without the
+-- update tree. Check that it gives the same results.
+g.test_single_field = function(cg)
+    cg.server:exec(function(engine)
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {
+            engine = engine,
+            format = {
+                {'id', 'unsigned'},
+                {'counter', 'integer'},
+                {'ratio', 'double'},
+                {'name', 'string'},
+                {'data', 'any'},
+            },
+        })
+        s:create_index('pk')
+        s:insert({1, 0, 1.5, 'abc', {a = 1}, 'tail'})
+
+        t:assert_equals(s:update(1, {{'+', 2, 1}}),
+                        {1, 1, 1.5, 'abc', {a = 1}, 'tail'})
+        t:assert_equals(s:update(1, {{'-', 'counter', 2}}),
+                        {1, -1, 1.5, 'abc', {a = 1}, 'tail'})
+        -- The field changes its MessagePack size.
+        t:assert_equals(s:update(1, {{'+', 2, 1000001}}),
+                        {1, 1000000, 1.5, 'abc', {a = 1}, 'tail'})
+        t:assert_equals(s:update(1, {{'=', 4, 'abcdef'}}),
+                        {1, 1000000, 1.5, 'abcdef', {a = 1}, 'tail'})
+        t:assert_equals(s:update(1, {{'=', -1, 'end'}}),
+                        {1, 1000000, 1.5, 'abcdef', {a = 1}, 'end'})
+        t:assert_equals(s:update(1, {{'|', 2, 7}}),
+                        {1, 1000007, 1.5, 'abcdef', {a = 1}, 'end'})
+        -- A float result is stored as double in a double field.
+        local tuple = s:update(1, {{'+', 'ratio', 1}})
+        t:assert_equals(tuple.ratio, 2.5)
+        t:assert_equals(require('msgpack').decode(
+                            require('msgpack').encode(tuple))[3], 2.5)
+        -- Not a single top-level field: the regular path.
+        t:assert_equals(s:update(1, {{'=', '[5].a', 2}}),
+                        {1, 1000007, 2.5, 'abcdef', {a = 2}, 'end'})
+        t:assert_equals(s:update(1, {{'=', 7, 'new'}}),
+                        {1, 1000007, 2.5, 'abcdef', {a = 2}, 'end', 'new'})
+        t:assert_equals(s:update(1, {{'+', 2, 1}, {'=', 4, 'x'}}),
+                        {1, 1000008, 2.5, 'x', {a = 2}, 'end', 'new'})
+        t:assert_equals(s:get(1),
+                        {1, 1000008, 2.5, 'x', {a = 2}, 'end', 'new'})
+
+        -- Errors are the same as before.
+        t:assert_error_msg_content_equals(
+            "Argument type in operation '+' on field 'name' does not " ..
+            "match field type: expected a number",
+            s.update, s, 1, {{'+', 'name', 1}})
+        t:assert_error_msg_content_equals(
+            "Tuple field 4 (name) type does not match one required by " ..
+            "operation: expected string, got unsigned",
+            s.update, s, 1, {{'=', 4, 1}})
+        t:assert_error_msg_content_equals(
+            "Attempt to modify a tuple field which is part of index " ..
+            "'pk' in space 'test'",
+            s.update, s, 1, {{'+', 1, 1}})
+        t:assert_equals(s:get(1),
+                        {1, 1000008, 2.5, 'x', {a = 2}, 'end', 'new'})
+    end, {cg.params.engine})
+end
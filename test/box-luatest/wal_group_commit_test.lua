@@ -0,0 +1,77 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group('wal_group_commit')
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_cfg = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.cfg.wal_group_commit_delay, 0)
+        t.assert_equals(box.cfg.wal_group_commit_max_size, 1024 * 1024)
+        t.assert_error_msg_contains(
+            "Incorrect value for option 'wal_group_commit_delay'",
+            box.cfg, {wal_group_commit_delay = -1})
+        t.assert_error_msg_contains(
+            "Incorrect value for option 'wal_group_commit_max_size'",
+            box.cfg, {wal_group_commit_max_size = 0})
+    end)
+end
+
+g.test_stat = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local stat = box.stat.wal()
+        box.space.test:replace({1})
+        local new_stat = box.stat.wal()
+        t.assert_equals(new_stat.writes, stat.writes + 1)
+        t.assert_equals(new_stat.entries, stat.entries + 1)
+        t.assert_gt(new_stat.bytes, stat.bytes)
+        t.assert_type(new_stat.batch_histogram, 'string')
+    end)
+end
+
+g.test_group_commit = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local fiber = require('fiber')
+        box.cfg{wal_group_commit_delay = 0.05}
+        local stat = box.stat.wal()
+        local count = 100
+        local done = fiber.channel(count)
+        for i = 1, count do
+            fiber.create(function()
+                -- Spread the writes in time so that they aren't
+                -- batched by tx already.
+                fiber.sleep(i * 0.001)
+                box.space.test:replace({i})
+                done:put(true)
+            end)
+        end
+        for _ = 1, count do
+            t.assert(done:get(10))
+        end
+        local new_stat = box.stat.wal()
+        t.assert_equals(new_stat.entries - stat.entries, count)
+        t.assert_lt(new_stat.writes - stat.writes, count)
+        t.assert_equals(box.space.test:count(), count)
+        box.cfg{wal_group_commit_delay = 0}
+    end)
+    cg.server:restart()
+    cg.server:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.space.test:count(), 100)
+    end)
+end
@@ -0,0 +1,42 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group('wal_io_mode')
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        alias = 'master',
+        box_cfg = {wal_mode = 'fsync', wal_io_mode = 'dsync'},
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_cfg = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.cfg.wal_io_mode, 'dsync')
+        t.assert_error_msg_equals(
+            "Can't set option 'wal_io_mode' dynamically",
+            box.cfg, {wal_io_mode = 'buffered'})
+    end)
+end
+
+g.test_recovery = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        for i = 1, 100 do
+            s:replace({i})
+        end
+    end)
+    cg.server:restart()
+    cg.server:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.space.test:count(), 100)
+        box.space.test:drop()
+    end)
+end
@@ -0,0 +1,48 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group('wal_recovery_reader')
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        alias = 'master',
+        -- Make the instance recover from several WAL files.
+        box_cfg = {wal_max_size = 64 * 1024},
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_wal_recovery = function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        box.snapshot()
+        -- Mix single-row transactions, which are written as is,
+        -- with big ones, which are compressed.
+        for i = 1, 5000 do
+            s:insert({i, string.rep(tostring(i), 10)})
+        end
+        box.begin()
+        for i = 5001, 10000 do
+            s:insert({i, string.rep(tostring(i), 10)})
+        end
+        box.commit()
+        s:delete({1})
+        s:update({2}, {{'=', 2, 'x'}})
+    end)
+    cg.server:restart()
+    cg.server:exec(function()
+        local t = require('luatest')
+        local s = box.space.test
+        t.assert_equals(s:count(), 9999)
+        t.assert_equals(s:get(1), nil)
+        t.assert_equals(s:get(2), {2, 'x'})
+        t.assert_equals(s:get(6789), {6789, string.rep('6789', 10)})
+        t.assert_equals(s:max(), {10000, string.rep('10000', 10)})
+        t.assert_gt(#require('fio').glob(box.cfg.wal_dir .. '/*.xlog'), 2)
+    end)
+end
@@ -0,0 +1,51 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group('wal_spare')
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        alias = 'master',
+        box_cfg = {wal_max_size = 1024 * 1024},
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.test_spare = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local fio = require('fio')
+        local spare = fio.pathjoin(box.cfg.wal_dir, 'spare.xlog.inprogress')
+        t.helpers.retrying({}, function()
+            t.assert(fio.path.exists(spare))
+        end)
+        local function xlogs()
+            return #fio.glob(fio.pathjoin(box.cfg.wal_dir, '*.xlog'))
+        end
+        local count = xlogs()
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        local data = string.rep('x', 1000)
+        for i = 1, 2000 do
+            s:replace({i, data})
+        end
+        -- The spare file was taken for new WAL files and then
+        -- created again.
+        t.assert_gt(xlogs(), count)
+        t.helpers.retrying({}, function()
+            t.assert(fio.path.exists(spare))
+        end)
+    end)
+    cg.server:restart()
+    cg.server:exec(function()
+        local t = require('luatest')
+        local s = box.space.test
+        t.assert_equals(s:count(), 2000)
+        t.assert_equals(s:get(2000)[2], string.rep('x', 1000))
+        s:drop()
+    end)
+end
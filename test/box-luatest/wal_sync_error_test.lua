@@ -0,0 +1,55 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group('wal_sync_error')
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        alias = 'master',
+        box_cfg = {wal_mode = 'fsync'},
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+-- A batch that failed to sync is cut off the WAL file and rolled back.
+-- The size of WAL written since the last checkpoint must not be
+-- decreased by more than was added for the batch, otherwise finishing
+-- a checkpoint that was in progress when the sync failed breaks the
+-- accounting.
+g.test_sync_error = function(cg)
+    cg.server:exec(function()
+        local fiber = require('fiber')
+        local t = require('luatest')
+        local s = box.schema.space.create('test')
+        s:create_index('pk')
+        s:insert({1})
+
+        box.error.injection.set('ERRINJ_SNAP_WRITE_DELAY', true)
+        local f = fiber.new(box.snapshot)
+        f:set_joinable(true)
+        t.helpers.retrying({}, function()
+            t.assert(box.info.gc().checkpoint_is_in_progress)
+        end)
+
+        box.error.injection.set('ERRINJ_WAL_SYNC_BATCH', true)
+        t.assert_error_msg_equals('Failed to write to disk',
+                                  s.insert, s, {2})
+        box.error.injection.set('ERRINJ_WAL_SYNC_BATCH', false)
+        s:insert({3})
+
+        box.error.injection.set('ERRINJ_SNAP_WRITE_DELAY', false)
+        t.assert_equals({f:join()}, {true, 'ok'})
+        t.assert_equals(s:select(), {{1}, {3}})
+        s:insert({4})
+    end)
+    cg.server:restart()
+    cg.server:exec(function()
+        local t = require('luatest')
+        t.assert_equals(box.space.test:select(), {{1}, {3}, {4}})
+        box.space.test:drop()
+    end)
+end
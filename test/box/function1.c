@@ -290,3 +290,42 @@ test_return_mp(box_function_ctx_t *ctx, const char *args, const char *args_end)
 	rc = box_return_tuple(ctx, tuple);
 	return rc;
 }
+
+/**
+ * Return the second argument, which must be an array, as many times
+ * as the first argument says, alternating MsgPack values and tuples.
+ */
+int
+test_return_repeat(box_function_ctx_t *ctx, const char *args,
+		   const char *args_end)
+{
+	uint32_t arg_count = mp_decode_array(&args);
+	if (arg_count != 2 || mp_typeof(*args) != MP_UINT) {
+		return box_error_set(__FILE__, __LINE__, ER_PROC_C, "%s",
+				     "usage: test_return_repeat(count, array)");
+	}
+	uint64_t count = mp_decode_uint(&args);
+	if (mp_typeof(*args) != MP_ARRAY) {
+		return box_error_set(__FILE__, __LINE__, ER_PROC_C, "%s",
+				     "usage: test_return_repeat(count, array)");
+	}
+	const char *value = args;
+	const char *value_end = args;
+	mp_next(&value_end);
+	for (uint64_t i = 0; i < count; i++) {
+		int rc;
+		if (i % 2 == 0) {
+			rc = box_return_mp(ctx, value, value_end);
+		} else {
+			box_tuple_t *tuple;
+			tuple = box_tuple_new(box_tuple_format_default(),
+					      value, value_end);
+			if (tuple == NULL)
+				return -1;
+			rc = box_return_tuple(ctx, tuple);
+		}
+		if (rc != 0)
+			return rc;
+	}
+	return 0;
+}
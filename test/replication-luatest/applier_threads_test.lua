@@ -0,0 +1,95 @@
+local t = require('luatest')
+local cluster = require('test.luatest_helpers.cluster')
+local helpers = require('test.luatest_helpers')
+
+local g = t.group('applier_threads', {{engine = 'memtx'}, {engine = 'vinyl'}})
+
+g.before_each(function(cg)
+    local engine = cg.params.engine
+
+    cg.cluster = cluster:new({})
+
+    local box_cfg = {
+        replication         = {
+            helpers.instance_uri('master')
+        },
+        replication_timeout = 1,
+        read_only           = false
+    }
+
+    cg.master = cg.cluster:build_server({alias = 'master', engine = engine, box_cfg = box_cfg})
+
+    local box_cfg = {
+        replication         = {
+            helpers.instance_uri('master'),
+            helpers.instance_uri('replica')
+        },
+        replication_timeout = 1,
+        replication_connect_timeout = 4,
+        replication_threads = 2,
+        read_only           = true
+    }
+
+    cg.replica = cg.cluster:build_server({alias = 'replica', engine = engine, box_cfg = box_cfg})
+
+    cg.cluster:add_server(cg.master)
+    cg.cluster:add_server(cg.replica)
+    cg.cluster:start()
+end)
+
+
+g.after_each(function(cg)
+    cg.cluster.servers = nil
+    cg.cluster:drop()
+end)
+
+
+g.test_replication = function(cg)
+    cg.master:eval("s = box.schema.space.create('test', {engine = ...})",
+                   {cg.params.engine})
+    cg.master:eval("s:create_index('pk')")
+    -- Single-statement and multi-statement transactions.
+    cg.master:eval("for i = 1, 1000 do s:insert{i, string.rep('x', i)} end")
+    cg.master:eval([[
+        box.begin()
+        for i = 1001, 1100 do s:insert{i} end
+        s:delete{1}
+        box.commit()
+    ]])
+
+    local vclock = helpers:get_vclock(cg.master)
+    vclock[0] = nil
+    helpers:wait_vclock(cg.replica, vclock)
+
+    t.assert_equals(cg.replica:eval("return box.space.test:count()"), 1099)
+    t.assert_equals(cg.replica:eval("return box.space.test:get{1000}"),
+                    {1000, string.rep('x', 1000)})
+    t.assert_equals(cg.replica:eval("return box.space.test:get{1}"), nil)
+    t.assert_equals(cg.replica:eval("return box.info.replication[1].upstream.status"), 'follow')
+end
+
+g.test_reconnect = function(cg)
+    cg.master:eval("s = box.schema.space.create('test', {engine = ...})",
+                   {cg.params.engine})
+    cg.master:eval("s:create_index('pk')")
+    cg.master:eval("s:insert{1}")
+
+    -- Restart replication to check that the reader is stopped and
+    -- a new one is started.
+    cg.replica:eval("rep = box.cfg.replication")
+    cg.replica:eval("box.cfg{replication = {}}")
+    cg.master:eval("s:insert{2}")
+    cg.replica:eval("box.cfg{replication = rep}")
+
+    local vclock = helpers:get_vclock(cg.master)
+    vclock[0] = nil
+    helpers:wait_vclock(cg.replica, vclock)
+    t.assert_equals(cg.replica:eval("return box.space.test:select()"), {{1}, {2}})
+end
+
+g.test_cfg = function(cg)
+    t.assert_equals(cg.replica:eval("return box.cfg.replication_threads"), 2)
+    t.assert_error_msg_contains("Can't set option 'replication_threads' dynamically",
+                                cg.replica.eval, cg.replica,
+                                "box.cfg{replication_threads = 1}")
+end
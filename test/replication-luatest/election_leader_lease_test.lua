@@ -0,0 +1,64 @@
+local t = require('luatest')
+local cluster = require('test.luatest_helpers.cluster')
+local helpers = require('test.luatest_helpers')
+
+local g = t.group('election_leader_lease')
+
+g.before_all(function(cg)
+    cg.cluster = cluster:new({})
+    local box_cfg = {
+        replication = {
+            helpers.instance_uri('server1'),
+            helpers.instance_uri('server2'),
+            helpers.instance_uri('server3'),
+        },
+        election_mode = 'manual',
+        election_leader_lease = true,
+        election_timeout = 1,
+        replication_synchro_quorum = 2,
+        replication_timeout = 0.1,
+    }
+    for i = 1, 3 do
+        local alias = 'server' .. i
+        local cfg = table.copy(box_cfg)
+        cfg.listen = helpers.instance_uri(alias)
+        cg[alias] = cg.cluster:build_server({alias = alias, box_cfg = cfg})
+        cg.cluster:add_server(cg[alias])
+    end
+    cg.cluster:start()
+    -- The voters don't let anybody in right after start, so retry.
+    t.helpers.retrying({timeout = 60}, function()
+        cg.server1:exec(function()
+            box.ctl.promote()
+            box.ctl.wait_rw(1)
+        end)
+    end)
+end)
+
+g.after_all(function(cg)
+    cg.cluster:drop()
+end)
+
+g.test_read_barrier_on_leader = function(cg)
+    cg.server1:exec(function()
+        box.ctl.read_barrier(30)
+    end)
+end
+
+g.test_read_barrier_on_follower = function(cg)
+    local ok, err = cg.server2:exec(function()
+        local ok, err = pcall(box.ctl.read_barrier, 1)
+        return ok, err and err:unpack()
+    end)
+    t.assert(not ok)
+    t.assert_equals(err.code, box.error.NOT_LEADER)
+end
+
+g.test_read_barrier_without_lease = function(cg)
+    cg.server2:exec(function()
+        box.cfg{election_leader_lease = false}
+        -- Nothing to wait for in the synchro queue.
+        box.ctl.read_barrier(1)
+        box.cfg{election_leader_lease = true}
+    end)
+end
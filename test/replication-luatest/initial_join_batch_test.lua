@@ -0,0 +1,70 @@
+local t = require('luatest')
+local cluster = require('test.luatest_helpers.cluster')
+local helpers = require('test.luatest_helpers')
+
+local g = t.group('initial_join_batch', {{engine = 'memtx'}, {engine = 'vinyl'}})
+
+g.before_each(function(cg)
+    cg.cluster = cluster:new({})
+    local box_cfg = {
+        replication         = {
+            helpers.instance_uri('master')
+        },
+        replication_timeout = 1,
+        read_only           = false
+    }
+    cg.master = cg.cluster:build_server({alias = 'master',
+                                         engine = cg.params.engine,
+                                         box_cfg = box_cfg})
+    cg.cluster:add_server(cg.master)
+    cg.cluster:start()
+end)
+
+g.after_each(function(cg)
+    cg.cluster.servers = nil
+    cg.cluster:drop()
+end)
+
+g.test_join = function(cg)
+    -- Enough data for several write batches, in several spaces.
+    cg.master:eval([[
+        for i = 1, 3 do
+            local s = box.schema.space.create('test' .. i, {engine = ...})
+            s:create_index('pk')
+            s:create_index('sk', {parts = {2, 'string'}, unique = false})
+            box.begin()
+            for j = 1, 5000 do
+                s:insert{j, string.rep(tostring(j % 10), 100)}
+            end
+            box.commit()
+        end
+    ]], {cg.params.engine})
+    cg.master:eval("box.snapshot()")
+
+    local box_cfg = {
+        replication         = {
+            helpers.instance_uri('master'),
+            helpers.instance_uri('replica')
+        },
+        replication_timeout = 1,
+        replication_connect_timeout = 4,
+        read_only           = true
+    }
+    cg.replica = cg.cluster:build_server({alias = 'replica',
+                                          engine = cg.params.engine,
+                                          box_cfg = box_cfg})
+    cg.cluster:add_server(cg.replica)
+    cg.replica:start()
+
+    local vclock = helpers:get_vclock(cg.master)
+    vclock[0] = nil
+    helpers:wait_vclock(cg.replica, vclock)
+    for i = 1, 3 do
+        local s = 'box.space.test' .. i
+        t.assert_equals(cg.replica:eval("return " .. s .. ":count()"), 5000)
+        t.assert_equals(cg.replica:eval("return " .. s .. ":get{5000}"),
+                        {5000, string.rep('0', 100)})
+        t.assert_equals(cg.replica:eval(
+            "return " .. s .. ".index.sk:count{string.rep('7', 100)}"), 500)
+    end
+end
@@ -0,0 +1,110 @@
+local t = require('luatest')
+local cluster = require('test.luatest_helpers.cluster')
+local helpers = require('test.luatest_helpers')
+
+local g = t.group('relay_wal_mem')
+
+g.before_each(function(cg)
+    cg.cluster = cluster:new({})
+
+    local box_cfg = {
+        replication         = {
+            helpers.instance_uri('master')
+        },
+        replication_timeout = 1,
+        checkpoint_count    = 1,
+        -- Rotate WAL files often to check that relays reading
+        -- rows from memory don't stall garbage collection.
+        wal_max_size        = 16 * 1024,
+        read_only           = false
+    }
+    cg.master = cg.cluster:build_server({alias = 'master', box_cfg = box_cfg})
+
+    cg.replicas = {}
+    for i = 1, 2 do
+        local alias = 'replica' .. i
+        local box_cfg = {
+            replication         = {
+                helpers.instance_uri('master'),
+                helpers.instance_uri(alias)
+            },
+            replication_timeout = 1,
+            replication_connect_timeout = 4,
+            read_only           = true
+        }
+        cg.replicas[i] = cg.cluster:build_server({alias = alias,
+                                                  box_cfg = box_cfg})
+    end
+
+    cg.cluster:add_server(cg.master)
+    for _, replica in ipairs(cg.replicas) do
+        cg.cluster:add_server(replica)
+    end
+    cg.cluster:start()
+
+    cg.master:eval("s = box.schema.space.create('test')")
+    cg.master:eval("s:create_index('pk')")
+end)
+
+g.after_each(function(cg)
+    cg.cluster.servers = nil
+    cg.cluster:drop()
+end)
+
+local function wait_replicas(cg)
+    local vclock = helpers:get_vclock(cg.master)
+    vclock[0] = nil
+    for _, replica in ipairs(cg.replicas) do
+        helpers:wait_vclock(replica, vclock)
+    end
+end
+
+g.test_replication = function(cg)
+    cg.master:eval([[
+        for i = 1, 1000 do s:insert{i, string.rep('x', 100)} end
+        box.begin()
+        for i = 1001, 1100 do s:insert{i} end
+        s:delete{1}
+        box.commit()
+    ]])
+    wait_replicas(cg)
+    for _, replica in ipairs(cg.replicas) do
+        t.assert_equals(replica:eval("return box.space.test:count()"), 1099)
+        t.assert_equals(replica:eval("return box.space.test:get{1}"), nil)
+        t.assert_equals(replica:eval("return box.space.test:get{1100}"),
+                        {1100})
+    end
+end
+
+g.test_lagging_replica = function(cg)
+    -- Stop one replica so that it has to read WAL files on
+    -- reconnect, while the other one keeps reading from memory.
+    local replica = cg.replicas[2]
+    replica:eval("rep = box.cfg.replication")
+    replica:eval("box.cfg{replication = {}}")
+    cg.master:eval("for i = 1, 500 do s:insert{i, string.rep('x', 100)} end")
+    replica:eval("box.cfg{replication = rep}")
+    cg.master:eval("for i = 501, 1000 do s:insert{i} end")
+    wait_replicas(cg)
+    for _, replica in ipairs(cg.replicas) do
+        t.assert_equals(replica:eval("return box.space.test:count()"), 1000)
+        t.assert_equals(replica:eval(
+            "return box.info.replication[1].upstream.status"), 'follow')
+    end
+end
+
+g.test_garbage_collection = function(cg)
+    cg.master:eval("for i = 1, 1000 do s:insert{i, string.rep('x', 100)} end")
+    wait_replicas(cg)
+    cg.master:eval("box.snapshot()")
+    cg.master:eval("s:insert{1001}")
+    wait_replicas(cg)
+    -- Old WAL files are removed once the replicas receive them.
+    t.helpers.retrying({}, function()
+        cg.master:eval("box.snapshot()")
+        t.assert_le(cg.master:eval("return #box.info.gc().checkpoints"), 1)
+        t.assert_le(cg.master:eval([[
+            return #require('fio').glob(box.cfg.wal_dir .. '/*.xlog')
+        ]]), 2)
+    end)
+end
@@ -0,0 +1,146 @@
+local t = require('luatest')
+local cluster = require('test.luatest_helpers.cluster')
+local helpers = require('test.luatest_helpers')
+
+local g = t.group('replication_compression', {
+    {replication_threads = 0}, {replication_threads = 1},
+})
+
+g.before_each(function(cg)
+    cg.cluster = cluster:new({})
+
+    local box_cfg = {
+        replication         = {
+            helpers.instance_uri('master')
+        },
+        replication_timeout = 1,
+        replication_compression_level = 1,
+        replication_compression_batch_size = 1024,
+        read_only           = false
+    }
+
+    cg.master = cg.cluster:build_server({alias = 'master', box_cfg = box_cfg})
+
+    local box_cfg = {
+        replication         = {
+            helpers.instance_uri('master'),
+            helpers.instance_uri('replica')
+        },
+        replication_timeout = 1,
+        replication_connect_timeout = 4,
+        replication_threads = cg.params.replication_threads,
+        read_only           = true
+    }
+
+    cg.replica = cg.cluster:build_server({alias = 'replica', box_cfg = box_cfg})
+
+    cg.cluster:add_server(cg.master)
+    cg.cluster:add_server(cg.replica)
+    cg.cluster:start()
+end)
+
+
+g.after_each(function(cg)
+    cg.cluster.servers = nil
+    cg.cluster:drop()
+end)
+
+local function wait_replica(cg)
+    local vclock = helpers:get_vclock(cg.master)
+    vclock[0] = nil
+    helpers:wait_vclock(cg.replica, vclock)
+end
+
+-- Returns the number of bytes the master has sent to the replica.
+local function bytes_sent(cg)
+    return cg.master:exec(function()
+        for _, r in pairs(box.info.replication) do
+            if r.downstream ~= nil and r.downstream.stat ~= nil then
+                return tonumber(r.downstream.stat.bytes.total)
+            end
+        end
+        error('no downstream')
+    end)
+end
+
+-- Inserts `count` rows with 1 KB of padding each starting from `first`
+-- and returns the number of bytes sent to the replica for them.
+local function replicate_padded_rows(cg, first, count)
+    local bytes = bytes_sent(cg)
+    cg.master:exec(function(first, count)
+        local pad = string.rep('z', 1000)
+        box.begin()
+        for i = first, first + count - 1 do
+            box.space.test:insert({i, pad})
+        end
+        box.commit()
+    end, {first, count})
+    wait_replica(cg)
+    return bytes_sent(cg) - bytes
+end
+
+g.test_replication = function(cg)
+    cg.master:eval("s = box.schema.space.create('test')")
+    cg.master:eval("s:create_index('pk')")
+    -- Rows smaller and bigger than the batch, a multi-statement
+    -- transaction spanning several batches.
+    cg.master:eval("s:insert{1}")
+    wait_replica(cg)
+    t.assert_equals(cg.replica:eval("return box.space.test:select()"), {{1}})
+    cg.master:eval("s:insert{2, string.rep('x', 10000)}")
+    cg.master:eval([[
+        box.begin()
+        for i = 3, 1000 do s:insert{i, string.rep('y', i % 100)} end
+        box.commit()
+    ]])
+    wait_replica(cg)
+    t.assert_equals(cg.replica:eval("return box.space.test:count()"), 1000)
+    t.assert_equals(cg.replica:eval("return box.space.test:get{2}"),
+                    {2, string.rep('x', 10000)})
+    t.assert_equals(cg.replica:eval("return box.space.test:get{999}"),
+                    {999, string.rep('y', 99)})
+    t.assert_equals(cg.replica:eval("return box.info.replication[1].upstream.status"), 'follow')
+
+    -- The padding is compressed well, so much less than the size of
+    -- the rows is sent.
+    local sent = replicate_padded_rows(cg, 1001, 100)
+    t.assert_lt(sent, 100 * 1000 / 10)
+    t.assert_equals(cg.replica:eval("return box.space.test:count()"), 1100)
+end
+
+g.test_reconnect = function(cg)
+    cg.master:eval("s = box.schema.space.create('test')")
+    cg.master:eval("s:create_index('pk')")
+    cg.master:eval("for i = 1, 100 do s:insert{i} end")
+    wait_replica(cg)
+
+    -- The new subscription starts a new compression stream.
+    cg.replica:eval("rep = box.cfg.replication")
+    cg.replica:eval("box.cfg{replication = {}}")
+    cg.master:eval("for i = 101, 200 do s:insert{i} end")
+    cg.replica:eval("box.cfg{replication = rep}")
+    wait_replica(cg)
+    t.assert_equals(cg.replica:eval("return box.space.test:count()"), 200)
+
+    -- Compression can be disabled for new subscriptions.
+    cg.master:eval("box.cfg{replication_compression_level = 0}")
+    cg.replica:eval("box.cfg{replication = {}}")
+    cg.replica:eval("box.cfg{replication = rep}")
+    cg.master:eval("for i = 201, 300 do s:insert{i} end")
+    wait_replica(cg)
+    t.assert_equals(cg.replica:eval("return box.space.test:count()"), 300)
+    local sent = replicate_padded_rows(cg, 301, 100)
+    t.assert_gt(sent, 100 * 1000)
+    t.assert_equals(cg.replica:eval("return box.space.test:count()"), 400)
+end
+
+g.test_cfg = function(cg)
+    t.assert_error_msg_contains(
+        "Incorrect value for option 'replication_compression_level'",
+        cg.master.eval, cg.master,
+        "box.cfg{replication_compression_level = -1}")
+    t.assert_error_msg_contains(
+        "Incorrect value for option 'replication_compression_batch_size'",
+        cg.master.eval, cg.master,
+        "box.cfg{replication_compression_batch_size = 0}")
+end
@@ -0,0 +1,70 @@
+local t = require('luatest')
+local cluster = require('test.luatest_helpers.cluster')
+local helpers = require('test.luatest_helpers')
+
+local g = t.group('replication_stat')
+
+g.before_all(function(cg)
+    cg.cluster = cluster:new({})
+
+    local box_cfg = {
+        replication         = {
+            helpers.instance_uri('master')
+        },
+        replication_timeout = 1,
+        read_only           = false
+    }
+    cg.master = cg.cluster:build_server({alias = 'master', box_cfg = box_cfg})
+
+    box_cfg = {
+        replication         = {
+            helpers.instance_uri('master'),
+            helpers.instance_uri('replica')
+        },
+        replication_timeout = 1,
+        replication_connect_timeout = 4,
+        read_only           = true
+    }
+    cg.replica = cg.cluster:build_server({alias = 'replica',
+                                          box_cfg = box_cfg})
+
+    cg.cluster:add_server(cg.master)
+    cg.cluster:add_server(cg.replica)
+    cg.cluster:start()
+
+    cg.master:eval("s = box.schema.space.create('test')")
+    cg.master:eval("s:create_index('pk')")
+end)
+
+g.after_all(function(cg)
+    cg.cluster.servers = nil
+    cg.cluster:drop()
+end)
+
+g.test_stat = function(cg)
+    cg.master:eval("for i = 1, 100 do s:insert{i, string.rep('x', 100)} end")
+    local vclock = helpers:get_vclock(cg.master)
+    vclock[0] = nil
+    helpers:wait_vclock(cg.replica, vclock)
+
+    local stat = cg.replica:eval(
+        "return box.info.replication[1].upstream.stat")
+    t.assert_ge(stat.rows.total, 100)
+    t.assert_ge(stat.bytes.total, 100 * 100)
+    for _, name in ipairs({'apply_latency', 'wal_latency'}) do
+        for _, pct in ipairs({'p50', 'p90', 'p99'}) do
+            t.assert_type(stat[name][pct], 'number')
+        end
+        t.assert_le(stat[name].p50, stat[name].p99)
+    end
+
+    local id = cg.replica:eval("return box.info.id")
+    stat = cg.master:eval(
+        "return box.info.replication[...].downstream.stat", {id})
+    t.assert_ge(stat.rows.total, 100)
+    t.assert_ge(stat.bytes.total, 100 * 100)
+    t.assert_type(stat.rows.rps, 'number')
+    t.assert_type(stat.bytes.rps, 'number')
+    t.assert_ge(stat.wal_read_time, 0)
+    t.assert_gt(stat.send_time, 0)
+end
@@ -0,0 +1,92 @@
+local t = require('luatest')
+local cluster = require('test.luatest_helpers.cluster')
+local helpers = require('test.luatest_helpers')
+
+local g = t.group('synchro_confirm_batch')
+
+g.before_each(function(cg)
+    cg.cluster = cluster:new({})
+
+    local box_cfg = {
+        replication         = {
+            helpers.instance_uri('master')
+        },
+        replication_synchro_quorum = 2,
+        replication_synchro_timeout = 30,
+        replication_timeout = 1
+    }
+    cg.master = cg.cluster:build_server({alias = 'master', box_cfg = box_cfg})
+
+    local box_cfg = {
+        replication         = {
+            helpers.instance_uri('master'),
+            helpers.instance_uri('replica')
+        },
+        replication_timeout = 1,
+        replication_connect_timeout = 4,
+        read_only           = true
+    }
+    cg.replica = cg.cluster:build_server({alias = 'replica', box_cfg = box_cfg})
+
+    cg.cluster:add_server(cg.master)
+    cg.cluster:add_server(cg.replica)
+    cg.cluster:start()
+
+    cg.master:eval("box.schema.space.create('sync', {is_sync = true})")
+    cg.master:eval("box.space.sync:create_index('pk')")
+    cg.master:eval("box.ctl.promote()")
+end)
+
+g.after_each(function(cg)
+    cg.cluster.servers = nil
+    cg.cluster:drop()
+end)
+
+-- Count CONFIRM entries in the master's WAL.
+local function count_confirms(server)
+    return server:eval([[
+        local fio = require('fio')
+        local xlog = require('xlog')
+        local count = 0
+        for _, path in ipairs(fio.glob(box.cfg.wal_dir .. '/*.xlog')) do
+            for _, row in xlog.pairs(path) do
+                if row.HEADER.type == 'CONFIRM' then
+                    count = count + 1
+                end
+            end
+        end
+        return count
+    ]])
+end
+
+g.test_confirm_coalescing = function(cg)
+    local confirms_before = count_confirms(cg.master)
+    -- Many concurrent synchronous transactions get their quorum
+    -- while the CONFIRM for the first of them is being written.
+    t.assert(cg.master:eval([[
+        local fiber = require('fiber')
+        local fibers = {}
+        for i = 1, 100 do
+            local f = fiber.new(function() box.space.sync:insert{i} end)
+            f:set_joinable(true)
+            table.insert(fibers, f)
+        end
+        for _, f in ipairs(fibers) do
+            if not f:join() then
+                return false
+            end
+        end
+        return true
+    ]]))
+    t.assert_equals(cg.master:eval("return box.space.sync:count()"), 100)
+    t.assert_equals(cg.master:eval("return box.info.synchro.queue.len"), 0)
+    local confirms = count_confirms(cg.master) - confirms_before
+    t.assert_ge(confirms, 1)
+    t.assert_lt(confirms, 100)
+
+    local vclock = helpers:get_vclock(cg.master)
+    vclock[0] = nil
+    helpers:wait_vclock(cg.replica, vclock)
+    t.assert_equals(cg.replica:eval("return box.space.sync:count()"), 100)
+    t.assert_equals(cg.replica:eval("return box.info.synchro.queue.len"), 0)
+end
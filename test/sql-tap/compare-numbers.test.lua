@@ -0,0 +1,48 @@
+#!/usr/bin/env tarantool
+-- Check comparisons of integers, unsigned integers and doubles
+-- with each other and with values of other types.
+
+local test = require("sqltester")
+test:plan(6)
+
+test:execsql([[
+    CREATE TABLE t (id INT PRIMARY KEY, i INT, d DOUBLE, a ANY);
+    INSERT INTO t VALUES (1, -5, -0.5, 1), (2, 0, 0.0, 2),
+                         (3, 7, 7.5, 3),
+                         (4, 9223372036854775807, 1e100, 4),
+                         (5, -9223372036854775808, -1e100, 5),
+                         (6, NULL, NULL, NULL);
+]])
+
+test:do_execsql_test(
+    "compare-numbers-1.1",
+    "SELECT id FROM t WHERE i < 1 ORDER BY id",
+    {1, 2, 5})
+
+test:do_execsql_test(
+    "compare-numbers-1.2",
+    "SELECT id FROM t WHERE i >= -5 AND i <= 7 ORDER BY id",
+    {1, 2, 3})
+
+test:do_execsql_test(
+    "compare-numbers-1.3",
+    "SELECT id FROM t WHERE d > -1.0 AND d != 0.0 ORDER BY id",
+    {1, 3, 4})
+
+test:do_execsql_test(
+    "compare-numbers-1.4",
+    "SELECT i < id, i > id, d < i, i = id - 2 FROM t WHERE id <= 3 ORDER BY id",
+    {true, false, false, false, true, false, false, true,
+     false, true, false, false})
+
+test:do_execsql_test(
+    "compare-numbers-1.5",
+    "SELECT id FROM t WHERE i < NULL OR i = i - 0 ORDER BY id",
+    {1, 2, 3, 4, 5})
+
+test:do_catchsql_test(
+    "compare-numbers-1.6",
+    "SELECT id FROM t WHERE a > 1",
+    {1, "Type mismatch: can not convert any(1) to comparable type"})
+
+test:finish_test()
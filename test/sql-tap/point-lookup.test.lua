@@ -0,0 +1,110 @@
+#!/usr/bin/env tarantool
+local test = require("sqltester")
+test:plan(10)
+
+-- Statements that select all columns by a unique index are
+-- executed without the VDBE. Make sure they return the same
+-- results as the VDBE would.
+box.execute([[CREATE TABLE t (id INT PRIMARY KEY, s STRING UNIQUE, a INT);]])
+box.execute([[INSERT INTO t VALUES (1, 'a', 10), (2, 'b', 20), (3, 'c', 30);]])
+
+local function execute(sql, params)
+    local stmt = box.prepare(sql)
+    local res, err = stmt:execute(params)
+    stmt:unprepare()
+    if res == nil then
+        return {1, err.message}
+    end
+    return res.rows
+end
+
+test:do_test(
+    "point-lookup-1.1",
+    function()
+        return execute([[SELECT * FROM t WHERE id = ?;]], {2})
+    end, {
+        {2, 'b', 20}
+    })
+
+test:do_test(
+    "point-lookup-1.2",
+    function()
+        return execute([[SELECT * FROM t WHERE ? = id;]], {3})
+    end, {
+        {3, 'c', 30}
+    })
+
+test:do_test(
+    "point-lookup-1.3",
+    function()
+        return execute([[SELECT * FROM t WHERE id = ?;]], {100})
+    end, {
+    })
+
+test:do_test(
+    "point-lookup-1.4",
+    function()
+        return execute([[SELECT * FROM t WHERE s = ?;]], {'a'})
+    end, {
+        {1, 'a', 10}
+    })
+
+test:do_test(
+    "point-lookup-1.5",
+    function()
+        return box.execute([[SELECT * FROM t WHERE id = ?;]], {1}).rows
+    end, {
+        {1, 'a', 10}
+    })
+
+-- Values that don't fit the index as is are handled by the VDBE.
+test:do_test(
+    "point-lookup-2.1",
+    function()
+        return execute([[SELECT * FROM t WHERE id = ?;]], {1.0})
+    end, {
+        {1, 'a', 10}
+    })
+
+test:do_test(
+    "point-lookup-2.2",
+    function()
+        return execute([[SELECT * FROM t WHERE id = ?;]], {box.NULL})
+    end, {
+    })
+
+-- Tuples with missing or extra fields are returned as rows of
+-- all columns of the table.
+box.space.T:insert({4, 'd'})
+box.space.T:insert({5, 'e', 50, 'extra'})
+
+test:do_test(
+    "point-lookup-3.1",
+    function()
+        local rows = execute([[SELECT * FROM t WHERE id = ?;]], {4})
+        return {#rows[1], rows[1][2], rows[1][3] == nil}
+    end, {
+        3, 'd', true
+    })
+
+test:do_test(
+    "point-lookup-3.2",
+    function()
+        return execute([[SELECT * FROM t WHERE id = ?;]], {5})
+    end, {
+        {5, 'e', 50}
+    })
+
+-- Access rights are checked.
+test:do_test(
+    "point-lookup-4.1",
+    function()
+        return box.session.su('guest', execute,
+                              [[SELECT * FROM t WHERE id = ?;]], {1})
+    end, {
+        1, "Read access to space 'T' is denied for user 'guest'"
+    })
+
+box.execute([[DROP TABLE t;]])
+
+test:finish_test()
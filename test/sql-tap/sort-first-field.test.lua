@@ -0,0 +1,56 @@
+#!/usr/bin/env tarantool
+-- Check the order of rows sorted by the sorter when the first
+-- key field of all rows is an integer or a string, including
+-- negative numbers, ties and descending order.
+
+local test = require("sqltester")
+test:plan(7)
+
+test:execsql([[
+    CREATE TABLE t (id INT PRIMARY KEY, i INT, s STRING, n NUMBER);
+    INSERT INTO t VALUES (1, 5, 'b', 1), (2, -3, 'ab', 2.5),
+                         (3, 5, 'a', 3), (4, 0, 'b', -1),
+                         (5, -9223372036854775808, '', 5),
+                         (6, 9223372036854775807, 'abc', 6),
+                         (7, -3, 'a', 7);
+]])
+
+test:do_execsql_test(
+    "sort-first-field-1.1",
+    "SELECT id FROM t ORDER BY i + 0, id DESC",
+    {5, 7, 2, 4, 3, 1, 6})
+
+test:do_execsql_test(
+    "sort-first-field-1.2",
+    "SELECT id FROM t ORDER BY i + 0 DESC, id",
+    {6, 1, 3, 4, 2, 7, 5})
+
+test:do_execsql_test(
+    "sort-first-field-1.3",
+    "SELECT id FROM t ORDER BY s || '', id DESC",
+    {5, 7, 3, 2, 6, 4, 1})
+
+test:do_execsql_test(
+    "sort-first-field-1.4",
+    "SELECT id FROM t ORDER BY s || '' DESC, id",
+    {1, 4, 6, 2, 3, 7, 5})
+
+test:do_execsql_test(
+    "sort-first-field-1.5",
+    "SELECT id FROM t ORDER BY (s || '') COLLATE \"unicode_ci\", id",
+    {5, 3, 7, 2, 6, 1, 4})
+
+-- The first field is an integer in some rows and a double in
+-- others.
+test:do_execsql_test(
+    "sort-first-field-1.6",
+    "SELECT id FROM t ORDER BY n + 0 DESC",
+    {7, 6, 5, 3, 2, 1, 4})
+
+test:do_execsql_test(
+    "sort-first-field-1.7",
+    [[SELECT i + 0, count(*) FROM t WHERE id NOT IN (5, 6)
+      GROUP BY i + 0 ORDER BY 2 DESC, 1]],
+    {-3, 2, 5, 2, 0, 1})
+
+test:finish_test()
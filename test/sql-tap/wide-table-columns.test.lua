@@ -0,0 +1,65 @@
+#!/usr/bin/env tarantool
+-- Check that columns of wide tables are fetched correctly in any
+-- order, including the columns after indexed ones and the columns
+-- with numbers greater than 64.
+
+local test = require("sqltester")
+test:plan(5)
+
+local column_count = 100
+local columns = {}
+for i = 1, column_count do
+    table.insert(columns, 'c' .. i .. ' INT')
+end
+columns[1] = columns[1] .. ' PRIMARY KEY'
+test:execsql('CREATE TABLE t (' .. table.concat(columns, ', ') ..
+             ', CONSTRAINT ck CHECK (c97 >= c3))')
+test:execsql('CREATE INDEX i70 ON t (c70)')
+test:execsql('CREATE INDEX i90 ON t (c90)')
+
+local values = {}
+for row = 1, 3 do
+    for i = 1, column_count do
+        values[i] = row * 1000 + i
+    end
+    test:execsql('INSERT INTO t VALUES (' .. table.concat(values, ', ') ..
+                 ')')
+end
+
+local fetched = {99, 71, 95, 2, 70, 91, 65, 1, 100, 64, 66}
+local names = {}
+local expected = {}
+for _, i in ipairs(fetched) do
+    table.insert(names, 'c' .. i)
+end
+for row = 1, 3 do
+    for _, i in ipairs(fetched) do
+        table.insert(expected, row * 1000 + i)
+    end
+end
+local select = 'SELECT ' .. table.concat(names, ', ') .. ' FROM t'
+
+test:do_execsql_test(
+    "wide-1.1",
+    select .. ' ORDER BY c1', expected)
+
+test:do_execsql_test(
+    "wide-1.2",
+    select .. ' WHERE c90 > 0 ORDER BY c1', expected)
+
+-- Rows come from a sorter through a pseudo cursor.
+test:do_execsql_test(
+    "wide-1.3",
+    select .. ' ORDER BY c2 + 0', expected)
+
+test:do_execsql_test(
+    "wide-1.4",
+    'SELECT c100 - c66, c66 - c65, c91 - c90 FROM t WHERE c1 = 2001',
+    {34, 1, 1})
+
+test:do_catchsql_test(
+    "wide-1.5",
+    'UPDATE t SET c97 = 0 WHERE c1 = 1001',
+    {1, "/Check constraint failed 'CK'/"})
+
+test:finish_test()
@@ -194,12 +194,69 @@ void test_get_set()
 	footer();
 }
 
+static
+void test_sparse_dense()
+{
+	header();
+
+	struct tt_bitset bm;
+	tt_bitset_create(&bm, realloc);
+	struct tt_bitset_info info;
+
+	/* Every 7th bit of one page, two of them in the next page */
+	const size_t page_bit = 160 * CHAR_BIT;
+	const size_t step = 7;
+	const size_t count = page_bit / step;
+	fail_unless(tt_bitset_set(&bm, page_bit + 1) == 0);
+	fail_unless(tt_bitset_set(&bm, page_bit + 3) == 0);
+	for (size_t i = count; i > 0; i--) {
+		fail_unless(tt_bitset_set(&bm, (i - 1) * step) == 0);
+		fail_unless(tt_bitset_set(&bm, (i - 1) * step) == 1);
+		tt_bitset_info(&bm, &info);
+		fail_unless(info.pages == 2);
+		size_t added = count - i + 1;
+		fail_unless(info.array_pages == (added <= 80 ? 2 : 1));
+	}
+	fail_unless(tt_bitset_cardinality(&bm) == count + 2);
+	tt_bitset_info(&bm, &info);
+	fail_unless(info.mem_total < 2 * info.page_total_size);
+
+	for (size_t i = 0; i < 2 * page_bit; i++) {
+		bool expected = (i < count * step && i % step == 0) ||
+				i == page_bit + 1 || i == page_bit + 3;
+		fail_unless(tt_bitset_test(&bm, i) == expected);
+	}
+
+	/* Clear until the dense page becomes sparse again */
+	for (size_t i = 0; i < count; i++) {
+		fail_unless(tt_bitset_clear(&bm, i * step) == 1);
+		fail_unless(tt_bitset_clear(&bm, i * step) == 0);
+		tt_bitset_info(&bm, &info);
+		size_t left = count - i - 1;
+		fail_unless(info.pages == (left > 0 ? 2 : 1));
+		fail_unless(info.array_pages == (left > 40 ? 1 : info.pages));
+		for (size_t j = 0; j < page_bit; j++) {
+			bool expected = j % step == 0 && j > i * step &&
+					 j < count * step;
+			fail_unless(tt_bitset_test(&bm, j) == expected);
+		}
+	}
+	tt_bitset_info(&bm, &info);
+	fail_unless(info.pages == 1 && info.array_pages == 1);
+	fail_unless(tt_bitset_cardinality(&bm) == 2);
+
+	tt_bitset_destroy(&bm);
+
+	footer();
+}
+
 int main(int argc, char *argv[])
 {
 	setbuf(stdout, NULL);
 	srand(time(NULL));
 	test_cardinality();
 	test_get_set();
+	test_sparse_dense();
 
 	return 0;
 }
@@ -104,6 +104,29 @@ static int compare_key(const elem_t &a, long b)
 #undef bps_tree_key_t
 #undef bps_tree_arg_t
 
+/* tree with subtree sizes for order statistics test */
+#define BPS_TREE_NAME card
+#define BPS_TREE_BLOCK_SIZE 128 /* value is to low specially for tests */
+#define BPS_TREE_EXTENT_SIZE 2048 /* value is to low specially for tests */
+#define BPS_TREE_IS_IDENTICAL(a, b) (a == b)
+#define BPS_TREE_COMPARE(a, b, arg) compare(a, b)
+#define BPS_TREE_COMPARE_KEY(a, b, arg) compare(a, b)
+#define bps_tree_elem_t type_t
+#define bps_tree_key_t type_t
+#define bps_tree_arg_t int
+#define BPS_INNER_CARD
+#include "salad/bps_tree.h"
+#undef BPS_TREE_NAME
+#undef BPS_TREE_BLOCK_SIZE
+#undef BPS_TREE_EXTENT_SIZE
+#undef BPS_TREE_IS_IDENTICAL
+#undef BPS_TREE_COMPARE
+#undef BPS_TREE_COMPARE_KEY
+#undef bps_tree_elem_t
+#undef bps_tree_key_t
+#undef bps_tree_arg_t
+#undef BPS_INNER_CARD
+
 /* tree for approximate_count test */
 #define BPS_TREE_NAME approx
 #define BPS_TREE_BLOCK_SIZE 128 /* value is to low specially for tests */
@@ -585,6 +608,13 @@ bps_tree_debug_self_check()
 
 	test_debug_check_internal_functions(true);
 
+	res = card_debug_check_internal_functions(false);
+	if (res)
+		printf("self test with subtree sizes returned error %d\n",
+		       res);
+
+	card_debug_check_internal_functions(true);
+
 	footer();
 }
 
@@ -901,6 +931,134 @@ insert_successor_test()
 	footer();
 }
 
+static void
+find_batch_test()
+{
+	header();
+	test tree;
+	test_create(&tree, 0, extent_alloc, extent_free, &extents_count);
+
+	const size_t count = 100;
+	type_t keys[count];
+	type_t *results[count];
+	for (size_t i = 0; i < count; i++)
+		keys[i] = i;
+	test_find_batch(&tree, keys, count, results);
+	for (size_t i = 0; i < count; i++)
+		fail_unless(results[i] == NULL);
+
+	for (type_t v = 0; v < 2000; v += 2)
+		test_insert(&tree, v, NULL, NULL);
+	for (size_t i = 0; i < count; i++)
+		keys[i] = rand() % 2100;
+	test_find_batch(&tree, keys, count, results);
+	for (size_t i = 0; i < count; i++)
+		fail_unless(results[i] == test_find(&tree, keys[i]));
+
+	test_destroy(&tree);
+	footer();
+}
+
+/**
+ * Check offsets and positional access of the card tree against
+ * a sorted array of its elements.
+ */
+static void
+check_card_tree(const card *tree, const type_t *arr, size_t count,
+		type_t max_value)
+{
+	fail_unless(card_debug_check(tree) == 0);
+	fail_unless(card_size(tree) == count);
+	for (size_t i = 0; i < count; i++) {
+		card_iterator itr = card_iterator_at(tree, i);
+		type_t *elem = card_iterator_get_elem(tree, &itr);
+		fail_unless(elem != NULL && *elem == arr[i]);
+	}
+	card_iterator itr = card_iterator_at(tree, count);
+	fail_unless(card_iterator_is_invalid(&itr));
+	size_t lower = 0;
+	for (type_t v = -1; v <= max_value + 1; v++) {
+		while (lower < count && arr[lower] < v)
+			lower++;
+		size_t upper = lower;
+		while (upper < count && arr[upper] == v)
+			upper++;
+		bool exact;
+		fail_unless(card_lower_bound_offset(tree, v, &exact) == lower);
+		fail_unless(exact == (upper > lower));
+		fail_unless(card_upper_bound_offset(tree, v, &exact) == upper);
+		fail_unless(exact == (upper > lower));
+	}
+}
+
+static void
+order_statistics_test()
+{
+	header();
+	const type_t max_value = 3000;
+	bool present[max_value];
+	type_t arr[max_value];
+	type_t snapshot[max_value];
+	size_t snapshot_count = 0;
+	card tree;
+
+	for (int frozen = 0; frozen < 2; frozen++) {
+		card_create(&tree, 0, extent_alloc, extent_free,
+			    &extents_count);
+		memset(present, 0, sizeof(present));
+		card_iterator view = card_invalid_iterator();
+		for (int round = 0; round < 6; round++) {
+			/* Insert on even rounds, delete on odd rounds. */
+			for (int i = 0; i < 2000; i++) {
+				type_t v = rand() % max_value;
+				if (round % 2 == 0) {
+					card_insert(&tree, v, NULL, NULL);
+					present[v] = true;
+				} else {
+					card_delete(&tree, v);
+					present[v] = false;
+				}
+			}
+			size_t count = 0;
+			for (type_t v = 0; v < max_value; v++) {
+				if (present[v])
+					arr[count++] = v;
+			}
+			check_card_tree(&tree, arr, count, max_value);
+			if (frozen && round == 0) {
+				memcpy(snapshot, arr, count * sizeof(*arr));
+				snapshot_count = count;
+				view = card_iterator_first(&tree);
+				card_iterator_freeze(&tree, &view);
+			}
+		}
+		if (frozen) {
+			/* The frozen view sees the tree of round 0. */
+			for (size_t i = 0; i < snapshot_count; i++) {
+				type_t *elem =
+					card_iterator_get_elem(&tree, &view);
+				fail_unless(elem != NULL &&
+					    *elem == snapshot[i]);
+				card_iterator_next(&tree, &view);
+			}
+			fail_unless(card_iterator_is_invalid(&view));
+			card_iterator_destroy(&tree, &view);
+		}
+		card_destroy(&tree);
+	}
+
+	for (size_t count = 0; count < max_value; count = count * 2 + 1) {
+		for (size_t i = 0; i < count; i++)
+			arr[i] = i * 2;
+		card_create(&tree, 0, extent_alloc, extent_free,
+			    &extents_count);
+		fail_unless(card_build(&tree, arr, count) == 0);
+		check_card_tree(&tree, arr, count, count * 2);
+		card_destroy(&tree);
+	}
+
+	footer();
+}
 
 int
 main(void)
@@ -918,4 +1076,6 @@ main(void)
 	insert_get_iterator();
 	delete_value_check();
 	insert_successor_test();
+	find_batch_test();
+	order_statistics_test();
 }
@@ -0,0 +1,98 @@
+#include "unit.h"
+#include "salad/cm_sketch.h"
+
+static uint32_t
+h(uint32_t i)
+{
+	return i * 2654435761;
+}
+
+static void
+test_basic(void)
+{
+	plan(4);
+	header();
+
+	struct cm_sketch sketch;
+	ok(cm_sketch_create(&sketch, 1000) == 0, "create");
+	is(cm_sketch_estimate(&sketch, h(1)), 0, "empty sketch");
+	for (int i = 0; i < 5; i++)
+		cm_sketch_add(&sketch, h(1));
+	is(cm_sketch_estimate(&sketch, h(1)), 5, "count");
+	for (int i = 0; i < 100; i++)
+		cm_sketch_add(&sketch, h(1));
+	is(cm_sketch_estimate(&sketch, h(1)), CM_SKETCH_COUNTER_MAX,
+	   "saturation");
+	cm_sketch_destroy(&sketch);
+
+	footer();
+	check_plan();
+}
+
+/**
+ * Collisions may only make an estimate greater than the real
+ * count.
+ */
+static void
+test_no_underestimate(void)
+{
+	plan(1);
+	header();
+
+	struct cm_sketch sketch;
+	cm_sketch_create(&sketch, 1024);
+	/* Stay below the sample size to avoid aging. */
+	for (uint32_t i = 0; i < 1000; i++) {
+		for (uint32_t j = 0; j <= i % 8; j++)
+			cm_sketch_add(&sketch, h(i));
+	}
+	int underestimated = 0;
+	for (uint32_t i = 0; i < 1000; i++) {
+		if (cm_sketch_estimate(&sketch, h(i)) < i % 8 + 1)
+			underestimated++;
+	}
+	is(underestimated, 0, "no underestimates");
+	cm_sketch_destroy(&sketch);
+
+	footer();
+	check_plan();
+}
+
+static void
+test_aging(void)
+{
+	plan(2);
+	header();
+
+	struct cm_sketch sketch;
+	cm_sketch_create(&sketch, 64);
+	for (int i = 0; i < CM_SKETCH_COUNTER_MAX; i++)
+		cm_sketch_add(&sketch, h(1000000));
+	uint32_t count = CM_SKETCH_COUNTER_MAX;
+	/* The last addition reaches the sample size. */
+	for (uint32_t i = 0; count < sketch.sample_size - 1; i++, count++)
+		cm_sketch_add(&sketch, h(i));
+	is(cm_sketch_estimate(&sketch, h(1000000)), CM_SKETCH_COUNTER_MAX,
+	   "before aging");
+	cm_sketch_add(&sketch, h(count));
+	is(cm_sketch_estimate(&sketch, h(1000000)),
+	   CM_SKETCH_COUNTER_MAX / 2, "after aging");
+	cm_sketch_destroy(&sketch);
+
+	footer();
+	check_plan();
+}
+
+int
+main(void)
+{
+	plan(3);
+	header();
+
+	test_basic();
+	test_no_underestimate();
+	test_aging();
+
+	footer();
+	return check_plan();
+}
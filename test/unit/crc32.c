@@ -30,6 +30,7 @@
  */
 #include "unit.h"
 #include "crc32.h"
+#include "crc32_impl.h"
 
 static void
 test_alignment(void)
@@ -59,14 +60,42 @@ test_alignment(void)
 	footer();
 }
 
+/**
+ * Check that the implementation chosen by crc32_init() gives the
+ * same result as the software one for all offsets and lengths.
+ */
+static void
+test_implementation(void)
+{
+	header();
+	plan(1);
+
+	char buf[200];
+	for (unsigned int i = 0; i < sizeof(buf); i++)
+		buf[i] = i * 37 + 11;
+	int mismatch_count = 0;
+	for (unsigned int offset = 0; offset < 16; offset++) {
+		for (unsigned int len = 0; len + offset <= sizeof(buf); len++) {
+			if (crc32_calc(123, buf + offset, len) !=
+			    crc32c(123, buf + offset, len))
+				mismatch_count++;
+		}
+	}
+	is(mismatch_count, 0, "crc32_calc matches software crc32c");
+
+	check_plan();
+	footer();
+}
+
 int
 main(void)
 {
 	crc32_init();
 
 	header();
-	plan(1);
+	plan(2);
 	test_alignment();
+	test_implementation();
 	int rc = check_plan();
 	footer();
 	return rc;
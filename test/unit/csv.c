@@ -218,6 +218,57 @@ void big_chunk_separated_test() {
 	footer();
 }
 
+void
+long_field_printer(void *ctx, const char *s, const char *end)
+{
+	(void)ctx;
+	printf("|%d:%c..%c|", (int)(end - s), end > s ? *s : ' ',
+	       end > s ? end[-1] : ' ');
+}
+
+void
+long_field_endl(void *ctx)
+{
+	(void)ctx;
+	puts("");
+}
+
+/*
+ * Fields longer than the initial field buffer, with quotes, line
+ * ends and trailing spaces, fed by chunks that split the runs of
+ * plain characters at arbitrary positions.
+ */
+void long_fields_chunked_test() {
+	header();
+	struct csv csv;
+	csv_create(&csv);
+	csv_setopt(&csv, CSV_OPT_EMIT_FIELD, long_field_printer);
+	csv_setopt(&csv, CSV_OPT_EMIT_ROW, long_field_endl);
+
+	char buf[4096];
+	size_t bufn = 0;
+	buf[bufn++] = 'a';
+	memset(buf + bufn, 'x', 1000);
+	bufn += 1000;
+	buf[bufn++] = 'b';
+	memcpy(buf + bufn, "   ,\"q", 6);
+	bufn += 6;
+	for (int i = 0; i < 300; i++) {
+		memcpy(buf + bufn, i % 100 == 0 ? "\"\"" : "y,\n", 3);
+		bufn += i % 100 == 0 ? 2 : 3;
+	}
+	memcpy(buf + bufn, "z\",end\r\n", 8);
+	bufn += 8;
+
+	for (size_t pos = 0; pos < bufn; pos += 7)
+		csv_parse_chunk(&csv, buf + pos,
+				buf + (pos + 7 < bufn ? pos + 7 : bufn));
+	csv_finish_parsing(&csv);
+	fail_unless(csv_get_error_status(&csv) == CSV_ER_OK);
+	csv_destroy(&csv);
+	footer();
+}
+
 void random_generated_test() {
 	header();
 	const char *rand_test =
@@ -365,6 +416,7 @@ int main() {
 	test5();
 	test6(); // blank lines, invalid csv
 	big_chunk_separated_test();
+	long_fields_chunked_test();
 	random_generated_test();
 	/* comma in quotes */
 	common_test(
@@ -333,10 +333,68 @@ test_mp_print(void)
 	check_plan();
 }
 
+#define test_small_cmp(stra, strb) ({\
+	decimal_t a, b;\
+	decimal_from_string(&a, stra);\
+	decimal_from_string(&b, strb);\
+	char bufa[32], bufb[32];\
+	decimal_pack(bufa, &a);\
+	decimal_pack(bufb, &b);\
+	int64_t ca, cb;\
+	int32_t sa, sb;\
+	int res;\
+	ok(decimal_unpack_small(bufa, decimal_len(&a), &ca, &sa) &&\
+	   decimal_unpack_small(bufb, decimal_len(&b), &cb, &sb) &&\
+	   decimal_compare_small(ca, sa, cb, sb, &res) &&\
+	   res == decimal_compare(&a, &b),\
+	   "decimal_compare_small("stra", "strb")");\
+})
+
+static void
+test_small(void)
+{
+	plan(14);
+	header();
+
+	decimal_t dec;
+	int64_t coef, num;
+	int32_t scale;
+	decimal_from_string(&dec, "-123456.789");
+	decimal_pack(buf, &dec);
+	ok(decimal_unpack_small(buf, decimal_len(&dec), &coef, &scale) &&
+	   coef == -123456789 && scale == 3, "decimal_unpack_small(-123456.789)");
+	ok(decimal_small_to_int64(coef, scale, &num) && num == -123456,
+	   "decimal_small_to_int64(-123456.789)");
+	decimal_from_string(&dec, "1.2e5");
+	decimal_pack(buf, &dec);
+	ok(decimal_unpack_small(buf, decimal_len(&dec), &coef, &scale) &&
+	   decimal_small_to_int64(coef, scale, &num) && num == 120000,
+	   "decimal_small_to_int64(1.2e5)");
+	decimal_from_string(&dec, "1234567890123456789");
+	decimal_pack(buf, &dec);
+	ok(!decimal_unpack_small(buf, decimal_len(&dec), &coef, &scale),
+	   "decimal_unpack_small(1234567890123456789) - too many digits");
+
+	test_small_cmp("1", "1");
+	test_small_cmp("999999999999999999", "-999999999999999999");
+	test_small_cmp("1.10", "1.1");
+	test_small_cmp("-1.5", "1.5");
+	test_small_cmp("0", "-0.001");
+	test_small_cmp("123456789012345678", "12345678901234567.8");
+	test_small_cmp("-0.00000000000001", "-0.1");
+	test_small_cmp("999999999", "0.000000001");
+	test_small_cmp("1e10", "2");
+	ok(!decimal_compare_small(123456789012345678, 0, 1, 18, NULL),
+	   "decimal_compare_small() - overflow");
+
+	footer();
+	check_plan();
+}
+
 int
 main(void)
 {
-	plan(312);
+	plan(313);
 
 	dectest(314, 271, uint64, uint64_t);
 	dectest(65535, 23456, uint64, uint64_t);
@@ -421,5 +479,7 @@ main(void)
 	dectest_is(is_neg, 0, false);
 	dectest_is(is_neg, -0, false);
 
+	test_small();
+
 	return check_plan();
 }
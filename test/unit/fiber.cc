@@ -229,6 +229,27 @@ fiber_wakeup_self_test()
 	footer();
 }
 
+static void
+fiber_gc_test()
+{
+	header();
+
+	struct region *gc = &fiber()->gc;
+	fiber_gc();
+	region_alloc(gc, 1024);
+	fiber_gc();
+	assert(region_used(gc) == 0);
+	assert(region_total(gc) > 0);
+	note("small region is kept");
+
+	region_alloc(gc, FIBER_GC_REGION_MAX);
+	fiber_gc();
+	assert(region_total(gc) == 0);
+	note("big region is freed");
+
+	footer();
+}
+
 static int
 main_f(va_list ap)
 {
@@ -236,6 +257,7 @@ main_f(va_list ap)
 	fiber_join_test();
 	fiber_stack_test();
 	fiber_wakeup_self_test();
+	fiber_gc_test();
 	ev_break(loop(), EVBREAK_ALL);
 	return 0;
 }
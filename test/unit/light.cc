@@ -317,6 +317,44 @@ iterator_freeze_check()
 	footer();
 }
 
+static void
+reserve_test()
+{
+	header();
+
+	const uint32_t test_data_size = 10000;
+	struct light_core ht;
+	light_create(&ht, light_extent_size,
+		     my_light_alloc, my_light_free, &extents_count, 0);
+	for (hash_value_t val = 0; val < 100; val++)
+		light_insert(&ht, hash(val), val);
+	if (light_reserve(&ht, test_data_size) != 0)
+		fail("reserve failed", "true");
+	if (ht.table_size < test_data_size)
+		fail("table is too small after reserve", "true");
+	if (light_selfcheck(&ht))
+		fail("internal test failed (1)", "true");
+	uint32_t table_size = ht.table_size;
+	for (hash_value_t val = 100; val < test_data_size; val++)
+		light_insert(&ht, hash(val), val);
+	if (ht.table_size != table_size)
+		fail("table grew after reserve", "true");
+	if (light_selfcheck(&ht))
+		fail("internal test failed (2)", "true");
+	uint32_t total_length = 0;
+	for (uint32_t slot = 0; slot < ht.table_size; slot++)
+		total_length += light_chain_length(&ht, slot);
+	if (total_length != ht.count)
+		fail("chain length mismatch", "true");
+	for (hash_value_t val = 0; val < test_data_size; val++) {
+		if (light_find(&ht, hash(val), val) == light_end)
+			fail("find after reserve failed", "true");
+	}
+	light_destroy(&ht);
+
+	footer();
+}
+
 int
 main(int, const char**)
 {
@@ -325,6 +363,7 @@ main(int, const char**)
 	collision_test();
 	iterator_test();
 	iterator_freeze_check();
+	reserve_test();
 	if (extents_count != 0)
 		fail("memory leak!", "true");
 }
@@ -62,7 +62,7 @@ check_error(struct lua_State *L, struct tuple *tuple, int retvals,
 int
 test_basic(struct lua_State *L)
 {
-	plan(23);
+	plan(29);
 	header();
 
 	int top;
@@ -93,11 +93,14 @@ test_basic(struct lua_State *L)
 
 	/* Prepare the Lua stack. */
 	luaT_pushtuple(L, tuple);
+	struct tuple *orig = tuple;
+	box_tuple_ref(orig);
 
 	/* Create and check a tuple. */
 	top = lua_gettop(L);
 	tuple = luaT_tuple_new(L, -1, default_format);
 	check_tuple(tuple, default_format, lua_gettop(L) - top, "tuple");
+	is(tuple, orig, "tuple: same format is not copied");
 
 	/* Clean up. */
 	lua_pop(L, 1);
@@ -131,6 +134,24 @@ test_basic(struct lua_State *L)
 	check_tuple(tuple, another_format, lua_gettop(L) - top, "objects");
 
 	/* Clean up. */
+	lua_pop(L, 1);
+	assert(lua_gettop(L) == 0);
+
+	/*
+	 * Case: a tuple of another format as an input.
+	 */
+
+	/* Prepare the Lua stack. */
+	luaT_pushtuple(L, orig);
+
+	/* Create and check a tuple. */
+	top = lua_gettop(L);
+	tuple = luaT_tuple_new(L, -1, another_format);
+	check_tuple(tuple, another_format, lua_gettop(L) - top,
+		    "tuple of another format");
+
+	/* Clean up. */
+	box_tuple_unref(orig);
 	tuple_format_delete(another_format);
 	lua_pop(L, 1);
 	assert(lua_gettop(L) == 0);
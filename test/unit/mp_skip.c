@@ -0,0 +1,274 @@
+#include "mp_skip.h"
+#include "msgpuck.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "trivia/util.h"
+#include "unit.h"
+
+/** Buffer to encode test data into. */
+static char buf[16384];
+
+/** Encodes test data into buf and returns the end of it. */
+typedef char *(*encode_f)(char *data);
+
+struct test_case {
+	/** Name of the test case. */
+	const char *name;
+	/** Function that encodes the test data. */
+	encode_f encode;
+};
+
+static char *
+encode_fixint(char *data)
+{
+	return mp_encode_uint(data, 5);
+}
+
+static char *
+encode_empty_array(char *data)
+{
+	return mp_encode_array(data, 0);
+}
+
+/** An array of one-byte values long enough for a few SIMD steps. */
+static char *
+encode_one_byte_array(char *data)
+{
+	data = mp_encode_array(data, 100);
+	for (int i = 0; i < 100; i++) {
+		switch (i % 5) {
+		case 0:
+			data = mp_encode_uint(data, i);
+			break;
+		case 1:
+			data = mp_encode_int(data, -(i % 32) - 1);
+			break;
+		case 2:
+			data = mp_encode_nil(data);
+			break;
+		case 3:
+			data = mp_encode_bool(data, true);
+			break;
+		default:
+			data = mp_encode_bool(data, false);
+			break;
+		}
+	}
+	return data;
+}
+
+static char *
+encode_array16(char *data)
+{
+	data = mp_encode_array(data, 1000);
+	for (int i = 0; i < 1000; i++)
+		data = mp_encode_uint(data, i % 128);
+	return data;
+}
+
+static char *
+encode_string_array(char *data)
+{
+	data = mp_encode_array(data, 20);
+	for (int i = 0; i < 20; i++)
+		data = mp_encode_str0(data, "value");
+	return data;
+}
+
+static char *
+encode_nested_arrays(char *data)
+{
+	data = mp_encode_array(data, 3);
+	for (int i = 0; i < 3; i++) {
+		data = mp_encode_array(data, 3);
+		data = mp_encode_uint(data, 1);
+		data = mp_encode_uint(data, 2);
+		data = mp_encode_array(data, 20);
+		for (int j = 0; j < 20; j++)
+			data = mp_encode_uint(data, j);
+	}
+	return data;
+}
+
+static char *
+encode_map(char *data)
+{
+	data = mp_encode_map(data, 3);
+	data = mp_encode_uint(data, 1);
+	data = mp_encode_str0(data, "a");
+	data = mp_encode_uint(data, 2);
+	data = mp_encode_array(data, 3);
+	data = mp_encode_uint(data, 1);
+	data = mp_encode_uint(data, 2);
+	data = mp_encode_uint(data, 3);
+	data = mp_encode_uint(data, 3);
+	data = mp_encode_map(data, 1);
+	data = mp_encode_uint(data, 4);
+	data = mp_encode_uint(data, 5);
+	return data;
+}
+
+static char *
+encode_map16(char *data)
+{
+	data = mp_encode_map(data, 100);
+	for (int i = 0; i < 100; i++) {
+		data = mp_encode_uint(data, i);
+		data = mp_encode_bool(data, i % 2 == 0);
+	}
+	return data;
+}
+
+static char *
+encode_mixed_tuple(char *data)
+{
+	data = mp_encode_array(data, 8);
+	data = mp_encode_uint(data, 1);
+	data = mp_encode_str0(data, "str");
+	data = mp_encode_double(data, 1.5);
+	data = encode_nested_arrays(data);
+	data = encode_map(data);
+	data = mp_encode_nil(data);
+	data = mp_encode_bool(data, true);
+	data = mp_encode_uint(data, 100000);
+	return data;
+}
+
+static char *
+encode_empty(char *data)
+{
+	return data;
+}
+
+static char *
+encode_truncated_array(char *data)
+{
+	data = mp_encode_array(data, 100);
+	for (int i = 0; i < 50; i++)
+		data = mp_encode_uint(data, 1);
+	return data;
+}
+
+static char *
+encode_truncated_array16_header(char *data)
+{
+	*data++ = (char)0xdc;
+	*data++ = 0;
+	return data;
+}
+
+static char *
+encode_invalid_byte(char *data)
+{
+	data = mp_encode_array(data, 40);
+	for (int i = 0; i < 40; i++) {
+		if (i == 20)
+			*data++ = (char)0xc1;
+		else
+			data = mp_encode_uint(data, 1);
+	}
+	return data;
+}
+
+static char *
+encode_truncated_string(char *data)
+{
+	data = mp_encode_array(data, 20);
+	for (int i = 0; i < 19; i++)
+		data = mp_encode_uint(data, 1);
+	data = mp_encode_strl(data, 10);
+	memcpy(data, "abc", 3);
+	return data + 3;
+}
+
+static char *
+encode_truncated_map(char *data)
+{
+	data = mp_encode_map(data, 2);
+	data = mp_encode_uint(data, 1);
+	data = mp_encode_uint(data, 2);
+	data = mp_encode_uint(data, 3);
+	return data;
+}
+
+static const struct test_case valid_cases[] = {
+	{"fixint", encode_fixint},
+	{"empty array", encode_empty_array},
+	{"array of one-byte values", encode_one_byte_array},
+	{"array16", encode_array16},
+	{"array of strings", encode_string_array},
+	{"nested arrays", encode_nested_arrays},
+	{"map", encode_map},
+	{"map16", encode_map16},
+	{"mixed tuple", encode_mixed_tuple},
+};
+
+static const struct test_case invalid_cases[] = {
+	{"empty buffer", encode_empty},
+	{"truncated array", encode_truncated_array},
+	{"truncated array16 header", encode_truncated_array16_header},
+	{"invalid byte", encode_invalid_byte},
+	{"truncated string", encode_truncated_string},
+	{"truncated map", encode_truncated_map},
+};
+
+static void
+test_valid(void)
+{
+	int count = lengthof(valid_cases);
+	plan(2 * count);
+	header();
+
+	for (int i = 0; i < count; i++) {
+		const struct test_case *c = &valid_cases[i];
+		/* Trailing garbage must not be touched. */
+		memset(buf, 0xc1, sizeof(buf));
+		const char *end = c->encode(buf);
+		const char *expected = buf;
+		mp_next(&expected);
+		const char *data = buf;
+		ok(mp_check_fast(&data, end) == 0 && data == end,
+		   "mp_check_fast(%s)", c->name);
+		data = buf;
+		mp_next_fast(&data, end);
+		ok(data == expected, "mp_next_fast(%s)", c->name);
+	}
+
+	footer();
+	check_plan();
+}
+
+static void
+test_invalid(void)
+{
+	int count = lengthof(invalid_cases);
+	plan(count);
+	header();
+
+	for (int i = 0; i < count; i++) {
+		const struct test_case *c = &invalid_cases[i];
+		const char *end = c->encode(buf);
+		const char *data = buf;
+		int rc = mp_check(&data, end);
+		data = buf;
+		ok(rc != 0 && mp_check_fast(&data, end) != 0,
+		   "mp_check_fast(%s)", c->name);
+	}
+
+	footer();
+	check_plan();
+}
+
+int
+main(void)
+{
+	plan(2);
+
+	test_valid();
+	test_invalid();
+
+	return check_plan();
+}
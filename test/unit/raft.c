@@ -1421,10 +1421,86 @@ raft_test_promote_restore(void)
 	raft_finish_test();
 }
 
+static void
+raft_test_leader_lease(void)
+{
+	raft_start_test(14);
+	struct raft_node node;
+	raft_node_create(&node);
+	raft_node_cfg_is_candidate(&node, false);
+	raft_node_cfg_is_lease_enabled(&node, true);
+	double death_timeout = node.cfg_death_timeout;
+
+	/* A voter doesn't let other candidates in while the leader is seen. */
+
+	is(raft_node_send_leader(&node,
+		2 /* Term. */,
+		2 /* Source. */
+	), 0, "leader notification");
+	is(node.raft.leader, 2, "leader is accepted");
+
+	raft_run_for(death_timeout / 2);
+	is(raft_node_send_vote_request(&node,
+		3 /* Term. */,
+		"{}" /* Vclock. */,
+		3 /* Source. */
+	), 0, "vote request from 3");
+	ok(node.raft.volatile_term == 2 && node.raft.leader == 2,
+	   "vote request is ignored while the leader is seen");
+
+	raft_node_send_heartbeat(&node, 2);
+	raft_run_for(death_timeout * 3 / 4);
+	raft_node_send_vote_request(&node, 3, "{}", 3);
+	ok(node.raft.volatile_term == 2 && node.raft.leader == 2,
+	   "heartbeat prolongs the leader protection");
+
+	raft_run_for(death_timeout / 2);
+	raft_node_send_vote_request(&node, 3, "{}", 3);
+	ok(node.raft.volatile_term == 3 && node.raft.leader == 0,
+	   "vote request is accepted when the leader is not seen");
+
+	raft_node_destroy(&node);
+
+	/* The leader holds the lease while a quorum acks its messages. */
+
+	raft_node_create(&node);
+	raft_node_cfg_election_quorum(&node, 2);
+	raft_node_cfg_is_lease_enabled(&node, true);
+	raft_run_next_event();
+	is(raft_node_send_vote_response(&node,
+		2 /* Term. */,
+		1 /* Vote. */,
+		2 /* Source. */
+	), 0, "vote response from 2");
+	is(node.raft.state, RAFT_STATE_LEADER, "became leader");
+	ok(!raft_has_lease(&node.raft), "no lease without acks");
+
+	double ts = raft_time();
+	raft_process_lease_ack(&node.raft, 2, ts - 1);
+	ok(!raft_has_lease(&node.raft), "ack sent before the election is "
+	   "ignored");
+
+	raft_process_lease_ack(&node.raft, 2, ts);
+	ok(raft_has_lease(&node.raft), "lease is acquired with a quorum");
+
+	raft_run_for(death_timeout);
+	ok(!raft_has_lease(&node.raft), "lease expires before the death timeout "
+	   "of the followers");
+
+	raft_process_lease_ack(&node.raft, 2, raft_time());
+	ok(raft_has_lease(&node.raft), "lease is prolonged");
+
+	raft_node_cfg_is_lease_enabled(&node, false);
+	ok(!raft_has_lease(&node.raft), "no lease when disabled");
+
+	raft_node_destroy(&node);
+	raft_finish_test();
+}
+
 static int
 main_f(va_list ap)
 {
-	raft_start_test(14);
+	raft_start_test(15);
 
 	(void) ap;
 	fakeev_init();
@@ -1443,6 +1519,7 @@ main_f(va_list ap)
 	raft_test_enable_disable();
 	raft_test_too_long_wal_write();
 	raft_test_promote_restore();
+	raft_test_leader_lease();
 
 	fakeev_free();
 
@@ -59,6 +59,13 @@ raft_loop(void)
 	return fakeev_loop();
 }
 
+double
+raft_ev_monotonic_now(struct ev_loop *loop)
+{
+	(void)loop;
+	return fakeev_time();
+}
+
 static void
 raft_node_broadcast_f(struct raft *raft, const struct raft_msg *msg);
 
@@ -364,6 +371,7 @@ raft_node_start(struct raft_node *node)
 	raft_cfg_election_timeout(&node->raft, node->cfg_election_timeout);
 	raft_cfg_election_quorum(&node->raft, node->cfg_election_quorum);
 	raft_cfg_death_timeout(&node->raft, node->cfg_death_timeout);
+	raft_cfg_is_lease_enabled(&node->raft, node->cfg_is_lease_enabled);
 	raft_cfg_instance_id(&node->raft, node->cfg_instance_id);
 	raft_cfg_vclock(&node->raft, node->cfg_vclock);
 	raft_run_async_work();
@@ -453,6 +461,16 @@ raft_node_cfg_death_timeout(struct raft_node *node, double value)
 	}
 }
 
+void
+raft_node_cfg_is_lease_enabled(struct raft_node *node, bool value)
+{
+	node->cfg_is_lease_enabled = value;
+	if (raft_node_is_started(node)) {
+		raft_cfg_is_lease_enabled(&node->raft, value);
+		raft_run_async_work();
+	}
+}
+
 bool
 raft_msg_check(const struct raft_msg *msg, enum raft_state state, uint64_t term,
 	       uint32_t vote, const char *vclock)
@@ -558,7 +576,7 @@ raft_run_test(const char *log_file, fiber_func test)
 	int fd = open(log_file, O_TRUNC);
 	if (fd != -1)
 		close(fd);
-	say_logger_init(log_file, 5, 1, "plain", 0);
+	say_logger_init(log_file, 5, 1, 0, "plain", 0);
 	/* Print the seed to be able to reproduce a bug with the same seed. */
 	say_info("Random seed = %llu", (unsigned long long) seed);
 
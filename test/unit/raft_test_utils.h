@@ -104,6 +104,7 @@ struct raft_node {
 	double cfg_election_timeout;
 	int cfg_election_quorum;
 	double cfg_death_timeout;
+	bool cfg_is_lease_enabled;
 	uint32_t cfg_instance_id;
 	struct vclock *cfg_vclock;
 };
@@ -236,6 +237,9 @@ raft_node_cfg_election_quorum(struct raft_node *node, int value);
 void
 raft_node_cfg_death_timeout(struct raft_node *node, double value);
 
+void
+raft_node_cfg_is_lease_enabled(struct raft_node *node, bool value);
+
 /** Check that @a msg message matches the given arguments. */
 bool
 raft_msg_check(const struct raft_msg *msg, enum raft_state state, uint64_t term,
@@ -275,12 +275,73 @@ neighbor_test()
 	footer();
 }
 
+static void
+bulk_load_test()
+{
+	header();
+
+	const size_t counts[] = {0, 1, 17, 1000, 20000};
+	for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+		size_t count = counts[c];
+		struct rtree tree;
+		rtree_init(&tree, 2, extent_size,
+			   extent_alloc, extent_free, &page_count,
+			   RTREE_EUCLID);
+		struct rtree_builder builder;
+		rtree_builder_create(&builder);
+		struct rtree_rect rect;
+		for (size_t i = 0; i < count; i++) {
+			coord_t x = i % 150, y = i / 150;
+			rtree_set2d(&rect, x, y, x + 0.5, y + 0.5);
+			if (rtree_builder_add(&builder, &tree, &rect,
+					      (record_t)(i + 1)) != 0)
+				fail("builder add failed", "true");
+		}
+		if (rtree_builder_load(&builder, &tree) != 0)
+			fail("bulk load failed", "true");
+		rtree_builder_destroy(&builder);
+		if (rtree_number_of_records(&tree) != count)
+			fail("tree count mismatch", "true");
+		if (rtree_used_size(&tree) !=
+		    rtree_bulk_load_page_count(&tree, count) * tree.page_size)
+			fail("page count mismatch", "true");
+
+		struct rtree_iterator iterator;
+		rtree_iterator_init(&iterator);
+		for (size_t i = 0; i < count; i++) {
+			coord_t x = i % 150, y = i / 150;
+			rtree_set2d(&rect, x, y, x + 0.5, y + 0.5);
+			if (!rtree_search(&tree, &rect, SOP_EQUALS, &iterator) ||
+			    rtree_iterator_next(&iterator) != (record_t)(i + 1))
+				fail("record not found", "true");
+		}
+		/* The tree is usable for regular updates. */
+		rtree_set2d(&rect, -1, -1, -1, -1);
+		rtree_insert(&tree, &rect, (record_t)(count + 1));
+		if (!rtree_search(&tree, &rect, SOP_EQUALS, &iterator) ||
+		    rtree_iterator_next(&iterator) != (record_t)(count + 1))
+			fail("inserted record not found", "true");
+		for (size_t i = 0; i < count; i++) {
+			coord_t x = i % 150, y = i / 150;
+			rtree_set2d(&rect, x, y, x + 0.5, y + 0.5);
+			if (!rtree_remove(&tree, &rect, (record_t)(i + 1)))
+				fail("record not removed", "true");
+		}
+		if (rtree_number_of_records(&tree) != 1)
+			fail("tree count mismatch after remove", "true");
+		rtree_iterator_destroy(&iterator);
+		rtree_destroy(&tree);
+	}
+
+	footer();
+}
 
 int
 main(void)
 {
 	simple_check();
 	neighbor_test();
+	bulk_load_test();
 	if (page_count != 0) {
 		fail("memory leak!", "true");
 	}
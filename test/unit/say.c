@@ -10,6 +10,7 @@
 #include <sys/un.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <signal.h>
 
 int
 parse_logger_type(const char *input)
@@ -150,6 +151,75 @@ test_log_rotate()
 	tt_pthread_mutex_unlock(&mutex);
 }
 
+static void
+test_async(const char *dir)
+{
+	char filename[64];
+	snprintf(filename, sizeof(filename), "%s/async.log", dir);
+	struct log test_log;
+	log_create(&test_log, filename, false);
+	log_set_format(&test_log, say_format_plain);
+	ok(log_async_enable(&test_log, 64 * 1024) == 0, "async enable");
+	const int count = 1000;
+	for (int i = 0; i < count; i++)
+		log_say(&test_log, S_INFO, NULL, 0, NULL, "message %d", i);
+	/* Writes all queued messages. */
+	log_destroy(&test_log);
+	FILE *f = fopen(filename, "r");
+	char line[256];
+	int i = 0;
+	while (f != NULL && fgets(line, sizeof(line), f) != NULL) {
+		char expected[32];
+		snprintf(expected, sizeof(expected), "message %d\n", i);
+		if (strstr(line, expected) == NULL)
+			break;
+		i++;
+	}
+	if (f != NULL)
+		fclose(f);
+	unlink(filename);
+	ok(i == count, "async messages are written in order");
+
+	/*
+	 * Nobody reads the pipe, so the logger thread blocks and
+	 * the ring gets full.
+	 */
+	int fds[2];
+	fail_if(pipe(fds) != 0);
+	log_create(&test_log, filename, false);
+	log_set_format(&test_log, say_format_plain);
+	close(test_log.fd);
+	test_log.fd = fds[1];
+	log_async_enable(&test_log, 64 * 1024);
+	char payload[128];
+	memset(payload, 'x', sizeof(payload) - 1);
+	payload[sizeof(payload) - 1] = 0;
+	for (int j = 0; j < 100 * count; j++)
+		log_say(&test_log, S_INFO, NULL, 0, NULL, "%s", payload);
+	ok(log_async_dropped(&test_log) > 0,
+	   "messages are dropped when the ring is full");
+	size_t size = 32 * 1024 * 1024;
+	char *buf = malloc(size);
+	size_t used = 0;
+	bool is_reported = false;
+	while (!is_reported && used < size - 1) {
+		ssize_t n = read(fds[0], buf + used, size - 1 - used);
+		if (n <= 0)
+			break;
+		char *start = buf + (used > 64 ? used - 64 : 0);
+		used += n;
+		buf[used] = 0;
+		is_reported = strstr(start, "log messages were dropped") != NULL;
+	}
+	free(buf);
+	ok(is_reported, "dropped messages are reported");
+	/* Don't let the logger thread block on the rest. */
+	signal(SIGPIPE, SIG_IGN);
+	close(fds[0]);
+	log_destroy(&test_log);
+	unlink(filename);
+}
+
 static int
 main_f(va_list ap)
 {
@@ -166,9 +236,9 @@ int main()
 {
 	memory_init();
 	fiber_init(fiber_c_invoke);
-	say_logger_init("/dev/null", S_INFO, 0, "plain", 0);
+	say_logger_init("/dev/null", S_INFO, 0, 0, "plain", 0);
 
-	plan(33);
+	plan(37);
 
 #define PARSE_LOGGER_TYPE(input, rc) \
 	ok(parse_logger_type(input) == rc, "%s", input)
@@ -269,6 +339,7 @@ int main()
 		ok(strstr(line, "<131>") != NULL, "syslog line");
 	}
 	log_destroy(&test_log);
+	test_async(tmp_dir);
 	fiber_free();
 	memory_free();
 	unlink(tmp_filename);
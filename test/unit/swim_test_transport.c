@@ -29,6 +29,7 @@
  * SUCH DAMAGE.
  */
 #include <assert.h>
+#include <errno.h>
 #include <string.h>
 #include <netinet/in.h>
 #include <sys/socket.h>
@@ -47,7 +48,11 @@ ssize_t
 swim_transport_recv(struct swim_transport *transport, void *buffer, size_t size,
 		    struct sockaddr *addr, socklen_t *addr_size)
 {
-	return fakenet_recvfrom(transport->fd, buffer, size, addr, addr_size);
+	ssize_t ret = fakenet_recvfrom(transport->fd, buffer, size, addr,
+				       addr_size);
+	if (ret == -1 && errno == EAGAIN)
+		return 0;
+	return ret;
 }
 
 int
@@ -337,12 +337,79 @@ test_xrow_fields()
 	check_plan();
 }
 
+static void
+test_subscribe_filter()
+{
+	plan(10);
+
+	struct tt_uuid uuid;
+	tt_uuid_create(&uuid);
+	struct vclock vclock;
+	vclock_create(&vclock);
+	struct iproto_features features;
+	iproto_features_create(&features);
+	uint32_t space_ids[] = {512, 600};
+	struct xrow_subscribe_filter filter;
+	xrow_subscribe_filter_create(&filter);
+	filter.space_ids = space_ids;
+	filter.space_id_count = lengthof(space_ids);
+	filter.type_mask = (1ULL << IPROTO_INSERT) | (1ULL << IPROTO_REPLACE);
+
+	struct xrow_header row;
+	is(xrow_encode_subscribe(&row, &uuid, &uuid, &vclock, true, 0,
+				 &features, &filter), 0, "encode");
+	struct xrow_subscribe_filter decoded;
+	is(xrow_decode_subscribe(&row, NULL, NULL, NULL, NULL, NULL, NULL,
+				 NULL, &decoded), 0, "decode");
+	ok(decoded.space_id_count == 2 && decoded.space_ids[0] == 512 &&
+	   decoded.space_ids[1] == 600, "decoded space ids");
+	is(decoded.type_mask, filter.type_mask, "decoded type mask");
+
+	char buf[64];
+	struct xrow_header dml;
+	memset(&dml, 0, sizeof(dml));
+	dml.bodycnt = 1;
+	dml.body[0].iov_base = buf;
+
+	char *data = mp_encode_map(buf, 2);
+	data = mp_encode_uint(data, IPROTO_SPACE_ID);
+	data = mp_encode_uint(data, 600);
+	data = mp_encode_uint(data, IPROTO_TUPLE);
+	data = mp_encode_array(data, 1);
+	data = mp_encode_uint(data, 1);
+	dml.body[0].iov_len = data - buf;
+	dml.type = IPROTO_INSERT;
+	ok(xrow_subscribe_filter_match(&decoded, &dml), "space and type match");
+	dml.type = IPROTO_DELETE;
+	ok(!xrow_subscribe_filter_match(&decoded, &dml), "type mismatch");
+
+	data = mp_encode_map(buf, 2);
+	data = mp_encode_uint(data, IPROTO_TUPLE);
+	data = mp_encode_array(data, 1);
+	data = mp_encode_uint(data, 1);
+	data = mp_encode_uint(data, IPROTO_SPACE_ID);
+	data = mp_encode_uint(data, 513);
+	dml.body[0].iov_len = data - buf;
+	dml.type = IPROTO_REPLACE;
+	ok(!xrow_subscribe_filter_match(&decoded, &dml), "space mismatch");
+	decoded.space_ids = NULL;
+	ok(xrow_subscribe_filter_match(&decoded, &dml), "no space filter");
+
+	xrow_encode_subscribe(&row, &uuid, &uuid, &vclock, true, 0,
+			      &features, NULL);
+	is(xrow_decode_subscribe(&row, NULL, NULL, NULL, NULL, NULL, NULL,
+				 NULL, &decoded), 0, "decode without filter");
+	ok(xrow_subscribe_filter_is_empty(&decoded), "empty filter");
+
+	check_plan();
+}
+
 int
 main(void)
 {
 	memory_init();
 	fiber_init(fiber_c_invoke);
-	plan(4);
+	plan(5);
 
 	random_init();
 
@@ -351,6 +418,7 @@ main(void)
 	test_xrow_header_encode_decode();
 	test_request_str();
 	test_xrow_fields();
+	test_subscribe_filter();
 
 	random_free();
 	fiber_free();
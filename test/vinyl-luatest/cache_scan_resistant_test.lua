@@ -0,0 +1,82 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group('vinyl_cache_scan_resistant')
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        alias = 'master',
+        box_cfg = {
+            vinyl_cache = 100 * 1000,
+            vinyl_cache_scan_resistant = true,
+        },
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.before_each(function(cg)
+    cg.server:exec(function()
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk')
+        local pad = string.rep('x', 1000)
+        for i = 1, 1000 do
+            s:replace({i, pad})
+        end
+        box.snapshot()
+    end)
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.cfg{vinyl_cache_scan_resistant = true}
+        box.space.test:drop()
+    end)
+end)
+
+g.test_invalid_cfg = function(cg)
+    cg.server:exec(function()
+        t.assert_error_msg_contains(
+            "Incorrect value for option 'vinyl_cache_scan_resistant'",
+            box.cfg, {vinyl_cache_scan_resistant = 'foo'})
+    end)
+end
+
+-- A full scan doesn't add tuples to the cache.
+g.test_full_scan = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        t.assert_equals(#s:select({}, {limit = 50}), 50)
+        t.assert_equals(#s:select({}, {iterator = 'LE', limit = 50}), 50)
+        t.assert_equals(s.index.pk:stat().cache.put.rows, 0)
+        -- Ranges with a key are cached.
+        t.assert_equals(#s:select({100}, {iterator = 'GE', limit = 10}), 10)
+        t.assert_equals(s.index.pk:stat().cache.put.rows, 10)
+        box.cfg{vinyl_cache_scan_resistant = false}
+        t.assert_equals(#s:select({}, {limit = 10}), 10)
+        t.assert_equals(s.index.pk:stat().cache.put.rows, 20)
+    end)
+end
+
+-- Tuples that are read once don't evict the hot ones.
+g.test_admission = function(cg)
+    cg.server:exec(function()
+        local s = box.space.test
+        for _ = 1, 5 do
+            for i = 1, 20 do
+                s:get({i})
+            end
+        end
+        for i = 101, 1000 do
+            s:get({i})
+        end
+        local hits = s.index.pk:stat().cache.get.rows
+        for i = 1, 20 do
+            s:get({i})
+        end
+        t.assert_equals(s.index.pk:stat().cache.get.rows - hits, 20)
+    end)
+end
@@ -0,0 +1,63 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group('vinyl_compaction_split')
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.error.injection.set('ERRINJ_VY_MAX_COMPACTION_SIZE', -1)
+    end)
+end)
+
+-- Check that a range that has never been compacted is split before
+-- compaction if the compaction is going to write more than allowed
+-- for a single compaction task, so that its parts are compacted
+-- concurrently.
+g.test_split_before_first_compaction = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk', {
+            range_size = 32 * 1024,
+            page_size = 1024,
+            -- Don't compact runs until forced.
+            compaction_strategy = 'tiered',
+            run_count_per_level = 100,
+        })
+        local pad = string.rep('x', 100)
+        for i = 1, 10 do
+            box.begin()
+            for j = 1, 1000 do
+                s:replace({j * 10 + i, pad})
+            end
+            box.commit()
+            box.snapshot()
+        end
+        local stat = s.index.pk:stat()
+        t.assert_equals(stat.range_count, 1)
+        t.assert_equals(stat.run_count, 10)
+        t.assert_gt(stat.disk.bytes, 4 * 64 * 1024)
+
+        box.error.injection.set('ERRINJ_VY_MAX_COMPACTION_SIZE', 64 * 1024)
+        s.index.pk:compact()
+        t.helpers.retrying({timeout = 60}, function()
+            stat = s.index.pk:stat()
+            t.assert_equals(stat.disk.compaction.queue.bytes, 0)
+            t.assert_equals(stat.run_count, stat.range_count)
+        end)
+        t.assert_gt(stat.range_count, 1)
+        t.assert_ge(stat.disk.compaction.count, stat.range_count)
+        t.assert_equals(s:count(), 10000)
+        t.assert_equals(s:get({5005}), {5005, pad})
+        s:drop()
+    end)
+end
@@ -0,0 +1,92 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group('vinyl_compaction_strategy')
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        for _, name in ipairs({'leveled', 'tiered'}) do
+            if box.space[name] ~= nil then
+                box.space[name]:drop()
+            end
+        end
+    end)
+end)
+
+g.test_invalid = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('leveled', {engine = 'vinyl'})
+        t.assert_error_msg_equals(
+            "Wrong index options (field 4): compaction_strategy must be " ..
+            "either 'leveled' or 'tiered'",
+            s.create_index, s, 'pk', {compaction_strategy = 'foo'})
+        t.assert_error_msg_contains(
+            "options parameter 'compaction_strategy' should be of type " ..
+            "string", s.create_index, s, 'pk', {compaction_strategy = 1})
+        local pk = s:create_index('pk')
+        t.assert_equals(box.space._index:get({s.id, pk.id}).opts
+                        .compaction_strategy, nil)
+        pk:alter({compaction_strategy = 'TIERED'})
+        t.assert_equals(box.space._index:get({s.id, pk.id}).opts
+                        .compaction_strategy, 'TIERED')
+    end)
+end
+
+-- Check that the tiered strategy doesn't rewrite the last level
+-- as often as the leveled one, trading space amplification for
+-- write amplification.
+g.test_amplification = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local spaces = {}
+        for _, name in ipairs({'leveled', 'tiered'}) do
+            local s = box.schema.space.create(name, {engine = 'vinyl'})
+            s:create_index('pk', {
+                compaction_strategy = name,
+                run_count_per_level = 2,
+                run_size_ratio = 4,
+            })
+            table.insert(spaces, s)
+        end
+        local pad = string.rep('x', 100)
+        for i = 1, 20 do
+            box.begin()
+            for j = 1, 100 do
+                for _, s in ipairs(spaces) do
+                    s:insert({i * 1000 + j, pad})
+                end
+            end
+            box.commit()
+            box.snapshot()
+            t.helpers.retrying({}, function()
+                for _, s in ipairs(spaces) do
+                    local stat = s.index.pk:stat()
+                    t.assert_equals(stat.disk.compaction.queue.bytes, 0)
+                end
+            end)
+        end
+        local leveled = box.space.leveled.index.pk:stat()
+        local tiered = box.space.tiered.index.pk:stat()
+        t.assert_equals(leveled.rows, 2000)
+        t.assert_equals(tiered.rows, 2000)
+        t.assert_gt(leveled.disk.write_amplification, 1)
+        t.assert_gt(tiered.disk.write_amplification, 1)
+        t.assert_lt(tiered.disk.write_amplification,
+                    leveled.disk.write_amplification)
+        t.assert_ge(leveled.disk.space_amplification, 1)
+        t.assert_ge(tiered.disk.space_amplification,
+                    leveled.disk.space_amplification)
+        t.assert_equals(box.space.tiered:count(), 2000)
+        t.assert_equals(box.space.tiered:select({5050})[1], {5050, pad})
+    end)
+end
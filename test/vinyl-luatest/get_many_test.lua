@@ -0,0 +1,106 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group('vinyl_get_many')
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+-- Check that a batched lookup returns the same tuples as lookups
+-- of individual keys, in the order of keys.
+g.test_get_many = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk', {run_count_per_level = 100})
+        s:create_index('sk', {parts = {2, 'unsigned'}})
+        for i = 1, 100 do
+            s:replace({i, i})
+        end
+        box.snapshot()
+        for i = 1, 100, 2 do
+            s:replace({i, i + 1000})
+        end
+        box.snapshot()
+        for i = 1, 100, 3 do
+            s:delete({i})
+        end
+        box.snapshot()
+        for i = 1, 100, 5 do
+            s:replace({i, i + 2000})
+        end
+        for i = 1, 100, 7 do
+            s:replace({i, i + 3000})
+        end
+        local keys = {{500}, {3}, {1}, {3}, {42}, {99}, {0}, {2}, {100}}
+        for i = 100, 1, -1 do
+            table.insert(keys, {i})
+        end
+        local expected = {}
+        for _, key in ipairs(keys) do
+            local tuple = s:get(key)
+            if tuple ~= nil then
+                table.insert(expected, tuple)
+            end
+        end
+        t.assert_equals(s.index.pk:get_many(keys), expected)
+        t.assert_equals(s.index.pk:get_many({}), {})
+        t.assert_equals(s.index.pk:get_many({{1000}}), {})
+
+        keys = {}
+        expected = {}
+        for i = 100, 1, -1 do
+            table.insert(keys, {i + 1000})
+            local tuple = s.index.sk:get({i + 1000})
+            if tuple ~= nil then
+                table.insert(expected, tuple)
+            end
+        end
+        t.assert_equals(s.index.sk:get_many(keys), expected)
+
+        box.begin()
+        s:replace({1000, 1000})
+        s:delete({2})
+        t.assert_equals(s.index.pk:get_many({{1000}, {2}, {4}}),
+                        {{1000, 1000}, s:get({4})})
+        box.rollback()
+    end)
+end
+
+-- Check that keys stored in the same page are read with one
+-- page read.
+g.test_page_reuse = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk', {page_size = 64 * 1024,
+                              bloom_fpr = 0.001})
+        for i = 1, 100 do
+            s:replace({i})
+        end
+        box.snapshot()
+        local keys = {}
+        for i = 100, 1, -1 do
+            table.insert(keys, {i})
+        end
+        local pages = s.index.pk:stat().disk.iterator.read.pages
+        t.assert_equals(#s.index.pk:get_many(keys), 100)
+        local stat = s.index.pk:stat()
+        t.assert_lt(stat.disk.iterator.read.pages - pages, 10)
+        t.assert_equals(stat.get.rows, 100)
+    end)
+end
@@ -0,0 +1,99 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group('vinyl_page_cache')
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        alias = 'master',
+        -- Disable the tuple cache so that all lookups go to runs.
+        box_cfg = {vinyl_cache = 0},
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.cfg{vinyl_page_cache = 0}
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_invalid_cfg = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        t.assert_error_msg_contains(
+            "Incorrect value for option 'vinyl_page_cache'",
+            box.cfg, {vinyl_page_cache = -1})
+        t.assert_error_msg_contains(
+            "Incorrect value for option 'vinyl_page_cache'",
+            box.cfg, {vinyl_page_cache = 'foo'})
+    end)
+end
+
+g.test_page_cache = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk', {page_size = 1024})
+        local pad = string.rep('x', 100)
+        for i = 1, 100 do
+            s:replace({i, pad})
+        end
+        box.snapshot()
+
+        local function read_pages()
+            return s.index.pk:stat().disk.iterator.read.pages
+        end
+
+        -- The cache is disabled by default.
+        t.assert_equals(box.cfg.vinyl_page_cache, 0)
+        local pages = read_pages()
+        t.assert_equals(s:get({1}), {1, pad})
+        t.assert_equals(s:get({1}), {1, pad})
+        t.assert_equals(read_pages() - pages, 2)
+        t.assert_equals(box.stat.vinyl().memory.page_cache, 0)
+
+        -- Repeated reads of the same page hit the cache.
+        box.cfg{vinyl_page_cache = 1024 * 1024}
+        pages = read_pages()
+        t.assert_equals(s:get({1}), {1, pad})
+        t.assert_equals(s:get({1}), {1, pad})
+        t.assert_equals(s:select({}, {limit = 1}), {{1, pad}})
+        t.assert_equals(read_pages() - pages, 1)
+        t.assert_gt(box.stat.vinyl().memory.page_cache, 0)
+
+        -- The whole run fits in the cache.
+        t.assert_equals(#s:select(), 100)
+        pages = read_pages()
+        for i = 1, 100 do
+            t.assert_equals(s:get({i}), {i, pad})
+        end
+        t.assert_equals(#s:select(), 100)
+        t.assert_equals(read_pages(), pages)
+        local used = box.stat.vinyl().memory.page_cache
+
+        -- Shrinking the quota evicts pages.
+        box.cfg{vinyl_page_cache = used / 2}
+        t.assert_le(box.stat.vinyl().memory.page_cache, used / 2)
+        t.assert_equals(#s:select(), 100)
+        t.assert_gt(read_pages(), pages)
+        t.assert_le(box.stat.vinyl().memory.page_cache, used / 2)
+
+        -- Pages are freed with the run.
+        box.cfg{vinyl_page_cache = 1024 * 1024}
+        t.assert_equals(#s:select(), 100)
+        t.assert_gt(box.stat.vinyl().memory.page_cache, 0)
+        s:drop()
+        box.snapshot()
+        t.helpers.retrying({}, function()
+            t.assert_equals(box.stat.vinyl().memory.page_cache, 0)
+        end)
+    end)
+end
@@ -0,0 +1,59 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group('vinyl_point_lookup')
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+-- Check that a point lookup returns the newest version of a key
+-- when it's found in several runs, which are read concurrently.
+g.test_several_runs = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk', {run_count_per_level = 100})
+        local expected = {}
+        local function replace(tuple)
+            s:replace(tuple)
+            expected[tuple[1]] = tuple
+        end
+        local function delete(key)
+            s:delete({key})
+            expected[key] = nil
+        end
+        for i = 1, 100 do
+            replace({i, 0})
+        end
+        box.snapshot()
+        for i = 1, 100, 2 do
+            replace({i, 1})
+        end
+        box.snapshot()
+        for i = 1, 100, 3 do
+            delete(i)
+        end
+        box.snapshot()
+        for i = 1, 100, 5 do
+            replace({i, 3})
+        end
+        box.snapshot()
+        local stat = s.index.pk:stat()
+        t.assert_equals(stat.run_count, 4)
+        t.assert_equals(stat.memory.rows, 0)
+        for i = 1, 100 do
+            t.assert_equals(s:get({i}), expected[i], i)
+        end
+        t.assert_equals(s:get({1000}), nil)
+        stat = s.index.pk:stat()
+        t.assert_gt(stat.disk.iterator.bloom_hit, 0)
+        t.assert_gt(stat.disk.iterator.bloom_miss, 0)
+        s:drop()
+    end)
+end
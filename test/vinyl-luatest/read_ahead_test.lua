@@ -0,0 +1,64 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group('vinyl_read_ahead')
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        alias = 'master',
+        -- Disable the tuple cache so that all scans go to runs.
+        box_cfg = {vinyl_cache = 0},
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+-- Check that sequential scans that read pages ahead return correct
+-- results, including the case when iterators are closed or the run
+-- is deleted while pages are still being read ahead.
+g.test_read_ahead = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk', {page_size = 1024, range_size = 1024 * 1024})
+        local pad = string.rep('x', 100)
+        box.begin()
+        for i = 1, 1000 do
+            s:replace({i, pad})
+        end
+        box.commit()
+        box.snapshot()
+        t.assert_gt(s.index.pk:stat().disk.pages, 50)
+
+        local res = s:select({}, {iterator = 'GE'})
+        t.assert_equals(#res, 1000)
+        for i, tuple in ipairs(res) do
+            t.assert_equals(tuple[1], i)
+        end
+        res = s:select({}, {iterator = 'LE'})
+        t.assert_equals(#res, 1000)
+        for i, tuple in ipairs(res) do
+            t.assert_equals(tuple[1], 1001 - i)
+        end
+        t.assert_equals(s:select({500}, {iterator = 'GT', limit = 100}),
+                        s:select({501}, {iterator = 'GE', limit = 100}))
+        t.assert_equals(#s:select({500}, {iterator = 'LT', limit = 100}), 100)
+
+        -- Drop the run while pages are being read ahead.
+        t.assert_equals(#s:select({}, {limit = 200}), 200)
+        s:truncate()
+        box.snapshot()
+        t.assert_equals(s:select(), {})
+    end)
+end
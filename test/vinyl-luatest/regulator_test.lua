@@ -0,0 +1,65 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group('vinyl_regulator')
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        alias = 'master',
+        box_cfg = {vinyl_memory = 8 * 1024 * 1024},
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+-- Check that the write rate limit is recalculated while a memory dump
+-- is in progress, so that writers are slowed down as the free memory
+-- shrinks rather than stalled when they hit the limit.
+g.test_dump_rate_limit = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local fiber = require('fiber')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk')
+        local pad = string.rep('x', 1000)
+        local function fill(count)
+            local id = s:len()
+            for i = id + 1, id + count, 100 do
+                box.begin()
+                for j = i, i + 99 do
+                    s:replace({j, pad})
+                end
+                box.commit()
+            end
+        end
+        local function regulator()
+            return box.stat.vinyl().regulator
+        end
+        local dump_bandwidth = regulator().dump_bandwidth
+        t.assert_equals(regulator().rate_limit, dump_bandwidth)
+
+        box.error.injection.set('ERRINJ_VY_DUMP_DELAY', true)
+        fiber.sleep(1.5)
+        fill(5000)
+        t.helpers.retrying({}, function()
+            t.assert_lt(regulator().rate_limit, dump_bandwidth)
+        end)
+        local rate_limit = regulator().rate_limit
+
+        fill(1000)
+        t.helpers.retrying({}, function()
+            t.assert_lt(regulator().rate_limit, rate_limit)
+        end)
+
+        box.error.injection.set('ERRINJ_VY_DUMP_DELAY', false)
+        t.helpers.retrying({}, function()
+            t.assert_equals(box.stat.vinyl().scheduler.tasks_inprogress, 0)
+            t.assert_equals(regulator().rate_limit,
+                            regulator().dump_bandwidth)
+        end)
+        s:drop()
+    end)
+end
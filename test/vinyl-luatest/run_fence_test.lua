@@ -0,0 +1,60 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group('vinyl_run_fence')
+
+g.before_all(function(cg)
+    cg.server = server:new({
+        alias = 'master',
+        -- Disable the tuple cache so that all lookups go to runs.
+        box_cfg = {vinyl_cache = 0},
+    })
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+-- Check that a run isn't read if the search key is beyond the min
+-- and max keys of the run.
+g.test_skip_run = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk')
+        s:create_index('sk', {parts = {{2, 'unsigned'}, {3, 'unsigned'}}})
+        for i = 1, 3 do
+            for j = 1, 100 do
+                s:replace({i * 1000 + j, i, j})
+            end
+            box.snapshot()
+        end
+        local function read_rows(idx)
+            return idx:stat().disk.iterator.read.rows
+        end
+        local function check(idx, key, opts, count, skipped)
+            local rows = read_rows(idx)
+            t.assert_equals(#idx:select(key, opts), count)
+            if skipped then
+                t.assert_equals(read_rows(idx), rows)
+            else
+                t.assert_gt(read_rows(idx), rows)
+            end
+        end
+        local pk = s.index.pk
+        local sk = s.index.sk
+        check(pk, {5000}, {iterator = 'GE'}, 0, true)
+        check(pk, {3100}, {iterator = 'GT'}, 0, true)
+        check(pk, {1001}, {iterator = 'LT'}, 0, true)
+        check(pk, {1000}, {iterator = 'LE'}, 0, true)
+        check(pk, {3100}, {iterator = 'GE'}, 1, false)
+        check(sk, {4}, {iterator = 'GE'}, 0, true)
+        check(sk, {3}, {iterator = 'GT'}, 0, true)
+        check(sk, {1}, {iterator = 'LT'}, 0, true)
+        check(sk, {3, 200}, {iterator = 'EQ'}, 0, true)
+        check(sk, {3}, {iterator = 'GE', limit = 10}, 10, false)
+        check(sk, {2}, {iterator = 'EQ'}, 100, false)
+        s:drop()
+    end)
+end
@@ -0,0 +1,101 @@
+local server = require('test.luatest_helpers.server')
+local t = require('luatest')
+
+local g = t.group('vinyl_upsert_squash_threshold')
+
+g.before_all(function(cg)
+    cg.server = server:new({alias = 'master'})
+    cg.server:start()
+end)
+
+g.after_all(function(cg)
+    cg.server:drop()
+end)
+
+g.after_each(function(cg)
+    cg.server:exec(function()
+        box.cfg{vinyl_upsert_squash_threshold = 128}
+        if box.space.test ~= nil then
+            box.space.test:drop()
+        end
+    end)
+end)
+
+g.test_invalid_cfg = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local msg = "Incorrect value for option " ..
+                    "'vinyl_upsert_squash_threshold'"
+        t.assert_error_msg_contains(msg, box.cfg,
+                                    {vinyl_upsert_squash_threshold = 0})
+        t.assert_error_msg_contains(msg, box.cfg,
+                                    {vinyl_upsert_squash_threshold = 255})
+        t.assert_error_msg_contains(msg, box.cfg,
+                                    {vinyl_upsert_squash_threshold = 'foo'})
+        t.assert_equals(box.cfg.vinyl_upsert_squash_threshold, 128)
+    end)
+end
+
+g.test_squash_threshold = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk')
+        s:replace({1, 0})
+        -- Upserts aren't turned into replaces if there are runs.
+        box.snapshot()
+
+        local function squashed()
+            return s.index.pk:stat().upsert.squashed
+        end
+
+        box.cfg{vinyl_upsert_squash_threshold = 10}
+        for _ = 1, 10 do
+            s:upsert({1, 0}, {{'+', 2, 1}})
+        end
+        t.assert_equals(squashed(), 0)
+        s:upsert({1, 0}, {{'+', 2, 1}})
+        t.helpers.retrying({}, function()
+            t.assert_equals(squashed(), 1)
+        end)
+        t.assert_equals(s:get({1}), {1, 11})
+
+        -- The chain after the squashed statement is counted anew.
+        for _ = 1, 10 do
+            s:upsert({1, 0}, {{'+', 2, 1}})
+        end
+        t.assert_equals(squashed(), 1)
+        s:upsert({1, 0}, {{'+', 2, 1}})
+        t.helpers.retrying({}, function()
+            t.assert_equals(squashed(), 2)
+        end)
+        t.assert_equals(s:get({1}), {1, 22})
+    end)
+end
+
+g.test_lower_threshold = function(cg)
+    cg.server:exec(function()
+        local t = require('luatest')
+        local s = box.schema.space.create('test', {engine = 'vinyl'})
+        s:create_index('pk')
+        s:replace({1, 0})
+        box.snapshot()
+
+        local function squashed()
+            return s.index.pk:stat().upsert.squashed
+        end
+
+        for _ = 1, 20 do
+            s:upsert({1, 0}, {{'+', 2, 1}})
+        end
+        t.assert_equals(squashed(), 0)
+        -- The chain is already longer than the new threshold,
+        -- so the next upsert starts squashing.
+        box.cfg{vinyl_upsert_squash_threshold = 5}
+        s:upsert({1, 0}, {{'+', 2, 1}})
+        t.helpers.retrying({}, function()
+            t.assert_equals(squashed(), 1)
+        end)
+        t.assert_equals(s:get({1}), {1, 21})
+    end)
+end